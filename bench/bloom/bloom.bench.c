@@ -0,0 +1,158 @@
+/**
+ * Blocked Bloom filter vs classic Bloom filter
+ * --------------------------------------------
+ * `keys` random 64-bit keys inserted, then as many lookups of inserted
+ * keys and of absent keys, in random order, on:
+ *   - bloom: one 64-byte block per key, sized by bloom_init(keys, fpr)
+ *   - classic: k = round(-log2(fpr)) bits anywhere in an array of
+ *     -keys * ln(fpr) / ln(2)^2 bits (double hashing), the textbook optimum
+ * Reports memory, measured false positive rate and ns per operation.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -march=native -DNDEBUG -I./build -o build/bloom-bench bench/bloom/bloom.bench.c -lm
+ *   ./build/bloom-bench [keys] [fpr]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include "ccoutils.h"
+
+static uint64_t key_hash(uint64_t key)
+{
+   return hash_bytes(&key, sizeof(key), 0);
+}
+
+DEFINE_BLOOM(uint64_t)
+GENERATE_BLOOM(uint64_t, key_hash, malloc, free)
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+typedef struct
+{
+   uint64_t *bits;
+   uint64_t bit_count;
+   uint32_t k;
+} classic_s;
+
+static void classic_insert(classic_s *const f, uint64_t key)
+{
+   const uint64_t h = key_hash(key);
+   uint64_t a = h, b = (h * 0x9E3779B97F4A7C15ull) | 1;
+   for (uint32_t i = 0; i < f->k; i++, a += b)
+   {
+      const uint64_t bit = (uint64_t)(((unsigned __int128)a * f->bit_count) >> 64);
+      f->bits[bit / 64] |= (uint64_t)1 << (bit % 64);
+   }
+}
+
+static bool classic_contains(const classic_s *const f, uint64_t key)
+{
+   const uint64_t h = key_hash(key);
+   uint64_t a = h, b = (h * 0x9E3779B97F4A7C15ull) | 1;
+   for (uint32_t i = 0; i < f->k; i++, a += b)
+   {
+      const uint64_t bit = (uint64_t)(((unsigned __int128)a * f->bit_count) >> 64);
+      if (!((f->bits[bit / 64] >> (bit % 64)) & 1))
+         return false;
+   }
+   return true;
+}
+
+static void print_row(const char *name, size_t bytes, double insert, double hit, double miss, uint64_t false_positives, size_t n)
+{
+   printf("  %-8s %8.2f MB  %5.2f bits/key  fpr %.4f%%  insert %5.1f ns  hit %5.1f ns  miss %5.1f ns\n",
+      name, bytes / 1e6, bytes * 8.0 / n, false_positives * 100.0 / n, insert * 1e9 / n, hit * 1e9 / n, miss * 1e9 / n);
+}
+
+int main(int argc, char **argv)
+{
+   const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 10000000;
+   const double fpr = argc > 2 ? atof(argv[2]) : 0.01;
+
+   uint64_t *present = (uint64_t*)malloc(sizeof(uint64_t) * n);
+   uint64_t *absent = (uint64_t*)malloc(sizeof(uint64_t) * n);
+   if (!present || !absent)
+      return 1;
+   uint64_t seed = 0x9E3779B97F4A7C15ull;
+   for (size_t i = 0; i < n; i++)
+   {
+      present[i] = next_random(&seed) | 1;   // odd
+      absent[i] = next_random(&seed) & ~1ull; // even
+   }
+
+   printf("%zu keys, target fpr %.4f%%\n", n, fpr * 100.0);
+   uint64_t sink = 0;
+
+   // blocked
+   {
+      bloom(uint64_t) f;
+      bloom_init(uint64_t, &f, n, fpr);
+      double t = now_seconds();
+      for (size_t i = 0; i < n; i++)
+         bloom_insert(uint64_t, &f, present[i]);
+      const double insert = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t i = n; i-- > 0;)
+         sink += bloom_contains(uint64_t, &f, present[i]);
+      const double hit = now_seconds() - t;
+
+      uint64_t false_positives = 0;
+      t = now_seconds();
+      for (size_t i = 0; i < n; i++)
+         false_positives += bloom_contains(uint64_t, &f, absent[i]);
+      const double miss = now_seconds() - t;
+
+      print_row("bloom", bloom_bytes(uint64_t, &f), insert, hit, miss, false_positives, n);
+      bloom_delete(uint64_t, &f);
+   }
+
+   // classic
+   {
+      classic_s f;
+      f.k = (uint32_t)lround(-log2(fpr));
+      f.bit_count = (uint64_t)ceil(-(double)n * log(fpr) / (M_LN2 * M_LN2));
+      f.bits = (uint64_t*)calloc((f.bit_count + 63) / 64, sizeof(uint64_t));
+      if (!f.bits)
+         return 1;
+      double t = now_seconds();
+      for (size_t i = 0; i < n; i++)
+         classic_insert(&f, present[i]);
+      const double insert = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t i = n; i-- > 0;)
+         sink += classic_contains(&f, present[i]);
+      const double hit = now_seconds() - t;
+
+      uint64_t false_positives = 0;
+      t = now_seconds();
+      for (size_t i = 0; i < n; i++)
+         false_positives += classic_contains(&f, absent[i]);
+      const double miss = now_seconds() - t;
+
+      print_row("classic", (f.bit_count + 63) / 64 * 8, insert, hit, miss, false_positives, n);
+      free(f.bits);
+   }
+
+   if (sink != 2 * (uint64_t)n)
+      printf("false negatives!\n");
+   free(present);
+   free(absent);
+   return 0;
+}
@@ -0,0 +1,165 @@
+/**
+ * B+ tree map vs sorted array
+ * ---------------------------
+ * `keys` random 64-bit keys, same operations on both:
+ *   - btree: random inserts, then bulk_load of the sorted keys
+ *   - sorted: binary search + memmove per insert (a tenth of the keys,
+ *     the rest would take minutes), then qsort of all keys
+ * then lookups of every key in random order and range scans of 100 keys
+ * from a random start. Reports ns per operation (per key for scans).
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -march=native -DNDEBUG -I./build -o build/btree-bench bench/btree/btree.bench.c
+ *   ./build/btree-bench [keys]
+ * Build with -DBTREE_NODE_BYTES=512 (or another size) to compare node sizes.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+int compare_u64(const uint64_t *a, const uint64_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+static int qsort_u64(const void *a, const void *b)
+{
+   return compare_u64((const uint64_t*)a, (const uint64_t*)b);
+}
+
+DEFINE_BTREE_MAP(uint64_t, uint64_t, size_t)
+GENERATE_BTREE_MAP(uint64_t, uint64_t, size_t, compare_u64, malloc, free)
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* index of the first key >= key */
+static size_t sorted_lower_bound(const uint64_t *keys, size_t n, uint64_t key)
+{
+   size_t lo = 0, hi = n;
+   while (lo < hi)
+   {
+      const size_t mid = lo + (hi - lo) / 2;
+      if (keys[mid] < key)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+enum { SCANS = 100000, SCAN_LEN = 100 };
+
+int main(int argc, char **argv)
+{
+   const size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+
+   uint64_t *keys = (uint64_t*)malloc(sizeof(uint64_t) * n);
+   uint64_t *sorted = (uint64_t*)malloc(sizeof(uint64_t) * n);
+   uint64_t *starts = (uint64_t*)malloc(sizeof(uint64_t) * SCANS);
+   if (!keys || !sorted || !starts)
+      return 1;
+   uint64_t seed = 0x9E3779B97F4A7C15ull;
+   for (size_t i = 0; i < n; i++)
+      keys[i] = next_random(&seed);
+   for (size_t i = 0; i < SCANS; i++)
+      starts[i] = next_random(&seed);
+
+   printf("%zu keys, %d byte nodes (fanout %d)\n", n, BTREE_NODE_BYTES, (int)uint64_t_uint64_t_btree_fanout);
+   uint64_t sink = 0;
+
+   // btree
+   {
+      btree_map(uint64_t, uint64_t) map;
+      btree_map_init(uint64_t, uint64_t, &map);
+      double t = now_seconds();
+      for (size_t i = 0; i < n; i++)
+         btree_map_insert(uint64_t, uint64_t, &map, keys[i], i);
+      const double insert = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t i = n; i-- > 0;)
+         sink += *btree_map_get(uint64_t, uint64_t, &map, keys[i]);
+      const double lookup = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t s = 0; s < SCANS; s++)
+      {
+         btree_map_iterator(uint64_t, uint64_t) it = btree_map_lower_bound(uint64_t, uint64_t, &map, starts[s]);
+         for (int k = 0; k < SCAN_LEN && btree_map_iterator_valid(uint64_t, uint64_t, it); k++, btree_map_iterator_next(uint64_t, uint64_t, &it))
+            sink += *btree_map_iterator_value(uint64_t, uint64_t, it);
+      }
+      const double scan = now_seconds() - t;
+
+      memcpy(sorted, keys, sizeof(uint64_t) * n);
+      qsort(sorted, n, sizeof(uint64_t), qsort_u64);
+      btree_map_clear(uint64_t, uint64_t, &map);
+      t = now_seconds();
+      btree_map_bulk_load(uint64_t, uint64_t, &map, sorted, sorted, n);
+      const double load = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t i = n; i-- > 0;)
+         sink += *btree_map_get(uint64_t, uint64_t, &map, keys[i]);
+      const double loaded_lookup = now_seconds() - t;
+
+      printf("  btree   insert %6.1f ns  lookup %6.1f ns  scan %5.2f ns/key  bulk load %5.1f ns/key  lookup after load %6.1f ns  height %u\n",
+         insert * 1e9 / n, lookup * 1e9 / n, scan * 1e9 / (SCANS * SCAN_LEN), load * 1e9 / n, loaded_lookup * 1e9 / n, map.height);
+      btree_map_delete(uint64_t, uint64_t, &map);
+   }
+
+   // sorted array
+   {
+      const size_t inserts = n / 10;
+      size_t len = 0;
+      double t = now_seconds();
+      for (size_t i = 0; i < inserts; i++)
+      {
+         const size_t at = sorted_lower_bound(sorted, len, keys[i]);
+         memmove(&sorted[at + 1], &sorted[at], sizeof(uint64_t) * (len - at));
+         sorted[at] = keys[i];
+         len++;
+      }
+      const double insert = now_seconds() - t;
+
+      memcpy(sorted, keys, sizeof(uint64_t) * n);
+      t = now_seconds();
+      qsort(sorted, n, sizeof(uint64_t), qsort_u64);
+      const double load = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t i = n; i-- > 0;)
+         sink += sorted[sorted_lower_bound(sorted, n, keys[i])];
+      const double lookup = now_seconds() - t;
+
+      t = now_seconds();
+      for (size_t s = 0; s < SCANS; s++)
+         for (size_t at = sorted_lower_bound(sorted, n, starts[s]), k = 0; k < SCAN_LEN && at < n; k++, at++)
+            sink += sorted[at];
+      const double scan = now_seconds() - t;
+
+      printf("  sorted  insert %6.1f ns (%zu keys)  lookup %6.1f ns  scan %5.2f ns/key  qsort %5.1f ns/key\n",
+         insert * 1e9 / inserts, inserts, lookup * 1e9 / n, scan * 1e9 / (SCANS * SCAN_LEN), load * 1e9 / n);
+   }
+
+   printf("(%llu)\n", (unsigned long long)sink);
+   free(keys);
+   free(sorted);
+   free(starts);
+   return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * Delta queue vs queue of 64-bit IDs
+ * ----------------------------------
+ * `count` increasing 64-bit IDs with random gaps below `max_gap` in a
+ * queue(uint64_t) and a delta_queue(uint64_t):
+ *   - enque every ID
+ *   - drain: deque everything in batches of 4096 into an array
+ * Reports ns per ID, decoded GB/s (8 bytes per ID) and the bytes held.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -march=native -DNDEBUG -I./build -o build/delta-queue-bench bench/delta-queue/delta-queue.bench.c
+ *   ./build/delta-queue-bench [count] [max_gap]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+#define BATCH 4096
+
+bool id_valid(uint64_t id)
+{
+   (void)id;
+   return true;
+}
+
+DEFINE_QUEUE(uint64_t, uint32_t, 64)
+DEFINE_DELTA_QUEUE(uint64_t, uint32_t, 256)
+GENERATE_QUEUE(uint64_t, uint32_t, 64, 2, id_valid, malloc, realloc, free)
+GENERATE_DELTA_QUEUE(uint64_t, uint32_t, 256, 2, malloc, free)
+
+static uint64_t next_random(uint64_t *state)
+{
+   *state ^= *state << 13;
+   *state ^= *state >> 7;
+   *state ^= *state << 17;
+   return *state;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+   const uint32_t n = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 50000000;
+   const uint64_t max_gap = argc > 2 ? strtoull(argv[2], NULL, 10) : 100;
+   static uint64_t batch[BATCH];
+   uint64_t sink = 0;
+
+   // 8 bytes per ID
+   {
+      queue(uint64_t) q;
+      queue_init(uint64_t, &q);
+      uint64_t seed = 0x9E3779B97F4A7C15ull, id = 1ull << 40;
+      double t = now_seconds();
+      for (uint32_t i = 0; i < n; i++)
+      {
+         id += 1 + next_random(&seed) % max_gap;
+         queue_enque(uint64_t, &q, id);
+      }
+      const double enque = now_seconds() - t;
+      const double bytes = (double)q.size * sizeof(uint64_t);
+
+      const uint32_t mask = q.size - 1;
+      t = now_seconds();
+      while (q.len != 0)
+      {
+         const uint32_t k = q.len < BATCH ? q.len : BATCH;
+         for (uint32_t i = 0; i < k; i++)
+            batch[i] = q.values[(q.front + i) & mask];
+         sink += batch[k - 1];
+         q.front = (q.front + k) & mask;
+         q.len -= k;
+      }
+      const double drain = now_seconds() - t;
+
+      printf("  queue        enque %5.2f ns  drain %5.3f ns (%5.2f GB/s)  %8.1f MB\n", enque * 1e9 / n,
+             drain * 1e9 / n, (double)n * 8 / drain / 1e9, bytes / 1e6);
+      queue_delete(uint64_t, &q);
+   }
+
+   // group-varint deltas
+   {
+      delta_queue(uint64_t) q;
+      delta_queue_init(uint64_t, &q);
+      uint64_t seed = 0x9E3779B97F4A7C15ull, id = 1ull << 40;
+      double t = now_seconds();
+      for (uint32_t i = 0; i < n; i++)
+      {
+         id += 1 + next_random(&seed) % max_gap;
+         delta_queue_enque(uint64_t, &q, id);
+      }
+      const double enque = now_seconds() - t;
+      const double bytes = (double)delta_queue_bytes(uint64_t, &q);
+      const double used = (double)delta_queue_used(uint64_t, &q);
+
+      t = now_seconds();
+      while (!delta_queue_empty(uint64_t, &q))
+      {
+         const uint32_t k = delta_queue_deque_n(uint64_t, &q, batch, BATCH);
+         sink += batch[k - 1];
+      }
+      const double drain = now_seconds() - t;
+
+      printf("  delta_queue  enque %5.2f ns  drain %5.3f ns (%5.2f GB/s)  %8.1f MB (%.1f MB used)\n", enque * 1e9 / n,
+             drain * 1e9 / n, (double)n * 8 / drain / 1e9, bytes / 1e6, used / 1e6);
+      delta_queue_delete(uint64_t, &q);
+   }
+
+   printf("(%llu)\n", (unsigned long long)sink);
+   return 0;
+}
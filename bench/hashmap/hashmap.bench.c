@@ -0,0 +1,252 @@
+/**
+ * Swiss-table hashmap vs chained hash table
+ * -----------------------------------------
+ * uint64_t -> uint64_t, `keys` random keys, the same hash function in both:
+ *   - hashmap: GENERATE_HASHMAP (control bytes, 16-wide group probing)
+ *   - chained: bucket array of singly linked nodes, one malloc per node,
+ *     doubled at load factor 1 (the layout of a textbook / std::unordered_map
+ *     style table)
+ * Phases: insert every key, look every key up in a different random order
+ * (hit), look up as many absent keys (miss), remove every other key.
+ * Reports ns per operation and the memory held by each table.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -DNDEBUG -I./build -o build/hashmap-bench bench/hashmap/hashmap.bench.c
+ *   ./build/hashmap-bench [keys]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+/* splitmix64 finalizer */
+static uint64_t key_hash(uint64_t key)
+{
+   key ^= key >> 30;
+   key *= 0xBF58476D1CE4E5B9ull;
+   key ^= key >> 27;
+   key *= 0x94D049BB133111EBull;
+   return key ^ (key >> 31);
+}
+
+static bool key_equal(uint64_t a, uint64_t b)
+{
+   return a == b;
+}
+
+DEFINE_HASHMAP(uint64_t, uint64_t, size_t)
+GENERATE_HASHMAP(uint64_t, uint64_t, size_t, key_hash, key_equal, malloc, free)
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+typedef struct chained_node
+{
+   struct chained_node *next;
+   uint64_t key;
+   uint64_t value;
+} chained_node_s;
+
+typedef struct
+{
+   chained_node_s **buckets;
+   size_t bucket_count;
+   size_t len;
+} chained_s;
+
+static bool chained_init(chained_s *const t)
+{
+   t->bucket_count = 16;
+   t->len = 0;
+   t->buckets = calloc(t->bucket_count, sizeof(chained_node_s*));
+   return t->buckets != NULL;
+}
+
+static void chained_delete(chained_s *const t)
+{
+   for (size_t b = 0; b < t->bucket_count; b++)
+      for (chained_node_s *node = t->buckets[b], *next; node; node = next)
+      {
+         next = node->next;
+         free(node);
+      }
+   free(t->buckets);
+}
+
+static bool chained_grow(chained_s *const t)
+{
+   const size_t count = t->bucket_count * 2;
+   chained_node_s **const buckets = calloc(count, sizeof(chained_node_s*));
+   if (!buckets)
+      return false;
+   for (size_t b = 0; b < t->bucket_count; b++)
+      for (chained_node_s *node = t->buckets[b], *next; node; node = next)
+      {
+         next = node->next;
+         chained_node_s **const head = &buckets[key_hash(node->key) & (count - 1)];
+         node->next = *head;
+         *head = node;
+      }
+   free(t->buckets);
+   t->buckets = buckets;
+   t->bucket_count = count;
+   return true;
+}
+
+static uint64_t *chained_get(const chained_s *const t, const uint64_t key)
+{
+   for (chained_node_s *node = t->buckets[key_hash(key) & (t->bucket_count - 1)]; node; node = node->next)
+      if (node->key == key)
+         return &node->value;
+   return NULL;
+}
+
+static bool chained_insert(chained_s *const t, const uint64_t key, const uint64_t value)
+{
+   uint64_t *const existing = chained_get(t, key);
+   if (existing)
+   {
+      *existing = value;
+      return true;
+   }
+   if (t->len + 1 > t->bucket_count && !chained_grow(t))
+      return false;
+   chained_node_s *const node = malloc(sizeof(chained_node_s));
+   if (!node)
+      return false;
+   chained_node_s **const head = &t->buckets[key_hash(key) & (t->bucket_count - 1)];
+   node->key = key;
+   node->value = value;
+   node->next = *head;
+   *head = node;
+   t->len++;
+   return true;
+}
+
+static bool chained_remove(chained_s *const t, const uint64_t key)
+{
+   for (chained_node_s **link = &t->buckets[key_hash(key) & (t->bucket_count - 1)]; *link; link = &(*link)->next)
+      if ((*link)->key == key)
+      {
+         chained_node_s *const node = *link;
+         *link = node->next;
+         free(node);
+         t->len--;
+         return true;
+      }
+   return false;
+}
+
+typedef struct
+{
+   double insert;
+   double hit;
+   double miss;
+   double remove;
+} times_s;
+
+/* the same phases for both tables */
+#define RUN(insert_fn, get_fn, remove_fn, table, keys, order, absent, n, times, sum) \
+   do \
+   { \
+      double t = now_seconds(); \
+      for (size_t i = 0; i < (n); i++) \
+         if (!insert_fn(table, (keys)[i], i)) \
+            return 1; \
+      (times).insert = now_seconds() - t; \
+\
+      t = now_seconds(); \
+      for (size_t i = 0; i < (n); i++) \
+         (sum) += *get_fn(table, (keys)[(order)[i]]); \
+      (times).hit = now_seconds() - t; \
+\
+      t = now_seconds(); \
+      for (size_t i = 0; i < (n); i++) \
+         (sum) += (get_fn(table, (absent)[i]) != NULL); \
+      (times).miss = now_seconds() - t; \
+\
+      t = now_seconds(); \
+      for (size_t i = 0; i < (n); i += 2) \
+         (sum) += remove_fn(table, (keys)[(order)[i]]); \
+      (times).remove = now_seconds() - t; \
+   } while (0)
+
+#define MAP_INSERT(map, key, value) hashmap_insert(uint64_t, uint64_t, map, key, value)
+#define MAP_GET(map, key) hashmap_get(uint64_t, uint64_t, map, key)
+#define MAP_REMOVE(map, key) hashmap_remove(uint64_t, uint64_t, map, key)
+
+static void report(const char *name, const times_s *t, const size_t n, const double megabytes)
+{
+   printf("  %-8s insert %6.1f ns  hit %6.1f ns  miss %6.1f ns  remove %6.1f ns  %8.2f MB\n", name,
+      t->insert * 1e9 / n, t->hit * 1e9 / n, t->miss * 1e9 / n, t->remove * 1e9 / ((n + 1) / 2), megabytes);
+}
+
+int main(int argc, char **argv)
+{
+   const size_t n = (argc > 1) ? (size_t)atol(argv[1]) : 1000000;
+
+   uint64_t *keys = malloc(sizeof(uint64_t) * n);
+   uint64_t *absent = malloc(sizeof(uint64_t) * n);
+   size_t *order = malloc(sizeof(size_t) * n);
+   if (!keys || !absent || !order)
+      return 1;
+   // odd keys are inserted, even keys are absent
+   uint64_t seed = 88172645463325252ull;
+   for (size_t i = 0; i < n; i++)
+   {
+      keys[i] = next_random(&seed) | 1;
+      absent[i] = next_random(&seed) & ~(uint64_t)1;
+      order[i] = i;
+   }
+   for (size_t i = n; i > 1; i--)
+   {
+      const size_t j = next_random(&seed) % i;
+      const size_t tmp = order[i - 1];
+      order[i - 1] = order[j];
+      order[j] = tmp;
+   }
+
+   uint64_t sum = 0;
+   times_s map_times, chained_times;
+   double map_mb, chained_mb;
+   {
+      hashmap(uint64_t, uint64_t) map;
+      hashmap_init(uint64_t, uint64_t, &map);
+      uint64_t_uint64_t_hashmap_s *const table = &map;
+      RUN(MAP_INSERT, MAP_GET, MAP_REMOVE, table, keys, order, absent, n, map_times, sum);
+      map_mb = (double)map.capacity * (1 + sizeof(map.entries[0])) / 1e6;
+      hashmap_delete(uint64_t, uint64_t, &map);
+   }
+   {
+      chained_s chained;
+      if (!chained_init(&chained))
+         return 1;
+      chained_s *const table = &chained;
+      RUN(chained_insert, chained_get, chained_remove, table, keys, order, absent, n, chained_times, sum);
+      // malloc rounds each 24-byte node up to a 32-byte chunk on glibc
+      chained_mb = ((double)chained.bucket_count * sizeof(chained_node_s*) + (double)n * 32) / 1e6;
+      chained_delete(&chained);
+   }
+
+   printf("%zu keys, uint64_t -> uint64_t (checksum %llu)\n", n, (unsigned long long)sum);
+   report("hashmap", &map_times, n, map_mb);
+   report("chained", &chained_times, n, chained_mb);
+
+   free(keys);
+   free(absent);
+   free(order);
+   return 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * Binary heap vs 4-ary heap
+ * -------------------------
+ * The same random uint32_t keys go into a GENERATE_HEAP(..., 2, ...) and a
+ * GENERATE_HEAP(..., 4, ...) of each size:
+ *   - push:     n pushes into an empty heap
+ *   - pop:      n pops until it is empty
+ *   - heapify:  one bulk build of n keys
+ *   - push_pop: n replacements of the top of the full heap
+ * Reports ns per element.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -DNDEBUG -I./build -o build/heap-bench bench/heap/heap.bench.c
+ *   ./build/heap-bench [n ...]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+// distinct names for one key type, so both arities can be generated
+typedef uint32_t key2;
+typedef uint32_t key4;
+
+bool key2_valid(key2 x)
+{
+   (void)x;
+   return true;
+}
+
+bool key4_valid(key4 x)
+{
+   (void)x;
+   return true;
+}
+
+int compare_key2(const key2 *a, const key2 *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+int compare_key4(const key4 *a, const key4 *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+DEFINE_STACK(key2, size_t, 4)
+DEFINE_HEAP(key2, size_t)
+DEFINE_STACK(key4, size_t, 4)
+DEFINE_HEAP(key4, size_t)
+GENERATE_STACK(key2, size_t, 4, 2, key2_valid, malloc, realloc, free)
+GENERATE_HEAP(key2, size_t, 2, compare_key2)
+GENERATE_STACK(key4, size_t, 4, 2, key4_valid, malloc, realloc, free)
+GENERATE_HEAP(key4, size_t, 4, compare_key4)
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+typedef struct
+{
+   double push;
+   double pop;
+   double heapify;
+   double push_pop;
+} times_s;
+
+/* the same phases for both arities */
+#define RUN(type, keys, n, times, sum) \
+   do \
+   { \
+      heap(type) h; \
+      heap_init(type, &h); \
+      double t = now_seconds(); \
+      for (size_t i = 0; i < (n); i++) \
+         if (!heap_push(type, &h, (keys)[i])) \
+            return 1; \
+      (times).push = now_seconds() - t; \
+\
+      t = now_seconds(); \
+      for (size_t i = 0; i < (n); i++) \
+      { \
+         (sum) += heap_peek(type, &h); \
+         heap_pop(type, &h); \
+      } \
+      (times).pop = now_seconds() - t; \
+\
+      t = now_seconds(); \
+      if (!heap_heapify(type, &h, (keys), (n))) \
+         return 1; \
+      (times).heapify = now_seconds() - t; \
+\
+      t = now_seconds(); \
+      for (size_t i = 0; i < (n); i++) \
+         (sum) += heap_push_pop(type, &h, (keys)[i] ^ 0x5555u); \
+      (times).push_pop = now_seconds() - t; \
+      heap_delete(type, &h); \
+   } while (0)
+
+static void report(const char *name, const times_s *t, const size_t n)
+{
+   printf("  %-6s push %6.1f ns  pop %6.1f ns  heapify %5.1f ns  push_pop %6.1f ns\n", name,
+      t->push * 1e9 / n, t->pop * 1e9 / n, t->heapify * 1e9 / n, t->push_pop * 1e9 / n);
+}
+
+int main(int argc, char **argv)
+{
+   static const size_t defaults[] = { 1 << 16, 1 << 20, 1 << 24 };
+   const int runs = (argc > 1) ? argc - 1 : (int)(sizeof(defaults) / sizeof(defaults[0]));
+
+   for (int r = 0; r < runs; r++)
+   {
+      const size_t n = (argc > 1) ? (size_t)atol(argv[r + 1]) : defaults[r];
+      uint32_t *keys = malloc(sizeof(uint32_t) * n);
+      if (!keys)
+         return 1;
+      uint64_t seed = 88172645463325252ull;
+      for (size_t i = 0; i < n; i++)
+         keys[i] = (uint32_t)next_random(&seed);
+
+      uint64_t sum = 0;
+      times_s binary, quaternary;
+      RUN(key2, keys, n, binary, sum);
+      RUN(key4, keys, n, quaternary, sum);
+
+      printf("%zu keys (checksum %llu)\n", n, (unsigned long long)sum);
+      report("2-ary", &binary, n);
+      report("4-ary", &quaternary, n);
+      free(keys);
+   }
+   return 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * MEMORY_COPY_LARGE vs memcpy
+ * ---------------------------
+ * A `working_set` buffer is read until it is cache resident, then a
+ * `size` byte buffer is copied with each kernel, then the working set is
+ * read again. Reports the copy bandwidth and the cost of the second read
+ * per 64-byte line: a copy that streams past the caches leaves the working
+ * set resident, a copy through the caches evicts it.
+ *
+ * The stream threshold is a quarter of the last level cache size unless
+ * MEMORY_COPY_STREAM_THRESHOLD is defined, so pick `size` above it, or
+ * build with e.g. -DMEMORY_COPY_STREAM_THRESHOLD=4194304.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -DNDEBUG -I./build -o build/memory-copy-bench bench/memory-copy/memory-copy.bench.c
+ *   ./build/memory-copy-bench [size_mib] [working_set_kib] [reps]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "ccoutils.h"
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* one load per 64-byte line; the sum keeps the loads alive */
+static uint64_t touch(const uint64_t *const words, const size_t count)
+{
+   uint64_t sum = 0;
+   for (size_t i = 0; i < count; i += 8)
+      sum += words[i];
+   return sum;
+}
+
+/* memcpy through a pointer, so the compiler cannot substitute its own expansion */
+static void *(*volatile libc_memcpy)(void *, const void *, size_t) = memcpy;
+
+typedef struct
+{
+   double copy;   // seconds per copy
+   double reread; // seconds per working set read after the copy
+} result_s;
+
+#define RUN(kernel, dest, src, size, working, working_words, reps, sum) \
+   ({ \
+      result_s r = { 0, 0 }; \
+      for (int rep = 0; rep < (reps); rep++) \
+      { \
+         for (int warm = 0; warm < 4; warm++) \
+            (sum) += touch((working), (working_words)); \
+         double t = now_seconds(); \
+         kernel((dest), (src), (size)); \
+         r.copy += now_seconds() - t; \
+         t = now_seconds(); \
+         (sum) += touch((working), (working_words)); \
+         r.reread += now_seconds() - t; \
+         (sum) += ((const unsigned char*)(dest))[rep % (size)]; \
+      } \
+      r.copy /= (reps); \
+      r.reread /= (reps); \
+      r; \
+   })
+
+#define LIBC_COPY(dest, src, size) libc_memcpy(dest, src, size)
+#define LARGE_COPY(dest, src, size) MEMORY_COPY_LARGE(dest, src, size)
+
+int main(int argc, char **argv)
+{
+   const size_t size = ((argc > 1) ? (size_t)atol(argv[1]) : 256) << 20;
+   const size_t working_bytes = ((argc > 2) ? (size_t)atol(argv[2]) : 1024) << 10;
+   const int reps = (argc > 3) ? atoi(argv[3]) : 10;
+   const size_t working_words = working_bytes / sizeof(uint64_t);
+
+   unsigned char *src = malloc(size);
+   unsigned char *dest = malloc(size);
+   uint64_t *working = malloc(working_bytes);
+   if (!src || !dest || !working)
+      return 1;
+   for (size_t i = 0; i < size; i++)
+      src[i] = (unsigned char)(i * 131);
+   memset(dest, 0, size);
+   for (size_t i = 0; i < working_words; i++)
+      working[i] = i;
+
+   uint64_t sum = 0;
+   double t = now_seconds();
+   sum += touch(working, working_words);
+   const double cold = now_seconds() - t;
+   for (int warm = 0; warm < 4; warm++)
+      sum += touch(working, working_words);
+   t = now_seconds();
+   sum += touch(working, working_words);
+   const double hot = now_seconds() - t;
+
+   const result_s libc = RUN(LIBC_COPY, dest, src, size, working, working_words, reps, sum);
+   const result_s large = RUN(LARGE_COPY, dest, src, size, working, working_words, reps, sum);
+   if (memcmp(dest, src, size) != 0)
+      printf("MISMATCH\n");
+
+   const double lines = (double)working_bytes / 64;
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+   printf("copy %zu MiB, stream threshold %zu MiB, working set %zu KiB (checksum %llu)\n",
+      size >> 20, memory_stream_threshold() >> 20, working_bytes >> 10, (unsigned long long)sum);
+#else
+   printf("copy %zu MiB, working set %zu KiB (checksum %llu)\n", size >> 20, working_bytes >> 10, (unsigned long long)sum);
+#endif
+   printf("working set read: hot %.2f ns/line, cold %.2f ns/line\n", hot * 1e9 / lines, cold * 1e9 / lines);
+   printf("memcpy            : %6.2f GB/s, working set read after %.2f ns/line\n",
+      (double)size / libc.copy * 1e-9, libc.reread * 1e9 / lines);
+   printf("MEMORY_COPY_LARGE : %6.2f GB/s, working set read after %.2f ns/line\n",
+      (double)size / large.copy * 1e-9, large.reread * 1e9 / lines);
+
+   free(src);
+   free(dest);
+   free(working);
+   return 0;
+}
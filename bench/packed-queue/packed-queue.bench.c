@@ -0,0 +1,140 @@
+/**
+ * Bit-packed queue vs queue of 1-byte enums
+ * -----------------------------------------
+ * `count` 2-bit states in a queue(state_e) and a packed_queue(state_e),
+ * same operations on both:
+ *   - enque every state
+ *   - scan: `passes` times, histogram of the states front to back
+ *     (queue: indexed loads; packed: unpack 4096 at a time into a byte buffer)
+ *   - drain: deque everything in batches of 4096
+ * Reports ns per element and the bytes held by each.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -march=native -DNDEBUG -I./build -o build/packed-queue-bench bench/packed-queue/packed-queue.bench.c
+ *   ./build/packed-queue-bench [count] [passes]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+typedef PACKED_ENUM(state_e) { STATE_IDLE, STATE_RUNNING, STATE_BLOCKED, STATE_DONE, STATE_COUNT } state_e;
+
+bool state_valid(state_e s)
+{
+   return s < STATE_COUNT;
+}
+
+#define STATE_BITS PACKED_BITS_FOR(STATE_COUNT)
+#define BATCH 4096
+
+DEFINE_QUEUE(state_e, uint32_t, 64)
+DEFINE_PACKED_QUEUE(state_e, STATE_BITS, uint32_t, 64)
+GENERATE_QUEUE(state_e, uint32_t, 64, 2, state_valid, malloc, realloc, free)
+GENERATE_PACKED_QUEUE(state_e, STATE_BITS, uint32_t, 64, 2, malloc, realloc, free)
+
+static uint64_t next_random(uint64_t *state)
+{
+   *state ^= *state << 13;
+   *state ^= *state >> 7;
+   *state ^= *state << 17;
+   return *state;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv)
+{
+   const uint32_t n = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 50000000;
+   const int passes = argc > 2 ? atoi(argv[2]) : 10;
+   static uint8_t batch[BATCH];
+   uint64_t sink = 0;
+
+   // one byte per state
+   {
+      queue(state_e) q;
+      queue_init(state_e, &q);
+      uint64_t seed = 0x9E3779B97F4A7C15ull;
+      double t = now_seconds();
+      for (uint32_t i = 0; i < n; i++)
+         queue_enque(state_e, &q, (state_e)(next_random(&seed) & 3));
+      const double enque = now_seconds() - t;
+
+      const uint32_t mask = q.size - 1;
+      t = now_seconds();
+      for (int p = 0; p < passes; p++)
+      {
+         uint64_t hist[STATE_COUNT] = { 0 };
+         for (uint32_t i = 0; i < q.len; i++)
+            hist[q.values[(q.front + i) & mask]]++;
+         sink += hist[STATE_DONE];
+      }
+      const double scan = now_seconds() - t;
+
+      t = now_seconds();
+      while (q.len != 0)
+      {
+         const uint32_t k = q.len < BATCH ? q.len : BATCH;
+         for (uint32_t i = 0; i < k; i++)
+            batch[i] = q.values[(q.front + i) & mask];
+         sink += batch[k - 1];
+         q.front = (q.front + k) & mask;
+         q.len -= k;
+      }
+      const double drain = now_seconds() - t;
+
+      printf("  queue         enque %5.2f ns  scan %5.3f ns  drain %5.3f ns  %8.1f MB\n", enque * 1e9 / n,
+             scan * 1e9 / ((double)n * passes), drain * 1e9 / n, (double)q.size / 1e6);
+      queue_delete(state_e, &q);
+   }
+
+   // STATE_BITS bits per state
+   {
+      packed_queue(state_e) q;
+      packed_queue_init(state_e, &q);
+      uint64_t seed = 0x9E3779B97F4A7C15ull;
+      double t = now_seconds();
+      for (uint32_t i = 0; i < n; i++)
+         packed_queue_enque(state_e, &q, (state_e)(next_random(&seed) & 3));
+      const double enque = now_seconds() - t;
+
+      t = now_seconds();
+      for (int p = 0; p < passes; p++)
+      {
+         uint64_t hist[STATE_COUNT] = { 0 };
+         for (uint32_t from = 0; from < q.len; from += BATCH)
+         {
+            const uint32_t k = q.len - from < BATCH ? q.len - from : BATCH;
+            packed_queue_unpack(state_e, &q, from, k, batch);
+            for (uint32_t i = 0; i < k; i++)
+               hist[batch[i]]++;
+         }
+         sink += hist[STATE_DONE];
+      }
+      const double scan = now_seconds() - t;
+
+      const double bytes = (double)packed_queue_bytes(state_e, &q, STATE_BITS);
+      t = now_seconds();
+      while (!packed_queue_empty(state_e, &q))
+      {
+         const uint32_t k = q.len < BATCH ? q.len : BATCH;
+         packed_queue_unpack(state_e, &q, 0, k, batch);
+         sink += batch[k - 1];
+         packed_queue_deque_n(state_e, &q, k);
+      }
+      const double drain = now_seconds() - t;
+
+      printf("  packed_queue  enque %5.2f ns  scan %5.3f ns  drain %5.3f ns  %8.1f MB\n", enque * 1e9 / n,
+             scan * 1e9 / ((double)n * passes), drain * 1e9 / n, bytes / 1e6);
+      packed_queue_delete(state_e, &q);
+   }
+
+   printf("(%llu)\n", (unsigned long long)sink);
+   return 0;
+}
@@ -0,0 +1,190 @@
+/**
+ * Parallel passes and sorts: thread scaling
+ * -----------------------------------------
+ * On a stack(double) of `n` elements and a stack(int) of `n` random ints:
+ *   - for_each:  x = x * 0.5 + 1 (memory bound)
+ *   - transform: 32 dependent multiply-adds per element (compute bound)
+ *   - reduce:    sum into a double
+ *   - sort:      stable merge sort (stack_parallel_sort); the serial radix
+ *                sort is timed once as a reference
+ * Each is run serially (NULL pool) and on pools of 1, 2, 4, ... threads up
+ * to `threads` (default: one per online CPU), and reported as the best of
+ * `reps` runs with the speedup over serial. Pools larger than the CPU count
+ * only measure the pool's overhead.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -DNDEBUG -I./build -o build/parallel-bench bench/parallel/parallel.bench.c -lpthread
+ *   ./build/parallel-bench [n] [threads] [reps]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "ccoutils.h"
+
+bool double_valid(double x)
+{
+   (void)x;
+   return true;
+}
+
+bool int_valid(int x)
+{
+   (void)x;
+   return true;
+}
+
+DEFINE_STACK(double, size_t, 16)
+DEFINE_STACK_PARALLEL(double, size_t, double)
+GENERATE_STACK(double, size_t, 16, 2, double_valid, malloc, realloc, free)
+GENERATE_STACK_PARALLEL(double, size_t, double)
+
+DEFINE_STACK(int, size_t, 16)
+DEFINE_STACK_SORT(int, size_t)
+DEFINE_STACK_PARALLEL_SORT(int, size_t)
+GENERATE_STACK(int, size_t, 16, 2, int_valid, malloc, realloc, free)
+GENERATE_STACK_SORT(int, size_t, int, 0, malloc, free)
+GENERATE_STACK_PARALLEL_SORT(int, size_t, malloc, free)
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static void halve_add(double *x, void *ctx)
+{
+   (void)ctx;
+   *x = *x * 0.5 + 1.0;
+}
+
+static double polynomial(double x, void *ctx)
+{
+   (void)ctx;
+   double y = x;
+   for (int i = 0; i < 32; i++)
+      y = y * 0.999 + 0.001;
+   return y;
+}
+
+static double add_value(double acc, const double *x, void *ctx)
+{
+   (void)ctx;
+   return acc + *x;
+}
+
+static double add(double a, double b)
+{
+   return a + b;
+}
+
+static int compare_int(const int *a, const int *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+typedef struct
+{
+   double for_each;
+   double transform;
+   double reduce;
+   double sort;
+} times_s;
+
+static double min_time(double a, double b)
+{
+   return (a < b) ? a : b;
+}
+
+/* best of `reps` for every workload; pool NULL runs serially */
+static times_s run(parallel_pool_s *pool, stack(double) *values, stack(int) *ints, const int *shuffled, int reps, double *checksum)
+{
+   times_s best = { 1e30, 1e30, 1e30, 1e30 };
+   for (int rep = 0; rep < reps; rep++)
+   {
+      double t = now_seconds();
+      stack_parallel_for_each(double, values, pool, halve_add, NULL);
+      best.for_each = min_time(best.for_each, now_seconds() - t);
+
+      t = now_seconds();
+      stack_parallel_transform(double, values, pool, polynomial, NULL);
+      best.transform = min_time(best.transform, now_seconds() - t);
+
+      t = now_seconds();
+      *checksum += stack_parallel_reduce(double, values, pool, 0.0, add_value, add, NULL);
+      best.reduce = min_time(best.reduce, now_seconds() - t);
+
+      memcpy(ints->values, shuffled, sizeof(int) * ints->len);
+      t = now_seconds();
+      if (pool)
+         stack_parallel_sort(int, ints, pool, compare_int);
+      else
+         stack_sort(int, ints, compare_int);
+      best.sort = min_time(best.sort, now_seconds() - t);
+      *checksum += ints->values[ints->len / 2];
+   }
+   return best;
+}
+
+static void report(const char *label, const times_s *t, const times_s *serial)
+{
+   printf("%-10s %8.1f %5.2fx %8.1f %5.2fx %8.1f %5.2fx %8.1f %5.2fx\n", label,
+      t->for_each * 1e3, serial->for_each / t->for_each,
+      t->transform * 1e3, serial->transform / t->transform,
+      t->reduce * 1e3, serial->reduce / t->reduce,
+      t->sort * 1e3, serial->sort / t->sort);
+}
+
+int main(int argc, char **argv)
+{
+   const size_t n = (argc > 1) ? (size_t)atol(argv[1]) : 16000000;
+   const long online = sysconf(_SC_NPROCESSORS_ONLN);
+   const size_t max_threads = (argc > 2) ? (size_t)atol(argv[2]) : (online > 0 ? (size_t)online : 1);
+   const int reps = (argc > 3) ? atoi(argv[3]) : 3;
+
+   stack(double) values;
+   stack(int) ints;
+   stack_init(double, &values);
+   stack_init(int, &ints);
+   int *shuffled = malloc(sizeof(int) * n);
+   if (!shuffled)
+      return 1;
+   uint64_t seed = 1;
+   for (size_t i = 0; i < n; i++)
+   {
+      seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+      shuffled[i] = (int)(seed >> 33);
+      if (!stack_push(double, &values, (double)(i % 1000)) || !stack_push(int, &ints, shuffled[i]))
+         return 1;
+   }
+
+   double checksum = 0;
+   memcpy(ints.values, shuffled, sizeof(int) * n);
+   double t = now_seconds();
+   stack_radix_sort(int, &ints);
+   const double radix = now_seconds() - t;
+
+   printf("%zu elements, %ld online CPUs, best of %d (ms, speedup over serial)\n", n, online, reps);
+   printf("%-10s %15s %15s %15s %15s\n", "threads", "for_each", "transform", "reduce", "merge sort");
+   const times_s serial = run(NULL, &values, &ints, shuffled, reps, &checksum);
+   report("serial", &serial, &serial);
+   for (size_t threads = 1; threads <= max_threads; threads *= 2)
+   {
+      parallel_pool_s pool;
+      if (!parallel_pool_init(&pool, threads))
+         return 1;
+      const times_s times = run(&pool, &values, &ints, shuffled, reps, &checksum);
+      char label[16];
+      snprintf(label, sizeof(label), "%zu", threads);
+      report(label, &times, &serial);
+      parallel_pool_delete(&pool);
+   }
+   printf("serial radix sort %.1f ms (checksum %g)\n", radix * 1e3, checksum);
+
+   stack_delete(double, &values);
+   stack_delete(int, &ints);
+   free(shuffled);
+   return 0;
+}
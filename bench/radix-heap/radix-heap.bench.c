@@ -0,0 +1,184 @@
+/**
+ * Radix heap vs binary heap
+ * -------------------------
+ * Two monotone workloads on uint32_t keys, same elements in both queues:
+ *   - dijkstra: random CSR graph, integer weights, duplicate pushes instead
+ *     of decrease-key (stale entries are skipped when popped)
+ *   - timers:   a sliding window of timeouts, popped as the clock advances
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -DNDEBUG -I./build -o build/radix-heap-bench bench/radix-heap/radix-heap.bench.c
+ *   ./build/radix-heap-bench [vertices] [degree] [timers]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+typedef struct
+{
+   uint32_t key;
+   uint32_t vertex;
+} item_s;
+
+bool item_valid(item_s x)
+{
+   (void)x;
+   return true;
+}
+
+int compare_item(const item_s *a, const item_s *b)
+{
+   return (a->key > b->key) - (a->key < b->key);
+}
+
+DEFINE_STACK(item_s, uint32_t, 4)
+DEFINE_HEAP(item_s, uint32_t)
+DEFINE_RADIX_HEAP(item_s, uint32_t, uint32_t)
+GENERATE_STACK(item_s, uint32_t, 4, 2, item_valid, malloc, realloc, free)
+GENERATE_HEAP(item_s, uint32_t, 2, compare_item)
+GENERATE_RADIX_HEAP(item_s, uint32_t, uint32_t, offsetof(item_s, key))
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 17;
+   *seed ^= *seed << 5;
+   return *seed;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+typedef struct
+{
+   uint32_t vertices;
+   const uint32_t *offset;
+   const uint32_t *to;
+   const uint32_t *weight;
+} graph_s;
+
+/* the same loop for both queues; returns a checksum of the distances */
+#define DIJKSTRA(queue, graph, dist) \
+   do \
+   { \
+      for (uint32_t v = 0; v < (graph)->vertices; v++) \
+         (dist)[v] = UINT32_MAX; \
+      (dist)[0] = 0; \
+      queue##_push(item_s, &q, ((item_s){ .key = 0, .vertex = 0 })); \
+      while (!queue##_empty(item_s, &q)) \
+      { \
+         const item_s top = queue##_peek(item_s, &q); \
+         queue##_pop(item_s, &q); \
+         if (top.key > (dist)[top.vertex]) \
+            continue; \
+         for (uint32_t e = (graph)->offset[top.vertex]; e < (graph)->offset[top.vertex + 1]; e++) \
+         { \
+            const uint32_t d = top.key + (graph)->weight[e]; \
+            if (d < (dist)[(graph)->to[e]]) \
+            { \
+               (dist)[(graph)->to[e]] = d; \
+               queue##_push(item_s, &q, ((item_s){ .key = d, .vertex = (graph)->to[e] })); \
+            } \
+         } \
+      } \
+   } while (0)
+
+/* keeps `window` timers queued: each pop schedules a new one at now + timeout */
+#define TIMERS(queue, window, count, sum) \
+   do \
+   { \
+      uint32_t seed = 7; \
+      for (uint32_t i = 0; i < (window); i++) \
+         queue##_push(item_s, &q, ((item_s){ .key = next_random(&seed) % 60000, .vertex = i })); \
+      for (uint32_t i = 0; i < (count); i++) \
+      { \
+         const item_s top = queue##_peek(item_s, &q); \
+         queue##_pop(item_s, &q); \
+         (sum) += top.key; \
+         queue##_push(item_s, &q, ((item_s){ .key = top.key + 1 + next_random(&seed) % 60000, .vertex = top.vertex })); \
+      } \
+   } while (0)
+
+int main(int argc, char **argv)
+{
+   const uint32_t vertices = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000000;
+   const uint32_t degree = (argc > 2) ? (uint32_t)atoi(argv[2]) : 8;
+   const uint32_t window = (argc > 3) ? (uint32_t)atoi(argv[3]) : 1000000;
+   const size_t edges = (size_t)vertices * degree;
+
+   uint32_t *offset = malloc(sizeof(uint32_t) * (vertices + 1));
+   uint32_t *to = malloc(sizeof(uint32_t) * edges);
+   uint32_t *weight = malloc(sizeof(uint32_t) * edges);
+   uint32_t *dist = malloc(sizeof(uint32_t) * vertices);
+   if (!offset || !to || !weight || !dist)
+      return 1;
+   uint32_t seed = 1;
+   for (uint32_t v = 0; v <= vertices; v++)
+      offset[v] = v * degree;
+   for (size_t e = 0; e < edges; e++)
+   {
+      to[e] = next_random(&seed) % vertices;
+      weight[e] = next_random(&seed) % 100000;
+   }
+   const graph_s graph = { vertices, offset, to, weight };
+
+   uint64_t heap_sum = 0, radix_sum = 0;
+   double t = now_seconds();
+   {
+      heap(item_s) q;
+      heap_init(item_s, &q);
+      DIJKSTRA(heap, &graph, dist);
+      heap_delete(item_s, &q);
+      for (uint32_t v = 0; v < vertices; v++)
+         heap_sum += dist[v];
+   }
+   const double heap_dijkstra = now_seconds() - t;
+
+   t = now_seconds();
+   {
+      radix_heap(item_s) q;
+      radix_heap_init(item_s, &q);
+      DIJKSTRA(radix_heap, &graph, dist);
+      radix_heap_delete(item_s, &q);
+      for (uint32_t v = 0; v < vertices; v++)
+         radix_sum += dist[v];
+   }
+   const double radix_dijkstra = now_seconds() - t;
+   printf("dijkstra %u vertices, %zu edges: heap %.3fs, radix heap %.3fs%s\n",
+      vertices, edges, heap_dijkstra, radix_dijkstra, (heap_sum == radix_sum) ? "" : " (MISMATCH)");
+
+   // keys are 32 bits: keep the clock well below the wrap
+   const uint32_t count = 8 * window;
+   heap_sum = radix_sum = 0;
+   t = now_seconds();
+   {
+      heap(item_s) q;
+      heap_init(item_s, &q);
+      TIMERS(heap, window, count, heap_sum);
+      heap_delete(item_s, &q);
+   }
+   const double heap_timers = now_seconds() - t;
+
+   t = now_seconds();
+   {
+      radix_heap(item_s) q;
+      radix_heap_init(item_s, &q);
+      TIMERS(radix_heap, window, count, radix_sum);
+      radix_heap_delete(item_s, &q);
+   }
+   const double radix_timers = now_seconds() - t;
+   printf("timers %u queued, %u expiries: heap %.1f ns/op, radix heap %.1f ns/op%s\n",
+      window, count, heap_timers * 1e9 / count, radix_timers * 1e9 / count, (heap_sum == radix_sum) ? "" : " (MISMATCH)");
+
+   free(offset);
+   free(to);
+   free(weight);
+   free(dist);
+   return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * Structure-of-arrays queue vs queue of structs
+ * ---------------------------------------------
+ * `count` particles of 32 bytes (position, velocity, mass, id, flags) in
+ * a queue(particle_s) and a soa_queue(particle_s), same operations on both:
+ *   - enque every particle, then `passes` times:
+ *   - sum: total of one field (x)
+ *   - step: x += vx, y += vy
+ * Reports ns per element for each.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -march=native -DNDEBUG -I./build -o build/soa-bench bench/soa/soa.bench.c
+ *   ./build/soa-bench [count] [passes]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+typedef struct
+{
+   float x, y;
+   float vx, vy;
+   float mass;
+   uint32_t id;
+   uint64_t flags;
+} particle_s;
+#define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(float, vx) X(float, vy) X(float, mass) X(uint32_t, id) X(uint64_t, flags)
+
+bool particle_valid(particle_s p)
+{
+   return true;
+}
+
+DEFINE_QUEUE(particle_s, uint32_t, 16)
+DEFINE_SOA_QUEUE(particle_s, PARTICLE_FIELDS, uint32_t)
+GENERATE_QUEUE(particle_s, uint32_t, 16, 2, particle_valid, malloc, realloc, free)
+GENERATE_SOA_QUEUE(particle_s, PARTICLE_FIELDS, uint32_t, 16, 2, particle_valid, malloc, free)
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+static particle_s make_particle(uint32_t i)
+{
+   return (particle_s){ (float)(i % 1000), (float)(i % 777), 0.001f * (float)(i % 13), -0.002f * (float)(i % 7), 1.0f, i, 0 };
+}
+
+int main(int argc, char **argv)
+{
+   const uint32_t n = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 10000000;
+   const int passes = argc > 2 ? atoi(argv[2]) : 10;
+   double sink = 0;
+
+   // array of structs
+   {
+      queue(particle_s) q;
+      queue_init(particle_s, &q);
+      double t = now_seconds();
+      for (uint32_t i = 0; i < n; i++)
+         queue_enque(particle_s, &q, make_particle(i));
+      const double enque = now_seconds() - t;
+
+      const uint32_t mask = q.size - 1;
+      t = now_seconds();
+      for (int p = 0; p < passes; p++)
+      {
+         float sum = 0;
+         for (uint32_t i = 0; i < q.len; i++)
+            sum += q.values[(q.front + i) & mask].x;
+         sink += sum;
+      }
+      const double sum = now_seconds() - t;
+
+      t = now_seconds();
+      for (int p = 0; p < passes; p++)
+         for (uint32_t i = 0; i < q.len; i++)
+         {
+            particle_s *const e = &q.values[(q.front + i) & mask];
+            e->x += e->vx;
+            e->y += e->vy;
+         }
+      const double step = now_seconds() - t;
+      sink += q.values[q.front].x;
+
+      printf("  queue      enque %5.2f ns  sum %5.2f ns  step %5.2f ns\n", enque * 1e9 / n, sum * 1e9 / ((double)n * passes), step * 1e9 / ((double)n * passes));
+      queue_delete(particle_s, &q);
+   }
+
+   // structure of arrays
+   {
+      soa_queue(particle_s) q;
+      soa_queue_init(particle_s, &q);
+      double t = now_seconds();
+      for (uint32_t i = 0; i < n; i++)
+         soa_queue_enque(particle_s, &q, make_particle(i));
+      const double enque = now_seconds() - t;
+
+      t = now_seconds();
+      for (int p = 0; p < passes; p++)
+      {
+         float sum = 0;
+         for (unsigned part = 0; part < 2; part++)
+         {
+            uint32_t start;
+            const uint32_t len = soa_queue_span(particle_s, &q, part, &start);
+            const float *x = q.x + start;
+            for (uint32_t i = 0; i < len; i++)
+               sum += x[i];
+         }
+         sink += sum;
+      }
+      const double sum = now_seconds() - t;
+
+      t = now_seconds();
+      for (int p = 0; p < passes; p++)
+         for (unsigned part = 0; part < 2; part++)
+         {
+            uint32_t start;
+            const uint32_t len = soa_queue_span(particle_s, &q, part, &start);
+            float *restrict x = q.x + start, *restrict y = q.y + start;
+            const float *restrict vx = q.vx + start, *restrict vy = q.vy + start;
+            for (uint32_t i = 0; i < len; i++)
+            {
+               x[i] += vx[i];
+               y[i] += vy[i];
+            }
+         }
+      const double step = now_seconds() - t;
+      sink += soa_queue_front(particle_s, &q, x);
+
+      printf("  soa_queue  enque %5.2f ns  sum %5.2f ns  step %5.2f ns\n", enque * 1e9 / n, sum * 1e9 / ((double)n * passes), step * 1e9 / ((double)n * passes));
+      soa_queue_delete(particle_s, &q);
+   }
+
+   printf("(%g)\n", sink);
+   return 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * Stack sorts vs qsort
+ * --------------------
+ * The same random keys, copied into a stack and sorted three ways:
+ *   - qsort:      the C library sort on the stack's array
+ *   - sort:       stack_sort, the stable bottom-up merge sort
+ *   - radix_sort: stack_radix_sort, the stable LSD radix sort
+ * for uint32_t keys and for 16-byte records sorted by a double field.
+ * Reports ns per element, best of `reps` runs.
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -march=native -DNDEBUG -I./build -o build/sort-bench bench/sort/sort.bench.c
+ *   ./build/sort-bench [n] [reps]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "ccoutils.h"
+
+typedef struct
+{
+   double score;
+   uint64_t id;
+} record_s;
+
+bool uint32_t_valid(uint32_t x)
+{
+   (void)x;
+   return true;
+}
+
+bool record_valid(record_s x)
+{
+   (void)x;
+   return true;
+}
+
+DEFINE_STACK(uint32_t, size_t, 16)
+DEFINE_STACK_SORT(uint32_t, size_t)
+GENERATE_STACK(uint32_t, size_t, 16, 2, uint32_t_valid, malloc, realloc, free)
+GENERATE_STACK_SORT(uint32_t, size_t, uint32_t, 0, malloc, free)
+
+DEFINE_STACK(record_s, size_t, 16)
+DEFINE_STACK_SORT(record_s, size_t)
+GENERATE_STACK(record_s, size_t, 16, 2, record_valid, malloc, realloc, free)
+GENERATE_STACK_SORT(record_s, size_t, double, offsetof(record_s, score), malloc, free)
+
+static int compare_uint32_t(const uint32_t *a, const uint32_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+static int compare_record_s(const record_s *a, const record_s *b)
+{
+   return (a->score > b->score) - (a->score < b->score);
+}
+
+/* qsort takes void pointers */
+static int qsort_uint32_t(const void *a, const void *b)
+{
+   return compare_uint32_t((const uint32_t*)a, (const uint32_t*)b);
+}
+
+static int qsort_record_s(const void *a, const void *b)
+{
+   return compare_record_s((const record_s*)a, (const record_s*)b);
+}
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+/* best time of `reps` runs of `sort_call`, each on a fresh copy of `keys` */
+#define TIME_SORT(type, stack, keys, n, reps, best, sort_call) \
+   do \
+   { \
+      (best) = 1e30; \
+      for (int rep = 0; rep < (reps); rep++) \
+      { \
+         memcpy((stack)->values, (keys), sizeof(type) * (n)); \
+         (stack)->len = (n); \
+         const double t = now_seconds(); \
+         sort_call; \
+         const double elapsed = now_seconds() - t; \
+         (best) = (elapsed < (best)) ? elapsed : (best); \
+         for (size_t i = 1; i < (n); i++) \
+            if (compare_##type(&(stack)->values[i - 1], &(stack)->values[i]) > 0) \
+               return 1; \
+      } \
+   } while (0)
+
+int main(int argc, char **argv)
+{
+   const size_t n = (argc > 1) ? (size_t)atol(argv[1]) : 2000000;
+   const int reps = (argc > 2) ? atoi(argv[2]) : 3;
+   uint64_t seed = 88172645463325252ull;
+   double q, m, r;
+
+   {
+      uint32_t *keys = malloc(sizeof(uint32_t) * n);
+      stack(uint32_t) s;
+      stack_init(uint32_t, &s);
+      if (!keys)
+         return 1;
+      for (size_t i = 0; i < n; i++)
+      {
+         keys[i] = (uint32_t)next_random(&seed);
+         if (!stack_push(uint32_t, &s, keys[i]))
+            return 1;
+      }
+      TIME_SORT(uint32_t, &s, keys, n, reps, q, qsort(s.values, s.len, sizeof(uint32_t), qsort_uint32_t));
+      TIME_SORT(uint32_t, &s, keys, n, reps, m, stack_sort(uint32_t, &s, compare_uint32_t));
+      TIME_SORT(uint32_t, &s, keys, n, reps, r, stack_radix_sort(uint32_t, &s));
+      printf("%zu uint32_t\n", n);
+      printf("  qsort %6.1f ns  sort %6.1f ns (%4.1fx)  radix_sort %6.1f ns (%4.1fx)\n",
+         q * 1e9 / n, m * 1e9 / n, q / m, r * 1e9 / n, q / r);
+      stack_delete(uint32_t, &s);
+      free(keys);
+   }
+   {
+      record_s *keys = malloc(sizeof(record_s) * n);
+      stack(record_s) s;
+      stack_init(record_s, &s);
+      if (!keys)
+         return 1;
+      for (size_t i = 0; i < n; i++)
+      {
+         keys[i].score = (double)(next_random(&seed) >> 11) * 0x1p-53 * 2000.0 - 1000.0;
+         keys[i].id = i;
+         if (!stack_push(record_s, &s, keys[i]))
+            return 1;
+      }
+      TIME_SORT(record_s, &s, keys, n, reps, q, qsort(s.values, s.len, sizeof(record_s), qsort_record_s));
+      TIME_SORT(record_s, &s, keys, n, reps, m, stack_sort(record_s, &s, compare_record_s));
+      TIME_SORT(record_s, &s, keys, n, reps, r, stack_radix_sort(record_s, &s));
+      printf("%zu record_s (16 bytes, double key)\n", n);
+      printf("  qsort %6.1f ns  sort %6.1f ns (%4.1fx)  radix_sort %6.1f ns (%4.1fx)\n",
+         q * 1e9 / n, m * 1e9 / n, q / m, r * 1e9 / n, q / r);
+      stack_delete(record_s, &s);
+      free(keys);
+   }
+   return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * Timing wheel vs indexed heap
+ * ----------------------------
+ * Connection timeouts at a 1 ms tick, same operations on both:
+ *   - `connections` timers, one per connection ID, spread over one timeout
+ *   - every tick `activity` random connections see traffic: cancel and
+ *     re-arm at a random point of the next `timeout` ticks
+ *   - expired connections are re-armed the same way
+ * Reports the re-arm cost per operation and the expiry work per tick
+ * (average, and worst after a 1000 tick warm-up).
+ *
+ * Build & run (from the repository root, after `lua build.lua`):
+ *   gcc -std=gnu11 -O2 -DNDEBUG -I./build -o build/timing-wheel-bench bench/timing-wheel/timing-wheel.bench.c
+ *   ./build/timing-wheel-bench [connections] [activity per tick] [ticks] [timeout]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ccoutils.h"
+
+int compare_u64(const uint64_t *a, const uint64_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+DEFINE_TIMING_WHEEL(uint32_t, uint32_t)
+DEFINE_INDEXED_HEAP(uint64_t, uint32_t)
+GENERATE_TIMING_WHEEL(uint32_t, uint32_t, malloc, free)
+GENERATE_INDEXED_HEAP(uint64_t, uint32_t, 4, compare_u64, malloc, free)
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 17;
+   *seed ^= *seed << 5;
+   return *seed;
+}
+
+/* re-arm delay in 1 .. timeout, the same for both queues whatever the expiry order */
+static uint64_t delay(uint32_t id, uint64_t now, uint32_t timeout)
+{
+   uint64_t h = (now << 32 | id) * 0x9E3779B97F4A7C15ull;
+   return 1 + (h >> 32) % timeout;
+}
+
+static double now_seconds(void)
+{
+   struct timespec t;
+   clock_gettime(CLOCK_MONOTONIC, &t);
+   return (double)t.tv_sec + (double)t.tv_nsec * 1e-9;
+}
+
+typedef struct
+{
+   uint32_t *expired;
+   size_t count;
+} expired_s;
+
+static void on_timeout(uint32_t id, const uint32_t *value, void *ctx)
+{
+   expired_s *const out = (expired_s*)ctx;
+   out->expired[out->count++] = id;
+}
+
+typedef struct
+{
+   double rearm;    // seconds in cancel + schedule
+   double expire;   // seconds in advance / pop, summed over ticks
+   double worst;    // longest single tick of expiry work
+   uint64_t fired;
+} result_s;
+
+static void print_result(const char *name, const result_s *r, uint64_t rearms, uint32_t ticks)
+{
+   printf("  %-14s re-arm %6.1f ns/op, expiry %7.2f us/tick (worst %8.1f us), %llu fired\n",
+      name, r->rearm * 1e9 / rearms, r->expire * 1e6 / ticks, r->worst * 1e6, (unsigned long long)r->fired);
+}
+
+int main(int argc, char **argv)
+{
+   const uint32_t connections = (argc > 1) ? (uint32_t)atoi(argv[1]) : 1000000;
+   const uint32_t activity = (argc > 2) ? (uint32_t)atoi(argv[2]) : 300;
+   const uint32_t ticks = (argc > 3) ? (uint32_t)atoi(argv[3]) : 120000;
+   const uint32_t timeout = (argc > 4) ? (uint32_t)atoi(argv[4]) : 30000;
+   const uint64_t start = 1700000000000ull;   // milliseconds since the epoch
+   const uint32_t warmup = 1000;
+
+   uint32_t *expired = malloc(sizeof(uint32_t) * connections);
+   if (!expired)
+      return 1;
+   const uint64_t rearms = 2 * (uint64_t)activity * ticks;
+
+   result_s wheel_result = { 0 };
+   {
+      timing_wheel(uint32_t) w;
+      timing_wheel_init(uint32_t, &w, start);
+      timing_wheel_reserve(uint32_t, &w, connections);
+      uint32_t seed = 1;
+      for (uint32_t id = 0; id < connections; id++)
+         timing_wheel_schedule(uint32_t, &w, id, start + 1 + next_random(&seed) % timeout, id);
+
+      for (uint64_t now = start + 1; now <= start + ticks; now++)
+      {
+         double t = now_seconds();
+         for (uint32_t i = 0; i < activity; i++)
+         {
+            const uint32_t id = next_random(&seed) % connections;
+            timing_wheel_cancel(uint32_t, &w, id);
+            timing_wheel_schedule(uint32_t, &w, id, now + delay(id, now, timeout), id);
+         }
+         const double m = now_seconds();
+         wheel_result.rearm += m - t;
+
+         expired_s out = { expired, 0 };
+         timing_wheel_advance(uint32_t, &w, now, on_timeout, &out);
+         t = now_seconds() - m;
+         wheel_result.expire += t;
+         if (now > start + warmup && t > wheel_result.worst)
+            wheel_result.worst = t;
+         wheel_result.fired += out.count;
+         for (size_t i = 0; i < out.count; i++)
+            timing_wheel_schedule(uint32_t, &w, expired[i], now + delay(expired[i], now, timeout), expired[i]);
+      }
+      timing_wheel_delete(uint32_t, &w);
+   }
+
+   result_s heap_result = { 0 };
+   {
+      indexed_heap(uint64_t) q;
+      indexed_heap_init(uint64_t, &q);
+      indexed_heap_reserve(uint64_t, &q, connections);
+      uint32_t seed = 1;
+      for (uint32_t id = 0; id < connections; id++)
+         indexed_heap_push(uint64_t, &q, id, start + 1 + next_random(&seed) % timeout);
+
+      for (uint64_t now = start + 1; now <= start + ticks; now++)
+      {
+         double t = now_seconds();
+         for (uint32_t i = 0; i < activity; i++)
+         {
+            const uint32_t id = next_random(&seed) % connections;
+            indexed_heap_remove(uint64_t, &q, id);
+            indexed_heap_push(uint64_t, &q, id, now + delay(id, now, timeout));
+         }
+         const double m = now_seconds();
+         heap_result.rearm += m - t;
+
+         size_t count = 0;
+         while (!indexed_heap_empty(uint64_t, &q) && indexed_heap_peek_key(uint64_t, &q) <= now)
+         {
+            expired[count++] = indexed_heap_peek(uint64_t, &q);
+            indexed_heap_pop(uint64_t, &q);
+         }
+         t = now_seconds() - m;
+         heap_result.expire += t;
+         if (now > start + warmup && t > heap_result.worst)
+            heap_result.worst = t;
+         heap_result.fired += count;
+         for (size_t i = 0; i < count; i++)
+            indexed_heap_push(uint64_t, &q, expired[i], now + delay(expired[i], now, timeout));
+      }
+      indexed_heap_delete(uint64_t, &q);
+   }
+
+   printf("%u connections, %u re-arms per tick, %u ticks, timeout %u ticks:\n", connections, activity, ticks, timeout);
+   print_result("timing wheel", &wheel_result, rearms, ticks);
+   print_result("indexed heap", &heap_result, rearms, ticks);
+   if (wheel_result.fired != heap_result.fired)
+      printf("  (MISMATCH)\n");
+
+   free(expired);
+   return 0;
+}
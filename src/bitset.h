@@ -0,0 +1,624 @@
+#ifndef __BITSET_H
+#define __BITSET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+
+
+/**
+ * Bitset
+ * ------
+ * Growable array of bits, one bit per flag instead of the byte per flag of
+ * a stack(bool). Words are 64 bits, stored like a stack: in an inline
+ * buffer of init_size words first, then on the heap.
+ *
+ * Bits at index >= len are always zero, so count() and the bulk
+ * operations need no masking and a shorter operand reads as zero-extended.
+ */
+#define BITSET_NONE(len_type) ((len_type)-1)
+
+#define BITSET_WORD_BITS 64
+
+/* number of words holding `bits` bits */
+#define BITSET_WORDS(bits) (((size_t)(bits) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+
+/**
+ * Word helpers
+ * ------------
+ * ctz / popcount on 64-bit words, compiler builtins where available
+ * (a popcnt instruction with -mpopcnt or -march=native).
+ */
+
+/* index of the lowest set bit, word != 0 */
+static inline uint32_t bitset_ctz64(const uint64_t word)
+{
+   assert(word);
+#if defined(__GNUC__) || defined(__clang__)
+   return (uint32_t)__builtin_ctzll(word);
+#else
+   uint32_t n = 0;
+   while (!((word >> n) & 1))
+      n++;
+   return n;
+#endif
+}
+
+static inline uint32_t bitset_popcount64(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return (uint32_t)__builtin_popcountll(word);
+#else
+   word = word - ((word >> 1) & 0x5555555555555555ull);
+   word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+   word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+   return (uint32_t)((word * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/* number of set bits in words[0 .. n) */
+static inline size_t bitset_count_words(const uint64_t *const restrict words, const size_t n)
+{
+   size_t i = 0;
+   size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+   for (; i + 4 <= n; i += 4)
+   {
+      c0 += bitset_popcount64(words[i]);
+      c1 += bitset_popcount64(words[i + 1]);
+      c2 += bitset_popcount64(words[i + 2]);
+      c3 += bitset_popcount64(words[i + 3]);
+   }
+   for (; i < n; i++)
+      c0 += bitset_popcount64(words[i]);
+   return c0 + c1 + c2 + c3;
+}
+
+
+/**
+ * Bulk kernels
+ * ------------
+ * dst[i] = dst[i] op src[i] for i in [0, n).
+ *
+ * Functions:
+ *   bitset_and_words(dst, src, n)     dst &= src
+ *   bitset_or_words(dst, src, n)      dst |= src
+ *   bitset_xor_words(dst, src, n)     dst ^= src
+ *   bitset_andnot_words(dst, src, n)  dst &= ~src
+ *
+ * Behavior:
+ *   - AVX2: 256-bit lanes, two vectors per iteration.
+ *   - SSE2: 128-bit lanes.
+ *   - Otherwise: scalar loop over 64-bit words.
+ *
+ * Notes:
+ *   dst and src may be the same array.
+ */
+
+#if defined(__AVX2__)
+   #include <immintrin.h>
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+   #define BITSET_VECTOR_LOOP(dst, src, n, i, avx_op, sse_op) \
+      for (; i + 8 <= n; i += 8) \
+      { \
+         const __m256i d0 = _mm256_loadu_si256((const __m256i*)(dst + i)); \
+         const __m256i d1 = _mm256_loadu_si256((const __m256i*)(dst + i + 4)); \
+         const __m256i s0 = _mm256_loadu_si256((const __m256i*)(src + i)); \
+         const __m256i s1 = _mm256_loadu_si256((const __m256i*)(src + i + 4)); \
+         _mm256_storeu_si256((__m256i*)(dst + i), avx_op(d0, s0)); \
+         _mm256_storeu_si256((__m256i*)(dst + i + 4), avx_op(d1, s1)); \
+      }
+#elif defined(__SSE2__)
+   #define BITSET_VECTOR_LOOP(dst, src, n, i, avx_op, sse_op) \
+      for (; i + 4 <= n; i += 4) \
+      { \
+         const __m128i d0 = _mm_loadu_si128((const __m128i*)(dst + i)); \
+         const __m128i d1 = _mm_loadu_si128((const __m128i*)(dst + i + 2)); \
+         const __m128i s0 = _mm_loadu_si128((const __m128i*)(src + i)); \
+         const __m128i s1 = _mm_loadu_si128((const __m128i*)(src + i + 2)); \
+         _mm_storeu_si128((__m128i*)(dst + i), sse_op(d0, s0)); \
+         _mm_storeu_si128((__m128i*)(dst + i + 2), sse_op(d1, s1)); \
+      }
+#else
+   #define BITSET_VECTOR_LOOP(dst, src, n, i, avx_op, sse_op)
+#endif
+
+/* andnot intrinsics compute ~a & b: swap the operands for dst & ~src */
+#define BITSET_AVX_AND(d, s)    _mm256_and_si256(d, s)
+#define BITSET_AVX_OR(d, s)     _mm256_or_si256(d, s)
+#define BITSET_AVX_XOR(d, s)    _mm256_xor_si256(d, s)
+#define BITSET_AVX_ANDNOT(d, s) _mm256_andnot_si256(s, d)
+#define BITSET_SSE_AND(d, s)    _mm_and_si128(d, s)
+#define BITSET_SSE_OR(d, s)     _mm_or_si128(d, s)
+#define BITSET_SSE_XOR(d, s)    _mm_xor_si128(d, s)
+#define BITSET_SSE_ANDNOT(d, s) _mm_andnot_si128(s, d)
+
+/* name: and / or / xor / andnot, OP: AND / OR / XOR / ANDNOT */
+#define BITSET_GENERATE_KERNEL(name, OP, scalar_expr) \
+static inline void bitset_##name##_words(uint64_t *const dst, const uint64_t *const src, const size_t n) \
+{ \
+   size_t i = 0; \
+   BITSET_VECTOR_LOOP(dst, src, n, i, BITSET_AVX_##OP, BITSET_SSE_##OP) \
+   for (; i < n; i++) \
+      dst[i] = scalar_expr; \
+}
+
+BITSET_GENERATE_KERNEL(and, AND, dst[i] & src[i])
+BITSET_GENERATE_KERNEL(or, OR, dst[i] | src[i])
+BITSET_GENERATE_KERNEL(xor, XOR, dst[i] ^ src[i])
+BITSET_GENERATE_KERNEL(andnot, ANDNOT, dst[i] & ~src[i])
+
+
+/**
+ * DEFINE_BITSET macro
+ * -------------------
+ * Defines a growable bitset with an inline buffer of `init_size` words.
+ *
+ * Parameters:
+ *   len_type  - Unsigned integer type used for bit indices, length and size
+ *   init_size - Number of 64-bit words to store inline before heap allocation
+ *
+ * Output:
+ *   Declaration of bitset for len_type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_BITSET(...), Ensure macro arguments match
+ */
+#define DEFINE_BITSET(len_type, init_size) \
+   static_assert(init_size > 0, "Warning: init_size too small"); \
+   static_assert(init_size < 256, "Warning: init_size too big"); \
+   static_assert((init_size & (init_size - 1)) == 0, "Warning: init_size must be a power of 2"); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   uint64_t inline_buffer[init_size]; \
+   uint64_t *words; \
+   len_type len;  /* bits */ \
+   len_type size; /* words */ \
+} len_type##_bitset_s; \
+\
+static inline void len_type##_bitset_init(len_type##_bitset_s *const restrict bitset) \
+{ \
+   bitset->words = bitset->inline_buffer; \
+   bitset->len = 0; \
+   bitset->size = init_size; \
+} \
+\
+static inline bool len_type##_bitset_test(const len_type##_bitset_s *const restrict bitset, const len_type i) \
+{ \
+   assert(bitset); \
+   assert(i < bitset->len); \
+   return (bitset->words[i / BITSET_WORD_BITS] >> (i % BITSET_WORD_BITS)) & 1; \
+} \
+\
+static inline void len_type##_bitset_set(len_type##_bitset_s *const restrict bitset, const len_type i) \
+{ \
+   assert(bitset); \
+   assert(i < bitset->len); \
+   bitset->words[i / BITSET_WORD_BITS] |= (uint64_t)1 << (i % BITSET_WORD_BITS); \
+} \
+\
+static inline void len_type##_bitset_clear(len_type##_bitset_s *const restrict bitset, const len_type i) \
+{ \
+   assert(bitset); \
+   assert(i < bitset->len); \
+   bitset->words[i / BITSET_WORD_BITS] &= ~((uint64_t)1 << (i % BITSET_WORD_BITS)); \
+} \
+\
+static inline void len_type##_bitset_flip(len_type##_bitset_s *const restrict bitset, const len_type i) \
+{ \
+   assert(bitset); \
+   assert(i < bitset->len); \
+   bitset->words[i / BITSET_WORD_BITS] ^= (uint64_t)1 << (i % BITSET_WORD_BITS); \
+} \
+\
+/* test and set: true if the bit was clear */ \
+static inline bool len_type##_bitset_visit(len_type##_bitset_s *const restrict bitset, const len_type i) \
+{ \
+   assert(bitset); \
+   assert(i < bitset->len); \
+   uint64_t *const word = &bitset->words[i / BITSET_WORD_BITS]; \
+   const uint64_t bit = (uint64_t)1 << (i % BITSET_WORD_BITS); \
+   if (*word & bit) \
+      return false; \
+   *word |= bit; \
+   return true; \
+} \
+\
+static inline size_t len_type##_bitset_count(const len_type##_bitset_s *const restrict bitset) \
+{ \
+   assert(bitset); \
+   return bitset_count_words(bitset->words, BITSET_WORDS(bitset->len)); \
+} \
+\
+bool len_type##_bitset_resize(len_type##_bitset_s *const restrict, const len_type); \
+void len_type##_bitset_delete(len_type##_bitset_s *const restrict); \
+bool len_type##_bitset_push(len_type##_bitset_s *const restrict, const bool); \
+bool len_type##_bitset_pop(len_type##_bitset_s *const restrict); \
+void len_type##_bitset_fill(len_type##_bitset_s *const restrict, const bool); \
+len_type len_type##_bitset_find_next_set(const len_type##_bitset_s *const restrict, const len_type); \
+len_type len_type##_bitset_find_next_clear(const len_type##_bitset_s *const restrict, const len_type); \
+void len_type##_bitset_and(len_type##_bitset_s *const, const len_type##_bitset_s *const); \
+void len_type##_bitset_or(len_type##_bitset_s *const, const len_type##_bitset_s *const); \
+void len_type##_bitset_xor(len_type##_bitset_s *const, const len_type##_bitset_s *const); \
+void len_type##_bitset_andnot(len_type##_bitset_s *const, const len_type##_bitset_s *const);
+
+
+/**
+ * bitset(len_type) macro
+ * ----------------------
+ * Declares a bitset variable indexed by len_type.
+ *
+ * Usage (as variable):
+ *   bitset(uint32_t) visited;
+ *
+ * Usage (as parameter):
+ *   void expand(bitset(uint32_t) *const frontier) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying bitset struct type (len_type##_bitset_s).
+ */
+#define bitset(len_type) \
+   len_type##_bitset_s
+
+
+/**
+ * typecheck_bitset_ptr macro
+ * --------------------------
+ * Compile-time validation that 'var' is a pointer to a bitset indexed by
+ * 'len_type' (see typecheck_ptr).
+ */
+#define typecheck_bitset_ptr(var, len_type, expr) \
+   typecheck_ptr(var, len_type##_bitset_s, expr)
+
+
+/**
+ * Bitset Expression Macros
+ * ------------------------
+ * Direct access to bitset properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ *
+ * Notes:
+ *   - bitset_words gives the BITSET_WORDS(len) words holding the bits,
+ *     bit i at words[i / 64] >> (i % 64).
+ */
+#define bitset_len(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      (bitset)->len \
+   )
+
+#define bitset_size(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      (bitset)->size \
+   )
+
+#define bitset_empty(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      (bitset)->len == 0 \
+   )
+
+#define bitset_words(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      (bitset)->words \
+   )
+
+
+/**
+ * GENERATE_BITSET macro
+ * ---------------------
+ * Implements the bitset functions for len_type.
+ *
+ * Parameters:
+ *   len_type      - Unsigned integer type for bit indices, length & size
+ *   init_size     - Inline buffer size in words (initial size)
+ *   growth_factor - Multiplier for resizing
+ *   alloc_fn      - Allocator used when leaving the inline buffer
+ *   realloc_fn    - Reallocator for heap words
+ *   free_fn       - Matching free
+ *
+ * Behavior:
+ *   - resize(n): sets len to n bits; new bits are clear. False if the
+ *     words cannot grow (bitset unchanged).
+ *   - push(bit) / pop(): append / drop the last bit, like a stack(bool).
+ *   - find_next_set(from) / find_next_clear(from): first matching bit at
+ *     index >= from, BITSET_NONE(len_type) if none; skips whole words.
+ *   - and / or / xor / andnot(dst, src): dst op= src with the bulk
+ *     kernels; dst keeps its len, src is read as zero-extended (bits of
+ *     src beyond dst's len are ignored).
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_BITSET(...), Ensure macro arguments match
+ */
+#define GENERATE_BITSET(len_type, init_size, growth_factor, alloc_fn, realloc_fn, free_fn) \
+   static_assert(init_size > 0, "Warning: init_size too small"); \
+   static_assert(init_size < 256, "Warning: init_size too big"); \
+   static_assert((init_size & (init_size - 1)) == 0, "Warning: init_size must be a power of 2"); \
+   static_assert(growth_factor > 1, "Warning: growth_factor too small"); \
+   static_assert(growth_factor < 32,  "Warning: growth_factor too big"); \
+   static_assert(growth_factor != 0 && (growth_factor & (growth_factor - 1)) == 0, "Warning: growth_factor must be a power of 2"); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(realloc_fn, void* (void*, size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool len_type##_bitset_resize(len_type##_bitset_s *const restrict bitset, const len_type len) \
+{ \
+   assert(bitset); \
+   const size_t old_words = BITSET_WORDS(bitset->len); \
+   const size_t new_words = BITSET_WORDS(len); \
+\
+   if (new_words > bitset->size) \
+   { \
+      len_type new_size = bitset->size; \
+      while (new_size < new_words) \
+      { \
+         if (new_size > (len_type)(-1) / growth_factor) /* Prevent overflow */ \
+            return false; \
+         new_size *= growth_factor; \
+      } \
+\
+      void *tmp; \
+      if (bitset->words == bitset->inline_buffer) \
+      { \
+         tmp = alloc_fn(sizeof(uint64_t) * new_size); \
+         if (!tmp) \
+            return false; \
+         MEMORY_COPY(tmp, bitset->words, sizeof(uint64_t) * old_words); \
+      } \
+      else \
+      { \
+         tmp = realloc_fn(bitset->words, sizeof(uint64_t) * new_size); \
+         if (!tmp) \
+            return false; \
+      } \
+      bitset->words = (uint64_t*)tmp; \
+      bitset->size = new_size; \
+   } \
+\
+   if (new_words > old_words) \
+      MEMORY_SET(bitset->words + old_words, 0, sizeof(uint64_t) * (new_words - old_words)); \
+   else if (len < bitset->len && len % BITSET_WORD_BITS) /* keep the bits past len clear */ \
+      bitset->words[new_words - 1] &= ~(uint64_t)0 >> (BITSET_WORD_BITS - len % BITSET_WORD_BITS); \
+   bitset->len = len; \
+   return true; \
+} \
+\
+void len_type##_bitset_delete(len_type##_bitset_s *const restrict bitset) \
+{ \
+   assert(bitset); \
+   if (bitset->words != bitset->inline_buffer) \
+      free_fn(bitset->words); \
+   len_type##_bitset_init(bitset); \
+} \
+\
+bool len_type##_bitset_push(len_type##_bitset_s *const restrict bitset, const bool bit) \
+{ \
+   assert(bitset); \
+   if (bitset->len == BITSET_NONE(len_type) || !len_type##_bitset_resize(bitset, bitset->len + 1)) \
+      return false; \
+   bitset->words[(bitset->len - 1) / BITSET_WORD_BITS] |= (uint64_t)bit << ((bitset->len - 1) % BITSET_WORD_BITS); \
+   return true; \
+} \
+\
+bool len_type##_bitset_pop(len_type##_bitset_s *const restrict bitset) \
+{ \
+   assert(bitset); \
+   if (bitset->len == 0) \
+      return false; \
+   return len_type##_bitset_resize(bitset, bitset->len - 1); \
+} \
+\
+void len_type##_bitset_fill(len_type##_bitset_s *const restrict bitset, const bool bit) \
+{ \
+   assert(bitset); \
+   const size_t words = BITSET_WORDS(bitset->len); \
+   if (words == 0) \
+      return; \
+   MEMORY_SET(bitset->words, bit ? 0xFF : 0, sizeof(uint64_t) * words); \
+   if (bit && bitset->len % BITSET_WORD_BITS) \
+      bitset->words[words - 1] = ~(uint64_t)0 >> (BITSET_WORD_BITS - bitset->len % BITSET_WORD_BITS); \
+} \
+\
+len_type len_type##_bitset_find_next_set(const len_type##_bitset_s *const restrict bitset, const len_type from) \
+{ \
+   assert(bitset); \
+   if (from >= bitset->len) \
+      return BITSET_NONE(len_type); \
+   const size_t words = BITSET_WORDS(bitset->len); \
+   size_t w = from / BITSET_WORD_BITS; \
+   uint64_t word = bitset->words[w] & (~(uint64_t)0 << (from % BITSET_WORD_BITS)); \
+   for (;;) \
+   { \
+      if (word) \
+         return (len_type)(w * BITSET_WORD_BITS + bitset_ctz64(word)); \
+      if (++w == words) \
+         return BITSET_NONE(len_type); \
+      word = bitset->words[w]; \
+   } \
+} \
+\
+len_type len_type##_bitset_find_next_clear(const len_type##_bitset_s *const restrict bitset, const len_type from) \
+{ \
+   assert(bitset); \
+   if (from >= bitset->len) \
+      return BITSET_NONE(len_type); \
+   const size_t words = BITSET_WORDS(bitset->len); \
+   size_t w = from / BITSET_WORD_BITS; \
+   uint64_t word = ~bitset->words[w] & (~(uint64_t)0 << (from % BITSET_WORD_BITS)); \
+   for (;;) \
+   { \
+      if (word) \
+      { \
+         const size_t i = w * BITSET_WORD_BITS + bitset_ctz64(word); \
+         return (i < bitset->len) ? (len_type)i : BITSET_NONE(len_type); /* past len in the last word */ \
+      } \
+      if (++w == words) \
+         return BITSET_NONE(len_type); \
+      word = ~bitset->words[w]; \
+   } \
+} \
+\
+/* words both operands hold; past them src reads as zero */ \
+static inline size_t len_type##_bitset_common_words(const len_type##_bitset_s *const dst, const len_type##_bitset_s *const src) \
+{ \
+   const size_t dst_words = BITSET_WORDS(dst->len); \
+   const size_t src_words = BITSET_WORDS(src->len); \
+   return dst_words < src_words ? dst_words : src_words; \
+} \
+\
+static inline void len_type##_bitset_trim(len_type##_bitset_s *const dst) \
+{ \
+   if (dst->len % BITSET_WORD_BITS) \
+      dst->words[BITSET_WORDS(dst->len) - 1] &= ~(uint64_t)0 >> (BITSET_WORD_BITS - dst->len % BITSET_WORD_BITS); \
+} \
+\
+void len_type##_bitset_and(len_type##_bitset_s *const dst, const len_type##_bitset_s *const src) \
+{ \
+   assert(dst && src); \
+   const size_t n = len_type##_bitset_common_words(dst, src); \
+   bitset_and_words(dst->words, src->words, n); \
+   const size_t dst_words = BITSET_WORDS(dst->len); \
+   if (n < dst_words) /* src is zero past its len */ \
+      MEMORY_SET(dst->words + n, 0, sizeof(uint64_t) * (dst_words - n)); \
+} \
+\
+void len_type##_bitset_or(len_type##_bitset_s *const dst, const len_type##_bitset_s *const src) \
+{ \
+   assert(dst && src); \
+   bitset_or_words(dst->words, src->words, len_type##_bitset_common_words(dst, src)); \
+   len_type##_bitset_trim(dst); \
+} \
+\
+void len_type##_bitset_xor(len_type##_bitset_s *const dst, const len_type##_bitset_s *const src) \
+{ \
+   assert(dst && src); \
+   bitset_xor_words(dst->words, src->words, len_type##_bitset_common_words(dst, src)); \
+   len_type##_bitset_trim(dst); \
+} \
+\
+void len_type##_bitset_andnot(len_type##_bitset_s *const dst, const len_type##_bitset_s *const src) \
+{ \
+   assert(dst && src); \
+   bitset_andnot_words(dst->words, src->words, len_type##_bitset_common_words(dst, src)); \
+}
+
+
+/**
+ * Bitset function macros
+ * ----------------------
+ * Type-generic wrappers for the functions generated by GENERATE_BITSET.
+ *
+ * Usage:
+ *   bitset(uint32_t) visited;
+ *   bitset_init(uint32_t, &visited);
+ *   bitset_resize(uint32_t, &visited, node_count);      // all clear
+ *   if (bitset_visit(uint32_t, &visited, node))          // test and set
+ *      expand(node);
+ *   for (uint32_t i = bitset_find_next_set(uint32_t, &visited, 0);
+ *        i != BITSET_NONE(uint32_t);
+ *        i = bitset_find_next_set(uint32_t, &visited, i + 1))
+ *      report(i);
+ *   bitset_delete(uint32_t, &visited);
+ */
+#define bitset_init(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_init((bitset)) \
+   )
+
+#define bitset_resize(len_type, bitset, len) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_resize((bitset), (len)) \
+   )
+
+#define bitset_delete(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_delete((bitset)) \
+   )
+
+#define bitset_push(len_type, bitset, bit) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_push((bitset), (bit)) \
+   )
+
+#define bitset_pop(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_pop((bitset)) \
+   )
+
+#define bitset_test(len_type, bitset, i) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_test((bitset), (i)) \
+   )
+
+#define bitset_set(len_type, bitset, i) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_set((bitset), (i)) \
+   )
+
+#define bitset_clear(len_type, bitset, i) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_clear((bitset), (i)) \
+   )
+
+#define bitset_flip(len_type, bitset, i) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_flip((bitset), (i)) \
+   )
+
+#define bitset_visit(len_type, bitset, i) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_visit((bitset), (i)) \
+   )
+
+#define bitset_fill(len_type, bitset, bit) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_fill((bitset), (bit)) \
+   )
+
+#define bitset_count(len_type, bitset) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_count((bitset)) \
+   )
+
+#define bitset_find_next_set(len_type, bitset, from) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_find_next_set((bitset), (from)) \
+   )
+
+#define bitset_find_next_clear(len_type, bitset, from) \
+   typecheck_bitset_ptr(bitset, len_type, \
+      len_type##_bitset_find_next_clear((bitset), (from)) \
+   )
+
+#define bitset_and(len_type, dst, src) \
+   typecheck_bitset_ptr(dst, len_type, \
+      len_type##_bitset_and((dst), (src)) \
+   )
+
+#define bitset_or(len_type, dst, src) \
+   typecheck_bitset_ptr(dst, len_type, \
+      len_type##_bitset_or((dst), (src)) \
+   )
+
+#define bitset_xor(len_type, dst, src) \
+   typecheck_bitset_ptr(dst, len_type, \
+      len_type##_bitset_xor((dst), (src)) \
+   )
+
+#define bitset_andnot(len_type, dst, src) \
+   typecheck_bitset_ptr(dst, len_type, \
+      len_type##_bitset_andnot((dst), (src)) \
+   )
+
+
+#endif /* __BITSET_H */
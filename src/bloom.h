@@ -0,0 +1,497 @@
+#ifndef __BLOOM_H
+#define __BLOOM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <math.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+#include "bitset.h"
+
+
+/**
+ * Blocked Bloom filter
+ * --------------------
+ * Approximate set membership: contains() may answer true for a key never
+ * inserted (a false positive), never false for an inserted one.
+ *
+ * Every key maps to one 64-byte block (a cache line) and sets one bit in
+ * each of its eight 64-bit words, so insert and contains touch a single
+ * cache line:
+ *
+ *   block - high 32 bits of the hash, mapped onto block_count
+ *   bits  - low 32 bits of the hash times eight odd salts, top 6 bits
+ *
+ * Behavior:
+ *   - AVX2: the eight bit positions are computed and tested in two
+ *     256-bit vectors.
+ *   - Otherwise: scalar loop over the eight words.
+ *
+ * Notes:
+ *   Blocks are 64-byte aligned inside an over-allocation, whatever the
+ *   alignment alloc_fn gives.
+ */
+#define BLOOM_BLOCK_WORDS 8
+#define BLOOM_BLOCK_BYTES (BLOOM_BLOCK_WORDS * sizeof(uint64_t))
+
+/* largest average number of keys per block sizing will pick */
+#define BLOOM_MAX_LOAD 512.0
+
+/* serialized header: magic, block count, inserted count */
+#define BLOOM_MAGIC UINT64_C(0x31304D4F4F4C42) /* "BLOOM01" */
+#define BLOOM_HEADER_BYTES (3 * sizeof(uint64_t))
+
+static_assert(BLOOM_BLOCK_BYTES == 64, "Warning: a bloom block must be one cache line");
+
+
+#if defined(__AVX2__)
+   #include <immintrin.h>
+#endif
+
+static const uint32_t bloom_salts[BLOOM_BLOCK_WORDS] =
+{
+   0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du,
+   0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u
+};
+
+/* block of a hash: fast range reduction of the high 32 bits */
+static inline size_t bloom_block_index(const uint64_t hash, const size_t block_count)
+{
+   return (size_t)(((hash >> 32) * (uint64_t)block_count) >> 32);
+}
+
+#if defined(__AVX2__)
+
+   /* one bit per word, as two vectors of four words */
+   static inline void bloom_block_masks(const uint64_t hash, __m256i *const restrict lo, __m256i *const restrict hi)
+   {
+      const __m256i salts = _mm256_loadu_si256((const __m256i*)bloom_salts);
+      const __m256i shift = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int32_t)(uint32_t)hash), salts), 26);
+      const __m256i one = _mm256_set1_epi64x(1);
+      *lo = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(shift)));
+      *hi = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(shift, 1)));
+   }
+
+   static inline void bloom_block_insert(uint64_t *const restrict block, const uint64_t hash)
+   {
+      __m256i lo, hi;
+      bloom_block_masks(hash, &lo, &hi);
+      _mm256_store_si256((__m256i*)block, _mm256_or_si256(_mm256_load_si256((const __m256i*)block), lo));
+      _mm256_store_si256((__m256i*)(block + 4), _mm256_or_si256(_mm256_load_si256((const __m256i*)(block + 4)), hi));
+   }
+
+   static inline bool bloom_block_contains(const uint64_t *const restrict block, const uint64_t hash)
+   {
+      __m256i lo, hi;
+      bloom_block_masks(hash, &lo, &hi);
+      /* testc: every mask bit set in the block */
+      return _mm256_testc_si256(_mm256_load_si256((const __m256i*)block), lo)
+           & _mm256_testc_si256(_mm256_load_si256((const __m256i*)(block + 4)), hi);
+   }
+
+#else
+
+   static inline void bloom_block_insert(uint64_t *const restrict block, const uint64_t hash)
+   {
+      const uint32_t h = (uint32_t)hash;
+      for (uint32_t i = 0; i < BLOOM_BLOCK_WORDS; i++)
+         block[i] |= (uint64_t)1 << ((h * bloom_salts[i]) >> 26);
+   }
+
+   static inline bool bloom_block_contains(const uint64_t *const restrict block, const uint64_t hash)
+   {
+      const uint32_t h = (uint32_t)hash;
+      uint64_t missing = 0;
+      for (uint32_t i = 0; i < BLOOM_BLOCK_WORDS; i++)
+         missing |= ~block[i] & ((uint64_t)1 << ((h * bloom_salts[i]) >> 26));
+      return missing == 0;
+   }
+
+#endif
+
+/**
+ * Estimated false positive rate with `load` keys per block on average.
+ * Block loads are Poisson distributed; a block holding i keys answers a
+ * foreign key with probability (1 - (63/64)^i)^8.
+ */
+static inline double bloom_estimate_fpr(const double load)
+{
+   if (load <= 0.0)
+      return 0.0;
+   double term = exp(-load); /* P(i keys) */
+   double fpr = 0.0;
+   const uint32_t limit = (uint32_t)(load + 12.0 * sqrt(load) + 16.0);
+   for (uint32_t i = 1; i <= limit; i++)
+   {
+      term *= load / i;
+      fpr += term * pow(1.0 - pow(63.0 / 64.0, i), BLOOM_BLOCK_WORDS);
+   }
+   return fpr;
+}
+
+/* fewest blocks expected to keep `expected` keys within `fpr` */
+static inline size_t bloom_blocks_for(const size_t expected, const double fpr)
+{
+   double lo = 1.0 / 64.0, hi = BLOOM_MAX_LOAD;
+   if (bloom_estimate_fpr(hi) > fpr)
+   {
+      for (int i = 0; i < 40; i++)
+      {
+         const double mid = 0.5 * (lo + hi);
+         if (bloom_estimate_fpr(mid) <= fpr)
+            lo = mid;
+         else
+            hi = mid;
+      }
+      hi = lo;
+   }
+   const double blocks = ceil((double)expected / hi);
+   return blocks < 1.0 ? 1 : (size_t)blocks;
+}
+
+static inline void bloom_store64(unsigned char *const restrict p, const uint64_t x)
+{
+   for (int i = 0; i < 8; i++)
+      p[i] = (unsigned char)(x >> (8 * i));
+}
+
+static inline uint64_t bloom_load64(const unsigned char *const restrict p)
+{
+   uint64_t x = 0;
+   for (int i = 0; i < 8; i++)
+      x |= (uint64_t)p[i] << (8 * i);
+   return x;
+}
+
+
+/**
+ * DEFINE_BLOOM macro
+ * ------------------
+ * Defines a blocked Bloom filter for keys of key_type.
+ *
+ * Parameters:
+ *   key_type - Type of the keys (hashed, never stored)
+ *
+ * Output:
+ *   Declaration of Bloom filter for key_type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_BLOOM(...), Ensure macro arguments match
+ */
+#define DEFINE_BLOOM(key_type) \
+   assert_istype(key_type); \
+\
+typedef struct \
+{ \
+   uint64_t *blocks; /* block_count * BLOOM_BLOCK_WORDS, 64-byte aligned, NULL until used */ \
+   void *memory;     /* allocation holding blocks */ \
+   size_t block_count; \
+   size_t len;       /* keys inserted, duplicates included */ \
+} key_type##_bloom_s; \
+\
+/* empty filter sized for `expected` keys at false positive rate `fpr`, no allocation */ \
+static inline void key_type##_bloom_init(key_type##_bloom_s *const restrict filter, const size_t expected, const double fpr) \
+{ \
+   assert(filter); \
+   assert(fpr > 0.0 && fpr < 1.0); \
+   filter->blocks = NULL; \
+   filter->memory = NULL; \
+   filter->block_count = bloom_blocks_for(expected, fpr); \
+   filter->len = 0; \
+} \
+\
+static inline void key_type##_bloom_clear(key_type##_bloom_s *const restrict filter) \
+{ \
+   assert(filter); \
+   if (filter->blocks) \
+      MEMORY_SET(filter->blocks, 0, BLOOM_BLOCK_BYTES * filter->block_count); \
+   filter->len = 0; \
+} \
+\
+/* false positive rate expected at the current number of inserted keys */ \
+static inline double key_type##_bloom_fpr(const key_type##_bloom_s *const restrict filter) \
+{ \
+   assert(filter); \
+   return bloom_estimate_fpr((double)filter->len / (double)filter->block_count); \
+} \
+\
+static inline size_t key_type##_bloom_serialized_size(const key_type##_bloom_s *const restrict filter) \
+{ \
+   assert(filter); \
+   return BLOOM_HEADER_BYTES + BLOOM_BLOCK_BYTES * filter->block_count; \
+} \
+\
+void key_type##_bloom_delete(key_type##_bloom_s *const restrict); \
+bool key_type##_bloom_insert(key_type##_bloom_s *const restrict, const key_type); \
+bool key_type##_bloom_contains(const key_type##_bloom_s *const restrict, const key_type); \
+bool key_type##_bloom_merge(key_type##_bloom_s *const restrict, const key_type##_bloom_s *const restrict); \
+size_t key_type##_bloom_serialize(const key_type##_bloom_s *const restrict, void *const restrict); \
+bool key_type##_bloom_deserialize(key_type##_bloom_s *const restrict, const void *const restrict, const size_t);
+
+
+/**
+ * bloom(key_type) macro
+ * ---------------------
+ * Declares a Bloom filter variable for keys of key_type.
+ *
+ * Usage (as variable):
+ *   bloom(uint64_t) seen;
+ *
+ * Usage (as parameter):
+ *   void route(const bloom(uint64_t) *const seen) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (key_type##_bloom_s).
+ */
+#define bloom(key_type) \
+   key_type##_bloom_s
+
+
+/**
+ * typecheck_bloom_ptr macro
+ * -------------------------
+ * Compile-time validation that 'var' is a pointer to a Bloom filter of
+ * 'key_type' (see typecheck_ptr).
+ */
+#define typecheck_bloom_ptr(var, key_type, expr) \
+   typecheck_ptr(var, key_type##_bloom_s, expr)
+
+
+/**
+ * Bloom Expression Macros
+ * -----------------------
+ * Direct access to filter properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ */
+#define bloom_len(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      (filter)->len \
+   )
+
+#define bloom_empty(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      (filter)->len == 0 \
+   )
+
+#define bloom_block_count(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      (filter)->block_count \
+   )
+
+#define bloom_bytes(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      (BLOOM_BLOCK_BYTES * (filter)->block_count) \
+   )
+
+
+/**
+ * GENERATE_BLOOM macro
+ * --------------------
+ * Implements the Bloom filter functions for a key type.
+ *
+ * Parameters:
+ *   key_type - Type of the keys
+ *   hash_fn  - uint64_t (key_type), as for the hashmap; all 64 bits are used
+ *   alloc_fn - Allocator for the blocks
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - insert(key): allocates the zeroed blocks on first use; false only if
+ *     that allocation fails.
+ *   - merge(dst, src): dst |= src, the union of both key sets; false if
+ *     the filters differ in block count (init both with the same expected
+ *     count and rate) or allocation fails. Build one filter per thread,
+ *     merge once they are done.
+ *   - serialize(filter, buffer): writes serialized_size() bytes, words in
+ *     little endian; deserialize(filter, buffer, size) replaces the
+ *     contents of an initialised filter, block count included; false if
+ *     the buffer is not a serialized filter or allocation fails (filter
+ *     unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_BLOOM(...), Ensure macro arguments match
+ */
+#define GENERATE_BLOOM(key_type, hash_fn, alloc_fn, free_fn) \
+   assert_istype(key_type); \
+   assert_type(hash_fn, uint64_t (key_type)); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+/* zeroed, 64-byte aligned blocks for `block_count` blocks, NULL if allocation fails */ \
+static uint64_t *key_type##_bloom_allocate(const size_t block_count, void **const restrict memory) \
+{ \
+   if (block_count > (SIZE_MAX - BLOOM_BLOCK_BYTES) / BLOOM_BLOCK_BYTES) /* Prevent overflow */ \
+      return NULL; \
+   *memory = alloc_fn(BLOOM_BLOCK_BYTES * block_count + BLOOM_BLOCK_BYTES - 1); \
+   if (!*memory) \
+      return NULL; \
+   uint64_t *const blocks = (uint64_t*)(((uintptr_t)*memory + BLOOM_BLOCK_BYTES - 1) & ~(uintptr_t)(BLOOM_BLOCK_BYTES - 1)); \
+   MEMORY_SET(blocks, 0, BLOOM_BLOCK_BYTES * block_count); \
+   return blocks; \
+} \
+\
+void key_type##_bloom_delete(key_type##_bloom_s *const restrict filter) \
+{ \
+   assert(filter); \
+   if (filter->memory) \
+      free_fn(filter->memory); \
+   filter->memory = NULL; \
+   filter->blocks = NULL; \
+   filter->len = 0; \
+} \
+\
+bool key_type##_bloom_insert(key_type##_bloom_s *const restrict filter, const key_type key) \
+{ \
+   assert(filter); \
+   if (!filter->blocks && !(filter->blocks = key_type##_bloom_allocate(filter->block_count, &filter->memory))) \
+      return false; \
+\
+   const uint64_t hash = hash_fn(key); \
+   bloom_block_insert(filter->blocks + BLOOM_BLOCK_WORDS * bloom_block_index(hash, filter->block_count), hash); \
+   filter->len++; \
+   return true; \
+} \
+\
+bool key_type##_bloom_contains(const key_type##_bloom_s *const restrict filter, const key_type key) \
+{ \
+   assert(filter); \
+   if (!filter->blocks) \
+      return false; \
+\
+   const uint64_t hash = hash_fn(key); \
+   return bloom_block_contains(filter->blocks + BLOOM_BLOCK_WORDS * bloom_block_index(hash, filter->block_count), hash); \
+} \
+\
+bool key_type##_bloom_merge(key_type##_bloom_s *const restrict dst, const key_type##_bloom_s *const restrict src) \
+{ \
+   assert(dst && src); \
+   if (dst->block_count != src->block_count) \
+      return false; \
+   if (!src->blocks) \
+      return true; \
+   if (!dst->blocks && !(dst->blocks = key_type##_bloom_allocate(dst->block_count, &dst->memory))) \
+      return false; \
+\
+   bitset_or_words(dst->blocks, src->blocks, BLOOM_BLOCK_WORDS * dst->block_count); \
+   dst->len += src->len; \
+   return true; \
+} \
+\
+size_t key_type##_bloom_serialize(const key_type##_bloom_s *const restrict filter, void *const restrict buffer) \
+{ \
+   assert(filter && buffer); \
+   unsigned char *p = (unsigned char*)buffer; \
+   bloom_store64(p, BLOOM_MAGIC); \
+   bloom_store64(p + 8, (uint64_t)filter->block_count); \
+   bloom_store64(p + 16, (uint64_t)filter->len); \
+   p += BLOOM_HEADER_BYTES; \
+\
+   const size_t words = BLOOM_BLOCK_WORDS * filter->block_count; \
+   if (!filter->blocks) \
+      MEMORY_SET(p, 0, sizeof(uint64_t) * words); \
+   else \
+   { \
+      for (size_t i = 0; i < words; i++) \
+         bloom_store64(p + 8 * i, filter->blocks[i]); \
+   } \
+   return key_type##_bloom_serialized_size(filter); \
+} \
+\
+bool key_type##_bloom_deserialize(key_type##_bloom_s *const restrict filter, const void *const restrict buffer, const size_t size) \
+{ \
+   assert(filter && buffer); \
+   const unsigned char *p = (const unsigned char*)buffer; \
+   if (size < BLOOM_HEADER_BYTES || bloom_load64(p) != BLOOM_MAGIC) \
+      return false; \
+   const uint64_t block_count = bloom_load64(p + 8); \
+   const uint64_t len = bloom_load64(p + 16); \
+   if (block_count == 0 || block_count > (size - BLOOM_HEADER_BYTES) / BLOOM_BLOCK_BYTES \
+      || size != BLOOM_HEADER_BYTES + BLOOM_BLOCK_BYTES * block_count) \
+      return false; \
+\
+   void *memory; \
+   uint64_t *const blocks = key_type##_bloom_allocate((size_t)block_count, &memory); \
+   if (!blocks) \
+      return false; \
+   p += BLOOM_HEADER_BYTES; \
+   for (size_t i = 0; i < BLOOM_BLOCK_WORDS * block_count; i++) \
+      blocks[i] = bloom_load64(p + 8 * i); \
+\
+   key_type##_bloom_delete(filter); \
+   filter->blocks = blocks; \
+   filter->memory = memory; \
+   filter->block_count = (size_t)block_count; \
+   filter->len = (size_t)len; \
+   return true; \
+}
+
+
+/**
+ * Bloom function macros
+ * ---------------------
+ * Type-generic wrappers for the functions generated by GENERATE_BLOOM.
+ *
+ * Usage:
+ *   bloom(uint64_t) seen;
+ *   bloom_init(uint64_t, &seen, 1000000, 0.01);    // 1M keys at 1%
+ *   bloom_insert(uint64_t, &seen, id);
+ *   if (bloom_contains(uint64_t, &seen, id))        // maybe: ask the index
+ *      ...
+ *   bloom_delete(uint64_t, &seen);
+ */
+#define bloom_init(key_type, filter, expected, fpr) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_init((filter), (expected), (fpr)) \
+   )
+
+#define bloom_clear(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_clear((filter)) \
+   )
+
+#define bloom_delete(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_delete((filter)) \
+   )
+
+#define bloom_insert(key_type, filter, key) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_insert((filter), (key)) \
+   )
+
+#define bloom_contains(key_type, filter, key) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_contains((filter), (key)) \
+   )
+
+#define bloom_merge(key_type, dst, src) \
+   typecheck_bloom_ptr(dst, key_type, \
+      key_type##_bloom_merge((dst), (src)) \
+   )
+
+#define bloom_fpr(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_fpr((filter)) \
+   )
+
+#define bloom_serialized_size(key_type, filter) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_serialized_size((filter)) \
+   )
+
+#define bloom_serialize(key_type, filter, buffer) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_serialize((filter), (buffer)) \
+   )
+
+#define bloom_deserialize(key_type, filter, buffer, size) \
+   typecheck_bloom_ptr(filter, key_type, \
+      key_type##_bloom_deserialize((filter), (buffer), (size)) \
+   )
+
+
+#endif /* __BLOOM_H */
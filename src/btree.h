@@ -0,0 +1,1044 @@
+#ifndef __BTREE_H
+#define __BTREE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <limits.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+#include "search.h"
+
+
+/**
+ * B+ tree map
+ * -----------
+ * Ordered key -> value map: keys and values live in leaves linked in key
+ * order, inner nodes hold separator keys only. Nodes hold up to
+ * BTREE_FANOUT(key_type) keys, BTREE_NODE_BYTES of keys (a few cache
+ * lines) each, so a lookup touches one short array per level.
+ *
+ * Inner node: keys[0 .. count), children[0 .. count]; children[i] holds
+ * the keys k with keys[i - 1] <= k < keys[i].
+ * Every node but the root holds at least BTREE_FANOUT / 2 keys.
+ */
+
+/* bytes of keys per node */
+#ifndef BTREE_NODE_BYTES
+   #define BTREE_NODE_BYTES 256
+#endif
+
+/* deepest tree supported: 2^64 keys at the minimum fanout of 4 fit in 48 levels */
+#define BTREE_MAX_HEIGHT 48
+
+#define BTREE_FANOUT(key_type) \
+   (BTREE_NODE_BYTES / sizeof(key_type) < 4 ? 4 : \
+    BTREE_NODE_BYTES / sizeof(key_type) > 128 ? 128 : \
+    BTREE_NODE_BYTES / sizeof(key_type))
+
+static_assert(BTREE_NODE_BYTES >= 64, "Warning: BTREE_NODE_BYTES too small");
+static_assert(BTREE_NODE_BYTES <= 4096, "Warning: BTREE_NODE_BYTES too big");
+
+
+/**
+ * BTREE_IS_SIGNED macro
+ * ---------------------
+ * Compile-time constant: 1 if `type` is a signed integer type, otherwise 0.
+ * Only meaningful where SEARCH_IS_INTEGRAL(type) is 1.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)  /* C11+ */
+   #define BTREE_IS_SIGNED(type) \
+      _Generic((type){0}, \
+         char: (CHAR_MIN < 0), \
+         signed char: 1, \
+         short: 1, \
+         int: 1, \
+         long: 1, \
+         long long: 1, \
+         default: 0 \
+      )
+
+#else /* C99 fallback */
+   #define BTREE_IS_SIGNED(type) 0
+
+#endif
+
+
+/**
+ * Rank kernels
+ * ------------
+ * Number of keys below a needle in a sorted array of 32 or 64-bit
+ * integers: keys < needle, or keys <= needle when `inclusive`.
+ *
+ * Functions:
+ *   btree_rank_32(keys, n, needle, is_signed, inclusive)
+ *   btree_rank_64(keys, n, needle, is_signed, inclusive)
+ *   btree_rank(keys, n, width, is_signed, needle_ptr, inclusive) - dispatch on width
+ *
+ * Behavior:
+ *   - AVX2: 8 (32-bit) or 4 (64-bit) signed compares + movemask per step.
+ *   - SSE2: 4 32-bit compares per step; 64-bit keys need SSE4.2.
+ *   - Otherwise: scalar loop.
+ *   - Unsigned keys are compared as signed after flipping the sign bit.
+ *   - Every key is counted, no early exit: a node is a few vectors.
+ */
+#if defined(__AVX2__)
+   #include <immintrin.h>
+#elif defined(__SSE4_2__)
+   #include <nmmintrin.h>
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+#endif
+
+static inline uint32_t btree_popcount32(const uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return (uint32_t)__builtin_popcount(mask);
+#else
+   uint32_t n = 0;
+   for (uint32_t m = mask; m; m &= m - 1)
+      n++;
+   return n;
+#endif
+}
+
+static inline uint32_t btree_rank_32(const void *const restrict keys, const uint32_t n, const uint32_t needle, const bool is_signed, const bool inclusive)
+{
+   const unsigned char *const bytes = (const unsigned char*)keys;
+   const uint32_t flip = is_signed ? 0 : UINT32_C(0x80000000);
+   const int32_t x = (int32_t)(needle ^ flip);
+   uint32_t rank = 0, i = 0;
+
+#if defined(__AVX2__)
+   const __m256i vflip = _mm256_set1_epi32((int32_t)flip);
+   const __m256i vx = _mm256_set1_epi32(x);
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256i k = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(bytes + 4 * i)), vflip);
+      rank += inclusive
+         ? 8 - btree_popcount32((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, vx))))
+         : btree_popcount32((uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vx, k))));
+   }
+#elif defined(__SSE2__)
+   const __m128i vflip = _mm_set1_epi32((int32_t)flip);
+   const __m128i vx = _mm_set1_epi32(x);
+   for (; i + 4 <= n; i += 4)
+   {
+      const __m128i k = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(bytes + 4 * i)), vflip);
+      rank += inclusive
+         ? 4 - btree_popcount32((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, vx))))
+         : btree_popcount32((uint32_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(vx, k))));
+   }
+#endif
+
+   for (; i < n; i++)
+   {
+      uint32_t key;
+      memcpy(&key, bytes + 4 * i, sizeof(key));
+      const int32_t k = (int32_t)(key ^ flip);
+      rank += inclusive ? (k <= x) : (k < x);
+   }
+   return rank;
+}
+
+static inline uint32_t btree_rank_64(const void *const restrict keys, const uint32_t n, const uint64_t needle, const bool is_signed, const bool inclusive)
+{
+   const unsigned char *const bytes = (const unsigned char*)keys;
+   const uint64_t flip = is_signed ? 0 : UINT64_C(0x8000000000000000);
+   const int64_t x = (int64_t)(needle ^ flip);
+   uint32_t rank = 0, i = 0;
+
+#if defined(__AVX2__)
+   const __m256i vflip = _mm256_set1_epi64x((int64_t)flip);
+   const __m256i vx = _mm256_set1_epi64x(x);
+   for (; i + 4 <= n; i += 4)
+   {
+      const __m256i k = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(bytes + 8 * i)), vflip);
+      rank += inclusive
+         ? 4 - btree_popcount32((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, vx))))
+         : btree_popcount32((uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vx, k))));
+   }
+#elif defined(__SSE4_2__)
+   const __m128i vflip = _mm_set1_epi64x((int64_t)flip);
+   const __m128i vx = _mm_set1_epi64x(x);
+   for (; i + 2 <= n; i += 2)
+   {
+      const __m128i k = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(bytes + 8 * i)), vflip);
+      rank += inclusive
+         ? 2 - btree_popcount32((uint32_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, vx))))
+         : btree_popcount32((uint32_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(vx, k))));
+   }
+#endif
+
+   for (; i < n; i++)
+   {
+      uint64_t key;
+      memcpy(&key, bytes + 8 * i, sizeof(key));
+      const int64_t k = (int64_t)(key ^ flip);
+      rank += inclusive ? (k <= x) : (k < x);
+   }
+   return rank;
+}
+
+static inline uint32_t btree_rank(const void *const restrict keys, const uint32_t n, const size_t width, const bool is_signed, const void *const restrict needle, const bool inclusive)
+{
+   switch (width)
+   {
+      case 4: { uint32_t v; memcpy(&v, needle, 4); return btree_rank_32(keys, n, v, is_signed, inclusive); }
+      case 8: { uint64_t v; memcpy(&v, needle, 8); return btree_rank_64(keys, n, v, is_signed, inclusive); }
+   }
+   assert(false && "btree_rank: unsupported width");
+   return n;
+}
+
+
+/**
+ * DEFINE_BTREE_MAP macro
+ * ----------------------
+ * Defines an ordered map (B+ tree) from key_type to value_type.
+ *
+ * Parameters:
+ *   key_type   - Type of keys
+ *   value_type - Type of values
+ *   len_type   - Unsigned integer type used for the number of entries
+ *
+ * Output:
+ *   Declaration of B+ tree map for key_type -> value_type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_BTREE_MAP(...), Ensure macro arguments match
+ */
+#define DEFINE_BTREE_MAP(key_type, value_type, len_type) \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+   assert_istype(len_type); \
+\
+enum { key_type##_##value_type##_btree_fanout = BTREE_FANOUT(key_type) }; \
+\
+typedef struct \
+{ \
+   uint16_t count; \
+   uint16_t leaf; \
+   key_type keys[key_type##_##value_type##_btree_fanout]; \
+} key_type##_##value_type##_btree_node_s; \
+\
+typedef struct key_type##_##value_type##_btree_leaf_s \
+{ \
+   key_type##_##value_type##_btree_node_s node; \
+   value_type values[key_type##_##value_type##_btree_fanout]; \
+   struct key_type##_##value_type##_btree_leaf_s *prev; \
+   struct key_type##_##value_type##_btree_leaf_s *next; \
+} key_type##_##value_type##_btree_leaf_s; \
+\
+typedef struct \
+{ \
+   key_type##_##value_type##_btree_node_s node; \
+   key_type##_##value_type##_btree_node_s *children[key_type##_##value_type##_btree_fanout + 1]; \
+} key_type##_##value_type##_btree_inner_s; \
+\
+typedef struct \
+{ \
+   key_type##_##value_type##_btree_node_s *root; /* NULL when empty */ \
+   key_type##_##value_type##_btree_leaf_s *first; \
+   key_type##_##value_type##_btree_leaf_s *last; \
+   len_type len; \
+   uint32_t height; /* inner levels above the leaves */ \
+} key_type##_##value_type##_btree_map_s; \
+\
+/* position of an entry; leaf == NULL past either end */ \
+typedef struct \
+{ \
+   key_type##_##value_type##_btree_leaf_s *leaf; \
+   uint32_t index; \
+} key_type##_##value_type##_btree_map_iterator_s; \
+\
+static inline void key_type##_##value_type##_btree_map_init(key_type##_##value_type##_btree_map_s *const restrict map) \
+{ \
+   map->root = NULL; \
+   map->first = NULL; \
+   map->last = NULL; \
+   map->len = 0; \
+   map->height = 0; \
+} \
+\
+static inline key_type##_##value_type##_btree_map_iterator_s key_type##_##value_type##_btree_map_first(const key_type##_##value_type##_btree_map_s *const restrict map) \
+{ \
+   assert(map); \
+   return (key_type##_##value_type##_btree_map_iterator_s){ map->first, 0 }; \
+} \
+\
+static inline key_type##_##value_type##_btree_map_iterator_s key_type##_##value_type##_btree_map_last(const key_type##_##value_type##_btree_map_s *const restrict map) \
+{ \
+   assert(map); \
+   return (key_type##_##value_type##_btree_map_iterator_s){ map->last, map->last ? map->last->node.count - 1u : 0 }; \
+} \
+\
+static inline bool key_type##_##value_type##_btree_map_iterator_valid(const key_type##_##value_type##_btree_map_iterator_s it) \
+{ \
+   return it.leaf != NULL; \
+} \
+\
+static inline const key_type *key_type##_##value_type##_btree_map_iterator_key(const key_type##_##value_type##_btree_map_iterator_s it) \
+{ \
+   assert(it.leaf && it.index < it.leaf->node.count); \
+   return &it.leaf->node.keys[it.index]; \
+} \
+\
+static inline value_type *key_type##_##value_type##_btree_map_iterator_value(const key_type##_##value_type##_btree_map_iterator_s it) \
+{ \
+   assert(it.leaf && it.index < it.leaf->node.count); \
+   return &it.leaf->values[it.index]; \
+} \
+\
+static inline void key_type##_##value_type##_btree_map_iterator_next(key_type##_##value_type##_btree_map_iterator_s *const restrict it) \
+{ \
+   assert(it && it->leaf); \
+   if (++it->index == it->leaf->node.count) \
+   { \
+      it->leaf = it->leaf->next; \
+      it->index = 0; \
+   } \
+} \
+\
+static inline void key_type##_##value_type##_btree_map_iterator_prev(key_type##_##value_type##_btree_map_iterator_s *const restrict it) \
+{ \
+   assert(it && it->leaf); \
+   if (it->index-- == 0) \
+   { \
+      it->leaf = it->leaf->prev; \
+      it->index = it->leaf ? it->leaf->node.count - 1u : 0; \
+   } \
+} \
+\
+void key_type##_##value_type##_btree_map_clear(key_type##_##value_type##_btree_map_s *const restrict); \
+void key_type##_##value_type##_btree_map_delete(key_type##_##value_type##_btree_map_s *const restrict); \
+bool key_type##_##value_type##_btree_map_insert(key_type##_##value_type##_btree_map_s *const restrict, const key_type, const value_type); \
+value_type *key_type##_##value_type##_btree_map_get(const key_type##_##value_type##_btree_map_s *const restrict, const key_type); \
+bool key_type##_##value_type##_btree_map_remove(key_type##_##value_type##_btree_map_s *const restrict, const key_type); \
+bool key_type##_##value_type##_btree_map_bulk_load(key_type##_##value_type##_btree_map_s *const restrict, const key_type *const restrict, const value_type *const restrict, const len_type); \
+key_type##_##value_type##_btree_map_iterator_s key_type##_##value_type##_btree_map_lower_bound(const key_type##_##value_type##_btree_map_s *const restrict, const key_type); \
+key_type##_##value_type##_btree_map_iterator_s key_type##_##value_type##_btree_map_upper_bound(const key_type##_##value_type##_btree_map_s *const restrict, const key_type);
+
+
+/**
+ * btree_map(key_type, value_type) / btree_map_iterator(key_type, value_type) macros
+ * ---------------------------------------------------------------------------------
+ * Declare a B+ tree map, or an iterator over one.
+ *
+ * Usage (as variables):
+ *   btree_map(uint64_t, order_s) orders;
+ *   btree_map_iterator(uint64_t, order_s) it = btree_map_first(uint64_t, order_s, &orders);
+ *
+ * Usage (as parameter):
+ *   void report(const btree_map(uint64_t, order_s) *const orders) { ... }
+ *
+ * Notes:
+ *   - These macros expand to the underlying struct types
+ *     (key_type##_##value_type##_btree_map_s, ..._btree_map_iterator_s).
+ */
+#define btree_map(key_type, value_type) \
+   key_type##_##value_type##_btree_map_s
+
+#define btree_map_iterator(key_type, value_type) \
+   key_type##_##value_type##_btree_map_iterator_s
+
+
+/**
+ * typecheck_btree_map_ptr macro
+ * -----------------------------
+ * Compile-time validation that 'var' is a pointer to a B+ tree map of
+ * 'key_type' -> 'value_type' (see typecheck_ptr).
+ */
+#define typecheck_btree_map_ptr(var, key_type, value_type, expr) \
+   typecheck_ptr(var, key_type##_##value_type##_btree_map_s, expr)
+
+
+/**
+ * B+ Tree Map Expression Macros
+ * -----------------------------
+ * Direct access to map properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ */
+#define btree_map_len(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      (map)->len \
+   )
+
+#define btree_map_empty(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      (map)->len == 0 \
+   )
+
+#define btree_map_height(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      (map)->height \
+   )
+
+
+/**
+ * GENERATE_BTREE_MAP macro
+ * ------------------------
+ * Implements the B+ tree map functions for a key/value type pair.
+ *
+ * Parameters:
+ *   key_type   - Key type
+ *   value_type - Value type
+ *   len_type   - Unsigned integer type for the number of entries
+ *   compare_fn - int (const key_type*, const key_type*), qsort-style
+ *   alloc_fn   - Allocator for nodes (one call per node; an arena or pool
+ *                can back it)
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - Keys are found by a rank search in each node: 32 and 64-bit integer
+ *     keys use the SIMD rank kernels (compare_fn must then order them
+ *     numerically), other keys binary search with compare_fn.
+ *   - insert() overwrites the value of an existing key. The nodes a split
+ *     needs are allocated before anything moves, so a failed allocation
+ *     leaves the map unchanged.
+ *   - remove() refills a node below half full from a sibling, or merges
+ *     the two.
+ *   - bulk_load(keys, values, n) builds an empty map bottom-up from keys in
+ *     strictly increasing order, with nodes evenly filled.
+ *   - lower_bound(key) / upper_bound(key): iterator to the first key
+ *     >= / > key. Iterators, and pointers from get(), are valid until the
+ *     next insert, remove or bulk_load.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_BTREE_MAP(...), Ensure macro arguments match
+ */
+#define GENERATE_BTREE_MAP(key_type, value_type, len_type, compare_fn, alloc_fn, free_fn) \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+   assert_istype(len_type); \
+   assert_type(compare_fn, int (const key_type*, const key_type*)); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+/* keys[0 .. n) below key: < key, or <= key when inclusive */ \
+static uint32_t key_type##_##value_type##_btree_rank(const key_type *const restrict keys, const uint32_t n, const key_type key, const bool inclusive) \
+{ \
+   if (SEARCH_IS_INTEGRAL(key_type) && (sizeof(key_type) == 4 || sizeof(key_type) == 8)) \
+      return btree_rank(keys, n, sizeof(key_type), BTREE_IS_SIGNED(key_type), &key, inclusive); \
+\
+   uint32_t lo = 0, hi = n; \
+   while (lo < hi) \
+   { \
+      const uint32_t mid = lo + (hi - lo) / 2; \
+      const int c = compare_fn(&keys[mid], &key); \
+      if (c < 0 || (inclusive && c == 0)) \
+         lo = mid + 1; \
+      else \
+         hi = mid; \
+   } \
+   return lo; \
+} \
+\
+static void key_type##_##value_type##_btree_free_node(key_type##_##value_type##_btree_node_s *const node) \
+{ \
+   if (!node->leaf) \
+   { \
+      key_type##_##value_type##_btree_inner_s *const inner = (key_type##_##value_type##_btree_inner_s*)node; \
+      for (uint32_t i = 0; i <= node->count; i++) \
+         key_type##_##value_type##_btree_free_node(inner->children[i]); \
+   } \
+   free_fn(node); \
+} \
+\
+void key_type##_##value_type##_btree_map_clear(key_type##_##value_type##_btree_map_s *const restrict map) \
+{ \
+   assert(map); \
+   if (map->root) \
+      key_type##_##value_type##_btree_free_node(map->root); \
+   key_type##_##value_type##_btree_map_init(map); \
+} \
+\
+void key_type##_##value_type##_btree_map_delete(key_type##_##value_type##_btree_map_s *const restrict map) \
+{ \
+   key_type##_##value_type##_btree_map_clear(map); \
+} \
+\
+static key_type##_##value_type##_btree_leaf_s *key_type##_##value_type##_btree_new_leaf(void) \
+{ \
+   key_type##_##value_type##_btree_leaf_s *const leaf = (key_type##_##value_type##_btree_leaf_s*)alloc_fn(sizeof(key_type##_##value_type##_btree_leaf_s)); \
+   if (leaf) \
+   { \
+      leaf->node.count = 0; \
+      leaf->node.leaf = 1; \
+      leaf->prev = NULL; \
+      leaf->next = NULL; \
+   } \
+   return leaf; \
+} \
+\
+static key_type##_##value_type##_btree_inner_s *key_type##_##value_type##_btree_new_inner(void) \
+{ \
+   key_type##_##value_type##_btree_inner_s *const inner = (key_type##_##value_type##_btree_inner_s*)alloc_fn(sizeof(key_type##_##value_type##_btree_inner_s)); \
+   if (inner) \
+   { \
+      inner->node.count = 0; \
+      inner->node.leaf = 0; \
+   } \
+   return inner; \
+} \
+\
+/* leaf that holds `key` if present */ \
+static key_type##_##value_type##_btree_leaf_s *key_type##_##value_type##_btree_find_leaf(const key_type##_##value_type##_btree_map_s *const restrict map, const key_type key) \
+{ \
+   key_type##_##value_type##_btree_node_s *node = map->root; \
+   while (!node->leaf) \
+      node = ((key_type##_##value_type##_btree_inner_s*)node)->children[key_type##_##value_type##_btree_rank(node->keys, node->count, key, true)]; \
+   return (key_type##_##value_type##_btree_leaf_s*)node; \
+} \
+\
+value_type *key_type##_##value_type##_btree_map_get(const key_type##_##value_type##_btree_map_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   if (!map->root) \
+      return NULL; \
+   key_type##_##value_type##_btree_leaf_s *const leaf = key_type##_##value_type##_btree_find_leaf(map, key); \
+   const uint32_t i = key_type##_##value_type##_btree_rank(leaf->node.keys, leaf->node.count, key, false); \
+   if (i < leaf->node.count && compare_fn(&leaf->node.keys[i], &key) == 0) \
+      return &leaf->values[i]; \
+   return NULL; \
+} \
+\
+static void key_type##_##value_type##_btree_leaf_insert_at(key_type##_##value_type##_btree_leaf_s *const restrict leaf, const uint32_t i, const key_type key, const value_type value) \
+{ \
+   const uint32_t tail = leaf->node.count - i; \
+   MEMORY_MOVE(&leaf->node.keys[i + 1], &leaf->node.keys[i], sizeof(key_type) * tail); \
+   MEMORY_MOVE(&leaf->values[i + 1], &leaf->values[i], sizeof(value_type) * tail); \
+   leaf->node.keys[i] = key; \
+   leaf->values[i] = value; \
+   leaf->node.count++; \
+} \
+\
+/* key and right child after child i */ \
+static void key_type##_##value_type##_btree_inner_insert_at(key_type##_##value_type##_btree_inner_s *const restrict inner, const uint32_t i, const key_type key, key_type##_##value_type##_btree_node_s *const child) \
+{ \
+   const uint32_t tail = inner->node.count - i; \
+   MEMORY_MOVE(&inner->node.keys[i + 1], &inner->node.keys[i], sizeof(key_type) * tail); \
+   MEMORY_MOVE(&inner->children[i + 2], &inner->children[i + 1], sizeof(inner->children[0]) * tail); \
+   inner->node.keys[i] = key; \
+   inner->children[i + 1] = child; \
+   inner->node.count++; \
+} \
+\
+bool key_type##_##value_type##_btree_map_insert(key_type##_##value_type##_btree_map_s *const restrict map, const key_type key, const value_type value) \
+{ \
+   assert(map); \
+   const uint32_t fanout = key_type##_##value_type##_btree_fanout; \
+   if (!map->root) \
+   { \
+      key_type##_##value_type##_btree_leaf_s *const leaf = key_type##_##value_type##_btree_new_leaf(); \
+      if (!leaf) \
+         return false; \
+      leaf->node.keys[0] = key; \
+      leaf->values[0] = value; \
+      leaf->node.count = 1; \
+      map->root = &leaf->node; \
+      map->first = map->last = leaf; \
+      map->len = 1; \
+      return true; \
+   } \
+\
+   /* descend, remembering the path */ \
+   key_type##_##value_type##_btree_inner_s *path[BTREE_MAX_HEIGHT]; \
+   uint32_t slot[BTREE_MAX_HEIGHT]; \
+   key_type##_##value_type##_btree_node_s *node = map->root; \
+   for (uint32_t d = 0; d < map->height; d++) \
+   { \
+      assert(d < BTREE_MAX_HEIGHT); \
+      path[d] = (key_type##_##value_type##_btree_inner_s*)node; \
+      slot[d] = key_type##_##value_type##_btree_rank(node->keys, node->count, key, true); \
+      node = path[d]->children[slot[d]]; \
+   } \
+   key_type##_##value_type##_btree_leaf_s *const leaf = (key_type##_##value_type##_btree_leaf_s*)node; \
+   const uint32_t i = key_type##_##value_type##_btree_rank(leaf->node.keys, leaf->node.count, key, false); \
+   if (i < leaf->node.count && compare_fn(&leaf->node.keys[i], &key) == 0) \
+   { \
+      leaf->values[i] = value; \
+      return true; \
+   } \
+   if (leaf->node.count < fanout) \
+   { \
+      key_type##_##value_type##_btree_leaf_insert_at(leaf, i, key, value); \
+      map->len++; \
+      return true; \
+   } \
+\
+   /* full nodes from the leaf up split; a full root also needs a new root */ \
+   uint32_t splits = 0; \
+   while (splits < map->height && path[map->height - 1 - splits]->node.count == fanout) \
+      splits++; \
+   const uint32_t inner_count = splits + (splits == map->height); \
+   if (map->height + (splits == map->height) > BTREE_MAX_HEIGHT) \
+      return false; \
+   key_type##_##value_type##_btree_inner_s *spare[BTREE_MAX_HEIGHT + 1]; \
+   key_type##_##value_type##_btree_leaf_s *const right = key_type##_##value_type##_btree_new_leaf(); \
+   uint32_t allocated = 0; \
+   while (right && allocated < inner_count && (spare[allocated] = key_type##_##value_type##_btree_new_inner())) \
+      allocated++; \
+   if (!right || allocated < inner_count) \
+   { \
+      while (allocated) \
+         free_fn(spare[--allocated]); \
+      if (right) \
+         free_fn(right); \
+      return false; \
+   } \
+\
+   /* split the leaf: F + 1 entries, the left half keeps (F + 1) / 2 */ \
+   const uint32_t half = (fanout + 1) / 2; \
+   const uint32_t from = (i < half) ? half - 1 : half; \
+   right->node.count = (uint16_t)(fanout - from); \
+   MEMORY_COPY(right->node.keys, &leaf->node.keys[from], sizeof(key_type) * (fanout - from)); \
+   MEMORY_COPY(right->values, &leaf->values[from], sizeof(value_type) * (fanout - from)); \
+   leaf->node.count = (uint16_t)from; \
+   if (i < half) \
+      key_type##_##value_type##_btree_leaf_insert_at(leaf, i, key, value); \
+   else \
+      key_type##_##value_type##_btree_leaf_insert_at(right, i - from, key, value); \
+   right->prev = leaf; \
+   right->next = leaf->next; \
+   if (leaf->next) \
+      leaf->next->prev = right; \
+   else \
+      map->last = right; \
+   leaf->next = right; \
+   map->len++; \
+\
+   /* push the separator up, splitting full inner nodes */ \
+   key_type up_key = right->node.keys[0]; \
+   key_type##_##value_type##_btree_node_s *up_child = &right->node; \
+   uint32_t used = 0; \
+   for (uint32_t d = map->height; d-- > 0;) \
+   { \
+      key_type##_##value_type##_btree_inner_s *const inner = path[d]; \
+      if (inner->node.count < fanout) \
+      { \
+         key_type##_##value_type##_btree_inner_insert_at(inner, slot[d], up_key, up_child); \
+         return true; \
+      } \
+\
+      /* F + 1 keys and F + 2 children: the middle key moves up */ \
+      key_type keys[key_type##_##value_type##_btree_fanout + 1]; \
+      key_type##_##value_type##_btree_node_s *children[key_type##_##value_type##_btree_fanout + 2]; \
+      const uint32_t s = slot[d]; \
+      MEMORY_COPY(keys, inner->node.keys, sizeof(key_type) * s); \
+      keys[s] = up_key; \
+      MEMORY_COPY(&keys[s + 1], &inner->node.keys[s], sizeof(key_type) * (fanout - s)); \
+      MEMORY_COPY(children, inner->children, sizeof(children[0]) * (s + 1)); \
+      children[s + 1] = up_child; \
+      MEMORY_COPY(&children[s + 2], &inner->children[s + 1], sizeof(children[0]) * (fanout - s)); \
+\
+      const uint32_t mid = (fanout + 1) / 2; \
+      key_type##_##value_type##_btree_inner_s *const sibling = spare[used++]; \
+      MEMORY_COPY(inner->node.keys, keys, sizeof(key_type) * mid); \
+      MEMORY_COPY(inner->children, children, sizeof(children[0]) * (mid + 1)); \
+      inner->node.count = (uint16_t)mid; \
+      MEMORY_COPY(sibling->node.keys, &keys[mid + 1], sizeof(key_type) * (fanout - mid)); \
+      MEMORY_COPY(sibling->children, &children[mid + 1], sizeof(children[0]) * (fanout - mid + 1)); \
+      sibling->node.count = (uint16_t)(fanout - mid); \
+      up_key = keys[mid]; \
+      up_child = &sibling->node; \
+   } \
+\
+   /* the root split */ \
+   key_type##_##value_type##_btree_inner_s *const root = spare[used++]; \
+   assert(used == inner_count); \
+   root->node.keys[0] = up_key; \
+   root->children[0] = map->root; \
+   root->children[1] = up_child; \
+   root->node.count = 1; \
+   map->root = &root->node; \
+   map->height++; \
+   return true; \
+} \
+\
+/* refill children[i] of parent, below half full, from a sibling or merge it with one */ \
+static void key_type##_##value_type##_btree_rebalance(key_type##_##value_type##_btree_map_s *const restrict map, key_type##_##value_type##_btree_inner_s *const restrict parent, uint32_t i) \
+{ \
+   const uint32_t min = key_type##_##value_type##_btree_fanout / 2; \
+   key_type##_##value_type##_btree_node_s *const child = parent->children[i]; \
+   key_type##_##value_type##_btree_node_s *const left = (i > 0) ? parent->children[i - 1] : NULL; \
+   key_type##_##value_type##_btree_node_s *const right = (i < parent->node.count) ? parent->children[i + 1] : NULL; \
+\
+   if (left && left->count > min) \
+   { \
+      /* borrow the last entry of the left sibling */ \
+      MEMORY_MOVE(&child->keys[1], &child->keys[0], sizeof(key_type) * child->count); \
+      if (child->leaf) \
+      { \
+         key_type##_##value_type##_btree_leaf_s *const c = (key_type##_##value_type##_btree_leaf_s*)child; \
+         key_type##_##value_type##_btree_leaf_s *const l = (key_type##_##value_type##_btree_leaf_s*)left; \
+         MEMORY_MOVE(&c->values[1], &c->values[0], sizeof(value_type) * child->count); \
+         child->keys[0] = left->keys[left->count - 1]; \
+         c->values[0] = l->values[left->count - 1]; \
+         parent->node.keys[i - 1] = child->keys[0]; \
+      } \
+      else \
+      { \
+         key_type##_##value_type##_btree_inner_s *const c = (key_type##_##value_type##_btree_inner_s*)child; \
+         key_type##_##value_type##_btree_inner_s *const l = (key_type##_##value_type##_btree_inner_s*)left; \
+         MEMORY_MOVE(&c->children[1], &c->children[0], sizeof(c->children[0]) * (child->count + 1)); \
+         child->keys[0] = parent->node.keys[i - 1]; \
+         c->children[0] = l->children[left->count]; \
+         parent->node.keys[i - 1] = left->keys[left->count - 1]; \
+      } \
+      child->count++; \
+      left->count--; \
+      return; \
+   } \
+\
+   if (right && right->count > min) \
+   { \
+      /* borrow the first entry of the right sibling */ \
+      if (child->leaf) \
+      { \
+         key_type##_##value_type##_btree_leaf_s *const c = (key_type##_##value_type##_btree_leaf_s*)child; \
+         key_type##_##value_type##_btree_leaf_s *const r = (key_type##_##value_type##_btree_leaf_s*)right; \
+         child->keys[child->count] = right->keys[0]; \
+         c->values[child->count] = r->values[0]; \
+         MEMORY_MOVE(&r->values[0], &r->values[1], sizeof(value_type) * (right->count - 1)); \
+         MEMORY_MOVE(&right->keys[0], &right->keys[1], sizeof(key_type) * (right->count - 1)); \
+         parent->node.keys[i] = right->keys[0]; \
+      } \
+      else \
+      { \
+         key_type##_##value_type##_btree_inner_s *const c = (key_type##_##value_type##_btree_inner_s*)child; \
+         key_type##_##value_type##_btree_inner_s *const r = (key_type##_##value_type##_btree_inner_s*)right; \
+         child->keys[child->count] = parent->node.keys[i]; \
+         c->children[child->count + 1] = r->children[0]; \
+         parent->node.keys[i] = right->keys[0]; \
+         MEMORY_MOVE(&right->keys[0], &right->keys[1], sizeof(key_type) * (right->count - 1)); \
+         MEMORY_MOVE(&r->children[0], &r->children[1], sizeof(r->children[0]) * right->count); \
+      } \
+      child->count++; \
+      right->count--; \
+      return; \
+   } \
+\
+   /* merge children[i + 1] into children[i], after stepping left if there is no right sibling */ \
+   if (!right) \
+      i--; \
+   key_type##_##value_type##_btree_node_s *const a = parent->children[i]; \
+   key_type##_##value_type##_btree_node_s *const b = parent->children[i + 1]; \
+   if (a->leaf) \
+   { \
+      key_type##_##value_type##_btree_leaf_s *const la = (key_type##_##value_type##_btree_leaf_s*)a; \
+      key_type##_##value_type##_btree_leaf_s *const lb = (key_type##_##value_type##_btree_leaf_s*)b; \
+      MEMORY_COPY(&a->keys[a->count], b->keys, sizeof(key_type) * b->count); \
+      MEMORY_COPY(&la->values[a->count], lb->values, sizeof(value_type) * b->count); \
+      a->count += b->count; \
+      la->next = lb->next; \
+      if (lb->next) \
+         lb->next->prev = la; \
+      else \
+         map->last = la; \
+   } \
+   else \
+   { \
+      key_type##_##value_type##_btree_inner_s *const ia = (key_type##_##value_type##_btree_inner_s*)a; \
+      key_type##_##value_type##_btree_inner_s *const ib = (key_type##_##value_type##_btree_inner_s*)b; \
+      a->keys[a->count] = parent->node.keys[i]; \
+      MEMORY_COPY(&a->keys[a->count + 1], b->keys, sizeof(key_type) * b->count); \
+      MEMORY_COPY(&ia->children[a->count + 1], ib->children, sizeof(ib->children[0]) * (b->count + 1)); \
+      a->count += b->count + 1; \
+   } \
+   free_fn(b); \
+\
+   const uint32_t tail = parent->node.count - i - 1; \
+   MEMORY_MOVE(&parent->node.keys[i], &parent->node.keys[i + 1], sizeof(key_type) * tail); \
+   MEMORY_MOVE(&parent->children[i + 1], &parent->children[i + 2], sizeof(parent->children[0]) * tail); \
+   parent->node.count--; \
+} \
+\
+bool key_type##_##value_type##_btree_map_remove(key_type##_##value_type##_btree_map_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   if (!map->root) \
+      return false; \
+\
+   key_type##_##value_type##_btree_inner_s *path[BTREE_MAX_HEIGHT]; \
+   uint32_t slot[BTREE_MAX_HEIGHT]; \
+   key_type##_##value_type##_btree_node_s *node = map->root; \
+   for (uint32_t d = 0; d < map->height; d++) \
+   { \
+      path[d] = (key_type##_##value_type##_btree_inner_s*)node; \
+      slot[d] = key_type##_##value_type##_btree_rank(node->keys, node->count, key, true); \
+      node = path[d]->children[slot[d]]; \
+   } \
+   key_type##_##value_type##_btree_leaf_s *const leaf = (key_type##_##value_type##_btree_leaf_s*)node; \
+   const uint32_t i = key_type##_##value_type##_btree_rank(leaf->node.keys, leaf->node.count, key, false); \
+   if (i >= leaf->node.count || compare_fn(&leaf->node.keys[i], &key) != 0) \
+      return false; \
+\
+   const uint32_t tail = leaf->node.count - i - 1; \
+   MEMORY_MOVE(&leaf->node.keys[i], &leaf->node.keys[i + 1], sizeof(key_type) * tail); \
+   MEMORY_MOVE(&leaf->values[i], &leaf->values[i + 1], sizeof(value_type) * tail); \
+   leaf->node.count--; \
+   map->len--; \
+\
+   /* rebalance upwards while nodes are below half full */ \
+   for (uint32_t d = map->height; d-- > 0;) \
+   { \
+      if (path[d]->children[slot[d]]->count >= key_type##_##value_type##_btree_fanout / 2) \
+         break; \
+      key_type##_##value_type##_btree_rebalance(map, path[d], slot[d]); \
+   } \
+\
+   /* shrink from the root */ \
+   if (map->root->count == 0) \
+   { \
+      key_type##_##value_type##_btree_node_s *const old = map->root; \
+      if (old->leaf) \
+      { \
+         map->root = NULL; \
+         map->first = map->last = NULL; \
+      } \
+      else \
+      { \
+         map->root = ((key_type##_##value_type##_btree_inner_s*)old)->children[0]; \
+         map->height--; \
+      } \
+      free_fn(old); \
+   } \
+   return true; \
+} \
+\
+bool key_type##_##value_type##_btree_map_bulk_load(key_type##_##value_type##_btree_map_s *const restrict map, const key_type *const restrict keys, const value_type *const restrict values, const len_type n) \
+{ \
+   assert(map); \
+   const size_t fanout = key_type##_##value_type##_btree_fanout; \
+   if (map->root) \
+      return false; \
+   if (n == 0) \
+      return true; \
+   assert(keys && values); \
+   for (len_type i = 1; i < n; i++) \
+      if (compare_fn(&keys[i - 1], &keys[i]) >= 0) \
+         return false; \
+\
+   /* one level of nodes at a time, with the smallest key under each */ \
+   size_t count = ((size_t)n + fanout - 1) / fanout; \
+   key_type##_##value_type##_btree_node_s **const level = (key_type##_##value_type##_btree_node_s**)alloc_fn(sizeof(*level) * count); \
+   key_type *const mins = (key_type*)alloc_fn(sizeof(key_type) * count); \
+   if (!level || !mins) \
+   { \
+      if (level) \
+         free_fn(level); \
+      if (mins) \
+         free_fn(mins); \
+      return false; \
+   } \
+\
+   /* leaves, evenly filled so each holds at least half */ \
+   size_t done = 0; \
+   key_type##_##value_type##_btree_leaf_s *first = NULL, *prev = NULL; \
+   for (size_t j = 0; j < count; j++) \
+   { \
+      const size_t size = (size_t)n / count + (j < (size_t)n % count); \
+      key_type##_##value_type##_btree_leaf_s *const leaf = key_type##_##value_type##_btree_new_leaf(); \
+      if (!leaf) \
+      { \
+         while (j) \
+            free_fn(level[--j]); \
+         free_fn(level); \
+         free_fn(mins); \
+         return false; \
+      } \
+      MEMORY_COPY(leaf->node.keys, &keys[done], sizeof(key_type) * size); \
+      MEMORY_COPY(leaf->values, &values[done], sizeof(value_type) * size); \
+      leaf->node.count = (uint16_t)size; \
+      leaf->prev = prev; \
+      if (prev) \
+         prev->next = leaf; \
+      else \
+         first = leaf; \
+      level[j] = &leaf->node; \
+      mins[j] = keys[done]; \
+      done += size; \
+      prev = leaf; \
+   } \
+   map->first = first; \
+   map->last = prev; \
+\
+   /* inner levels, each node taking an even share of the level below */ \
+   uint32_t height = 0; \
+   while (count > 1) \
+   { \
+      const size_t parents = (count + fanout) / (fanout + 1); \
+      size_t taken = 0; \
+      for (size_t p = 0; p < parents; p++) \
+      { \
+         const size_t size = count / parents + (p < count % parents); \
+         key_type##_##value_type##_btree_inner_s *const inner = key_type##_##value_type##_btree_new_inner(); \
+         if (!inner) \
+         { \
+            /* free the new parents (with their subtrees) and the nodes not yet taken */ \
+            for (size_t q = 0; q < p; q++) \
+               key_type##_##value_type##_btree_free_node(level[q]); \
+            for (size_t q = taken; q < count; q++) \
+               key_type##_##value_type##_btree_free_node(level[q]); \
+            free_fn(level); \
+            free_fn(mins); \
+            key_type##_##value_type##_btree_map_init(map); \
+            return false; \
+         } \
+         for (size_t c = 0; c < size; c++) \
+         { \
+            inner->children[c] = level[taken + c]; \
+            if (c > 0) \
+               inner->node.keys[c - 1] = mins[taken + c]; \
+         } \
+         inner->node.count = (uint16_t)(size - 1); \
+         mins[p] = mins[taken]; \
+         level[p] = &inner->node; \
+         taken += size; \
+      } \
+      count = parents; \
+      height++; \
+   } \
+\
+   map->root = level[0]; \
+   map->height = height; \
+   map->len = n; \
+   free_fn(level); \
+   free_fn(mins); \
+   return true; \
+} \
+\
+key_type##_##value_type##_btree_map_iterator_s key_type##_##value_type##_btree_map_lower_bound(const key_type##_##value_type##_btree_map_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   key_type##_##value_type##_btree_map_iterator_s it = { NULL, 0 }; \
+   if (!map->root) \
+      return it; \
+   it.leaf = key_type##_##value_type##_btree_find_leaf(map, key); \
+   it.index = key_type##_##value_type##_btree_rank(it.leaf->node.keys, it.leaf->node.count, key, false); \
+   if (it.index == it.leaf->node.count) \
+   { \
+      it.leaf = it.leaf->next; \
+      it.index = 0; \
+   } \
+   return it; \
+} \
+\
+key_type##_##value_type##_btree_map_iterator_s key_type##_##value_type##_btree_map_upper_bound(const key_type##_##value_type##_btree_map_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   key_type##_##value_type##_btree_map_iterator_s it = { NULL, 0 }; \
+   if (!map->root) \
+      return it; \
+   it.leaf = key_type##_##value_type##_btree_find_leaf(map, key); \
+   it.index = key_type##_##value_type##_btree_rank(it.leaf->node.keys, it.leaf->node.count, key, true); \
+   if (it.index == it.leaf->node.count) \
+   { \
+      it.leaf = it.leaf->next; \
+      it.index = 0; \
+   } \
+   return it; \
+}
+
+
+/**
+ * B+ tree map function macros
+ * ---------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_BTREE_MAP.
+ *
+ * Usage:
+ *   btree_map(uint64_t, double) prices;
+ *   btree_map_init(uint64_t, double, &prices);
+ *   btree_map_insert(uint64_t, double, &prices, 42, 9.5);   // false on allocation failure
+ *   double *p = btree_map_get(uint64_t, double, &prices, 42);   // NULL if absent
+ *
+ *   // every key in [100, 200), in order
+ *   for (btree_map_iterator(uint64_t, double) it = btree_map_lower_bound(uint64_t, double, &prices, 100);
+ *        btree_map_iterator_valid(uint64_t, double, it) && *btree_map_iterator_key(uint64_t, double, it) < 200;
+ *        btree_map_iterator_next(uint64_t, double, &it))
+ *      total += *btree_map_iterator_value(uint64_t, double, it);
+ *
+ *   btree_map_delete(uint64_t, double, &prices);
+ */
+#define btree_map_init(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_init((map)) \
+   )
+
+#define btree_map_clear(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_clear((map)) \
+   )
+
+#define btree_map_delete(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_delete((map)) \
+   )
+
+#define btree_map_insert(key_type, value_type, map, key, value) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_insert((map), (key), (value)) \
+   )
+
+#define btree_map_get(key_type, value_type, map, key) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_get((map), (key)) \
+   )
+
+#define btree_map_contains(key_type, value_type, map, key) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      (key_type##_##value_type##_btree_map_get((map), (key)) != NULL) \
+   )
+
+#define btree_map_remove(key_type, value_type, map, key) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_remove((map), (key)) \
+   )
+
+#define btree_map_bulk_load(key_type, value_type, map, keys, values, n) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_bulk_load((map), (keys), (values), (n)) \
+   )
+
+#define btree_map_first(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_first((map)) \
+   )
+
+#define btree_map_last(key_type, value_type, map) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_last((map)) \
+   )
+
+#define btree_map_lower_bound(key_type, value_type, map, key) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_lower_bound((map), (key)) \
+   )
+
+#define btree_map_upper_bound(key_type, value_type, map, key) \
+   typecheck_btree_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_btree_map_upper_bound((map), (key)) \
+   )
+
+#define btree_map_iterator_valid(key_type, value_type, it) \
+   key_type##_##value_type##_btree_map_iterator_valid((it))
+
+#define btree_map_iterator_key(key_type, value_type, it) \
+   key_type##_##value_type##_btree_map_iterator_key((it))
+
+#define btree_map_iterator_value(key_type, value_type, it) \
+   key_type##_##value_type##_btree_map_iterator_value((it))
+
+#define btree_map_iterator_next(key_type, value_type, it) \
+   key_type##_##value_type##_btree_map_iterator_next((it))
+
+#define btree_map_iterator_prev(key_type, value_type, it) \
+   key_type##_##value_type##_btree_map_iterator_prev((it))
+
+
+#endif /* __BTREE_H */
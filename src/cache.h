@@ -0,0 +1,561 @@
+#ifndef __CACHE_H
+#define __CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "hashmap.h"
+
+
+/**
+ * Cache
+ * -----
+ * Bounded key -> value cache with CLOCK (second chance) eviction.
+ *
+ *   entries - contiguous array of `capacity` entries, the eviction order
+ *   index   - open addressing table (hashmap control bytes and group
+ *             probing) from key to entry number
+ *
+ * get() marks an entry referenced. When the cache is full, put() moves the
+ * clock hand over the entries: a referenced entry loses its mark and is
+ * passed over, the first unreferenced, unpinned entry is evicted and its
+ * place reused. Pinned entries are never evicted.
+ *
+ * Notes:
+ *   The index holds at most 2/3 of its slots' load budget in live keys, so
+ *   the tombstones left by evictions trigger a same-size rebuild (one hash
+ *   per live key) at most once every capacity / 2 insertions.
+ */
+#define CACHE_NONE(len_type) ((len_type)-1)
+
+
+/**
+ * DEFINE_CACHE macro
+ * ------------------
+ * Defines a bounded cache type from `key_type` to `value_type`.
+ *
+ * Parameters:
+ *   key_type   - Type of the keys
+ *   value_type - Type of the values
+ *   len_type   - Unsigned integer type used for length/capacity
+ *
+ * Output:
+ *   Declaration of cache for key_type -> value_type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_CACHE(...), Ensure macro arguments match
+ */
+#define DEFINE_CACHE(key_type, value_type, len_type) \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   key_type key; \
+   value_type value; \
+   len_type slot; /* index slot of the key; next free entry while free */ \
+   len_type pins; /* pin count, CACHE_NONE while free */ \
+   bool referenced; \
+} key_type##_##value_type##_cache_entry_s; \
+\
+typedef struct \
+{ \
+   int8_t *ctrl; /* index control bytes (see hashmap.h) */ \
+   len_type *index; /* index slot -> entry number */ \
+   key_type##_##value_type##_cache_entry_s *entries; \
+   len_type len; \
+   len_type capacity; /* entries */ \
+   len_type index_capacity; \
+   len_type growth_left; \
+   len_type used; /* entries handed out since the last clear */ \
+   len_type free_head; /* first free entry below used, CACHE_NONE */ \
+   len_type hand; \
+   uint64_t hits; \
+   uint64_t misses; \
+   uint64_t evictions; \
+   void (*evict)(key_type, value_type*, void*); \
+   void *ctx; \
+} key_type##_##value_type##_cache_s; \
+\
+static inline void key_type##_##value_type##_cache_init(key_type##_##value_type##_cache_s *const restrict cache, const len_type capacity, void (*const evict)(key_type, value_type*, void*), void *const ctx) \
+{ \
+   assert(capacity > 0 && capacity < CACHE_NONE(len_type)); \
+   cache->ctrl = NULL; \
+   cache->index = NULL; \
+   cache->entries = NULL; \
+   cache->len = 0; \
+   cache->capacity = capacity; \
+   cache->index_capacity = 0; \
+   cache->growth_left = 0; \
+   cache->used = 0; \
+   cache->free_head = CACHE_NONE(len_type); \
+   cache->hand = 0; \
+   cache->hits = 0; \
+   cache->misses = 0; \
+   cache->evictions = 0; \
+   cache->evict = evict; \
+   cache->ctx = ctx; \
+} \
+\
+void key_type##_##value_type##_cache_clear(key_type##_##value_type##_cache_s *const restrict); \
+void key_type##_##value_type##_cache_delete(key_type##_##value_type##_cache_s *const restrict); \
+bool key_type##_##value_type##_cache_contains(const key_type##_##value_type##_cache_s *const restrict, const key_type); \
+value_type *key_type##_##value_type##_cache_get(key_type##_##value_type##_cache_s *const restrict, const key_type); \
+bool key_type##_##value_type##_cache_put(key_type##_##value_type##_cache_s *const restrict, const key_type, const value_type); \
+value_type *key_type##_##value_type##_cache_pin(key_type##_##value_type##_cache_s *const restrict, const key_type); \
+bool key_type##_##value_type##_cache_unpin(key_type##_##value_type##_cache_s *const restrict, const key_type); \
+bool key_type##_##value_type##_cache_remove(key_type##_##value_type##_cache_s *const restrict, const key_type);
+
+
+/**
+ * cache(key_type, value_type) macro
+ * ---------------------------------
+ * Declares a cache variable of the given key and value types.
+ *
+ * Usage (as variable):
+ *   cache(uint64_t, image_ptr) thumbnails;
+ *
+ * Usage (as parameter):
+ *   void load(cache(uint64_t, image_ptr) *const thumbnails) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (key_type##_##value_type##_cache_s).
+ */
+#define cache(key_type, value_type) \
+   key_type##_##value_type##_cache_s
+
+
+/**
+ * typecheck_cache_ptr macro
+ * -------------------------
+ * Compile-time validation that 'var' is a pointer to a cache of
+ * 'key_type' -> 'value_type' (see typecheck_ptr).
+ */
+#define typecheck_cache_ptr(var, key_type, value_type, expr) \
+   typecheck_ptr(var, key_type##_##value_type##_cache_s, expr)
+
+
+/**
+ * Cache Expression Macros
+ * -----------------------
+ * Direct access to cache properties and counters, type-checked at
+ * compile-time (C11+) with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   printf("%zu / %zu cached, hit rate %.1f%%, %llu evicted\n",
+ *      cache_len(uint64_t, image_ptr, &c), cache_capacity(uint64_t, image_ptr, &c),
+ *      100.0 * cache_hit_rate(uint64_t, image_ptr, &c), cache_evictions(uint64_t, image_ptr, &c));
+ */
+#define cache_len(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->len \
+   )
+
+#define cache_capacity(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->capacity \
+   )
+
+#define cache_empty(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->len == 0 \
+   )
+
+#define cache_full(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->len == (cache)->capacity \
+   )
+
+#define cache_hits(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->hits \
+   )
+
+#define cache_misses(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->misses \
+   )
+
+#define cache_evictions(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (cache)->evictions \
+   )
+
+#define cache_hit_rate(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      (((cache)->hits + (cache)->misses) ? (double)(cache)->hits / (double)((cache)->hits + (cache)->misses) : 0.0) \
+   )
+
+
+/**
+ * GENERATE_CACHE macro
+ * --------------------
+ * Implements the cache functions for a key/value type pair.
+ *
+ * Parameters:
+ *   key_type   - Key type
+ *   value_type - Value type
+ *   len_type   - Unsigned integer type for length & capacity
+ *   hash_fn    - uint64_t (key_type), e.g. hash_bytes(&key, sizeof(key), seed)
+ *   equal_fn   - bool (key_type, key_type)
+ *   alloc_fn   - Allocator for the entries and the index
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - init(capacity, evict, ctx) fixes the number of entries; nothing is
+ *     allocated until the first put. Entries and index are then one
+ *     allocation that never grows.
+ *   - get(key) / pin(key): pointer to the cached value or NULL, counted as
+ *     a hit or a miss. The pointer stays valid while the entry is cached;
+ *     pin() keeps it cached until the matching unpin().
+ *   - put(key, value): inserts, or replaces the value of a cached key.
+ *     When full, evicts one entry by CLOCK. Returns false if allocation
+ *     fails, every entry is pinned, or the key is pinned (cache unchanged).
+ *   - evict(key, &value, ctx), if not NULL, is called for every value the
+ *     cache lets go of: evicted, replaced by put, removed, or dropped by
+ *     clear/delete. It must not call into the cache.
+ *   - remove(key): false if the key is absent or pinned.
+ *   - The hit / miss / eviction counters start at init and survive clear;
+ *     `evictions` counts capacity evictions only.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_CACHE(...), Ensure macro arguments match
+ *    hash_fn should mix all 64 bits (see GENERATE_HASHMAP).
+ */
+#define GENERATE_CACHE(key_type, value_type, len_type, hash_fn, equal_fn, alloc_fn, free_fn) \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+   assert_istype(len_type); \
+   assert_type(hash_fn, uint64_t (key_type)); \
+   assert_type(equal_fn, bool (key_type, key_type)); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+/* index slot holding `key`, or index_capacity */ \
+static inline size_t key_type##_##value_type##_cache_find(const key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   const uint64_t hash = hash_fn(key); \
+   const size_t mask = (size_t)cache->index_capacity - 1; \
+   const int8_t h2 = hashmap_h2(hash); \
+   size_t pos = hashmap_h1(hash) & mask; \
+   for (size_t step = HASHMAP_GROUP_WIDTH;; step += HASHMAP_GROUP_WIDTH) \
+   { \
+      const int8_t *const group = cache->ctrl + pos; \
+      for (uint32_t match = hashmap_group_match(group, h2); match; match &= match - 1) \
+      { \
+         const size_t i = (pos + hashmap_ctz(match)) & mask; \
+         if (equal_fn(cache->entries[cache->index[i]].key, key)) \
+            return i; \
+      } \
+      if (hashmap_group_match(group, HASHMAP_EMPTY)) \
+         return cache->index_capacity; \
+      pos = (pos + step) & mask; \
+   } \
+} \
+\
+/* entry of `key`, or CACHE_NONE */ \
+static inline len_type key_type##_##value_type##_cache_lookup(const key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   if (cache->len == 0) \
+      return CACHE_NONE(len_type); \
+   const size_t slot = key_type##_##value_type##_cache_find(cache, key); \
+   return (slot < cache->index_capacity) ? cache->index[slot] : CACHE_NONE(len_type); \
+} \
+\
+static bool key_type##_##value_type##_cache_allocate(key_type##_##value_type##_cache_s *const restrict cache) \
+{ \
+   /* smallest power of two whose load budget is 3/2 of the entries */ \
+   size_t index_capacity = HASHMAP_MIN_CAPACITY; \
+   while (hashmap_max_load(index_capacity) < (size_t)cache->capacity + cache->capacity / 2) \
+   { \
+      if (index_capacity > (len_type)(-1) / 2) /* Prevent overflow */ \
+         return false; \
+      index_capacity *= 2; \
+   } \
+\
+   /* a multiple of 16 control bytes, then a multiple of 16 slots: entries stay aligned */ \
+   const size_t ctrl_bytes = index_capacity + HASHMAP_GROUP_WIDTH; \
+   unsigned char *const block = (unsigned char*)alloc_fn(ctrl_bytes + sizeof(len_type) * index_capacity + sizeof(key_type##_##value_type##_cache_entry_s) * cache->capacity); \
+   if (!block) \
+      return false; \
+\
+   cache->ctrl = (int8_t*)block; \
+   cache->index = (len_type*)(block + ctrl_bytes); \
+   cache->entries = (key_type##_##value_type##_cache_entry_s*)(cache->index + index_capacity); \
+   cache->index_capacity = (len_type)index_capacity; \
+   memset(cache->ctrl, HASHMAP_EMPTY, ctrl_bytes); \
+   cache->growth_left = (len_type)hashmap_max_load(index_capacity); \
+   return true; \
+} \
+\
+/* same-size rebuild of the index from the live entries, drops tombstones */ \
+static void key_type##_##value_type##_cache_rebuild(key_type##_##value_type##_cache_s *const restrict cache) \
+{ \
+   memset(cache->ctrl, HASHMAP_EMPTY, (size_t)cache->index_capacity + HASHMAP_GROUP_WIDTH); \
+   for (len_type e = 0; e < cache->used; e++) \
+   { \
+      key_type##_##value_type##_cache_entry_s *const entry = &cache->entries[e]; \
+      if (entry->pins == CACHE_NONE(len_type)) \
+         continue; \
+      const uint64_t hash = hash_fn(entry->key); \
+      const size_t slot = hashmap_find_free(cache->ctrl, cache->index_capacity, hash); \
+      hashmap_set_ctrl(cache->ctrl, cache->index_capacity, slot, hashmap_h2(hash)); \
+      cache->index[slot] = e; \
+      entry->slot = (len_type)slot; \
+   } \
+   cache->growth_left = (len_type)(hashmap_max_load(cache->index_capacity) - cache->len); \
+} \
+\
+/* next victim of the clock hand, CACHE_NONE if every entry is pinned (cache full) */ \
+static len_type key_type##_##value_type##_cache_sweep(key_type##_##value_type##_cache_s *const restrict cache) \
+{ \
+   /* two turns: the first may only clear reference marks */ \
+   for (size_t step = 0; step < 2 * (size_t)cache->capacity; step++) \
+   { \
+      const len_type e = cache->hand; \
+      key_type##_##value_type##_cache_entry_s *const entry = &cache->entries[e]; \
+      cache->hand = (e + 1 < cache->capacity) ? e + 1 : 0; \
+      if (entry->pins) \
+         continue; \
+      if (!entry->referenced) \
+         return e; \
+      entry->referenced = false; \
+   } \
+   return CACHE_NONE(len_type); \
+} \
+\
+/* takes an entry out of the index; the entry itself is left to the caller */ \
+static inline void key_type##_##value_type##_cache_unindex(key_type##_##value_type##_cache_s *const restrict cache, const len_type e) \
+{ \
+   cache->growth_left += hashmap_erase_ctrl(cache->ctrl, cache->index_capacity, cache->entries[e].slot); \
+   cache->len--; \
+} \
+\
+void key_type##_##value_type##_cache_clear(key_type##_##value_type##_cache_s *const restrict cache) \
+{ \
+   assert(cache); \
+   if (!cache->ctrl) \
+      return; \
+   for (len_type e = 0; e < cache->used; e++) \
+   { \
+      key_type##_##value_type##_cache_entry_s *const entry = &cache->entries[e]; \
+      if (entry->pins != CACHE_NONE(len_type) && cache->evict) \
+         cache->evict(entry->key, &entry->value, cache->ctx); \
+   } \
+   memset(cache->ctrl, HASHMAP_EMPTY, (size_t)cache->index_capacity + HASHMAP_GROUP_WIDTH); \
+   cache->len = 0; \
+   cache->growth_left = (len_type)hashmap_max_load(cache->index_capacity); \
+   cache->used = 0; \
+   cache->free_head = CACHE_NONE(len_type); \
+   cache->hand = 0; \
+} \
+\
+void key_type##_##value_type##_cache_delete(key_type##_##value_type##_cache_s *const restrict cache) \
+{ \
+   assert(cache); \
+   key_type##_##value_type##_cache_clear(cache); \
+   if (cache->ctrl) \
+      free_fn(cache->ctrl); \
+   cache->ctrl = NULL; \
+   cache->index = NULL; \
+   cache->entries = NULL; \
+   cache->index_capacity = 0; \
+   cache->growth_left = 0; \
+} \
+\
+bool key_type##_##value_type##_cache_contains(const key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   assert(cache); \
+   return key_type##_##value_type##_cache_lookup(cache, key) != CACHE_NONE(len_type); \
+} \
+\
+value_type *key_type##_##value_type##_cache_get(key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   assert(cache); \
+   const len_type e = key_type##_##value_type##_cache_lookup(cache, key); \
+   if (e == CACHE_NONE(len_type)) \
+   { \
+      cache->misses++; \
+      return NULL; \
+   } \
+   cache->hits++; \
+   cache->entries[e].referenced = true; \
+   return &cache->entries[e].value; \
+} \
+\
+bool key_type##_##value_type##_cache_put(key_type##_##value_type##_cache_s *const restrict cache, const key_type key, const value_type value) \
+{ \
+   assert(cache); \
+   if (!cache->ctrl && !key_type##_##value_type##_cache_allocate(cache)) \
+      return false; \
+\
+   len_type e = key_type##_##value_type##_cache_lookup(cache, key); \
+   if (e != CACHE_NONE(len_type)) \
+   { \
+      key_type##_##value_type##_cache_entry_s *const entry = &cache->entries[e]; \
+      if (entry->pins) \
+         return false; \
+      if (cache->evict) \
+         cache->evict(entry->key, &entry->value, cache->ctx); \
+      entry->value = value; \
+      entry->referenced = true; \
+      return true; \
+   } \
+\
+   /* a free entry, a never used one, or the clock's victim */ \
+   if (cache->free_head != CACHE_NONE(len_type)) \
+   { \
+      e = cache->free_head; \
+      cache->free_head = cache->entries[e].slot; \
+   } \
+   else if (cache->used < cache->capacity) \
+   { \
+      e = cache->used++; \
+      cache->entries[e].pins = CACHE_NONE(len_type); /* out of a rebuild below */ \
+   } \
+   else \
+   { \
+      e = key_type##_##value_type##_cache_sweep(cache); \
+      if (e == CACHE_NONE(len_type)) \
+         return false; \
+      key_type##_##value_type##_cache_entry_s *const victim = &cache->entries[e]; \
+      key_type##_##value_type##_cache_unindex(cache, e); \
+      victim->pins = CACHE_NONE(len_type); /* out of a rebuild below */ \
+      cache->evictions++; \
+      if (cache->evict) \
+         cache->evict(victim->key, &victim->value, cache->ctx); \
+   } \
+\
+   const uint64_t hash = hash_fn(key); \
+   size_t slot = hashmap_find_free(cache->ctrl, cache->index_capacity, hash); \
+   if (cache->growth_left == 0 && cache->ctrl[slot] == HASHMAP_EMPTY) \
+   { \
+      key_type##_##value_type##_cache_rebuild(cache); \
+      slot = hashmap_find_free(cache->ctrl, cache->index_capacity, hash); \
+   } \
+   cache->growth_left -= (cache->ctrl[slot] == HASHMAP_EMPTY); \
+   hashmap_set_ctrl(cache->ctrl, cache->index_capacity, slot, hashmap_h2(hash)); \
+   cache->index[slot] = e; \
+\
+   key_type##_##value_type##_cache_entry_s *const entry = &cache->entries[e]; \
+   entry->key = key; \
+   entry->value = value; \
+   entry->slot = (len_type)slot; \
+   entry->pins = 0; \
+   entry->referenced = false; \
+   cache->len++; \
+   return true; \
+} \
+\
+value_type *key_type##_##value_type##_cache_pin(key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   assert(cache); \
+   value_type *const value = key_type##_##value_type##_cache_get(cache, key); \
+   if (value) \
+   { \
+      key_type##_##value_type##_cache_entry_s *const entry = (key_type##_##value_type##_cache_entry_s*)((unsigned char*)value - offsetof(key_type##_##value_type##_cache_entry_s, value)); \
+      assert(entry->pins < CACHE_NONE(len_type) - 1); \
+      entry->pins++; \
+   } \
+   return value; \
+} \
+\
+bool key_type##_##value_type##_cache_unpin(key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   assert(cache); \
+   const len_type e = key_type##_##value_type##_cache_lookup(cache, key); \
+   if (e == CACHE_NONE(len_type) || cache->entries[e].pins == 0) \
+      return false; \
+   cache->entries[e].pins--; \
+   return true; \
+} \
+\
+bool key_type##_##value_type##_cache_remove(key_type##_##value_type##_cache_s *const restrict cache, const key_type key) \
+{ \
+   assert(cache); \
+   const len_type e = key_type##_##value_type##_cache_lookup(cache, key); \
+   if (e == CACHE_NONE(len_type) || cache->entries[e].pins) \
+      return false; \
+\
+   key_type##_##value_type##_cache_entry_s *const entry = &cache->entries[e]; \
+   key_type##_##value_type##_cache_unindex(cache, e); \
+   if (cache->evict) \
+      cache->evict(entry->key, &entry->value, cache->ctx); \
+   entry->pins = CACHE_NONE(len_type); \
+   entry->slot = cache->free_head; \
+   cache->free_head = e; \
+   return true; \
+}
+
+
+/**
+ * Cache function macros
+ * ---------------------
+ * Type-generic wrappers for the functions generated by GENERATE_CACHE.
+ *
+ * Usage:
+ *   cache(uint64_t, image_ptr) c;
+ *   cache_init(uint64_t, image_ptr, &c, 1024, free_image, NULL);   // at most 1024 images
+ *   image_ptr *img = cache_get(uint64_t, image_ptr, &c, id);      // NULL on a miss
+ *   if (!img)
+ *      cache_put(uint64_t, image_ptr, &c, id, decode(id));       // may evict via free_image
+ *
+ *   image_ptr *held = cache_pin(uint64_t, image_ptr, &c, id);     // not evicted until unpinned
+ *   draw(*held);
+ *   cache_unpin(uint64_t, image_ptr, &c, id);
+ *
+ *   cache_delete(uint64_t, image_ptr, &c);                        // free_image on every entry
+ */
+#define cache_init(key_type, value_type, cache, capacity, evict, ctx) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_init((cache), (capacity), (evict), (ctx)) \
+   )
+
+#define cache_clear(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_clear((cache)) \
+   )
+
+#define cache_delete(key_type, value_type, cache) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_delete((cache)) \
+   )
+
+#define cache_contains(key_type, value_type, cache, key) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_contains((cache), (key)) \
+   )
+
+#define cache_get(key_type, value_type, cache, key) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_get((cache), (key)) \
+   )
+
+#define cache_put(key_type, value_type, cache, key, value) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_put((cache), (key), (value)) \
+   )
+
+#define cache_pin(key_type, value_type, cache, key) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_pin((cache), (key)) \
+   )
+
+#define cache_unpin(key_type, value_type, cache, key) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_unpin((cache), (key)) \
+   )
+
+#define cache_remove(key_type, value_type, cache, key) \
+   typecheck_cache_ptr(cache, key_type, value_type, \
+      key_type##_##value_type##_cache_remove((cache), (key)) \
+   )
+
+
+#endif /* __CACHE_H */
@@ -0,0 +1,235 @@
+#ifndef __COMPACT_H
+#define __COMPACT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/**
+ * Compaction kernels
+ * ------------------
+ * In-place, order-preserving removal of every element equal to `value`
+ * from a contiguous array of 1, 2, 4 or 8 byte elements (bitwise equality).
+ *
+ * Functions:
+ *   compact_remove_<bits>(values, n, value)  - returns the number kept;
+ *                                              survivors are in values[0..kept)
+ *   compact_remove(values, n, width, value)  - dispatch on element width
+ *
+ * Behavior:
+ *   - AVX-512F: compare to a mask, then compress-store the kept lanes
+ *     (4 and 8 byte elements).
+ *   - AVX2: compare + movemask, then permute the kept lanes to the bottom of
+ *     the register with a lookup table and store the whole register
+ *     (4 and 8 byte elements).
+ *   - Otherwise: branchless scalar loop (always write, advance on keep).
+ *
+ * Notes:
+ *   The write cursor never passes the read cursor, and full-register
+ *   stores only touch lanes already loaded, so compaction is safe in place.
+ */
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+   #include <immintrin.h>
+#endif
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+   /* nibble j = source lane of result lane j, indexed by the 8-bit keep mask */
+   static const uint32_t compact_permute_32[256] =
+   {
+      0x00000000, 0x00000000, 0x00000001, 0x00000010, 0x00000002, 0x00000020, 0x00000021, 0x00000210,
+      0x00000003, 0x00000030, 0x00000031, 0x00000310, 0x00000032, 0x00000320, 0x00000321, 0x00003210,
+      0x00000004, 0x00000040, 0x00000041, 0x00000410, 0x00000042, 0x00000420, 0x00000421, 0x00004210,
+      0x00000043, 0x00000430, 0x00000431, 0x00004310, 0x00000432, 0x00004320, 0x00004321, 0x00043210,
+      0x00000005, 0x00000050, 0x00000051, 0x00000510, 0x00000052, 0x00000520, 0x00000521, 0x00005210,
+      0x00000053, 0x00000530, 0x00000531, 0x00005310, 0x00000532, 0x00005320, 0x00005321, 0x00053210,
+      0x00000054, 0x00000540, 0x00000541, 0x00005410, 0x00000542, 0x00005420, 0x00005421, 0x00054210,
+      0x00000543, 0x00005430, 0x00005431, 0x00054310, 0x00005432, 0x00054320, 0x00054321, 0x00543210,
+      0x00000006, 0x00000060, 0x00000061, 0x00000610, 0x00000062, 0x00000620, 0x00000621, 0x00006210,
+      0x00000063, 0x00000630, 0x00000631, 0x00006310, 0x00000632, 0x00006320, 0x00006321, 0x00063210,
+      0x00000064, 0x00000640, 0x00000641, 0x00006410, 0x00000642, 0x00006420, 0x00006421, 0x00064210,
+      0x00000643, 0x00006430, 0x00006431, 0x00064310, 0x00006432, 0x00064320, 0x00064321, 0x00643210,
+      0x00000065, 0x00000650, 0x00000651, 0x00006510, 0x00000652, 0x00006520, 0x00006521, 0x00065210,
+      0x00000653, 0x00006530, 0x00006531, 0x00065310, 0x00006532, 0x00065320, 0x00065321, 0x00653210,
+      0x00000654, 0x00006540, 0x00006541, 0x00065410, 0x00006542, 0x00065420, 0x00065421, 0x00654210,
+      0x00006543, 0x00065430, 0x00065431, 0x00654310, 0x00065432, 0x00654320, 0x00654321, 0x06543210,
+      0x00000007, 0x00000070, 0x00000071, 0x00000710, 0x00000072, 0x00000720, 0x00000721, 0x00007210,
+      0x00000073, 0x00000730, 0x00000731, 0x00007310, 0x00000732, 0x00007320, 0x00007321, 0x00073210,
+      0x00000074, 0x00000740, 0x00000741, 0x00007410, 0x00000742, 0x00007420, 0x00007421, 0x00074210,
+      0x00000743, 0x00007430, 0x00007431, 0x00074310, 0x00007432, 0x00074320, 0x00074321, 0x00743210,
+      0x00000075, 0x00000750, 0x00000751, 0x00007510, 0x00000752, 0x00007520, 0x00007521, 0x00075210,
+      0x00000753, 0x00007530, 0x00007531, 0x00075310, 0x00007532, 0x00075320, 0x00075321, 0x00753210,
+      0x00000754, 0x00007540, 0x00007541, 0x00075410, 0x00007542, 0x00075420, 0x00075421, 0x00754210,
+      0x00007543, 0x00075430, 0x00075431, 0x00754310, 0x00075432, 0x00754320, 0x00754321, 0x07543210,
+      0x00000076, 0x00000760, 0x00000761, 0x00007610, 0x00000762, 0x00007620, 0x00007621, 0x00076210,
+      0x00000763, 0x00007630, 0x00007631, 0x00076310, 0x00007632, 0x00076320, 0x00076321, 0x00763210,
+      0x00000764, 0x00007640, 0x00007641, 0x00076410, 0x00007642, 0x00076420, 0x00076421, 0x00764210,
+      0x00007643, 0x00076430, 0x00076431, 0x00764310, 0x00076432, 0x00764320, 0x00764321, 0x07643210,
+      0x00000765, 0x00007650, 0x00007651, 0x00076510, 0x00007652, 0x00076520, 0x00076521, 0x00765210,
+      0x00007653, 0x00076530, 0x00076531, 0x00765310, 0x00076532, 0x00765320, 0x00765321, 0x07653210,
+      0x00007654, 0x00076540, 0x00076541, 0x00765410, 0x00076542, 0x00765420, 0x00765421, 0x07654210,
+      0x00076543, 0x00765430, 0x00765431, 0x07654310, 0x00765432, 0x07654320, 0x07654321, 0x76543210
+   };
+
+   /* same for 4 x 64-bit lanes, expressed as pairs of 32-bit lanes */
+   static const uint32_t compact_permute_64[16] =
+   {
+      0x00000000, 0x00000010, 0x00000032, 0x00003210, 0x00000054, 0x00005410, 0x00005432, 0x00543210,
+      0x00000076, 0x00007610, 0x00007632, 0x00763210, 0x00007654, 0x00765410, 0x00765432, 0x76543210
+   };
+
+   static inline __m256i compact_permute_indices(const uint32_t packed)
+   {
+      const __m256i shifts = _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28);
+      return _mm256_and_si256(_mm256_srlv_epi32(_mm256_set1_epi32((int)packed), shifts), _mm256_set1_epi32(0xF));
+   }
+#endif
+
+
+#define COMPACT_SCALAR_LOOP(bits, bytes, n, value, i, kept) \
+   for (; i < n; i++) \
+   { \
+      uint##bits##_t x; \
+      memcpy(&x, bytes + i * sizeof(x), sizeof(x)); \
+      memcpy(bytes + kept * sizeof(x), &x, sizeof(x)); \
+      kept += (x != value); \
+   }
+
+static inline size_t compact_remove_8(void *const restrict values, const size_t n, const uint8_t value)
+{
+   unsigned char *const bytes = (unsigned char*)values;
+   size_t i = 0, kept = 0;
+   COMPACT_SCALAR_LOOP(8, bytes, n, value, i, kept)
+   return kept;
+}
+
+static inline size_t compact_remove_16(void *const restrict values, const size_t n, const uint16_t value)
+{
+   unsigned char *const bytes = (unsigned char*)values;
+   size_t i = 0, kept = 0;
+   COMPACT_SCALAR_LOOP(16, bytes, n, value, i, kept)
+   return kept;
+}
+
+static inline size_t compact_remove_32(void *const restrict values, const size_t n, const uint32_t value)
+{
+   unsigned char *const bytes = (unsigned char*)values;
+   size_t i = 0, kept = 0;
+
+#if defined(__AVX512F__)
+   const __m512i needle = _mm512_set1_epi32((int)value);
+   for (; i + 16 <= n; i += 16)
+   {
+      const __m512i v = _mm512_loadu_si512(bytes + i * 4);
+      const __mmask16 keep = _mm512_cmpneq_epi32_mask(v, needle);
+      _mm512_mask_compressstoreu_epi32(bytes + kept * 4, keep, v);
+      kept += (size_t)__builtin_popcount(keep);
+   }
+#elif defined(__AVX2__)
+   const __m256i needle = _mm256_set1_epi32((int)value);
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m256i v = _mm256_loadu_si256((const __m256i*)(bytes + i * 4));
+      const uint32_t keep = ~(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, needle))) & 0xFF;
+      const __m256i packed = _mm256_permutevar8x32_epi32(v, compact_permute_indices(compact_permute_32[keep]));
+      _mm256_storeu_si256((__m256i*)(bytes + kept * 4), packed);
+      kept += (size_t)__builtin_popcount(keep);
+   }
+#endif
+
+   COMPACT_SCALAR_LOOP(32, bytes, n, value, i, kept)
+   return kept;
+}
+
+static inline size_t compact_remove_64(void *const restrict values, const size_t n, const uint64_t value)
+{
+   unsigned char *const bytes = (unsigned char*)values;
+   size_t i = 0, kept = 0;
+
+#if defined(__AVX512F__)
+   const __m512i needle = _mm512_set1_epi64((long long)value);
+   for (; i + 8 <= n; i += 8)
+   {
+      const __m512i v = _mm512_loadu_si512(bytes + i * 8);
+      const __mmask8 keep = _mm512_cmpneq_epi64_mask(v, needle);
+      _mm512_mask_compressstoreu_epi64(bytes + kept * 8, keep, v);
+      kept += (size_t)__builtin_popcount(keep);
+   }
+#elif defined(__AVX2__)
+   const __m256i needle = _mm256_set1_epi64x((long long)value);
+   for (; i + 4 <= n; i += 4)
+   {
+      const __m256i v = _mm256_loadu_si256((const __m256i*)(bytes + i * 8));
+      const uint32_t keep = ~(uint32_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, needle))) & 0xF;
+      const __m256i packed = _mm256_permutevar8x32_epi32(v, compact_permute_indices(compact_permute_64[keep]));
+      _mm256_storeu_si256((__m256i*)(bytes + kept * 8), packed);
+      kept += (size_t)__builtin_popcount(keep);
+   }
+#endif
+
+   COMPACT_SCALAR_LOOP(64, bytes, n, value, i, kept)
+   return kept;
+}
+
+static inline size_t compact_remove(void *const restrict values, const size_t n, const size_t width, const void *const restrict value)
+{
+   switch (width)
+   {
+      case 1: { uint8_t v; memcpy(&v, value, 1); return compact_remove_8(values, n, v); }
+      case 2: { uint16_t v; memcpy(&v, value, 2); return compact_remove_16(values, n, v); }
+      case 4: { uint32_t v; memcpy(&v, value, 4); return compact_remove_32(values, n, v); }
+      case 8: { uint64_t v; memcpy(&v, value, 8); return compact_remove_64(values, n, v); }
+   }
+   assert(false && "compact_remove: unsupported width");
+   return n;
+}
+
+
+/**
+ * COMPACT_GENERATE_ARRAY macro
+ * ----------------------------
+ * Generates the predicate compaction kernel used by the container
+ * remove_if / retain_if / remove_value functions.
+ *
+ * Parameters:
+ *   prefix - Name prefix (e.g. int_stack)
+ *   type   - Element type
+ *
+ * Output:
+ *   static inline size_t prefix##_compact_array(values, n, pred, ctx, remove)
+ *      Keeps values[i] when pred(&values[i], ctx) != remove, in order,
+ *      in place; returns the number kept.
+ *   static inline size_t prefix##_compact_equal_array(values, n, value, equal)
+ *      Removes every element for which equal(element, value); returns the
+ *      number kept.
+ */
+#define COMPACT_GENERATE_ARRAY(prefix, type) \
+static inline size_t prefix##_compact_array(type *const restrict values, const size_t n, bool (*const pred)(const type*, void*), void *const ctx, const bool remove) \
+{ \
+   size_t kept = 0; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      const bool keep = (pred(&values[i], ctx) != remove); \
+      values[kept] = values[i]; \
+      kept += keep; \
+   } \
+   return kept; \
+} \
+\
+static inline size_t prefix##_compact_equal_array(type *const restrict values, const size_t n, const type value, bool (*const equal)(type, type)) \
+{ \
+   size_t kept = 0; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      const bool keep = !equal(values[i], value); \
+      values[kept] = values[i]; \
+      kept += keep; \
+   } \
+   return kept; \
+}
+
+
+#endif /* __COMPACT_H */
\ No newline at end of file
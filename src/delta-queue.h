@@ -0,0 +1,613 @@
+#ifndef __DELTA_QUEUE_H
+#define __DELTA_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+
+
+/**
+ * Delta queue
+ * -----------
+ * FIFO queue of unsigned integers stored as compressed deltas: each value
+ * is encoded as its difference from the previous one, four differences per
+ * group-varint group:
+ *
+ *   [tag][d0][d1][d2][d3]     tag bits 2k..2k+1 = c, dk takes 1 << c bytes
+ *
+ * so a group of small deltas (increasing IDs, timestamps, offsets) takes
+ * 5 bytes instead of 32. Differences wrap modulo 2^bits, so any sequence
+ * round-trips; a decreasing step just costs 8 bytes.
+ *
+ * The groups live in a byte ring. A group never straddles the end of the
+ * ring: writer and reader both restart at byte 0 when fewer than
+ * DELTA_QUEUE_GROUP_MAX bytes are left, so every group can be read with
+ * full-width loads. The last < 4 values enqueued wait uncompressed in
+ * `tail`; the rest of a partly consumed group waits decoded in `head`.
+ */
+#define DELTA_QUEUE_GROUP 4
+
+/* tag + four 8-byte deltas */
+#define DELTA_QUEUE_GROUP_MAX (1 + DELTA_QUEUE_GROUP * 8)
+
+/* 1 if `type` is uint64_t, so deque_n can decode into the caller's array (C99: always 0) */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)  /* C11+ */
+   #define DELTA_QUEUE_IS_UINT64(type) _Generic((type){0}, uint64_t: 1, default: 0)
+#else /* C99 fallback */
+   #define DELTA_QUEUE_IS_UINT64(type) 0
+#endif
+
+
+/**
+ * Group codec
+ * -----------
+ * delta_queue_encode_group(dst, deltas)      - writes one group, returns its bytes
+ * delta_queue_decode_group(src, base, out)   - out[k] = base + d0 + .. + dk,
+ *                                              returns the group's bytes
+ * delta_queue_decode_groups(&src, end, groups, &base, out)
+ *                                            - consecutive groups starting
+ *                                              before end, 4 values each;
+ *                                              returns how many
+ *
+ * Behavior:
+ *   - Bytes are little-endian. Decoding reads DELTA_QUEUE_GROUP_MAX bytes
+ *     from src whatever the group's size, and masks the excess.
+ *   - SSSE3 (and AVX2 builds): when the four deltas total at most 16 bytes,
+ *     one load and two byte shuffles place them in 64-bit lanes and two
+ *     vector adds apply the prefix sum. The shuffle for each pair of deltas
+ *     comes from delta_queue_pair_shuffle, indexed by 4 bits of the tag.
+ *     The running value stays in a vector register from group to group.
+ *   - Otherwise: one masked 8-byte load per delta.
+ */
+#define DELTA_QUEUE_LEN(code) (1 << (code))
+
+#define DELTA_QUEUE_SHUFFLE_BYTE(pair, j) \
+   ((j) < 8 ? ((j) < DELTA_QUEUE_LEN((pair) & 3) ? (j) : 0x80) \
+            : ((j) - 8 < DELTA_QUEUE_LEN((pair) >> 2) ? DELTA_QUEUE_LEN((pair) & 3) + (j) - 8 : 0x80))
+
+#define DELTA_QUEUE_SHUFFLE(pair) \
+   { DELTA_QUEUE_SHUFFLE_BYTE(pair, 0), DELTA_QUEUE_SHUFFLE_BYTE(pair, 1), DELTA_QUEUE_SHUFFLE_BYTE(pair, 2), DELTA_QUEUE_SHUFFLE_BYTE(pair, 3), \
+     DELTA_QUEUE_SHUFFLE_BYTE(pair, 4), DELTA_QUEUE_SHUFFLE_BYTE(pair, 5), DELTA_QUEUE_SHUFFLE_BYTE(pair, 6), DELTA_QUEUE_SHUFFLE_BYTE(pair, 7), \
+     DELTA_QUEUE_SHUFFLE_BYTE(pair, 8), DELTA_QUEUE_SHUFFLE_BYTE(pair, 9), DELTA_QUEUE_SHUFFLE_BYTE(pair, 10), DELTA_QUEUE_SHUFFLE_BYTE(pair, 11), \
+     DELTA_QUEUE_SHUFFLE_BYTE(pair, 12), DELTA_QUEUE_SHUFFLE_BYTE(pair, 13), DELTA_QUEUE_SHUFFLE_BYTE(pair, 14), DELTA_QUEUE_SHUFFLE_BYTE(pair, 15) }
+
+#if defined(__SSSE3__)
+   #include <tmmintrin.h>
+
+/* byte shuffle moving two deltas (codes pair & 3, pair >> 2) into 64-bit lanes */
+static const uint8_t delta_queue_pair_shuffle[16][16] =
+{
+   DELTA_QUEUE_SHUFFLE(0), DELTA_QUEUE_SHUFFLE(1), DELTA_QUEUE_SHUFFLE(2), DELTA_QUEUE_SHUFFLE(3),
+   DELTA_QUEUE_SHUFFLE(4), DELTA_QUEUE_SHUFFLE(5), DELTA_QUEUE_SHUFFLE(6), DELTA_QUEUE_SHUFFLE(7),
+   DELTA_QUEUE_SHUFFLE(8), DELTA_QUEUE_SHUFFLE(9), DELTA_QUEUE_SHUFFLE(10), DELTA_QUEUE_SHUFFLE(11),
+   DELTA_QUEUE_SHUFFLE(12), DELTA_QUEUE_SHUFFLE(13), DELTA_QUEUE_SHUFFLE(14), DELTA_QUEUE_SHUFFLE(15),
+};
+#endif
+
+/* bytes of the two deltas selected by 4 bits of the tag */
+#define DELTA_QUEUE_PAIR_BYTES(pair) (DELTA_QUEUE_LEN((pair) & 3) + DELTA_QUEUE_LEN((pair) >> 2))
+
+static inline size_t delta_queue_encode_group(uint8_t *const restrict dst, const uint64_t deltas[DELTA_QUEUE_GROUP])
+{
+   uint8_t buffer[DELTA_QUEUE_GROUP_MAX + 8];
+   uint8_t tag = 0;
+   size_t at = 1;
+   for (unsigned k = 0; k < DELTA_QUEUE_GROUP; k++)
+   {
+      const uint64_t d = deltas[k];
+      const unsigned code = (d >> 8 != 0) + (d >> 16 != 0) + (d >> 32 != 0);
+      tag |= (uint8_t)(code << (2 * k));
+      memcpy(&buffer[at], &d, sizeof(d));   /* little-endian: the low bytes first */
+      at += DELTA_QUEUE_LEN(code);
+   }
+   buffer[0] = tag;
+   MEMORY_COPY(dst, buffer, at);
+   return at;
+}
+
+/* one group without SIMD: returns its bytes, *base = its last value */
+static inline size_t delta_queue_decode_group_scalar(const uint8_t *const restrict src, uint64_t *const restrict base, uint64_t out[DELTA_QUEUE_GROUP])
+{
+   static const uint64_t mask[4] = { 0xFFull, 0xFFFFull, 0xFFFFFFFFull, ~0ull };
+   const unsigned tag = src[0];
+   const uint8_t *at = src + 1;
+   uint64_t value = *base;
+   for (unsigned k = 0; k < DELTA_QUEUE_GROUP; k++)
+   {
+      const unsigned code = (tag >> (2 * k)) & 3;
+      uint64_t d;
+      memcpy(&d, at, sizeof(d));
+      value += d & mask[code];
+      out[k] = value;
+      at += DELTA_QUEUE_LEN(code);
+   }
+   *base = value;
+   return (size_t)(at - src);
+}
+
+/* groups starting before `end`, at most `groups` of them: returns how many, advances *src */
+static inline size_t delta_queue_decode_groups(const uint8_t **const restrict src, const uint8_t *const end, const size_t groups,
+                                               uint64_t *const restrict base, uint64_t *restrict out)
+{
+   const uint8_t *at = *src;
+   size_t done = 0;
+#if defined(__SSSE3__)
+   __m128i carry = _mm_set1_epi64x((long long)*base);   /* previous value in both lanes */
+   for (; done < groups && at < end; done++, out += DELTA_QUEUE_GROUP)
+   {
+      const unsigned tag = at[0];
+      const unsigned low_bytes = DELTA_QUEUE_PAIR_BYTES(tag & 15);
+      const unsigned bytes = 1 + low_bytes + DELTA_QUEUE_PAIR_BYTES(tag >> 4);
+      if (bytes <= 17)
+      {
+         const __m128i data = _mm_loadu_si128((const __m128i*)(at + 1));
+         const __m128i high_shuffle = _mm_add_epi8(_mm_loadu_si128((const __m128i*)delta_queue_pair_shuffle[tag >> 4]),
+                                                   _mm_set1_epi8((char)low_bytes));
+         __m128i low = _mm_shuffle_epi8(data, _mm_loadu_si128((const __m128i*)delta_queue_pair_shuffle[tag & 15]));
+         __m128i high = _mm_shuffle_epi8(data, high_shuffle);
+         low = _mm_add_epi64(low, _mm_slli_si128(low, 8));      /* d0, d0 + d1 */
+         high = _mm_add_epi64(high, _mm_slli_si128(high, 8));   /* d2, d2 + d3 */
+         low = _mm_add_epi64(low, carry);
+         high = _mm_add_epi64(high, _mm_unpackhi_epi64(low, low));
+         carry = _mm_unpackhi_epi64(high, high);
+         _mm_storeu_si128((__m128i*)out, low);
+         _mm_storeu_si128((__m128i*)(out + 2), high);
+         at += bytes;
+      }
+      else
+      {
+         uint64_t value = (uint64_t)_mm_cvtsi128_si64(carry);
+         at += delta_queue_decode_group_scalar(at, &value, out);
+         carry = _mm_set1_epi64x((long long)value);
+      }
+   }
+   *base = (uint64_t)_mm_cvtsi128_si64(carry);
+#else
+   for (; done < groups && at < end; done++, out += DELTA_QUEUE_GROUP)
+      at += delta_queue_decode_group_scalar(at, base, out);
+#endif
+   *src = at;
+   return done;
+}
+
+static inline size_t delta_queue_decode_group(const uint8_t *const restrict src, const uint64_t base, uint64_t out[DELTA_QUEUE_GROUP])
+{
+   const uint8_t *at = src;
+   uint64_t last = base;
+   delta_queue_decode_groups(&at, src + 1, 1, &last, out);
+   return (size_t)(at - src);
+}
+
+
+/**
+ * DEFINE_DELTA_QUEUE macro
+ * ------------------------
+ * Defines a delta-compressed queue of unsigned integers.
+ *
+ * Parameters:
+ *   type      - Unsigned integer type of the values (uint32_t, uint64_t, ...)
+ *   len_type  - Unsigned integer type used for value counts and byte offsets
+ *   init_size - Bytes of the inline ring: a power of 2, at least
+ *               2 * DELTA_QUEUE_GROUP_MAX
+ *
+ * Output:
+ *   Declaration of delta queue for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_DELTA_QUEUE(...), Ensure macro arguments match
+ */
+#define DEFINE_DELTA_QUEUE(type, len_type, init_size) \
+   static_assert((type)-1 > (type)0, "Warning: type must be an unsigned integer"); \
+   static_assert(sizeof(type) <= sizeof(uint64_t), "Warning: type wider than 64 bits"); \
+   static_assert(init_size >= 2 * DELTA_QUEUE_GROUP_MAX, "Warning: init_size too small"); \
+   static_assert(init_size <= 4096, "Warning: init_size too big"); \
+   static_assert(init_size != 0 && (init_size & (init_size - 1)) == 0, "Warning: init_size must be a power of 2"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   uint8_t inline_buffer[init_size]; \
+   uint8_t *bytes; \
+   len_type size;  /* bytes of the ring */ \
+   len_type front; /* next group to decode */ \
+   len_type back;  /* where the next group goes */ \
+   len_type used;  /* bytes from front to back, skipped end included */ \
+   len_type gap;   /* bytes skipped at the end of the ring by the last wrap */ \
+   len_type len;   /* values */ \
+   type last;      /* last value encoded into the ring */ \
+   type base;      /* last value decoded out of the ring */ \
+   type head[DELTA_QUEUE_GROUP]; /* decoded, not yet dequeued: head[head_at ..] */ \
+   type tail[DELTA_QUEUE_GROUP]; /* enqueued, not yet encoded: tail[.. tail_len) */ \
+   uint8_t head_at; \
+   uint8_t head_len; \
+   uint8_t tail_len; \
+} type##_delta_queue_s; \
+\
+/* drops every value, keeps the ring */ \
+static inline void type##_delta_queue_clear(type##_delta_queue_s *const restrict queue) \
+{ \
+   queue->front = queue->back = queue->used = queue->gap = 0; \
+   queue->len = 0; \
+   queue->last = queue->base = 0; \
+   queue->head_at = queue->head_len = queue->tail_len = 0; \
+} \
+\
+static inline void type##_delta_queue_init(type##_delta_queue_s *const restrict queue) \
+{ \
+   queue->bytes = queue->inline_buffer; \
+   queue->size = init_size; \
+   type##_delta_queue_clear(queue); \
+} \
+\
+bool type##_delta_queue_resize(type##_delta_queue_s *const restrict); \
+void type##_delta_queue_delete(type##_delta_queue_s *const restrict); \
+bool type##_delta_queue_enque(type##_delta_queue_s *const restrict, const type); \
+type type##_delta_queue_peek(type##_delta_queue_s *const restrict); \
+bool type##_delta_queue_deque(type##_delta_queue_s *const restrict); \
+len_type type##_delta_queue_deque_n(type##_delta_queue_s *const restrict, type *const restrict, len_type);
+
+
+/**
+ * delta_queue(type) macro
+ * -----------------------
+ * Declares a delta queue of the given type.
+ *
+ * Usage (as variable):
+ *   delta_queue(uint64_t) ids;
+ *
+ * Usage (as parameter):
+ *   void drain(delta_queue(uint64_t) *const ids) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (type##_delta_queue_s).
+ */
+#define delta_queue(type) \
+   type##_delta_queue_s
+
+
+/**
+ * typecheck_delta_queue_ptr macro
+ * -------------------------------
+ * Compile-time validation that 'var' is a pointer to a delta queue of
+ * 'type' (see typecheck_ptr).
+ */
+#define typecheck_delta_queue_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_delta_queue_s, expr)
+
+
+/**
+ * Delta Queue Expression Macros
+ * -----------------------------
+ * Direct access to queue properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ *
+ *   delta_queue_bytes(type, queue)  - bytes of the ring
+ *   delta_queue_used(type, queue)   - bytes of the ring holding groups
+ */
+#define delta_queue_len(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      (queue)->len \
+   )
+
+#define delta_queue_empty(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      (queue)->len == 0 \
+   )
+
+#define delta_queue_bytes(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      (queue)->size \
+   )
+
+#define delta_queue_used(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      (queue)->used \
+   )
+
+
+/**
+ * GENERATE_DELTA_QUEUE macro
+ * --------------------------
+ * Implements the delta queue functions for a type.
+ *
+ * Parameters:
+ *   type           - Unsigned integer type of the values
+ *   len_type       - Unsigned integer type for counts & byte offsets
+ *   init_size      - Inline ring size in bytes (initial size)
+ *   growth_factor  - Multiplier for resizing
+ *
+ * Behavior:
+ *   - enque: appends to `tail`; every 4th value encodes the group of deltas
+ *     into the ring, growing it if the group does not fit.
+ *   - deque_n(out, n): moves up to n values to out[0 ..] and returns how
+ *     many. For uint64_t, whole groups are decoded straight into `out`;
+ *     narrower types are decoded 16 groups at a time into a stack buffer
+ *     and narrowed. Only a group split by n goes through `head`.
+ *   - peek: the front value; decodes the next group into `head` when
+ *     needed, so it takes a non-const queue.
+ *   - resize: copies the ring's groups, in order and without the skipped
+ *     end, to the start of a growth_factor times larger block.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_DELTA_QUEUE(...), Ensure macro arguments match
+ */
+#define GENERATE_DELTA_QUEUE(type, len_type, init_size, growth_factor, alloc_fn, free_fn) \
+   static_assert(growth_factor > 1, "Warning: growth_factor too small"); \
+   static_assert(growth_factor < 32,  "Warning: growth_factor too big"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_delta_queue_resize(type##_delta_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (queue->size > (len_type)(-1) / growth_factor) /* Prevent overflow */ \
+      return false; \
+   const len_type new_size = queue->size * growth_factor; \
+   uint8_t *const tmp = (uint8_t*)alloc_fn(new_size); \
+   if (!tmp) \
+      return false; \
+\
+   len_type used = queue->used; \
+   if (used > queue->size - queue->front) /* wrapped: [front, size - gap) then [0, back) */ \
+   { \
+      const len_type first = queue->size - queue->gap - queue->front; \
+      MEMORY_COPY(tmp, queue->bytes + queue->front, first); \
+      MEMORY_COPY(tmp + first, queue->bytes, queue->back); \
+      used = first + queue->back; \
+   } \
+   else \
+      MEMORY_COPY(tmp, queue->bytes + queue->front, used); \
+\
+   if (queue->bytes != queue->inline_buffer) \
+      free_fn(queue->bytes); \
+   queue->bytes = tmp; \
+   queue->size = new_size; \
+   queue->front = 0; \
+   queue->back = used; \
+   queue->used = used; \
+   queue->gap = 0; \
+   return true; \
+} \
+\
+void type##_delta_queue_delete(type##_delta_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (queue->bytes != queue->inline_buffer) \
+      free_fn(queue->bytes); \
+   type##_delta_queue_init(queue); \
+} \
+\
+/* encodes tail[0 .. 4) into the ring */ \
+static bool type##_delta_queue_push_group(type##_delta_queue_s *const restrict queue) \
+{ \
+   uint64_t deltas[DELTA_QUEUE_GROUP]; \
+   type previous = queue->last; \
+   for (unsigned k = 0; k < DELTA_QUEUE_GROUP; k++) \
+   { \
+      deltas[k] = (type)(queue->tail[k] - previous); \
+      previous = queue->tail[k]; \
+   } \
+\
+   uint8_t group[DELTA_QUEUE_GROUP_MAX]; \
+   const len_type bytes = (len_type)delta_queue_encode_group(group, deltas); \
+   for (;;) \
+   { \
+      /* restart at 0 when a whole group might not fit before the end */ \
+      const bool wrap = queue->size - queue->back < DELTA_QUEUE_GROUP_MAX; \
+      const len_type skip = wrap ? queue->size - queue->back : 0; \
+      if (queue->used + skip + bytes <= queue->size) \
+      { \
+         if (wrap) \
+         { \
+            queue->gap = skip; \
+            queue->back = 0; \
+            queue->used += skip; \
+         } \
+         MEMORY_COPY(queue->bytes + queue->back, group, bytes); \
+         queue->back += bytes; \
+         queue->used += bytes; \
+         queue->last = previous; \
+         return true; \
+      } \
+      if (!type##_delta_queue_resize(queue)) \
+         return false; \
+   } \
+} \
+\
+/* decodes up to `groups` groups from the front into out, 4 values each; returns how many */ \
+static len_type type##_delta_queue_pop_groups(type##_delta_queue_s *const restrict queue, type *restrict out, const len_type groups) \
+{ \
+   assert(queue->used != 0 && groups != 0); \
+   if (queue->size - queue->front < DELTA_QUEUE_GROUP_MAX) \
+   { \
+      queue->used -= queue->size - queue->front; \
+      queue->front = 0; \
+      queue->gap = 0; \
+   } \
+   /* groups are contiguous up to back, or up to the skipped end if the ring wraps */ \
+   const len_type end = (queue->used <= queue->size - queue->front) ? queue->front + queue->used : queue->size - queue->gap; \
+   const uint8_t *at = queue->bytes + queue->front; \
+   uint64_t base = queue->base; \
+   len_type done = 0; \
+   if (DELTA_QUEUE_IS_UINT64(type)) /* out already holds uint64_t: decode in place */ \
+      done = (len_type)delta_queue_decode_groups(&at, queue->bytes + end, groups, &base, (uint64_t*)out); \
+   else \
+   { \
+      uint64_t values[16 * DELTA_QUEUE_GROUP]; \
+      while (done < groups) \
+      { \
+         const size_t chunk = (groups - done < 16) ? (size_t)(groups - done) : 16; \
+         const size_t got = delta_queue_decode_groups(&at, queue->bytes + end, chunk, &base, values); \
+         for (size_t k = 0; k < got * DELTA_QUEUE_GROUP; k++) \
+            out[k] = (type)values[k]; \
+         out += got * DELTA_QUEUE_GROUP; \
+         done += (len_type)got; \
+         if (got < chunk) \
+            break; \
+      } \
+   } \
+   const len_type bytes = (len_type)(at - (queue->bytes + queue->front)); \
+   queue->base = (type)base; \
+   queue->front += bytes; \
+   queue->used -= bytes; \
+   if (queue->used == 0) /* empty ring: start over at byte 0 */ \
+      queue->front = queue->back = queue->gap = 0; \
+   return done; \
+} \
+\
+bool type##_delta_queue_enque(type##_delta_queue_s *const restrict queue, const type value) \
+{ \
+   assert(queue); \
+   if (queue->len == (len_type)(-1)) \
+      return false; \
+   queue->tail[queue->tail_len++] = value; \
+   if (queue->tail_len == DELTA_QUEUE_GROUP) \
+   { \
+      if (!type##_delta_queue_push_group(queue)) \
+      { \
+         queue->tail_len--; \
+         return false; \
+      } \
+      queue->tail_len = 0; \
+   } \
+   queue->len++; \
+   return true; \
+} \
+\
+type type##_delta_queue_peek(type##_delta_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   assert(queue->len != 0); \
+   if (queue->head_len == 0 && queue->used != 0) \
+   { \
+      type##_delta_queue_pop_groups(queue, queue->head, 1); \
+      queue->head_at = 0; \
+      queue->head_len = DELTA_QUEUE_GROUP; \
+   } \
+   return queue->head_len ? queue->head[queue->head_at] : queue->tail[0]; \
+} \
+\
+len_type type##_delta_queue_deque_n(type##_delta_queue_s *const restrict queue, type *const restrict out, len_type n) \
+{ \
+   assert(queue); \
+   assert(out || n == 0); \
+   if (n > queue->len) \
+      n = queue->len; \
+   len_type done = 0; \
+\
+   /* rest of a split group */ \
+   while (done < n && queue->head_len) \
+   { \
+      out[done++] = queue->head[queue->head_at++]; \
+      queue->head_len--; \
+   } \
+\
+   /* whole groups */ \
+   while (n - done >= DELTA_QUEUE_GROUP && queue->used != 0) \
+      done += DELTA_QUEUE_GROUP * type##_delta_queue_pop_groups(queue, out + done, (n - done) / DELTA_QUEUE_GROUP); \
+\
+   /* split group */ \
+   if (done < n && queue->used != 0) \
+   { \
+      type##_delta_queue_pop_groups(queue, queue->head, 1); \
+      queue->head_at = 0; \
+      queue->head_len = DELTA_QUEUE_GROUP; \
+      while (done < n) \
+      { \
+         out[done++] = queue->head[queue->head_at++]; \
+         queue->head_len--; \
+      } \
+   } \
+\
+   /* values not yet encoded */ \
+   if (done < n) \
+   { \
+      const unsigned taken = (unsigned)(n - done); \
+      for (unsigned k = 0; k < taken; k++) \
+         out[done++] = queue->tail[k]; \
+      for (unsigned k = taken; k < queue->tail_len; k++) \
+         queue->tail[k - taken] = queue->tail[k]; \
+      queue->tail_len -= (uint8_t)taken; \
+   } \
+\
+   queue->len -= n; \
+   return n; \
+} \
+\
+bool type##_delta_queue_deque(type##_delta_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (queue->len == 0) \
+      return false; \
+   type value; \
+   type##_delta_queue_deque_n(queue, &value, 1); \
+   return true; \
+}
+
+
+/**
+ * Delta queue function macros
+ * ---------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_DELTA_QUEUE.
+ *
+ * Usage:
+ *   delta_queue(uint64_t) ids;
+ *   delta_queue_init(uint64_t, &ids);
+ *   delta_queue_enque(uint64_t, &ids, next_id);
+ *   uint64_t first = delta_queue_peek(uint64_t, &ids);
+ *
+ *   uint64_t batch[256];
+ *   uint32_t n = delta_queue_deque_n(uint64_t, &ids, batch, 256);   // up to 256, oldest first
+ *   delta_queue_delete(uint64_t, &ids);
+ */
+#define delta_queue_init(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_init((queue)) \
+   )
+
+#define delta_queue_clear(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_clear((queue)) \
+   )
+
+#define delta_queue_resize(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_resize((queue)) \
+   )
+
+#define delta_queue_delete(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_delete((queue)) \
+   )
+
+#define delta_queue_enque(type, queue, value) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_enque((queue), (value)) \
+   )
+
+#define delta_queue_peek(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_peek((queue)) \
+   )
+
+#define delta_queue_deque(type, queue) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_deque((queue)) \
+   )
+
+#define delta_queue_deque_n(type, queue, out, n) \
+   typecheck_delta_queue_ptr(queue, type, \
+      type##_delta_queue_deque_n((queue), (out), (n)) \
+   )
+
+
+#endif /* __DELTA_QUEUE_H */
@@ -6,6 +6,12 @@
 #include "static-assert.h"
 #include "swap.h"
 #include "memory-copy.h"
+#include "search.h"
+#include "reduce.h"
+#include "sort.h"
+#include "compact.h"
+#include "hash.h"
+#include "parallel.h"
 
 
 /**
@@ -69,7 +75,9 @@ void type##_deque_delete(type##_deque_s *const restrict); \
 bool type##_deque_insert_front(type##_deque_s *const restrict, const type); \
 bool type##_deque_insert_back(type##_deque_s *const restrict, const type); \
 bool type##_deque_remove_front(type##_deque_s *const restrict); \
-bool type##_deque_remove_back(type##_deque_s *const restrict);
+bool type##_deque_remove_back(type##_deque_s *const restrict); \
+void type##_deque_reverse(type##_deque_s *const restrict); \
+void type##_deque_rotate(type##_deque_s *const restrict, len_type);
 
 
 /**
@@ -223,13 +231,13 @@ bool type##_deque_resize(type##_deque_s *const restrict deque) \
 \
       if (not_wrapped) \
       { \
-         MEMORY_COPY(tmp, deque->values, sizeof(type) * deque->len); \
+         MEMORY_COPY_LARGE(tmp, deque->values, sizeof(type) * deque->len); \
       } \
       else \
       { \
          len_type first_chunk = deque->size - deque->front; \
-         MEMORY_COPY(tmp, &deque->values[deque->front], sizeof(type) * first_chunk); \
-         MEMORY_COPY((type*)tmp + first_chunk, deque->values, sizeof(type) * deque->front); \
+         MEMORY_COPY_LARGE(tmp, &deque->values[deque->front], sizeof(type) * first_chunk); \
+         MEMORY_COPY_LARGE((type*)tmp + first_chunk, deque->values, sizeof(type) * deque->front); \
       } \
 \
       if (in_heap) \
@@ -299,6 +307,80 @@ bool type##_deque_remove_back(type##_deque_s *const restrict deque) \
       return false; \
    deque->len--; \
    return true; \
+} \
+\
+void type##_deque_reverse(type##_deque_s *const restrict deque) \
+{ \
+   assert(deque); \
+   if (deque->len < 2) \
+      return; \
+\
+   /* mirrored pairs in runs that are contiguous at both ends */ \
+   const len_type mask = deque->size - 1; \
+   len_type left = deque->front; \
+   len_type right = ((deque->front + deque->len - 1) & mask) + 1; /* one past the back element */ \
+   for (len_type pairs = deque->len / 2; pairs > 0;) \
+   { \
+      len_type run = pairs; \
+      if (deque->size - left < run) \
+         run = deque->size - left; \
+      if (right < run) \
+         run = right; \
+      swap_ranges_reversed(&deque->values[left], &deque->values[right - run], run, sizeof(type)); \
+      left = (left + run) & mask; \
+      right = ((right - run + deque->size - 1) & mask) + 1; \
+      pairs -= run; \
+   } \
+} \
+\
+void type##_deque_rotate(type##_deque_s *const restrict deque, len_type k) \
+{ \
+   assert(deque); \
+   if (deque->len < 2) \
+      return; \
+\
+   const len_type mask = deque->size - 1; \
+   k %= deque->len; \
+   if (deque->len == deque->size) /* no gap: only the front moves */ \
+   { \
+      deque->front = (deque->front + k) & mask; \
+      return; \
+   } \
+\
+   /* move the shorter side across the gap, in runs contiguous at both ends */ \
+   if (k <= deque->len - k) \
+   { \
+      for (len_type i = 0; i < k;) \
+      { \
+         const len_type src = (deque->front + i) & mask; \
+         const len_type dst = (deque->front + deque->len + i) & mask; \
+         len_type run = k - i; \
+         if (deque->size - src < run) \
+            run = deque->size - src; \
+         if (deque->size - dst < run) \
+            run = deque->size - dst; \
+         MEMORY_MOVE(&deque->values[dst], &deque->values[src], sizeof(type) * run); \
+         i += run; \
+      } \
+      deque->front = (deque->front + k) & mask; \
+   } \
+   else \
+   { \
+      const len_type r = deque->len - k; \
+      for (len_type i = r; i > 0;) /* back to front, so no element is overwritten before it is moved */ \
+      { \
+         const len_type src_end = ((deque->front + k + i - 1) & mask) + 1; \
+         const len_type dst_end = ((deque->front + deque->size - r + i - 1) & mask) + 1; \
+         len_type run = i; \
+         if (src_end < run) \
+            run = src_end; \
+         if (dst_end < run) \
+            run = dst_end; \
+         MEMORY_MOVE(&deque->values[dst_end - run], &deque->values[src_end - run], sizeof(type) * run); \
+         i -= run; \
+      } \
+      deque->front = (deque->front + deque->size - r) & mask; \
+   } \
 }
 
 
@@ -364,5 +446,1003 @@ bool type##_deque_remove_back(type##_deque_s *const restrict deque) \
       type##_deque_remove_back((deque)) \
    )
 
+#define deque_reverse(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_reverse((deque)) \
+   )
+
+#define deque_rotate(type, deque, k) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_rotate((deque), (k)) \
+   )
+
+
+/**
+ * DEFINE_DEQUE_SEARCH macro
+ * -------------------------
+ * Declares find / count / contains for a deque type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the deque
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE(...)
+ *    Use in combination with GENERATE_DEQUE_SEARCH(...)
+ */
+#define DEFINE_DEQUE_SEARCH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+len_type type##_deque_find(const type##_deque_s *const restrict, const type); \
+len_type type##_deque_count(const type##_deque_s *const restrict, const type); \
+bool type##_deque_contains(const type##_deque_s *const restrict, const type);
+
+
+/**
+ * GENERATE_DEQUE_SEARCH macro
+ * ---------------------------
+ * Implements find / count / contains for a deque type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   equal_fn - bool (type, type) equality, used for non-integral types
+ *
+ * Behavior:
+ *   - Integral types: bitwise SIMD kernels from search.h, run over the
+ *     one or two contiguous segments of the ring (equal_fn unused).
+ *   - Other types: linear scan with equal_fn
+ *     (use DEFINE_BYTES_EQUAL(type) for memcmp on padding-free structs).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_DEQUE(...)
+ *    Use in combination with DEFINE_DEQUE_SEARCH(...)
+ */
+#define GENERATE_DEQUE_SEARCH(type, len_type, equal_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(equal_fn, bool (type, type)); \
+\
+len_type type##_deque_find(const type##_deque_s *const restrict deque, const type value) \
+{ \
+   assert(deque); \
+   const len_type mask = deque->size - 1; \
+   if (SEARCH_IS_INTEGRAL(type)) \
+   { \
+      const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+      const len_type index = (len_type)search_find(&deque->values[deque->front], first_chunk, sizeof(type), &value); \
+      if (index < first_chunk) \
+         return index; \
+      return first_chunk + (len_type)search_find(deque->values, deque->len - first_chunk, sizeof(type), &value); \
+   } \
+\
+   for (len_type i = 0; i < deque->len; i++) \
+      if (equal_fn(deque->values[(deque->front + i) & mask], value)) \
+         return i; \
+   return deque->len; \
+} \
+\
+len_type type##_deque_count(const type##_deque_s *const restrict deque, const type value) \
+{ \
+   assert(deque); \
+   const len_type mask = deque->size - 1; \
+   if (SEARCH_IS_INTEGRAL(type)) \
+   { \
+      const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+      return (len_type)(search_count(&deque->values[deque->front], first_chunk, sizeof(type), &value) \
+                      + search_count(deque->values, deque->len - first_chunk, sizeof(type), &value)); \
+   } \
+\
+   len_type count = 0; \
+   for (len_type i = 0; i < deque->len; i++) \
+      count += equal_fn(deque->values[(deque->front + i) & mask], value); \
+   return count; \
+} \
+\
+bool type##_deque_contains(const type##_deque_s *const restrict deque, const type value) \
+{ \
+   return type##_deque_find(deque, value) != deque->len; \
+}
+
+
+/**
+ * Deque search macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_SEARCH.
+ *
+ * Usage:
+ *   len_type i = deque_find(int, &dq, 42);    // index from front, deque_len() if absent
+ *   len_type n = deque_count(int, &dq, 42);   // number of elements equal to 42
+ *   bool has = deque_contains(int, &dq, 42);
+ */
+#define deque_find(type, deque, value) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_find((deque), (value)) \
+   )
+
+#define deque_count(type, deque, value) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_count((deque), (value)) \
+   )
+
+#define deque_contains(type, deque, value) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_contains((deque), (value)) \
+   )
+
+
+/**
+ * DEFINE_DEQUE_REDUCE macro
+ * -------------------------
+ * Declares sum / min / max / argmin / argmax for a numeric deque type.
+ *
+ * Parameters:
+ *   type     - Numeric element type stored in the deque
+ *   len_type - Integer type used for length/size
+ *   sum_type - Accumulator type returned by sum (e.g. int64_t for int32_t)
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE(...)
+ *    Use in combination with GENERATE_DEQUE_REDUCE(...), Ensure macro arguments match
+ */
+#define DEFINE_DEQUE_REDUCE(type, len_type, sum_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(sum_type); \
+\
+sum_type type##_deque_sum(const type##_deque_s *const restrict); \
+type type##_deque_min(const type##_deque_s *const restrict); \
+type type##_deque_max(const type##_deque_s *const restrict); \
+len_type type##_deque_argmin(const type##_deque_s *const restrict); \
+len_type type##_deque_argmax(const type##_deque_s *const restrict);
+
+
+/**
+ * GENERATE_DEQUE_REDUCE macro
+ * ---------------------------
+ * Implements sum / min / max / argmin / argmax for a numeric deque type.
+ *
+ * Parameters:
+ *   type     - Numeric element type
+ *   len_type - Unsigned integer type for length & size
+ *   sum_type - Accumulator type returned by sum
+ *
+ * Behavior:
+ *   - float / double: SSE2/AVX2 kernels from reduce.h, run over the one or
+ *     two contiguous segments of the ring (sum only when sum_type is the
+ *     element type).
+ *   - Other types: scalar loops, left to the compiler to vectorize.
+ *   - argmin/argmax: the min / max, then the first element equal to it
+ *     with a compare + movemask kernel (reduce_find_* for float / double,
+ *     search_find for integers) over each contiguous segment.
+ *   - Overflow: sum accumulates in sum_type; pick a wider type to avoid
+ *     overflow (unsigned wraps, signed overflow is undefined).
+ *   - NaN: sum propagates NaN, min/max return NaN if any element is NaN,
+ *     argmin/argmax return the index of the first NaN.
+ *   - min/max/argmin/argmax assert the deque is non-empty; sum of an empty
+ *     deque is 0.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_DEQUE(...)
+ *    Use in combination with DEFINE_DEQUE_REDUCE(...), Ensure macro arguments match
+ */
+#define GENERATE_DEQUE_REDUCE(type, len_type, sum_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(sum_type); \
+\
+static inline sum_type type##_deque_sum_scalar(const type *const restrict values, const size_t n) \
+{ \
+   sum_type sum = 0; \
+   for (size_t i = 0; i < n; i++) \
+      sum += (sum_type)values[i]; \
+   return sum; \
+} \
+\
+static inline type type##_deque_min_scalar(const type *const restrict values, const size_t n) \
+{ \
+   type result = values[0]; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      if (values[i] != values[i]) /* NaN */ \
+         return values[i]; \
+      if (values[i] < result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline type type##_deque_max_scalar(const type *const restrict values, const size_t n) \
+{ \
+   type result = values[0]; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      if (values[i] != values[i]) /* NaN */ \
+         return values[i]; \
+      if (values[i] > result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline size_t type##_deque_index_of(const type *const restrict values, const size_t n, const type target) \
+{ \
+   if (SEARCH_IS_INTEGRAL(type)) /* bitwise equality: compare + movemask kernel from search.h */ \
+      return search_find(values, n, sizeof(type), &target); \
+   const bool is_nan = (target != target); \
+   size_t i = 0; \
+   while (i < n && !(is_nan ? (values[i] != values[i]) : (values[i] == target))) \
+      i++; \
+   return i; \
+} \
+\
+sum_type type##_deque_sum(const type##_deque_s *const restrict deque) \
+{ \
+   assert(deque); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   return REDUCE_SUM_DISPATCH(deque->values, sum_type, type##_deque_sum_scalar)(&deque->values[deque->front], first_chunk) \
+        + REDUCE_SUM_DISPATCH(deque->values, sum_type, type##_deque_sum_scalar)(deque->values, deque->len - first_chunk); \
+} \
+\
+type type##_deque_min(const type##_deque_s *const restrict deque) \
+{ \
+   assert(deque); \
+   assert(!deque_empty(type, deque)); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   const type first = REDUCE_DISPATCH(deque->values, reduce_min_f32, reduce_min_f64, type##_deque_min_scalar)(&deque->values[deque->front], first_chunk); \
+   if (first_chunk == deque->len || first != first) \
+      return first; \
+   const type second = REDUCE_DISPATCH(deque->values, reduce_min_f32, reduce_min_f64, type##_deque_min_scalar)(deque->values, deque->len - first_chunk); \
+   return (second != second || second < first) ? second : first; \
+} \
+\
+type type##_deque_max(const type##_deque_s *const restrict deque) \
+{ \
+   assert(deque); \
+   assert(!deque_empty(type, deque)); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   const type first = REDUCE_DISPATCH(deque->values, reduce_max_f32, reduce_max_f64, type##_deque_max_scalar)(&deque->values[deque->front], first_chunk); \
+   if (first_chunk == deque->len || first != first) \
+      return first; \
+   const type second = REDUCE_DISPATCH(deque->values, reduce_max_f32, reduce_max_f64, type##_deque_max_scalar)(deque->values, deque->len - first_chunk); \
+   return (second != second || second > first) ? second : first; \
+} \
+\
+len_type type##_deque_argmin(const type##_deque_s *const restrict deque) \
+{ \
+   const type target = type##_deque_min(deque); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   const len_type index = (len_type)REDUCE_DISPATCH(deque->values, reduce_find_f32, reduce_find_f64, type##_deque_index_of)(&deque->values[deque->front], first_chunk, target); \
+   if (index < first_chunk) \
+      return index; \
+   return first_chunk + (len_type)REDUCE_DISPATCH(deque->values, reduce_find_f32, reduce_find_f64, type##_deque_index_of)(deque->values, deque->len - first_chunk, target); \
+} \
+\
+len_type type##_deque_argmax(const type##_deque_s *const restrict deque) \
+{ \
+   const type target = type##_deque_max(deque); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   const len_type index = (len_type)REDUCE_DISPATCH(deque->values, reduce_find_f32, reduce_find_f64, type##_deque_index_of)(&deque->values[deque->front], first_chunk, target); \
+   if (index < first_chunk) \
+      return index; \
+   return first_chunk + (len_type)REDUCE_DISPATCH(deque->values, reduce_find_f32, reduce_find_f64, type##_deque_index_of)(deque->values, deque->len - first_chunk, target); \
+}
+
+
+/**
+ * Deque reduce macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_REDUCE.
+ *
+ * Usage:
+ *   int64_t total = deque_sum(int32_t, &dq);
+ *   int32_t lo = deque_min(int32_t, &dq);        // asserts non-empty
+ *   len_type at = deque_argmax(int32_t, &dq);    // index from front
+ */
+#define deque_sum(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_sum((deque)) \
+   )
+
+#define deque_min(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_min((deque)) \
+   )
+
+#define deque_max(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_max((deque)) \
+   )
+
+#define deque_argmin(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_argmin((deque)) \
+   )
+
+#define deque_argmax(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_argmax((deque)) \
+   )
+
+
+/**
+ * DEFINE_DEQUE_SORT macro
+ * -----------------------
+ * Declares the sort functions for a deque type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the deque
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE(...)
+ *    Use in combination with GENERATE_DEQUE_SORT(...), Ensure macro arguments match
+ */
+#define DEFINE_DEQUE_SORT(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+bool type##_deque_sort(type##_deque_s *const restrict, int (*const)(const type*, const type*)); \
+bool type##_deque_radix_sort(type##_deque_s *const restrict);
+
+
+/**
+ * GENERATE_DEQUE_SORT macro
+ * -------------------------
+ * Implements the sort functions for a deque type.
+ *
+ * Parameters:
+ *   type       - Element type
+ *   len_type   - Unsigned integer type for length & size
+ *   key_type   - Radix key: unsigned, signed, float or double (1/2/4/8 bytes)
+ *   key_offset - Byte offset of the key in type (0 when key_type is type,
+ *                offsetof(type, field) for struct keys)
+ *   alloc_fn   - Allocator for the scratch buffer (the deque's own allocator)
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - sort(compare): stable merge sort, compare is qsort-style on pointers.
+ *   - radix_sort(): stable LSD radix sort ascending by key, skipping digits
+ *     that are equal for every key.
+ *   - Both sort the logical order front to back. A wrapped ring is unwrapped
+ *     into the scratch buffer and sorted back into values[0..len) with
+ *     front reset to 0; an unwrapped ring is sorted in place.
+ *   - Allocates one scratch buffer of len elements and returns false if
+ *     that allocation fails (deque left unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_DEQUE(...)
+ *    Use in combination with DEFINE_DEQUE_SORT(...), Ensure macro arguments match
+ */
+#define GENERATE_DEQUE_SORT(type, len_type, key_type, key_offset, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(key_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+   SORT_GENERATE_ARRAY(type##_deque, type, key_type, key_offset) \
+\
+/* Points *data at the elements as one contiguous run, *spare at a buffer of len; returns where the result belongs */ \
+static inline type *type##_deque_sort_unwrap(type##_deque_s *const restrict deque, type *const restrict scratch, type **const data, type **const spare) \
+{ \
+   if (deque->front + deque->len <= deque->size) /* not wrapped: sort in place */ \
+   { \
+      *data = &deque->values[deque->front]; \
+      *spare = scratch; \
+      return *data; \
+   } \
+\
+   const len_type first_chunk = deque->size - deque->front; \
+   MEMORY_COPY(scratch, &deque->values[deque->front], sizeof(type) * first_chunk); \
+   MEMORY_COPY(scratch + first_chunk, deque->values, sizeof(type) * (deque->len - first_chunk)); \
+   deque->front = 0; \
+   *data = scratch; \
+   *spare = deque->values; \
+   return deque->values; \
+} \
+\
+bool type##_deque_sort(type##_deque_s *const restrict deque, int (*const compare)(const type*, const type*)) \
+{ \
+   assert(deque); \
+   assert(compare); \
+   if (deque->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * deque->len); \
+   if (!scratch) \
+      return false; \
+\
+   type *data, *spare; \
+   type *const base = type##_deque_sort_unwrap(deque, scratch, &data, &spare); \
+   const type *const sorted = type##_deque_merge_sort_array(data, spare, deque->len, compare); \
+   if (sorted != base) \
+      MEMORY_COPY(base, sorted, sizeof(type) * deque->len); \
+   free_fn(scratch); \
+   return true; \
+} \
+\
+bool type##_deque_radix_sort(type##_deque_s *const restrict deque) \
+{ \
+   assert(deque); \
+   if (deque->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * deque->len); \
+   if (!scratch) \
+      return false; \
+\
+   type *data, *spare; \
+   type *const base = type##_deque_sort_unwrap(deque, scratch, &data, &spare); \
+   const type *const sorted = type##_deque_radix_sort_array(data, spare, deque->len); \
+   if (sorted != base) \
+      MEMORY_COPY(base, sorted, sizeof(type) * deque->len); \
+   free_fn(scratch); \
+   return true; \
+}
+
+
+/**
+ * Deque sort macros
+ * -----------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_SORT.
+ *
+ * Usage:
+ *   static int compare_int(const int *a, const int *b) { return (*a > *b) - (*a < *b); }
+ *
+ *   if (!deque_sort(int, &dq, compare_int))     // stable, front to back
+ *      handle_oom();
+ *   deque_radix_sort(int, &dq);                 // by key_type at key_offset
+ */
+#define deque_sort(type, deque, compare) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_sort((deque), (compare)) \
+   )
+
+#define deque_radix_sort(type, deque) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_radix_sort((deque)) \
+   )
+
+
+/**
+ * DEFINE_DEQUE_REMOVE_IF macro
+ * ----------------------------
+ * Declares remove_if / retain_if / remove_value for a deque type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the deque
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE(...)
+ *    Use in combination with GENERATE_DEQUE_REMOVE_IF(...)
+ */
+#define DEFINE_DEQUE_REMOVE_IF(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+len_type type##_deque_remove_if(type##_deque_s *const restrict, bool (*const)(const type*, void*), void *const); \
+len_type type##_deque_retain_if(type##_deque_s *const restrict, bool (*const)(const type*, void*), void *const); \
+len_type type##_deque_remove_value(type##_deque_s *const restrict, const type);
+
+
+/**
+ * GENERATE_DEQUE_REMOVE_IF macro
+ * ------------------------------
+ * Implements remove_if / retain_if / remove_value for a deque type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   equal_fn - bool (type, type) equality, used for non-integral types
+ *
+ * Behavior:
+ *   - Single pass, in place, order of the survivors is preserved.
+ *   - Each contiguous segment of the ring is compacted on its own; if the
+ *     deque wraps, the survivors of the first segment are then moved up
+ *     against the end of the buffer (front moves, the ring is never
+ *     linearized).
+ *   - remove_if / retain_if: pred(&element, ctx) is called once per element,
+ *     front to back; the loop is branchless on the result.
+ *   - remove_value: integral types use the SIMD compress kernels from
+ *     compact.h (equal_fn unused), other types a scan with equal_fn.
+ *   - All return the number of elements removed. Capacity is unchanged.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_DEQUE(...)
+ *    Use in combination with DEFINE_DEQUE_REMOVE_IF(...)
+ */
+#define GENERATE_DEQUE_REMOVE_IF(type, len_type, equal_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(equal_fn, bool (type, type)); \
+   COMPACT_GENERATE_ARRAY(type##_deque, type) \
+\
+static inline len_type type##_deque_compact_close(type##_deque_s *const restrict deque, const len_type first_chunk, const len_type kept_first, const len_type kept_second) \
+{ \
+   const len_type removed = deque->len - kept_first - kept_second; \
+   if (first_chunk < deque->len) /* wrapped: close the gap before the end of the buffer */ \
+   { \
+      MEMORY_MOVE(&deque->values[deque->size - kept_first], &deque->values[deque->front], sizeof(type) * kept_first); \
+      deque->front = (deque->size - kept_first) & (deque->size - 1); \
+   } \
+   deque->len = kept_first + kept_second; \
+   return removed; \
+} \
+\
+static inline len_type type##_deque_compact(type##_deque_s *const restrict deque, bool (*const pred)(const type*, void*), void *const ctx, const bool remove) \
+{ \
+   assert(deque); \
+   assert(pred); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   const len_type kept_first = (len_type)type##_deque_compact_array(&deque->values[deque->front], first_chunk, pred, ctx, remove); \
+   const len_type kept_second = (len_type)type##_deque_compact_array(deque->values, deque->len - first_chunk, pred, ctx, remove); \
+   return type##_deque_compact_close(deque, first_chunk, kept_first, kept_second); \
+} \
+\
+len_type type##_deque_remove_if(type##_deque_s *const restrict deque, bool (*const pred)(const type*, void*), void *const ctx) \
+{ \
+   return type##_deque_compact(deque, pred, ctx, true); \
+} \
+\
+len_type type##_deque_retain_if(type##_deque_s *const restrict deque, bool (*const pred)(const type*, void*), void *const ctx) \
+{ \
+   return type##_deque_compact(deque, pred, ctx, false); \
+} \
+\
+len_type type##_deque_remove_value(type##_deque_s *const restrict deque, const type value) \
+{ \
+   assert(deque); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   len_type kept_first, kept_second; \
+   if (SEARCH_IS_INTEGRAL(type)) \
+   { \
+      kept_first = (len_type)compact_remove(&deque->values[deque->front], first_chunk, sizeof(type), &value); \
+      kept_second = (len_type)compact_remove(deque->values, deque->len - first_chunk, sizeof(type), &value); \
+   } \
+   else \
+   { \
+      kept_first = (len_type)type##_deque_compact_equal_array(&deque->values[deque->front], first_chunk, value, equal_fn); \
+      kept_second = (len_type)type##_deque_compact_equal_array(deque->values, deque->len - first_chunk, value, equal_fn); \
+   } \
+   return type##_deque_compact_close(deque, first_chunk, kept_first, kept_second); \
+}
+
+
+/**
+ * Deque remove macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_REMOVE_IF.
+ *
+ * Usage:
+ *   static bool is_even(const int *x, void *ctx) { (void)ctx; return *x % 2 == 0; }
+ *
+ *   len_type n = deque_remove_if(int, &q, is_even, NULL);   // drop even values
+ *   deque_retain_if(int, &q, is_even, NULL);                // keep only even values
+ *   deque_remove_value(int, &q, 42);                        // drop every 42
+ */
+#define deque_remove_if(type, deque, pred, ctx) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_remove_if((deque), (pred), (ctx)) \
+   )
+
+#define deque_retain_if(type, deque, pred, ctx) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_retain_if((deque), (pred), (ctx)) \
+   )
+
+#define deque_remove_value(type, deque, value) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_remove_value((deque), (value)) \
+   )
+
+
+/**
+ * DEFINE_DEQUE_HASH macro
+ * -----------------------
+ * Declares hash / equal for a deque type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the deque
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE(...)
+ *    Use in combination with GENERATE_DEQUE_HASH(...)
+ */
+#define DEFINE_DEQUE_HASH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+uint64_t type##_deque_hash(const type##_deque_s *const restrict, const uint64_t); \
+bool type##_deque_equal(const type##_deque_s *const, const type##_deque_s *const);
+
+
+/**
+ * GENERATE_DEQUE_HASH macro
+ * -------------------------
+ * Implements hash / equal for a deque type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *
+ * Behavior:
+ *   - hash(seed): 64-bit streaming hash (hash.h) of the bytes of the
+ *     elements, front to back, fed segment by segment without linearizing.
+ *     Capacity and the position of the wrap point do not affect the result.
+ *   - equal(a, b): same length and memcmp-equal elements; the two rings are
+ *     walked in runs that are contiguous in both (at most three memcmp
+ *     calls), so their fronts and sizes may differ.
+ *
+ * Notes:
+ *    Both work on the object representation: only use for element types
+ *    without padding bytes, and where bitwise equality is value equality.
+ *    Use only in a source (.c) file, after GENERATE_DEQUE(...)
+ *    Use in combination with DEFINE_DEQUE_HASH(...)
+ */
+#define GENERATE_DEQUE_HASH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+uint64_t type##_deque_hash(const type##_deque_s *const restrict deque, const uint64_t seed) \
+{ \
+   assert(deque); \
+   const len_type first_chunk = (deque->front + deque->len <= deque->size) ? deque->len : deque->size - deque->front; \
+   hash_state_s state; \
+   hash_init(&state, seed); \
+   hash_update(&state, &deque->values[deque->front], sizeof(type) * first_chunk); \
+   hash_update(&state, deque->values, sizeof(type) * (deque->len - first_chunk)); \
+   return hash_final(&state); \
+} \
+\
+bool type##_deque_equal(const type##_deque_s *const a, const type##_deque_s *const b) \
+{ \
+   assert(a); \
+   assert(b); \
+   if (a->len != b->len) \
+      return false; \
+\
+   for (len_type i = 0; i < a->len;) \
+   { \
+      const len_type index_a = (a->front + i) & (a->size - 1); \
+      const len_type index_b = (b->front + i) & (b->size - 1); \
+      len_type run = a->len - i; \
+      if (a->size - index_a < run) \
+         run = a->size - index_a; \
+      if (b->size - index_b < run) \
+         run = b->size - index_b; \
+      if (memcmp(&a->values[index_a], &b->values[index_b], sizeof(type) * run) != 0) \
+         return false; \
+      i += run; \
+   } \
+   return true; \
+}
+
+
+/**
+ * Deque hash macros
+ * -----------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_HASH.
+ *
+ * Usage:
+ *   uint64_t h = deque_hash(int, &d, 0);     // seed 0
+ *   if (deque_equal(int, &d, &e)) { ... }    // wrap points may differ
+ */
+#define deque_hash(type, deque, seed) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_hash((deque), (seed)) \
+   )
+
+#define deque_equal(type, a, b) \
+   typecheck_deque_ptr(a, type, typecheck_deque_ptr(b, type, \
+      type##_deque_equal((a), (b)) \
+   ))
+
+
+/**
+ * DEFINE_DEQUE_PARALLEL macro
+ * ---------------------------
+ * Declares parallel for_each / transform / reduce for a deque type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the deque
+ *   len_type - Integer type used for length/size
+ *   acc_type - Accumulator type of parallel_reduce
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE(...)
+ *    Use in combination with GENERATE_DEQUE_PARALLEL(...), Ensure macro arguments match
+ */
+#define DEFINE_DEQUE_PARALLEL(type, len_type, acc_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(acc_type); \
+\
+void type##_deque_parallel_for_each(type##_deque_s *const restrict, parallel_pool_s *const, void (*const)(type*, void*), void *const); \
+void type##_deque_parallel_transform(type##_deque_s *const restrict, parallel_pool_s *const, type (*const)(type, void*), void *const); \
+acc_type type##_deque_parallel_reduce(const type##_deque_s *const restrict, parallel_pool_s *const, const acc_type, acc_type (*const)(acc_type, const type*, void*), acc_type (*const)(acc_type, acc_type), void *const);
+
+
+/**
+ * GENERATE_DEQUE_PARALLEL macro
+ * -----------------------------
+ * Implements parallel for_each / transform / reduce for a deque type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   acc_type - Accumulator type of parallel_reduce
+ *
+ * Behavior:
+ *   - The elements are split into chunks with parallel_chunks (serial
+ *     below PARALLEL_SERIAL_THRESHOLD) and the chunks run on `pool`
+ *     (parallel.h); pool may be NULL for a serial pass.
+ *
+ *   - Chunks cover the logical order front to back; a chunk that crosses
+ *     the wrap point is processed as its two contiguous pieces.
+ *   - for_each(fn, ctx): fn(&element, ctx) for every element.
+ *   - transform(fn, ctx): element = fn(element, ctx) for every element.
+ *   - reduce(init, reduce_fn, combine_fn, ctx): each chunk folds its
+ *     elements in order with reduce_fn starting from init, then the chunk
+ *     results are folded in chunk order with combine_fn, starting from
+ *     init. init must be an identity of combine_fn; with an associative
+ *     combine_fn the result matches a serial fold.
+ *   - fn / reduce_fn run concurrently on different elements: they must
+ *     not touch the same shared state without synchronization.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_DEQUE(...)
+ *    Use in combination with DEFINE_DEQUE_PARALLEL(...), Ensure macro arguments match
+ */
+#define GENERATE_DEQUE_PARALLEL(type, len_type, acc_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(acc_type); \
+\
+typedef struct \
+{ \
+   type *values; \
+   size_t front; \
+   size_t len; \
+   size_t size; \
+   size_t chunk; \
+   void (*for_each_fn)(type*, void*); \
+   type (*transform_fn)(type, void*); \
+   acc_type (*reduce_fn)(acc_type, const type*, void*); \
+   acc_type init; \
+   acc_type *partials; \
+   void *ctx; \
+} type##_deque_parallel_job_s; \
+\
+static inline void type##_deque_parallel_span(const type##_deque_parallel_job_s *const restrict job, const size_t index, type **const first, size_t *const first_len, type **const second, size_t *const second_len) \
+{ \
+   const size_t lo = index * job->chunk; \
+   const size_t hi = (lo + job->chunk < job->len) ? lo + job->chunk : job->len; \
+   const size_t start = (job->front + lo) & (job->size - 1); \
+   *first = job->values + start; \
+   *first_len = (start + (hi - lo) <= job->size) ? hi - lo : job->size - start; \
+   *second = job->values; \
+   *second_len = (hi - lo) - *first_len; \
+} \
+\
+static void type##_deque_parallel_for_each_task(void *const arg, const size_t index) \
+{ \
+   const type##_deque_parallel_job_s *const job = (const type##_deque_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_deque_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         job->for_each_fn(&pieces[p][i], job->ctx); \
+} \
+\
+static void type##_deque_parallel_transform_task(void *const arg, const size_t index) \
+{ \
+   const type##_deque_parallel_job_s *const job = (const type##_deque_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_deque_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         pieces[p][i] = job->transform_fn(pieces[p][i], job->ctx); \
+} \
+\
+static void type##_deque_parallel_reduce_task(void *const arg, const size_t index) \
+{ \
+   const type##_deque_parallel_job_s *const job = (const type##_deque_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_deque_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   acc_type acc = job->init; \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         acc = job->reduce_fn(acc, &pieces[p][i], job->ctx); \
+   job->partials[index] = acc; \
+} \
+\
+void type##_deque_parallel_for_each(type##_deque_s *const restrict deque, parallel_pool_s *const pool, void (*const fn)(type*, void*), void *const ctx) \
+{ \
+   assert(deque); \
+   assert(fn); \
+   type##_deque_parallel_job_s job = { .values = deque->values, .front = deque->front, .len = deque->len, .size = deque->size }; \
+   job.for_each_fn = fn; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, deque->len, &job.chunk); \
+   parallel_run(pool, tasks, type##_deque_parallel_for_each_task, &job); \
+} \
+\
+void type##_deque_parallel_transform(type##_deque_s *const restrict deque, parallel_pool_s *const pool, type (*const fn)(type, void*), void *const ctx) \
+{ \
+   assert(deque); \
+   assert(fn); \
+   type##_deque_parallel_job_s job = { .values = deque->values, .front = deque->front, .len = deque->len, .size = deque->size }; \
+   job.transform_fn = fn; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, deque->len, &job.chunk); \
+   parallel_run(pool, tasks, type##_deque_parallel_transform_task, &job); \
+} \
+\
+acc_type type##_deque_parallel_reduce(const type##_deque_s *const restrict deque, parallel_pool_s *const pool, const acc_type init, acc_type (*const reduce_fn)(acc_type, const type*, void*), acc_type (*const combine_fn)(acc_type, acc_type), void *const ctx) \
+{ \
+   assert(deque); \
+   assert(reduce_fn); \
+   assert(combine_fn); \
+   acc_type partials[PARALLEL_MAX_TASKS]; \
+   type##_deque_parallel_job_s job = { .values = deque->values, .front = deque->front, .len = deque->len, .size = deque->size }; \
+   job.reduce_fn = reduce_fn; \
+   job.init = init; \
+   job.partials = partials; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, deque->len, &job.chunk); \
+   assert(tasks <= PARALLEL_MAX_TASKS); \
+   parallel_run(pool, tasks, type##_deque_parallel_reduce_task, &job); \
+\
+   acc_type result = init; \
+   for (size_t i = 0; i < tasks; i++) \
+      result = combine_fn(result, partials[i]); \
+   return result; \
+}
+
+/**
+ * Deque parallel macros
+ * ---------------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_PARALLEL.
+ *
+ * Usage:
+ *   parallel_pool_s pool;
+ *   parallel_pool_init(&pool, 0);                                   // one thread per CPU
+ *
+ *   deque_parallel_for_each(int, &d, &pool, clamp, &limits);       // void clamp(int*, void*)
+ *   deque_parallel_transform(int, &d, &pool, square, NULL);         // int square(int, void*)
+ *   int64_t sum = deque_parallel_reduce(int, &d, &pool, 0, add, add64, NULL);
+ *
+ *   parallel_pool_delete(&pool);
+ */
+#define deque_parallel_for_each(type, deque, pool, fn, ctx) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_parallel_for_each((deque), (pool), (fn), (ctx)) \
+   )
+
+#define deque_parallel_transform(type, deque, pool, fn, ctx) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_parallel_transform((deque), (pool), (fn), (ctx)) \
+   )
+
+#define deque_parallel_reduce(type, deque, pool, init, reduce_fn, combine_fn, ctx) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_parallel_reduce((deque), (pool), (init), (reduce_fn), (combine_fn), (ctx)) \
+   )
+
+
+/**
+ * DEFINE_DEQUE_PARALLEL_SORT macro
+ * --------------------------------
+ * Declares the multi-threaded sort functions for a deque type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the deque
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_DEQUE_SORT(...)
+ *    Use in combination with GENERATE_DEQUE_PARALLEL_SORT(...), Ensure macro arguments match
+ */
+#define DEFINE_DEQUE_PARALLEL_SORT(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+bool type##_deque_parallel_sort(type##_deque_s *const restrict, parallel_pool_s *const, int (*const)(const type*, const type*));
+
+
+/**
+ * GENERATE_DEQUE_PARALLEL_SORT macro
+ * ----------------------------------
+ * Implements the multi-threaded sort functions for a deque type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   alloc_fn - Allocator for the scratch buffer (the deque's own allocator)
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - parallel_sort(pool, compare): same result as sort. The elements are
+ *     cut into runs that are sorted on `pool`, then merged in parallel (see
+ *     SORT_GENERATE_PARALLEL).
+ *   - A wrapped ring is unwrapped into the scratch buffer, sorted there and
+ *     merged back into values[0..len) with front reset to 0; an unwrapped
+ *     ring is merged into the scratch buffer and copied back in place.
+ *     Both copies are split across the pool.
+ *   - pool may be NULL, and below PARALLEL_SERIAL_THRESHOLD elements the
+ *     serial sort runs.
+ *   - Allocates one scratch buffer of len elements and returns false if
+ *     that allocation fails (deque left unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_DEQUE_SORT(...)
+ *    Use in combination with DEFINE_DEQUE_PARALLEL_SORT(...), Ensure macro arguments match
+ */
+#define GENERATE_DEQUE_PARALLEL_SORT(type, len_type, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+   SORT_GENERATE_PARALLEL(type##_deque, type) \
+\
+/* deque_sort_unwrap with the copies split across the pool */ \
+static inline type *type##_deque_parallel_sort_unwrap(type##_deque_s *const restrict deque, parallel_pool_s *const pool, type *const restrict scratch, type **const data, type **const spare) \
+{ \
+   if (deque->front + deque->len <= deque->size) /* not wrapped: sort in place */ \
+   { \
+      *data = &deque->values[deque->front]; \
+      *spare = scratch; \
+      return *data; \
+   } \
+\
+   const len_type first_chunk = deque->size - deque->front; \
+   parallel_copy(pool, scratch, &deque->values[deque->front], sizeof(type) * first_chunk); \
+   parallel_copy(pool, scratch + first_chunk, deque->values, sizeof(type) * (deque->len - first_chunk)); \
+   deque->front = 0; \
+   *data = scratch; \
+   *spare = deque->values; \
+   return deque->values; \
+} \
+\
+bool type##_deque_parallel_sort(type##_deque_s *const restrict deque, parallel_pool_s *const pool, int (*const compare)(const type*, const type*)) \
+{ \
+   assert(deque); \
+   assert(compare); \
+   if (deque->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * deque->len); \
+   if (!scratch) \
+      return false; \
+\
+   type *data, *spare; \
+   type *const base = type##_deque_parallel_sort_unwrap(deque, pool, scratch, &data, &spare); \
+   const type *const sorted = type##_deque_parallel_merge_sort_array(data, spare, deque->len, compare, pool); \
+   if (sorted != base) \
+      parallel_copy(pool, base, sorted, sizeof(type) * deque->len); \
+   free_fn(scratch); \
+   return true; \
+}
+
+/**
+ * Deque parallel sort macros
+ * --------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_DEQUE_PARALLEL_SORT.
+ *
+ * Usage:
+ *   if (!deque_parallel_sort(int, &d, &pool, compare_int))     // stable, front to back
+ *      handle_oom();
+ */
+#define deque_parallel_sort(type, deque, pool, compare) \
+   typecheck_deque_ptr(deque, type, \
+      type##_deque_parallel_sort((deque), (pool), (compare)) \
+   )
+
 
 #endif /* __DEQUE_H */
\ No newline at end of file
@@ -0,0 +1,423 @@
+#ifndef __ENUM_SET_H
+#define __ENUM_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "bitset.h"
+
+
+/**
+ * Enum set / enum map
+ * -------------------
+ * Fixed-size containers keyed by an enum with values 0 .. count - 1, where
+ * count is the enum's sentinel (e.g. STATE_COUNT):
+ *   - enum_set(type): one bit per enumerator in ENUM_SET_WORDS(count)
+ *     64-bit words, so membership is a shift and a mask instead of a switch
+ *   - enum_map(key_type, value_type): a value_type array indexed by the
+ *     enumerator, no hashing
+ *
+ * Both are plain values with no allocation: copy, compare with the
+ * functions below, or declare them static const.
+ */
+
+/* number of words holding `count` enumerators */
+#define ENUM_SET_WORDS(count) (((size_t)(count) + 63) / 64)
+
+
+/**
+ * DEFINE_ENUM_SET macro
+ * ---------------------
+ * Defines a set of `type` enumerators and its inline functions.
+ *
+ * Parameters:
+ *   type   - Enum type (a PACKED_ENUM typedef or any integer-valued enum)
+ *   count  - Number of enumerators, usually the trailing sentinel; values
+ *            must lie in [0, count)
+ *
+ * Behavior:
+ *   - add / remove / toggle / assign / has: one word, no branches
+ *   - union / intersect / difference / equal / subset / intersects / count:
+ *     loops over a constant number of words, unrolled by the compiler
+ *   - next(from): the smallest member >= from, or `count` if none; the bits
+ *     past `count` are always zero, so no bound check inside a word
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    There is no GENERATE_ENUM_SET: every function is static inline
+ */
+#define DEFINE_ENUM_SET(type, count) \
+   static_assert((count) > 0, "Warning: count must be positive"); \
+   assert_istype(type); \
+\
+enum { type##_enum_set_count = (count), type##_enum_set_words = ENUM_SET_WORDS(count) }; \
+\
+typedef struct \
+{ \
+   uint64_t words[ENUM_SET_WORDS(count)]; \
+} type##_enum_set_s; \
+\
+static inline void type##_enum_set_init(type##_enum_set_s *const restrict set) \
+{ \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      set->words[w] = 0; \
+} \
+\
+static inline void type##_enum_set_add(type##_enum_set_s *const restrict set, const type value) \
+{ \
+   assert((size_t)value < type##_enum_set_count); \
+   set->words[(size_t)value / 64] |= 1ull << ((size_t)value % 64); \
+} \
+\
+static inline void type##_enum_set_remove(type##_enum_set_s *const restrict set, const type value) \
+{ \
+   assert((size_t)value < type##_enum_set_count); \
+   set->words[(size_t)value / 64] &= ~(1ull << ((size_t)value % 64)); \
+} \
+\
+static inline void type##_enum_set_toggle(type##_enum_set_s *const restrict set, const type value) \
+{ \
+   assert((size_t)value < type##_enum_set_count); \
+   set->words[(size_t)value / 64] ^= 1ull << ((size_t)value % 64); \
+} \
+\
+/* add if `member`, remove otherwise */ \
+static inline void type##_enum_set_assign(type##_enum_set_s *const restrict set, const type value, const bool member) \
+{ \
+   assert((size_t)value < type##_enum_set_count); \
+   uint64_t *const word = &set->words[(size_t)value / 64]; \
+   const uint64_t bit = 1ull << ((size_t)value % 64); \
+   *word = (*word & ~bit) | (-(uint64_t)member & bit); \
+} \
+\
+static inline bool type##_enum_set_has(const type##_enum_set_s *const restrict set, const type value) \
+{ \
+   assert((size_t)value < type##_enum_set_count); \
+   return (set->words[(size_t)value / 64] >> ((size_t)value % 64)) & 1; \
+} \
+\
+/* every enumerator in [0, count) */ \
+static inline void type##_enum_set_fill(type##_enum_set_s *const restrict set) \
+{ \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      set->words[w] = ~0ull; \
+   if (type##_enum_set_count % 64) \
+      set->words[type##_enum_set_words - 1] = (1ull << (type##_enum_set_count % 64)) - 1; \
+} \
+\
+static inline void type##_enum_set_union(type##_enum_set_s *const dst, const type##_enum_set_s *const src) \
+{ \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      dst->words[w] |= src->words[w]; \
+} \
+\
+static inline void type##_enum_set_intersect(type##_enum_set_s *const dst, const type##_enum_set_s *const src) \
+{ \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      dst->words[w] &= src->words[w]; \
+} \
+\
+static inline void type##_enum_set_difference(type##_enum_set_s *const dst, const type##_enum_set_s *const src) \
+{ \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      dst->words[w] &= ~src->words[w]; \
+} \
+\
+static inline bool type##_enum_set_equal(const type##_enum_set_s *const a, const type##_enum_set_s *const b) \
+{ \
+   uint64_t diff = 0; \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      diff |= a->words[w] ^ b->words[w]; \
+   return diff == 0; \
+} \
+\
+/* every member of a is in b */ \
+static inline bool type##_enum_set_subset(const type##_enum_set_s *const a, const type##_enum_set_s *const b) \
+{ \
+   uint64_t extra = 0; \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      extra |= a->words[w] & ~b->words[w]; \
+   return extra == 0; \
+} \
+\
+static inline bool type##_enum_set_intersects(const type##_enum_set_s *const a, const type##_enum_set_s *const b) \
+{ \
+   uint64_t common = 0; \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      common |= a->words[w] & b->words[w]; \
+   return common != 0; \
+} \
+\
+static inline bool type##_enum_set_empty(const type##_enum_set_s *const restrict set) \
+{ \
+   uint64_t any = 0; \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      any |= set->words[w]; \
+   return any == 0; \
+} \
+\
+static inline uint32_t type##_enum_set_count_members(const type##_enum_set_s *const restrict set) \
+{ \
+   uint32_t n = 0; \
+   for (size_t w = 0; w < type##_enum_set_words; w++) \
+      n += bitset_popcount64(set->words[w]); \
+   return n; \
+} \
+\
+/* smallest member >= from, count if there is none */ \
+static inline type type##_enum_set_next(const type##_enum_set_s *const restrict set, const size_t from) \
+{ \
+   if (from >= type##_enum_set_count) \
+      return (type)type##_enum_set_count; \
+   size_t w = from / 64; \
+   uint64_t word = set->words[w] & (~0ull << (from % 64)); \
+   while (!word) \
+   { \
+      if (++w == type##_enum_set_words) \
+         return (type)type##_enum_set_count; \
+      word = set->words[w]; \
+   } \
+   return (type)(w * 64 + bitset_ctz64(word)); \
+} \
+\
+/* set holding values[0 .. n) */ \
+static inline type##_enum_set_s type##_enum_set_of(const type *const restrict values, const size_t n) \
+{ \
+   type##_enum_set_s set; \
+   type##_enum_set_init(&set); \
+   for (size_t i = 0; i < n; i++) \
+      type##_enum_set_add(&set, values[i]); \
+   return set; \
+}
+
+
+/**
+ * DEFINE_ENUM_MAP macro
+ * ---------------------
+ * Defines a map from `key_type` enumerators to `value_type` values, stored
+ * as `value_type values[count]` and indexed directly by the key.
+ *
+ * Parameters:
+ *   key_type    - Enum type, values in [0, count)
+ *   value_type  - Stored type
+ *   count       - Number of enumerators, usually the trailing sentinel
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Every key always has a value: the map holds whatever it was
+ *    initialized with (fill, or a designated initializer on `values`)
+ *    Use with an enum_set(key_type) to track which keys are meaningful
+ */
+#define DEFINE_ENUM_MAP(key_type, value_type, count) \
+   static_assert((count) > 0, "Warning: count must be positive"); \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+\
+enum { key_type##_##value_type##_enum_map_count = (count) }; \
+\
+typedef struct \
+{ \
+   value_type values[count]; \
+} key_type##_##value_type##_enum_map_s; \
+\
+static inline value_type *key_type##_##value_type##_enum_map_get(key_type##_##value_type##_enum_map_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   assert((size_t)key < key_type##_##value_type##_enum_map_count); \
+   return &map->values[(size_t)key]; \
+} \
+\
+static inline value_type key_type##_##value_type##_enum_map_value(const key_type##_##value_type##_enum_map_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   assert((size_t)key < key_type##_##value_type##_enum_map_count); \
+   return map->values[(size_t)key]; \
+} \
+\
+static inline void key_type##_##value_type##_enum_map_set(key_type##_##value_type##_enum_map_s *const restrict map, const key_type key, const value_type value) \
+{ \
+   assert(map); \
+   assert((size_t)key < key_type##_##value_type##_enum_map_count); \
+   map->values[(size_t)key] = value; \
+} \
+\
+static inline void key_type##_##value_type##_enum_map_fill(key_type##_##value_type##_enum_map_s *const restrict map, const value_type value) \
+{ \
+   assert(map); \
+   for (size_t i = 0; i < key_type##_##value_type##_enum_map_count; i++) \
+      map->values[i] = value; \
+}
+
+
+/**
+ * enum_set(type) / enum_map(key_type, value_type) macros
+ * ------------------------------------------------------
+ * Declare an enum set or enum map.
+ *
+ * Usage (as variable):
+ *   enum_set(state_e) terminal;
+ *   static const enum_map(state_e, int) weight = { .values = { [STATE_IDLE] = 1, [STATE_DONE] = 4 } };
+ *
+ * Usage (as parameter):
+ *   void mark(enum_set(state_e) *const seen) { ... }
+ *
+ * Notes:
+ *   - These macros expand to the underlying struct types
+ *     (type##_enum_set_s, key_type##_##value_type##_enum_map_s).
+ */
+#define enum_set(type) \
+   type##_enum_set_s
+
+#define enum_map(key_type, value_type) \
+   key_type##_##value_type##_enum_map_s
+
+
+/**
+ * typecheck_enum_set_ptr / typecheck_enum_map_ptr macros
+ * ------------------------------------------------------
+ * Compile-time validation that 'var' is a pointer to the enum set / enum
+ * map (see typecheck_ptr).
+ */
+#define typecheck_enum_set_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_enum_set_s, expr)
+
+#define typecheck_enum_map_ptr(var, key_type, value_type, expr) \
+   typecheck_ptr(var, key_type##_##value_type##_enum_map_s, expr)
+
+
+/**
+ * Enum set / enum map function macros
+ * -----------------------------------
+ * Type-generic wrappers for the functions defined by DEFINE_ENUM_SET and
+ * DEFINE_ENUM_MAP.
+ *
+ *   enum_set_of(type, ...)                - set of the listed enumerators, by value
+ *   enum_set_foreach(type, set, var)      - for loop over the members, ascending
+ *   enum_map_at(key, value, map, k)       - lvalue of k's value
+ *   enum_map_value(key, value, map, k)    - k's value, also on a const map
+ *
+ * Usage:
+ *   const enum_set(state_e) terminal = enum_set_of(state_e, STATE_DONE, STATE_FAILED);
+ *   if (enum_set_has(state_e, &terminal, job->state)) ...
+ *
+ *   enum_set_foreach(state_e, &seen, s)
+ *      printf("%s\n", enum_map_value(state_e, str, &names, s));
+ */
+#define enum_set_init(type, set) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_init((set)) \
+   )
+
+#define enum_set_clear(type, set) \
+   enum_set_init(type, set)
+
+#define enum_set_add(type, set, value) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_add((set), (value)) \
+   )
+
+#define enum_set_remove(type, set, value) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_remove((set), (value)) \
+   )
+
+#define enum_set_toggle(type, set, value) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_toggle((set), (value)) \
+   )
+
+#define enum_set_assign(type, set, value, member) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_assign((set), (value), (member)) \
+   )
+
+#define enum_set_has(type, set, value) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_has((set), (value)) \
+   )
+
+#define enum_set_fill(type, set) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_fill((set)) \
+   )
+
+#define enum_set_union(type, dst, src) \
+   typecheck_enum_set_ptr(dst, type, \
+      type##_enum_set_union((dst), (src)) \
+   )
+
+#define enum_set_intersect(type, dst, src) \
+   typecheck_enum_set_ptr(dst, type, \
+      type##_enum_set_intersect((dst), (src)) \
+   )
+
+#define enum_set_difference(type, dst, src) \
+   typecheck_enum_set_ptr(dst, type, \
+      type##_enum_set_difference((dst), (src)) \
+   )
+
+#define enum_set_equal(type, a, b) \
+   typecheck_enum_set_ptr(a, type, \
+      type##_enum_set_equal((a), (b)) \
+   )
+
+#define enum_set_subset(type, a, b) \
+   typecheck_enum_set_ptr(a, type, \
+      type##_enum_set_subset((a), (b)) \
+   )
+
+#define enum_set_intersects(type, a, b) \
+   typecheck_enum_set_ptr(a, type, \
+      type##_enum_set_intersects((a), (b)) \
+   )
+
+#define enum_set_empty(type, set) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_empty((set)) \
+   )
+
+#define enum_set_count(type, set) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_count_members((set)) \
+   )
+
+#define enum_set_next(type, set, from) \
+   typecheck_enum_set_ptr(set, type, \
+      type##_enum_set_next((set), (from)) \
+   )
+
+#define enum_set_of(type, ...) \
+   type##_enum_set_of((const type[]){ __VA_ARGS__ }, sizeof((const type[]){ __VA_ARGS__ }) / sizeof(type))
+
+#define enum_set_foreach(type, set, var) \
+   for (type var = enum_set_next(type, set, 0); \
+        (size_t)var < type##_enum_set_count; \
+        var = type##_enum_set_next((set), (size_t)var + 1))
+
+#define enum_map_get(key_type, value_type, map, key) \
+   typecheck_enum_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_enum_map_get((map), (key)) \
+   )
+
+#define enum_map_value(key_type, value_type, map, key) \
+   typecheck_enum_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_enum_map_value((map), (key)) \
+   )
+
+#define enum_map_at(key_type, value_type, map, key) \
+   (*enum_map_get(key_type, value_type, map, key))
+
+#define enum_map_set(key_type, value_type, map, key, value) \
+   typecheck_enum_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_enum_map_set((map), (key), (value)) \
+   )
+
+#define enum_map_fill(key_type, value_type, map, value) \
+   typecheck_enum_map_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_enum_map_fill((map), (value)) \
+   )
+
+
+#endif /* __ENUM_SET_H */
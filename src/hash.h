@@ -0,0 +1,195 @@
+#ifndef __HASH_H
+#define __HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+
+/**
+ * Hash functions
+ * --------------
+ * Fast non-cryptographic 64-bit hashing (XXH64 algorithm), one-shot or
+ * streamed in pieces of any size.
+ *
+ * Functions:
+ *   hash_init(state, seed)         - start a stream
+ *   hash_update(state, data, size) - feed `size` bytes
+ *   hash_final(state)              - 64-bit digest (state is not modified)
+ *   hash_bytes(data, size, seed)   - one-shot hash_init + hash_update + hash_final
+ *
+ * Behavior:
+ *   - The digest depends only on the concatenated bytes and the seed, not on
+ *     how they were split across hash_update calls.
+ *   - Input is consumed in 32-byte stripes on four independent lanes.
+ *
+ * Notes:
+ *   Words are read in host byte order, so digests of the same bytes differ
+ *   between little and big endian hosts (they match reference XXH64 on
+ *   little endian). Not suitable where hash flooding is a concern.
+ */
+
+#define HASH_PRIME_1 UINT64_C(0x9E3779B185EBCA87)
+#define HASH_PRIME_2 UINT64_C(0xC2B2AE3D27D4EB4F)
+#define HASH_PRIME_3 UINT64_C(0x165667B19E3779F9)
+#define HASH_PRIME_4 UINT64_C(0x85EBCA77C2B2AE63)
+#define HASH_PRIME_5 UINT64_C(0x27D4EB2F165667C5)
+
+#define HASH_STRIPE 32
+
+typedef struct
+{
+   uint64_t lanes[4];
+   uint64_t seed;
+   uint64_t total_len;
+   unsigned char buffer[HASH_STRIPE];
+   size_t buffer_len;
+} hash_state_s;
+
+
+static inline uint64_t hash_rotl(const uint64_t x, const int r)
+{
+   return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t hash_read64(const unsigned char *const restrict p)
+{
+   uint64_t x;
+   memcpy(&x, p, sizeof(x));
+   return x;
+}
+
+static inline uint32_t hash_read32(const unsigned char *const restrict p)
+{
+   uint32_t x;
+   memcpy(&x, p, sizeof(x));
+   return x;
+}
+
+static inline uint64_t hash_round(uint64_t acc, const uint64_t input)
+{
+   acc += input * HASH_PRIME_2;
+   acc = hash_rotl(acc, 31);
+   return acc * HASH_PRIME_1;
+}
+
+static inline uint64_t hash_merge_round(uint64_t acc, const uint64_t lane)
+{
+   acc ^= hash_round(0, lane);
+   return acc * HASH_PRIME_1 + HASH_PRIME_4;
+}
+
+/* consumes whole stripes from `p`, returns the pointer past the last one */
+static inline const unsigned char *hash_stripes(uint64_t *const restrict lanes, const unsigned char *restrict p, const unsigned char *const end)
+{
+   uint64_t v1 = lanes[0], v2 = lanes[1], v3 = lanes[2], v4 = lanes[3];
+   for (; p + HASH_STRIPE <= end; p += HASH_STRIPE)
+   {
+      v1 = hash_round(v1, hash_read64(p));
+      v2 = hash_round(v2, hash_read64(p + 8));
+      v3 = hash_round(v3, hash_read64(p + 16));
+      v4 = hash_round(v4, hash_read64(p + 24));
+   }
+   lanes[0] = v1; lanes[1] = v2; lanes[2] = v3; lanes[3] = v4;
+   return p;
+}
+
+
+static inline void hash_init(hash_state_s *const restrict state, const uint64_t seed)
+{
+   assert(state);
+   state->lanes[0] = seed + HASH_PRIME_1 + HASH_PRIME_2;
+   state->lanes[1] = seed + HASH_PRIME_2;
+   state->lanes[2] = seed;
+   state->lanes[3] = seed - HASH_PRIME_1;
+   state->seed = seed;
+   state->total_len = 0;
+   state->buffer_len = 0;
+}
+
+static inline void hash_update(hash_state_s *const restrict state, const void *const restrict data, const size_t size)
+{
+   assert(state);
+   assert(data || size == 0);
+   const unsigned char *p = (const unsigned char*)data;
+   const unsigned char *const end = p + size;
+   state->total_len += size;
+
+   if (state->buffer_len + size < HASH_STRIPE)
+   {
+      if (size)
+         memcpy(state->buffer + state->buffer_len, p, size);
+      state->buffer_len += size;
+      return;
+   }
+
+   if (state->buffer_len)
+   {
+      const size_t fill = HASH_STRIPE - state->buffer_len;
+      memcpy(state->buffer + state->buffer_len, p, fill);
+      hash_stripes(state->lanes, state->buffer, state->buffer + HASH_STRIPE);
+      p += fill;
+      state->buffer_len = 0;
+   }
+
+   p = hash_stripes(state->lanes, p, end);
+   state->buffer_len = (size_t)(end - p);
+   if (state->buffer_len)
+      memcpy(state->buffer, p, state->buffer_len);
+}
+
+static inline uint64_t hash_final(const hash_state_s *const restrict state)
+{
+   assert(state);
+   uint64_t h;
+   if (state->total_len >= HASH_STRIPE)
+   {
+      const uint64_t *const v = state->lanes;
+      h = hash_rotl(v[0], 1) + hash_rotl(v[1], 7) + hash_rotl(v[2], 12) + hash_rotl(v[3], 18);
+      h = hash_merge_round(h, v[0]);
+      h = hash_merge_round(h, v[1]);
+      h = hash_merge_round(h, v[2]);
+      h = hash_merge_round(h, v[3]);
+   }
+   else
+      h = state->seed + HASH_PRIME_5;
+   h += state->total_len;
+
+   const unsigned char *p = state->buffer;
+   const unsigned char *const end = p + state->buffer_len;
+   for (; p + 8 <= end; p += 8)
+   {
+      h ^= hash_round(0, hash_read64(p));
+      h = hash_rotl(h, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+   }
+   if (p + 4 <= end)
+   {
+      h ^= (uint64_t)hash_read32(p) * HASH_PRIME_1;
+      h = hash_rotl(h, 23) * HASH_PRIME_2 + HASH_PRIME_3;
+      p += 4;
+   }
+   for (; p < end; p++)
+   {
+      h ^= (uint64_t)(*p) * HASH_PRIME_5;
+      h = hash_rotl(h, 11) * HASH_PRIME_1;
+   }
+
+   h ^= h >> 33;
+   h *= HASH_PRIME_2;
+   h ^= h >> 29;
+   h *= HASH_PRIME_3;
+   h ^= h >> 32;
+   return h;
+}
+
+static inline uint64_t hash_bytes(const void *const restrict data, const size_t size, const uint64_t seed)
+{
+   hash_state_s state;
+   hash_init(&state, seed);
+   hash_update(&state, data, size);
+   return hash_final(&state);
+}
+
+
+#endif /* __HASH_H */
\ No newline at end of file
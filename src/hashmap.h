@@ -0,0 +1,541 @@
+#ifndef __HASHMAP_H
+#define __HASHMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "static-assert.h"
+
+
+/**
+ * Hashmap control bytes
+ * ---------------------
+ * Open addressing in the Swiss table style: every slot has one control byte,
+ * and lookups compare a whole group of control bytes at once.
+ *
+ *   HASHMAP_EMPTY   (0x80) - unused since the last rehash, ends a probe
+ *   HASHMAP_DELETED (0xFE) - tombstone, probing continues past it
+ *   0x00 .. 0x7F           - full, holds h2 (the low 7 bits of the hash)
+ *
+ * Group probing (HASHMAP_GROUP_WIDTH control bytes per step):
+ *   - SSE2: one 16-byte compare + movemask per group.
+ *   - Otherwise: scalar loop building the same 16-bit mask.
+ *
+ * Notes:
+ *   The first HASHMAP_GROUP_WIDTH control bytes are mirrored after the last
+ *   one, so a group load starting anywhere in the table never wraps.
+ *   Groups are probed quadratically from h1 (the hash without its low 7
+ *   bits), which visits every group of a power-of-two table.
+ */
+#define HASHMAP_GROUP_WIDTH 16
+#define HASHMAP_EMPTY ((int8_t)-128)
+#define HASHMAP_DELETED ((int8_t)-2)
+
+/* smallest table allocated, in slots */
+#ifndef HASHMAP_MIN_CAPACITY
+   #define HASHMAP_MIN_CAPACITY 16
+#endif
+
+static_assert(HASHMAP_MIN_CAPACITY >= HASHMAP_GROUP_WIDTH, "Warning: HASHMAP_MIN_CAPACITY too small");
+static_assert((HASHMAP_MIN_CAPACITY & (HASHMAP_MIN_CAPACITY - 1)) == 0, "Warning: HASHMAP_MIN_CAPACITY must be a power of 2");
+
+// SSE2
+#if defined(__SSE2__)
+   #include <emmintrin.h>
+
+   /* bit i set when ctrl[i] == byte */
+   static inline uint32_t hashmap_group_match(const int8_t *const restrict ctrl, const int8_t byte)
+   {
+      const __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+      return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+   }
+
+   /* bit i set when ctrl[i] is empty or deleted (sign bit set) */
+   static inline uint32_t hashmap_group_match_free(const int8_t *const restrict ctrl)
+   {
+      return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+   }
+
+// Scalar
+#else
+   static inline uint32_t hashmap_group_match(const int8_t *const restrict ctrl, const int8_t byte)
+   {
+      uint32_t mask = 0;
+      for (uint32_t i = 0; i < HASHMAP_GROUP_WIDTH; i++)
+         mask |= (uint32_t)(ctrl[i] == byte) << i;
+      return mask;
+   }
+
+   static inline uint32_t hashmap_group_match_free(const int8_t *const restrict ctrl)
+   {
+      uint32_t mask = 0;
+      for (uint32_t i = 0; i < HASHMAP_GROUP_WIDTH; i++)
+         mask |= (uint32_t)(ctrl[i] < 0) << i;
+      return mask;
+   }
+
+#endif
+
+/* index of the lowest set bit, mask != 0 */
+static inline uint32_t hashmap_ctz(const uint32_t mask)
+{
+   assert(mask);
+#if defined(__GNUC__) || defined(__clang__)
+   return (uint32_t)__builtin_ctz(mask);
+#else
+   uint32_t n = 0;
+   while (!((mask >> n) & 1))
+      n++;
+   return n;
+#endif
+}
+
+/* zero bits above the highest set bit of a 16-bit group mask, mask != 0 */
+static inline uint32_t hashmap_clz16(const uint32_t mask)
+{
+   assert(mask && mask <= 0xFFFF);
+#if defined(__GNUC__) || defined(__clang__)
+   return (uint32_t)__builtin_clz(mask) - 16;
+#else
+   uint32_t n = 0;
+   while (!((mask << n) & 0x8000))
+      n++;
+   return n;
+#endif
+}
+
+static inline size_t hashmap_h1(const uint64_t hash)
+{
+   return (size_t)(hash >> 7);
+}
+
+static inline int8_t hashmap_h2(const uint64_t hash)
+{
+   return (int8_t)(hash & 0x7F);
+}
+
+/* slots that may be used before a rehash (7/8 load) */
+static inline size_t hashmap_max_load(const size_t capacity)
+{
+   return capacity - capacity / 8;
+}
+
+/* writes ctrl[i] and its mirror */
+static inline void hashmap_set_ctrl(int8_t *const restrict ctrl, const size_t capacity, const size_t i, const int8_t byte)
+{
+   ctrl[i] = byte;
+   if (i < HASHMAP_GROUP_WIDTH)
+      ctrl[capacity + i] = byte;
+}
+
+/* frees full slot i: empty if no probe can have passed over it, else a tombstone; true if emptied */
+static inline bool hashmap_erase_ctrl(int8_t *const restrict ctrl, const size_t capacity, const size_t i)
+{
+   /* no probe passed this slot if the group-wide window around it has an empty byte */
+   const size_t before = (i - HASHMAP_GROUP_WIDTH) & (capacity - 1);
+   const uint32_t empty_after = hashmap_group_match(ctrl + i, HASHMAP_EMPTY);
+   const uint32_t empty_before = hashmap_group_match(ctrl + before, HASHMAP_EMPTY);
+   const bool never_full = empty_before && empty_after && hashmap_ctz(empty_after) + hashmap_clz16(empty_before) < HASHMAP_GROUP_WIDTH;
+
+   hashmap_set_ctrl(ctrl, capacity, i, never_full ? HASHMAP_EMPTY : HASHMAP_DELETED);
+   return never_full;
+}
+
+/* first empty or deleted slot on the probe sequence of `hash` */
+static inline size_t hashmap_find_free(const int8_t *const restrict ctrl, const size_t capacity, const uint64_t hash)
+{
+   const size_t mask = capacity - 1;
+   size_t pos = hashmap_h1(hash) & mask;
+   for (size_t step = HASHMAP_GROUP_WIDTH;; step += HASHMAP_GROUP_WIDTH)
+   {
+      const uint32_t free_slots = hashmap_group_match_free(ctrl + pos);
+      if (free_slots)
+         return (pos + hashmap_ctz(free_slots)) & mask;
+      pos = (pos + step) & mask;
+   }
+}
+
+
+/**
+ * DEFINE_HASHMAP macro
+ * --------------------
+ * Defines a generic hash map type from `key_type` to `value_type`.
+ *
+ * Parameters:
+ *   key_type   - Type of the keys
+ *   value_type - Type of the values
+ *   len_type   - Unsigned integer type used for length/capacity
+ *
+ * Output:
+ *   Declaration of hashmap for key_type -> value_type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_HASHMAP(...), Ensure macro arguments match
+ */
+#define DEFINE_HASHMAP(key_type, value_type, len_type) \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   key_type key; \
+   value_type value; \
+} key_type##_##value_type##_hashmap_entry_s; \
+\
+typedef struct \
+{ \
+   int8_t *ctrl; \
+   key_type##_##value_type##_hashmap_entry_s *entries; \
+   len_type len; \
+   len_type capacity; \
+   len_type growth_left; \
+} key_type##_##value_type##_hashmap_s; \
+\
+static inline void key_type##_##value_type##_hashmap_init(key_type##_##value_type##_hashmap_s *const restrict map) \
+{ \
+   map->ctrl = NULL; \
+   map->entries = NULL; \
+   map->len = 0; \
+   map->capacity = 0; \
+   map->growth_left = 0; \
+} \
+\
+bool key_type##_##value_type##_hashmap_reserve(key_type##_##value_type##_hashmap_s *const restrict, const len_type); \
+void key_type##_##value_type##_hashmap_clear(key_type##_##value_type##_hashmap_s *const restrict); \
+void key_type##_##value_type##_hashmap_delete(key_type##_##value_type##_hashmap_s *const restrict); \
+bool key_type##_##value_type##_hashmap_insert(key_type##_##value_type##_hashmap_s *const restrict, const key_type, const value_type); \
+value_type *key_type##_##value_type##_hashmap_get(const key_type##_##value_type##_hashmap_s *const restrict, const key_type); \
+bool key_type##_##value_type##_hashmap_remove(key_type##_##value_type##_hashmap_s *const restrict, const key_type); \
+len_type key_type##_##value_type##_hashmap_next(const key_type##_##value_type##_hashmap_s *const restrict, len_type);
+
+
+/**
+ * hashmap(key_type, value_type) macro
+ * -----------------------------------
+ * Declares a hashmap variable of the given key and value types.
+ *
+ * Usage (as variable):
+ *   hashmap(int, double) m;
+ *
+ * Usage (as parameter):
+ *   void process_map(hashmap(int, double) *const m) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (key_type##_##value_type##_hashmap_s).
+ */
+#define hashmap(key_type, value_type) \
+   key_type##_##value_type##_hashmap_s
+
+
+/**
+ * typecheck_hashmap_ptr macro
+ * ---------------------------
+ * Compile-time validation that 'var' is a pointer to a hashmap of
+ * 'key_type' -> 'value_type' (see typecheck_ptr).
+ */
+#define typecheck_hashmap_ptr(var, key_type, value_type, expr) \
+   typecheck_ptr(var, key_type##_##value_type##_hashmap_s, expr)
+
+
+/**
+ * Hashmap Expression Macros
+ * -------------------------
+ * Direct access to hashmap properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   if (!hashmap_empty(int, double, &m))
+ *      printf("%zu of %zu slots used\n", hashmap_len(int, double, &m), hashmap_capacity(int, double, &m));
+ */
+#define hashmap_len(key_type, value_type, map) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      (map)->len \
+   )
+
+#define hashmap_capacity(key_type, value_type, map) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      (map)->capacity \
+   )
+
+#define hashmap_empty(key_type, value_type, map) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      (map)->len == 0 \
+   )
+
+
+/**
+ * GENERATE_HASHMAP macro
+ * ----------------------
+ * Implements the hashmap functions for a key/value type pair.
+ *
+ * Parameters:
+ *   key_type   - Key type
+ *   value_type - Value type
+ *   len_type   - Unsigned integer type for length & capacity
+ *   hash_fn    - uint64_t (key_type), e.g. hash_bytes(&key, sizeof(key), seed)
+ *   equal_fn   - bool (key_type, key_type)
+ *   alloc_fn   - Allocator for the table
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - The table is one allocation: capacity + HASHMAP_GROUP_WIDTH control
+ *     bytes followed by capacity entries. An initialised map owns nothing
+ *     until the first insert or reserve.
+ *   - Capacity is a power of two (at least HASHMAP_MIN_CAPACITY), filled to
+ *     at most 7/8 counting tombstones. When that budget runs out the table
+ *     is rebuilt: twice as large if at least half of the budget holds live
+ *     entries, otherwise at the same size to drop tombstones.
+ *   - remove() leaves an empty slot instead of a tombstone when no probe can
+ *     have passed over it (an empty control byte lies within one group).
+ *   - insert() overwrites the value of an existing key; get() returns a
+ *     pointer to the stored value or NULL, valid until the next insert,
+ *     reserve or delete.
+ *   - insert() and reserve() return false if allocation fails (map left
+ *     unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_HASHMAP(...), Ensure macro arguments match
+ *    hash_fn should mix all 64 bits: h2 comes from the low 7 bits and
+ *    the probe start from the rest.
+ */
+#define GENERATE_HASHMAP(key_type, value_type, len_type, hash_fn, equal_fn, alloc_fn, free_fn) \
+   assert_istype(key_type); \
+   assert_istype(value_type); \
+   assert_istype(len_type); \
+   assert_type(hash_fn, uint64_t (key_type)); \
+   assert_type(equal_fn, bool (key_type, key_type)); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+/* slot holding `key`, or capacity */ \
+static inline size_t key_type##_##value_type##_hashmap_find(const key_type##_##value_type##_hashmap_s *const restrict map, const key_type key, const uint64_t hash) \
+{ \
+   const size_t mask = (size_t)map->capacity - 1; \
+   const int8_t h2 = hashmap_h2(hash); \
+   size_t pos = hashmap_h1(hash) & mask; \
+   for (size_t step = HASHMAP_GROUP_WIDTH;; step += HASHMAP_GROUP_WIDTH) \
+   { \
+      const int8_t *const group = map->ctrl + pos; \
+      for (uint32_t match = hashmap_group_match(group, h2); match; match &= match - 1) \
+      { \
+         const size_t i = (pos + hashmap_ctz(match)) & mask; \
+         if (equal_fn(map->entries[i].key, key)) \
+            return i; \
+      } \
+      if (hashmap_group_match(group, HASHMAP_EMPTY)) \
+         return map->capacity; \
+      pos = (pos + step) & mask; \
+   } \
+} \
+\
+static bool key_type##_##value_type##_hashmap_rehash(key_type##_##value_type##_hashmap_s *const restrict map, const size_t capacity) \
+{ \
+   assert(capacity >= HASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0); \
+   const size_t ctrl_bytes = capacity + HASHMAP_GROUP_WIDTH; /* a multiple of 16: entries stay aligned */ \
+   unsigned char *const block = (unsigned char*)alloc_fn(ctrl_bytes + sizeof(key_type##_##value_type##_hashmap_entry_s) * capacity); \
+   if (!block) \
+      return false; \
+\
+   int8_t *const ctrl = (int8_t*)block; \
+   key_type##_##value_type##_hashmap_entry_s *const entries = (key_type##_##value_type##_hashmap_entry_s*)(block + ctrl_bytes); \
+   memset(ctrl, HASHMAP_EMPTY, ctrl_bytes); \
+   for (size_t i = 0; i < map->capacity; i++) \
+   { \
+      if (map->ctrl[i] < 0) \
+         continue; \
+      const uint64_t hash = hash_fn(map->entries[i].key); \
+      const size_t slot = hashmap_find_free(ctrl, capacity, hash); \
+      hashmap_set_ctrl(ctrl, capacity, slot, hashmap_h2(hash)); \
+      entries[slot] = map->entries[i]; \
+   } \
+\
+   if (map->ctrl) \
+      free_fn(map->ctrl); \
+   map->ctrl = ctrl; \
+   map->entries = entries; \
+   map->capacity = (len_type)capacity; \
+   map->growth_left = (len_type)(hashmap_max_load(capacity) - map->len); \
+   return true; \
+} \
+\
+bool key_type##_##value_type##_hashmap_reserve(key_type##_##value_type##_hashmap_s *const restrict map, const len_type len) \
+{ \
+   assert(map); \
+   size_t capacity = HASHMAP_MIN_CAPACITY; \
+   while (hashmap_max_load(capacity) < len) \
+   { \
+      if (capacity > (len_type)(-1) / 2) /* Prevent overflow */ \
+         return false; \
+      capacity *= 2; \
+   } \
+   if (capacity <= map->capacity) \
+      return true; \
+   return key_type##_##value_type##_hashmap_rehash(map, capacity); \
+} \
+\
+void key_type##_##value_type##_hashmap_clear(key_type##_##value_type##_hashmap_s *const restrict map) \
+{ \
+   assert(map); \
+   if (!map->ctrl) \
+      return; \
+   memset(map->ctrl, HASHMAP_EMPTY, (size_t)map->capacity + HASHMAP_GROUP_WIDTH); \
+   map->len = 0; \
+   map->growth_left = (len_type)hashmap_max_load(map->capacity); \
+} \
+\
+void key_type##_##value_type##_hashmap_delete(key_type##_##value_type##_hashmap_s *const restrict map) \
+{ \
+   assert(map); \
+   if (map->ctrl) \
+      free_fn(map->ctrl); \
+   key_type##_##value_type##_hashmap_init(map); \
+} \
+\
+bool key_type##_##value_type##_hashmap_insert(key_type##_##value_type##_hashmap_s *const restrict map, const key_type key, const value_type value) \
+{ \
+   assert(map); \
+   const uint64_t hash = hash_fn(key); \
+   if (map->capacity) \
+   { \
+      const size_t found = key_type##_##value_type##_hashmap_find(map, key, hash); \
+      if (found < map->capacity) \
+      { \
+         map->entries[found].value = value; \
+         return true; \
+      } \
+   } \
+\
+   size_t slot = map->capacity ? hashmap_find_free(map->ctrl, map->capacity, hash) : 0; \
+   if (!map->capacity || (map->growth_left == 0 && map->ctrl[slot] == HASHMAP_EMPTY)) \
+   { \
+      size_t capacity = map->capacity ? map->capacity : HASHMAP_MIN_CAPACITY; \
+      if (map->len >= hashmap_max_load(capacity) / 2) \
+      { \
+         if (map->capacity > (len_type)(-1) / 2) /* Prevent overflow */ \
+            return false; \
+         capacity = map->capacity * 2; \
+      } \
+      if (!key_type##_##value_type##_hashmap_rehash(map, capacity)) \
+         return false; \
+      slot = hashmap_find_free(map->ctrl, map->capacity, hash); \
+   } \
+\
+   map->growth_left -= (map->ctrl[slot] == HASHMAP_EMPTY); \
+   hashmap_set_ctrl(map->ctrl, map->capacity, slot, hashmap_h2(hash)); \
+   map->entries[slot].key = key; \
+   map->entries[slot].value = value; \
+   map->len++; \
+   return true; \
+} \
+\
+value_type *key_type##_##value_type##_hashmap_get(const key_type##_##value_type##_hashmap_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   if (map->len == 0) \
+      return NULL; \
+   const size_t found = key_type##_##value_type##_hashmap_find(map, key, hash_fn(key)); \
+   return (found < map->capacity) ? &map->entries[found].value : NULL; \
+} \
+\
+bool key_type##_##value_type##_hashmap_remove(key_type##_##value_type##_hashmap_s *const restrict map, const key_type key) \
+{ \
+   assert(map); \
+   if (map->len == 0) \
+      return false; \
+   const size_t found = key_type##_##value_type##_hashmap_find(map, key, hash_fn(key)); \
+   if (found == map->capacity) \
+      return false; \
+\
+   map->growth_left += hashmap_erase_ctrl(map->ctrl, map->capacity, found); \
+   map->len--; \
+   return true; \
+} \
+\
+len_type key_type##_##value_type##_hashmap_next(const key_type##_##value_type##_hashmap_s *const restrict map, len_type index) \
+{ \
+   assert(map); \
+   while (index < map->capacity) \
+   { \
+      const uint32_t full = ~hashmap_group_match_free(map->ctrl + index) & 0xFFFF; \
+      if (full) \
+      { \
+         const size_t i = (size_t)index + hashmap_ctz(full); \
+         return (i < map->capacity) ? (len_type)i : map->capacity; \
+      } \
+      index += HASHMAP_GROUP_WIDTH; \
+   } \
+   return map->capacity; \
+}
+
+
+/**
+ * Hashmap function macros
+ * -----------------------
+ * Type-generic wrappers for the functions generated by GENERATE_HASHMAP.
+ *
+ * Usage:
+ *   hashmap(int, double) m;
+ *   hashmap_init(int, double, &m);
+ *   hashmap_insert(int, double, &m, 7, 0.5);         // false on allocation failure
+ *   double *v = hashmap_get(int, double, &m, 7);     // NULL if absent
+ *   if (hashmap_contains(int, double, &m, 7))
+ *      hashmap_remove(int, double, &m, 7);
+ *
+ *   // iterate the slots in table order
+ *   for (size_t i = hashmap_next(int, double, &m, 0); i < m.capacity; i = hashmap_next(int, double, &m, i + 1))
+ *      use(m.entries[i].key, m.entries[i].value);
+ *
+ *   hashmap_delete(int, double, &m);
+ */
+#define hashmap_init(key_type, value_type, map) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_init((map)) \
+   )
+
+#define hashmap_reserve(key_type, value_type, map, len) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_reserve((map), (len)) \
+   )
+
+#define hashmap_clear(key_type, value_type, map) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_clear((map)) \
+   )
+
+#define hashmap_delete(key_type, value_type, map) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_delete((map)) \
+   )
+
+#define hashmap_insert(key_type, value_type, map, key, value) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_insert((map), (key), (value)) \
+   )
+
+#define hashmap_get(key_type, value_type, map, key) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_get((map), (key)) \
+   )
+
+#define hashmap_contains(key_type, value_type, map, key) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      (key_type##_##value_type##_hashmap_get((map), (key)) != NULL) \
+   )
+
+#define hashmap_remove(key_type, value_type, map, key) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_remove((map), (key)) \
+   )
+
+#define hashmap_next(key_type, value_type, map, index) \
+   typecheck_hashmap_ptr(map, key_type, value_type, \
+      key_type##_##value_type##_hashmap_next((map), (index)) \
+   )
+
+
+#endif /* __HASHMAP_H */
\ No newline at end of file
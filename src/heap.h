@@ -0,0 +1,302 @@
+#ifndef __HEAP_H
+#define __HEAP_H
+
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "stack.h"
+
+
+/**
+ * DEFINE_HEAP macro
+ * -----------------
+ * Defines a d-ary min-heap (priority queue) type stored in a stack of the
+ * same element type, so it shares the stack's inline buffer and growth.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the heap
+ *   len_type - Integer type used for length/size (the stack's len_type)
+ *
+ * Output:
+ *   Declaration of heap for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(type, len_type, ...)
+ *    Use in combination with GENERATE_HEAP(...), Ensure macro arguments match
+ */
+#define DEFINE_HEAP(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   type##_stack_s stack; \
+} type##_heap_s; \
+\
+static inline void type##_heap_init(type##_heap_s *const restrict heap) \
+{ \
+   type##_stack_init(&heap->stack); \
+} \
+\
+static inline void type##_heap_delete(type##_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   type##_stack_delete(&heap->stack); \
+} \
+\
+static inline type type##_heap_peek(const type##_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->stack.len > 0); \
+   return heap->stack.values[0]; \
+} \
+\
+bool type##_heap_push(type##_heap_s *const restrict, const type); \
+bool type##_heap_pop(type##_heap_s *const restrict); \
+type type##_heap_push_pop(type##_heap_s *const restrict, const type); \
+bool type##_heap_heapify(type##_heap_s *const restrict, const type *const restrict, const len_type);
+
+
+/**
+ * heap(type) macro
+ * ----------------
+ * Declares a heap variable of the given type.
+ *
+ * Usage (as variable):
+ *   heap(int) h;
+ *
+ * Usage (as parameter):
+ *   void process_heap(heap(int) *const h) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying heap struct type (type##_heap_s).
+ */
+#define heap(type) \
+   type##_heap_s
+
+
+/**
+ * typecheck_heap_ptr macro
+ * ------------------------
+ * Compile-time validation that 'var' is a pointer to a heap of 'type'
+ * (see typecheck_ptr).
+ */
+#define typecheck_heap_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_heap_s, expr)
+
+
+/**
+ * Heap Expression Macros
+ * ----------------------
+ * Direct access to heap properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   while (!heap_empty(int, &h))
+ *   {
+ *      use(heap_peek(int, &h));
+ *      heap_pop(int, &h);
+ *   }
+ */
+#define heap_len(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      (heap)->stack.len \
+   )
+
+#define heap_size(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      (heap)->stack.size \
+   )
+
+#define heap_empty(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      (heap)->stack.len == 0 \
+   )
+
+#define heap_clear(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      (heap)->stack.len = 0 \
+   )
+
+
+/**
+ * GENERATE_HEAP macro
+ * -------------------
+ * Implements the heap functions for a type.
+ *
+ * Parameters:
+ *   type       - Element type
+ *   len_type   - Unsigned integer type for length & size
+ *   arity      - Children per node: 2 (binary) or 4 (4-ary)
+ *   compare_fn - int (const type*, const type*), qsort-style; the smallest
+ *                element is on top
+ *
+ * Behavior:
+ *   - push(value): appends through the stack (validation, growth) and
+ *     sifts up; false if the stack cannot grow.
+ *   - pop(): removes the top; false when empty.
+ *   - push_pop(value): push followed by pop in one sift, returns the
+ *     removed element (value itself when it is not larger than the top).
+ *   - heapify(values, n): appends n elements (each validated in debug
+ *     builds) and rebuilds the heap bottom up in O(len); false if the
+ *     stack cannot grow (heap unchanged).
+ *   - Sifts move a hole instead of swapping, so every level costs one copy.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(type, len_type, ...)
+ *    Use in combination with DEFINE_HEAP(...), Ensure macro arguments match
+ *    A 4-ary heap is half as deep: pushes do fewer levels and pops scan
+ *    four children that usually share a cache line.
+ */
+#define GENERATE_HEAP(type, len_type, arity, compare_fn) \
+   static_assert((arity) == 2 || (arity) == 4, "Warning: arity must be 2 or 4"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(compare_fn, int (const type*, const type*)); \
+\
+static inline void type##_heap_sift_up(type *const restrict values, len_type i, const type value) \
+{ \
+   while (i > 0) \
+   { \
+      const len_type parent = (i - 1) / (arity); \
+      if (compare_fn(&value, &values[parent]) >= 0) \
+         break; \
+      values[i] = values[parent]; \
+      i = parent; \
+   } \
+   values[i] = value; \
+} \
+\
+static inline void type##_heap_sift_down(type *const restrict values, const len_type len, len_type i, const type value) \
+{ \
+   for (;;) \
+   { \
+      if (len < 2 || i > (len - 2) / (arity)) /* leaf; also keeps i * arity + 1 within len_type */ \
+         break; \
+      const len_type first = i * (arity) + 1; \
+      len_type child = first; \
+      if (len - first >= (arity)) /* full node: fixed trip count, unrolled into selects */ \
+      { \
+         for (len_type c = first + 1; c < first + (arity); c++) \
+            child = (compare_fn(&values[c], &values[child]) < 0) ? c : child; \
+      } \
+      else \
+      { \
+         for (len_type c = first + 1; c < len; c++) \
+            child = (compare_fn(&values[c], &values[child]) < 0) ? c : child; \
+      } \
+      if (compare_fn(&values[child], &value) >= 0) \
+         break; \
+      values[i] = values[child]; \
+      i = child; \
+   } \
+   values[i] = value; \
+} \
+\
+bool type##_heap_push(type##_heap_s *const restrict heap, const type value) \
+{ \
+   assert(heap); \
+   if (!type##_stack_push(&heap->stack, value)) \
+      return false; \
+   type##_heap_sift_up(heap->stack.values, heap->stack.len - 1, value); \
+   return true; \
+} \
+\
+bool type##_heap_pop(type##_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->stack.len == 0) \
+      return false; \
+\
+   const len_type len = --heap->stack.len; \
+   if (len > 0) \
+      type##_heap_sift_down(heap->stack.values, len, 0, heap->stack.values[len]); \
+   return true; \
+} \
+\
+type type##_heap_push_pop(type##_heap_s *const restrict heap, const type value) \
+{ \
+   assert(heap); \
+   if (heap->stack.len == 0 || compare_fn(&value, &heap->stack.values[0]) <= 0) \
+      return value; \
+\
+   const type top = heap->stack.values[0]; \
+   type##_heap_sift_down(heap->stack.values, heap->stack.len, 0, value); \
+   return top; \
+} \
+\
+bool type##_heap_heapify(type##_heap_s *const restrict heap, const type *const restrict values, const len_type n) \
+{ \
+   assert(heap); \
+   assert(values || n == 0); \
+   if ((len_type)(heap->stack.len + n) < heap->stack.len) /* Prevent overflow */ \
+      return false; \
+   while (heap->stack.size - heap->stack.len < n) \
+      if (!type##_stack_resize(&heap->stack)) \
+         return false; \
+\
+   assert(type##_stack_valid_n(values, n)); \
+   MEMORY_COPY(heap->stack.values + heap->stack.len, values, sizeof(type) * n); \
+   heap->stack.len += n; \
+\
+   const len_type len = heap->stack.len; \
+   if (len < 2) \
+      return true; \
+   for (len_type i = (len - 2) / (arity) + 1; i-- > 0;) \
+      type##_heap_sift_down(heap->stack.values, len, i, heap->stack.values[i]); \
+   return true; \
+}
+
+
+/**
+ * Heap function macros
+ * --------------------
+ * Type-generic wrappers for the functions generated by GENERATE_HEAP.
+ *
+ * Usage:
+ *   heap(int) h;
+ *   heap_init(int, &h);
+ *   heap_heapify(int, &h, values, n);         // O(n) bulk build
+ *   heap_push(int, &h, 42);                   // false on allocation failure
+ *   int low = heap_peek(int, &h);             // smallest element
+ *   heap_pop(int, &h);
+ *   int out = heap_push_pop(int, &h, 7);      // push 7, then remove the smallest
+ *   heap_delete(int, &h);
+ */
+#define heap_init(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_init((heap)) \
+   )
+
+#define heap_delete(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_delete((heap)) \
+   )
+
+#define heap_peek(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_peek((heap)) \
+   )
+
+#define heap_push(type, heap, value) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_push((heap), (value)) \
+   )
+
+#define heap_pop(type, heap) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_pop((heap)) \
+   )
+
+#define heap_push_pop(type, heap, value) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_push_pop((heap), (value)) \
+   )
+
+#define heap_heapify(type, heap, values, n) \
+   typecheck_heap_ptr(heap, type, \
+      type##_heap_heapify((heap), (values), (n)) \
+   )
+
+
+#endif /* __HEAP_H */
\ No newline at end of file
@@ -0,0 +1,750 @@
+#ifndef __INDEXED_HEAP_H
+#define __INDEXED_HEAP_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+
+
+/**
+ * Indexed heap
+ * ------------
+ * A min-priority queue of dense integer IDs (0, 1, 2, ...) with one key per
+ * ID. Every queued ID can be found in O(1), so keys can be changed or the ID
+ * removed without pushing duplicates (e.g. Dijkstra's decrease-key).
+ *
+ * Layouts (chosen at compile time, same API):
+ *   - default: d-ary heap of { key, id } entries plus a position array
+ *     (id -> heap index).
+ *   - INDEXED_HEAP_PAIRING defined before including: pairing heap whose
+ *     nodes are the IDs themselves (child / next / prev arrays), with O(1)
+ *     push and decrease_key.
+ *
+ * Notes:
+ *   IDs index arrays directly, so capacity follows the largest ID pushed,
+ *   not the number of queued IDs. INDEXED_HEAP_NONE is not a valid ID.
+ */
+#define INDEXED_HEAP_NONE(len_type) ((len_type)-1)
+
+/* smallest number of IDs allocated */
+#ifndef INDEXED_HEAP_MIN_CAPACITY
+   #define INDEXED_HEAP_MIN_CAPACITY 16
+#endif
+
+static_assert(INDEXED_HEAP_MIN_CAPACITY >= 16, "Warning: INDEXED_HEAP_MIN_CAPACITY too small");
+static_assert((INDEXED_HEAP_MIN_CAPACITY & (INDEXED_HEAP_MIN_CAPACITY - 1)) == 0, "Warning: INDEXED_HEAP_MIN_CAPACITY must be a power of 2");
+
+
+/**
+ * DEFINE_INDEXED_HEAP macro
+ * -------------------------
+ * Defines an indexed min-heap type with keys of `type` and IDs of `len_type`.
+ *
+ * Parameters:
+ *   type     - Type of the keys
+ *   len_type - Unsigned integer type used for IDs, length and capacity
+ *
+ * Output:
+ *   Declaration of indexed heap for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_INDEXED_HEAP(...), Ensure macro arguments match
+ *    Define (or leave undefined) INDEXED_HEAP_PAIRING identically for both
+ */
+#if !defined(INDEXED_HEAP_PAIRING)
+
+#define DEFINE_INDEXED_HEAP(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   type key; \
+   len_type id; \
+} type##_indexed_heap_entry_s; \
+\
+typedef struct \
+{ \
+   type##_indexed_heap_entry_s *entries; /* heap order */ \
+   len_type *position; /* id -> index in entries, or INDEXED_HEAP_NONE */ \
+   len_type len; \
+   len_type capacity; \
+} type##_indexed_heap_s; \
+\
+static inline void type##_indexed_heap_init(type##_indexed_heap_s *const restrict heap) \
+{ \
+   heap->entries = NULL; \
+   heap->position = NULL; \
+   heap->len = 0; \
+   heap->capacity = 0; \
+} \
+\
+static inline bool type##_indexed_heap_contains(const type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   assert(heap); \
+   return id < heap->capacity && heap->position[id] != INDEXED_HEAP_NONE(len_type); \
+} \
+\
+static inline type type##_indexed_heap_key(const type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   assert(type##_indexed_heap_contains(heap, id)); \
+   return heap->entries[heap->position[id]].key; \
+} \
+\
+static inline len_type type##_indexed_heap_peek(const type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->len > 0); \
+   return heap->entries[0].id; \
+} \
+\
+static inline type type##_indexed_heap_peek_key(const type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->len > 0); \
+   return heap->entries[0].key; \
+} \
+\
+INDEXED_HEAP_DECLARE(type, len_type)
+
+#else
+
+#define DEFINE_INDEXED_HEAP(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   type *keys; /* id -> key */ \
+   len_type *child; /* id -> first child */ \
+   len_type *next; /* id -> next sibling */ \
+   len_type *prev; /* id -> previous sibling or parent, itself for the root, INDEXED_HEAP_NONE if not queued */ \
+   len_type root; \
+   len_type len; \
+   len_type capacity; \
+} type##_indexed_heap_s; \
+\
+static inline void type##_indexed_heap_init(type##_indexed_heap_s *const restrict heap) \
+{ \
+   heap->keys = NULL; \
+   heap->child = NULL; \
+   heap->next = NULL; \
+   heap->prev = NULL; \
+   heap->root = INDEXED_HEAP_NONE(len_type); \
+   heap->len = 0; \
+   heap->capacity = 0; \
+} \
+\
+static inline bool type##_indexed_heap_contains(const type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   assert(heap); \
+   return id < heap->capacity && heap->prev[id] != INDEXED_HEAP_NONE(len_type); \
+} \
+\
+static inline type type##_indexed_heap_key(const type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   assert(type##_indexed_heap_contains(heap, id)); \
+   return heap->keys[id]; \
+} \
+\
+static inline len_type type##_indexed_heap_peek(const type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->len > 0); \
+   return heap->root; \
+} \
+\
+static inline type type##_indexed_heap_peek_key(const type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->len > 0); \
+   return heap->keys[heap->root]; \
+} \
+\
+INDEXED_HEAP_DECLARE(type, len_type)
+
+#endif /* INDEXED_HEAP_PAIRING */
+
+/* functions generated by GENERATE_INDEXED_HEAP, for both layouts */
+#define INDEXED_HEAP_DECLARE(type, len_type) \
+bool type##_indexed_heap_reserve(type##_indexed_heap_s *const restrict, const len_type); \
+void type##_indexed_heap_clear(type##_indexed_heap_s *const restrict); \
+void type##_indexed_heap_delete(type##_indexed_heap_s *const restrict); \
+bool type##_indexed_heap_push(type##_indexed_heap_s *const restrict, const len_type, const type); \
+bool type##_indexed_heap_pop(type##_indexed_heap_s *const restrict); \
+bool type##_indexed_heap_decrease_key(type##_indexed_heap_s *const restrict, const len_type, const type); \
+bool type##_indexed_heap_increase_key(type##_indexed_heap_s *const restrict, const len_type, const type); \
+bool type##_indexed_heap_remove(type##_indexed_heap_s *const restrict, const len_type);
+
+
+/**
+ * indexed_heap(type) macro
+ * ------------------------
+ * Declares an indexed heap variable of the given key type.
+ *
+ * Usage (as variable):
+ *   indexed_heap(int) q;
+ *
+ * Usage (as parameter):
+ *   void relax(indexed_heap(int) *const q) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (type##_indexed_heap_s).
+ */
+#define indexed_heap(type) \
+   type##_indexed_heap_s
+
+
+/**
+ * typecheck_indexed_heap_ptr macro
+ * --------------------------------
+ * Compile-time validation that 'var' is a pointer to an indexed heap of
+ * 'type' (see typecheck_ptr).
+ */
+#define typecheck_indexed_heap_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_indexed_heap_s, expr)
+
+
+/**
+ * Indexed Heap Expression Macros
+ * ------------------------------
+ * Direct access to indexed heap properties, type-checked at compile-time
+ * (C11+) with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   if (!indexed_heap_empty(int, &q))
+ *      printf("%zu queued, IDs below %zu\n", indexed_heap_len(int, &q), indexed_heap_capacity(int, &q));
+ */
+#define indexed_heap_len(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      (heap)->len \
+   )
+
+#define indexed_heap_capacity(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      (heap)->capacity \
+   )
+
+#define indexed_heap_empty(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      (heap)->len == 0 \
+   )
+
+
+/**
+ * GENERATE_INDEXED_HEAP macro
+ * ---------------------------
+ * Implements the indexed heap functions for a key type.
+ *
+ * Parameters:
+ *   type       - Key type
+ *   len_type   - Unsigned integer type for IDs, length & capacity
+ *   arity      - Children per node of the d-ary layout: 2 or 4 (unused by
+ *                the pairing heap)
+ *   compare_fn - int (const type*, const type*), qsort-style; the smallest
+ *                key is on top
+ *   alloc_fn   - Allocator for the arrays
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - All per-ID arrays share one allocation of `capacity` IDs, a power of
+ *     two (at least INDEXED_HEAP_MIN_CAPACITY). push() grows it to cover the
+ *     ID; reserve(n) makes IDs below n usable without further allocation.
+ *   - push(id, key): false if the ID is already queued or allocation fails.
+ *   - pop(): removes the top ID; false when empty.
+ *   - decrease_key / increase_key(id, key): false if the ID is not queued.
+ *     The new key must not be larger (resp. smaller) than the current one.
+ *   - remove(id): false if the ID is not queued.
+ *   - d-ary: every operation is O(log n); entries carry their key, so sifts
+ *     never leave the entry array except to update positions.
+ *   - pairing: push and decrease_key are O(1), pop / remove / increase_key
+ *     are O(log n) amortised (two-pass pairing).
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_INDEXED_HEAP(...), Ensure macro arguments match
+ */
+#define INDEXED_HEAP_GENERATE_COMMON(type, len_type, arity, compare_fn, alloc_fn, free_fn) \
+   static_assert((arity) == 2 || (arity) == 4, "Warning: arity must be 2 or 4"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(compare_fn, int (const type*, const type*)); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_indexed_heap_reserve(type##_indexed_heap_s *const restrict heap, const len_type n) \
+{ \
+   assert(heap); \
+   size_t capacity = INDEXED_HEAP_MIN_CAPACITY; \
+   while (capacity < n) \
+   { \
+      if (capacity > (len_type)(-1) / 2) /* Prevent overflow */ \
+         return false; \
+      capacity *= 2; \
+   } \
+   if (capacity <= heap->capacity) \
+      return true; \
+   return type##_indexed_heap_resize(heap, capacity); \
+} \
+\
+/* makes `id` a valid index, growing the arrays if needed */ \
+static inline bool type##_indexed_heap_cover(type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   if (id < heap->capacity) \
+      return true; \
+   if (id == INDEXED_HEAP_NONE(len_type)) \
+      return false; \
+   return type##_indexed_heap_reserve(heap, id + 1); \
+}
+
+#if !defined(INDEXED_HEAP_PAIRING)
+
+#define GENERATE_INDEXED_HEAP(type, len_type, arity, compare_fn, alloc_fn, free_fn) \
+static bool type##_indexed_heap_resize(type##_indexed_heap_s *const restrict heap, const size_t capacity) \
+{ \
+   /* capacity is a multiple of 16, so the position array stays aligned */ \
+   unsigned char *const block = (unsigned char*)alloc_fn((sizeof(type##_indexed_heap_entry_s) + sizeof(len_type)) * capacity); \
+   if (!block) \
+      return false; \
+\
+   type##_indexed_heap_entry_s *const entries = (type##_indexed_heap_entry_s*)block; \
+   len_type *const position = (len_type*)(block + sizeof(type##_indexed_heap_entry_s) * capacity); \
+   if (heap->entries) \
+   { \
+      MEMORY_COPY(entries, heap->entries, sizeof(type##_indexed_heap_entry_s) * heap->len); \
+      MEMORY_COPY(position, heap->position, sizeof(len_type) * heap->capacity); \
+      free_fn(heap->entries); \
+   } \
+   MEMORY_SET(position + heap->capacity, 0xFF, sizeof(len_type) * (capacity - heap->capacity)); /* INDEXED_HEAP_NONE */ \
+\
+   heap->entries = entries; \
+   heap->position = position; \
+   heap->capacity = (len_type)capacity; \
+   return true; \
+} \
+\
+INDEXED_HEAP_GENERATE_COMMON(type, len_type, arity, compare_fn, alloc_fn, free_fn) \
+\
+static inline void type##_indexed_heap_sift_up(type##_indexed_heap_s *const restrict heap, len_type i, const type##_indexed_heap_entry_s entry) \
+{ \
+   type##_indexed_heap_entry_s *const entries = heap->entries; \
+   while (i > 0) \
+   { \
+      const len_type parent = (i - 1) / (arity); \
+      if (compare_fn(&entry.key, &entries[parent].key) >= 0) \
+         break; \
+      entries[i] = entries[parent]; \
+      heap->position[entries[i].id] = i; \
+      i = parent; \
+   } \
+   entries[i] = entry; \
+   heap->position[entry.id] = i; \
+} \
+\
+static inline void type##_indexed_heap_sift_down(type##_indexed_heap_s *const restrict heap, len_type i, const type##_indexed_heap_entry_s entry) \
+{ \
+   type##_indexed_heap_entry_s *const entries = heap->entries; \
+   const len_type len = heap->len; \
+   for (;;) \
+   { \
+      if (len < 2 || i > (len - 2) / (arity)) /* leaf; also keeps i * arity + 1 within len_type */ \
+         break; \
+      const len_type first = i * (arity) + 1; \
+      len_type child = first; \
+      if (len - first >= (arity)) /* full node: fixed trip count, unrolled into selects */ \
+      { \
+         for (len_type c = first + 1; c < first + (arity); c++) \
+            child = (compare_fn(&entries[c].key, &entries[child].key) < 0) ? c : child; \
+      } \
+      else \
+      { \
+         for (len_type c = first + 1; c < len; c++) \
+            child = (compare_fn(&entries[c].key, &entries[child].key) < 0) ? c : child; \
+      } \
+      if (compare_fn(&entries[child].key, &entry.key) >= 0) \
+         break; \
+      entries[i] = entries[child]; \
+      heap->position[entries[i].id] = i; \
+      i = child; \
+   } \
+   entries[i] = entry; \
+   heap->position[entry.id] = i; \
+} \
+\
+void type##_indexed_heap_clear(type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   for (len_type i = 0; i < heap->len; i++) \
+      heap->position[heap->entries[i].id] = INDEXED_HEAP_NONE(len_type); \
+   heap->len = 0; \
+} \
+\
+void type##_indexed_heap_delete(type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->entries) \
+      free_fn(heap->entries); \
+   type##_indexed_heap_init(heap); \
+} \
+\
+bool type##_indexed_heap_push(type##_indexed_heap_s *const restrict heap, const len_type id, const type key) \
+{ \
+   assert(heap); \
+   if (type##_indexed_heap_contains(heap, id) || !type##_indexed_heap_cover(heap, id)) \
+      return false; \
+   const type##_indexed_heap_entry_s entry = { .key = key, .id = id }; \
+   type##_indexed_heap_sift_up(heap, heap->len++, entry); \
+   return true; \
+} \
+\
+bool type##_indexed_heap_pop(type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->len == 0) \
+      return false; \
+\
+   heap->position[heap->entries[0].id] = INDEXED_HEAP_NONE(len_type); \
+   const len_type len = --heap->len; \
+   if (len > 0) \
+      type##_indexed_heap_sift_down(heap, 0, heap->entries[len]); \
+   return true; \
+} \
+\
+bool type##_indexed_heap_decrease_key(type##_indexed_heap_s *const restrict heap, const len_type id, const type key) \
+{ \
+   assert(heap); \
+   if (!type##_indexed_heap_contains(heap, id)) \
+      return false; \
+   const len_type i = heap->position[id]; \
+   assert(compare_fn(&key, &heap->entries[i].key) <= 0); \
+   const type##_indexed_heap_entry_s entry = { .key = key, .id = id }; \
+   type##_indexed_heap_sift_up(heap, i, entry); \
+   return true; \
+} \
+\
+bool type##_indexed_heap_increase_key(type##_indexed_heap_s *const restrict heap, const len_type id, const type key) \
+{ \
+   assert(heap); \
+   if (!type##_indexed_heap_contains(heap, id)) \
+      return false; \
+   const len_type i = heap->position[id]; \
+   assert(compare_fn(&key, &heap->entries[i].key) >= 0); \
+   const type##_indexed_heap_entry_s entry = { .key = key, .id = id }; \
+   type##_indexed_heap_sift_down(heap, i, entry); \
+   return true; \
+} \
+\
+bool type##_indexed_heap_remove(type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   assert(heap); \
+   if (!type##_indexed_heap_contains(heap, id)) \
+      return false; \
+\
+   const len_type i = heap->position[id]; \
+   heap->position[id] = INDEXED_HEAP_NONE(len_type); \
+   const len_type len = --heap->len; \
+   if (i == len) \
+      return true; \
+\
+   /* the last entry fills the hole and moves whichever way its key requires */ \
+   const type##_indexed_heap_entry_s last = heap->entries[len]; \
+   if (compare_fn(&last.key, &heap->entries[i].key) < 0) \
+      type##_indexed_heap_sift_up(heap, i, last); \
+   else \
+      type##_indexed_heap_sift_down(heap, i, last); \
+   return true; \
+}
+
+#else
+
+#define GENERATE_INDEXED_HEAP(type, len_type, arity, compare_fn, alloc_fn, free_fn) \
+static bool type##_indexed_heap_resize(type##_indexed_heap_s *const restrict heap, const size_t capacity) \
+{ \
+   /* capacity is a multiple of 16, so the link arrays stay aligned */ \
+   unsigned char *const block = (unsigned char*)alloc_fn((sizeof(type) + 3 * sizeof(len_type)) * capacity); \
+   if (!block) \
+      return false; \
+\
+   type *const keys = (type*)block; \
+   len_type *const child = (len_type*)(block + sizeof(type) * capacity); \
+   len_type *const next = child + capacity; \
+   len_type *const prev = next + capacity; \
+   if (heap->keys) \
+   { \
+      MEMORY_COPY(keys, heap->keys, sizeof(type) * heap->capacity); \
+      MEMORY_COPY(child, heap->child, sizeof(len_type) * heap->capacity); \
+      MEMORY_COPY(next, heap->next, sizeof(len_type) * heap->capacity); \
+      MEMORY_COPY(prev, heap->prev, sizeof(len_type) * heap->capacity); \
+      free_fn(heap->keys); \
+   } \
+   MEMORY_SET(prev + heap->capacity, 0xFF, sizeof(len_type) * (capacity - heap->capacity)); /* INDEXED_HEAP_NONE */ \
+\
+   heap->keys = keys; \
+   heap->child = child; \
+   heap->next = next; \
+   heap->prev = prev; \
+   heap->capacity = (len_type)capacity; \
+   return true; \
+} \
+\
+INDEXED_HEAP_GENERATE_COMMON(type, len_type, arity, compare_fn, alloc_fn, free_fn) \
+\
+/* links the larger of two roots as the first child of the smaller; returns the new root */ \
+static inline len_type type##_indexed_heap_meld(type##_indexed_heap_s *const restrict heap, len_type a, len_type b) \
+{ \
+   if (compare_fn(&heap->keys[b], &heap->keys[a]) < 0) \
+   { \
+      const len_type tmp = a; \
+      a = b; \
+      b = tmp; \
+   } \
+   const len_type first = heap->child[a]; \
+   heap->next[b] = first; \
+   if (first != INDEXED_HEAP_NONE(len_type)) \
+      heap->prev[first] = b; \
+   heap->prev[b] = a; \
+   heap->child[a] = b; \
+   return a; \
+} \
+\
+/* two-pass pairing of a sibling list: pairs left to right, then melds right to left */ \
+static len_type type##_indexed_heap_merge_pairs(type##_indexed_heap_s *const restrict heap, len_type a) \
+{ \
+   if (a == INDEXED_HEAP_NONE(len_type)) \
+      return a; \
+\
+   len_type pairs = INDEXED_HEAP_NONE(len_type); /* melded pairs, rightmost first, linked by next */ \
+   while (a != INDEXED_HEAP_NONE(len_type)) \
+   { \
+      const len_type b = heap->next[a]; \
+      if (b == INDEXED_HEAP_NONE(len_type)) \
+      { \
+         heap->next[a] = pairs; \
+         pairs = a; \
+         break; \
+      } \
+      const len_type rest = heap->next[b]; \
+      const len_type m = type##_indexed_heap_meld(heap, a, b); \
+      heap->next[m] = pairs; \
+      pairs = m; \
+      a = rest; \
+   } \
+\
+   len_type root = pairs; \
+   for (len_type p = heap->next[root]; p != INDEXED_HEAP_NONE(len_type);) \
+   { \
+      const len_type rest = heap->next[p]; \
+      root = type##_indexed_heap_meld(heap, root, p); \
+      p = rest; \
+   } \
+   return root; \
+} \
+\
+/* makes `id` (detached, with key set) part of the root list */ \
+static inline void type##_indexed_heap_link_root(type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   heap->root = (heap->root == INDEXED_HEAP_NONE(len_type)) ? id : type##_indexed_heap_meld(heap, heap->root, id); \
+   heap->next[heap->root] = INDEXED_HEAP_NONE(len_type); \
+   heap->prev[heap->root] = heap->root; \
+} \
+\
+/* unlinks a non-root node (and its subtree) from its parent or left sibling */ \
+static inline void type##_indexed_heap_detach(type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   const len_type p = heap->prev[id]; \
+   const len_type n = heap->next[id]; \
+   if (heap->child[p] == id) \
+      heap->child[p] = n; \
+   else \
+      heap->next[p] = n; \
+   if (n != INDEXED_HEAP_NONE(len_type)) \
+      heap->prev[n] = p; \
+} \
+\
+void type##_indexed_heap_clear(type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->prev) \
+      MEMORY_SET(heap->prev, 0xFF, sizeof(len_type) * heap->capacity); /* INDEXED_HEAP_NONE */ \
+   heap->root = INDEXED_HEAP_NONE(len_type); \
+   heap->len = 0; \
+} \
+\
+void type##_indexed_heap_delete(type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->keys) \
+      free_fn(heap->keys); \
+   type##_indexed_heap_init(heap); \
+} \
+\
+bool type##_indexed_heap_push(type##_indexed_heap_s *const restrict heap, const len_type id, const type key) \
+{ \
+   assert(heap); \
+   if (type##_indexed_heap_contains(heap, id) || !type##_indexed_heap_cover(heap, id)) \
+      return false; \
+   heap->keys[id] = key; \
+   heap->child[id] = INDEXED_HEAP_NONE(len_type); \
+   type##_indexed_heap_link_root(heap, id); \
+   heap->len++; \
+   return true; \
+} \
+\
+bool type##_indexed_heap_pop(type##_indexed_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->len == 0) \
+      return false; \
+\
+   const len_type top = heap->root; \
+   heap->root = type##_indexed_heap_merge_pairs(heap, heap->child[top]); \
+   if (heap->root != INDEXED_HEAP_NONE(len_type)) \
+   { \
+      heap->next[heap->root] = INDEXED_HEAP_NONE(len_type); \
+      heap->prev[heap->root] = heap->root; \
+   } \
+   heap->prev[top] = INDEXED_HEAP_NONE(len_type); \
+   heap->len--; \
+   return true; \
+} \
+\
+bool type##_indexed_heap_decrease_key(type##_indexed_heap_s *const restrict heap, const len_type id, const type key) \
+{ \
+   assert(heap); \
+   if (!type##_indexed_heap_contains(heap, id)) \
+      return false; \
+   assert(compare_fn(&key, &heap->keys[id]) <= 0); \
+   heap->keys[id] = key; \
+   if (id != heap->root) \
+   { \
+      type##_indexed_heap_detach(heap, id); \
+      type##_indexed_heap_link_root(heap, id); \
+   } \
+   return true; \
+} \
+\
+bool type##_indexed_heap_remove(type##_indexed_heap_s *const restrict heap, const len_type id) \
+{ \
+   assert(heap); \
+   if (!type##_indexed_heap_contains(heap, id)) \
+      return false; \
+   if (id == heap->root) \
+      return type##_indexed_heap_pop(heap); \
+\
+   type##_indexed_heap_detach(heap, id); \
+   const len_type sub = type##_indexed_heap_merge_pairs(heap, heap->child[id]); \
+   if (sub != INDEXED_HEAP_NONE(len_type)) \
+      type##_indexed_heap_link_root(heap, sub); \
+   heap->prev[id] = INDEXED_HEAP_NONE(len_type); \
+   heap->len--; \
+   return true; \
+} \
+\
+bool type##_indexed_heap_increase_key(type##_indexed_heap_s *const restrict heap, const len_type id, const type key) \
+{ \
+   assert(heap); \
+   if (!type##_indexed_heap_contains(heap, id)) \
+      return false; \
+   assert(compare_fn(&key, &heap->keys[id]) >= 0); \
+   type##_indexed_heap_remove(heap, id); \
+   return type##_indexed_heap_push(heap, id, key); /* cannot fail: id is covered and no longer queued */ \
+}
+
+#endif /* INDEXED_HEAP_PAIRING */
+
+
+/**
+ * Indexed heap function macros
+ * ----------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_INDEXED_HEAP.
+ *
+ * Usage (Dijkstra):
+ *   indexed_heap(uint32_t) q;
+ *   indexed_heap_init(uint32_t, &q);
+ *   indexed_heap_reserve(uint32_t, &q, vertex_count);   // false on allocation failure
+ *   indexed_heap_push(uint32_t, &q, source, 0);
+ *   while (!indexed_heap_empty(uint32_t, &q))
+ *   {
+ *      const size_t u = indexed_heap_peek(uint32_t, &q);
+ *      const uint32_t d = indexed_heap_peek_key(uint32_t, &q);
+ *      indexed_heap_pop(uint32_t, &q);
+ *      for (each edge u -> v with weight w)
+ *         if (d + w < dist[v])
+ *         {
+ *            dist[v] = d + w;
+ *            if (!indexed_heap_decrease_key(uint32_t, &q, v, d + w))
+ *               indexed_heap_push(uint32_t, &q, v, d + w);
+ *         }
+ *   }
+ *   indexed_heap_delete(uint32_t, &q);
+ */
+#define indexed_heap_init(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_init((heap)) \
+   )
+
+#define indexed_heap_reserve(type, heap, n) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_reserve((heap), (n)) \
+   )
+
+#define indexed_heap_clear(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_clear((heap)) \
+   )
+
+#define indexed_heap_delete(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_delete((heap)) \
+   )
+
+#define indexed_heap_contains(type, heap, id) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_contains((heap), (id)) \
+   )
+
+#define indexed_heap_key(type, heap, id) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_key((heap), (id)) \
+   )
+
+#define indexed_heap_peek(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_peek((heap)) \
+   )
+
+#define indexed_heap_peek_key(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_peek_key((heap)) \
+   )
+
+#define indexed_heap_push(type, heap, id, key) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_push((heap), (id), (key)) \
+   )
+
+#define indexed_heap_pop(type, heap) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_pop((heap)) \
+   )
+
+#define indexed_heap_decrease_key(type, heap, id, key) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_decrease_key((heap), (id), (key)) \
+   )
+
+#define indexed_heap_increase_key(type, heap, id, key) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_increase_key((heap), (id), (key)) \
+   )
+
+#define indexed_heap_remove(type, heap, id) \
+   typecheck_indexed_heap_ptr(heap, type, \
+      type##_indexed_heap_remove((heap), (id)) \
+   )
+
+
+#endif /* __INDEXED_HEAP_H */
@@ -2,6 +2,7 @@
 #define __MEMORY_COPY_H
 
 #include <stddef.h>
+#include <stdbool.h>
 
 /**
  * MEMORY_COPY macro
@@ -32,4 +33,292 @@
 
 #endif
 
+
+/**
+ * MEMORY_MOVE / MEMORY_SET macros
+ * -------------------------------
+ * Portable overlapping copy and byte fill with the same compiler hints as
+ * MEMORY_COPY.
+ *
+ * Usage:
+ *   MEMORY_MOVE(dest, src, size);   // dest and src may overlap
+ *   MEMORY_SET(dest, byte, size);
+ *
+ * Behavior:
+ *   - GCC, Clang: sizes that are compile-time constants of at most
+ *     MEMORY_SMALL_MAX (64) bytes go through a fixed size stack temporary,
+ *     which the compiler turns into register loads / stores; other sizes
+ *     use __builtin_memmove / __builtin_memset.
+ *   - MSVC, Pelles C: memmove / __stosb.
+ *   - Other: memmove / memset.
+ *
+ * Notes:
+ *   Each argument is evaluated once.
+ */
+#define MEMORY_SMALL_MAX 64
+
+// GCC, Clang
+#if defined(__GNUC__) || defined(__clang__)
+   /* all loads happen before any store, so overlap is fine */
+   __attribute__((always_inline))
+   static inline void memory_move_small(void *const dest, const void *const src, const size_t size)
+   {
+      unsigned char tmp[MEMORY_SMALL_MAX];
+      __builtin_memcpy(tmp, src, size);
+      __builtin_memcpy(dest, tmp, size);
+   }
+
+   __attribute__((always_inline))
+   static inline void memory_set_small(void *const dest, const int byte, const size_t size)
+   {
+      unsigned char tmp[MEMORY_SMALL_MAX];
+      __builtin_memset(tmp, byte, MEMORY_SMALL_MAX);
+      __builtin_memcpy(dest, tmp, size);
+   }
+
+   /* inlined, so `size` is still a constant when the caller passed one, and is evaluated once */
+   __attribute__((always_inline))
+   static inline void memory_move(void *const dest, const void *const src, const size_t size)
+   {
+      if (__builtin_constant_p(size) && size <= MEMORY_SMALL_MAX)
+         memory_move_small(dest, src, size);
+      else
+         __builtin_memmove(dest, src, size);
+   }
+
+   __attribute__((always_inline))
+   static inline void memory_set(void *const dest, const int byte, const size_t size)
+   {
+      if (__builtin_constant_p(size) && size <= MEMORY_SMALL_MAX)
+         memory_set_small(dest, byte, size);
+      else
+         __builtin_memset(dest, byte, size);
+   }
+
+   #define MEMORY_MOVE(dest, src, size) memory_move(dest, src, size)
+   #define MEMORY_SET(dest, byte, size) memory_set(dest, byte, size)
+
+// MSVC, Pelles C
+#elif defined(_MSC_VER) || defined(__POCC__)
+   #include <string.h>
+   #define MEMORY_MOVE(dest, src, size) memmove(dest, src, size)
+   #define MEMORY_SET(dest, byte, size) __stosb((unsigned char*)(dest), (unsigned char)(byte), size)
+
+// Other
+#else
+   #include <string.h>
+   #define MEMORY_MOVE(dest, src, size) memmove(dest, src, size)
+   #define MEMORY_SET(dest, byte, size) memset(dest, byte, size)
+
+#endif
+
+
+/**
+ * MEMORY_FILL macro
+ * -----------------
+ * Sets `n` consecutive elements of `type` starting at `dest` to `value`.
+ *
+ * Usage:
+ *   MEMORY_FILL(int, values, -1, len);
+ *   MEMORY_FILL(point_s, points, origin, count);
+ *
+ * Behavior:
+ *   - 1 byte elements, or values whose bytes are all equal (e.g. zero):
+ *     a single MEMORY_SET.
+ *   - Otherwise: stores one element, then doubles the filled prefix with
+ *     MEMORY_COPY (log2(n) copies).
+ */
+static inline void memory_fill(void *const restrict dest, const void *const restrict value, const size_t width, const size_t n)
+{
+   if (n == 0)
+      return;
+
+   unsigned char *const bytes = (unsigned char*)dest;
+   const unsigned char *const pattern = (const unsigned char*)value;
+   bool uniform = true;
+   for (size_t i = 1; i < width; i++)
+      uniform &= (pattern[i] == pattern[0]);
+   if (uniform)
+   {
+      MEMORY_SET(bytes, pattern[0], width * n);
+      return;
+   }
+
+   MEMORY_COPY(bytes, pattern, width);
+   for (size_t filled = 1; filled < n;)
+   {
+      const size_t chunk = (filled < n - filled) ? filled : n - filled;
+      MEMORY_COPY(bytes + filled * width, bytes, chunk * width);
+      filled += chunk;
+   }
+}
+
+#define MEMORY_FILL(type, dest, value, n) \
+   do { \
+      const type memory_fill_value = (value); \
+      memory_fill((dest), &memory_fill_value, sizeof(type), (n)); \
+   } while (0)
+
+
+/**
+ * MEMORY_COPY_LARGE macro
+ * -----------------------
+ * Memory copy for large, non-overlapping buffers (e.g. container resize).
+ *
+ * Usage:
+ *   MEMORY_COPY_LARGE(dest, src, size);
+ *
+ * Behavior:
+ *   - size < MEMORY_COPY_LARGE_MIN: same as MEMORY_COPY.
+ *   - GCC / Clang on x86: copies of at least the stream threshold use
+ *     non-temporal stores, so the destination does not evict the working
+ *     set from the caches. The kernel is picked at run time from cpuid
+ *     (AVX-512F, then AVX2, else MEMORY_COPY), independent of -march.
+ *     Smaller copies use MEMORY_COPY, which the C library already tunes
+ *     for cached stores.
+ *   - Other compilers / targets: same as MEMORY_COPY.
+ *
+ * Notes:
+ *   MEMORY_COPY_STREAM_THRESHOLD defaults to 0, meaning a quarter of the
+ *   last level cache as reported by cpuid (8 MiB if unavailable): a copy
+ *   that large already evicts a good part of the working set, and glibc
+ *   memcpy only starts streaming near the full cache size.
+ *   Define either macro before including this header to override it.
+ */
+#ifndef MEMORY_COPY_LARGE_MIN
+   #define MEMORY_COPY_LARGE_MIN (256 * 1024)
+#endif
+
+#ifndef MEMORY_COPY_STREAM_THRESHOLD
+   #define MEMORY_COPY_STREAM_THRESHOLD 0
+#endif
+
+#define MEMORY_COPY_DEFAULT_LLC_SIZE (8 * 1024 * 1024)
+
+// GCC, Clang on x86
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+   #include <stdint.h>
+   #include <cpuid.h>
+   #include <immintrin.h>
+
+   /* largest cache reported by the deterministic cache parameters leaf (Intel: 4, AMD: 0x8000001D) */
+   static inline size_t memory_cache_size_leaf(const unsigned int leaf)
+   {
+      size_t largest = 0;
+      unsigned int eax, ebx, ecx, edx;
+      for (unsigned int index = 0; index < 16; index++)
+      {
+         if (!__get_cpuid_count(leaf, index, &eax, &ebx, &ecx, &edx) || (eax & 0x1F) == 0)
+            break;
+         const size_t ways = ((ebx >> 22) & 0x3FF) + 1;
+         const size_t partitions = ((ebx >> 12) & 0x3FF) + 1;
+         const size_t line = (ebx & 0xFFF) + 1;
+         const size_t sets = (size_t)ecx + 1;
+         if (ways * partitions * line * sets > largest)
+            largest = ways * partitions * line * sets;
+      }
+      return largest;
+   }
+
+   static inline size_t memory_llc_size(void)
+   {
+      /* detected once per translation unit; racing threads store the same value.
+         The __atomic builtins keep this C99-clean, unlike <stdatomic.h> */
+      static size_t llc_size = 0;
+      size_t size = __atomic_load_n(&llc_size, __ATOMIC_RELAXED);
+      if (!size)
+      {
+         size = (__get_cpuid_max(0, NULL) >= 4) ? memory_cache_size_leaf(4) : 0;
+         if (!size && __get_cpuid_max(0x80000000, NULL) >= 0x8000001D)
+            size = memory_cache_size_leaf(0x8000001D);
+         if (!size)
+            size = MEMORY_COPY_DEFAULT_LLC_SIZE;
+         __atomic_store_n(&llc_size, size, __ATOMIC_RELAXED);
+      }
+      return size;
+   }
+
+   static inline size_t memory_stream_threshold(void)
+   {
+      return MEMORY_COPY_STREAM_THRESHOLD ? (size_t)MEMORY_COPY_STREAM_THRESHOLD : memory_llc_size() / 4;
+   }
+
+   /* dest is aligned to 32 bytes by a short head copy, src may be unaligned */
+   __attribute__((target("avx2")))
+   static inline void memory_copy_stream_avx2(void *const restrict dest, const void *const restrict src, const size_t size)
+   {
+      unsigned char *d = (unsigned char*)dest;
+      const unsigned char *s = (const unsigned char*)src;
+      const size_t head = (32 - ((uintptr_t)d & 31)) & 31;
+      MEMORY_COPY(d, s, head);
+      d += head;
+      s += head;
+      size_t n = size - head;
+
+      for (; n >= 128; n -= 128, d += 128, s += 128)
+      {
+         const __m256i a = _mm256_loadu_si256((const __m256i*)s);
+         const __m256i b = _mm256_loadu_si256((const __m256i*)(s + 32));
+         const __m256i c = _mm256_loadu_si256((const __m256i*)(s + 64));
+         const __m256i e = _mm256_loadu_si256((const __m256i*)(s + 96));
+         _mm256_stream_si256((__m256i*)d, a);
+         _mm256_stream_si256((__m256i*)(d + 32), b);
+         _mm256_stream_si256((__m256i*)(d + 64), c);
+         _mm256_stream_si256((__m256i*)(d + 96), e);
+      }
+      _mm_sfence();
+      MEMORY_COPY(d, s, n);
+   }
+
+   /* dest is aligned to 64 bytes by a short head copy, src may be unaligned */
+   __attribute__((target("avx512f")))
+   static inline void memory_copy_stream_avx512(void *const restrict dest, const void *const restrict src, const size_t size)
+   {
+      unsigned char *d = (unsigned char*)dest;
+      const unsigned char *s = (const unsigned char*)src;
+      const size_t head = (64 - ((uintptr_t)d & 63)) & 63;
+      MEMORY_COPY(d, s, head);
+      d += head;
+      s += head;
+      size_t n = size - head;
+
+      for (; n >= 256; n -= 256, d += 256, s += 256)
+      {
+         const __m512i a = _mm512_loadu_si512(s);
+         const __m512i b = _mm512_loadu_si512(s + 64);
+         const __m512i c = _mm512_loadu_si512(s + 128);
+         const __m512i e = _mm512_loadu_si512(s + 192);
+         _mm512_stream_si512((void*)d, a);
+         _mm512_stream_si512((void*)(d + 64), b);
+         _mm512_stream_si512((void*)(d + 128), c);
+         _mm512_stream_si512((void*)(d + 192), e);
+      }
+      _mm_sfence();
+      MEMORY_COPY(d, s, n);
+   }
+
+   static inline void memory_copy_large(void *const restrict dest, const void *const restrict src, const size_t size)
+   {
+      if (size < MEMORY_COPY_LARGE_MIN || size < memory_stream_threshold())
+      {
+         MEMORY_COPY(dest, src, size);
+         return;
+      }
+
+      if (__builtin_cpu_supports("avx512f"))
+         memory_copy_stream_avx512(dest, src, size);
+      else if (__builtin_cpu_supports("avx2"))
+         memory_copy_stream_avx2(dest, src, size);
+      else
+         MEMORY_COPY(dest, src, size);
+   }
+
+   #define MEMORY_COPY_LARGE(dest, src, size) memory_copy_large(dest, src, size)
+
+// Other
+#else
+   #define MEMORY_COPY_LARGE(dest, src, size) MEMORY_COPY(dest, src, size)
+
+#endif
+
 #endif /* __MEMORY_COPY_H */
\ No newline at end of file
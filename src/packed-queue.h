@@ -0,0 +1,742 @@
+#ifndef __PACKED_QUEUE_H
+#define __PACKED_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+
+
+/**
+ * Bit-packed queue / stack
+ * ------------------------
+ * Queue or stack of small values (PACKED_ENUM states, flags) stored in 1,
+ * 2 or 4 bits each, 64 / bits per 64-bit word: a 4-state enum takes a
+ * quarter of the byte a queue(state_e) spends on it.
+ *
+ * Element i lives in bits [(i % per_word) * bits, + bits) of word
+ * i / per_word. Sizes are powers of two and multiples of per_word, so the
+ * ring masks like queue.h and wraps on a word boundary.
+ */
+
+/* values stored in `bits` bits: 1, 2 or 4 */
+#define PACKED_BITS_VALID(bits) ((bits) == 1 || (bits) == 2 || (bits) == 4)
+
+/* smallest valid width for an enum of `count` values (e.g. a STATE_COUNT sentinel); 8 if none fits */
+#define PACKED_BITS_FOR(count) ((count) <= 2 ? 1 : (count) <= 4 ? 2 : (count) <= 16 ? 4 : 8)
+
+/* words holding `n` elements of `bits` bits */
+#define PACKED_WORDS(n, bits) (((size_t)(n) * (bits) + 63) / 64)
+
+
+/**
+ * Element helpers
+ * ---------------
+ * packed_get(words, i, bits)         - element i
+ * packed_set(words, i, bits, value)  - stores element i, other bits unchanged
+ */
+static inline uint8_t packed_get(const uint64_t *const restrict words, const size_t i, const unsigned bits)
+{
+   const unsigned per_word = 64 / bits;
+   return (uint8_t)((words[i / per_word] >> ((i % per_word) * bits)) & ((1u << bits) - 1));
+}
+
+static inline void packed_set(uint64_t *const restrict words, const size_t i, const unsigned bits, const uint8_t value)
+{
+   const unsigned per_word = 64 / bits;
+   const unsigned shift = (unsigned)(i % per_word) * bits;
+   uint64_t *const word = &words[i / per_word];
+   *word = (*word & ~((uint64_t)((1u << bits) - 1) << shift)) | ((uint64_t)value << shift);
+}
+
+
+/**
+ * packed_unpack function
+ * ----------------------
+ * Expands elements [index, index + n) into one byte each: out[k] = element
+ * index + k.
+ *
+ * Behavior:
+ *   - Scalar up to the first byte boundary, then:
+ *   - AVX2: 32 elements per step. 2 and 4-bit elements are zero-extended
+ *     into 32 / 16-bit lanes and their fields shifted into bytes; 1-bit
+ *     elements are broadcast with a byte shuffle and tested against a
+ *     per-byte bit mask.
+ *   - SSE2: 16 elements per step, the same with unpacks for the widening.
+ *   - Otherwise, and for the tail: scalar loop.
+ *   - Reads the words as little-endian bytes, as on every SSE2 / AVX2 target.
+ */
+#if defined(__AVX2__)
+   #include <immintrin.h>
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+#endif
+
+static inline void packed_unpack(const uint64_t *const restrict words, size_t index, size_t n, const unsigned bits, uint8_t *restrict out)
+{
+   assert(PACKED_BITS_VALID(bits));
+   const unsigned per_byte = 8 / bits;
+   for (; n && index % per_byte; index++, n--)
+      *out++ = packed_get(words, index, bits);
+
+#if defined(__AVX2__) || defined(__SSE2__)
+   const unsigned char *src = (const unsigned char*)words + index / per_byte;
+   size_t done = 0;
+   #if defined(__AVX2__)
+   switch (bits)
+   {
+      case 1:
+      {
+         const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                                 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+         const __m256i select = _mm256_set1_epi64x((long long)0x8040201008040201ull);
+         const __m256i one = _mm256_set1_epi8(1);
+         for (; done + 32 <= n; done += 32, src += 4)
+         {
+            uint32_t raw;
+            memcpy(&raw, src, sizeof(raw));
+            const __m256i x = _mm256_shuffle_epi8(_mm256_set1_epi32((int)raw), spread);
+            const __m256i y = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(x, select), select), one);
+            _mm256_storeu_si256((__m256i*)(out + done), y);
+         }
+         break;
+      }
+      case 2:
+      {
+         for (; done + 32 <= n; done += 32, src += 8)
+         {
+            const __m256i x = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)src));
+            const __m256i y = _mm256_or_si256(
+               _mm256_or_si256(_mm256_and_si256(x, _mm256_set1_epi32(0x3)),
+                               _mm256_and_si256(_mm256_slli_epi32(x, 6), _mm256_set1_epi32(0x300))),
+               _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(x, 12), _mm256_set1_epi32(0x30000)),
+                               _mm256_and_si256(_mm256_slli_epi32(x, 18), _mm256_set1_epi32(0x3000000))));
+            _mm256_storeu_si256((__m256i*)(out + done), y);
+         }
+         break;
+      }
+      case 4:
+      {
+         for (; done + 32 <= n; done += 32, src += 16)
+         {
+            const __m256i x = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)src));
+            const __m256i y = _mm256_or_si256(_mm256_and_si256(x, _mm256_set1_epi16(0x0F)),
+                                              _mm256_and_si256(_mm256_slli_epi16(x, 4), _mm256_set1_epi16(0x0F00)));
+            _mm256_storeu_si256((__m256i*)(out + done), y);
+         }
+         break;
+      }
+   }
+   #else
+   const __m128i zero = _mm_setzero_si128();
+   switch (bits)
+   {
+      case 1:
+      {
+         const __m128i select = _mm_set1_epi64x((long long)0x8040201008040201ull);
+         const __m128i one = _mm_set1_epi8(1);
+         for (; done + 16 <= n; done += 16, src += 2)
+         {
+            uint16_t raw;
+            memcpy(&raw, src, sizeof(raw));
+            __m128i x = _mm_cvtsi32_si128(raw);
+            x = _mm_unpacklo_epi8(x, x);
+            x = _mm_unpacklo_epi16(x, x);
+            x = _mm_unpacklo_epi32(x, x);
+            const __m128i y = _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(x, select), select), one);
+            _mm_storeu_si128((__m128i*)(out + done), y);
+         }
+         break;
+      }
+      case 2:
+      {
+         for (; done + 16 <= n; done += 16, src += 4)
+         {
+            uint32_t raw;
+            memcpy(&raw, src, sizeof(raw));
+            const __m128i x = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128((int)raw), zero), zero);
+            const __m128i y = _mm_or_si128(
+               _mm_or_si128(_mm_and_si128(x, _mm_set1_epi32(0x3)),
+                            _mm_and_si128(_mm_slli_epi32(x, 6), _mm_set1_epi32(0x300))),
+               _mm_or_si128(_mm_and_si128(_mm_slli_epi32(x, 12), _mm_set1_epi32(0x30000)),
+                            _mm_and_si128(_mm_slli_epi32(x, 18), _mm_set1_epi32(0x3000000))));
+            _mm_storeu_si128((__m128i*)(out + done), y);
+         }
+         break;
+      }
+      case 4:
+      {
+         for (; done + 16 <= n; done += 16, src += 8)
+         {
+            const __m128i x = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)src), zero);
+            const __m128i y = _mm_or_si128(_mm_and_si128(x, _mm_set1_epi16(0x0F)),
+                                           _mm_and_si128(_mm_slli_epi16(x, 4), _mm_set1_epi16(0x0F00)));
+            _mm_storeu_si128((__m128i*)(out + done), y);
+         }
+         break;
+      }
+   }
+   #endif
+   index += done;
+   out += done;
+   n -= done;
+#endif
+
+   for (size_t k = 0; k < n; k++)
+      out[k] = packed_get(words, index + k, bits);
+}
+
+
+/**
+ * DEFINE_PACKED_QUEUE macro
+ * -------------------------
+ * Defines a bit-packed queue of `type` values, `bits` bits each.
+ *
+ * Parameters:
+ *   type      - Element type: a PACKED_ENUM or small unsigned integer type
+ *   bits      - Bits per element: 1, 2 or 4 (see PACKED_BITS_FOR)
+ *   len_type  - Unsigned integer type used for length/size
+ *   init_size - Elements stored inline before heap allocation: a power
+ *               of 2, at least 64 / bits
+ *
+ * Output:
+ *   Declaration of bit-packed queue for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_PACKED_QUEUE(...), Ensure macro arguments match
+ */
+#define DEFINE_PACKED_QUEUE(type, bits, len_type, init_size) \
+   static_assert(PACKED_BITS_VALID(bits), "Warning: bits must be 1, 2 or 4"); \
+   static_assert(init_size >= 64 / (bits), "Warning: init_size must fill a word"); \
+   static_assert(init_size <= 4096, "Warning: init_size too big"); \
+   static_assert(init_size != 0 && (init_size & (init_size - 1)) == 0, "Warning: init_size must be a power of 2"); /* ring masking */ \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   uint64_t inline_buffer[PACKED_WORDS(init_size, bits)]; \
+   uint64_t *words; \
+   len_type front; \
+   len_type len; \
+   len_type size; /* elements */ \
+} type##_packed_queue_s; \
+\
+static inline void type##_packed_queue_init(type##_packed_queue_s *const restrict queue) \
+{ \
+   queue->words = queue->inline_buffer; \
+   queue->front = 0; \
+   queue->len = 0; \
+   queue->size = init_size; \
+} \
+\
+/* i-th element from the front */ \
+static inline type type##_packed_queue_get(const type##_packed_queue_s *const restrict queue, const len_type i) \
+{ \
+   assert(queue); \
+   assert(i < queue->len); \
+   return (type)packed_get(queue->words, (queue->front + i) & (queue->size - 1), bits); \
+} \
+\
+static inline type type##_packed_queue_peek(const type##_packed_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   assert(queue->len != 0); \
+   return (type)packed_get(queue->words, queue->front, bits); \
+} \
+\
+bool type##_packed_queue_resize(type##_packed_queue_s *const restrict); \
+void type##_packed_queue_delete(type##_packed_queue_s *const restrict); \
+bool type##_packed_queue_enque(type##_packed_queue_s *const restrict, const type); \
+bool type##_packed_queue_deque(type##_packed_queue_s *const restrict); \
+len_type type##_packed_queue_deque_n(type##_packed_queue_s *const restrict, len_type); \
+void type##_packed_queue_unpack(const type##_packed_queue_s *const restrict, const len_type, const len_type, uint8_t *const restrict);
+
+
+/**
+ * DEFINE_PACKED_STACK macro
+ * -------------------------
+ * Defines a bit-packed stack of `type` values, `bits` bits each.
+ *
+ * Parameters:
+ *   type      - Element type: a PACKED_ENUM or small unsigned integer type
+ *   bits      - Bits per element: 1, 2 or 4 (see PACKED_BITS_FOR)
+ *   len_type  - Unsigned integer type used for length/size
+ *   init_size - Elements stored inline before heap allocation: a power
+ *               of 2, at least 64 / bits
+ *
+ * Output:
+ *   Declaration of bit-packed stack for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_PACKED_STACK(...), Ensure macro arguments match
+ */
+#define DEFINE_PACKED_STACK(type, bits, len_type, init_size) \
+   static_assert(PACKED_BITS_VALID(bits), "Warning: bits must be 1, 2 or 4"); \
+   static_assert(init_size >= 64 / (bits), "Warning: init_size must fill a word"); \
+   static_assert(init_size <= 4096, "Warning: init_size too big"); \
+   static_assert(init_size != 0 && (init_size & (init_size - 1)) == 0, "Warning: init_size must be a power of 2"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   uint64_t inline_buffer[PACKED_WORDS(init_size, bits)]; \
+   uint64_t *words; \
+   len_type len; \
+   len_type size; /* elements */ \
+} type##_packed_stack_s; \
+\
+static inline void type##_packed_stack_init(type##_packed_stack_s *const restrict stack) \
+{ \
+   stack->words = stack->inline_buffer; \
+   stack->len = 0; \
+   stack->size = init_size; \
+} \
+\
+/* i-th element from the bottom */ \
+static inline type type##_packed_stack_get(const type##_packed_stack_s *const restrict stack, const len_type i) \
+{ \
+   assert(stack); \
+   assert(i < stack->len); \
+   return (type)packed_get(stack->words, i, bits); \
+} \
+\
+static inline type type##_packed_stack_peek(const type##_packed_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   assert(stack->len != 0); \
+   return (type)packed_get(stack->words, stack->len - 1, bits); \
+} \
+\
+/* elements [from, from + n) from the bottom, one byte each */ \
+static inline void type##_packed_stack_unpack(const type##_packed_stack_s *const restrict stack, const len_type from, const len_type n, uint8_t *const restrict out) \
+{ \
+   assert(stack); \
+   assert(from <= stack->len && n <= stack->len - from); \
+   packed_unpack(stack->words, from, n, bits, out); \
+} \
+\
+bool type##_packed_stack_resize(type##_packed_stack_s *const restrict); \
+void type##_packed_stack_delete(type##_packed_stack_s *const restrict); \
+bool type##_packed_stack_push(type##_packed_stack_s *const restrict, const type); \
+bool type##_packed_stack_pop(type##_packed_stack_s *const restrict);
+
+
+/**
+ * packed_queue(type) / packed_stack(type) macros
+ * ----------------------------------------------
+ * Declare a bit-packed queue or stack of the given type.
+ *
+ * Usage (as variable):
+ *   packed_queue(state_e) history;
+ *
+ * Usage (as parameter):
+ *   void replay(const packed_queue(state_e) *const history) { ... }
+ *
+ * Notes:
+ *   - These macros expand to the underlying struct types
+ *     (type##_packed_queue_s, type##_packed_stack_s).
+ */
+#define packed_queue(type) \
+   type##_packed_queue_s
+
+#define packed_stack(type) \
+   type##_packed_stack_s
+
+
+/**
+ * typecheck_packed_queue_ptr / typecheck_packed_stack_ptr macros
+ * --------------------------------------------------------------
+ * Compile-time validation that 'var' is a pointer to a bit-packed queue /
+ * stack of 'type' (see typecheck_ptr).
+ */
+#define typecheck_packed_queue_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_packed_queue_s, expr)
+
+#define typecheck_packed_stack_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_packed_stack_s, expr)
+
+
+/**
+ * Packed Queue / Stack Expression Macros
+ * --------------------------------------
+ * Direct access to container properties, type-checked at compile-time
+ * (C11+) with a runtime NULL check (via assert).
+ *
+ *   packed_queue_bytes(type, queue) - bytes of words in use by the ring
+ */
+#define packed_queue_len(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      (queue)->len \
+   )
+
+#define packed_queue_size(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      (queue)->size \
+   )
+
+#define packed_queue_full(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      (queue)->len == (queue)->size \
+   )
+
+#define packed_queue_empty(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      (queue)->len == 0 \
+   )
+
+#define packed_queue_clear(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      (queue)->len = 0 \
+   )
+
+#define packed_queue_bytes(type, queue, bits) \
+   typecheck_packed_queue_ptr(queue, type, \
+      PACKED_WORDS((queue)->size, bits) * sizeof(uint64_t) \
+   )
+
+#define packed_stack_len(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      (stack)->len \
+   )
+
+#define packed_stack_size(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      (stack)->size \
+   )
+
+#define packed_stack_full(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      (stack)->len == (stack)->size \
+   )
+
+#define packed_stack_empty(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      (stack)->len == 0 \
+   )
+
+#define packed_stack_clear(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      (stack)->len = 0 \
+   )
+
+
+/**
+ * GENERATE_PACKED_QUEUE macro
+ * ---------------------------
+ * Implements the bit-packed queue functions for a type.
+ *
+ * Parameters:
+ *   type           - Element type
+ *   bits           - Bits per element, as given to DEFINE_PACKED_QUEUE
+ *   len_type       - Unsigned integer type for length & size
+ *   init_size      - Inline buffer size in elements (initial size)
+ *   growth_factor  - Multiplier for resizing
+ *
+ * Behavior:
+ *   - enque / deque / peek / resize / delete as in queue.h; enque asserts
+ *     (debug) that the value fits in `bits`.
+ *   - Resize keeps `front`: the old words are copied (or realloc'd) in
+ *     place, and the elements that wrapped to the start of the ring move to
+ *     just past the old end, where the bigger ring continues.
+ *   - deque_n(n): drops up to n elements from the front, returns how many.
+ *   - unpack(from, n, out): elements [from, from + n) counted from the
+ *     front into out[0 .. n), with the packed_unpack SIMD kernels.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_PACKED_QUEUE(...), Ensure macro arguments match
+ */
+#define GENERATE_PACKED_QUEUE(type, bits, len_type, init_size, growth_factor, alloc_fn, realloc_fn, free_fn) \
+   static_assert(growth_factor > 1, "Warning: growth_factor too small"); \
+   static_assert(growth_factor < 32,  "Warning: growth_factor too big"); \
+   static_assert(growth_factor != 0 && (growth_factor & (growth_factor - 1)) == 0, "Warning: growth_factor must be a power of 2"); /* ring masking */ \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(realloc_fn, void* (void*, size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_packed_queue_resize(type##_packed_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (queue->size > (len_type)(-1) / growth_factor) /* Prevent overflow */ \
+      return false; \
+   const len_type new_size = queue->size * growth_factor; \
+   const size_t old_words = PACKED_WORDS(queue->size, bits); \
+   const size_t new_words = PACKED_WORDS(new_size, bits); \
+\
+   uint64_t *tmp; \
+   if (queue->words == queue->inline_buffer) \
+   { \
+      tmp = (uint64_t*)alloc_fn(sizeof(uint64_t) * new_words); \
+      if (!tmp) \
+         return false; \
+      MEMORY_COPY(tmp, queue->words, sizeof(uint64_t) * old_words); \
+   } \
+   else \
+   { \
+      tmp = (uint64_t*)realloc_fn(queue->words, sizeof(uint64_t) * new_words); \
+      if (!tmp) \
+         return false; \
+   } \
+\
+   /* wrapped elements [0, tail) continue the ring at [size, size + tail) */ \
+   if (queue->front + queue->len > queue->size) \
+   { \
+      const len_type tail = queue->front + queue->len - queue->size; \
+      MEMORY_COPY(&tmp[old_words], tmp, sizeof(uint64_t) * PACKED_WORDS(tail, bits)); \
+   } \
+\
+   queue->words = tmp; \
+   queue->size = new_size; \
+   return true; \
+} \
+\
+void type##_packed_queue_delete(type##_packed_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (queue->words != queue->inline_buffer) \
+      free_fn(queue->words); \
+   type##_packed_queue_init(queue); \
+} \
+\
+bool type##_packed_queue_enque(type##_packed_queue_s *const restrict queue, const type value) \
+{ \
+   assert(queue); \
+   assert((uint64_t)value < (1u << (bits))); \
+   if (packed_queue_full(type, queue) && !type##_packed_queue_resize(queue)) \
+      return false; \
+   packed_set(queue->words, (queue->front + queue->len) & (queue->size - 1), bits, (uint8_t)value); \
+   queue->len++; \
+   return true; \
+} \
+\
+bool type##_packed_queue_deque(type##_packed_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (packed_queue_empty(type, queue)) \
+      return false; \
+   queue->front = (queue->front + 1) & (queue->size - 1); \
+   queue->len--; \
+   return true; \
+} \
+\
+len_type type##_packed_queue_deque_n(type##_packed_queue_s *const restrict queue, len_type n) \
+{ \
+   assert(queue); \
+   if (n > queue->len) \
+      n = queue->len; \
+   queue->front = (queue->front + n) & (queue->size - 1); \
+   queue->len -= n; \
+   return n; \
+} \
+\
+void type##_packed_queue_unpack(const type##_packed_queue_s *const restrict queue, const len_type from, const len_type n, uint8_t *const restrict out) \
+{ \
+   assert(queue && (out || n == 0)); \
+   assert(from <= queue->len && n <= queue->len - from); \
+   const len_type start = (queue->front + from) & (queue->size - 1); \
+   const len_type first = (n < queue->size - start) ? n : (len_type)(queue->size - start); \
+   packed_unpack(queue->words, start, first, bits, out); \
+   packed_unpack(queue->words, 0, n - first, bits, out + first); \
+}
+
+
+/**
+ * GENERATE_PACKED_STACK macro
+ * ---------------------------
+ * Implements the bit-packed stack functions for a type.
+ *
+ * Parameters:
+ *   type           - Element type
+ *   bits           - Bits per element, as given to DEFINE_PACKED_STACK
+ *   len_type       - Unsigned integer type for length & size
+ *   init_size      - Inline buffer size in elements (initial size)
+ *   growth_factor  - Multiplier for resizing
+ *
+ * Behavior:
+ *   push / pop / peek / resize / delete as in stack.h; push asserts
+ *   (debug) that the value fits in `bits`.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_PACKED_STACK(...), Ensure macro arguments match
+ */
+#define GENERATE_PACKED_STACK(type, bits, len_type, init_size, growth_factor, alloc_fn, realloc_fn, free_fn) \
+   static_assert(growth_factor > 1, "Warning: growth_factor too small"); \
+   static_assert(growth_factor < 32,  "Warning: growth_factor too big"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(realloc_fn, void* (void*, size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_packed_stack_resize(type##_packed_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   if (stack->size > (len_type)(-1) / growth_factor) /* Prevent overflow */ \
+      return false; \
+   const len_type new_size = stack->size * growth_factor; \
+   const size_t new_words = PACKED_WORDS(new_size, bits); \
+\
+   uint64_t *tmp; \
+   if (stack->words == stack->inline_buffer) \
+   { \
+      tmp = (uint64_t*)alloc_fn(sizeof(uint64_t) * new_words); \
+      if (!tmp) \
+         return false; \
+      MEMORY_COPY(tmp, stack->words, sizeof(uint64_t) * PACKED_WORDS(stack->len, bits)); \
+   } \
+   else \
+   { \
+      tmp = (uint64_t*)realloc_fn(stack->words, sizeof(uint64_t) * new_words); \
+      if (!tmp) \
+         return false; \
+   } \
+\
+   stack->words = tmp; \
+   stack->size = new_size; \
+   return true; \
+} \
+\
+void type##_packed_stack_delete(type##_packed_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   if (stack->words != stack->inline_buffer) \
+      free_fn(stack->words); \
+   type##_packed_stack_init(stack); \
+} \
+\
+bool type##_packed_stack_push(type##_packed_stack_s *const restrict stack, const type value) \
+{ \
+   assert(stack); \
+   assert((uint64_t)value < (1u << (bits))); \
+   if (packed_stack_full(type, stack) && !type##_packed_stack_resize(stack)) \
+      return false; \
+   packed_set(stack->words, stack->len, bits, (uint8_t)value); \
+   stack->len++; \
+   return true; \
+} \
+\
+bool type##_packed_stack_pop(type##_packed_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   if (packed_stack_empty(type, stack)) \
+      return false; \
+   stack->len--; \
+   return true; \
+}
+
+
+/**
+ * Packed queue / stack function macros
+ * ------------------------------------
+ * Type-generic wrappers for the functions generated by
+ * GENERATE_PACKED_QUEUE and GENERATE_PACKED_STACK.
+ *
+ * Usage:
+ *   packed_queue(state_e) q;
+ *   packed_queue_init(state_e, &q);
+ *   packed_queue_enque(state_e, &q, STATE_RUNNING);
+ *   state_e s = packed_queue_peek(state_e, &q);
+ *
+ *   uint8_t batch[256];
+ *   uint32_t n = packed_queue_len(state_e, &q) < 256 ? packed_queue_len(state_e, &q) : 256;
+ *   packed_queue_unpack(state_e, &q, 0, n, batch);    // batch[i] = i-th state
+ *   packed_queue_deque_n(state_e, &q, n);
+ *   packed_queue_delete(state_e, &q);
+ */
+#define packed_queue_init(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_init((queue)) \
+   )
+
+#define packed_queue_peek(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_peek((queue)) \
+   )
+
+#define packed_queue_get(type, queue, i) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_get((queue), (i)) \
+   )
+
+#define packed_queue_resize(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_resize((queue)) \
+   )
+
+#define packed_queue_delete(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_delete((queue)) \
+   )
+
+#define packed_queue_enque(type, queue, value) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_enque((queue), (value)) \
+   )
+
+#define packed_queue_deque(type, queue) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_deque((queue)) \
+   )
+
+#define packed_queue_deque_n(type, queue, n) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_deque_n((queue), (n)) \
+   )
+
+#define packed_queue_unpack(type, queue, from, n, out) \
+   typecheck_packed_queue_ptr(queue, type, \
+      type##_packed_queue_unpack((queue), (from), (n), (out)) \
+   )
+
+#define packed_stack_init(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_init((stack)) \
+   )
+
+#define packed_stack_peek(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_peek((stack)) \
+   )
+
+#define packed_stack_get(type, stack, i) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_get((stack), (i)) \
+   )
+
+#define packed_stack_unpack(type, stack, from, n, out) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_unpack((stack), (from), (n), (out)) \
+   )
+
+#define packed_stack_resize(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_resize((stack)) \
+   )
+
+#define packed_stack_delete(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_delete((stack)) \
+   )
+
+#define packed_stack_push(type, stack, value) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_push((stack), (value)) \
+   )
+
+#define packed_stack_pop(type, stack) \
+   typecheck_packed_stack_ptr(stack, type, \
+      type##_packed_stack_pop((stack)) \
+   )
+
+
+#endif /* __PACKED_QUEUE_H */
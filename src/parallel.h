@@ -0,0 +1,288 @@
+#ifndef __PARALLEL_H
+#define __PARALLEL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/**
+ * Parallel pool
+ * -------------
+ * A small fixed-size worker pool that runs one batch of indexed tasks at a
+ * time; the calling thread takes part in every batch.
+ *
+ * Functions:
+ *   parallel_pool_init(pool, threads)  - start `threads` workers in total,
+ *                                        counting the caller (0: one per
+ *                                        online CPU); false on failure
+ *   parallel_pool_delete(pool)         - stop and join the workers
+ *   parallel_pool_threads(pool)        - threads that run a batch (>= 1)
+ *   parallel_run(pool, n, task, ctx)   - calls task(ctx, i) for i in [0, n),
+ *                                        returns when all calls are done
+ *   parallel_chunks(pool, n, &chunk)   - number of tasks to split n elements
+ *                                        into, and the elements per task
+ *   parallel_copy(pool, dest, src, size) - memcpy split across the pool
+ *
+ * Behavior:
+ *   - Tasks are handed out one at a time under the pool mutex, so callers
+ *     should make them coarse (see parallel_chunks).
+ *   - A NULL pool, or a build without pthreads, runs every task serially
+ *     on the calling thread.
+ *
+ * Notes:
+ *   One batch at a time per pool: do not call parallel_run on the same
+ *   pool from several threads or from inside a task.
+ *   PARALLEL_MAX_THREADS, PARALLEL_SERIAL_THRESHOLD and PARALLEL_MIN_CHUNK
+ *   can be defined before including this header.
+ */
+#ifndef PARALLEL_MAX_THREADS
+   #define PARALLEL_MAX_THREADS 64
+#endif
+
+/* below this many elements a container pass runs serially */
+#ifndef PARALLEL_SERIAL_THRESHOLD
+   #define PARALLEL_SERIAL_THRESHOLD 32768
+#endif
+
+/* smallest number of elements given to one task */
+#ifndef PARALLEL_MIN_CHUNK
+   #define PARALLEL_MIN_CHUNK 4096
+#endif
+
+/* tasks per thread, for load balancing */
+#define PARALLEL_TASKS_PER_THREAD 4
+#define PARALLEL_MAX_TASKS (PARALLEL_MAX_THREADS * PARALLEL_TASKS_PER_THREAD)
+
+#if defined(__unix__) || defined(__APPLE__)
+   #define PARALLEL_HAS_PTHREADS 1
+   #include <pthread.h>
+   #include <unistd.h>
+#else
+   #define PARALLEL_HAS_PTHREADS 0
+#endif
+
+
+typedef struct parallel_pool
+{
+#if PARALLEL_HAS_PTHREADS
+   pthread_t workers[PARALLEL_MAX_THREADS];
+   pthread_mutex_t lock;
+   pthread_cond_t work_ready;
+   pthread_cond_t work_done;
+#endif
+   size_t worker_count;
+   void (*task)(void*, size_t);
+   void *ctx;
+   size_t task_count;
+   size_t next_task;
+   size_t done_count;
+   unsigned long generation;
+   bool shutdown;
+} parallel_pool_s;
+
+
+static inline size_t parallel_pool_threads(const parallel_pool_s *const restrict pool)
+{
+   return pool ? pool->worker_count + 1 : 1;
+}
+
+#if PARALLEL_HAS_PTHREADS
+   /* runs tasks of the current batch until none are left; called with the lock held */
+   static inline void parallel_drain(parallel_pool_s *const restrict pool)
+   {
+      while (pool->next_task < pool->task_count)
+      {
+         const size_t index = pool->next_task++;
+         void (*const task)(void*, size_t) = pool->task;
+         void *const ctx = pool->ctx;
+         pthread_mutex_unlock(&pool->lock);
+         task(ctx, index);
+         pthread_mutex_lock(&pool->lock);
+         if (++pool->done_count == pool->task_count)
+            pthread_cond_signal(&pool->work_done);
+      }
+   }
+
+   static inline void *parallel_worker(void *const arg)
+   {
+      parallel_pool_s *const pool = (parallel_pool_s*)arg;
+      unsigned long seen = 0;
+      pthread_mutex_lock(&pool->lock);
+      for (;;)
+      {
+         while (!pool->shutdown && pool->generation == seen)
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+         if (pool->shutdown)
+            break;
+         seen = pool->generation;
+         parallel_drain(pool);
+      }
+      pthread_mutex_unlock(&pool->lock);
+      return NULL;
+   }
+#endif
+
+static inline void parallel_pool_delete(parallel_pool_s *const restrict pool)
+{
+   assert(pool);
+#if PARALLEL_HAS_PTHREADS
+   pthread_mutex_lock(&pool->lock);
+   pool->shutdown = true;
+   pthread_cond_broadcast(&pool->work_ready);
+   pthread_mutex_unlock(&pool->lock);
+   for (size_t i = 0; i < pool->worker_count; i++)
+      pthread_join(pool->workers[i], NULL);
+
+   pthread_cond_destroy(&pool->work_done);
+   pthread_cond_destroy(&pool->work_ready);
+   pthread_mutex_destroy(&pool->lock);
+#endif
+   pool->worker_count = 0;
+}
+
+static inline bool parallel_pool_init(parallel_pool_s *const restrict pool, size_t threads)
+{
+   assert(pool);
+   pool->worker_count = 0;
+   pool->task = NULL;
+   pool->ctx = NULL;
+   pool->task_count = 0;
+   pool->next_task = 0;
+   pool->done_count = 0;
+   pool->generation = 0;
+   pool->shutdown = false;
+
+#if PARALLEL_HAS_PTHREADS
+   if (threads == 0)
+   {
+      const long online = sysconf(_SC_NPROCESSORS_ONLN);
+      threads = (online > 0) ? (size_t)online : 1;
+   }
+   if (threads > PARALLEL_MAX_THREADS)
+      threads = PARALLEL_MAX_THREADS;
+
+   if (pthread_mutex_init(&pool->lock, NULL) != 0)
+      return false;
+   if (pthread_cond_init(&pool->work_ready, NULL) != 0)
+   {
+      pthread_mutex_destroy(&pool->lock);
+      return false;
+   }
+   if (pthread_cond_init(&pool->work_done, NULL) != 0)
+   {
+      pthread_cond_destroy(&pool->work_ready);
+      pthread_mutex_destroy(&pool->lock);
+      return false;
+   }
+
+   /* the caller is the first thread */
+   for (size_t i = 0; i + 1 < threads; i++)
+   {
+      if (pthread_create(&pool->workers[i], NULL, parallel_worker, pool) != 0)
+         break;
+      pool->worker_count++;
+   }
+   if (pool->worker_count + 1 < threads)
+   {
+      parallel_pool_delete(pool);
+      return false;
+   }
+#else
+   (void)threads;
+#endif
+   return true;
+}
+
+static inline void parallel_run(parallel_pool_s *const restrict pool, const size_t task_count, void (*const task)(void*, size_t), void *const ctx)
+{
+   assert(task);
+#if PARALLEL_HAS_PTHREADS
+   if (pool && pool->worker_count > 0 && task_count > 1)
+   {
+      pthread_mutex_lock(&pool->lock);
+      pool->task = task;
+      pool->ctx = ctx;
+      pool->task_count = task_count;
+      pool->next_task = 0;
+      pool->done_count = 0;
+      pool->generation++;
+      pthread_cond_broadcast(&pool->work_ready);
+
+      parallel_drain(pool);
+      while (pool->done_count < pool->task_count)
+         pthread_cond_wait(&pool->work_done, &pool->lock);
+      pthread_mutex_unlock(&pool->lock);
+      return;
+   }
+#else
+   (void)pool;
+#endif
+   for (size_t i = 0; i < task_count; i++)
+      task(ctx, i);
+}
+
+/**
+ * parallel_chunks function
+ * ------------------------
+ * Splits `n` elements into tasks: serial (one task) below
+ * PARALLEL_SERIAL_THRESHOLD, otherwise up to PARALLEL_TASKS_PER_THREAD
+ * tasks per thread of at least PARALLEL_MIN_CHUNK elements each. Chunk
+ * sizes are multiples of 64 elements, counted from the first element
+ * handed to the tasks. Neighbouring tasks only avoid writing to the same
+ * cache line when that element starts a line, e.g. a stack or array
+ * whose allocator returns 64-byte aligned memory. A queue or deque ring
+ * whose front is not 0, or a buffer off a 64-byte boundary, shares one
+ * line at each chunk boundary. Returns the task count, *chunk gets the
+ * elements per task (the last task takes the remainder).
+ */
+static inline size_t parallel_chunks(const parallel_pool_s *const restrict pool, const size_t n, size_t *const restrict chunk)
+{
+   assert(chunk);
+   size_t tasks = parallel_pool_threads(pool) * PARALLEL_TASKS_PER_THREAD;
+   if (n < PARALLEL_SERIAL_THRESHOLD || tasks <= PARALLEL_TASKS_PER_THREAD)
+      tasks = 1;
+   if (tasks > n / PARALLEL_MIN_CHUNK)
+      tasks = (n / PARALLEL_MIN_CHUNK > 0) ? n / PARALLEL_MIN_CHUNK : 1;
+
+   size_t size = (n + tasks - 1) / tasks;
+   size = (size + 63) & ~(size_t)63;
+   *chunk = size ? size : 1;
+   return size ? (n + size - 1) / size : 1;
+}
+
+
+typedef struct
+{
+   unsigned char *dest;
+   const unsigned char *src;
+   size_t size;
+   size_t chunk;
+} parallel_copy_job_s;
+
+static inline void parallel_copy_task(void *const arg, const size_t index)
+{
+   const parallel_copy_job_s *const job = (const parallel_copy_job_s*)arg;
+   const size_t lo = index * job->chunk;
+   const size_t hi = (lo + job->chunk < job->size) ? lo + job->chunk : job->size;
+   memcpy(job->dest + lo, job->src + lo, hi - lo);
+}
+
+/**
+ * parallel_copy function
+ * ----------------------
+ * memcpy of `size` bytes split into cache line multiples across the pool
+ * (serial below PARALLEL_SERIAL_THRESHOLD cache lines). The ranges must
+ * not overlap.
+ */
+static inline void parallel_copy(parallel_pool_s *const pool, void *const restrict dest, const void *const restrict src, const size_t size)
+{
+   parallel_copy_job_s job = { .dest = (unsigned char*)dest, .src = (const unsigned char*)src, .size = size };
+   parallel_chunks(pool, size / 64, &job.chunk);
+   job.chunk *= 64;
+   parallel_run(pool, (size + job.chunk - 1) / job.chunk, parallel_copy_task, &job);
+}
+
+
+#endif /* __PARALLEL_H */
\ No newline at end of file
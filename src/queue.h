@@ -6,6 +6,12 @@
 #include "static-assert.h"
 #include "swap.h"
 #include "memory-copy.h"
+#include "search.h"
+#include "reduce.h"
+#include "sort.h"
+#include "compact.h"
+#include "hash.h"
+#include "parallel.h"
 
 
 /**
@@ -216,13 +222,13 @@ bool type##_queue_resize(type##_queue_s *const restrict queue) \
 \
       if (not_wrapped) \
       { \
-         MEMORY_COPY(tmp, queue->values, sizeof(type) * queue->len); \
+         MEMORY_COPY_LARGE(tmp, queue->values, sizeof(type) * queue->len); \
       } \
       else \
       { \
          len_type first_chunk = queue->size - queue->front; \
-         MEMORY_COPY(tmp, &queue->values[queue->front], sizeof(type) * first_chunk); \
-         MEMORY_COPY((type*)tmp + first_chunk, queue->values, sizeof(type) * queue->front); \
+         MEMORY_COPY_LARGE(tmp, &queue->values[queue->front], sizeof(type) * first_chunk); \
+         MEMORY_COPY_LARGE((type*)tmp + first_chunk, queue->values, sizeof(type) * queue->front); \
       } \
 \
       if (in_heap) \
@@ -278,12 +284,22 @@ void type##_queue_reverse(type##_queue_s *const restrict queue) \
    if (queue->len < 2) \
       return; \
 \
-   len_type front = queue->front; \
-   len_type tail = queue->front + queue->len - 1; \
-   len_type mask = queue->size - 1; \
-   for (len_type i = 0; i < queue->len / 2; i++) \
-      /* SWAP(type, queue->values[(front + i) % queue->size], queue->values[(tail - i) % queue->size]); */ \
-      SWAP(type, queue->values[(front + i) & mask], queue->values[(tail - i) & mask]); \
+   /* mirrored pairs in runs that are contiguous at both ends */ \
+   const len_type mask = queue->size - 1; \
+   len_type left = queue->front; \
+   len_type right = ((queue->front + queue->len - 1) & mask) + 1; /* one past the back element */ \
+   for (len_type pairs = queue->len / 2; pairs > 0;) \
+   { \
+      len_type run = pairs; \
+      if (queue->size - left < run) \
+         run = queue->size - left; \
+      if (right < run) \
+         run = right; \
+      swap_ranges_reversed(&queue->values[left], &queue->values[right - run], run, sizeof(type)); \
+      left = (left + run) & mask; \
+      right = ((right - run + queue->size - 1) & mask) + 1; \
+      pairs -= run; \
+   } \
 }
 
 
@@ -339,4 +355,992 @@ void type##_queue_reverse(type##_queue_s *const restrict queue) \
    )
 
 
+/**
+ * DEFINE_QUEUE_SEARCH macro
+ * -------------------------
+ * Declares find / count / contains for a queue type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the queue
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE(...)
+ *    Use in combination with GENERATE_QUEUE_SEARCH(...)
+ */
+#define DEFINE_QUEUE_SEARCH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+len_type type##_queue_find(const type##_queue_s *const restrict, const type); \
+len_type type##_queue_count(const type##_queue_s *const restrict, const type); \
+bool type##_queue_contains(const type##_queue_s *const restrict, const type);
+
+
+/**
+ * GENERATE_QUEUE_SEARCH macro
+ * ---------------------------
+ * Implements find / count / contains for a queue type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   equal_fn - bool (type, type) equality, used for non-integral types
+ *
+ * Behavior:
+ *   - Integral types: bitwise SIMD kernels from search.h, run over the
+ *     one or two contiguous segments of the ring (equal_fn unused).
+ *   - Other types: linear scan with equal_fn
+ *     (use DEFINE_BYTES_EQUAL(type) for memcmp on padding-free structs).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_QUEUE(...)
+ *    Use in combination with DEFINE_QUEUE_SEARCH(...)
+ */
+#define GENERATE_QUEUE_SEARCH(type, len_type, equal_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(equal_fn, bool (type, type)); \
+\
+len_type type##_queue_find(const type##_queue_s *const restrict queue, const type value) \
+{ \
+   assert(queue); \
+   const len_type mask = queue->size - 1; \
+   if (SEARCH_IS_INTEGRAL(type)) \
+   { \
+      const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+      const len_type index = (len_type)search_find(&queue->values[queue->front], first_chunk, sizeof(type), &value); \
+      if (index < first_chunk) \
+         return index; \
+      return first_chunk + (len_type)search_find(queue->values, queue->len - first_chunk, sizeof(type), &value); \
+   } \
+\
+   for (len_type i = 0; i < queue->len; i++) \
+      if (equal_fn(queue->values[(queue->front + i) & mask], value)) \
+         return i; \
+   return queue->len; \
+} \
+\
+len_type type##_queue_count(const type##_queue_s *const restrict queue, const type value) \
+{ \
+   assert(queue); \
+   const len_type mask = queue->size - 1; \
+   if (SEARCH_IS_INTEGRAL(type)) \
+   { \
+      const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+      return (len_type)(search_count(&queue->values[queue->front], first_chunk, sizeof(type), &value) \
+                      + search_count(queue->values, queue->len - first_chunk, sizeof(type), &value)); \
+   } \
+\
+   len_type count = 0; \
+   for (len_type i = 0; i < queue->len; i++) \
+      count += equal_fn(queue->values[(queue->front + i) & mask], value); \
+   return count; \
+} \
+\
+bool type##_queue_contains(const type##_queue_s *const restrict queue, const type value) \
+{ \
+   return type##_queue_find(queue, value) != queue->len; \
+}
+
+
+/**
+ * Queue search macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_SEARCH.
+ *
+ * Usage:
+ *   len_type i = queue_find(int, &q, 42);    // index from front, queue_len() if absent
+ *   len_type n = queue_count(int, &q, 42);   // number of elements equal to 42
+ *   bool has = queue_contains(int, &q, 42);
+ */
+#define queue_find(type, queue, value) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_find((queue), (value)) \
+   )
+
+#define queue_count(type, queue, value) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_count((queue), (value)) \
+   )
+
+#define queue_contains(type, queue, value) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_contains((queue), (value)) \
+   )
+
+
+/**
+ * DEFINE_QUEUE_REDUCE macro
+ * -------------------------
+ * Declares sum / min / max / argmin / argmax for a numeric queue type.
+ *
+ * Parameters:
+ *   type     - Numeric element type stored in the queue
+ *   len_type - Integer type used for length/size
+ *   sum_type - Accumulator type returned by sum (e.g. int64_t for int32_t)
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE(...)
+ *    Use in combination with GENERATE_QUEUE_REDUCE(...), Ensure macro arguments match
+ */
+#define DEFINE_QUEUE_REDUCE(type, len_type, sum_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(sum_type); \
+\
+sum_type type##_queue_sum(const type##_queue_s *const restrict); \
+type type##_queue_min(const type##_queue_s *const restrict); \
+type type##_queue_max(const type##_queue_s *const restrict); \
+len_type type##_queue_argmin(const type##_queue_s *const restrict); \
+len_type type##_queue_argmax(const type##_queue_s *const restrict);
+
+
+/**
+ * GENERATE_QUEUE_REDUCE macro
+ * ---------------------------
+ * Implements sum / min / max / argmin / argmax for a numeric queue type.
+ *
+ * Parameters:
+ *   type     - Numeric element type
+ *   len_type - Unsigned integer type for length & size
+ *   sum_type - Accumulator type returned by sum
+ *
+ * Behavior:
+ *   - float / double: SSE2/AVX2 kernels from reduce.h, run over the one or
+ *     two contiguous segments of the ring (sum only when sum_type is the
+ *     element type).
+ *   - Other types: scalar loops, left to the compiler to vectorize.
+ *   - argmin/argmax: the min / max, then the first element equal to it
+ *     with a compare + movemask kernel (reduce_find_* for float / double,
+ *     search_find for integers) over each contiguous segment.
+ *   - Overflow: sum accumulates in sum_type; pick a wider type to avoid
+ *     overflow (unsigned wraps, signed overflow is undefined).
+ *   - NaN: sum propagates NaN, min/max return NaN if any element is NaN,
+ *     argmin/argmax return the index of the first NaN.
+ *   - min/max/argmin/argmax assert the queue is non-empty; sum of an empty
+ *     queue is 0.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_QUEUE(...)
+ *    Use in combination with DEFINE_QUEUE_REDUCE(...), Ensure macro arguments match
+ */
+#define GENERATE_QUEUE_REDUCE(type, len_type, sum_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(sum_type); \
+\
+static inline sum_type type##_queue_sum_scalar(const type *const restrict values, const size_t n) \
+{ \
+   sum_type sum = 0; \
+   for (size_t i = 0; i < n; i++) \
+      sum += (sum_type)values[i]; \
+   return sum; \
+} \
+\
+static inline type type##_queue_min_scalar(const type *const restrict values, const size_t n) \
+{ \
+   type result = values[0]; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      if (values[i] != values[i]) /* NaN */ \
+         return values[i]; \
+      if (values[i] < result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline type type##_queue_max_scalar(const type *const restrict values, const size_t n) \
+{ \
+   type result = values[0]; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      if (values[i] != values[i]) /* NaN */ \
+         return values[i]; \
+      if (values[i] > result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline size_t type##_queue_index_of(const type *const restrict values, const size_t n, const type target) \
+{ \
+   if (SEARCH_IS_INTEGRAL(type)) /* bitwise equality: compare + movemask kernel from search.h */ \
+      return search_find(values, n, sizeof(type), &target); \
+   const bool is_nan = (target != target); \
+   size_t i = 0; \
+   while (i < n && !(is_nan ? (values[i] != values[i]) : (values[i] == target))) \
+      i++; \
+   return i; \
+} \
+\
+sum_type type##_queue_sum(const type##_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   return REDUCE_SUM_DISPATCH(queue->values, sum_type, type##_queue_sum_scalar)(&queue->values[queue->front], first_chunk) \
+        + REDUCE_SUM_DISPATCH(queue->values, sum_type, type##_queue_sum_scalar)(queue->values, queue->len - first_chunk); \
+} \
+\
+type type##_queue_min(const type##_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   assert(!queue_empty(type, queue)); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   const type first = REDUCE_DISPATCH(queue->values, reduce_min_f32, reduce_min_f64, type##_queue_min_scalar)(&queue->values[queue->front], first_chunk); \
+   if (first_chunk == queue->len || first != first) \
+      return first; \
+   const type second = REDUCE_DISPATCH(queue->values, reduce_min_f32, reduce_min_f64, type##_queue_min_scalar)(queue->values, queue->len - first_chunk); \
+   return (second != second || second < first) ? second : first; \
+} \
+\
+type type##_queue_max(const type##_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   assert(!queue_empty(type, queue)); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   const type first = REDUCE_DISPATCH(queue->values, reduce_max_f32, reduce_max_f64, type##_queue_max_scalar)(&queue->values[queue->front], first_chunk); \
+   if (first_chunk == queue->len || first != first) \
+      return first; \
+   const type second = REDUCE_DISPATCH(queue->values, reduce_max_f32, reduce_max_f64, type##_queue_max_scalar)(queue->values, queue->len - first_chunk); \
+   return (second != second || second > first) ? second : first; \
+} \
+\
+len_type type##_queue_argmin(const type##_queue_s *const restrict queue) \
+{ \
+   const type target = type##_queue_min(queue); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   const len_type index = (len_type)REDUCE_DISPATCH(queue->values, reduce_find_f32, reduce_find_f64, type##_queue_index_of)(&queue->values[queue->front], first_chunk, target); \
+   if (index < first_chunk) \
+      return index; \
+   return first_chunk + (len_type)REDUCE_DISPATCH(queue->values, reduce_find_f32, reduce_find_f64, type##_queue_index_of)(queue->values, queue->len - first_chunk, target); \
+} \
+\
+len_type type##_queue_argmax(const type##_queue_s *const restrict queue) \
+{ \
+   const type target = type##_queue_max(queue); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   const len_type index = (len_type)REDUCE_DISPATCH(queue->values, reduce_find_f32, reduce_find_f64, type##_queue_index_of)(&queue->values[queue->front], first_chunk, target); \
+   if (index < first_chunk) \
+      return index; \
+   return first_chunk + (len_type)REDUCE_DISPATCH(queue->values, reduce_find_f32, reduce_find_f64, type##_queue_index_of)(queue->values, queue->len - first_chunk, target); \
+}
+
+
+/**
+ * Queue reduce macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_REDUCE.
+ *
+ * Usage:
+ *   int64_t total = queue_sum(int32_t, &q);
+ *   int32_t lo = queue_min(int32_t, &q);        // asserts non-empty
+ *   len_type at = queue_argmax(int32_t, &q);    // index from front
+ */
+#define queue_sum(type, queue) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_sum((queue)) \
+   )
+
+#define queue_min(type, queue) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_min((queue)) \
+   )
+
+#define queue_max(type, queue) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_max((queue)) \
+   )
+
+#define queue_argmin(type, queue) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_argmin((queue)) \
+   )
+
+#define queue_argmax(type, queue) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_argmax((queue)) \
+   )
+
+
+/**
+ * DEFINE_QUEUE_SORT macro
+ * -----------------------
+ * Declares the sort functions for a queue type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the queue
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE(...)
+ *    Use in combination with GENERATE_QUEUE_SORT(...), Ensure macro arguments match
+ */
+#define DEFINE_QUEUE_SORT(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+bool type##_queue_sort(type##_queue_s *const restrict, int (*const)(const type*, const type*)); \
+bool type##_queue_radix_sort(type##_queue_s *const restrict);
+
+
+/**
+ * GENERATE_QUEUE_SORT macro
+ * -------------------------
+ * Implements the sort functions for a queue type.
+ *
+ * Parameters:
+ *   type       - Element type
+ *   len_type   - Unsigned integer type for length & size
+ *   key_type   - Radix key: unsigned, signed, float or double (1/2/4/8 bytes)
+ *   key_offset - Byte offset of the key in type (0 when key_type is type,
+ *                offsetof(type, field) for struct keys)
+ *   alloc_fn   - Allocator for the scratch buffer (the queue's own allocator)
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - sort(compare): stable merge sort, compare is qsort-style on pointers.
+ *   - radix_sort(): stable LSD radix sort ascending by key, skipping digits
+ *     that are equal for every key.
+ *   - Both sort the logical order front to back. A wrapped ring is unwrapped
+ *     into the scratch buffer and sorted back into values[0..len) with
+ *     front reset to 0; an unwrapped ring is sorted in place.
+ *   - Allocates one scratch buffer of len elements and returns false if
+ *     that allocation fails (queue left unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_QUEUE(...)
+ *    Use in combination with DEFINE_QUEUE_SORT(...), Ensure macro arguments match
+ */
+#define GENERATE_QUEUE_SORT(type, len_type, key_type, key_offset, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(key_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+   SORT_GENERATE_ARRAY(type##_queue, type, key_type, key_offset) \
+\
+/* Points *data at the elements as one contiguous run, *spare at a buffer of len; returns where the result belongs */ \
+static inline type *type##_queue_sort_unwrap(type##_queue_s *const restrict queue, type *const restrict scratch, type **const data, type **const spare) \
+{ \
+   if (queue->front + queue->len <= queue->size) /* not wrapped: sort in place */ \
+   { \
+      *data = &queue->values[queue->front]; \
+      *spare = scratch; \
+      return *data; \
+   } \
+\
+   const len_type first_chunk = queue->size - queue->front; \
+   MEMORY_COPY(scratch, &queue->values[queue->front], sizeof(type) * first_chunk); \
+   MEMORY_COPY(scratch + first_chunk, queue->values, sizeof(type) * (queue->len - first_chunk)); \
+   queue->front = 0; \
+   *data = scratch; \
+   *spare = queue->values; \
+   return queue->values; \
+} \
+\
+bool type##_queue_sort(type##_queue_s *const restrict queue, int (*const compare)(const type*, const type*)) \
+{ \
+   assert(queue); \
+   assert(compare); \
+   if (queue->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * queue->len); \
+   if (!scratch) \
+      return false; \
+\
+   type *data, *spare; \
+   type *const base = type##_queue_sort_unwrap(queue, scratch, &data, &spare); \
+   const type *const sorted = type##_queue_merge_sort_array(data, spare, queue->len, compare); \
+   if (sorted != base) \
+      MEMORY_COPY(base, sorted, sizeof(type) * queue->len); \
+   free_fn(scratch); \
+   return true; \
+} \
+\
+bool type##_queue_radix_sort(type##_queue_s *const restrict queue) \
+{ \
+   assert(queue); \
+   if (queue->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * queue->len); \
+   if (!scratch) \
+      return false; \
+\
+   type *data, *spare; \
+   type *const base = type##_queue_sort_unwrap(queue, scratch, &data, &spare); \
+   const type *const sorted = type##_queue_radix_sort_array(data, spare, queue->len); \
+   if (sorted != base) \
+      MEMORY_COPY(base, sorted, sizeof(type) * queue->len); \
+   free_fn(scratch); \
+   return true; \
+}
+
+
+/**
+ * Queue sort macros
+ * -----------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_SORT.
+ *
+ * Usage:
+ *   static int compare_int(const int *a, const int *b) { return (*a > *b) - (*a < *b); }
+ *
+ *   if (!queue_sort(int, &q, compare_int))     // stable, front to back
+ *      handle_oom();
+ *   queue_radix_sort(int, &q);                 // by key_type at key_offset
+ */
+#define queue_sort(type, queue, compare) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_sort((queue), (compare)) \
+   )
+
+#define queue_radix_sort(type, queue) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_radix_sort((queue)) \
+   )
+
+
+/**
+ * DEFINE_QUEUE_REMOVE_IF macro
+ * ----------------------------
+ * Declares remove_if / retain_if / remove_value for a queue type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the queue
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE(...)
+ *    Use in combination with GENERATE_QUEUE_REMOVE_IF(...)
+ */
+#define DEFINE_QUEUE_REMOVE_IF(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+len_type type##_queue_remove_if(type##_queue_s *const restrict, bool (*const)(const type*, void*), void *const); \
+len_type type##_queue_retain_if(type##_queue_s *const restrict, bool (*const)(const type*, void*), void *const); \
+len_type type##_queue_remove_value(type##_queue_s *const restrict, const type);
+
+
+/**
+ * GENERATE_QUEUE_REMOVE_IF macro
+ * ------------------------------
+ * Implements remove_if / retain_if / remove_value for a queue type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   equal_fn - bool (type, type) equality, used for non-integral types
+ *
+ * Behavior:
+ *   - Single pass, in place, order of the survivors is preserved.
+ *   - Each contiguous segment of the ring is compacted on its own; if the
+ *     queue wraps, the survivors of the first segment are then moved up
+ *     against the end of the buffer (front moves, the ring is never
+ *     linearized).
+ *   - remove_if / retain_if: pred(&element, ctx) is called once per element,
+ *     front to back; the loop is branchless on the result.
+ *   - remove_value: integral types use the SIMD compress kernels from
+ *     compact.h (equal_fn unused), other types a scan with equal_fn.
+ *   - All return the number of elements removed. Capacity is unchanged.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_QUEUE(...)
+ *    Use in combination with DEFINE_QUEUE_REMOVE_IF(...)
+ */
+#define GENERATE_QUEUE_REMOVE_IF(type, len_type, equal_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(equal_fn, bool (type, type)); \
+   COMPACT_GENERATE_ARRAY(type##_queue, type) \
+\
+static inline len_type type##_queue_compact_close(type##_queue_s *const restrict queue, const len_type first_chunk, const len_type kept_first, const len_type kept_second) \
+{ \
+   const len_type removed = queue->len - kept_first - kept_second; \
+   if (first_chunk < queue->len) /* wrapped: close the gap before the end of the buffer */ \
+   { \
+      MEMORY_MOVE(&queue->values[queue->size - kept_first], &queue->values[queue->front], sizeof(type) * kept_first); \
+      queue->front = (queue->size - kept_first) & (queue->size - 1); \
+   } \
+   queue->len = kept_first + kept_second; \
+   return removed; \
+} \
+\
+static inline len_type type##_queue_compact(type##_queue_s *const restrict queue, bool (*const pred)(const type*, void*), void *const ctx, const bool remove) \
+{ \
+   assert(queue); \
+   assert(pred); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   const len_type kept_first = (len_type)type##_queue_compact_array(&queue->values[queue->front], first_chunk, pred, ctx, remove); \
+   const len_type kept_second = (len_type)type##_queue_compact_array(queue->values, queue->len - first_chunk, pred, ctx, remove); \
+   return type##_queue_compact_close(queue, first_chunk, kept_first, kept_second); \
+} \
+\
+len_type type##_queue_remove_if(type##_queue_s *const restrict queue, bool (*const pred)(const type*, void*), void *const ctx) \
+{ \
+   return type##_queue_compact(queue, pred, ctx, true); \
+} \
+\
+len_type type##_queue_retain_if(type##_queue_s *const restrict queue, bool (*const pred)(const type*, void*), void *const ctx) \
+{ \
+   return type##_queue_compact(queue, pred, ctx, false); \
+} \
+\
+len_type type##_queue_remove_value(type##_queue_s *const restrict queue, const type value) \
+{ \
+   assert(queue); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   len_type kept_first, kept_second; \
+   if (SEARCH_IS_INTEGRAL(type)) \
+   { \
+      kept_first = (len_type)compact_remove(&queue->values[queue->front], first_chunk, sizeof(type), &value); \
+      kept_second = (len_type)compact_remove(queue->values, queue->len - first_chunk, sizeof(type), &value); \
+   } \
+   else \
+   { \
+      kept_first = (len_type)type##_queue_compact_equal_array(&queue->values[queue->front], first_chunk, value, equal_fn); \
+      kept_second = (len_type)type##_queue_compact_equal_array(queue->values, queue->len - first_chunk, value, equal_fn); \
+   } \
+   return type##_queue_compact_close(queue, first_chunk, kept_first, kept_second); \
+}
+
+
+/**
+ * Queue remove macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_REMOVE_IF.
+ *
+ * Usage:
+ *   static bool is_even(const int *x, void *ctx) { (void)ctx; return *x % 2 == 0; }
+ *
+ *   len_type n = queue_remove_if(int, &q, is_even, NULL);   // drop even values
+ *   queue_retain_if(int, &q, is_even, NULL);                // keep only even values
+ *   queue_remove_value(int, &q, 42);                        // drop every 42
+ */
+#define queue_remove_if(type, queue, pred, ctx) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_remove_if((queue), (pred), (ctx)) \
+   )
+
+#define queue_retain_if(type, queue, pred, ctx) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_retain_if((queue), (pred), (ctx)) \
+   )
+
+#define queue_remove_value(type, queue, value) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_remove_value((queue), (value)) \
+   )
+
+
+/**
+ * DEFINE_QUEUE_HASH macro
+ * -----------------------
+ * Declares hash / equal for a queue type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the queue
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE(...)
+ *    Use in combination with GENERATE_QUEUE_HASH(...)
+ */
+#define DEFINE_QUEUE_HASH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+uint64_t type##_queue_hash(const type##_queue_s *const restrict, const uint64_t); \
+bool type##_queue_equal(const type##_queue_s *const, const type##_queue_s *const);
+
+
+/**
+ * GENERATE_QUEUE_HASH macro
+ * -------------------------
+ * Implements hash / equal for a queue type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *
+ * Behavior:
+ *   - hash(seed): 64-bit streaming hash (hash.h) of the bytes of the
+ *     elements, front to back, fed segment by segment without linearizing.
+ *     Capacity and the position of the wrap point do not affect the result.
+ *   - equal(a, b): same length and memcmp-equal elements; the two rings are
+ *     walked in runs that are contiguous in both (at most three memcmp
+ *     calls), so their fronts and sizes may differ.
+ *
+ * Notes:
+ *    Both work on the object representation: only use for element types
+ *    without padding bytes, and where bitwise equality is value equality.
+ *    Use only in a source (.c) file, after GENERATE_QUEUE(...)
+ *    Use in combination with DEFINE_QUEUE_HASH(...)
+ */
+#define GENERATE_QUEUE_HASH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+uint64_t type##_queue_hash(const type##_queue_s *const restrict queue, const uint64_t seed) \
+{ \
+   assert(queue); \
+   const len_type first_chunk = (queue->front + queue->len <= queue->size) ? queue->len : queue->size - queue->front; \
+   hash_state_s state; \
+   hash_init(&state, seed); \
+   hash_update(&state, &queue->values[queue->front], sizeof(type) * first_chunk); \
+   hash_update(&state, queue->values, sizeof(type) * (queue->len - first_chunk)); \
+   return hash_final(&state); \
+} \
+\
+bool type##_queue_equal(const type##_queue_s *const a, const type##_queue_s *const b) \
+{ \
+   assert(a); \
+   assert(b); \
+   if (a->len != b->len) \
+      return false; \
+\
+   for (len_type i = 0; i < a->len;) \
+   { \
+      const len_type index_a = (a->front + i) & (a->size - 1); \
+      const len_type index_b = (b->front + i) & (b->size - 1); \
+      len_type run = a->len - i; \
+      if (a->size - index_a < run) \
+         run = a->size - index_a; \
+      if (b->size - index_b < run) \
+         run = b->size - index_b; \
+      if (memcmp(&a->values[index_a], &b->values[index_b], sizeof(type) * run) != 0) \
+         return false; \
+      i += run; \
+   } \
+   return true; \
+}
+
+
+/**
+ * Queue hash macros
+ * -----------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_HASH.
+ *
+ * Usage:
+ *   uint64_t h = queue_hash(int, &q, 0);     // seed 0
+ *   if (queue_equal(int, &q, &r)) { ... }    // wrap points may differ
+ */
+#define queue_hash(type, queue, seed) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_hash((queue), (seed)) \
+   )
+
+#define queue_equal(type, a, b) \
+   typecheck_queue_ptr(a, type, typecheck_queue_ptr(b, type, \
+      type##_queue_equal((a), (b)) \
+   ))
+
+
+/**
+ * DEFINE_QUEUE_PARALLEL macro
+ * ---------------------------
+ * Declares parallel for_each / transform / reduce for a queue type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the queue
+ *   len_type - Integer type used for length/size
+ *   acc_type - Accumulator type of parallel_reduce
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE(...)
+ *    Use in combination with GENERATE_QUEUE_PARALLEL(...), Ensure macro arguments match
+ */
+#define DEFINE_QUEUE_PARALLEL(type, len_type, acc_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(acc_type); \
+\
+void type##_queue_parallel_for_each(type##_queue_s *const restrict, parallel_pool_s *const, void (*const)(type*, void*), void *const); \
+void type##_queue_parallel_transform(type##_queue_s *const restrict, parallel_pool_s *const, type (*const)(type, void*), void *const); \
+acc_type type##_queue_parallel_reduce(const type##_queue_s *const restrict, parallel_pool_s *const, const acc_type, acc_type (*const)(acc_type, const type*, void*), acc_type (*const)(acc_type, acc_type), void *const);
+
+
+/**
+ * GENERATE_QUEUE_PARALLEL macro
+ * -----------------------------
+ * Implements parallel for_each / transform / reduce for a queue type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   acc_type - Accumulator type of parallel_reduce
+ *
+ * Behavior:
+ *   - The elements are split into chunks with parallel_chunks (serial
+ *     below PARALLEL_SERIAL_THRESHOLD) and the chunks run on `pool`
+ *     (parallel.h); pool may be NULL for a serial pass.
+ *
+ *   - Chunks cover the logical order front to back; a chunk that crosses
+ *     the wrap point is processed as its two contiguous pieces.
+ *   - for_each(fn, ctx): fn(&element, ctx) for every element.
+ *   - transform(fn, ctx): element = fn(element, ctx) for every element.
+ *   - reduce(init, reduce_fn, combine_fn, ctx): each chunk folds its
+ *     elements in order with reduce_fn starting from init, then the chunk
+ *     results are folded in chunk order with combine_fn, starting from
+ *     init. init must be an identity of combine_fn; with an associative
+ *     combine_fn the result matches a serial fold.
+ *   - fn / reduce_fn run concurrently on different elements: they must
+ *     not touch the same shared state without synchronization.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_QUEUE(...)
+ *    Use in combination with DEFINE_QUEUE_PARALLEL(...), Ensure macro arguments match
+ */
+#define GENERATE_QUEUE_PARALLEL(type, len_type, acc_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(acc_type); \
+\
+typedef struct \
+{ \
+   type *values; \
+   size_t front; \
+   size_t len; \
+   size_t size; \
+   size_t chunk; \
+   void (*for_each_fn)(type*, void*); \
+   type (*transform_fn)(type, void*); \
+   acc_type (*reduce_fn)(acc_type, const type*, void*); \
+   acc_type init; \
+   acc_type *partials; \
+   void *ctx; \
+} type##_queue_parallel_job_s; \
+\
+static inline void type##_queue_parallel_span(const type##_queue_parallel_job_s *const restrict job, const size_t index, type **const first, size_t *const first_len, type **const second, size_t *const second_len) \
+{ \
+   const size_t lo = index * job->chunk; \
+   const size_t hi = (lo + job->chunk < job->len) ? lo + job->chunk : job->len; \
+   const size_t start = (job->front + lo) & (job->size - 1); \
+   *first = job->values + start; \
+   *first_len = (start + (hi - lo) <= job->size) ? hi - lo : job->size - start; \
+   *second = job->values; \
+   *second_len = (hi - lo) - *first_len; \
+} \
+\
+static void type##_queue_parallel_for_each_task(void *const arg, const size_t index) \
+{ \
+   const type##_queue_parallel_job_s *const job = (const type##_queue_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_queue_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         job->for_each_fn(&pieces[p][i], job->ctx); \
+} \
+\
+static void type##_queue_parallel_transform_task(void *const arg, const size_t index) \
+{ \
+   const type##_queue_parallel_job_s *const job = (const type##_queue_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_queue_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         pieces[p][i] = job->transform_fn(pieces[p][i], job->ctx); \
+} \
+\
+static void type##_queue_parallel_reduce_task(void *const arg, const size_t index) \
+{ \
+   const type##_queue_parallel_job_s *const job = (const type##_queue_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_queue_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   acc_type acc = job->init; \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         acc = job->reduce_fn(acc, &pieces[p][i], job->ctx); \
+   job->partials[index] = acc; \
+} \
+\
+void type##_queue_parallel_for_each(type##_queue_s *const restrict queue, parallel_pool_s *const pool, void (*const fn)(type*, void*), void *const ctx) \
+{ \
+   assert(queue); \
+   assert(fn); \
+   type##_queue_parallel_job_s job = { .values = queue->values, .front = queue->front, .len = queue->len, .size = queue->size }; \
+   job.for_each_fn = fn; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, queue->len, &job.chunk); \
+   parallel_run(pool, tasks, type##_queue_parallel_for_each_task, &job); \
+} \
+\
+void type##_queue_parallel_transform(type##_queue_s *const restrict queue, parallel_pool_s *const pool, type (*const fn)(type, void*), void *const ctx) \
+{ \
+   assert(queue); \
+   assert(fn); \
+   type##_queue_parallel_job_s job = { .values = queue->values, .front = queue->front, .len = queue->len, .size = queue->size }; \
+   job.transform_fn = fn; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, queue->len, &job.chunk); \
+   parallel_run(pool, tasks, type##_queue_parallel_transform_task, &job); \
+} \
+\
+acc_type type##_queue_parallel_reduce(const type##_queue_s *const restrict queue, parallel_pool_s *const pool, const acc_type init, acc_type (*const reduce_fn)(acc_type, const type*, void*), acc_type (*const combine_fn)(acc_type, acc_type), void *const ctx) \
+{ \
+   assert(queue); \
+   assert(reduce_fn); \
+   assert(combine_fn); \
+   acc_type partials[PARALLEL_MAX_TASKS]; \
+   type##_queue_parallel_job_s job = { .values = queue->values, .front = queue->front, .len = queue->len, .size = queue->size }; \
+   job.reduce_fn = reduce_fn; \
+   job.init = init; \
+   job.partials = partials; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, queue->len, &job.chunk); \
+   assert(tasks <= PARALLEL_MAX_TASKS); \
+   parallel_run(pool, tasks, type##_queue_parallel_reduce_task, &job); \
+\
+   acc_type result = init; \
+   for (size_t i = 0; i < tasks; i++) \
+      result = combine_fn(result, partials[i]); \
+   return result; \
+}
+
+/**
+ * Queue parallel macros
+ * ---------------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_PARALLEL.
+ *
+ * Usage:
+ *   parallel_pool_s pool;
+ *   parallel_pool_init(&pool, 0);                                   // one thread per CPU
+ *
+ *   queue_parallel_for_each(int, &q, &pool, clamp, &limits);       // void clamp(int*, void*)
+ *   queue_parallel_transform(int, &q, &pool, square, NULL);         // int square(int, void*)
+ *   int64_t sum = queue_parallel_reduce(int, &q, &pool, 0, add, add64, NULL);
+ *
+ *   parallel_pool_delete(&pool);
+ */
+#define queue_parallel_for_each(type, queue, pool, fn, ctx) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_parallel_for_each((queue), (pool), (fn), (ctx)) \
+   )
+
+#define queue_parallel_transform(type, queue, pool, fn, ctx) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_parallel_transform((queue), (pool), (fn), (ctx)) \
+   )
+
+#define queue_parallel_reduce(type, queue, pool, init, reduce_fn, combine_fn, ctx) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_parallel_reduce((queue), (pool), (init), (reduce_fn), (combine_fn), (ctx)) \
+   )
+
+
+/**
+ * DEFINE_QUEUE_PARALLEL_SORT macro
+ * --------------------------------
+ * Declares the multi-threaded sort functions for a queue type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the queue
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_QUEUE_SORT(...)
+ *    Use in combination with GENERATE_QUEUE_PARALLEL_SORT(...), Ensure macro arguments match
+ */
+#define DEFINE_QUEUE_PARALLEL_SORT(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+bool type##_queue_parallel_sort(type##_queue_s *const restrict, parallel_pool_s *const, int (*const)(const type*, const type*));
+
+
+/**
+ * GENERATE_QUEUE_PARALLEL_SORT macro
+ * ----------------------------------
+ * Implements the multi-threaded sort functions for a queue type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   alloc_fn - Allocator for the scratch buffer (the queue's own allocator)
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - parallel_sort(pool, compare): same result as sort. The elements are
+ *     cut into runs that are sorted on `pool`, then merged in parallel (see
+ *     SORT_GENERATE_PARALLEL).
+ *   - A wrapped ring is unwrapped into the scratch buffer, sorted there and
+ *     merged back into values[0..len) with front reset to 0; an unwrapped
+ *     ring is merged into the scratch buffer and copied back in place.
+ *     Both copies are split across the pool.
+ *   - pool may be NULL, and below PARALLEL_SERIAL_THRESHOLD elements the
+ *     serial sort runs.
+ *   - Allocates one scratch buffer of len elements and returns false if
+ *     that allocation fails (queue left unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_QUEUE_SORT(...)
+ *    Use in combination with DEFINE_QUEUE_PARALLEL_SORT(...), Ensure macro arguments match
+ */
+#define GENERATE_QUEUE_PARALLEL_SORT(type, len_type, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+   SORT_GENERATE_PARALLEL(type##_queue, type) \
+\
+/* queue_sort_unwrap with the copies split across the pool */ \
+static inline type *type##_queue_parallel_sort_unwrap(type##_queue_s *const restrict queue, parallel_pool_s *const pool, type *const restrict scratch, type **const data, type **const spare) \
+{ \
+   if (queue->front + queue->len <= queue->size) /* not wrapped: sort in place */ \
+   { \
+      *data = &queue->values[queue->front]; \
+      *spare = scratch; \
+      return *data; \
+   } \
+\
+   const len_type first_chunk = queue->size - queue->front; \
+   parallel_copy(pool, scratch, &queue->values[queue->front], sizeof(type) * first_chunk); \
+   parallel_copy(pool, scratch + first_chunk, queue->values, sizeof(type) * (queue->len - first_chunk)); \
+   queue->front = 0; \
+   *data = scratch; \
+   *spare = queue->values; \
+   return queue->values; \
+} \
+\
+bool type##_queue_parallel_sort(type##_queue_s *const restrict queue, parallel_pool_s *const pool, int (*const compare)(const type*, const type*)) \
+{ \
+   assert(queue); \
+   assert(compare); \
+   if (queue->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * queue->len); \
+   if (!scratch) \
+      return false; \
+\
+   type *data, *spare; \
+   type *const base = type##_queue_parallel_sort_unwrap(queue, pool, scratch, &data, &spare); \
+   const type *const sorted = type##_queue_parallel_merge_sort_array(data, spare, queue->len, compare, pool); \
+   if (sorted != base) \
+      parallel_copy(pool, base, sorted, sizeof(type) * queue->len); \
+   free_fn(scratch); \
+   return true; \
+}
+
+/**
+ * Queue parallel sort macros
+ * --------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_QUEUE_PARALLEL_SORT.
+ *
+ * Usage:
+ *   if (!queue_parallel_sort(int, &d, &pool, compare_int))     // stable, front to back
+ *      handle_oom();
+ */
+#define queue_parallel_sort(type, queue, pool, compare) \
+   typecheck_queue_ptr(queue, type, \
+      type##_queue_parallel_sort((queue), (pool), (compare)) \
+   )
+
+
 #endif /* __QUEUE_H */
\ No newline at end of file
@@ -0,0 +1,364 @@
+#ifndef __RADIX_HEAP_H
+#define __RADIX_HEAP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <string.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "stack.h"
+
+
+/**
+ * Radix heap
+ * ----------
+ * A monotone priority queue over unsigned integer keys: a popped key is
+ * never larger than any key pushed after it (timers, Dijkstra with integer
+ * weights). Elements live in one stack per bucket:
+ *
+ *   bucket 0     - key == last (the last key popped, 0 after init or clear)
+ *   bucket i > 0 - highest bit in which key and last differ is bit i - 1
+ *
+ * A pop that finds bucket 0 empty first empties the lowest non-empty
+ * bucket into the buckets below it, relative to its smallest key (the new
+ * last). Every element can only move down, at most once per bit of the
+ * key, so push and pop are O(1) amortised with no key comparisons beyond
+ * finding that minimum.
+ */
+
+/* bucket of an element whose key differs from last by `diff`: bit width of diff */
+static inline uint32_t radix_heap_bucket(const uint64_t diff)
+{
+   if (diff == 0)
+      return 0;
+#if defined(__GNUC__) || defined(__clang__)
+   return 64 - (uint32_t)__builtin_clzll(diff);
+#else
+   uint32_t n = 0;
+   while (n < 64 && (diff >> n)) /* a shift by 64 is undefined */
+      n++;
+   return n;
+#endif
+}
+
+#define RADIX_HEAP_BUCKETS(key_type) \
+   (sizeof(key_type) * CHAR_BIT + 1)
+
+
+/**
+ * DEFINE_RADIX_HEAP macro
+ * -----------------------
+ * Defines a radix heap of `type` ordered by an unsigned `key_type` key,
+ * with one stack of `type` per bucket.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the heap
+ *   len_type - Integer type used for length/size (the stack's len_type)
+ *   key_type - Unsigned integer key type (8 to 64 bits)
+ *
+ * Output:
+ *   Declaration of radix heap for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(type, len_type, ...)
+ *    Use in combination with GENERATE_RADIX_HEAP(...), Ensure macro arguments match
+ *    Every bucket carries the stack's inline buffer: keep init_size small.
+ */
+#define DEFINE_RADIX_HEAP(type, len_type, key_type) \
+   static_assert((key_type)-1 > 0, "Warning: key_type must be unsigned"); \
+   static_assert(sizeof(key_type) <= sizeof(uint64_t), "Warning: key_type too big"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   type##_stack_s buckets[RADIX_HEAP_BUCKETS(key_type)]; \
+   key_type last; \
+   len_type len; \
+} type##_radix_heap_s; \
+\
+static inline void type##_radix_heap_init(type##_radix_heap_s *const restrict heap) \
+{ \
+   for (size_t i = 0; i < RADIX_HEAP_BUCKETS(key_type); i++) \
+      type##_stack_init(&heap->buckets[i]); \
+   heap->last = 0; \
+   heap->len = 0; \
+} \
+\
+static inline void type##_radix_heap_clear(type##_radix_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   for (size_t i = 0; i < RADIX_HEAP_BUCKETS(key_type); i++) \
+      heap->buckets[i].len = 0; \
+   heap->last = 0; \
+   heap->len = 0; \
+} \
+\
+void type##_radix_heap_delete(type##_radix_heap_s *const restrict); \
+type type##_radix_heap_peek(const type##_radix_heap_s *const restrict); \
+key_type type##_radix_heap_peek_key(const type##_radix_heap_s *const restrict); \
+bool type##_radix_heap_push(type##_radix_heap_s *const restrict, const type); \
+bool type##_radix_heap_pop(type##_radix_heap_s *const restrict);
+
+
+/**
+ * radix_heap(type) macro
+ * ----------------------
+ * Declares a radix heap variable of the given type.
+ *
+ * Usage (as variable):
+ *   radix_heap(timer_s) timers;
+ *
+ * Usage (as parameter):
+ *   void expire(radix_heap(timer_s) *const timers) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (type##_radix_heap_s).
+ */
+#define radix_heap(type) \
+   type##_radix_heap_s
+
+
+/**
+ * typecheck_radix_heap_ptr macro
+ * ------------------------------
+ * Compile-time validation that 'var' is a pointer to a radix heap of 'type'
+ * (see typecheck_ptr).
+ */
+#define typecheck_radix_heap_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_radix_heap_s, expr)
+
+
+/**
+ * Radix Heap Expression Macros
+ * ----------------------------
+ * Direct access to radix heap properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   while (!radix_heap_empty(timer_s, &timers) && radix_heap_peek_key(timer_s, &timers) <= now)
+ *   {
+ *      fire(radix_heap_peek(timer_s, &timers));
+ *      radix_heap_pop(timer_s, &timers);
+ *   }
+ */
+#define radix_heap_len(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      (heap)->len \
+   )
+
+#define radix_heap_empty(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      (heap)->len == 0 \
+   )
+
+
+/**
+ * GENERATE_RADIX_HEAP macro
+ * -------------------------
+ * Implements the radix heap functions for a type.
+ *
+ * Parameters:
+ *   type       - Element type
+ *   len_type   - Unsigned integer type for length & size
+ *   key_type   - Unsigned integer key type
+ *   key_offset - Byte offset of the key in type (0 when key_type is type,
+ *                offsetof(type, field) for struct keys)
+ *
+ * Behavior:
+ *   - push(value): the key must not be smaller than the last key popped
+ *     (asserted; 0 after init or clear); false if the bucket's stack cannot
+ *     grow.
+ *   - pop(): removes an element with the smallest key; false when empty.
+ *     When bucket 0 is empty, the next bucket is redistributed first and
+ *     pop returns false if a stack cannot grow (heap unchanged).
+ *   - peek() / peek_key(): an element with the smallest key / that key.
+ *     O(1) while bucket 0 has elements, otherwise a scan of the bucket the
+ *     next pop redistributes.
+ *   - Elements with equal keys come out in no particular order, but pop()
+ *     always removes the element peek() returned.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(type, len_type, ...)
+ *    Use in combination with DEFINE_RADIX_HEAP(...), Ensure macro arguments match
+ */
+#define GENERATE_RADIX_HEAP(type, len_type, key_type, key_offset) \
+   static_assert((key_offset) + sizeof(key_type) <= sizeof(type), "Warning: key_offset out of range"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+static inline key_type type##_radix_heap_key(const type *const restrict value) \
+{ \
+   key_type key; \
+   memcpy(&key, (const unsigned char*)value + (key_offset), sizeof(key_type)); \
+   return key; \
+} \
+\
+/* lowest non-empty bucket, with bucket 0 empty */ \
+static inline size_t type##_radix_heap_next_bucket(const type##_radix_heap_s *const restrict heap) \
+{ \
+   size_t i = 1; \
+   while (heap->buckets[i].len == 0) \
+      i++; \
+   return i; \
+} \
+\
+/* an element with the smallest key in a non-empty bucket */ \
+static inline const type *type##_radix_heap_min(const type##_stack_s *const restrict bucket) \
+{ \
+   const type *min = &bucket->values[0]; \
+   key_type min_key = type##_radix_heap_key(min); \
+   for (len_type j = 1; j < bucket->len; j++) \
+   { \
+      const key_type key = type##_radix_heap_key(&bucket->values[j]); \
+      if (key < min_key) \
+      { \
+         min = &bucket->values[j]; \
+         min_key = key; \
+      } \
+   } \
+   return min; \
+} \
+\
+static inline const type *type##_radix_heap_top(const type##_radix_heap_s *const restrict heap) \
+{ \
+   const type##_stack_s *const top = &heap->buckets[0]; \
+   if (top->len > 0) \
+      return &top->values[top->len - 1]; \
+   return type##_radix_heap_min(&heap->buckets[type##_radix_heap_next_bucket(heap)]); \
+} \
+\
+/* empties the lowest non-empty bucket into the buckets below it, with bucket 0 empty */ \
+static bool type##_radix_heap_refill(type##_radix_heap_s *const restrict heap) \
+{ \
+   const size_t i = type##_radix_heap_next_bucket(heap); \
+   type##_stack_s *const from = &heap->buckets[i]; \
+   const type *const min = type##_radix_heap_min(from); \
+   const key_type last = type##_radix_heap_key(min); \
+\
+   /* grow every target first, so a failed allocation moves nothing */ \
+   len_type counts[RADIX_HEAP_BUCKETS(key_type)] = { 0 }; \
+   for (len_type j = 0; j < from->len; j++) \
+      counts[radix_heap_bucket((uint64_t)(type##_radix_heap_key(&from->values[j]) ^ last))]++; \
+   for (size_t b = 0; b < i; b++) \
+      while (heap->buckets[b].size - heap->buckets[b].len < counts[b]) \
+         if (!type##_stack_resize(&heap->buckets[b])) \
+            return false; \
+\
+   /* the element peek() returned goes on top of bucket 0, so pop() removes that one */ \
+   heap->last = last; \
+   for (len_type j = 0; j < from->len; j++) \
+   { \
+      if (&from->values[j] == min) \
+         continue; \
+      const type value = from->values[j]; \
+      type##_stack_s *const to = &heap->buckets[radix_heap_bucket((uint64_t)(type##_radix_heap_key(&value) ^ last))]; \
+      to->values[to->len++] = value; \
+   } \
+   heap->buckets[0].values[heap->buckets[0].len++] = *min; \
+   from->len = 0; \
+   return true; \
+} \
+\
+void type##_radix_heap_delete(type##_radix_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   for (size_t i = 0; i < RADIX_HEAP_BUCKETS(key_type); i++) \
+      type##_stack_delete(&heap->buckets[i]); \
+   heap->last = 0; \
+   heap->len = 0; \
+} \
+\
+type type##_radix_heap_peek(const type##_radix_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->len > 0); \
+   return *type##_radix_heap_top(heap); \
+} \
+\
+key_type type##_radix_heap_peek_key(const type##_radix_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   assert(heap->len > 0); \
+   return heap->buckets[0].len ? heap->last : type##_radix_heap_key(type##_radix_heap_top(heap)); \
+} \
+\
+bool type##_radix_heap_push(type##_radix_heap_s *const restrict heap, const type value) \
+{ \
+   assert(heap); \
+   const key_type key = type##_radix_heap_key(&value); \
+   assert(key >= heap->last); /* monotone */ \
+\
+   if (!type##_stack_push(&heap->buckets[radix_heap_bucket((uint64_t)(key ^ heap->last))], value)) \
+      return false; \
+   heap->len++; \
+   return true; \
+} \
+\
+bool type##_radix_heap_pop(type##_radix_heap_s *const restrict heap) \
+{ \
+   assert(heap); \
+   if (heap->len == 0) \
+      return false; \
+\
+   if (heap->buckets[0].len == 0 && !type##_radix_heap_refill(heap)) \
+      return false; \
+   heap->buckets[0].len--; \
+   heap->len--; \
+   return true; \
+}
+
+
+/**
+ * Radix heap function macros
+ * --------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_RADIX_HEAP.
+ *
+ * Usage:
+ *   radix_heap(uint32_t) h;
+ *   radix_heap_init(uint32_t, &h);
+ *   radix_heap_push(uint32_t, &h, 40);           // false on allocation failure
+ *   radix_heap_push(uint32_t, &h, 12);
+ *   uint32_t low = radix_heap_peek(uint32_t, &h); // 12
+ *   radix_heap_pop(uint32_t, &h);
+ *   radix_heap_push(uint32_t, &h, 30);           // >= 12: keys only move forward
+ *   radix_heap_delete(uint32_t, &h);
+ */
+#define radix_heap_init(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_init((heap)) \
+   )
+
+#define radix_heap_delete(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_delete((heap)) \
+   )
+
+#define radix_heap_clear(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_clear((heap)) \
+   )
+
+#define radix_heap_peek(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_peek((heap)) \
+   )
+
+#define radix_heap_peek_key(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_peek_key((heap)) \
+   )
+
+#define radix_heap_push(type, heap, value) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_push((heap), (value)) \
+   )
+
+#define radix_heap_pop(type, heap) \
+   typecheck_radix_heap_ptr(heap, type, \
+      type##_radix_heap_pop((heap)) \
+   )
+
+
+#endif /* __RADIX_HEAP_H */
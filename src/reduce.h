@@ -0,0 +1,313 @@
+#ifndef __REDUCE_H
+#define __REDUCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <math.h>
+
+
+/**
+ * Reduction kernels
+ * -----------------
+ * Sum / min / max over contiguous float and double arrays.
+ *
+ * Functions:
+ *   reduce_sum_f32(values, n), reduce_sum_f64(values, n)
+ *   reduce_min_f32(values, n), reduce_min_f64(values, n)
+ *   reduce_max_f32(values, n), reduce_max_f64(values, n)
+ *   reduce_find_f32(values, n, target), reduce_find_f64(values, n, target)
+ *     - index of the first element == target (the first NaN if target is
+ *       NaN), or n; argmin / argmax run it on the min / max
+ *
+ * Behavior:
+ *   - AVX2: 256-bit lanes, two accumulators for the sum.
+ *   - SSE2: 128-bit lanes.
+ *   - Otherwise: scalar loop.
+ *   - NaN propagates: sum follows IEEE rules, min/max return NAN if any
+ *     element is NaN (the vector min/max instructions alone would drop it).
+ *   - find: compare + movemask per vector; -0.0 matches 0.0.
+ *
+ * Notes:
+ *   min/max require n > 0 (asserted).
+ *   Vector sums reassociate, so results may differ from a sequential loop
+ *   in the last bits.
+ */
+
+#if defined(__AVX2__)
+   #include <immintrin.h>
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+#endif
+
+static inline float reduce_sum_f32(const float *const restrict values, const size_t n)
+{
+   size_t i = 0;
+   float sum = 0.0f;
+
+#if defined(__AVX2__)
+   __m256 acc0 = _mm256_setzero_ps();
+   __m256 acc1 = _mm256_setzero_ps();
+   for (; i + 16 <= n; i += 16)
+   {
+      acc0 = _mm256_add_ps(acc0, _mm256_loadu_ps(values + i));
+      acc1 = _mm256_add_ps(acc1, _mm256_loadu_ps(values + i + 8));
+   }
+   float lanes[8];
+   _mm256_storeu_ps(lanes, _mm256_add_ps(acc0, acc1));
+   for (size_t j = 0; j < 8; j++)
+      sum += lanes[j];
+#elif defined(__SSE2__)
+   __m128 acc0 = _mm_setzero_ps();
+   __m128 acc1 = _mm_setzero_ps();
+   for (; i + 8 <= n; i += 8)
+   {
+      acc0 = _mm_add_ps(acc0, _mm_loadu_ps(values + i));
+      acc1 = _mm_add_ps(acc1, _mm_loadu_ps(values + i + 4));
+   }
+   float lanes[4];
+   _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+   for (size_t j = 0; j < 4; j++)
+      sum += lanes[j];
+#endif
+
+   for (; i < n; i++)
+      sum += values[i];
+   return sum;
+}
+
+static inline double reduce_sum_f64(const double *const restrict values, const size_t n)
+{
+   size_t i = 0;
+   double sum = 0.0;
+
+#if defined(__AVX2__)
+   __m256d acc0 = _mm256_setzero_pd();
+   __m256d acc1 = _mm256_setzero_pd();
+   for (; i + 8 <= n; i += 8)
+   {
+      acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + i));
+      acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + i + 4));
+   }
+   double lanes[4];
+   _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+   for (size_t j = 0; j < 4; j++)
+      sum += lanes[j];
+#elif defined(__SSE2__)
+   __m128d acc0 = _mm_setzero_pd();
+   __m128d acc1 = _mm_setzero_pd();
+   for (; i + 4 <= n; i += 4)
+   {
+      acc0 = _mm_add_pd(acc0, _mm_loadu_pd(values + i));
+      acc1 = _mm_add_pd(acc1, _mm_loadu_pd(values + i + 2));
+   }
+   double lanes[2];
+   _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+   sum += lanes[0] + lanes[1];
+#endif
+
+   for (; i < n; i++)
+      sum += values[i];
+   return sum;
+}
+
+
+/* op: min / max, cmp: < / > */
+#define REDUCE_GENERATE_MIN_MAX(op, cmp) \
+static inline float reduce_##op##_f32(const float *const restrict values, const size_t n) \
+{ \
+   assert(n > 0); \
+   size_t i = 0; \
+   float result = values[0]; \
+   REDUCE_VECTOR_##op##_F32(values, n, i, result) \
+   for (; i < n; i++) \
+   { \
+      if (values[i] != values[i]) \
+         return NAN; \
+      if (values[i] cmp result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline double reduce_##op##_f64(const double *const restrict values, const size_t n) \
+{ \
+   assert(n > 0); \
+   size_t i = 0; \
+   double result = values[0]; \
+   REDUCE_VECTOR_##op##_F64(values, n, i, result) \
+   for (; i < n; i++) \
+   { \
+      if (values[i] != values[i]) \
+         return NAN; \
+      if (values[i] cmp result) \
+         result = values[i]; \
+   } \
+   return result; \
+}
+
+#if defined(__AVX2__)
+   #define REDUCE_VECTOR_MIN_MAX(vec, width, suffix, intrin, values, n, i, result) \
+   { \
+      vec acc = _mm256_set1_##suffix(result); \
+      vec nan = _mm256_setzero_##suffix(); \
+      for (; i + width <= n; i += width) \
+      { \
+         const vec v = _mm256_loadu_##suffix(values + i); \
+         acc = intrin(acc, v); \
+         nan = _mm256_or_##suffix(nan, _mm256_cmp_##suffix(v, v, _CMP_UNORD_Q)); \
+      } \
+      if (_mm256_movemask_##suffix(nan)) \
+         return NAN; \
+      __typeof__(result) lanes[width]; \
+      _mm256_storeu_##suffix(lanes, acc); \
+      for (size_t j = 0; j < width; j++) \
+         result = REDUCE_LANE_##intrin(result, lanes[j]); \
+   }
+   #define REDUCE_LANE__mm256_min_ps(a, b) ((b) < (a) ? (b) : (a))
+   #define REDUCE_LANE__mm256_min_pd(a, b) ((b) < (a) ? (b) : (a))
+   #define REDUCE_LANE__mm256_max_ps(a, b) ((b) > (a) ? (b) : (a))
+   #define REDUCE_LANE__mm256_max_pd(a, b) ((b) > (a) ? (b) : (a))
+   #define REDUCE_VECTOR_min_F32(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m256, 8, ps, _mm256_min_ps, values, n, i, result)
+   #define REDUCE_VECTOR_max_F32(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m256, 8, ps, _mm256_max_ps, values, n, i, result)
+   #define REDUCE_VECTOR_min_F64(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m256d, 4, pd, _mm256_min_pd, values, n, i, result)
+   #define REDUCE_VECTOR_max_F64(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m256d, 4, pd, _mm256_max_pd, values, n, i, result)
+
+#elif defined(__SSE2__)
+   #define REDUCE_VECTOR_MIN_MAX(vec, width, suffix, intrin, values, n, i, result) \
+   { \
+      vec acc = _mm_set1_##suffix(result); \
+      vec nan = _mm_setzero_##suffix(); \
+      for (; i + width <= n; i += width) \
+      { \
+         const vec v = _mm_loadu_##suffix(values + i); \
+         acc = intrin(acc, v); \
+         nan = _mm_or_##suffix(nan, _mm_cmpunord_##suffix(v, v)); \
+      } \
+      if (_mm_movemask_##suffix(nan)) \
+         return NAN; \
+      __typeof__(result) lanes[width]; \
+      _mm_storeu_##suffix(lanes, acc); \
+      for (size_t j = 0; j < width; j++) \
+         result = REDUCE_LANE_##intrin(result, lanes[j]); \
+   }
+   #define REDUCE_LANE__mm_min_ps(a, b) ((b) < (a) ? (b) : (a))
+   #define REDUCE_LANE__mm_min_pd(a, b) ((b) < (a) ? (b) : (a))
+   #define REDUCE_LANE__mm_max_ps(a, b) ((b) > (a) ? (b) : (a))
+   #define REDUCE_LANE__mm_max_pd(a, b) ((b) > (a) ? (b) : (a))
+   #define REDUCE_VECTOR_min_F32(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m128, 4, ps, _mm_min_ps, values, n, i, result)
+   #define REDUCE_VECTOR_max_F32(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m128, 4, ps, _mm_max_ps, values, n, i, result)
+   #define REDUCE_VECTOR_min_F64(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m128d, 2, pd, _mm_min_pd, values, n, i, result)
+   #define REDUCE_VECTOR_max_F64(values, n, i, result) REDUCE_VECTOR_MIN_MAX(__m128d, 2, pd, _mm_max_pd, values, n, i, result)
+
+#else
+   #define REDUCE_VECTOR_min_F32(values, n, i, result)
+   #define REDUCE_VECTOR_max_F32(values, n, i, result)
+   #define REDUCE_VECTOR_min_F64(values, n, i, result)
+   #define REDUCE_VECTOR_max_F64(values, n, i, result)
+
+#endif
+
+REDUCE_GENERATE_MIN_MAX(min, <)
+REDUCE_GENERATE_MIN_MAX(max, >)
+
+
+#define REDUCE_GENERATE_FIND(suffix, scalar) \
+static inline size_t reduce_find_##suffix(const scalar *const restrict values, const size_t n, const scalar target) \
+{ \
+   const bool is_nan = (target != target); \
+   size_t i = 0; \
+   REDUCE_VECTOR_FIND_##suffix(values, n, i, target, is_nan) \
+   for (; i < n; i++) \
+      if (is_nan ? (values[i] != values[i]) : (values[i] == target)) \
+         return i; \
+   return n; \
+}
+
+#if defined(__AVX2__)
+   #define REDUCE_VECTOR_FIND(vec, width, suffix, values, n, i, target, is_nan) \
+   { \
+      const vec needle = _mm256_set1_##suffix(target); \
+      for (; i + width <= n; i += width) \
+      { \
+         const vec v = _mm256_loadu_##suffix(values + i); \
+         const uint32_t mask = (uint32_t)_mm256_movemask_##suffix(is_nan ? _mm256_cmp_##suffix(v, v, _CMP_UNORD_Q) \
+                                                                          : _mm256_cmp_##suffix(v, needle, _CMP_EQ_OQ)); \
+         if (mask) \
+            return i + (size_t)__builtin_ctz(mask); \
+      } \
+   }
+   #define REDUCE_VECTOR_FIND_f32(values, n, i, target, is_nan) REDUCE_VECTOR_FIND(__m256, 8, ps, values, n, i, target, is_nan)
+   #define REDUCE_VECTOR_FIND_f64(values, n, i, target, is_nan) REDUCE_VECTOR_FIND(__m256d, 4, pd, values, n, i, target, is_nan)
+
+#elif defined(__SSE2__)
+   #define REDUCE_VECTOR_FIND(vec, width, suffix, values, n, i, target, is_nan) \
+   { \
+      const vec needle = _mm_set1_##suffix(target); \
+      for (; i + width <= n; i += width) \
+      { \
+         const vec v = _mm_loadu_##suffix(values + i); \
+         const uint32_t mask = (uint32_t)_mm_movemask_##suffix(is_nan ? _mm_cmpunord_##suffix(v, v) : _mm_cmpeq_##suffix(v, needle)); \
+         if (mask) \
+            return i + (size_t)__builtin_ctz(mask); \
+      } \
+   }
+   #define REDUCE_VECTOR_FIND_f32(values, n, i, target, is_nan) REDUCE_VECTOR_FIND(__m128, 4, ps, values, n, i, target, is_nan)
+   #define REDUCE_VECTOR_FIND_f64(values, n, i, target, is_nan) REDUCE_VECTOR_FIND(__m128d, 2, pd, values, n, i, target, is_nan)
+
+#else
+   #define REDUCE_VECTOR_FIND_f32(values, n, i, target, is_nan)
+   #define REDUCE_VECTOR_FIND_f64(values, n, i, target, is_nan)
+
+#endif
+
+REDUCE_GENERATE_FIND(f32, float)
+REDUCE_GENERATE_FIND(f64, double)
+
+
+/**
+ * REDUCE_DISPATCH macro
+ * ---------------------
+ * Selects the float / double kernel for a pointer, or `fallback_fn` for any
+ * other element type. Expands to a function designator.
+ *
+ * Usage:
+ *   REDUCE_DISPATCH(values, reduce_min_f32, reduce_min_f64, my_scalar_min)(values, n)
+ *   REDUCE_SUM_DISPATCH(values, sum_type, my_scalar_sum)(values, n)
+ *
+ * Behavior:
+ *   - C11+: _Generic on the pointer type.
+ *   - C99 fallback: always `fallback_fn`.
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)  /* C11+ */
+   #define REDUCE_DISPATCH(ptr, f32_fn, f64_fn, fallback_fn) \
+      _Generic((ptr), \
+         float*: f32_fn, \
+         const float*: f32_fn, \
+         double*: f64_fn, \
+         const double*: f64_fn, \
+         default: fallback_fn \
+      )
+
+   /* sum kernels only apply when the accumulator is the element type */
+   #define REDUCE_SUM_DISPATCH(ptr, sum_type, fallback_fn) \
+      _Generic((ptr), \
+         float*: _Generic((sum_type){0}, float: reduce_sum_f32, default: fallback_fn), \
+         const float*: _Generic((sum_type){0}, float: reduce_sum_f32, default: fallback_fn), \
+         double*: _Generic((sum_type){0}, double: reduce_sum_f64, default: fallback_fn), \
+         const double*: _Generic((sum_type){0}, double: reduce_sum_f64, default: fallback_fn), \
+         default: fallback_fn \
+      )
+
+#else /* C99 fallback */
+   #define REDUCE_DISPATCH(ptr, f32_fn, f64_fn, fallback_fn) \
+      fallback_fn
+
+   #define REDUCE_SUM_DISPATCH(ptr, sum_type, fallback_fn) \
+      fallback_fn
+
+#endif
+
+
+#endif /* __REDUCE_H */
\ No newline at end of file
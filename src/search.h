@@ -0,0 +1,225 @@
+#ifndef __SEARCH_H
+#define __SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/**
+ * Search kernels
+ * --------------
+ * Linear search primitives over contiguous arrays of 1, 2, 4 or 8 byte
+ * elements, compared bit-for-bit against a needle.
+ *
+ * Functions:
+ *   search_find_<bits>(values, n, value)  - index of first match, or n
+ *   search_count_<bits>(values, n, value) - number of matches
+ *   search_find(values, n, width, value)  - dispatch on element width
+ *   search_count(values, n, width, value) - dispatch on element width
+ *
+ * Behavior:
+ *   - AVX2: 32-byte compare + movemask per iteration.
+ *   - SSE2: 16-byte compare + movemask per iteration
+ *           (64-bit equality is built from two 32-bit compares).
+ *   - Otherwise: scalar loop.
+ *
+ * Notes:
+ *   Only use for types where bitwise equality is value equality
+ *   (integers, enums, bool). Floats compare -0.0 != 0.0 and NaN == NaN here.
+ */
+
+// AVX2
+#if defined(__AVX2__)
+   #include <immintrin.h>
+   #define SEARCH_VECTOR_BYTES 32
+   #define search_vector_t __m256i
+   #define search_load(ptr) _mm256_loadu_si256((const __m256i*)(ptr))
+   #define search_movemask(vec) ((uint32_t)_mm256_movemask_epi8(vec))
+   #define search_set1_8(x) _mm256_set1_epi8((char)(x))
+   #define search_set1_16(x) _mm256_set1_epi16((short)(x))
+   #define search_set1_32(x) _mm256_set1_epi32((int)(x))
+   #define search_set1_64(x) _mm256_set1_epi64x((long long)(x))
+   #define search_cmpeq_8(a, b) _mm256_cmpeq_epi8(a, b)
+   #define search_cmpeq_16(a, b) _mm256_cmpeq_epi16(a, b)
+   #define search_cmpeq_32(a, b) _mm256_cmpeq_epi32(a, b)
+   #define search_cmpeq_64(a, b) _mm256_cmpeq_epi64(a, b)
+
+// SSE2
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+   #define SEARCH_VECTOR_BYTES 16
+   #define search_vector_t __m128i
+   #define search_load(ptr) _mm_loadu_si128((const __m128i*)(ptr))
+   #define search_movemask(vec) ((uint32_t)_mm_movemask_epi8(vec))
+   #define search_set1_8(x) _mm_set1_epi8((char)(x))
+   #define search_set1_16(x) _mm_set1_epi16((short)(x))
+   #define search_set1_32(x) _mm_set1_epi32((int)(x))
+   #define search_set1_64(x) _mm_set1_epi64x((long long)(x))
+   #define search_cmpeq_8(a, b) _mm_cmpeq_epi8(a, b)
+   #define search_cmpeq_16(a, b) _mm_cmpeq_epi16(a, b)
+   #define search_cmpeq_32(a, b) _mm_cmpeq_epi32(a, b)
+   #define search_cmpeq_64(a, b) search_cmpeq_64_sse2(a, b)
+
+   static inline __m128i search_cmpeq_64_sse2(const __m128i a, const __m128i b)
+   {
+      const __m128i eq32 = _mm_cmpeq_epi32(a, b);
+      return _mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1)));
+   }
+
+#endif
+
+#if defined(SEARCH_VECTOR_BYTES)
+   /* movemask sets sizeof(element) bits per matching element */
+   #define SEARCH_VECTOR_FIND(bits, bytes, n, value, i) \
+   { \
+      const search_vector_t needle = search_set1_##bits(value); \
+      for (; i + SEARCH_VECTOR_BYTES / sizeof(value) <= n; i += SEARCH_VECTOR_BYTES / sizeof(value)) \
+      { \
+         const uint32_t mask = search_movemask(search_cmpeq_##bits(search_load(bytes + i * sizeof(value)), needle)); \
+         if (mask) \
+            return i + (size_t)__builtin_ctz(mask) / sizeof(value); \
+      } \
+   }
+
+   #define SEARCH_VECTOR_COUNT(bits, bytes, n, value, i, count) \
+   { \
+      const search_vector_t needle = search_set1_##bits(value); \
+      size_t bit_count = 0; \
+      for (; i + SEARCH_VECTOR_BYTES / sizeof(value) <= n; i += SEARCH_VECTOR_BYTES / sizeof(value)) \
+         bit_count += (size_t)__builtin_popcount(search_movemask(search_cmpeq_##bits(search_load(bytes + i * sizeof(value)), needle))); \
+      count += bit_count / sizeof(value); \
+   }
+
+#else
+   #define SEARCH_VECTOR_FIND(bits, bytes, n, value, i)
+   #define SEARCH_VECTOR_COUNT(bits, bytes, n, value, i, count)
+
+#endif
+
+
+#define SEARCH_GENERATE_KERNELS(bits) \
+static inline size_t search_find_##bits(const void *const restrict values, const size_t n, const uint##bits##_t value) \
+{ \
+   const unsigned char *const bytes = (const unsigned char*)values; \
+   size_t i = 0; \
+   SEARCH_VECTOR_FIND(bits, bytes, n, value, i) \
+   for (; i < n; i++) \
+   { \
+      uint##bits##_t x; \
+      memcpy(&x, bytes + i * sizeof(x), sizeof(x)); \
+      if (x == value) \
+         return i; \
+   } \
+   return n; \
+} \
+\
+static inline size_t search_count_##bits(const void *const restrict values, const size_t n, const uint##bits##_t value) \
+{ \
+   const unsigned char *const bytes = (const unsigned char*)values; \
+   size_t i = 0; \
+   size_t count = 0; \
+   SEARCH_VECTOR_COUNT(bits, bytes, n, value, i, count) \
+   for (; i < n; i++) \
+   { \
+      uint##bits##_t x; \
+      memcpy(&x, bytes + i * sizeof(x), sizeof(x)); \
+      count += (x == value); \
+   } \
+   return count; \
+}
+
+SEARCH_GENERATE_KERNELS(8)
+SEARCH_GENERATE_KERNELS(16)
+SEARCH_GENERATE_KERNELS(32)
+SEARCH_GENERATE_KERNELS(64)
+
+
+static inline size_t search_find(const void *const restrict values, const size_t n, const size_t width, const void *const restrict value)
+{
+   switch (width)
+   {
+      case 1: { uint8_t v; memcpy(&v, value, 1); return search_find_8(values, n, v); }
+      case 2: { uint16_t v; memcpy(&v, value, 2); return search_find_16(values, n, v); }
+      case 4: { uint32_t v; memcpy(&v, value, 4); return search_find_32(values, n, v); }
+      case 8: { uint64_t v; memcpy(&v, value, 8); return search_find_64(values, n, v); }
+   }
+   assert(false && "search_find: unsupported width");
+   return n;
+}
+
+static inline size_t search_count(const void *const restrict values, const size_t n, const size_t width, const void *const restrict value)
+{
+   switch (width)
+   {
+      case 1: { uint8_t v; memcpy(&v, value, 1); return search_count_8(values, n, v); }
+      case 2: { uint16_t v; memcpy(&v, value, 2); return search_count_16(values, n, v); }
+      case 4: { uint32_t v; memcpy(&v, value, 4); return search_count_32(values, n, v); }
+      case 8: { uint64_t v; memcpy(&v, value, 8); return search_count_64(values, n, v); }
+   }
+   assert(false && "search_count: unsupported width");
+   return 0;
+}
+
+
+/**
+ * SEARCH_IS_INTEGRAL macro
+ * ------------------------
+ * Compile-time constant: 1 if `type` is an integer type (or an enum / bool
+ * compatible with one) whose equality is bitwise, otherwise 0.
+ *
+ * Usage:
+ *   if (SEARCH_IS_INTEGRAL(type)) { ... SIMD kernel ... } else { ... equal_fn ... }
+ *
+ * Behavior:
+ *   - C11+: uses _Generic on a compound literal of `type`.
+ *   - C99 fallback: always 0 (comparator path only).
+ */
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)  /* C11+ */
+   #define SEARCH_IS_INTEGRAL(type) \
+      _Generic((type){0}, \
+         _Bool: 1, \
+         char: 1, \
+         signed char: 1, \
+         unsigned char: 1, \
+         short: 1, \
+         unsigned short: 1, \
+         int: 1, \
+         unsigned int: 1, \
+         long: 1, \
+         unsigned long: 1, \
+         long long: 1, \
+         unsigned long long: 1, \
+         default: 0 \
+      )
+
+#else /* C99 fallback */
+   #define SEARCH_IS_INTEGRAL(type) 0
+
+#endif
+
+
+/**
+ * DEFINE_BYTES_EQUAL macro
+ * ------------------------
+ * Generates `bool type##_bytes_equal(const type a, const type b)`, comparing
+ * the object representations with memcmp.
+ *
+ * Usage:
+ *   DEFINE_BYTES_EQUAL(date_s)
+ *   GENERATE_DEQUE_SEARCH(date_s, size_t, date_s_bytes_equal)
+ *
+ * Notes:
+ *   Only valid for plain structs without padding bytes or floating members
+ *   that need value semantics.
+ */
+#define DEFINE_BYTES_EQUAL(type) \
+static inline bool type##_bytes_equal(const type a, const type b) \
+{ \
+   return memcmp(&a, &b, sizeof(type)) == 0; \
+}
+
+
+#endif /* __SEARCH_H */
\ No newline at end of file
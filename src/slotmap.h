@@ -0,0 +1,398 @@
+#ifndef __SLOTMAP_H
+#define __SLOTMAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+#include "stack.h"
+
+
+/**
+ * Slot map
+ * --------
+ * Values stored contiguously (dense, no holes) and addressed by stable
+ * handles { index, generation }:
+ *
+ *   values - dense array of len values, in no particular order
+ *   owners - dense position -> slot index
+ *   slots  - slot index -> { dense position, generation }
+ *   free   - stack of slot indices ready for reuse
+ *
+ * remove() moves the last value into the hole (swap-remove) and bumps the
+ * slot's generation, so every handle to the removed value goes stale. A
+ * slot whose 32-bit generation would wrap is retired instead of reused, so
+ * a stale handle can never match again.
+ *
+ * Notes:
+ *   Generations start at 1: a zeroed handle is never valid.
+ *   SLOTMAP_NONE(len_type) marks a free slot and is not a valid index.
+ */
+#define SLOTMAP_NONE(len_type) ((len_type)-1)
+
+/* smallest number of values allocated */
+#ifndef SLOTMAP_MIN_CAPACITY
+   #define SLOTMAP_MIN_CAPACITY 16
+#endif
+
+static_assert(SLOTMAP_MIN_CAPACITY >= 16, "Warning: SLOTMAP_MIN_CAPACITY too small");
+static_assert((SLOTMAP_MIN_CAPACITY & (SLOTMAP_MIN_CAPACITY - 1)) == 0, "Warning: SLOTMAP_MIN_CAPACITY must be a power of 2");
+
+
+/**
+ * DEFINE_SLOTMAP macro
+ * --------------------
+ * Defines a slot map of `type` values with a free list kept in a stack of
+ * len_type slot indices.
+ *
+ * Parameters:
+ *   type     - Type of the values
+ *   len_type - Unsigned integer type used for slot indices, length and capacity
+ *
+ * Output:
+ *   Declaration of slot map for type, and its handle type
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(len_type, ...)
+ *    (once per len_type, shared by every slot map using it)
+ *    Use in combination with GENERATE_SLOTMAP(...), Ensure macro arguments match
+ */
+#define DEFINE_SLOTMAP(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   len_type index; \
+   uint32_t generation; \
+} type##_slotmap_handle_s; \
+\
+typedef struct \
+{ \
+   len_type dense; /* position in values, SLOTMAP_NONE while free */ \
+   uint32_t generation; \
+} type##_slotmap_slot_s; \
+\
+typedef struct \
+{ \
+   type *values; \
+   len_type *owners; \
+   type##_slotmap_slot_s *slots; \
+   len_type##_stack_s free; \
+   len_type len; \
+   len_type slot_count; /* slots created so far, live or free */ \
+   len_type capacity; \
+} type##_slotmap_s; \
+\
+static inline void type##_slotmap_init(type##_slotmap_s *const restrict map) \
+{ \
+   map->values = NULL; \
+   map->owners = NULL; \
+   map->slots = NULL; \
+   len_type##_stack_init(&map->free); \
+   map->len = 0; \
+   map->slot_count = 0; \
+   map->capacity = 0; \
+} \
+\
+static inline bool type##_slotmap_contains(const type##_slotmap_s *const restrict map, const type##_slotmap_handle_s handle) \
+{ \
+   assert(map); \
+   return handle.index < map->slot_count && map->slots[handle.index].dense != SLOTMAP_NONE(len_type) && map->slots[handle.index].generation == handle.generation; \
+} \
+\
+static inline type *type##_slotmap_get(const type##_slotmap_s *const restrict map, const type##_slotmap_handle_s handle) \
+{ \
+   return type##_slotmap_contains(map, handle) ? &map->values[map->slots[handle.index].dense] : NULL; \
+} \
+\
+static inline type##_slotmap_handle_s type##_slotmap_handle_at(const type##_slotmap_s *const restrict map, const len_type i) \
+{ \
+   assert(map); \
+   assert(i < map->len); \
+   const len_type index = map->owners[i]; \
+   return (type##_slotmap_handle_s){ .index = index, .generation = map->slots[index].generation }; \
+} \
+\
+bool type##_slotmap_reserve(type##_slotmap_s *const restrict, const len_type); \
+void type##_slotmap_clear(type##_slotmap_s *const restrict); \
+void type##_slotmap_delete(type##_slotmap_s *const restrict); \
+bool type##_slotmap_insert(type##_slotmap_s *const restrict, const type, type##_slotmap_handle_s *const restrict); \
+bool type##_slotmap_remove(type##_slotmap_s *const restrict, const type##_slotmap_handle_s);
+
+
+/**
+ * slotmap(type) / slotmap_handle(type) macros
+ * -------------------------------------------
+ * Declare a slot map variable, or a handle into one, of the given type.
+ *
+ * Usage (as variables):
+ *   slotmap(particle_s) particles;
+ *   slotmap_handle(particle_s) h;
+ *
+ * Usage (as parameter):
+ *   void step(slotmap(particle_s) *const particles) { ... }
+ *
+ * Notes:
+ *   - These macros expand to the underlying struct types (type##_slotmap_s,
+ *     type##_slotmap_handle_s).
+ */
+#define slotmap(type) \
+   type##_slotmap_s
+
+#define slotmap_handle(type) \
+   type##_slotmap_handle_s
+
+
+/**
+ * typecheck_slotmap_ptr macro
+ * ---------------------------
+ * Compile-time validation that 'var' is a pointer to a slot map of 'type'
+ * (see typecheck_ptr).
+ */
+#define typecheck_slotmap_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_slotmap_s, expr)
+
+
+/**
+ * Slot Map Expression Macros
+ * --------------------------
+ * Direct access to slot map properties, type-checked at compile-time (C11+)
+ * with a runtime NULL check (via assert).
+ *
+ * Example (iterate the dense values, no holes):
+ *   particle_s *p = slotmap_values(particle_s, &particles);
+ *   for (size_t i = 0; i < slotmap_len(particle_s, &particles); i++)
+ *      p[i].x += p[i].vx;
+ */
+#define slotmap_len(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      (map)->len \
+   )
+
+#define slotmap_capacity(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      (map)->capacity \
+   )
+
+#define slotmap_empty(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      (map)->len == 0 \
+   )
+
+#define slotmap_values(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      (map)->values \
+   )
+
+
+/**
+ * GENERATE_SLOTMAP macro
+ * ----------------------
+ * Implements the slot map functions for a type.
+ *
+ * Parameters:
+ *   type     - Value type
+ *   len_type - Unsigned integer type for slot indices, length & capacity
+ *   alloc_fn - Allocator for the values, owners and slots
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - insert(value, &handle): O(1) amortised; reuses the most recently
+ *     freed slot, else creates one. False if allocation fails (map and
+ *     handle unchanged).
+ *   - get(handle): pointer to the value or NULL if the handle is stale;
+ *     valid until the next insert, remove, clear or delete.
+ *   - remove(handle): O(1) swap-remove; false if the handle is stale.
+ *   - clear(): O(len); every handle goes stale, slots are kept for reuse.
+ *   - handle_at(i): handle of the value at dense position i, to remove or
+ *     keep values found while iterating.
+ *   - Values, owners and slots share one allocation of `capacity`, a power
+ *     of two (at least SLOTMAP_MIN_CAPACITY). The free stack grows on its
+ *     own; if it cannot, the freed slot is simply not reused.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(len_type, ...)
+ *    Use in combination with DEFINE_SLOTMAP(...), Ensure macro arguments match
+ */
+#define GENERATE_SLOTMAP(type, len_type, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+static bool type##_slotmap_resize(type##_slotmap_s *const restrict map, const size_t capacity) \
+{ \
+   /* capacity is a multiple of 16: values first, every array stays aligned */ \
+   unsigned char *const block = (unsigned char*)alloc_fn((sizeof(type) + sizeof(type##_slotmap_slot_s) + sizeof(len_type)) * capacity); \
+   if (!block) \
+      return false; \
+\
+   type *const values = (type*)block; \
+   type##_slotmap_slot_s *const slots = (type##_slotmap_slot_s*)(values + capacity); \
+   len_type *const owners = (len_type*)(slots + capacity); \
+   if (map->values) \
+   { \
+      MEMORY_COPY(values, map->values, sizeof(type) * map->len); \
+      MEMORY_COPY(slots, map->slots, sizeof(type##_slotmap_slot_s) * map->slot_count); \
+      MEMORY_COPY(owners, map->owners, sizeof(len_type) * map->len); \
+      free_fn(map->values); \
+   } \
+\
+   map->values = values; \
+   map->slots = slots; \
+   map->owners = owners; \
+   map->capacity = (len_type)capacity; \
+   return true; \
+} \
+\
+bool type##_slotmap_reserve(type##_slotmap_s *const restrict map, const len_type n) \
+{ \
+   assert(map); \
+   size_t capacity = SLOTMAP_MIN_CAPACITY; \
+   while (capacity < n) \
+   { \
+      if (capacity > (len_type)(-1) / 2) /* Prevent overflow */ \
+         return false; \
+      capacity *= 2; \
+   } \
+   if (capacity <= map->capacity) \
+      return true; \
+   return type##_slotmap_resize(map, capacity); \
+} \
+\
+/* frees slot `index`; retired for good if its generation would wrap */ \
+static inline void type##_slotmap_release(type##_slotmap_s *const restrict map, const len_type index) \
+{ \
+   type##_slotmap_slot_s *const slot = &map->slots[index]; \
+   slot->dense = SLOTMAP_NONE(len_type); \
+   if (++slot->generation != 0) \
+      len_type##_stack_push(&map->free, index); \
+} \
+\
+void type##_slotmap_clear(type##_slotmap_s *const restrict map) \
+{ \
+   assert(map); \
+   for (len_type i = 0; i < map->len; i++) \
+      type##_slotmap_release(map, map->owners[i]); \
+   map->len = 0; \
+} \
+\
+void type##_slotmap_delete(type##_slotmap_s *const restrict map) \
+{ \
+   assert(map); \
+   if (map->values) \
+      free_fn(map->values); \
+   len_type##_stack_delete(&map->free); \
+   type##_slotmap_init(map); \
+} \
+\
+bool type##_slotmap_insert(type##_slotmap_s *const restrict map, const type value, type##_slotmap_handle_s *const restrict handle) \
+{ \
+   assert(map); \
+   assert(handle); \
+   len_type index; \
+   if (map->free.len > 0) /* len < slot_count <= capacity */ \
+      index = map->free.values[--map->free.len]; \
+   else \
+   { \
+      if (map->slot_count == SLOTMAP_NONE(len_type)) \
+         return false; \
+      if (map->slot_count == map->capacity && !type##_slotmap_reserve(map, map->slot_count + 1)) \
+         return false; \
+      index = map->slot_count++; \
+      map->slots[index].generation = 1; \
+   } \
+\
+   const len_type dense = map->len++; \
+   map->values[dense] = value; \
+   map->owners[dense] = index; \
+   map->slots[index].dense = dense; \
+   handle->index = index; \
+   handle->generation = map->slots[index].generation; \
+   return true; \
+} \
+\
+bool type##_slotmap_remove(type##_slotmap_s *const restrict map, const type##_slotmap_handle_s handle) \
+{ \
+   assert(map); \
+   if (!type##_slotmap_contains(map, handle)) \
+      return false; \
+\
+   /* the last value fills the hole */ \
+   const len_type dense = map->slots[handle.index].dense; \
+   const len_type last = --map->len; \
+   if (dense != last) \
+   { \
+      map->values[dense] = map->values[last]; \
+      map->owners[dense] = map->owners[last]; \
+      map->slots[map->owners[dense]].dense = dense; \
+   } \
+   type##_slotmap_release(map, handle.index); \
+   return true; \
+}
+
+
+/**
+ * Slot map function macros
+ * ------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_SLOTMAP.
+ *
+ * Usage:
+ *   slotmap(particle_s) particles;
+ *   slotmap_handle(particle_s) h;
+ *   slotmap_init(particle_s, &particles);
+ *   slotmap_insert(particle_s, &particles, p, &h);          // false on allocation failure
+ *   particle_s *q = slotmap_get(particle_s, &particles, h); // NULL once removed
+ *   slotmap_remove(particle_s, &particles, h);              // h and its copies go stale
+ *   slotmap_delete(particle_s, &particles);
+ */
+#define slotmap_init(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_init((map)) \
+   )
+
+#define slotmap_reserve(type, map, n) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_reserve((map), (n)) \
+   )
+
+#define slotmap_clear(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_clear((map)) \
+   )
+
+#define slotmap_delete(type, map) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_delete((map)) \
+   )
+
+#define slotmap_contains(type, map, handle) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_contains((map), (handle)) \
+   )
+
+#define slotmap_get(type, map, handle) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_get((map), (handle)) \
+   )
+
+#define slotmap_handle_at(type, map, i) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_handle_at((map), (i)) \
+   )
+
+#define slotmap_insert(type, map, value, handle) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_insert((map), (value), (handle)) \
+   )
+
+#define slotmap_remove(type, map, handle) \
+   typecheck_slotmap_ptr(map, type, \
+      type##_slotmap_remove((map), (handle)) \
+   )
+
+
+#endif /* __SLOTMAP_H */
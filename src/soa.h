@@ -0,0 +1,653 @@
+#ifndef __SOA_H
+#define __SOA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+#include "swap.h"
+
+
+/**
+ * Structure-of-arrays stack / queue
+ * ---------------------------------
+ * A stack or queue of struct elements stored one array per field, so a
+ * loop over one field reads only that field's bytes and can run on SIMD
+ * vectors. Push / pop / enque / deque behave like stack.h and queue.h.
+ *
+ * Fields are given as an X-macro list: a macro taking a callback and
+ * calling it once per stored field with (field_type, field_name):
+ *
+ *   typedef struct { float x, y, vx, vy; uint32_t id; } particle_s;
+ *   #define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(float, vx) X(float, vy) X(uint32_t, id)
+ *   DEFINE_SOA_QUEUE(particle_s, PARTICLE_FIELDS, uint32_t)
+ *
+ * Each field becomes a `field_type *field_name` member of the container.
+ * All fields share one allocation, each array starting on a SOA_ALIGN byte
+ * boundary, and one set of front / len / size. Arrays are spaced one extra
+ * SOA_ALIGN apart, so power-of-two sized fields do not all start in the
+ * same cache set. Fields of the struct left out of the list are not
+ * stored and read back as zero.
+ */
+
+/* alignment of every field array */
+#define SOA_ALIGN 64
+
+static inline size_t soa_align(const size_t bytes)
+{
+   return (bytes + SOA_ALIGN - 1) & ~(size_t)(SOA_ALIGN - 1);
+}
+
+
+/**
+ * X-macro callbacks
+ * -----------------
+ * Applied to the field list inside the generated code; they refer to its
+ * locals: `soa` (container), `grown` (resized container), `element`
+ * (struct value), `at` (slot), `size`, `offset`, `block`, `first`,
+ * `second` (element runs to copy), `from`, `count`.
+ */
+#define SOA_MEMBER(field_type, field_name) \
+   field_type *field_name;
+
+#define SOA_CHECK_FIELD(field_type, field_name) \
+   assert_type(((const soa_element_t*)0)->field_name, field_type);
+
+#define SOA_NULL_FIELD(field_type, field_name) \
+   soa->field_name = NULL;
+
+#define SOA_FIELD_BYTES(field_type, field_name) \
+   + soa_align(sizeof(field_type) * (size_t)size) + SOA_ALIGN
+
+#define SOA_STORE_FIELD(field_type, field_name) \
+   soa->field_name[at] = element.field_name;
+
+#define SOA_LOAD_FIELD(field_type, field_name) \
+   element.field_name = soa->field_name[at];
+
+/* places the field in `block` and copies `first` elements from soa->front, then `second` from 0 */
+#define SOA_MOVE_FIELD(field_type, field_name) \
+   grown.field_name = (field_type*)(block + offset); \
+   offset += soa_align(sizeof(field_type) * (size_t)size) + SOA_ALIGN; \
+   if (soa->field_name) \
+   { \
+      MEMORY_COPY_LARGE(grown.field_name, &soa->field_name[soa->front], sizeof(field_type) * (size_t)first); \
+      MEMORY_COPY_LARGE(grown.field_name + first, soa->field_name, sizeof(field_type) * (size_t)second); \
+   }
+
+#define SOA_ROTATE_FIELD(field_type, field_name) \
+   rotate_range(soa->field_name, soa->size, soa->front, sizeof(field_type));
+
+/* moves `count` elements from slot `from` down to slot 0 */
+#define SOA_SHIFT_FIELD(field_type, field_name) \
+   MEMORY_MOVE(soa->field_name, &soa->field_name[from], sizeof(field_type) * (size_t)count);
+
+/* places the field in `block` and copies the `first` elements of a stack */
+#define SOA_MOVE_STACK_FIELD(field_type, field_name) \
+   grown.field_name = (field_type*)(block + offset); \
+   offset += soa_align(sizeof(field_type) * (size_t)size) + SOA_ALIGN; \
+   if (soa->field_name) \
+      MEMORY_COPY_LARGE(grown.field_name, soa->field_name, sizeof(field_type) * (size_t)first);
+
+
+/**
+ * DEFINE_SOA_QUEUE macro
+ * ----------------------
+ * Defines a queue of `type` stored as one array per listed field.
+ *
+ * Parameters:
+ *   type     - Element struct type
+ *   fields   - X-macro list of (field_type, field_name) for the stored fields
+ *   len_type - Unsigned integer type used for length/size
+ *
+ * Output:
+ *   Declaration of structure-of-arrays queue for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_SOA_QUEUE(...), Ensure macro arguments match
+ */
+#define DEFINE_SOA_QUEUE(type, fields, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   fields(SOA_MEMBER) \
+   void *memory; /* the allocation holding every field, NULL before the first enque */ \
+   len_type front; \
+   len_type len; \
+   len_type size; \
+} type##_soa_queue_s; \
+\
+static inline void type##_soa_queue_check_fields(void) \
+{ \
+   typedef type soa_element_t; \
+   fields(SOA_CHECK_FIELD) \
+} \
+\
+static inline void type##_soa_queue_init(type##_soa_queue_s *const restrict soa) \
+{ \
+   fields(SOA_NULL_FIELD) \
+   soa->memory = NULL; \
+   soa->front = 0; \
+   soa->len = 0; \
+   soa->size = 0; \
+} \
+\
+static inline type type##_soa_queue_peek(const type##_soa_queue_s *const restrict soa) \
+{ \
+   assert(soa); \
+   assert(soa->len != 0); \
+   type element; \
+   MEMORY_SET(&element, 0, sizeof(element)); \
+   const len_type at = soa->front; \
+   fields(SOA_LOAD_FIELD) \
+   return element; \
+} \
+\
+/* contiguous run `part` (0 or 1) of the ring: *start is its first slot, returns its length */ \
+static inline len_type type##_soa_queue_span(const type##_soa_queue_s *const restrict soa, const unsigned part, len_type *const restrict start) \
+{ \
+   assert(soa && start && part < 2); \
+   const len_type first = (soa->len < soa->size - soa->front) ? soa->len : (len_type)(soa->size - soa->front); \
+   *start = part ? 0 : soa->front; \
+   return part ? (len_type)(soa->len - first) : first; \
+} \
+\
+bool type##_soa_queue_resize(type##_soa_queue_s *const restrict); \
+void type##_soa_queue_delete(type##_soa_queue_s *const restrict); \
+bool type##_soa_queue_enque(type##_soa_queue_s *const restrict, const type); \
+bool type##_soa_queue_deque(type##_soa_queue_s *const restrict); \
+void type##_soa_queue_linearize(type##_soa_queue_s *const restrict);
+
+
+/**
+ * DEFINE_SOA_STACK macro
+ * ----------------------
+ * Defines a stack of `type` stored as one array per listed field.
+ *
+ * Parameters:
+ *   type     - Element struct type
+ *   fields   - X-macro list of (field_type, field_name) for the stored fields
+ *   len_type - Unsigned integer type used for length/size
+ *
+ * Output:
+ *   Declaration of structure-of-arrays stack for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_SOA_STACK(...), Ensure macro arguments match
+ */
+#define DEFINE_SOA_STACK(type, fields, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   fields(SOA_MEMBER) \
+   void *memory; /* the allocation holding every field, NULL before the first push */ \
+   len_type len; \
+   len_type size; \
+} type##_soa_stack_s; \
+\
+static inline void type##_soa_stack_check_fields(void) \
+{ \
+   typedef type soa_element_t; \
+   fields(SOA_CHECK_FIELD) \
+} \
+\
+static inline void type##_soa_stack_init(type##_soa_stack_s *const restrict soa) \
+{ \
+   fields(SOA_NULL_FIELD) \
+   soa->memory = NULL; \
+   soa->len = 0; \
+   soa->size = 0; \
+} \
+\
+static inline type type##_soa_stack_peek(const type##_soa_stack_s *const restrict soa) \
+{ \
+   assert(soa); \
+   assert(soa->len != 0); \
+   type element; \
+   MEMORY_SET(&element, 0, sizeof(element)); \
+   const len_type at = soa->len - 1; \
+   fields(SOA_LOAD_FIELD) \
+   return element; \
+} \
+\
+bool type##_soa_stack_resize(type##_soa_stack_s *const restrict); \
+void type##_soa_stack_delete(type##_soa_stack_s *const restrict); \
+bool type##_soa_stack_push(type##_soa_stack_s *const restrict, const type); \
+bool type##_soa_stack_pop(type##_soa_stack_s *const restrict);
+
+
+/**
+ * soa_queue(type) / soa_stack(type) macros
+ * ----------------------------------------
+ * Declare a structure-of-arrays queue or stack of the given type.
+ *
+ * Usage (as variable):
+ *   soa_queue(particle_s) particles;
+ *
+ * Usage (as parameter):
+ *   void step(soa_queue(particle_s) *const particles) { ... }
+ *
+ * Notes:
+ *   - These macros expand to the underlying struct types
+ *     (type##_soa_queue_s, type##_soa_stack_s).
+ */
+#define soa_queue(type) \
+   type##_soa_queue_s
+
+#define soa_stack(type) \
+   type##_soa_stack_s
+
+
+/**
+ * typecheck_soa_queue_ptr / typecheck_soa_stack_ptr macros
+ * --------------------------------------------------------
+ * Compile-time validation that 'var' is a pointer to a structure-of-arrays
+ * queue / stack of 'type' (see typecheck_ptr).
+ */
+#define typecheck_soa_queue_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_soa_queue_s, expr)
+
+#define typecheck_soa_stack_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_soa_stack_s, expr)
+
+
+/**
+ * SoA Expression Macros
+ * ---------------------
+ * Direct access to container properties and single fields, type-checked
+ * at compile-time (C11+) with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   float x = soa_queue_front(particle_s, &particles, x);   // field of the front element
+ *   soa_queue_at(particle_s, &particles, vx, 3) *= 0.5f;    // field of the 4th element
+ *   float *ys = soa_stack_field(particle_s, &stack, y);     // ys[0 .. len) in push order
+ */
+#define soa_queue_len(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->len \
+   )
+
+#define soa_queue_size(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->size \
+   )
+
+#define soa_queue_full(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->len == (soa)->size \
+   )
+
+#define soa_queue_empty(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->len == 0 \
+   )
+
+#define soa_queue_clear(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->len = 0 \
+   )
+
+#define soa_queue_field(type, soa, field) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->field \
+   )
+
+#define soa_queue_front(type, soa, field) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->field[(soa)->front] \
+   )
+
+#define soa_queue_at(type, soa, field, i) \
+   typecheck_soa_queue_ptr(soa, type, \
+      (soa)->field[((soa)->front + (i)) & ((soa)->size - 1)] \
+   )
+
+#define soa_stack_len(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->len \
+   )
+
+#define soa_stack_size(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->size \
+   )
+
+#define soa_stack_full(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->len == (soa)->size \
+   )
+
+#define soa_stack_empty(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->len == 0 \
+   )
+
+#define soa_stack_clear(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->len = 0 \
+   )
+
+#define soa_stack_field(type, soa, field) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->field \
+   )
+
+#define soa_stack_top(type, soa, field) \
+   typecheck_soa_stack_ptr(soa, type, \
+      (soa)->field[(soa)->len - 1] \
+   )
+
+
+/**
+ * GENERATE_SOA_QUEUE macro
+ * ------------------------
+ * Implements the structure-of-arrays queue functions for a type.
+ *
+ * Parameters:
+ *   type           - Element struct type
+ *   fields         - X-macro field list, as given to DEFINE_SOA_QUEUE
+ *   len_type       - Unsigned integer type for length & size
+ *   init_size      - Size of the first allocation
+ *   growth_factor  - Multiplier for resizing
+ *   validate_value - Function to validate a value (asserted in debug)
+ *   alloc_fn       - Allocator for the block holding every field array
+ *   free_fn        - Matching free
+ *
+ * Behavior:
+ *   - enque / deque / peek / resize / delete as in queue.h. There is no
+ *     inline buffer: the first enque allocates init_size slots, and a
+ *     resize allocates the next size and copies the fields unwrapped.
+ *   - span(part, &start): the live elements are slots [start, start + n)
+ *     of every field array for part 0, then part 1 (empty unless the ring
+ *     wraps), for loops over plain arrays.
+ *   - linearize(): rotates every field so front is 0 and part 0 holds all
+ *     elements, without allocating.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_SOA_QUEUE(...), Ensure macro arguments match
+ */
+#define GENERATE_SOA_QUEUE(type, fields, len_type, init_size, growth_factor, validate_value_fn, alloc_fn, free_fn) \
+   static_assert(init_size > 1, "Warning: init_size too small"); \
+   static_assert(init_size != 0 && (init_size & (init_size - 1)) == 0, "Warning: init_size must be a power of 2"); /* ring masking */ \
+   static_assert(growth_factor > 1, "Warning: growth_factor too small"); \
+   static_assert(growth_factor < 32,  "Warning: growth_factor too big"); \
+   static_assert(growth_factor != 0 && (growth_factor & (growth_factor - 1)) == 0, "Warning: growth_factor must be a power of 2"); /* ring masking */ \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(validate_value_fn((type){0}), bool); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_soa_queue_resize(type##_soa_queue_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa->size > (len_type)(-1) / growth_factor) /* Prevent overflow */ \
+      return false; \
+   const len_type size = soa->size ? (len_type)(soa->size * growth_factor) : (len_type)init_size; \
+\
+   const size_t bytes = 0 fields(SOA_FIELD_BYTES); \
+   void *const memory = alloc_fn(bytes + SOA_ALIGN - 1); \
+   if (!memory) \
+      return false; \
+   unsigned char *const block = (unsigned char*)(((uintptr_t)memory + SOA_ALIGN - 1) & ~(uintptr_t)(SOA_ALIGN - 1)); \
+\
+   type##_soa_queue_s grown; \
+   size_t offset = 0; \
+   const len_type first = (soa->len < soa->size - soa->front) ? soa->len : (len_type)(soa->size - soa->front); \
+   const len_type second = soa->len - first; \
+   fields(SOA_MOVE_FIELD) \
+\
+   if (soa->memory) \
+      free_fn(soa->memory); \
+   grown.memory = memory; \
+   grown.front = 0; \
+   grown.len = soa->len; \
+   grown.size = size; \
+   *soa = grown; \
+   return true; \
+} \
+\
+void type##_soa_queue_delete(type##_soa_queue_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa->memory) \
+      free_fn(soa->memory); \
+   type##_soa_queue_init(soa); \
+} \
+\
+bool type##_soa_queue_enque(type##_soa_queue_s *const restrict soa, const type element) \
+{ \
+   assert(soa); \
+   assert(validate_value_fn(element)); \
+   if (soa_queue_full(type, soa) && !type##_soa_queue_resize(soa)) \
+      return false; \
+   const len_type at = (soa->front + soa->len) & (soa->size - 1); \
+   fields(SOA_STORE_FIELD) \
+   soa->len++; \
+   return true; \
+} \
+\
+bool type##_soa_queue_deque(type##_soa_queue_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa_queue_empty(type, soa)) \
+      return false; \
+   soa->front = (soa->front + 1) & (soa->size - 1); \
+   soa->len--; \
+   return true; \
+} \
+\
+void type##_soa_queue_linearize(type##_soa_queue_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa->front == 0) \
+      return; \
+   if (soa->front + soa->len > soa->size) \
+   { \
+      fields(SOA_ROTATE_FIELD) \
+   } \
+   else \
+   { \
+      /* not wrapped: a move per field is cheaper than rotating the whole ring */ \
+      const len_type from = soa->front, count = soa->len; \
+      fields(SOA_SHIFT_FIELD) \
+   } \
+   soa->front = 0; \
+}
+
+
+/**
+ * GENERATE_SOA_STACK macro
+ * ------------------------
+ * Implements the structure-of-arrays stack functions for a type.
+ *
+ * Parameters:
+ *   type           - Element struct type
+ *   fields         - X-macro field list, as given to DEFINE_SOA_STACK
+ *   len_type       - Unsigned integer type for length & size
+ *   init_size      - Size of the first allocation
+ *   growth_factor  - Multiplier for resizing
+ *   validate_value - Function to validate a value (asserted in debug)
+ *   alloc_fn       - Allocator for the block holding every field array
+ *   free_fn        - Matching free
+ *
+ * Behavior:
+ *   - push / pop / peek / resize / delete as in stack.h, without the
+ *     inline buffer: the first push allocates init_size slots.
+ *   - Every field array holds the elements in push order at [0, len).
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_SOA_STACK(...), Ensure macro arguments match
+ */
+#define GENERATE_SOA_STACK(type, fields, len_type, init_size, growth_factor, validate_value_fn, alloc_fn, free_fn) \
+   static_assert(init_size > 1, "Warning: init_size too small"); \
+   static_assert(growth_factor > 1, "Warning: growth_factor too small"); \
+   static_assert(growth_factor < 32,  "Warning: growth_factor too big"); \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(validate_value_fn((type){0}), bool); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_soa_stack_resize(type##_soa_stack_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa->size > (len_type)(-1) / growth_factor) /* Prevent overflow */ \
+      return false; \
+   const len_type size = soa->size ? (len_type)(soa->size * growth_factor) : (len_type)init_size; \
+\
+   const size_t bytes = 0 fields(SOA_FIELD_BYTES); \
+   void *const memory = alloc_fn(bytes + SOA_ALIGN - 1); \
+   if (!memory) \
+      return false; \
+   unsigned char *const block = (unsigned char*)(((uintptr_t)memory + SOA_ALIGN - 1) & ~(uintptr_t)(SOA_ALIGN - 1)); \
+\
+   type##_soa_stack_s grown; \
+   size_t offset = 0; \
+   const len_type first = soa->len; \
+   fields(SOA_MOVE_STACK_FIELD) \
+\
+   if (soa->memory) \
+      free_fn(soa->memory); \
+   grown.memory = memory; \
+   grown.len = soa->len; \
+   grown.size = size; \
+   *soa = grown; \
+   return true; \
+} \
+\
+void type##_soa_stack_delete(type##_soa_stack_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa->memory) \
+      free_fn(soa->memory); \
+   type##_soa_stack_init(soa); \
+} \
+\
+bool type##_soa_stack_push(type##_soa_stack_s *const restrict soa, const type element) \
+{ \
+   assert(soa); \
+   assert(validate_value_fn(element)); \
+   if (soa_stack_full(type, soa) && !type##_soa_stack_resize(soa)) \
+      return false; \
+   const len_type at = soa->len; \
+   fields(SOA_STORE_FIELD) \
+   soa->len++; \
+   return true; \
+} \
+\
+bool type##_soa_stack_pop(type##_soa_stack_s *const restrict soa) \
+{ \
+   assert(soa); \
+   if (soa_stack_empty(type, soa)) \
+      return false; \
+   soa->len--; \
+   return true; \
+}
+
+
+/**
+ * SoA function macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_SOA_QUEUE
+ * and GENERATE_SOA_STACK.
+ *
+ * Usage:
+ *   soa_queue(particle_s) q;
+ *   soa_queue_init(particle_s, &q);
+ *   soa_queue_enque(particle_s, &q, ((particle_s){ .x = 1, .y = 2 }));
+ *   particle_s p = soa_queue_peek(particle_s, &q);
+ *   soa_queue_deque(particle_s, &q);
+ *
+ *   // one field, as plain arrays
+ *   for (unsigned part = 0; part < 2; part++)
+ *   {
+ *      uint32_t start, n = soa_queue_span(particle_s, &q, part, &start);
+ *      float *x = soa_queue_field(particle_s, &q, x) + start;
+ *      for (uint32_t i = 0; i < n; i++)
+ *         x[i] += 1.0f;
+ *   }
+ *   soa_queue_delete(particle_s, &q);
+ */
+#define soa_queue_init(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_init((soa)) \
+   )
+
+#define soa_queue_peek(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_peek((soa)) \
+   )
+
+#define soa_queue_span(type, soa, part, start) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_span((soa), (part), (start)) \
+   )
+
+#define soa_queue_resize(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_resize((soa)) \
+   )
+
+#define soa_queue_delete(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_delete((soa)) \
+   )
+
+#define soa_queue_enque(type, soa, value) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_enque((soa), (value)) \
+   )
+
+#define soa_queue_deque(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_deque((soa)) \
+   )
+
+#define soa_queue_linearize(type, soa) \
+   typecheck_soa_queue_ptr(soa, type, \
+      type##_soa_queue_linearize((soa)) \
+   )
+
+#define soa_stack_init(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      type##_soa_stack_init((soa)) \
+   )
+
+#define soa_stack_peek(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      type##_soa_stack_peek((soa)) \
+   )
+
+#define soa_stack_resize(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      type##_soa_stack_resize((soa)) \
+   )
+
+#define soa_stack_delete(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      type##_soa_stack_delete((soa)) \
+   )
+
+#define soa_stack_push(type, soa, value) \
+   typecheck_soa_stack_ptr(soa, type, \
+      type##_soa_stack_push((soa), (value)) \
+   )
+
+#define soa_stack_pop(type, soa) \
+   typecheck_soa_stack_ptr(soa, type, \
+      type##_soa_stack_pop((soa)) \
+   )
+
+
+#endif /* __SOA_H */
@@ -0,0 +1,383 @@
+#ifndef __SORT_H
+#define __SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "parallel.h"
+
+
+/**
+ * Sort key kinds
+ * --------------
+ * How the radix sort maps a key to an unsigned integer with the same order.
+ *
+ *   SORT_KEY_UNSIGNED - used as is
+ *   SORT_KEY_SIGNED   - sign bit flipped
+ *   SORT_KEY_FLOAT    - IEEE-754 total order (negatives inverted, positives
+ *                       get the sign bit set); -NaN sorts first, +NaN last
+ *
+ * SORT_KEY_KIND(key_type) selects the kind at compile time:
+ *   - C11+: _Generic on a compound literal of `key_type`.
+ *   - C99 fallback: arithmetic on casts of 0.5 and -1 to `key_type`.
+ */
+#define SORT_KEY_UNSIGNED 0
+#define SORT_KEY_SIGNED   1
+#define SORT_KEY_FLOAT    2
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)  /* C11+ */
+   #define SORT_KEY_KIND(key_type) \
+      _Generic((key_type){0}, \
+         char: ((char)-1 < 0) ? SORT_KEY_SIGNED : SORT_KEY_UNSIGNED, \
+         signed char: SORT_KEY_SIGNED, \
+         short: SORT_KEY_SIGNED, \
+         int: SORT_KEY_SIGNED, \
+         long: SORT_KEY_SIGNED, \
+         long long: SORT_KEY_SIGNED, \
+         float: SORT_KEY_FLOAT, \
+         double: SORT_KEY_FLOAT, \
+         default: SORT_KEY_UNSIGNED \
+      )
+
+#else /* C99 fallback: casts of 0.5 and -1 tell floating, signed and unsigned keys apart */
+   #define SORT_KEY_KIND(key_type) \
+      (((key_type)0.5 != (key_type)0 && (key_type)0.5 != (key_type)1) ? SORT_KEY_FLOAT : \
+       ((key_type)-1 < (key_type)1) ? SORT_KEY_SIGNED : SORT_KEY_UNSIGNED)
+
+#endif
+
+
+/**
+ * sort_key_bits function
+ * ----------------------
+ * Loads a `width` byte key from `key` and maps it to an order-preserving
+ * unsigned integer according to `kind`.
+ *
+ * Notes:
+ *   `width` and `kind` are compile-time constants at every call site in this
+ *   library, so the switch and branches fold away after inlining.
+ */
+static inline uint64_t sort_key_bits(const void *const restrict key, const size_t width, const int kind)
+{
+   uint64_t bits = 0;
+   switch (width)
+   {
+      case 1: { uint8_t k; memcpy(&k, key, 1); bits = k; break; }
+      case 2: { uint16_t k; memcpy(&k, key, 2); bits = k; break; }
+      case 4: { uint32_t k; memcpy(&k, key, 4); bits = k; break; }
+      case 8: { uint64_t k; memcpy(&k, key, 8); bits = k; break; }
+   }
+
+   const uint64_t sign = UINT64_C(1) << (8 * width - 1);
+   const uint64_t mask = sign | (sign - 1);
+   if (kind == SORT_KEY_SIGNED)
+      bits ^= sign;
+   else if (kind == SORT_KEY_FLOAT)
+      bits = (bits & sign) ? (~bits & mask) : (bits | sign);
+   return bits;
+}
+
+
+/**
+ * SORT_RUN macro
+ * --------------
+ * Length of the runs sorted by insertion sort before the merge passes.
+ */
+#ifndef SORT_RUN
+   #define SORT_RUN 16
+#endif
+
+
+/**
+ * SORT_GENERATE_ARRAY macro
+ * -------------------------
+ * Generates the array kernels used by the container sort functions.
+ *
+ * Parameters:
+ *   prefix     - Name prefix (e.g. int_stack)
+ *   type       - Element type
+ *   key_type   - Radix key type: unsigned, signed, float or double (1/2/4/8 bytes)
+ *   key_offset - Byte offset of the key in `type` (0 when key_type is type)
+ *
+ * Output:
+ *   static inline type *prefix##_merge_sort_array(a, b, n, compare)
+ *      Stable bottom-up merge sort of a[0..n) using b[0..n) as scratch.
+ *   static inline type *prefix##_radix_sort_array(a, b, n)
+ *      Stable LSD radix sort (8-bit digits) of a[0..n) by key, using
+ *      b[0..n) as scratch. Digits shared by all keys are skipped.
+ *
+ *   Both return the buffer (a or b) that holds the sorted elements.
+ *
+ * Notes:
+ *   Used by GENERATE_STACK_SORT, GENERATE_QUEUE_SORT and GENERATE_DEQUE_SORT.
+ */
+#define SORT_GENERATE_ARRAY(prefix, type, key_type, key_offset) \
+   static_assert(sizeof(key_type) == 1 || sizeof(key_type) == 2 || sizeof(key_type) == 4 || sizeof(key_type) == 8, "Warning: key_type must be 1, 2, 4 or 8 bytes"); \
+   static_assert((key_offset) + sizeof(key_type) <= sizeof(type), "Warning: key_offset out of range"); \
+\
+static inline uint64_t prefix##_sort_key(const type *const restrict value) \
+{ \
+   return sort_key_bits((const unsigned char*)value + (key_offset), sizeof(key_type), SORT_KEY_KIND(key_type)); \
+} \
+\
+static inline type *prefix##_merge_sort_array(type *a, type *b, const size_t n, int (*const compare)(const type*, const type*)) \
+{ \
+   for (size_t lo = 0; lo < n; lo += SORT_RUN) \
+   { \
+      const size_t hi = (lo + SORT_RUN < n) ? lo + SORT_RUN : n; \
+      for (size_t i = lo + 1; i < hi; i++) \
+      { \
+         const type x = a[i]; \
+         size_t j = i; \
+         for (; j > lo && compare(&x, &a[j - 1]) < 0; j--) \
+            a[j] = a[j - 1]; \
+         a[j] = x; \
+      } \
+   } \
+\
+   for (size_t width = SORT_RUN; width < n; width *= 2) \
+   { \
+      /* a and b swap roles every pass, so only these per-pass copies are restrict */ \
+      const type *const restrict src = a; \
+      type *const restrict dst = b; \
+      for (size_t lo = 0; lo < n; lo += 2 * width) \
+      { \
+         const size_t mid = (lo + width < n) ? lo + width : n; \
+         const size_t hi = (lo + 2 * width < n) ? lo + 2 * width : n; \
+         size_t i = lo, j = mid, k = lo; \
+         while (i < mid && j < hi) \
+            dst[k++] = (compare(&src[j], &src[i]) < 0) ? src[j++] : src[i++]; \
+         while (i < mid) \
+            dst[k++] = src[i++]; \
+         while (j < hi) \
+            dst[k++] = src[j++]; \
+      } \
+      type *const tmp = a; \
+      a = b; \
+      b = tmp; \
+   } \
+   return a; \
+} \
+\
+static inline type *prefix##_radix_sort_array(type *a, type *b, const size_t n) \
+{ \
+   size_t counts[sizeof(key_type)][256]; \
+   memset(counts, 0, sizeof(counts)); \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      const uint64_t key = prefix##_sort_key(&a[i]); \
+      for (size_t d = 0; d < sizeof(key_type); d++) \
+         counts[d][(key >> (8 * d)) & 0xFF]++; \
+   } \
+\
+   for (size_t d = 0; d < sizeof(key_type); d++) \
+   { \
+      size_t *const count = counts[d]; \
+      if (count[(prefix##_sort_key(&a[0]) >> (8 * d)) & 0xFF] == n) /* every key shares this digit */ \
+         continue; \
+\
+      size_t offset = 0; \
+      for (size_t digit = 0; digit < 256; digit++) \
+      { \
+         const size_t c = count[digit]; \
+         count[digit] = offset; \
+         offset += c; \
+      } \
+      const type *const restrict src = a; /* per pass, as in merge_sort_array */ \
+      type *const restrict dst = b; \
+      for (size_t i = 0; i < n; i++) \
+         dst[count[(prefix##_sort_key(&src[i]) >> (8 * d)) & 0xFF]++] = src[i]; \
+\
+      type *const tmp = a; \
+      a = b; \
+      b = tmp; \
+   } \
+   return a; \
+}
+
+
+/**
+ * SORT_OVERSAMPLE macro
+ * ---------------------
+ * Splitter samples taken from each sorted run by the parallel sorts.
+ */
+#ifndef SORT_OVERSAMPLE
+   #define SORT_OVERSAMPLE 8
+#endif
+
+
+/**
+ * SORT_GENERATE_PARALLEL macro
+ * ----------------------------
+ * Generates the parallel array kernels used by the container parallel sorts.
+ *
+ * Parameters:
+ *   prefix - Name prefix, the same one given to SORT_GENERATE_ARRAY
+ *   type   - Element type
+ *
+ * Output:
+ *   static inline type *prefix##_parallel_merge_sort_array(a, b, n, compare, pool)
+ *      Stable parallel merge sort of a[0..n) using b[0..n) as scratch.
+ *      Returns the buffer (a or b) that holds the sorted elements.
+ *
+ * Behavior:
+ *   - a[0..n) is cut into runs with parallel_chunks; each run is sorted by
+ *     its own task and left in a.
+ *   - SORT_OVERSAMPLE evenly spaced samples per run are sorted and one
+ *     splitter per run boundary is picked from them. Output part j gets
+ *     every element in [splitter j-1, splitter j) from every run, so its
+ *     offset in b is known without a prefix pass.
+ *   - Each part is a k-way heap merge into b; ties go to the lower run,
+ *     which keeps the sort stable.
+ *   - Below PARALLEL_SERIAL_THRESHOLD elements, or with a NULL pool, the
+ *     serial kernel runs instead.
+ *
+ * Notes:
+ *   Use after SORT_GENERATE_ARRAY(prefix, ...).
+ *   Keys that are mostly equal collapse into few parts: still correct, but
+ *   the merge then runs on fewer threads.
+ *   There is no parallel radix sort: the k-way merge alone costs more than
+ *   the serial LSD passes (bench/parallel), so radix_sort stays serial.
+ */
+#define SORT_GENERATE_PARALLEL(prefix, type) \
+\
+typedef struct \
+{ \
+   type *a; \
+   type *b; \
+   size_t n; \
+   size_t chunk; \
+   size_t runs; \
+   int (*compare)(const type*, const type*); \
+   const type *splitters[PARALLEL_MAX_TASKS]; \
+} prefix##_parallel_sort_job_s; \
+\
+/* first index of run[0..len) whose element is not less than *value */ \
+static inline size_t prefix##_sort_lower_bound(const type *const restrict run, size_t len, const type *const restrict value, int (*const compare)(const type*, const type*)) \
+{ \
+   size_t lo = 0; \
+   while (len > 0) \
+   { \
+      const size_t half = len / 2; \
+      if (compare(&run[lo + half], value) < 0) \
+      { \
+         lo += half + 1; \
+         len -= half + 1; \
+      } \
+      else \
+         len = half; \
+   } \
+   return lo; \
+} \
+\
+static inline void prefix##_parallel_sort_run_task(void *const arg, const size_t index) \
+{ \
+   const prefix##_parallel_sort_job_s *const job = (const prefix##_parallel_sort_job_s*)arg; \
+   const size_t lo = index * job->chunk; \
+   const size_t len = (lo + job->chunk < job->n) ? job->chunk : job->n - lo; \
+   type *const sorted = prefix##_merge_sort_array(job->a + lo, job->b + lo, len, job->compare); \
+   if (sorted != job->a + lo) \
+      memcpy(job->a + lo, sorted, sizeof(type) * len); \
+} \
+\
+static inline void prefix##_parallel_sort_merge_task(void *const arg, const size_t index) \
+{ \
+   const prefix##_parallel_sort_job_s *const job = (const prefix##_parallel_sort_job_s*)arg; \
+   const type *const a = job->a; \
+   const type *const lower = (index > 0) ? job->splitters[index - 1] : NULL; \
+   const type *const upper = (index + 1 < job->runs) ? job->splitters[index] : NULL; \
+   size_t pos[PARALLEL_MAX_TASKS]; \
+   size_t end[PARALLEL_MAX_TASKS]; \
+   size_t heap[PARALLEL_MAX_TASKS]; \
+   size_t heap_len = 0; \
+   size_t out = 0; \
+\
+   /* a run sorts before another on a smaller head, or an equal head from a lower run */ \
+   for (size_t r = 0; r < job->runs; r++) \
+   { \
+      const size_t start = r * job->chunk; \
+      const size_t len = (start + job->chunk < job->n) ? job->chunk : job->n - start; \
+      pos[r] = start + (lower ? prefix##_sort_lower_bound(a + start, len, lower, job->compare) : 0); \
+      end[r] = start + (upper ? prefix##_sort_lower_bound(a + start, len, upper, job->compare) : len); \
+      out += pos[r] - start; \
+      if (pos[r] == end[r]) \
+         continue; \
+\
+      size_t i = heap_len++; \
+      while (i > 0 && job->compare(&a[pos[r]], &a[pos[heap[(i - 1) / 2]]]) < 0) \
+      { \
+         heap[i] = heap[(i - 1) / 2]; \
+         i = (i - 1) / 2; \
+      } \
+      heap[i] = r; \
+   } \
+\
+   type *restrict dest = job->b + out; \
+   while (heap_len > 1) \
+   { \
+      const size_t top = heap[0]; \
+      *dest++ = a[pos[top]++]; \
+      const size_t r = (pos[top] < end[top]) ? top : heap[--heap_len]; \
+\
+      size_t i = 0; \
+      for (;;) \
+      { \
+         size_t child = 2 * i + 1; \
+         if (child >= heap_len) \
+            break; \
+         if (child + 1 < heap_len) \
+         { \
+            const int c = job->compare(&a[pos[heap[child + 1]]], &a[pos[heap[child]]]); \
+            if (c < 0 || (c == 0 && heap[child + 1] < heap[child])) \
+               child++; \
+         } \
+         const int c = job->compare(&a[pos[heap[child]]], &a[pos[r]]); \
+         if (c > 0 || (c == 0 && heap[child] > r)) \
+            break; \
+         heap[i] = heap[child]; \
+         i = child; \
+      } \
+      heap[i] = r; \
+   } \
+   if (heap_len == 1) \
+      memcpy(dest, &a[pos[heap[0]]], sizeof(type) * (end[heap[0]] - pos[heap[0]])); \
+} \
+\
+static inline type *prefix##_parallel_merge_sort_array(type *const restrict a, type *const restrict b, const size_t n, int (*const compare)(const type*, const type*), parallel_pool_s *const pool) \
+{ \
+   prefix##_parallel_sort_job_s job = { .a = a, .b = b, .n = n, .compare = compare }; \
+   job.runs = parallel_chunks(pool, n, &job.chunk); \
+   if (job.runs < 2) \
+      return prefix##_merge_sort_array(a, b, n, compare); \
+   assert(job.runs <= PARALLEL_MAX_TASKS); \
+   parallel_run(pool, job.runs, prefix##_parallel_sort_run_task, &job); \
+\
+   const type *samples[PARALLEL_MAX_TASKS * SORT_OVERSAMPLE]; \
+   size_t count = 0; \
+   for (size_t r = 0; r < job.runs; r++) \
+   { \
+      const size_t start = r * job.chunk; \
+      const size_t len = (start + job.chunk < n) ? job.chunk : n - start; \
+      for (size_t s = 0; s < SORT_OVERSAMPLE; s++) \
+         samples[count++] = &a[start + (len * (2 * s + 1)) / (2 * SORT_OVERSAMPLE)]; \
+   } \
+   for (size_t i = 1; i < count; i++) \
+   { \
+      const type *const x = samples[i]; \
+      size_t j = i; \
+      for (; j > 0 && compare(x, samples[j - 1]) < 0; j--) \
+         samples[j] = samples[j - 1]; \
+      samples[j] = x; \
+   } \
+   for (size_t j = 1; j < job.runs; j++) \
+      job.splitters[j - 1] = samples[(j * count) / job.runs]; \
+\
+   parallel_run(pool, job.runs, prefix##_parallel_sort_merge_task, &job); \
+   return b; \
+}
+
+
+#endif /* __SORT_H */
\ No newline at end of file
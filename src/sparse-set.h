@@ -0,0 +1,594 @@
+#ifndef __SPARSE_SET_H
+#define __SPARSE_SET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+
+
+/**
+ * Sparse set
+ * ----------
+ * Set of integer IDs with O(1) insert / remove / contains and a packed
+ * array of its members for iteration:
+ *
+ *   dense  - the IDs in the set, len of them, in no particular order
+ *   sparse - ID -> position in dense, in pages of 2^SPARSE_SET_PAGE_BITS
+ *            entries allocated on first use
+ *
+ * An ID is a member when its sparse entry points inside dense at itself,
+ * so stale entries are harmless: clear() only resets len, in O(1).
+ * remove() moves the last member into the hole (swap-remove).
+ *
+ * Sparse map: the same set plus a value per member, stored parallel to
+ * dense, for entity-component style storage.
+ *
+ * Notes:
+ *   Memory follows the ID ranges in use, one page at a time, plus one
+ *   page pointer per 2^SPARSE_SET_PAGE_BITS IDs up to the largest ID.
+ *   Pages are kept until delete().
+ */
+#define SPARSE_SET_NONE(len_type) ((len_type)-1)
+
+/* log2 of the number of sparse entries per page */
+#ifndef SPARSE_SET_PAGE_BITS
+   #define SPARSE_SET_PAGE_BITS 12
+#endif
+
+/* smallest number of members allocated */
+#ifndef SPARSE_SET_MIN_CAPACITY
+   #define SPARSE_SET_MIN_CAPACITY 16
+#endif
+
+#define SPARSE_SET_PAGE_SIZE ((size_t)1 << SPARSE_SET_PAGE_BITS)
+
+/* dense capacity for n members: a power of 2, at least SPARSE_SET_MIN_CAPACITY; 0 if above max */
+static inline size_t sparse_set_capacity_for(const size_t n, const size_t max)
+{
+   size_t capacity = SPARSE_SET_MIN_CAPACITY;
+   while (capacity < n)
+   {
+      if (capacity > max / 2) /* Prevent overflow */
+         return 0;
+      capacity *= 2;
+   }
+   return capacity;
+}
+
+static_assert(SPARSE_SET_PAGE_BITS >= 4 && SPARSE_SET_PAGE_BITS <= 20, "Warning: SPARSE_SET_PAGE_BITS must be within 4 .. 20");
+static_assert(SPARSE_SET_MIN_CAPACITY >= 16, "Warning: SPARSE_SET_MIN_CAPACITY too small");
+static_assert((SPARSE_SET_MIN_CAPACITY & (SPARSE_SET_MIN_CAPACITY - 1)) == 0, "Warning: SPARSE_SET_MIN_CAPACITY must be a power of 2");
+
+
+/**
+ * DEFINE_SPARSE_SET macro
+ * -----------------------
+ * Defines a sparse set of IDs of type len_type.
+ *
+ * Parameters:
+ *   len_type - Unsigned integer type of the IDs, length and capacity
+ *
+ * Output:
+ *   Declaration of sparse set for len_type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_SPARSE_SET(...), Ensure macro arguments match
+ */
+#define DEFINE_SPARSE_SET(len_type) \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   len_type **pages; /* page -> sparse entries, NULL until used */ \
+   len_type *dense; \
+   size_t page_count; \
+   len_type len; \
+   len_type capacity; \
+} len_type##_sparse_set_s; \
+\
+static inline void len_type##_sparse_set_init(len_type##_sparse_set_s *const restrict set) \
+{ \
+   set->pages = NULL; \
+   set->dense = NULL; \
+   set->page_count = 0; \
+   set->len = 0; \
+   set->capacity = 0; \
+} \
+\
+/* position of `id` in dense, SPARSE_SET_NONE if not a member */ \
+static inline len_type len_type##_sparse_set_index(const len_type##_sparse_set_s *const restrict set, const len_type id) \
+{ \
+   assert(set); \
+   const size_t page = (size_t)id >> SPARSE_SET_PAGE_BITS; \
+   if (page >= set->page_count || !set->pages[page]) \
+      return SPARSE_SET_NONE(len_type); \
+   const len_type i = set->pages[page][id & (SPARSE_SET_PAGE_SIZE - 1)]; \
+   return (i < set->len && set->dense[i] == id) ? i : SPARSE_SET_NONE(len_type); \
+} \
+\
+static inline bool len_type##_sparse_set_contains(const len_type##_sparse_set_s *const restrict set, const len_type id) \
+{ \
+   return len_type##_sparse_set_index(set, id) != SPARSE_SET_NONE(len_type); \
+} \
+\
+static inline void len_type##_sparse_set_clear(len_type##_sparse_set_s *const restrict set) \
+{ \
+   assert(set); \
+   set->len = 0; \
+} \
+\
+bool len_type##_sparse_set_reserve(len_type##_sparse_set_s *const restrict, const len_type); \
+void len_type##_sparse_set_delete(len_type##_sparse_set_s *const restrict); \
+bool len_type##_sparse_set_insert(len_type##_sparse_set_s *const restrict, const len_type); \
+bool len_type##_sparse_set_remove(len_type##_sparse_set_s *const restrict, const len_type);
+
+
+/**
+ * DEFINE_SPARSE_MAP macro
+ * -----------------------
+ * Defines a sparse set of len_type IDs with a `type` value per member,
+ * stored parallel to the dense IDs.
+ *
+ * Parameters:
+ *   type     - Type of the values
+ *   len_type - Unsigned integer type of the IDs, length and capacity
+ *
+ * Output:
+ *   Declaration of sparse map for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_SPARSE_SET(len_type)
+ *    Use in combination with GENERATE_SPARSE_MAP(...), Ensure macro arguments match
+ */
+#define DEFINE_SPARSE_MAP(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+typedef struct \
+{ \
+   len_type##_sparse_set_s set; \
+   type *values; /* parallel to set.dense */ \
+} type##_sparse_map_s; \
+\
+static inline void type##_sparse_map_init(type##_sparse_map_s *const restrict map) \
+{ \
+   len_type##_sparse_set_init(&map->set); \
+   map->values = NULL; \
+} \
+\
+static inline type *type##_sparse_map_get(const type##_sparse_map_s *const restrict map, const len_type id) \
+{ \
+   assert(map); \
+   const len_type i = len_type##_sparse_set_index(&map->set, id); \
+   return (i != SPARSE_SET_NONE(len_type)) ? &map->values[i] : NULL; \
+} \
+\
+static inline void type##_sparse_map_clear(type##_sparse_map_s *const restrict map) \
+{ \
+   assert(map); \
+   len_type##_sparse_set_clear(&map->set); \
+} \
+\
+bool type##_sparse_map_reserve(type##_sparse_map_s *const restrict, const len_type); \
+void type##_sparse_map_delete(type##_sparse_map_s *const restrict); \
+bool type##_sparse_map_insert(type##_sparse_map_s *const restrict, const len_type, const type); \
+bool type##_sparse_map_remove(type##_sparse_map_s *const restrict, const len_type);
+
+
+/**
+ * sparse_set(len_type) / sparse_map(type) macros
+ * ----------------------------------------------
+ * Declare a sparse set of len_type IDs, or a sparse map of type values.
+ *
+ * Usage (as variables):
+ *   sparse_set(uint32_t) alive;
+ *   sparse_map(position_s) positions;
+ *
+ * Usage (as parameter):
+ *   void move(sparse_map(position_s) *const positions) { ... }
+ *
+ * Notes:
+ *   - These macros expand to the underlying struct types
+ *     (len_type##_sparse_set_s, type##_sparse_map_s).
+ */
+#define sparse_set(len_type) \
+   len_type##_sparse_set_s
+
+#define sparse_map(type) \
+   type##_sparse_map_s
+
+
+/**
+ * typecheck_sparse_set_ptr / typecheck_sparse_map_ptr macros
+ * ----------------------------------------------------------
+ * Compile-time validation that 'var' is a pointer to a sparse set of
+ * 'len_type' IDs / a sparse map of 'type' values (see typecheck_ptr).
+ */
+#define typecheck_sparse_set_ptr(var, len_type, expr) \
+   typecheck_ptr(var, len_type##_sparse_set_s, expr)
+
+#define typecheck_sparse_map_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_sparse_map_s, expr)
+
+
+/**
+ * Sparse Set / Map Expression Macros
+ * ----------------------------------
+ * Direct access to properties and the packed arrays, type-checked at
+ * compile-time (C11+) with a runtime NULL check (via assert).
+ *
+ * Example (iterate members without holes):
+ *   const uint32_t *ids = sparse_map_ids(position_s, &positions);
+ *   position_s *pos = sparse_map_values(position_s, &positions);
+ *   for (size_t i = 0; i < sparse_map_len(position_s, &positions); i++)
+ *      pos[i].x += velocity_of(ids[i]);
+ */
+#define sparse_set_len(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      (set)->len \
+   )
+
+#define sparse_set_capacity(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      (set)->capacity \
+   )
+
+#define sparse_set_empty(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      (set)->len == 0 \
+   )
+
+#define sparse_set_ids(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      (set)->dense \
+   )
+
+#define sparse_map_len(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      (map)->set.len \
+   )
+
+#define sparse_map_capacity(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      (map)->set.capacity \
+   )
+
+#define sparse_map_empty(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      (map)->set.len == 0 \
+   )
+
+#define sparse_map_ids(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      (map)->set.dense \
+   )
+
+#define sparse_map_values(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      (map)->values \
+   )
+
+
+/**
+ * GENERATE_SPARSE_SET macro
+ * -------------------------
+ * Implements the sparse set functions for len_type IDs.
+ *
+ * Parameters:
+ *   len_type - Unsigned integer type of the IDs, length & capacity
+ *   alloc_fn - Allocator for pages, the page table and dense
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - insert(id): O(1) amortised; false if the ID is a member already or
+ *     allocation fails (set unchanged).
+ *   - remove(id): O(1) swap-remove; false if the ID is not a member.
+ *   - clear(): O(1), memory kept.
+ *   - A page is allocated (and filled with SPARSE_SET_NONE) the first time
+ *     an ID in its range is inserted. The page table and dense double as
+ *     needed; dense capacity is a power of two, at least
+ *     SPARSE_SET_MIN_CAPACITY.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_SPARSE_SET(...), Ensure macro arguments match
+ */
+#define GENERATE_SPARSE_SET(len_type, alloc_fn, free_fn) \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool len_type##_sparse_set_reserve(len_type##_sparse_set_s *const restrict set, const len_type n) \
+{ \
+   assert(set); \
+   const size_t capacity = sparse_set_capacity_for(n, (len_type)(-1)); \
+   if (capacity == 0) \
+      return false; \
+   if (capacity <= set->capacity) \
+      return true; \
+\
+   len_type *const dense = (len_type*)alloc_fn(sizeof(len_type) * capacity); \
+   if (!dense) \
+      return false; \
+   if (set->dense) \
+   { \
+      MEMORY_COPY(dense, set->dense, sizeof(len_type) * set->len); \
+      free_fn(set->dense); \
+   } \
+   set->dense = dense; \
+   set->capacity = (len_type)capacity; \
+   return true; \
+} \
+\
+/* sparse page of `id`, allocated if needed; NULL if allocation fails */ \
+static len_type *len_type##_sparse_set_page(len_type##_sparse_set_s *const restrict set, const len_type id) \
+{ \
+   const size_t page = (size_t)id >> SPARSE_SET_PAGE_BITS; \
+   if (page >= set->page_count) \
+   { \
+      size_t page_count = set->page_count ? set->page_count : 1; \
+      while (page_count <= page) \
+         page_count *= 2; \
+      len_type **const pages = (len_type**)alloc_fn(sizeof(len_type*) * page_count); \
+      if (!pages) \
+         return NULL; \
+      if (set->pages) \
+      { \
+         MEMORY_COPY(pages, set->pages, sizeof(len_type*) * set->page_count); \
+         free_fn(set->pages); \
+      } \
+      for (size_t p = set->page_count; p < page_count; p++) \
+         pages[p] = NULL; \
+      set->pages = pages; \
+      set->page_count = page_count; \
+   } \
+   if (!set->pages[page]) \
+   { \
+      len_type *const entries = (len_type*)alloc_fn(sizeof(len_type) * SPARSE_SET_PAGE_SIZE); \
+      if (!entries) \
+         return NULL; \
+      MEMORY_SET(entries, 0xFF, sizeof(len_type) * SPARSE_SET_PAGE_SIZE); /* SPARSE_SET_NONE */ \
+      set->pages[page] = entries; \
+   } \
+   return set->pages[page]; \
+} \
+\
+void len_type##_sparse_set_delete(len_type##_sparse_set_s *const restrict set) \
+{ \
+   assert(set); \
+   for (size_t p = 0; p < set->page_count; p++) \
+      if (set->pages[p]) \
+         free_fn(set->pages[p]); \
+   if (set->pages) \
+      free_fn(set->pages); \
+   if (set->dense) \
+      free_fn(set->dense); \
+   len_type##_sparse_set_init(set); \
+} \
+\
+bool len_type##_sparse_set_insert(len_type##_sparse_set_s *const restrict set, const len_type id) \
+{ \
+   assert(set); \
+   if (len_type##_sparse_set_contains(set, id)) \
+      return false; \
+   if (set->len == set->capacity && (set->len == SPARSE_SET_NONE(len_type) || !len_type##_sparse_set_reserve(set, set->len + 1))) \
+      return false; \
+   len_type *const page = len_type##_sparse_set_page(set, id); \
+   if (!page) \
+      return false; \
+\
+   page[id & (SPARSE_SET_PAGE_SIZE - 1)] = set->len; \
+   set->dense[set->len++] = id; \
+   return true; \
+} \
+\
+bool len_type##_sparse_set_remove(len_type##_sparse_set_s *const restrict set, const len_type id) \
+{ \
+   assert(set); \
+   const len_type i = len_type##_sparse_set_index(set, id); \
+   if (i == SPARSE_SET_NONE(len_type)) \
+      return false; \
+\
+   /* the last member fills the hole */ \
+   const len_type moved = set->dense[--set->len]; \
+   set->dense[i] = moved; \
+   set->pages[(size_t)moved >> SPARSE_SET_PAGE_BITS][moved & (SPARSE_SET_PAGE_SIZE - 1)] = i; \
+   return true; \
+}
+
+
+/**
+ * GENERATE_SPARSE_MAP macro
+ * -------------------------
+ * Implements the sparse map functions for a value type.
+ *
+ * Parameters:
+ *   type     - Value type
+ *   len_type - Unsigned integer type of the IDs, length & capacity
+ *   alloc_fn - Allocator for the values
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - As GENERATE_SPARSE_SET; values move with their IDs, so
+ *     values[i] always belongs to ids[i].
+ *   - insert(id, value): false if the ID is a member already (use get() to
+ *     change its value) or allocation fails.
+ *   - get(id): pointer to the value or NULL, valid until the next insert,
+ *     remove or delete.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_SPARSE_SET(len_type, ...)
+ *    Use in combination with DEFINE_SPARSE_MAP(...), Ensure macro arguments match
+ */
+#define GENERATE_SPARSE_MAP(type, len_type, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+bool type##_sparse_map_reserve(type##_sparse_map_s *const restrict map, const len_type n) \
+{ \
+   assert(map); \
+   size_t capacity = sparse_set_capacity_for(n, (len_type)(-1)); \
+   if (capacity == 0) \
+      return false; \
+   if (capacity > map->set.capacity || !map->values) \
+   { \
+      /* values first: if the set cannot grow after this, values is still at least as large as dense */ \
+      capacity = (capacity > map->set.capacity) ? capacity : map->set.capacity; \
+      type *const values = (type*)alloc_fn(sizeof(type) * capacity); \
+      if (!values) \
+         return false; \
+      if (map->values) \
+      { \
+         MEMORY_COPY(values, map->values, sizeof(type) * map->set.len); \
+         free_fn(map->values); \
+      } \
+      map->values = values; \
+   } \
+   return len_type##_sparse_set_reserve(&map->set, n); \
+} \
+\
+void type##_sparse_map_delete(type##_sparse_map_s *const restrict map) \
+{ \
+   assert(map); \
+   if (map->values) \
+      free_fn(map->values); \
+   len_type##_sparse_set_delete(&map->set); \
+   map->values = NULL; \
+} \
+\
+bool type##_sparse_map_insert(type##_sparse_map_s *const restrict map, const len_type id, const type value) \
+{ \
+   assert(map); \
+   if (len_type##_sparse_set_contains(&map->set, id)) \
+      return false; \
+   if (map->set.len == map->set.capacity || !map->values) \
+   { \
+      if (map->set.len == SPARSE_SET_NONE(len_type) || !type##_sparse_map_reserve(map, map->set.len + 1)) \
+         return false; \
+   } \
+   if (!len_type##_sparse_set_insert(&map->set, id)) \
+      return false; \
+   map->values[map->set.len - 1] = value; \
+   return true; \
+} \
+\
+bool type##_sparse_map_remove(type##_sparse_map_s *const restrict map, const len_type id) \
+{ \
+   assert(map); \
+   const len_type i = len_type##_sparse_set_index(&map->set, id); \
+   if (i == SPARSE_SET_NONE(len_type)) \
+      return false; \
+   map->values[i] = map->values[map->set.len - 1]; \
+   return len_type##_sparse_set_remove(&map->set, id); \
+}
+
+
+/**
+ * Sparse set / map function macros
+ * --------------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_SPARSE_SET
+ * and GENERATE_SPARSE_MAP.
+ *
+ * Usage:
+ *   sparse_set(uint32_t) alive;
+ *   sparse_set_init(uint32_t, &alive);
+ *   sparse_set_insert(uint32_t, &alive, 4000000000u);       // one page, not 4G entries
+ *   if (sparse_set_contains(uint32_t, &alive, 7))
+ *      sparse_set_remove(uint32_t, &alive, 7);
+ *   sparse_set_clear(uint32_t, &alive);                     // O(1)
+ *   sparse_set_delete(uint32_t, &alive);
+ *
+ *   sparse_map(position_s) positions;
+ *   sparse_map_init(position_s, &positions);
+ *   sparse_map_insert(position_s, &positions, entity, ((position_s){ 0, 0 }));
+ *   position_s *p = sparse_map_get(position_s, &positions, entity);   // NULL if absent
+ *   sparse_map_delete(position_s, &positions);
+ */
+#define sparse_set_init(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_init((set)) \
+   )
+
+#define sparse_set_reserve(len_type, set, n) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_reserve((set), (n)) \
+   )
+
+#define sparse_set_clear(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_clear((set)) \
+   )
+
+#define sparse_set_delete(len_type, set) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_delete((set)) \
+   )
+
+#define sparse_set_index(len_type, set, id) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_index((set), (id)) \
+   )
+
+#define sparse_set_contains(len_type, set, id) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_contains((set), (id)) \
+   )
+
+#define sparse_set_insert(len_type, set, id) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_insert((set), (id)) \
+   )
+
+#define sparse_set_remove(len_type, set, id) \
+   typecheck_sparse_set_ptr(set, len_type, \
+      len_type##_sparse_set_remove((set), (id)) \
+   )
+
+#define sparse_map_init(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_init((map)) \
+   )
+
+#define sparse_map_reserve(type, map, n) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_reserve((map), (n)) \
+   )
+
+#define sparse_map_clear(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_clear((map)) \
+   )
+
+#define sparse_map_delete(type, map) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_delete((map)) \
+   )
+
+#define sparse_map_contains(type, map, id) \
+   typecheck_sparse_map_ptr(map, type, \
+      (type##_sparse_map_get((map), (id)) != NULL) \
+   )
+
+#define sparse_map_get(type, map, id) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_get((map), (id)) \
+   )
+
+#define sparse_map_insert(type, map, id, value) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_insert((map), (id), (value)) \
+   )
+
+#define sparse_map_remove(type, map, id) \
+   typecheck_sparse_map_ptr(map, type, \
+      type##_sparse_map_remove((map), (id)) \
+   )
+
+
+#endif /* __SPARSE_SET_H */
@@ -6,6 +6,12 @@
 #include "static-assert.h"
 #include "swap.h"
 #include "memory-copy.h"
+#include "search.h"
+#include "reduce.h"
+#include "sort.h"
+#include "compact.h"
+#include "hash.h"
+#include "parallel.h"
 
 
 /**
@@ -186,6 +192,14 @@ void type##_stack_reverse(type##_stack_s *const restrict);
    assert_type(realloc_fn, void* (void*, size_t)); \
    assert_type(free_fn, void (void*)); \
 \
+static inline bool type##_stack_valid_n(const type *const restrict values, const len_type n) /* debug checks of bulk appends */ \
+{ \
+   for (len_type i = 0; i < n; i++) \
+      if (!validate_value_fn(values[i])) \
+         return false; \
+   return true; \
+} \
+\
 bool type##_stack_resize(type##_stack_s *const restrict stack) \
 { \
    assert(stack); \
@@ -260,8 +274,7 @@ void type##_stack_reverse(type##_stack_s *const restrict stack) \
    if (stack->len < 2) \
       return; \
 \
-   for (len_type i = 0; i < stack->len / 2; i++) \
-      SWAP(type, stack->values[i], stack->values[stack->len - 1 - i]); \
+   REVERSE_RANGE(type, stack->values, stack->len); \
 }
 
 
@@ -318,4 +331,855 @@ void type##_stack_reverse(type##_stack_s *const restrict stack) \
    )
 
 
+/**
+ * DEFINE_STACK_SEARCH macro
+ * -------------------------
+ * Declares find / count / contains for a stack type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the stack
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(...)
+ *    Use in combination with GENERATE_STACK_SEARCH(...)
+ */
+#define DEFINE_STACK_SEARCH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+len_type type##_stack_find(const type##_stack_s *const restrict, const type); \
+len_type type##_stack_count(const type##_stack_s *const restrict, const type); \
+bool type##_stack_contains(const type##_stack_s *const restrict, const type);
+
+
+/**
+ * GENERATE_STACK_SEARCH macro
+ * ---------------------------
+ * Implements find / count / contains for a stack type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   equal_fn - bool (type, type) equality, used for non-integral types
+ *
+ * Behavior:
+ *   - Integral types: bitwise SIMD kernels from search.h (equal_fn unused).
+ *   - Other types: linear scan with equal_fn
+ *     (use DEFINE_BYTES_EQUAL(type) for memcmp on padding-free structs).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(...)
+ *    Use in combination with DEFINE_STACK_SEARCH(...)
+ */
+#define GENERATE_STACK_SEARCH(type, len_type, equal_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(equal_fn, bool (type, type)); \
+\
+len_type type##_stack_find(const type##_stack_s *const restrict stack, const type value) \
+{ \
+   assert(stack); \
+   if (SEARCH_IS_INTEGRAL(type)) \
+      return (len_type)search_find(stack->values, stack->len, sizeof(type), &value); \
+\
+   for (len_type i = 0; i < stack->len; i++) \
+      if (equal_fn(stack->values[i], value)) \
+         return i; \
+   return stack->len; \
+} \
+\
+len_type type##_stack_count(const type##_stack_s *const restrict stack, const type value) \
+{ \
+   assert(stack); \
+   if (SEARCH_IS_INTEGRAL(type)) \
+      return (len_type)search_count(stack->values, stack->len, sizeof(type), &value); \
+\
+   len_type count = 0; \
+   for (len_type i = 0; i < stack->len; i++) \
+      count += equal_fn(stack->values[i], value); \
+   return count; \
+} \
+\
+bool type##_stack_contains(const type##_stack_s *const restrict stack, const type value) \
+{ \
+   return type##_stack_find(stack, value) != stack->len; \
+}
+
+
+/**
+ * Stack search macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_SEARCH.
+ *
+ * Usage:
+ *   len_type i = stack_find(int, &s, 42);    // index from bottom, stack_len() if absent
+ *   len_type n = stack_count(int, &s, 42);   // number of elements equal to 42
+ *   bool has = stack_contains(int, &s, 42);
+ */
+#define stack_find(type, stack, value) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_find((stack), (value)) \
+   )
+
+#define stack_count(type, stack, value) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_count((stack), (value)) \
+   )
+
+#define stack_contains(type, stack, value) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_contains((stack), (value)) \
+   )
+
+
+/**
+ * DEFINE_STACK_REDUCE macro
+ * -------------------------
+ * Declares sum / min / max / argmin / argmax for a numeric stack type.
+ *
+ * Parameters:
+ *   type     - Numeric element type stored in the stack
+ *   len_type - Integer type used for length/size
+ *   sum_type - Accumulator type returned by sum (e.g. int64_t for int32_t)
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(...)
+ *    Use in combination with GENERATE_STACK_REDUCE(...), Ensure macro arguments match
+ */
+#define DEFINE_STACK_REDUCE(type, len_type, sum_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(sum_type); \
+\
+sum_type type##_stack_sum(const type##_stack_s *const restrict); \
+type type##_stack_min(const type##_stack_s *const restrict); \
+type type##_stack_max(const type##_stack_s *const restrict); \
+len_type type##_stack_argmin(const type##_stack_s *const restrict); \
+len_type type##_stack_argmax(const type##_stack_s *const restrict);
+
+
+/**
+ * GENERATE_STACK_REDUCE macro
+ * ---------------------------
+ * Implements sum / min / max / argmin / argmax for a numeric stack type.
+ *
+ * Parameters:
+ *   type     - Numeric element type
+ *   len_type - Unsigned integer type for length & size
+ *   sum_type - Accumulator type returned by sum
+ *
+ * Behavior:
+ *   - float / double: SSE2/AVX2 kernels from reduce.h
+ *     (sum only when sum_type is the element type).
+ *   - Other types: scalar loops, left to the compiler to vectorize.
+ *   - argmin/argmax: the min / max, then the first element equal to it
+ *     with a compare + movemask kernel (reduce_find_* for float / double,
+ *     search_find for integers).
+ *   - Overflow: sum accumulates in sum_type; pick a wider type to avoid
+ *     overflow (unsigned wraps, signed overflow is undefined).
+ *   - NaN: sum propagates NaN, min/max return NaN if any element is NaN,
+ *     argmin/argmax return the index of the first NaN.
+ *   - min/max/argmin/argmax assert the stack is non-empty; sum of an empty
+ *     stack is 0.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(...)
+ *    Use in combination with DEFINE_STACK_REDUCE(...), Ensure macro arguments match
+ */
+#define GENERATE_STACK_REDUCE(type, len_type, sum_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(sum_type); \
+\
+static inline sum_type type##_stack_sum_scalar(const type *const restrict values, const size_t n) \
+{ \
+   sum_type sum = 0; \
+   for (size_t i = 0; i < n; i++) \
+      sum += (sum_type)values[i]; \
+   return sum; \
+} \
+\
+static inline type type##_stack_min_scalar(const type *const restrict values, const size_t n) \
+{ \
+   type result = values[0]; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      if (values[i] != values[i]) /* NaN */ \
+         return values[i]; \
+      if (values[i] < result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline type type##_stack_max_scalar(const type *const restrict values, const size_t n) \
+{ \
+   type result = values[0]; \
+   for (size_t i = 0; i < n; i++) \
+   { \
+      if (values[i] != values[i]) /* NaN */ \
+         return values[i]; \
+      if (values[i] > result) \
+         result = values[i]; \
+   } \
+   return result; \
+} \
+\
+static inline size_t type##_stack_index_of(const type *const restrict values, const size_t n, const type target) \
+{ \
+   if (SEARCH_IS_INTEGRAL(type)) /* bitwise equality: compare + movemask kernel from search.h */ \
+      return search_find(values, n, sizeof(type), &target); \
+   const bool is_nan = (target != target); \
+   size_t i = 0; \
+   while (i < n && !(is_nan ? (values[i] != values[i]) : (values[i] == target))) \
+      i++; \
+   return i; \
+} \
+\
+sum_type type##_stack_sum(const type##_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   return REDUCE_SUM_DISPATCH(stack->values, sum_type, type##_stack_sum_scalar)(stack->values, stack->len); \
+} \
+\
+type type##_stack_min(const type##_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   assert(!stack_empty(type, stack)); \
+   return REDUCE_DISPATCH(stack->values, reduce_min_f32, reduce_min_f64, type##_stack_min_scalar)(stack->values, stack->len); \
+} \
+\
+type type##_stack_max(const type##_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   assert(!stack_empty(type, stack)); \
+   return REDUCE_DISPATCH(stack->values, reduce_max_f32, reduce_max_f64, type##_stack_max_scalar)(stack->values, stack->len); \
+} \
+\
+len_type type##_stack_argmin(const type##_stack_s *const restrict stack) \
+{ \
+   const type target = type##_stack_min(stack); \
+   return (len_type)REDUCE_DISPATCH(stack->values, reduce_find_f32, reduce_find_f64, type##_stack_index_of)(stack->values, stack->len, target); \
+} \
+\
+len_type type##_stack_argmax(const type##_stack_s *const restrict stack) \
+{ \
+   const type target = type##_stack_max(stack); \
+   return (len_type)REDUCE_DISPATCH(stack->values, reduce_find_f32, reduce_find_f64, type##_stack_index_of)(stack->values, stack->len, target); \
+}
+
+
+/**
+ * Stack reduce macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_REDUCE.
+ *
+ * Usage:
+ *   int64_t total = stack_sum(int32_t, &s);
+ *   int32_t lo = stack_min(int32_t, &s);        // asserts non-empty
+ *   len_type at = stack_argmax(int32_t, &s);    // index from bottom
+ */
+#define stack_sum(type, stack) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_sum((stack)) \
+   )
+
+#define stack_min(type, stack) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_min((stack)) \
+   )
+
+#define stack_max(type, stack) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_max((stack)) \
+   )
+
+#define stack_argmin(type, stack) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_argmin((stack)) \
+   )
+
+#define stack_argmax(type, stack) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_argmax((stack)) \
+   )
+
+
+/**
+ * DEFINE_STACK_SORT macro
+ * -----------------------
+ * Declares the sort functions for a stack type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the stack
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(...)
+ *    Use in combination with GENERATE_STACK_SORT(...), Ensure macro arguments match
+ */
+#define DEFINE_STACK_SORT(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+bool type##_stack_sort(type##_stack_s *const restrict, int (*const)(const type*, const type*)); \
+bool type##_stack_radix_sort(type##_stack_s *const restrict);
+
+
+/**
+ * GENERATE_STACK_SORT macro
+ * -------------------------
+ * Implements the sort functions for a stack type.
+ *
+ * Parameters:
+ *   type       - Element type
+ *   len_type   - Unsigned integer type for length & size
+ *   key_type   - Radix key: unsigned, signed, float or double (1/2/4/8 bytes)
+ *   key_offset - Byte offset of the key in type (0 when key_type is type,
+ *                offsetof(type, field) for struct keys)
+ *   alloc_fn   - Allocator for the scratch buffer (the stack's own allocator)
+ *   free_fn    - Matching free
+ *
+ * Behavior:
+ *   - sort(compare): stable merge sort, compare is qsort-style on pointers.
+ *   - radix_sort(): stable LSD radix sort ascending by key, skipping digits
+ *     that are equal for every key.
+ *   - Both sort bottom to top, allocate one scratch buffer of len elements
+ *     and return false if that allocation fails (stack left unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(...)
+ *    Use in combination with DEFINE_STACK_SORT(...), Ensure macro arguments match
+ */
+#define GENERATE_STACK_SORT(type, len_type, key_type, key_offset, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(key_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+   SORT_GENERATE_ARRAY(type##_stack, type, key_type, key_offset) \
+\
+bool type##_stack_sort(type##_stack_s *const restrict stack, int (*const compare)(const type*, const type*)) \
+{ \
+   assert(stack); \
+   assert(compare); \
+   if (stack->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * stack->len); \
+   if (!scratch) \
+      return false; \
+\
+   const type *const sorted = type##_stack_merge_sort_array(stack->values, scratch, stack->len, compare); \
+   if (sorted != stack->values) \
+      MEMORY_COPY(stack->values, sorted, sizeof(type) * stack->len); \
+   free_fn(scratch); \
+   return true; \
+} \
+\
+bool type##_stack_radix_sort(type##_stack_s *const restrict stack) \
+{ \
+   assert(stack); \
+   if (stack->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * stack->len); \
+   if (!scratch) \
+      return false; \
+\
+   const type *const sorted = type##_stack_radix_sort_array(stack->values, scratch, stack->len); \
+   if (sorted != stack->values) \
+      MEMORY_COPY(stack->values, sorted, sizeof(type) * stack->len); \
+   free_fn(scratch); \
+   return true; \
+}
+
+
+/**
+ * Stack sort macros
+ * -----------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_SORT.
+ *
+ * Usage:
+ *   static int compare_int(const int *a, const int *b) { return (*a > *b) - (*a < *b); }
+ *
+ *   if (!stack_sort(int, &s, compare_int))     // stable, bottom to top
+ *      handle_oom();
+ *   stack_radix_sort(int, &s);                 // by key_type at key_offset
+ */
+#define stack_sort(type, stack, compare) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_sort((stack), (compare)) \
+   )
+
+#define stack_radix_sort(type, stack) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_radix_sort((stack)) \
+   )
+
+
+/**
+ * DEFINE_STACK_REMOVE_IF macro
+ * ----------------------------
+ * Declares remove_if / retain_if / remove_value for a stack type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the stack
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(...)
+ *    Use in combination with GENERATE_STACK_REMOVE_IF(...)
+ */
+#define DEFINE_STACK_REMOVE_IF(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+len_type type##_stack_remove_if(type##_stack_s *const restrict, bool (*const)(const type*, void*), void *const); \
+len_type type##_stack_retain_if(type##_stack_s *const restrict, bool (*const)(const type*, void*), void *const); \
+len_type type##_stack_remove_value(type##_stack_s *const restrict, const type);
+
+
+/**
+ * GENERATE_STACK_REMOVE_IF macro
+ * ------------------------------
+ * Implements remove_if / retain_if / remove_value for a stack type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   equal_fn - bool (type, type) equality, used for non-integral types
+ *
+ * Behavior:
+ *   - Single pass, in place, order of the survivors is preserved.
+ *   - remove_if / retain_if: pred(&element, ctx) is called once per element,
+ *     bottom to top; the loop is branchless on the result.
+ *   - remove_value: integral types use the SIMD compress kernels from
+ *     compact.h (equal_fn unused), other types a scan with equal_fn.
+ *   - All return the number of elements removed. Capacity is unchanged.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(...)
+ *    Use in combination with DEFINE_STACK_REMOVE_IF(...)
+ */
+#define GENERATE_STACK_REMOVE_IF(type, len_type, equal_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(equal_fn, bool (type, type)); \
+   COMPACT_GENERATE_ARRAY(type##_stack, type) \
+\
+static inline len_type type##_stack_compact(type##_stack_s *const restrict stack, bool (*const pred)(const type*, void*), void *const ctx, const bool remove) \
+{ \
+   assert(stack); \
+   assert(pred); \
+   const len_type kept = (len_type)type##_stack_compact_array(stack->values, stack->len, pred, ctx, remove); \
+   const len_type removed = stack->len - kept; \
+   stack->len = kept; \
+   return removed; \
+} \
+\
+len_type type##_stack_remove_if(type##_stack_s *const restrict stack, bool (*const pred)(const type*, void*), void *const ctx) \
+{ \
+   return type##_stack_compact(stack, pred, ctx, true); \
+} \
+\
+len_type type##_stack_retain_if(type##_stack_s *const restrict stack, bool (*const pred)(const type*, void*), void *const ctx) \
+{ \
+   return type##_stack_compact(stack, pred, ctx, false); \
+} \
+\
+len_type type##_stack_remove_value(type##_stack_s *const restrict stack, const type value) \
+{ \
+   assert(stack); \
+   const len_type kept = SEARCH_IS_INTEGRAL(type) \
+      ? (len_type)compact_remove(stack->values, stack->len, sizeof(type), &value) \
+      : (len_type)type##_stack_compact_equal_array(stack->values, stack->len, value, equal_fn); \
+   const len_type removed = stack->len - kept; \
+   stack->len = kept; \
+   return removed; \
+}
+
+
+/**
+ * Stack remove macros
+ * -------------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_REMOVE_IF.
+ *
+ * Usage:
+ *   static bool is_even(const int *x, void *ctx) { (void)ctx; return *x % 2 == 0; }
+ *
+ *   len_type n = stack_remove_if(int, &s, is_even, NULL);   // drop even values
+ *   stack_retain_if(int, &s, is_even, NULL);                // keep only even values
+ *   stack_remove_value(int, &s, 42);                        // drop every 42
+ */
+#define stack_remove_if(type, stack, pred, ctx) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_remove_if((stack), (pred), (ctx)) \
+   )
+
+#define stack_retain_if(type, stack, pred, ctx) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_retain_if((stack), (pred), (ctx)) \
+   )
+
+#define stack_remove_value(type, stack, value) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_remove_value((stack), (value)) \
+   )
+
+
+/**
+ * DEFINE_STACK_HASH macro
+ * -----------------------
+ * Declares hash / equal for a stack type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the stack
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(...)
+ *    Use in combination with GENERATE_STACK_HASH(...)
+ */
+#define DEFINE_STACK_HASH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+uint64_t type##_stack_hash(const type##_stack_s *const restrict, const uint64_t); \
+bool type##_stack_equal(const type##_stack_s *const, const type##_stack_s *const);
+
+
+/**
+ * GENERATE_STACK_HASH macro
+ * -------------------------
+ * Implements hash / equal for a stack type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *
+ * Behavior:
+ *   - hash(seed): 64-bit hash (hash.h) of the bytes of the elements,
+ *     bottom to top. Capacity does not affect the result.
+ *   - equal(a, b): same length and memcmp-equal elements.
+ *
+ * Notes:
+ *    Both work on the object representation: only use for element types
+ *    without padding bytes, and where bitwise equality is value equality.
+ *    Use only in a source (.c) file, after GENERATE_STACK(...)
+ *    Use in combination with DEFINE_STACK_HASH(...)
+ */
+#define GENERATE_STACK_HASH(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+uint64_t type##_stack_hash(const type##_stack_s *const restrict stack, const uint64_t seed) \
+{ \
+   assert(stack); \
+   return hash_bytes(stack->values, sizeof(type) * stack->len, seed); \
+} \
+\
+bool type##_stack_equal(const type##_stack_s *const a, const type##_stack_s *const b) \
+{ \
+   assert(a); \
+   assert(b); \
+   return a->len == b->len && (a->len == 0 || memcmp(a->values, b->values, sizeof(type) * a->len) == 0); \
+}
+
+
+/**
+ * Stack hash macros
+ * -----------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_HASH.
+ *
+ * Usage:
+ *   uint64_t h = stack_hash(int, &s, 0);     // seed 0
+ *   if (stack_equal(int, &s, &t)) { ... }
+ */
+#define stack_hash(type, stack, seed) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_hash((stack), (seed)) \
+   )
+
+#define stack_equal(type, a, b) \
+   typecheck_stack_ptr(a, type, typecheck_stack_ptr(b, type, \
+      type##_stack_equal((a), (b)) \
+   ))
+
+
+/**
+ * DEFINE_STACK_PARALLEL macro
+ * ---------------------------
+ * Declares parallel for_each / transform / reduce for a stack type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the stack
+ *   len_type - Integer type used for length/size
+ *   acc_type - Accumulator type of parallel_reduce
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK(...)
+ *    Use in combination with GENERATE_STACK_PARALLEL(...), Ensure macro arguments match
+ */
+#define DEFINE_STACK_PARALLEL(type, len_type, acc_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(acc_type); \
+\
+void type##_stack_parallel_for_each(type##_stack_s *const restrict, parallel_pool_s *const, void (*const)(type*, void*), void *const); \
+void type##_stack_parallel_transform(type##_stack_s *const restrict, parallel_pool_s *const, type (*const)(type, void*), void *const); \
+acc_type type##_stack_parallel_reduce(const type##_stack_s *const restrict, parallel_pool_s *const, const acc_type, acc_type (*const)(acc_type, const type*, void*), acc_type (*const)(acc_type, acc_type), void *const);
+
+
+/**
+ * GENERATE_STACK_PARALLEL macro
+ * -----------------------------
+ * Implements parallel for_each / transform / reduce for a stack type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   acc_type - Accumulator type of parallel_reduce
+ *
+ * Behavior:
+ *   - The elements are split into chunks with parallel_chunks (serial
+ *     below PARALLEL_SERIAL_THRESHOLD) and the chunks run on `pool`
+ *     (parallel.h); pool may be NULL for a serial pass.
+ *
+ *   - for_each(fn, ctx): fn(&element, ctx) for every element.
+ *   - transform(fn, ctx): element = fn(element, ctx) for every element.
+ *   - reduce(init, reduce_fn, combine_fn, ctx): each chunk folds its
+ *     elements in order with reduce_fn starting from init, then the chunk
+ *     results are folded in chunk order with combine_fn, starting from
+ *     init. init must be an identity of combine_fn; with an associative
+ *     combine_fn the result matches a serial fold.
+ *   - fn / reduce_fn run concurrently on different elements: they must
+ *     not touch the same shared state without synchronization.
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK(...)
+ *    Use in combination with DEFINE_STACK_PARALLEL(...), Ensure macro arguments match
+ */
+#define GENERATE_STACK_PARALLEL(type, len_type, acc_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_istype(acc_type); \
+\
+typedef struct \
+{ \
+   type *values; \
+   size_t len; \
+   size_t chunk; \
+   void (*for_each_fn)(type*, void*); \
+   type (*transform_fn)(type, void*); \
+   acc_type (*reduce_fn)(acc_type, const type*, void*); \
+   acc_type init; \
+   acc_type *partials; \
+   void *ctx; \
+} type##_stack_parallel_job_s; \
+\
+static inline void type##_stack_parallel_span(const type##_stack_parallel_job_s *const restrict job, const size_t index, type **const first, size_t *const first_len, type **const second, size_t *const second_len) \
+{ \
+   const size_t lo = index * job->chunk; \
+   const size_t hi = (lo + job->chunk < job->len) ? lo + job->chunk : job->len; \
+   *first = job->values + lo; \
+   *first_len = hi - lo; \
+   *second = job->values; \
+   *second_len = 0; \
+} \
+\
+static void type##_stack_parallel_for_each_task(void *const arg, const size_t index) \
+{ \
+   const type##_stack_parallel_job_s *const job = (const type##_stack_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_stack_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         job->for_each_fn(&pieces[p][i], job->ctx); \
+} \
+\
+static void type##_stack_parallel_transform_task(void *const arg, const size_t index) \
+{ \
+   const type##_stack_parallel_job_s *const job = (const type##_stack_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_stack_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         pieces[p][i] = job->transform_fn(pieces[p][i], job->ctx); \
+} \
+\
+static void type##_stack_parallel_reduce_task(void *const arg, const size_t index) \
+{ \
+   const type##_stack_parallel_job_s *const job = (const type##_stack_parallel_job_s*)arg; \
+   type *pieces[2]; \
+   size_t lens[2]; \
+   type##_stack_parallel_span(job, index, &pieces[0], &lens[0], &pieces[1], &lens[1]); \
+   acc_type acc = job->init; \
+   for (size_t p = 0; p < 2; p++) \
+      for (size_t i = 0; i < lens[p]; i++) \
+         acc = job->reduce_fn(acc, &pieces[p][i], job->ctx); \
+   job->partials[index] = acc; \
+} \
+\
+void type##_stack_parallel_for_each(type##_stack_s *const restrict stack, parallel_pool_s *const pool, void (*const fn)(type*, void*), void *const ctx) \
+{ \
+   assert(stack); \
+   assert(fn); \
+   type##_stack_parallel_job_s job = { .values = stack->values, .len = stack->len }; \
+   job.for_each_fn = fn; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, stack->len, &job.chunk); \
+   parallel_run(pool, tasks, type##_stack_parallel_for_each_task, &job); \
+} \
+\
+void type##_stack_parallel_transform(type##_stack_s *const restrict stack, parallel_pool_s *const pool, type (*const fn)(type, void*), void *const ctx) \
+{ \
+   assert(stack); \
+   assert(fn); \
+   type##_stack_parallel_job_s job = { .values = stack->values, .len = stack->len }; \
+   job.transform_fn = fn; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, stack->len, &job.chunk); \
+   parallel_run(pool, tasks, type##_stack_parallel_transform_task, &job); \
+} \
+\
+acc_type type##_stack_parallel_reduce(const type##_stack_s *const restrict stack, parallel_pool_s *const pool, const acc_type init, acc_type (*const reduce_fn)(acc_type, const type*, void*), acc_type (*const combine_fn)(acc_type, acc_type), void *const ctx) \
+{ \
+   assert(stack); \
+   assert(reduce_fn); \
+   assert(combine_fn); \
+   acc_type partials[PARALLEL_MAX_TASKS]; \
+   type##_stack_parallel_job_s job = { .values = stack->values, .len = stack->len }; \
+   job.reduce_fn = reduce_fn; \
+   job.init = init; \
+   job.partials = partials; \
+   job.ctx = ctx; \
+   const size_t tasks = parallel_chunks(pool, stack->len, &job.chunk); \
+   assert(tasks <= PARALLEL_MAX_TASKS); \
+   parallel_run(pool, tasks, type##_stack_parallel_reduce_task, &job); \
+\
+   acc_type result = init; \
+   for (size_t i = 0; i < tasks; i++) \
+      result = combine_fn(result, partials[i]); \
+   return result; \
+}
+
+/**
+ * Stack parallel macros
+ * ---------------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_PARALLEL.
+ *
+ * Usage:
+ *   parallel_pool_s pool;
+ *   parallel_pool_init(&pool, 0);                                   // one thread per CPU
+ *
+ *   stack_parallel_for_each(int, &s, &pool, clamp, &limits);       // void clamp(int*, void*)
+ *   stack_parallel_transform(int, &s, &pool, square, NULL);         // int square(int, void*)
+ *   int64_t sum = stack_parallel_reduce(int, &s, &pool, 0, add, add64, NULL);
+ *
+ *   parallel_pool_delete(&pool);
+ */
+#define stack_parallel_for_each(type, stack, pool, fn, ctx) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_parallel_for_each((stack), (pool), (fn), (ctx)) \
+   )
+
+#define stack_parallel_transform(type, stack, pool, fn, ctx) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_parallel_transform((stack), (pool), (fn), (ctx)) \
+   )
+
+#define stack_parallel_reduce(type, stack, pool, init, reduce_fn, combine_fn, ctx) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_parallel_reduce((stack), (pool), (init), (reduce_fn), (combine_fn), (ctx)) \
+   )
+
+
+/**
+ * DEFINE_STACK_PARALLEL_SORT macro
+ * --------------------------------
+ * Declares the multi-threaded sort functions for a stack type.
+ *
+ * Parameters:
+ *   type     - Type of elements stored in the stack
+ *   len_type - Integer type used for length/size
+ *
+ * Notes:
+ *    Use only in a header (.h) file, after DEFINE_STACK_SORT(...)
+ *    Use in combination with GENERATE_STACK_PARALLEL_SORT(...), Ensure macro arguments match
+ */
+#define DEFINE_STACK_PARALLEL_SORT(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+bool type##_stack_parallel_sort(type##_stack_s *const restrict, parallel_pool_s *const, int (*const)(const type*, const type*));
+
+
+/**
+ * GENERATE_STACK_PARALLEL_SORT macro
+ * ----------------------------------
+ * Implements the multi-threaded sort functions for a stack type.
+ *
+ * Parameters:
+ *   type     - Element type
+ *   len_type - Unsigned integer type for length & size
+ *   alloc_fn - Allocator for the scratch buffer (the stack's own allocator)
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - parallel_sort(pool, compare): same result as sort. The stack is cut
+ *     into runs that are sorted on `pool`, then merged in parallel into the
+ *     scratch buffer and copied back (see SORT_GENERATE_PARALLEL).
+ *   - pool may be NULL, and below PARALLEL_SERIAL_THRESHOLD elements the
+ *     serial sort runs.
+ *   - Allocates one scratch buffer of len elements and returns false if
+ *     that allocation fails (stack left unchanged).
+ *
+ * Notes:
+ *    Use only in a source (.c) file, after GENERATE_STACK_SORT(...)
+ *    Use in combination with DEFINE_STACK_PARALLEL_SORT(...), Ensure macro arguments match
+ */
+#define GENERATE_STACK_PARALLEL_SORT(type, len_type, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+   SORT_GENERATE_PARALLEL(type##_stack, type) \
+\
+bool type##_stack_parallel_sort(type##_stack_s *const restrict stack, parallel_pool_s *const pool, int (*const compare)(const type*, const type*)) \
+{ \
+   assert(stack); \
+   assert(compare); \
+   if (stack->len < 2) \
+      return true; \
+\
+   type *const scratch = (type*)alloc_fn(sizeof(type) * stack->len); \
+   if (!scratch) \
+      return false; \
+\
+   const type *const sorted = type##_stack_parallel_merge_sort_array(stack->values, scratch, stack->len, compare, pool); \
+   if (sorted != stack->values) \
+      parallel_copy(pool, stack->values, sorted, sizeof(type) * stack->len); \
+   free_fn(scratch); \
+   return true; \
+}
+
+/**
+ * Stack parallel sort macros
+ * --------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_STACK_PARALLEL_SORT.
+ *
+ * Usage:
+ *   if (!stack_parallel_sort(int, &s, &pool, compare_int))     // stable, bottom to top
+ *      handle_oom();
+ */
+#define stack_parallel_sort(type, stack, pool, compare) \
+   typecheck_stack_ptr(stack, type, \
+      type##_stack_parallel_sort((stack), (pool), (compare)) \
+   )
+
+
 #endif /* __STACK_H */
\ No newline at end of file
@@ -1,6 +1,9 @@
 #ifndef __SWAP_H
 #define __SWAP_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 #include "static-assert.h"
 
 /**
@@ -23,4 +26,250 @@
    (b) = _tmp;            \
 } while (0)
 
+
+#if defined(__AVX2__)
+   #include <immintrin.h>
+#elif defined(__SSE2__)
+   #include <emmintrin.h>
+#endif
+
+
+/**
+ * swap_ranges / swap_ranges_reversed functions
+ * --------------------------------------------
+ * Block swap kernels behind SWAP_RANGES, REVERSE_RANGE and ROTATE_RANGE.
+ *
+ * Functions:
+ *   swap_ranges(a, b, size)                 - swaps `size` bytes of a and b
+ *   swap_ranges_reversed(a, b, n, width)    - swaps a[i] and b[n - 1 - i] for
+ *                                             n elements of `width` bytes
+ *
+ * Behavior:
+ *   - swap_ranges: 32-byte (AVX2) or 16-byte (SSE2) chunks, then 8-byte
+ *     words, then bytes, whatever the element type.
+ *   - swap_ranges_reversed: whole registers are loaded from both ends, the
+ *     element order inside each is reversed with a shuffle and they are
+ *     stored crosswise (AVX2: 1/2/4/8 byte elements, SSE2: 2/4/8 byte
+ *     elements); other widths swap element by element.
+ *
+ * Notes:
+ *   The two ranges must not overlap.
+ */
+static inline void swap_ranges(void *const restrict a, void *const restrict b, const size_t size)
+{
+   unsigned char *const pa = (unsigned char*)a;
+   unsigned char *const pb = (unsigned char*)b;
+   size_t i = 0;
+
+#if defined(__AVX2__)
+   for (; i + 32 <= size; i += 32)
+   {
+      const __m256i x = _mm256_loadu_si256((const __m256i*)(pa + i));
+      const __m256i y = _mm256_loadu_si256((const __m256i*)(pb + i));
+      _mm256_storeu_si256((__m256i*)(pa + i), y);
+      _mm256_storeu_si256((__m256i*)(pb + i), x);
+   }
+#elif defined(__SSE2__)
+   for (; i + 16 <= size; i += 16)
+   {
+      const __m128i x = _mm_loadu_si128((const __m128i*)(pa + i));
+      const __m128i y = _mm_loadu_si128((const __m128i*)(pb + i));
+      _mm_storeu_si128((__m128i*)(pa + i), y);
+      _mm_storeu_si128((__m128i*)(pb + i), x);
+   }
+#endif
+
+   for (; i + 8 <= size; i += 8)
+   {
+      uint64_t x, y;
+      memcpy(&x, pa + i, 8);
+      memcpy(&y, pb + i, 8);
+      memcpy(pa + i, &y, 8);
+      memcpy(pb + i, &x, 8);
+   }
+   for (; i < size; i++)
+   {
+      const unsigned char x = pa[i];
+      pa[i] = pb[i];
+      pb[i] = x;
+   }
+}
+
+/* swaps `lanes` elements from the front of a with `lanes` elements from the back of b, reversing both */
+#define SWAP_REVERSED_LOOP(vec, load, store, reverse, lanes, width) \
+   for (; i + (lanes) <= n; i += (lanes)) \
+   { \
+      unsigned char *const x_ptr = pa + i * (width); \
+      unsigned char *const y_ptr = pb + (n - i - (lanes)) * (width); \
+      const vec x = load(x_ptr); \
+      const vec y = load(y_ptr); \
+      store(x_ptr, reverse(y)); \
+      store(y_ptr, reverse(x)); \
+   }
+
+#if defined(__AVX2__)
+   #define SWAP_LOAD(ptr) _mm256_loadu_si256((const __m256i*)(ptr))
+   #define SWAP_STORE(ptr, v) _mm256_storeu_si256((__m256i*)(ptr), v)
+   #define SWAP_REVERSE_64(v) _mm256_permute4x64_epi64(v, 0x1B)
+   #define SWAP_REVERSE_32(v) _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0))
+   #define SWAP_REVERSE_16(v) _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, _mm256_setr_epi8( \
+      14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1, 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1)), 0x4E)
+   #define SWAP_REVERSE_8(v) _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, _mm256_setr_epi8( \
+      15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)), 0x4E)
+   #define SWAP_REVERSED_VECTOR(width) \
+      SWAP_REVERSED_LOOP(__m256i, SWAP_LOAD, SWAP_STORE, SWAP_REVERSE_##width, 256 / (width), (width) / 8)
+   #define SWAP_REVERSED_VECTOR_8 SWAP_REVERSED_VECTOR(8)
+
+#elif defined(__SSE2__)
+   #define SWAP_LOAD(ptr) _mm_loadu_si128((const __m128i*)(ptr))
+   #define SWAP_STORE(ptr, v) _mm_storeu_si128((__m128i*)(ptr), v)
+   #define SWAP_REVERSE_64(v) _mm_shuffle_epi32(v, 0x4E)
+   #define SWAP_REVERSE_32(v) _mm_shuffle_epi32(v, 0x1B)
+   #define SWAP_REVERSE_16(v) _mm_shuffle_epi32(_mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0x1B), 0x1B), 0x4E)
+   #define SWAP_REVERSED_VECTOR(width) \
+      SWAP_REVERSED_LOOP(__m128i, SWAP_LOAD, SWAP_STORE, SWAP_REVERSE_##width, 128 / (width), (width) / 8)
+   #define SWAP_REVERSED_VECTOR_8
+
+#else
+   #define SWAP_REVERSED_VECTOR(width)
+   #define SWAP_REVERSED_VECTOR_8
+
+#endif
+
+/* bits: element width in bits, tail elements are swapped through a uint<bits>_t */
+#define SWAP_REVERSED_SCALAR(bits) \
+   for (; i < n; i++) \
+   { \
+      unsigned char *const x_ptr = pa + i * sizeof(uint##bits##_t); \
+      unsigned char *const y_ptr = pb + (n - 1 - i) * sizeof(uint##bits##_t); \
+      uint##bits##_t x, y; \
+      memcpy(&x, x_ptr, sizeof(x)); \
+      memcpy(&y, y_ptr, sizeof(y)); \
+      memcpy(x_ptr, &y, sizeof(y)); \
+      memcpy(y_ptr, &x, sizeof(x)); \
+   }
+
+static inline void swap_ranges_reversed(void *const restrict a, void *const restrict b, const size_t n, const size_t width)
+{
+   unsigned char *const pa = (unsigned char*)a;
+   unsigned char *const pb = (unsigned char*)b;
+   size_t i = 0;
+
+   switch (width)
+   {
+      case 1:
+         SWAP_REVERSED_VECTOR_8
+         SWAP_REVERSED_SCALAR(8)
+         return;
+      case 2:
+         SWAP_REVERSED_VECTOR(16)
+         SWAP_REVERSED_SCALAR(16)
+         return;
+      case 4:
+         SWAP_REVERSED_VECTOR(32)
+         SWAP_REVERSED_SCALAR(32)
+         return;
+      case 8:
+         SWAP_REVERSED_VECTOR(64)
+         SWAP_REVERSED_SCALAR(64)
+         return;
+   }
+
+   for (; i < n; i++)
+      swap_ranges(pa + i * width, pb + (n - 1 - i) * width, width);
+}
+
+
+/**
+ * SWAP_RANGES macro
+ * -----------------
+ * Swaps the n elements starting at a with the n elements starting at b.
+ *
+ * Usage:
+ *   SWAP_RANGES(int, &values[0], &values[16], 8);
+ *
+ * Notes:
+ *   a and b are `type*` and must not overlap. Works on the bytes, so
+ *   the cost does not depend on how large `type` is.
+ */
+#define SWAP_RANGES(type, a, b, n) do { \
+   assert_istype(type); \
+   assert_type(&(a)[0], type*); \
+   assert_type(&(b)[0], type*); \
+   swap_ranges((a), (b), sizeof(type) * (n)); \
+} while (0)
+
+
+/**
+ * REVERSE_RANGE macro
+ * -------------------
+ * Reverses the n elements starting at p in place.
+ *
+ * Usage:
+ *   REVERSE_RANGE(int, values, len);
+ *
+ * Behavior:
+ *   Swaps the first n / 2 elements with the last n / 2 in mirrored
+ *   order using swap_ranges_reversed.
+ */
+#define REVERSE_RANGE(type, p, n) do { \
+   assert_istype(type); \
+   assert_type(&(p)[0], type*); \
+   const size_t _half = (size_t)(n) / 2; \
+   swap_ranges_reversed((p), (p) + ((size_t)(n) - _half), _half, sizeof(type)); \
+} while (0)
+
+
+/**
+ * rotate_range function
+ * ---------------------
+ * Rotates n elements of `width` bytes at p left by k, so that p[k] becomes
+ * p[0] and p[0] becomes p[n - k].
+ *
+ * Behavior:
+ *   Gries-Mills block swap: the shorter side is swapped into its final
+ *   place with swap_ranges and the remainder is rotated in turn, so
+ *   every step is a sequential wide swap and no scratch memory is used.
+ */
+static inline void rotate_range(void *const p, size_t n, size_t k, const size_t width)
+{
+   unsigned char *base = (unsigned char*)p;
+   if (n)
+      k %= n;
+   while (k && k < n)
+   {
+      const size_t rest = n - k;
+      if (k <= rest)
+      {
+         /* A B1 B2, |B1| = |A|  ->  B1 A B2 */
+         swap_ranges(base, base + k * width, k * width);
+         base += k * width;
+         n -= k;
+      }
+      else
+      {
+         /* A1 A2 B, |A2| = |B|  ->  A1 B A2 */
+         swap_ranges(base + (k - rest) * width, base + k * width, rest * width);
+         n -= rest;
+         k -= rest;
+      }
+   }
+}
+
+
+/**
+ * ROTATE_RANGE macro
+ * ------------------
+ * Rotates the n elements starting at p left by k (k may exceed n).
+ *
+ * Usage:
+ *   ROTATE_RANGE(int, values, len, 3);         // values[3] moves to values[0]
+ *   ROTATE_RANGE(int, values, len, len - 3);   // rotate right by 3
+ */
+#define ROTATE_RANGE(type, p, n, k) do { \
+   assert_istype(type); \
+   assert_type(&(p)[0], type*); \
+   rotate_range((p), (n), (k), sizeof(type)); \
+} while (0)
+
 #endif /* __SWAP_H */
\ No newline at end of file
@@ -0,0 +1,546 @@
+#ifndef __TIMING_WHEEL_H
+#define __TIMING_WHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "static-assert.h"
+#include "memory-copy.h"
+
+
+/**
+ * Timing wheel
+ * ------------
+ * Hierarchical timing wheel: TIMING_WHEEL_LEVELS wheels of
+ * 2^TIMING_WHEEL_BITS slots, each slot an intrusive doubly linked list of
+ * timer IDs. Time is counted in ticks (uint64_t, e.g. milliseconds).
+ *
+ * A timer with deadline d is stored relative to the current tick `now`:
+ *   level - the lowest level L at which d is less than one rotation ahead,
+ *           (d >> L * TIMING_WHEEL_BITS) - (now >> L * TIMING_WHEEL_BITS)
+ *           < 2^TIMING_WHEEL_BITS
+ *   slot  - d's digit at that level
+ * Every level wraps around: slots before now's digit belong to the next
+ * rotation. Level 0 slots fire when now reaches them. A higher level slot
+ * is cascaded (its timers re-filed relative to the new now, always to lower
+ * levels) when now enters the time span it covers.
+ *
+ * Placement by distance rather than by the highest differing bit keeps
+ * cascades even: a level 1 cascade moves the timers due in the next
+ * 2^TIMING_WHEEL_BITS ticks, whatever the alignment of now.
+ *
+ * A deadline a top level rotation or more away waits in the top level slot
+ * cascaded last and is re-filed until it fits
+ * (TIMING_WHEEL_LEVELS * TIMING_WHEEL_BITS bits of ticks per round).
+ *
+ * Notes:
+ *   Each level keeps an occupancy bitmap, so advance() jumps from one
+ *   non-empty slot to the next instead of stepping through empty ticks.
+ */
+#ifndef TIMING_WHEEL_BITS
+   #define TIMING_WHEEL_BITS 8
+#endif
+
+#ifndef TIMING_WHEEL_LEVELS
+   #define TIMING_WHEEL_LEVELS 4
+#endif
+
+#define TIMING_WHEEL_SLOTS (1u << TIMING_WHEEL_BITS)
+#define TIMING_WHEEL_MASK (TIMING_WHEEL_SLOTS - 1)
+#define TIMING_WHEEL_WORDS (TIMING_WHEEL_SLOTS / 64)
+#define TIMING_WHEEL_NONE(len_type) ((len_type)-1)
+#define TIMING_WHEEL_UNSCHEDULED UINT32_MAX
+
+/* smallest number of IDs allocated */
+#ifndef TIMING_WHEEL_MIN_CAPACITY
+   #define TIMING_WHEEL_MIN_CAPACITY 16
+#endif
+
+static_assert(TIMING_WHEEL_BITS >= 6 && TIMING_WHEEL_BITS <= 16, "Warning: TIMING_WHEEL_BITS must be within 6 .. 16");
+static_assert(TIMING_WHEEL_LEVELS >= 1 && TIMING_WHEEL_LEVELS * TIMING_WHEEL_BITS < 64, "Warning: TIMING_WHEEL_LEVELS out of range");
+static_assert(TIMING_WHEEL_MIN_CAPACITY >= 16, "Warning: TIMING_WHEEL_MIN_CAPACITY too small");
+static_assert((TIMING_WHEEL_MIN_CAPACITY & (TIMING_WHEEL_MIN_CAPACITY - 1)) == 0, "Warning: TIMING_WHEEL_MIN_CAPACITY must be a power of 2");
+
+/* digit of `tick` at `level` */
+static inline uint32_t timing_wheel_digit(const uint64_t tick, const uint32_t level)
+{
+   return (uint32_t)(tick >> (level * TIMING_WHEEL_BITS)) & TIMING_WHEEL_MASK;
+}
+
+/* lowest level whose slots reach deadline from now (deadline >= now), TIMING_WHEEL_LEVELS if out of reach */
+static inline uint32_t timing_wheel_level(const uint64_t deadline, const uint64_t now)
+{
+   for (uint32_t level = 0; level < TIMING_WHEEL_LEVELS; level++)
+   {
+      const uint32_t shift = level * TIMING_WHEEL_BITS;
+      if ((deadline >> shift) - (now >> shift) < TIMING_WHEEL_SLOTS)
+         return level;
+   }
+   return TIMING_WHEEL_LEVELS;
+}
+
+/* first set bit at index >= from, TIMING_WHEEL_SLOTS if none */
+static inline uint32_t timing_wheel_next_set(const uint64_t *const restrict bits, const uint32_t from)
+{
+   if (from >= TIMING_WHEEL_SLOTS)
+      return TIMING_WHEEL_SLOTS;
+   uint32_t word = from / 64;
+   uint64_t mask = bits[word] & (~(uint64_t)0 << (from % 64));
+   for (;;)
+   {
+      if (mask)
+      {
+#if defined(__GNUC__) || defined(__clang__)
+         return word * 64 + (uint32_t)__builtin_ctzll(mask);
+#else
+         uint32_t n = 0;
+         while (!((mask >> n) & 1))
+            n++;
+         return word * 64 + n;
+#endif
+      }
+      if (++word == TIMING_WHEEL_WORDS)
+         return TIMING_WHEEL_SLOTS;
+      mask = bits[word];
+   }
+}
+
+
+/**
+ * DEFINE_TIMING_WHEEL macro
+ * -------------------------
+ * Defines a timing wheel of timers identified by dense integer IDs, each
+ * carrying a value of `type`.
+ *
+ * Parameters:
+ *   type     - Type of the value stored with each timer
+ *   len_type - Unsigned integer type used for IDs, length and capacity
+ *
+ * Output:
+ *   Declaration of timing wheel for type
+ *
+ * Notes:
+ *    Use only in a header (.h) file
+ *    Use in combination with GENERATE_TIMING_WHEEL(...), Ensure macro arguments match
+ */
+#define DEFINE_TIMING_WHEEL(type, len_type) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+\
+/* link fields of one ID side by side: schedule and cancel touch one cache line per ID */ \
+typedef struct \
+{ \
+   uint64_t deadline; /* deadline tick */ \
+   len_type next; /* next ID in its slot */ \
+   len_type prev; /* previous ID in its slot, TIMING_WHEEL_NONE for the first */ \
+   uint32_t slot; /* level * TIMING_WHEEL_SLOTS + slot, TIMING_WHEEL_UNSCHEDULED */ \
+} type##_timing_wheel_node_s; \
+\
+typedef struct \
+{ \
+   len_type heads[TIMING_WHEEL_LEVELS][TIMING_WHEEL_SLOTS]; /* first ID per slot */ \
+   uint64_t occupied[TIMING_WHEEL_LEVELS][TIMING_WHEEL_WORDS]; /* bit per non-empty slot */ \
+   uint64_t now; \
+   type##_timing_wheel_node_s *nodes; /* id -> node */ \
+   type *values; /* id -> value */ \
+   len_type len; \
+   len_type capacity; \
+} type##_timing_wheel_s; \
+\
+static inline bool type##_timing_wheel_scheduled(const type##_timing_wheel_s *const restrict wheel, const len_type id) \
+{ \
+   assert(wheel); \
+   return id < wheel->capacity && wheel->nodes[id].slot != TIMING_WHEEL_UNSCHEDULED; \
+} \
+\
+static inline uint64_t type##_timing_wheel_deadline(const type##_timing_wheel_s *const restrict wheel, const len_type id) \
+{ \
+   assert(type##_timing_wheel_scheduled(wheel, id)); \
+   return wheel->nodes[id].deadline; \
+} \
+\
+static inline type type##_timing_wheel_value(const type##_timing_wheel_s *const restrict wheel, const len_type id) \
+{ \
+   assert(type##_timing_wheel_scheduled(wheel, id)); \
+   return wheel->values[id]; \
+} \
+\
+void type##_timing_wheel_init(type##_timing_wheel_s *const restrict, const uint64_t); \
+bool type##_timing_wheel_reserve(type##_timing_wheel_s *const restrict, const len_type); \
+void type##_timing_wheel_clear(type##_timing_wheel_s *const restrict); \
+void type##_timing_wheel_delete(type##_timing_wheel_s *const restrict); \
+bool type##_timing_wheel_schedule(type##_timing_wheel_s *const restrict, const len_type, const uint64_t, const type); \
+bool type##_timing_wheel_cancel(type##_timing_wheel_s *const restrict, const len_type); \
+size_t type##_timing_wheel_advance(type##_timing_wheel_s *const restrict, const uint64_t, void (*const)(len_type, const type*, void*), void *const);
+
+
+/**
+ * timing_wheel(type) macro
+ * ------------------------
+ * Declares a timing wheel variable of the given value type.
+ *
+ * Usage (as variable):
+ *   timing_wheel(conn_ptr) timeouts;
+ *
+ * Usage (as parameter):
+ *   void tick(timing_wheel(conn_ptr) *const timeouts) { ... }
+ *
+ * Notes:
+ *   - This macro expands to the underlying struct type (type##_timing_wheel_s).
+ */
+#define timing_wheel(type) \
+   type##_timing_wheel_s
+
+
+/**
+ * typecheck_timing_wheel_ptr macro
+ * --------------------------------
+ * Compile-time validation that 'var' is a pointer to a timing wheel of
+ * 'type' (see typecheck_ptr).
+ */
+#define typecheck_timing_wheel_ptr(var, type, expr) \
+   typecheck_ptr(var, type##_timing_wheel_s, expr)
+
+
+/**
+ * Timing Wheel Expression Macros
+ * ------------------------------
+ * Direct access to timing wheel properties, type-checked at compile-time
+ * (C11+) with a runtime NULL check (via assert).
+ *
+ * Example:
+ *   if (!timing_wheel_empty(conn_ptr, &w))
+ *      printf("%zu timers pending at tick %llu\n", timing_wheel_len(conn_ptr, &w), timing_wheel_now(conn_ptr, &w));
+ */
+#define timing_wheel_len(type, wheel) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      (wheel)->len \
+   )
+
+#define timing_wheel_capacity(type, wheel) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      (wheel)->capacity \
+   )
+
+#define timing_wheel_empty(type, wheel) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      (wheel)->len == 0 \
+   )
+
+#define timing_wheel_now(type, wheel) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      (wheel)->now \
+   )
+
+
+/**
+ * GENERATE_TIMING_WHEEL macro
+ * ---------------------------
+ * Implements the timing wheel functions for a value type.
+ *
+ * Parameters:
+ *   type     - Value type
+ *   len_type - Unsigned integer type for IDs, length & capacity
+ *   alloc_fn - Allocator for the per-ID arrays
+ *   free_fn  - Matching free
+ *
+ * Behavior:
+ *   - init(now): empty wheel whose clock starts at tick `now`; nothing is
+ *     allocated until the first schedule or reserve.
+ *   - schedule(id, deadline, value): O(1); false if the ID is already
+ *     scheduled or allocation fails. Deadlines not after now fire on the
+ *     next advance.
+ *   - cancel(id): O(1) unlink; false if the ID is not scheduled.
+ *   - advance(now, expire, ctx): moves the clock forward and calls
+ *     expire(id, &value, ctx) for every timer with deadline <= now, in
+ *     deadline order between slots (any order within one tick). The ID is
+ *     unscheduled before the call, so expire may schedule or cancel any
+ *     timer, including the one expiring. Returns the number expired.
+ *   - Work per advance is proportional to the timers expired or cascaded
+ *     plus the non-empty slots visited; empty ticks are skipped.
+ *   - Per-ID arrays share one allocation of `capacity` IDs, a power of two
+ *     (at least TIMING_WHEEL_MIN_CAPACITY) covering the largest ID.
+ *
+ * Notes:
+ *    Use only in a source (.c) file
+ *    Use in combination with DEFINE_TIMING_WHEEL(...), Ensure macro arguments match
+ */
+#define GENERATE_TIMING_WHEEL(type, len_type, alloc_fn, free_fn) \
+   assert_istype(type); \
+   assert_istype(len_type); \
+   assert_type(alloc_fn, void* (size_t)); \
+   assert_type(free_fn, void (void*)); \
+\
+static bool type##_timing_wheel_resize(type##_timing_wheel_s *const restrict wheel, const size_t capacity) \
+{ \
+   unsigned char *const block = (unsigned char*)alloc_fn((sizeof(type##_timing_wheel_node_s) + sizeof(type)) * capacity); \
+   if (!block) \
+      return false; \
+\
+   type##_timing_wheel_node_s *const nodes = (type##_timing_wheel_node_s*)block; \
+   type *const values = (type*)(nodes + capacity); \
+   if (wheel->nodes) \
+   { \
+      MEMORY_COPY(nodes, wheel->nodes, sizeof(type##_timing_wheel_node_s) * wheel->capacity); \
+      MEMORY_COPY(values, wheel->values, sizeof(type) * wheel->capacity); \
+      free_fn(wheel->nodes); \
+   } \
+   for (size_t i = wheel->capacity; i < capacity; i++) \
+      nodes[i].slot = TIMING_WHEEL_UNSCHEDULED; \
+\
+   wheel->nodes = nodes; \
+   wheel->values = values; \
+   wheel->capacity = (len_type)capacity; \
+   return true; \
+} \
+\
+/* files a timer (deadline >= now) into its slot */ \
+static inline void type##_timing_wheel_link(type##_timing_wheel_s *const restrict wheel, const len_type id) \
+{ \
+   const uint64_t deadline = wheel->nodes[id].deadline; \
+   uint32_t level = timing_wheel_level(deadline, wheel->now); \
+   uint32_t index; \
+   if (level < TIMING_WHEEL_LEVELS) \
+      index = timing_wheel_digit(deadline, level); \
+   else /* a top level rotation or more away: the slot cascaded last */ \
+   { \
+      level = TIMING_WHEEL_LEVELS - 1; \
+      index = (timing_wheel_digit(wheel->now, level) - 1) & TIMING_WHEEL_MASK; \
+   } \
+\
+   const len_type head = wheel->heads[level][index]; \
+   wheel->nodes[id].next = head; \
+   wheel->nodes[id].prev = TIMING_WHEEL_NONE(len_type); \
+   if (head != TIMING_WHEEL_NONE(len_type)) \
+      wheel->nodes[head].prev = id; \
+   wheel->heads[level][index] = id; \
+   wheel->occupied[level][index / 64] |= (uint64_t)1 << (index % 64); \
+   wheel->nodes[id].slot = level * TIMING_WHEEL_SLOTS + index; \
+} \
+\
+static inline void type##_timing_wheel_unlink(type##_timing_wheel_s *const restrict wheel, const len_type id) \
+{ \
+   const uint32_t level = wheel->nodes[id].slot / TIMING_WHEEL_SLOTS; \
+   const uint32_t index = wheel->nodes[id].slot % TIMING_WHEEL_SLOTS; \
+   const len_type next = wheel->nodes[id].next; \
+   const len_type prev = wheel->nodes[id].prev; \
+   if (prev == TIMING_WHEEL_NONE(len_type)) \
+      wheel->heads[level][index] = next; \
+   else \
+      wheel->nodes[prev].next = next; \
+   if (next != TIMING_WHEEL_NONE(len_type)) \
+      wheel->nodes[next].prev = prev; \
+   if (wheel->heads[level][index] == TIMING_WHEEL_NONE(len_type)) \
+      wheel->occupied[level][index / 64] &= ~((uint64_t)1 << (index % 64)); \
+   wheel->nodes[id].slot = TIMING_WHEEL_UNSCHEDULED; \
+} \
+\
+/* earliest tick > now at which a non-empty slot is reached, UINT64_MAX if none */ \
+static inline uint64_t type##_timing_wheel_next_event(const type##_timing_wheel_s *const restrict wheel) \
+{ \
+   const uint64_t now = wheel->now; \
+   uint64_t earliest = UINT64_MAX; \
+   for (uint32_t level = 0; level < TIMING_WHEEL_LEVELS; level++) \
+   { \
+      /* slots after now's digit come up in this rotation, the others in the next */ \
+      const uint32_t shift = level * TIMING_WHEEL_BITS; \
+      const uint32_t digit = timing_wheel_digit(now, level); \
+      const uint64_t rotation = (now >> shift) - digit; /* in level units */ \
+      uint64_t event; \
+      uint32_t index = timing_wheel_next_set(wheel->occupied[level], digit + 1); \
+      if (index < TIMING_WHEEL_SLOTS) \
+         event = (rotation + index) << shift; \
+      else if ((index = timing_wheel_next_set(wheel->occupied[level], 0)) <= digit) \
+         event = (rotation + TIMING_WHEEL_SLOTS + index) << shift; \
+      else \
+         continue; \
+      if (event < earliest) \
+         earliest = event; \
+   } \
+   return earliest; \
+} \
+\
+void type##_timing_wheel_init(type##_timing_wheel_s *const restrict wheel, const uint64_t now) \
+{ \
+   MEMORY_SET(wheel->heads, 0xFF, sizeof(wheel->heads)); /* TIMING_WHEEL_NONE */ \
+   MEMORY_SET(wheel->occupied, 0, sizeof(wheel->occupied)); \
+   wheel->now = now; \
+   wheel->nodes = NULL; \
+   wheel->values = NULL; \
+   wheel->len = 0; \
+   wheel->capacity = 0; \
+} \
+\
+bool type##_timing_wheel_reserve(type##_timing_wheel_s *const restrict wheel, const len_type n) \
+{ \
+   assert(wheel); \
+   size_t capacity = TIMING_WHEEL_MIN_CAPACITY; \
+   while (capacity < n) \
+   { \
+      if (capacity > (len_type)(-1) / 2) /* Prevent overflow */ \
+         return false; \
+      capacity *= 2; \
+   } \
+   if (capacity <= wheel->capacity) \
+      return true; \
+   return type##_timing_wheel_resize(wheel, capacity); \
+} \
+\
+void type##_timing_wheel_clear(type##_timing_wheel_s *const restrict wheel) \
+{ \
+   assert(wheel); \
+   MEMORY_SET(wheel->heads, 0xFF, sizeof(wheel->heads)); /* TIMING_WHEEL_NONE */ \
+   MEMORY_SET(wheel->occupied, 0, sizeof(wheel->occupied)); \
+   for (size_t i = 0; i < wheel->capacity; i++) \
+      wheel->nodes[i].slot = TIMING_WHEEL_UNSCHEDULED; \
+   wheel->len = 0; \
+} \
+\
+void type##_timing_wheel_delete(type##_timing_wheel_s *const restrict wheel) \
+{ \
+   assert(wheel); \
+   if (wheel->nodes) \
+      free_fn(wheel->nodes); \
+   type##_timing_wheel_init(wheel, wheel->now); \
+} \
+\
+bool type##_timing_wheel_schedule(type##_timing_wheel_s *const restrict wheel, const len_type id, const uint64_t deadline, const type value) \
+{ \
+   assert(wheel); \
+   if (type##_timing_wheel_scheduled(wheel, id)) \
+      return false; \
+   if (id >= wheel->capacity && (id == TIMING_WHEEL_NONE(len_type) || !type##_timing_wheel_reserve(wheel, id + 1))) \
+      return false; \
+\
+   wheel->nodes[id].deadline = (deadline > wheel->now) ? deadline : wheel->now + 1; \
+   wheel->values[id] = value; \
+   type##_timing_wheel_link(wheel, id); \
+   wheel->len++; \
+   return true; \
+} \
+\
+bool type##_timing_wheel_cancel(type##_timing_wheel_s *const restrict wheel, const len_type id) \
+{ \
+   assert(wheel); \
+   if (!type##_timing_wheel_scheduled(wheel, id)) \
+      return false; \
+   type##_timing_wheel_unlink(wheel, id); \
+   wheel->len--; \
+   return true; \
+} \
+\
+size_t type##_timing_wheel_advance(type##_timing_wheel_s *const restrict wheel, const uint64_t now, void (*const expire)(len_type, const type*, void*), void *const ctx) \
+{ \
+   assert(wheel); \
+   assert(expire); \
+   size_t expired = 0; \
+   while (wheel->now < now) \
+   { \
+      const uint64_t tick = type##_timing_wheel_next_event(wheel); \
+      if (tick > now) \
+      { \
+         wheel->now = now; \
+         break; \
+      } \
+      wheel->now = tick; \
+\
+      /* cascade every level whose digit just changed, highest first */ \
+      uint32_t level = 1; \
+      while (level < TIMING_WHEEL_LEVELS && timing_wheel_digit(tick, level - 1) == 0) \
+         level++; \
+      while (--level > 0) \
+      { \
+         const uint32_t index = timing_wheel_digit(tick, level); \
+         len_type id = wheel->heads[level][index]; \
+         wheel->heads[level][index] = TIMING_WHEEL_NONE(len_type); \
+         wheel->occupied[level][index / 64] &= ~((uint64_t)1 << (index % 64)); \
+         while (id != TIMING_WHEEL_NONE(len_type)) \
+         { \
+            const len_type next = wheel->nodes[id].next; \
+            type##_timing_wheel_link(wheel, id); \
+            id = next; \
+         } \
+      } \
+\
+      /* expire level 0; expire() may link new timers, never into this slot */ \
+      const uint32_t index = timing_wheel_digit(tick, 0); \
+      len_type id; \
+      while ((id = wheel->heads[0][index]) != TIMING_WHEEL_NONE(len_type)) \
+      { \
+         const type value = wheel->values[id]; \
+         type##_timing_wheel_unlink(wheel, id); \
+         wheel->len--; \
+         expired++; \
+         expire(id, &value, ctx); \
+      } \
+   } \
+   return expired; \
+}
+
+
+/**
+ * Timing wheel function macros
+ * ----------------------------
+ * Type-generic wrappers for the functions generated by GENERATE_TIMING_WHEEL.
+ *
+ * Usage (connection timeouts, 1 ms ticks):
+ *   timing_wheel(conn_ptr) w;
+ *   timing_wheel_init(conn_ptr, &w, clock_ms());
+ *   timing_wheel_schedule(conn_ptr, &w, conn->fd, clock_ms() + 30000, conn);  // false if scheduled already
+ *   timing_wheel_cancel(conn_ptr, &w, conn->fd);                              // on activity
+ *   timing_wheel_advance(conn_ptr, &w, clock_ms(), on_timeout, NULL);         // once per loop iteration
+ *   timing_wheel_delete(conn_ptr, &w);
+ */
+#define timing_wheel_init(type, wheel, now) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_init((wheel), (now)) \
+   )
+
+#define timing_wheel_reserve(type, wheel, n) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_reserve((wheel), (n)) \
+   )
+
+#define timing_wheel_clear(type, wheel) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_clear((wheel)) \
+   )
+
+#define timing_wheel_delete(type, wheel) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_delete((wheel)) \
+   )
+
+#define timing_wheel_scheduled(type, wheel, id) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_scheduled((wheel), (id)) \
+   )
+
+#define timing_wheel_deadline(type, wheel, id) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_deadline((wheel), (id)) \
+   )
+
+#define timing_wheel_value(type, wheel, id) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_value((wheel), (id)) \
+   )
+
+#define timing_wheel_schedule(type, wheel, id, deadline, value) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_schedule((wheel), (id), (deadline), (value)) \
+   )
+
+#define timing_wheel_cancel(type, wheel, id) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_cancel((wheel), (id)) \
+   )
+
+#define timing_wheel_advance(type, wheel, now, expire, ctx) \
+   typecheck_timing_wheel_ptr(wheel, type, \
+      type##_timing_wheel_advance((wheel), (now), (expire), (ctx)) \
+   )
+
+
+#endif /* __TIMING_WHEEL_H */
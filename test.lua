@@ -36,7 +36,9 @@ local function main()
       "-I" .. test_dir,
       "-o " .. out_file,
       table.concat(find_src_files(test_dir), " "),
-      "-lcmocka"
+      "-lcmocka",
+      "-lpthread",
+      "-lm"
    }, " ")
    compile = run_cmd(cmd)
    if compile == "" then
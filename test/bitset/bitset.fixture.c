@@ -0,0 +1,8 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "bitset.fixture.h"
+
+
+/* Flags indexed by uint32_t */
+
+GENERATE_BITSET(uint32_t, 4, 2, malloc, realloc, free)
\ No newline at end of file
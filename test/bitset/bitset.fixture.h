@@ -0,0 +1,11 @@
+#ifndef __BITSET_FIXTURE_H
+#define __BITSET_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Flags indexed by uint32_t, 4 words (256 bits) inline */
+DEFINE_BITSET(uint32_t, 4)
+
+#endif /* __BITSET_FIXTURE_H */
@@ -0,0 +1,262 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "bitset.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   bitset(uint32_t) a;
+   bitset(uint32_t) b;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   bitset_init(uint32_t, &tmp->a);
+   bitset_init(uint32_t, &tmp->b);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   bitset_delete(uint32_t, &tmp->a);
+   bitset_delete(uint32_t, &tmp->b);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+/* fill `bits` and `ref` with the same random bits, one in `density` set */
+static void fill_random(bitset(uint32_t) *bits, bool *ref, uint32_t len, uint32_t density, uint32_t *seed)
+{
+   assert_true(bitset_resize(uint32_t, bits, len));
+   for (uint32_t i = 0; i < len; i++)
+   {
+      ref[i] = next_random(seed) % density == 0;
+      if (ref[i])
+         bitset_set(uint32_t, bits, i);
+   }
+}
+
+static void assert_matches(const bitset(uint32_t) *bits, const bool *ref, uint32_t len)
+{
+   assert_int_equal(bitset_len(uint32_t, bits), len);
+   size_t count = 0;
+   for (uint32_t i = 0; i < len; i++)
+   {
+      assert_int_equal(bitset_test(uint32_t, bits, i), ref[i]);
+      count += ref[i];
+   }
+   assert_int_equal(bitset_count(uint32_t, bits), count);
+}
+
+
+static void test_bitset_init_delete(void **state)
+{
+   bitset(uint32_t) bits;
+   bitset_init(uint32_t, &bits);
+   assert_int_equal(bitset_len(uint32_t, &bits), 0);
+   assert_int_equal(bitset_size(uint32_t, &bits), 4);
+   assert_true(bitset_empty(uint32_t, &bits));
+   assert_int_equal(bitset_count(uint32_t, &bits), 0);
+   assert_int_equal(bitset_find_next_set(uint32_t, &bits, 0), BITSET_NONE(uint32_t));
+   assert_false(bitset_pop(uint32_t, &bits));
+
+   // the inline buffer holds 256 bits, then words move to the heap
+   assert_true(bitset_resize(uint32_t, &bits, 256));
+   assert_ptr_equal(bitset_words(uint32_t, &bits), bits.inline_buffer);
+   bitset_set(uint32_t, &bits, 255);
+   assert_true(bitset_push(uint32_t, &bits, true));
+   assert_ptr_not_equal(bitset_words(uint32_t, &bits), bits.inline_buffer);
+   assert_int_equal(bitset_size(uint32_t, &bits), 8);
+   assert_true(bitset_test(uint32_t, &bits, 255));
+   assert_true(bitset_test(uint32_t, &bits, 256));
+   assert_int_equal(bitset_count(uint32_t, &bits), 2);
+
+   bitset_delete(uint32_t, &bits);
+   assert_int_equal(bitset_len(uint32_t, &bits), 0);
+   assert_ptr_equal(bitset_words(uint32_t, &bits), bits.inline_buffer);
+}
+
+static void test_bitset_set_clear(void **state)
+{
+   bitset(uint32_t) *bits = &((test_state_s*)(*state))->a;
+
+   const uint32_t marks[] = { 0, 1, 63, 64, 65, 127, 500, 999 };
+   assert_true(bitset_resize(uint32_t, bits, 1000));
+   assert_int_equal(bitset_count(uint32_t, bits), 0);
+   for (size_t i = 0; i < ARRAY_LEN(marks); i++)
+   {
+      assert_true(bitset_visit(uint32_t, bits, marks[i]));
+      assert_false(bitset_visit(uint32_t, bits, marks[i]));
+   }
+   assert_int_equal(bitset_count(uint32_t, bits), ARRAY_LEN(marks));
+
+   // find_next_set walks the marks in order
+   uint32_t i = bitset_find_next_set(uint32_t, bits, 0);
+   for (size_t m = 0; m < ARRAY_LEN(marks); m++)
+   {
+      assert_int_equal(i, marks[m]);
+      i = bitset_find_next_set(uint32_t, bits, i + 1);
+   }
+   assert_int_equal(i, BITSET_NONE(uint32_t));
+   assert_int_equal(bitset_find_next_set(uint32_t, bits, 128), 500);
+   assert_int_equal(bitset_find_next_set(uint32_t, bits, 1000), BITSET_NONE(uint32_t));
+   assert_int_equal(bitset_find_next_clear(uint32_t, bits, 63), 66);
+   assert_int_equal(bitset_find_next_clear(uint32_t, bits, 0), 2);
+
+   bitset_clear(uint32_t, bits, 64);
+   bitset_flip(uint32_t, bits, 63);
+   bitset_flip(uint32_t, bits, 62);
+   assert_false(bitset_test(uint32_t, bits, 64));
+   assert_false(bitset_test(uint32_t, bits, 63));
+   assert_true(bitset_test(uint32_t, bits, 62));
+   assert_int_equal(bitset_count(uint32_t, bits), ARRAY_LEN(marks) - 1);
+
+   // fill keeps the bits past len clear
+   bitset_fill(uint32_t, bits, true);
+   assert_int_equal(bitset_count(uint32_t, bits), 1000);
+   assert_int_equal(bitset_find_next_clear(uint32_t, bits, 0), BITSET_NONE(uint32_t));
+   assert_int_equal(bitset_words(uint32_t, bits)[15], ~(uint64_t)0 >> (64 - 1000 % 64));
+   bitset_fill(uint32_t, bits, false);
+   assert_int_equal(bitset_count(uint32_t, bits), 0);
+}
+
+static void test_bitset_resize_push_pop(void **state)
+{
+   bitset(uint32_t) *bits = &((test_state_s*)(*state))->a;
+
+   // push / pop like a stack(bool)
+   bool ref[700];
+   uint32_t seed = 3;
+   for (uint32_t i = 0; i < ARRAY_LEN(ref); i++)
+   {
+      ref[i] = next_random(&seed) % 3 == 0;
+      assert_true(bitset_push(uint32_t, bits, ref[i]));
+   }
+   assert_matches(bits, ref, ARRAY_LEN(ref));
+   for (uint32_t i = 0; i < 100; i++)
+      assert_true(bitset_pop(uint32_t, bits));
+   assert_matches(bits, ref, ARRAY_LEN(ref) - 100);
+
+   // shrinking clears the dropped bits, growing brings them back clear
+   bitset_fill(uint32_t, bits, true);
+   assert_true(bitset_resize(uint32_t, bits, 70));
+   assert_int_equal(bitset_count(uint32_t, bits), 70);
+   assert_true(bitset_resize(uint32_t, bits, 650));
+   assert_int_equal(bitset_count(uint32_t, bits), 70);
+   assert_int_equal(bitset_find_next_clear(uint32_t, bits, 0), 70);
+   assert_int_equal(bitset_find_next_set(uint32_t, bits, 70), BITSET_NONE(uint32_t));
+}
+
+static void test_bitset_bulk(void **state)
+{
+   bitset(uint32_t) *a = &((test_state_s*)(*state))->a;
+   bitset(uint32_t) *b = &((test_state_s*)(*state))->b;
+
+   // lengths around the vector widths, equal and mismatched
+   const uint32_t lens[][2] = { { 1000, 1000 }, { 1000, 333 }, { 333, 1000 }, { 64, 64 }, { 511, 512 }, { 5, 0 } };
+   enum { MAX_LEN = 1000 };
+   bool ref_a[MAX_LEN], ref_b[MAX_LEN], expected[MAX_LEN];
+   uint32_t seed = 5;
+
+   for (size_t l = 0; l < ARRAY_LEN(lens); l++)
+   {
+      const uint32_t len_a = lens[l][0], len_b = lens[l][1];
+      for (int op = 0; op < 4; op++)
+      {
+         bitset_resize(uint32_t, a, 0);
+         bitset_resize(uint32_t, b, 0);
+         fill_random(a, ref_a, len_a, 2, &seed);
+         fill_random(b, ref_b, len_b, 3, &seed);
+         for (uint32_t i = 0; i < len_a; i++)
+         {
+            const bool y = i < len_b && ref_b[i];
+            expected[i] = op == 0 ? ref_a[i] && y
+                        : op == 1 ? ref_a[i] || y
+                        : op == 2 ? ref_a[i] != y
+                        : ref_a[i] && !y;
+         }
+         switch (op)
+         {
+            case 0: bitset_and(uint32_t, a, b); break;
+            case 1: bitset_or(uint32_t, a, b); break;
+            case 2: bitset_xor(uint32_t, a, b); break;
+            case 3: bitset_andnot(uint32_t, a, b); break;
+         }
+         assert_matches(a, expected, len_a);
+         assert_matches(b, ref_b, len_b);
+      }
+   }
+
+   // an operand can be its own source
+   fill_random(a, ref_a, 777, 2, &seed);
+   bitset_xor(uint32_t, a, a);
+   assert_int_equal(bitset_count(uint32_t, a), 0);
+}
+
+static void test_bitset_random(void **state)
+{
+   bitset(uint32_t) *bits = &((test_state_s*)(*state))->a;
+
+   enum { LEN = 5000 };
+   bool *ref = (bool*)calloc(LEN, sizeof(bool));
+   assert_non_null(ref);
+   assert_true(bitset_resize(uint32_t, bits, LEN));
+
+   uint32_t seed = 9;
+   for (uint32_t step = 0; step < 20000; step++)
+   {
+      const uint32_t i = next_random(&seed) % LEN;
+      switch (next_random(&seed) % 3)
+      {
+         case 0: bitset_set(uint32_t, bits, i); ref[i] = true; break;
+         case 1: bitset_clear(uint32_t, bits, i); ref[i] = false; break;
+         case 2: bitset_flip(uint32_t, bits, i); ref[i] = !ref[i]; break;
+      }
+
+      if (step % 997 == 0)
+      {
+         assert_matches(bits, ref, LEN);
+         const uint32_t from = next_random(&seed) % LEN;
+         uint32_t next_set = from, next_clear = from;
+         while (next_set < LEN && !ref[next_set])
+            next_set++;
+         while (next_clear < LEN && ref[next_clear])
+            next_clear++;
+         assert_int_equal(bitset_find_next_set(uint32_t, bits, from), next_set < LEN ? next_set : BITSET_NONE(uint32_t));
+         assert_int_equal(bitset_find_next_clear(uint32_t, bits, from), next_clear < LEN ? next_clear : BITSET_NONE(uint32_t));
+      }
+   }
+   free(ref);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_bitset_init_delete),
+      cmocka_unit_test_setup_teardown(test_bitset_set_clear, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_bitset_resize_push_pop, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_bitset_bulk, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_bitset_random, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
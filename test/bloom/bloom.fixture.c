@@ -0,0 +1,24 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "bloom.fixture.h"
+
+
+/* Integer keys */
+
+uint64_t u64_hash(uint64_t key)
+{
+   return hash_bytes(&key, sizeof(key), 0);
+}
+
+GENERATE_BLOOM(uint64_t, u64_hash, malloc, free)
+
+
+/* String keys */
+
+uint64_t cstr_hash(cstr key)
+{
+   return hash_bytes(key, strlen(key), 0);
+}
+
+GENERATE_BLOOM(cstr, cstr_hash, malloc, free)
\ No newline at end of file
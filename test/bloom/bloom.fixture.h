@@ -0,0 +1,15 @@
+#ifndef __BLOOM_FIXTURE_H
+#define __BLOOM_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Integer keys */
+DEFINE_BLOOM(uint64_t)
+
+/* String keys */
+typedef const char* cstr;
+DEFINE_BLOOM(cstr)
+
+#endif /* __BLOOM_FIXTURE_H */
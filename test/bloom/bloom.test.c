@@ -0,0 +1,223 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "bloom.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   bloom(uint64_t) filter;
+   bloom(uint64_t) other;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   bloom_init(uint64_t, &tmp->filter, 100000, 0.01);
+   bloom_init(uint64_t, &tmp->other, 100000, 0.01);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   bloom_delete(uint64_t, &tmp->filter);
+   bloom_delete(uint64_t, &tmp->other);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+/* inserted keys are even, absent keys odd */
+static uint64_t key_of(uint64_t i)
+{
+   return i * 2;
+}
+
+
+static void test_bloom_sizing(void **state)
+{
+   // lower rates and more keys need more blocks
+   assert_int_equal(bloom_blocks_for(0, 0.01), 1);
+   assert_true(bloom_blocks_for(100000, 0.001) > bloom_blocks_for(100000, 0.01));
+   assert_true(bloom_blocks_for(200000, 0.01) > bloom_blocks_for(100000, 0.01));
+
+   // the estimate at the expected count stays within the target, near it
+   const double rates[] = { 0.1, 0.01, 0.001, 0.0001 };
+   for (size_t r = 0; r < ARRAY_LEN(rates); r++)
+   {
+      const size_t blocks = bloom_blocks_for(100000, rates[r]);
+      const double fpr = bloom_estimate_fpr(100000.0 / blocks);
+      assert_true(fpr <= rates[r]);
+      assert_true(fpr > rates[r] * 0.9);
+   }
+   assert_true(bloom_estimate_fpr(1.0) < bloom_estimate_fpr(10.0));
+   assert_true(bloom_estimate_fpr(0.0) == 0.0);
+}
+
+static void test_bloom_insert_contains(void **state)
+{
+   bloom(uint64_t) *filter = &((test_state_s*)(*state))->filter;
+
+   assert_true(bloom_empty(uint64_t, filter));
+   assert_false(bloom_contains(uint64_t, filter, 1));
+   assert_ptr_equal(filter->blocks, NULL);
+
+   for (uint64_t i = 0; i < 100000; i++)
+      assert_true(bloom_insert(uint64_t, filter, key_of(i)));
+   assert_int_equal(bloom_len(uint64_t, filter), 100000);
+   assert_int_equal((uintptr_t)filter->blocks % BLOOM_BLOCK_BYTES, 0);
+   assert_int_equal(bloom_bytes(uint64_t, filter), BLOOM_BLOCK_BYTES * bloom_block_count(uint64_t, filter));
+
+   // no false negatives
+   for (uint64_t i = 0; i < 100000; i++)
+      assert_true(bloom_contains(uint64_t, filter, key_of(i)));
+
+   // measured rate close to the 1% asked for
+   uint64_t false_positives = 0;
+   for (uint64_t i = 0; i < 1000000; i++)
+      false_positives += bloom_contains(uint64_t, filter, key_of(i) + 1);
+   const double measured = false_positives / 1e6;
+   assert_true(measured < 0.0125);
+   assert_true(measured > 0.0075);
+   assert_true(bloom_fpr(uint64_t, filter) <= 0.01);
+
+   bloom_clear(uint64_t, filter);
+   assert_true(bloom_empty(uint64_t, filter));
+   for (uint64_t i = 0; i < 1000; i++)
+      assert_false(bloom_contains(uint64_t, filter, key_of(i)));
+}
+
+static void test_bloom_merge(void **state)
+{
+   bloom(uint64_t) *filter = &((test_state_s*)(*state))->filter;
+   bloom(uint64_t) *other = &((test_state_s*)(*state))->other;
+
+   // merging an unused filter changes nothing, into an unused one copies
+   assert_true(bloom_merge(uint64_t, filter, other));
+   assert_ptr_equal(filter->blocks, NULL);
+   for (uint64_t i = 0; i < 5000; i++)
+      assert_true(bloom_insert(uint64_t, other, key_of(i)));
+   assert_true(bloom_merge(uint64_t, filter, other));
+   for (uint64_t i = 0; i < 5000; i++)
+      assert_true(bloom_contains(uint64_t, filter, key_of(i)));
+
+   // per-thread filters: each sees a share of the keys, the union sees all
+   bloom(uint64_t) shards[4];
+   for (int s = 0; s < 4; s++)
+   {
+      bloom_init(uint64_t, &shards[s], 100000, 0.01);
+      for (uint64_t i = 5000 + s; i < 50000; i += 4)
+         assert_true(bloom_insert(uint64_t, &shards[s], key_of(i)));
+   }
+   for (int s = 0; s < 4; s++)
+   {
+      assert_true(bloom_merge(uint64_t, filter, &shards[s]));
+      bloom_delete(uint64_t, &shards[s]);
+   }
+   assert_int_equal(bloom_len(uint64_t, filter), 50000);
+   for (uint64_t i = 0; i < 50000; i++)
+      assert_true(bloom_contains(uint64_t, filter, key_of(i)));
+
+   // filters of different sizes do not merge
+   bloom(uint64_t) small;
+   bloom_init(uint64_t, &small, 10, 0.01);
+   assert_true(bloom_insert(uint64_t, &small, 1));
+   assert_false(bloom_merge(uint64_t, filter, &small));
+   assert_false(bloom_merge(uint64_t, &small, filter));
+   bloom_delete(uint64_t, &small);
+}
+
+static void test_bloom_serialize(void **state)
+{
+   bloom(uint64_t) *filter = &((test_state_s*)(*state))->filter;
+
+   for (uint64_t i = 0; i < 20000; i++)
+      assert_true(bloom_insert(uint64_t, filter, key_of(i)));
+
+   const size_t size = bloom_serialized_size(uint64_t, filter);
+   assert_int_equal(size, BLOOM_HEADER_BYTES + bloom_bytes(uint64_t, filter));
+   unsigned char *buffer = (unsigned char*)malloc(size);
+   assert_non_null(buffer);
+   assert_int_equal(bloom_serialize(uint64_t, filter, buffer), size);
+
+   // round trip into a filter of another size
+   bloom(uint64_t) copy;
+   bloom_init(uint64_t, &copy, 10, 0.5);
+   assert_true(bloom_insert(uint64_t, &copy, 12345));
+   assert_true(bloom_deserialize(uint64_t, &copy, buffer, size));
+   assert_int_equal(bloom_block_count(uint64_t, &copy), bloom_block_count(uint64_t, filter));
+   assert_int_equal(bloom_len(uint64_t, &copy), 20000);
+   assert_memory_equal(copy.blocks, filter->blocks, bloom_bytes(uint64_t, filter));
+   for (uint64_t i = 0; i < 20000; i++)
+      assert_true(bloom_contains(uint64_t, &copy, key_of(i)));
+   assert_true(bloom_merge(uint64_t, &copy, filter));
+
+   // truncated or foreign buffers are rejected, the filter unchanged
+   assert_false(bloom_deserialize(uint64_t, &copy, buffer, size - 1));
+   assert_false(bloom_deserialize(uint64_t, &copy, buffer, 8));
+   buffer[0] ^= 1;
+   assert_false(bloom_deserialize(uint64_t, &copy, buffer, size));
+   assert_int_equal(bloom_len(uint64_t, &copy), 40000);
+   bloom_delete(uint64_t, &copy);
+
+   // an unused filter serializes as empty blocks
+   bloom(uint64_t) empty;
+   bloom_init(uint64_t, &empty, 10, 0.01);
+   unsigned char small[BLOOM_HEADER_BYTES + BLOOM_BLOCK_BYTES];
+   assert_int_equal(bloom_serialized_size(uint64_t, &empty), sizeof(small));
+   assert_int_equal(bloom_serialize(uint64_t, &empty, small), sizeof(small));
+   assert_true(bloom_deserialize(uint64_t, &empty, small, sizeof(small)));
+   assert_false(bloom_contains(uint64_t, &empty, 1));
+   bloom_delete(uint64_t, &empty);
+   free(buffer);
+}
+
+static void test_cstr_bloom(void **state)
+{
+   bloom(cstr) words;
+   bloom_init(cstr, &words, 1000, 0.001);
+
+   char key[32];
+   for (int i = 0; i < 1000; i++)
+   {
+      snprintf(key, sizeof(key), "word-%d", i);
+      assert_true(bloom_insert(cstr, &words, key));
+   }
+   for (int i = 0; i < 1000; i++)
+   {
+      snprintf(key, sizeof(key), "word-%d", i);
+      assert_true(bloom_contains(cstr, &words, key));
+   }
+   int false_positives = 0;
+   for (int i = 0; i < 100000; i++)
+   {
+      snprintf(key, sizeof(key), "other-%d", i);
+      false_positives += bloom_contains(cstr, &words, key);
+   }
+   assert_true(false_positives < 200);
+   bloom_delete(cstr, &words);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_bloom_sizing),
+      cmocka_unit_test_setup_teardown(test_bloom_insert_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_bloom_merge, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_bloom_serialize, setup, teardown),
+      cmocka_unit_test(test_cstr_bloom),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
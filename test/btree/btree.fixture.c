@@ -0,0 +1,60 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "btree.fixture.h"
+
+
+/* Counting allocator */
+
+long test_live_allocations = 0;
+long test_fail_after = -1;
+
+void *test_alloc(size_t size)
+{
+   if (test_fail_after == 0)
+      return NULL;
+   if (test_fail_after > 0)
+      test_fail_after--;
+   void *ptr = malloc(size);
+   if (ptr)
+      test_live_allocations++;
+   return ptr;
+}
+
+void test_free(void *ptr)
+{
+   if (ptr)
+      test_live_allocations--;
+   free(ptr);
+}
+
+
+/* Signed integer keys */
+
+int i64_compare(const int64_t *a, const int64_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_BTREE_MAP(int64_t, int64_t, uint32_t, i64_compare, test_alloc, test_free)
+
+
+/* Unsigned integer keys */
+
+int u32_compare(const uint32_t *a, const uint32_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_BTREE_MAP(uint32_t, uint32_t, uint32_t, u32_compare, test_alloc, test_free)
+
+
+/* Struct keys */
+
+int version_compare(const version_s *a, const version_s *b)
+{
+   if (a->major != b->major)
+      return (a->major > b->major) - (a->major < b->major);
+   return (a->minor > b->minor) - (a->minor < b->minor);
+}
+
+GENERATE_BTREE_MAP(version_s, int, size_t, version_compare, malloc, free)
\ No newline at end of file
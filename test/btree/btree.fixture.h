@@ -0,0 +1,29 @@
+#ifndef __BTREE_FIXTURE_H
+#define __BTREE_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ccoutils.h"
+
+/* Counting allocator: live nodes, and a countdown to a failed allocation (-1 never fails) */
+extern long test_live_allocations;
+extern long test_fail_after;
+void *test_alloc(size_t size);
+void test_free(void *ptr);
+
+/* Signed integer keys */
+DEFINE_BTREE_MAP(int64_t, int64_t, uint32_t)
+
+/* Unsigned integer keys */
+DEFINE_BTREE_MAP(uint32_t, uint32_t, uint32_t)
+
+/* Struct keys, ordered by compare_fn */
+typedef struct
+{
+   uint32_t major;
+   uint32_t minor;
+} version_s;
+DEFINE_BTREE_MAP(version_s, int, size_t)
+
+#endif /* __BTREE_FIXTURE_H */
@@ -0,0 +1,493 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "btree.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   btree_map(int64_t, int64_t) map;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   btree_map_init(int64_t, int64_t, &tmp->map);
+   test_fail_after = -1;
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   btree_map_delete(int64_t, int64_t, &tmp->map);
+   assert_int_equal(test_live_allocations, 0);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+enum { FANOUT = int64_t_int64_t_btree_fanout };
+
+typedef struct
+{
+   const int64_t_int64_t_btree_leaf_s *leaf; /* next leaf expected in the chain */
+   int64_t last;
+   bool any;
+} walk_s;
+
+/* check the subtree of `node` holds keys in [lo, hi) and every B+ tree invariant; returns its key count */
+static size_t check_node(const int64_t_int64_t_btree_node_s *node, uint32_t depth, uint32_t height, bool root,
+                         const int64_t *lo, const int64_t *hi, walk_s *walk)
+{
+   assert_true(node->count <= FANOUT);
+   if (!root)
+      assert_true(node->count >= FANOUT / 2);
+   for (uint32_t i = 1; i < node->count; i++)
+      assert_true(node->keys[i - 1] < node->keys[i]);
+   if (node->count)
+   {
+      if (lo)
+         assert_true(node->keys[0] >= *lo);
+      if (hi)
+         assert_true(node->keys[node->count - 1] < *hi);
+   }
+
+   if (node->leaf)
+   {
+      assert_int_equal(depth, height);
+      const int64_t_int64_t_btree_leaf_s *leaf = (const int64_t_int64_t_btree_leaf_s*)node;
+      assert_ptr_equal(leaf, walk->leaf);
+      for (uint32_t i = 0; i < node->count; i++)
+      {
+         if (walk->any)
+            assert_true(walk->last < node->keys[i]);
+         walk->last = node->keys[i];
+         walk->any = true;
+      }
+      if (leaf->next)
+         assert_ptr_equal(leaf->next->prev, leaf);
+      walk->leaf = leaf->next;
+      return node->count;
+   }
+
+   assert_true(node->count > 0);
+   const int64_t_int64_t_btree_inner_s *inner = (const int64_t_int64_t_btree_inner_s*)node;
+   size_t total = 0;
+   for (uint32_t i = 0; i <= node->count; i++)
+      total += check_node(inner->children[i], depth + 1, height, false,
+                          i > 0 ? &node->keys[i - 1] : lo, i < node->count ? &node->keys[i] : hi, walk);
+   return total;
+}
+
+static void check_tree(const btree_map(int64_t, int64_t) *map)
+{
+   if (!map->root)
+   {
+      assert_int_equal(btree_map_len(int64_t, int64_t, map), 0);
+      assert_ptr_equal(map->first, NULL);
+      assert_ptr_equal(map->last, NULL);
+      assert_int_equal(map->height, 0);
+      return;
+   }
+   assert_ptr_equal(map->first->prev, NULL);
+   assert_ptr_equal(map->last->next, NULL);
+   walk_s walk = { map->first, 0, false };
+   assert_int_equal(check_node(map->root, 0, map->height, true, NULL, NULL, &walk), btree_map_len(int64_t, int64_t, map));
+   assert_ptr_equal(walk.leaf, NULL);
+}
+
+
+static void test_btree_rank_kernels(void **state)
+{
+   uint32_t keys32[130];
+   uint64_t keys64[130];
+   uint64_t seed = 7;
+
+   for (uint32_t n = 0; n <= ARRAY_LEN(keys32); n++)
+   {
+      for (int is_signed = 0; is_signed < 2; is_signed++)
+      {
+         // sorted (in the key's own order) with duplicates and values near the sign bit
+         for (uint32_t i = 0; i < n; i++)
+         {
+            keys32[i] = (uint32_t)(next_random(&seed) % 64) + 0x7FFFFFE0u;
+            keys64[i] = (next_random(&seed) % 64) + 0x7FFFFFFFFFFFFFE0ull;
+         }
+         for (uint32_t i = 1; i < n; i++)
+            for (uint32_t j = i; j > 0; j--)
+            {
+               const bool swap32 = is_signed ? (int32_t)keys32[j - 1] > (int32_t)keys32[j] : keys32[j - 1] > keys32[j];
+               const bool swap64 = is_signed ? (int64_t)keys64[j - 1] > (int64_t)keys64[j] : keys64[j - 1] > keys64[j];
+               if (swap32) { uint32_t t = keys32[j]; keys32[j] = keys32[j - 1]; keys32[j - 1] = t; }
+               if (swap64) { uint64_t t = keys64[j]; keys64[j] = keys64[j - 1]; keys64[j - 1] = t; }
+            }
+
+         for (int probe = 0; probe < 8; probe++)
+         {
+            const uint32_t x32 = (uint32_t)(next_random(&seed) % 80) + 0x7FFFFFD8u;
+            const uint64_t x64 = (next_random(&seed) % 80) + 0x7FFFFFFFFFFFFFD8ull;
+            for (int inclusive = 0; inclusive < 2; inclusive++)
+            {
+               uint32_t expected32 = 0, expected64 = 0;
+               for (uint32_t i = 0; i < n; i++)
+               {
+                  const bool below32 = is_signed ? (int32_t)keys32[i] < (int32_t)x32 : keys32[i] < x32;
+                  const bool below64 = is_signed ? (int64_t)keys64[i] < (int64_t)x64 : keys64[i] < x64;
+                  expected32 += below32 || (inclusive && keys32[i] == x32);
+                  expected64 += below64 || (inclusive && keys64[i] == x64);
+               }
+               assert_int_equal(btree_rank_32(keys32, n, x32, is_signed, inclusive), expected32);
+               assert_int_equal(btree_rank_64(keys64, n, x64, is_signed, inclusive), expected64);
+            }
+         }
+      }
+   }
+}
+
+static void test_btree_insert_get(void **state)
+{
+   btree_map(int64_t, int64_t) *map = &((test_state_s*)(*state))->map;
+
+   assert_true(btree_map_empty(int64_t, int64_t, map));
+   assert_ptr_equal(btree_map_get(int64_t, int64_t, map, 1), NULL);
+   assert_false(btree_map_remove(int64_t, int64_t, map, 1));
+   assert_false(btree_map_iterator_valid(int64_t, int64_t, btree_map_first(int64_t, int64_t, map)));
+
+   // a permutation of [-5000, 5000), negative keys included
+   enum { N = 10000 };
+   for (int64_t i = 0; i < N; i++)
+   {
+      const int64_t key = (i * 7919) % N - N / 2;
+      assert_true(btree_map_insert(int64_t, int64_t, map, key, key * 3));
+   }
+   check_tree(map);
+   assert_int_equal(btree_map_len(int64_t, int64_t, map), N);
+   assert_true(btree_map_height(int64_t, int64_t, map) >= 1);
+   for (int64_t key = -N / 2; key < N / 2; key++)
+   {
+      int64_t *value = btree_map_get(int64_t, int64_t, map, key);
+      assert_non_null(value);
+      assert_int_equal(*value, key * 3);
+   }
+   assert_false(btree_map_contains(int64_t, int64_t, map, N / 2));
+   assert_false(btree_map_contains(int64_t, int64_t, map, INT64_MIN));
+
+   // insert overwrites
+   assert_true(btree_map_insert(int64_t, int64_t, map, -7, 70));
+   assert_int_equal(btree_map_len(int64_t, int64_t, map), N);
+   assert_int_equal(*btree_map_get(int64_t, int64_t, map, -7), 70);
+
+   // iteration visits keys in order, both ways
+   int64_t expected = -N / 2;
+   for (btree_map_iterator(int64_t, int64_t) it = btree_map_first(int64_t, int64_t, map);
+        btree_map_iterator_valid(int64_t, int64_t, it); btree_map_iterator_next(int64_t, int64_t, &it))
+      assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), expected++);
+   assert_int_equal(expected, N / 2);
+   for (btree_map_iterator(int64_t, int64_t) it = btree_map_last(int64_t, int64_t, map);
+        btree_map_iterator_valid(int64_t, int64_t, it); btree_map_iterator_prev(int64_t, int64_t, &it))
+      assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), --expected);
+   assert_int_equal(expected, -N / 2);
+
+   btree_map_clear(int64_t, int64_t, map);
+   assert_int_equal(test_live_allocations, 0);
+   check_tree(map);
+}
+
+static void test_btree_remove_random(void **state)
+{
+   btree_map(int64_t, int64_t) *map = &((test_state_s*)(*state))->map;
+
+   enum { DOMAIN = 3000 };
+   bool *present = (bool*)calloc(DOMAIN, sizeof(bool));
+   assert_non_null(present);
+   size_t len = 0;
+   uint64_t seed = 11;
+
+   for (uint32_t step = 0; step < 60000; step++)
+   {
+      // insert-heavy first half, remove-heavy second half
+      const int64_t key = (int64_t)(next_random(&seed) % DOMAIN) - DOMAIN / 3;
+      const bool insert = next_random(&seed) % 10 < (step < 30000 ? 7 : 3);
+      bool *slot = &present[key + DOMAIN / 3];
+      if (insert)
+      {
+         assert_true(btree_map_insert(int64_t, int64_t, map, key, -key));
+         len += !*slot;
+         *slot = true;
+      }
+      else
+      {
+         assert_int_equal(btree_map_remove(int64_t, int64_t, map, key), *slot);
+         len -= *slot;
+         *slot = false;
+      }
+      assert_int_equal(btree_map_len(int64_t, int64_t, map), len);
+      if (step % 1999 == 0)
+      {
+         check_tree(map);
+         for (int64_t k = 0; k < DOMAIN; k++)
+            assert_int_equal(btree_map_contains(int64_t, int64_t, map, k - DOMAIN / 3), present[k]);
+      }
+   }
+
+   // removing everything frees every node
+   for (int64_t k = 0; k < DOMAIN; k++)
+      if (present[k])
+         assert_true(btree_map_remove(int64_t, int64_t, map, k - DOMAIN / 3));
+   check_tree(map);
+   assert_ptr_equal(map->root, NULL);
+   assert_int_equal(test_live_allocations, 0);
+   free(present);
+}
+
+static void test_btree_range(void **state)
+{
+   btree_map(int64_t, int64_t) *map = &((test_state_s*)(*state))->map;
+
+   // even keys 0, 2, .., 19998
+   for (int64_t i = 0; i < 10000; i++)
+      assert_true(btree_map_insert(int64_t, int64_t, map, i * 2, i));
+
+   btree_map_iterator(int64_t, int64_t) it = btree_map_lower_bound(int64_t, int64_t, map, 100);
+   assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), 100);
+   it = btree_map_upper_bound(int64_t, int64_t, map, 100);
+   assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), 102);
+   it = btree_map_lower_bound(int64_t, int64_t, map, 101);
+   assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), 102);
+   it = btree_map_lower_bound(int64_t, int64_t, map, -50);
+   assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), 0);
+   assert_false(btree_map_iterator_valid(int64_t, int64_t, btree_map_lower_bound(int64_t, int64_t, map, 19999)));
+   assert_false(btree_map_iterator_valid(int64_t, int64_t, btree_map_upper_bound(int64_t, int64_t, map, 19998)));
+
+   // every range [lo, hi) agrees with arithmetic, across leaf boundaries
+   uint64_t seed = 13;
+   for (int r = 0; r < 500; r++)
+   {
+      const int64_t lo = (int64_t)(next_random(&seed) % 20100) - 50;
+      const int64_t hi = lo + (int64_t)(next_random(&seed) % 600);
+      int64_t sum = 0, count = 0;
+      for (it = btree_map_lower_bound(int64_t, int64_t, map, lo);
+           btree_map_iterator_valid(int64_t, int64_t, it) && *btree_map_iterator_key(int64_t, int64_t, it) < hi;
+           btree_map_iterator_next(int64_t, int64_t, &it))
+      {
+         sum += *btree_map_iterator_value(int64_t, int64_t, it);
+         count++;
+      }
+      int64_t expected_sum = 0, expected_count = 0;
+      for (int64_t k = lo < 0 ? 0 : lo; k < hi && k < 20000; k++)
+         if (k % 2 == 0)
+         {
+            expected_sum += k / 2;
+            expected_count++;
+         }
+      assert_int_equal(count, expected_count);
+      assert_int_equal(sum, expected_sum);
+   }
+
+   // values are writable through the iterator, stepping back from upper_bound
+   it = btree_map_upper_bound(int64_t, int64_t, map, 500);
+   btree_map_iterator_prev(int64_t, int64_t, &it);
+   assert_int_equal(*btree_map_iterator_key(int64_t, int64_t, it), 500);
+   *btree_map_iterator_value(int64_t, int64_t, it) = -1;
+   assert_int_equal(*btree_map_get(int64_t, int64_t, map, 500), -1);
+}
+
+static void test_btree_bulk_load(void **state)
+{
+   btree_map(int64_t, int64_t) *map = &((test_state_s*)(*state))->map;
+
+   enum { MAX = 100000 };
+   int64_t *keys = (int64_t*)malloc(sizeof(int64_t) * MAX);
+   int64_t *values = (int64_t*)malloc(sizeof(int64_t) * MAX);
+   assert_non_null(keys);
+   assert_non_null(values);
+   for (int64_t i = 0; i < MAX; i++)
+   {
+      keys[i] = i * 3 - MAX;
+      values[i] = i;
+   }
+
+   const uint32_t sizes[] = { 0, 1, FANOUT - 1, FANOUT, FANOUT + 1, FANOUT * (FANOUT + 1), FANOUT * (FANOUT + 1) + 1, 777, MAX };
+   for (size_t s = 0; s < ARRAY_LEN(sizes); s++)
+   {
+      const uint32_t n = sizes[s];
+      assert_true(btree_map_bulk_load(int64_t, int64_t, map, keys, values, n));
+      assert_int_equal(btree_map_len(int64_t, int64_t, map), n);
+      check_tree(map);
+      for (uint32_t i = 0; i < n; i += 7)
+         assert_int_equal(*btree_map_get(int64_t, int64_t, map, keys[i]), values[i]);
+
+      // a loaded tree takes inserts and removes like any other
+      for (int64_t k = -MAX - 20; k < -MAX + 200; k++)
+         assert_true(btree_map_insert(int64_t, int64_t, map, k, 0));
+      for (uint32_t i = 0; i < n; i += 2)
+         assert_true(btree_map_remove(int64_t, int64_t, map, keys[i]));
+      check_tree(map);
+
+      // only into an empty map
+      if (!btree_map_empty(int64_t, int64_t, map))
+         assert_false(btree_map_bulk_load(int64_t, int64_t, map, keys, values, n));
+      btree_map_clear(int64_t, int64_t, map);
+      assert_int_equal(test_live_allocations, 0);
+   }
+
+   // keys must be strictly increasing
+   keys[500] = keys[499];
+   assert_false(btree_map_bulk_load(int64_t, int64_t, map, keys, values, 1000));
+   assert_true(btree_map_empty(int64_t, int64_t, map));
+   assert_int_equal(test_live_allocations, 0);
+   free(keys);
+   free(values);
+}
+
+static void test_btree_allocation_failure(void **state)
+{
+   btree_map(int64_t, int64_t) *map = &((test_state_s*)(*state))->map;
+
+   // every allocation of a growing tree fails once; the map stays as it was
+   uint64_t seed = 17;
+   for (int64_t i = 0; i < 5000; i++)
+   {
+      const int64_t key = (int64_t)(next_random(&seed) % 100000);
+      const uint32_t len = btree_map_len(int64_t, int64_t, map);
+      const long live = test_live_allocations;
+      test_fail_after = 0;
+      const bool inserted = btree_map_insert(int64_t, int64_t, map, key, i);
+      test_fail_after = -1;
+      if (!inserted)
+      {
+         assert_int_equal(btree_map_len(int64_t, int64_t, map), len);
+         assert_int_equal(test_live_allocations, live);
+         assert_false(btree_map_contains(int64_t, int64_t, map, key));
+         if (i % 100 == 0)
+            check_tree(map);
+         assert_true(btree_map_insert(int64_t, int64_t, map, key, i));
+      }
+      // a split deep in the tree fails on its last allocation
+      else if (i % 50 == 0)
+      {
+         const uint32_t height = btree_map_height(int64_t, int64_t, map);
+         test_fail_after = height;
+         for (int64_t k = 100000; k < 100000 + FANOUT * 2; k++)
+            if (!btree_map_insert(int64_t, int64_t, map, k, 0))
+               break;
+         test_fail_after = -1;
+         check_tree(map);
+         for (int64_t k = 100000; k < 100000 + FANOUT * 2; k++)
+            btree_map_remove(int64_t, int64_t, map, k);
+      }
+   }
+   check_tree(map);
+
+   // a failed bulk load leaves the map empty and frees what it built
+   int64_t keys[5000], values[5000];
+   for (int64_t i = 0; i < 5000; i++)
+      keys[i] = values[i] = i;
+   btree_map_clear(int64_t, int64_t, map);
+   for (long fail = 0; fail < 20; fail++)
+   {
+      test_fail_after = fail * 7;
+      const bool loaded = btree_map_bulk_load(int64_t, int64_t, map, keys, values, 5000);
+      test_fail_after = -1;
+      if (!loaded)
+      {
+         assert_true(btree_map_empty(int64_t, int64_t, map));
+         assert_int_equal(test_live_allocations, 0);
+      }
+      check_tree(map);
+      btree_map_clear(int64_t, int64_t, map);
+   }
+}
+
+static void test_btree_unsigned_keys(void **state)
+{
+   btree_map(uint32_t, uint32_t) map;
+   btree_map_init(uint32_t, uint32_t, &map);
+
+   // keys with the top bit set sort above the others
+   const uint32_t keys[] = { 0, 1, 0x7FFFFFFFu, 0x80000000u, 0xFFFFFFFEu, 0xFFFFFFFFu };
+   for (uint32_t i = 0; i < 3000; i++)
+      assert_true(btree_map_insert(uint32_t, uint32_t, &map, i * 0x155555u, i));
+   for (size_t i = 0; i < ARRAY_LEN(keys); i++)
+      assert_true(btree_map_insert(uint32_t, uint32_t, &map, keys[i], 7));
+
+   uint32_t previous = 0;
+   size_t count = 0;
+   for (btree_map_iterator(uint32_t, uint32_t) it = btree_map_first(uint32_t, uint32_t, &map);
+        btree_map_iterator_valid(uint32_t, uint32_t, it); btree_map_iterator_next(uint32_t, uint32_t, &it))
+   {
+      if (count++)
+         assert_true(*btree_map_iterator_key(uint32_t, uint32_t, it) > previous);
+      previous = *btree_map_iterator_key(uint32_t, uint32_t, it);
+   }
+   assert_int_equal(count, btree_map_len(uint32_t, uint32_t, &map));
+   assert_int_equal(previous, 0xFFFFFFFFu);
+   assert_int_equal(*btree_map_iterator_key(uint32_t, uint32_t, btree_map_lower_bound(uint32_t, uint32_t, &map, 0x7FFFFFFFu + 1)), 0x80000000u);
+   for (size_t i = 0; i < ARRAY_LEN(keys); i++)
+      assert_int_equal(*btree_map_get(uint32_t, uint32_t, &map, keys[i]), 7);
+
+   btree_map_delete(uint32_t, uint32_t, &map);
+   assert_int_equal(test_live_allocations, 0);
+}
+
+static void test_btree_struct_keys(void **state)
+{
+   btree_map(version_s, int) versions;
+   btree_map_init(version_s, int, &versions);
+
+   // compare_fn orders by major, then minor
+   for (uint32_t major = 0; major < 40; major++)
+      for (uint32_t minor = 0; minor < 40; minor++)
+         assert_true(btree_map_insert(version_s, int, &versions, ((version_s){ 39 - major, minor }), (int)((39 - major) * 100 + minor)));
+   assert_int_equal(btree_map_len(version_s, int, &versions), 1600);
+   assert_int_equal(*btree_map_get(version_s, int, &versions, ((version_s){ 12, 34 })), 1234);
+   assert_true(btree_map_remove(version_s, int, &versions, ((version_s){ 12, 34 })));
+   assert_false(btree_map_contains(version_s, int, &versions, ((version_s){ 12, 34 })));
+
+   // all of major 12, in order
+   int expected = 1200;
+   for (btree_map_iterator(version_s, int) it = btree_map_lower_bound(version_s, int, &versions, ((version_s){ 12, 0 }));
+        btree_map_iterator_valid(version_s, int, it) && btree_map_iterator_key(version_s, int, it)->major == 12;
+        btree_map_iterator_next(version_s, int, &it))
+   {
+      if (expected == 1234)
+         expected++;
+      assert_int_equal(*btree_map_iterator_value(version_s, int, it), expected++);
+   }
+   assert_int_equal(expected, 1240);
+   btree_map_delete(version_s, int, &versions);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_btree_rank_kernels),
+      cmocka_unit_test_setup_teardown(test_btree_insert_get, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_btree_remove_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_btree_range, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_btree_bulk_load, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_btree_allocation_failure, setup, teardown),
+      cmocka_unit_test(test_btree_unsigned_keys),
+      cmocka_unit_test(test_btree_struct_keys),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
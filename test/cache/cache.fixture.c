@@ -0,0 +1,33 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "cache.fixture.h"
+
+
+/* Int -> int cache */
+
+uint64_t int_hash(int key)
+{
+   return hash_bytes(&key, sizeof(key), 0);
+}
+
+bool int_equal(int a, int b)
+{
+   return a == b;
+}
+
+GENERATE_CACHE(int, int, uint32_t, int_hash, int_equal, malloc, free)
+
+
+/* Decoded objects owned by the cache */
+
+uint64_t u64_hash(uint64_t key)
+{
+   return hash_bytes(&key, sizeof(key), 0);
+}
+
+bool u64_equal(uint64_t a, uint64_t b)
+{
+   return a == b;
+}
+
+GENERATE_CACHE(uint64_t, object_ptr, size_t, u64_hash, u64_equal, malloc, free)
\ No newline at end of file
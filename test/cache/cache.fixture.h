@@ -0,0 +1,20 @@
+#ifndef __CACHE_FIXTURE_H
+#define __CACHE_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Int -> int cache */
+DEFINE_CACHE(int, int, uint32_t)
+
+/* Decoded objects owned by the cache */
+typedef struct
+{
+   uint64_t id;
+   char text[24];
+} object_s;
+typedef object_s* object_ptr;
+DEFINE_CACHE(uint64_t, object_ptr, size_t)
+
+#endif /* __CACHE_FIXTURE_H */
@@ -0,0 +1,370 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <cmocka.h>
+#include "cache.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+/* what the eviction callback saw */
+typedef struct
+{
+   int keys[64];
+   int values[64];
+   size_t count;
+} evicted_log_s;
+
+static void log_evicted(int key, int *value, void *ctx)
+{
+   evicted_log_s *const log = (evicted_log_s*)ctx;
+   if (log->count < ARRAY_LEN(log->keys))
+   {
+      log->keys[log->count] = key;
+      log->values[log->count] = *value;
+   }
+   log->count++;
+}
+
+struct test_state
+{
+   cache(int, int) int_cache;
+   evicted_log_s log;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)calloc(1, sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   cache_init(int, int, &tmp->int_cache, 4, log_evicted, &tmp->log);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   cache_delete(int, int, &tmp->int_cache);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+
+/* Int -> int cache */
+
+static void test_int_cache_init_delete(void **state)
+{
+   cache(int, int) c;
+   cache_init(int, int, &c, 100, NULL, NULL);
+   assert_int_equal(cache_len(int, int, &c), 0);
+   assert_int_equal(cache_capacity(int, int, &c), 100);
+   assert_true(cache_empty(int, int, &c));
+   assert_ptr_equal(c.ctrl, NULL);
+
+   // lookups on an unallocated cache
+   assert_false(cache_contains(int, int, &c, 3));
+   assert_ptr_equal(cache_get(int, int, &c, 3), NULL);
+   assert_ptr_equal(cache_pin(int, int, &c, 3), NULL);
+   assert_false(cache_unpin(int, int, &c, 3));
+   assert_false(cache_remove(int, int, &c, 3));
+   assert_int_equal(cache_misses(int, int, &c), 2);
+   assert_true(cache_hit_rate(int, int, &c) == 0.0);
+
+   assert_true(cache_put(int, int, &c, 3, 30));
+   assert_ptr_not_equal(c.ctrl, NULL);
+   assert_int_equal(*cache_get(int, int, &c, 3), 30);
+   assert_true(cache_hit_rate(int, int, &c) == 1.0 / 3.0);
+
+   // delete keeps the capacity, the cache can be used again
+   cache_delete(int, int, &c);
+   assert_true(cache_empty(int, int, &c));
+   assert_ptr_equal(c.ctrl, NULL);
+   assert_int_equal(cache_capacity(int, int, &c), 100);
+   assert_false(cache_contains(int, int, &c, 3));
+   assert_true(cache_put(int, int, &c, 4, 40));
+   cache_delete(int, int, &c);
+}
+
+static void test_int_cache_clock(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   cache(int, int) *c = &s->int_cache;
+
+   for (int k = 1; k <= 4; k++)
+      assert_true(cache_put(int, int, c, k, 10 * k));
+   assert_true(cache_full(int, int, c));
+   assert_int_equal(s->log.count, 0);
+
+   // 1 and 2 get a second chance, 3 is the first unreferenced entry
+   assert_int_equal(*cache_get(int, int, c, 1), 10);
+   assert_int_equal(*cache_get(int, int, c, 2), 20);
+   assert_true(cache_put(int, int, c, 5, 50));
+   assert_int_equal(s->log.count, 1);
+   assert_int_equal(s->log.keys[0], 3);
+   assert_int_equal(s->log.values[0], 30);
+   assert_false(cache_contains(int, int, c, 3));
+
+   // the hand moves on: 4, then 1 (its mark was cleared)
+   assert_true(cache_put(int, int, c, 6, 60));
+   assert_true(cache_put(int, int, c, 7, 70));
+   assert_int_equal(s->log.count, 3);
+   assert_int_equal(s->log.keys[1], 4);
+   assert_int_equal(s->log.keys[2], 1);
+   assert_int_equal(cache_evictions(int, int, c), 3);
+   assert_int_equal(cache_len(int, int, c), 4);
+
+   // replacing a value hands the old one to the callback, not an eviction
+   assert_true(cache_put(int, int, c, 2, 21));
+   assert_int_equal(s->log.count, 4);
+   assert_int_equal(s->log.keys[3], 2);
+   assert_int_equal(s->log.values[3], 20);
+   assert_int_equal(*cache_get(int, int, c, 2), 21);
+   assert_int_equal(cache_evictions(int, int, c), 3);
+
+   // removed entries are reused before anything is evicted
+   assert_true(cache_remove(int, int, c, 5));
+   assert_false(cache_remove(int, int, c, 5));
+   assert_int_equal(s->log.count, 5);
+   assert_true(cache_put(int, int, c, 8, 80));
+   assert_int_equal(cache_evictions(int, int, c), 3);
+   assert_int_equal(cache_len(int, int, c), 4);
+
+   assert_int_equal(cache_hits(int, int, c), 3);
+   assert_int_equal(cache_misses(int, int, c), 0);
+
+   // clear drops everything through the callback, counters survive
+   cache_clear(int, int, c);
+   assert_true(cache_empty(int, int, c));
+   assert_int_equal(s->log.count, 9);
+   assert_int_equal(cache_hits(int, int, c), 3);
+   for (int k = 1; k <= 8; k++)
+      assert_false(cache_contains(int, int, c, k));
+}
+
+static void test_int_cache_pin(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   cache(int, int) *c = &s->int_cache;
+
+   for (int k = 1; k <= 4; k++)
+   {
+      assert_true(cache_put(int, int, c, k, 10 * k));
+      assert_int_equal(*cache_pin(int, int, c, k), 10 * k);
+   }
+
+   // every entry pinned: nothing to evict
+   assert_false(cache_put(int, int, c, 5, 50));
+   assert_false(cache_contains(int, int, c, 5));
+   assert_int_equal(cache_len(int, int, c), 4);
+
+   // pinned entries are neither replaced nor removed
+   assert_false(cache_put(int, int, c, 2, 0));
+   assert_false(cache_remove(int, int, c, 2));
+   assert_int_equal(*cache_get(int, int, c, 2), 20);
+   assert_int_equal(s->log.count, 0);
+
+   // pins nest
+   int *held = cache_pin(int, int, c, 3);
+   assert_true(cache_unpin(int, int, c, 3));
+   assert_false(cache_put(int, int, c, 5, 50));
+   assert_true(cache_unpin(int, int, c, 3));
+   assert_false(cache_unpin(int, int, c, 3));
+
+   // 3 is the only candidate, referenced or not
+   assert_true(cache_put(int, int, c, 5, 50));
+   assert_int_equal(s->log.count, 1);
+   assert_int_equal(s->log.keys[0], 3);
+   assert_ptr_equal(cache_get(int, int, c, 5), held); // its entry is reused
+
+   for (int k = 1; k <= 4; k++)
+      if (k != 3)
+         assert_true(cache_unpin(int, int, c, k));
+   assert_false(cache_unpin(int, int, c, 5));
+}
+
+static void test_int_cache_random(void **state)
+{
+   // random operations against a plain array (-1: not cached)
+   enum { KEYS = 600, CAPACITY = 100 };
+   int model[KEYS];
+   for (int k = 0; k < KEYS; k++)
+      model[k] = -1;
+
+   evicted_log_s log = { 0 };
+   cache(int, int) c;
+   cache_init(int, int, &c, CAPACITY, log_evicted, &log);
+
+   uint32_t seed = 17;
+   size_t cached = 0, callbacks = 0;
+   for (uint32_t step = 0; step < 100000; step++)
+   {
+      // skewed keys: low keys are hot
+      const uint32_t r = next_random(&seed);
+      const int key = (int)((r % 4 == 0) ? (r / 4) % KEYS : (r / 4) % (KEYS / 10));
+      const int value = (int)(next_random(&seed) % 1000);
+      assert_int_equal(cache_contains(int, int, &c, key), model[key] >= 0);
+      log.count = 0;
+      switch (next_random(&seed) % 8)
+      {
+         case 0:
+            assert_int_equal(cache_remove(int, int, &c, key), model[key] >= 0);
+            if (model[key] >= 0)
+            {
+               assert_int_equal(log.count, 1);
+               assert_int_equal(log.values[0], model[key]);
+               model[key] = -1;
+               cached--;
+            }
+            break;
+         case 1:
+         case 2:
+         case 3:
+            assert_true(cache_put(int, int, &c, key, value));
+            if (model[key] < 0)
+               cached++;
+            for (size_t i = 0; i < log.count; i++)
+            {
+               // an eviction or the replaced value
+               assert_int_equal(log.values[i], model[log.keys[i]]);
+               if (log.keys[i] != key)
+               {
+                  model[log.keys[i]] = -1;
+                  cached--;
+               }
+            }
+            model[key] = value;
+            break;
+         default:
+         {
+            const int *found = cache_get(int, int, &c, key);
+            assert_int_equal(found != NULL, model[key] >= 0);
+            if (found)
+               assert_int_equal(*found, model[key]);
+         }
+      }
+      callbacks += log.count;
+      assert_true(cached <= CAPACITY);
+      assert_int_equal(cache_len(int, int, &c), cached);
+   }
+
+   // the hot keys mostly stay cached
+   assert_true(cache_hit_rate(int, int, &c) > 0.5);
+   assert_true(cache_evictions(int, int, &c) > 0);
+   assert_true(callbacks >= cache_evictions(int, int, &c));
+   cache_delete(int, int, &c);
+}
+
+static void test_int_cache_churn(void **state)
+{
+   // remove/put churn leaves tombstones until growth_left runs out while
+   // entries are still unused; the next puts rebuild the index under them
+   enum { CAPACITY = 64, LIVE = 48 };
+   int live[LIVE];
+   cache(int, int) c;
+   cache_init(int, int, &c, CAPACITY, NULL, NULL);
+
+   int key = 0;
+   for (int i = 0; i < LIVE; i++, key++)
+   {
+      assert_true(cache_put(int, int, &c, key, -key));
+      live[i] = key;
+   }
+   uint32_t seed = 3;
+   for (uint32_t step = 0; c.growth_left > 0; step++, key++)
+   {
+      assert_true(step < 100000);
+      const uint32_t i = next_random(&seed) % LIVE;
+      assert_true(cache_remove(int, int, &c, live[i]));
+      assert_true(cache_put(int, int, &c, key, -key));
+      live[i] = key;
+   }
+
+   for (int i = 0; i < CAPACITY - LIVE; i++)
+      assert_true(cache_put(int, int, &c, key + i, -(key + i)));
+   assert_int_equal(cache_len(int, int, &c), CAPACITY);
+   assert_int_equal(cache_evictions(int, int, &c), 0);
+   for (int i = 0; i < LIVE; i++)
+      assert_int_equal(*cache_get(int, int, &c, live[i]), -live[i]);
+   for (int i = 0; i < CAPACITY - LIVE; i++)
+      assert_int_equal(*cache_get(int, int, &c, key + i), -(key + i));
+
+   // one full control byte per cached key: the rebuild indexed no unused entry
+   size_t full = 0;
+   for (size_t slot = 0; slot < c.index_capacity; slot++)
+      full += (c.ctrl[slot] >= 0);
+   assert_int_equal(full, CAPACITY);
+   cache_delete(int, int, &c);
+}
+
+/* Decoded objects owned by the cache */
+
+static void free_object(uint64_t key, object_ptr *value, void *ctx)
+{
+   assert_int_equal((*value)->id, key);
+   (*(size_t*)ctx)++;
+   free(*value);
+}
+
+static object_ptr decode(uint64_t id)
+{
+   object_ptr object = (object_ptr)malloc(sizeof(object_s));
+   assert_non_null(object);
+   object->id = id;
+   snprintf(object->text, sizeof(object->text), "object %llu", (unsigned long long)id);
+   return object;
+}
+
+static void test_object_cache_ownership(void **state)
+{
+   // the cache frees every object it drops (checked under ASan)
+   size_t freed = 0;
+   cache(uint64_t, object_ptr) c;
+   cache_init(uint64_t, object_ptr, &c, 32, free_object, &freed);
+
+   uint32_t seed = 9;
+   size_t decoded = 0;
+   for (uint32_t i = 0; i < 5000; i++)
+   {
+      const uint64_t id = ((uint64_t)1 << 40) + next_random(&seed) % 64;
+      object_ptr *found = cache_get(uint64_t, object_ptr, &c, id);
+      if (found)
+      {
+         assert_int_equal((*found)->id, id);
+         continue;
+      }
+      assert_true(cache_put(uint64_t, object_ptr, &c, id, decode(id)));
+      decoded++;
+   }
+   assert_int_equal(cache_len(uint64_t, object_ptr, &c), 32);
+   assert_int_equal(freed, cache_evictions(uint64_t, object_ptr, &c));
+   assert_int_equal(cache_hits(uint64_t, object_ptr, &c) + cache_misses(uint64_t, object_ptr, &c), 5000);
+
+   cache_delete(uint64_t, object_ptr, &c);
+   assert_int_equal(freed, decoded);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_int_cache_init_delete),
+      cmocka_unit_test_setup_teardown(test_int_cache_clock, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_cache_pin, setup, teardown),
+      cmocka_unit_test(test_int_cache_random),
+      cmocka_unit_test(test_int_cache_churn),
+      cmocka_unit_test(test_object_cache_ownership),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,9 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "delta-queue.fixture.h"
+
+
+/* Delta queues of 64 and 32-bit values */
+
+GENERATE_DELTA_QUEUE(uint64_t, uint32_t, 128, 2, malloc, free)
+GENERATE_DELTA_QUEUE(uint32_t, uint32_t, 128, 2, malloc, free)
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef __DELTA_QUEUE_FIXTURE_H
+#define __DELTA_QUEUE_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Event IDs, 128-byte inline ring */
+DEFINE_DELTA_QUEUE(uint64_t, uint32_t, 128)
+
+/* 32-bit counters, deltas wrap modulo 2^32 */
+DEFINE_DELTA_QUEUE(uint32_t, uint32_t, 128)
+
+#endif /* __DELTA_QUEUE_FIXTURE_H */
@@ -0,0 +1,312 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "delta-queue.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   delta_queue(uint64_t) ids;
+   delta_queue(uint32_t) counters;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   delta_queue_init(uint64_t, &tmp->ids);
+   delta_queue_init(uint32_t, &tmp->counters);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   delta_queue_delete(uint64_t, &tmp->ids);
+   delta_queue_delete(uint32_t, &tmp->counters);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint64_t next_random(uint64_t *seed)
+{
+   *seed ^= *seed << 13;
+   *seed ^= *seed >> 7;
+   *seed ^= *seed << 17;
+   return *seed;
+}
+
+/* every combination of delta widths round-trips, scalar or SIMD */
+static void test_delta_queue_codec(void **state)
+{
+   (void)state;
+   static const uint64_t widths[4] = { 0xA5ull, 0xBEEFull, 0xDEADBEEFull, 0x0123456789ABCDEFull };
+   uint8_t bytes[DELTA_QUEUE_GROUP_MAX * 2];
+
+   for (unsigned tag = 0; tag < 256; tag++)
+   {
+      uint64_t deltas[DELTA_QUEUE_GROUP], out[DELTA_QUEUE_GROUP];
+      size_t expect = 1;
+      for (unsigned k = 0; k < DELTA_QUEUE_GROUP; k++)
+      {
+         const unsigned code = (tag >> (2 * k)) & 3;
+         deltas[k] = widths[code] - k;
+         expect += (size_t)1 << code;
+      }
+
+      memset(bytes, 0xFF, sizeof(bytes));  /* garbage past the group must be masked */
+      assert_int_equal(delta_queue_encode_group(bytes, deltas), expect);
+      assert_int_equal(bytes[0], tag);
+      assert_int_equal(delta_queue_decode_group(bytes, 1000, out), expect);
+
+      uint64_t value = 1000;
+      for (unsigned k = 0; k < DELTA_QUEUE_GROUP; k++)
+      {
+         value += deltas[k];
+         assert_true(out[k] == value);
+      }
+   }
+}
+
+static void test_delta_queue_init_delete(void **state)
+{
+   (void)state;
+   delta_queue(uint64_t) q;
+   delta_queue_init(uint64_t, &q);
+   assert_int_equal(delta_queue_len(uint64_t, &q), 0);
+   assert_true(delta_queue_empty(uint64_t, &q));
+   assert_int_equal(delta_queue_bytes(uint64_t, &q), 128);
+   assert_false(delta_queue_deque(uint64_t, &q));
+
+   uint64_t out[4];
+   assert_int_equal(delta_queue_deque_n(uint64_t, &q, out, 4), 0);
+   delta_queue_delete(uint64_t, &q);
+   assert_ptr_equal(q.bytes, q.inline_buffer);
+}
+
+/* increasing IDs with small gaps take a group of 5 bytes per 4 values */
+static void test_delta_queue_monotonic(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   delta_queue(uint64_t) *q = &s->ids;
+   enum { N = 100000 };
+   uint64_t seed = 7, id = 1ull << 40;
+
+   for (uint32_t i = 0; i < N; i++)
+   {
+      id += 1 + next_random(&seed) % 200;
+      assert_true(delta_queue_enque(uint64_t, q, id));
+   }
+   assert_int_equal(delta_queue_len(uint64_t, q), N);
+   assert_true(delta_queue_used(uint64_t, q) <= (N / 4) * 5 + 8);   /* + the first group's 5-byte delta */
+   assert_true(delta_queue_bytes(uint64_t, q) <= 256 * 1024);        /* vs 800 KB uncompressed */
+
+   uint64_t out[300];
+   seed = 7;
+   id = 1ull << 40;
+   uint32_t seen = 0;
+   uint64_t batch_seed = 3;
+   while (!delta_queue_empty(uint64_t, q))
+   {
+      const uint32_t want = (uint32_t)(next_random(&batch_seed) % ARRAY_LEN(out)) + 1;
+      const uint32_t got = delta_queue_deque_n(uint64_t, q, out, want);
+      assert_int_equal(got, want < N - seen ? want : N - seen);
+      for (uint32_t k = 0; k < got; k++)
+      {
+         id += 1 + next_random(&seed) % 200;
+         assert_true(out[k] == id);
+      }
+      seen += got;
+   }
+   assert_int_equal(seen, N);
+}
+
+/* any sequence round-trips: decreasing steps and full-width values included */
+static void test_delta_queue_random(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   delta_queue(uint64_t) *q = &s->ids;
+   enum { CAP = 1 << 16 };
+   uint64_t *ref = (uint64_t*)malloc(CAP * sizeof(uint64_t));
+   assert_non_null(ref);
+   uint32_t head = 0, tail = 0;
+   uint64_t seed = 11, value = 0;
+   uint64_t out[64];
+
+   for (uint32_t step = 0; step < 200000; step++)
+   {
+      const uint32_t r = (uint32_t)(next_random(&seed) % 16);
+      if (r < 9 && tail - head < CAP)
+      {
+         switch (next_random(&seed) % 8)
+         {
+            case 0: value = next_random(&seed); break;                  /* anywhere */
+            case 1: value -= next_random(&seed) % 1000; break;          /* backwards */
+            case 2: value += next_random(&seed) % 100000; break;        /* 3-byte gap */
+            default: value += next_random(&seed) % 100; break;          /* 1-byte gap */
+         }
+         assert_true(delta_queue_enque(uint64_t, q, value));
+         ref[tail++ % CAP] = value;
+      }
+      else if (r < 12)
+      {
+         if (head != tail)
+            assert_true(delta_queue_peek(uint64_t, q) == ref[head % CAP]);
+         assert_int_equal(delta_queue_deque(uint64_t, q), head != tail);
+         if (head != tail)
+            head++;
+      }
+      else
+      {
+         const uint32_t n = (uint32_t)(next_random(&seed) % ARRAY_LEN(out));
+         const uint32_t got = delta_queue_deque_n(uint64_t, q, out, n);
+         assert_int_equal(got, n < tail - head ? n : tail - head);
+         for (uint32_t k = 0; k < got; k++)
+            assert_true(out[k] == ref[head++ % CAP]);
+      }
+      assert_int_equal(delta_queue_len(uint64_t, q), tail - head);
+      assert_true(delta_queue_used(uint64_t, q) <= delta_queue_bytes(uint64_t, q));
+
+      /* now and then drain far enough to wrap the ring, then refill past its size */
+      if (step % 20011 == 0)
+      {
+         while (tail - head > 10)
+         {
+            const uint32_t got = delta_queue_deque_n(uint64_t, q, out, ARRAY_LEN(out));
+            for (uint32_t k = 0; k < got && tail - head > 0; k++)
+               assert_true(out[k] == ref[head++ % CAP]);
+         }
+      }
+   }
+
+   while (head != tail)
+   {
+      assert_true(delta_queue_peek(uint64_t, q) == ref[head % CAP]);
+      const uint32_t got = delta_queue_deque_n(uint64_t, q, out, ARRAY_LEN(out));
+      for (uint32_t k = 0; k < got; k++)
+         assert_true(out[k] == ref[head++ % CAP]);
+   }
+   assert_true(delta_queue_empty(uint64_t, q));
+   free(ref);
+}
+
+/* small ring: interleaved enque / deque wraps many times, resizes while wrapped */
+static void test_delta_queue_wrap(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   delta_queue(uint64_t) *q = &s->ids;
+   enum { CAP = 4096 };
+   uint64_t ref[CAP];
+   uint32_t head = 0, tail = 0;
+   uint64_t value = 0, seed = 5;
+   uint64_t out[16];
+
+   for (uint32_t round = 0; round < 3000; round++)
+   {
+      /* slightly more in than out after round 1000, so the ring grows while wrapped */
+      const uint32_t in = (uint32_t)(next_random(&seed) % 16) + (round > 1000 ? 1 : 0);
+      for (uint32_t k = 0; k < in && tail - head < CAP; k++)
+      {
+         value += (round % 3 == 0) ? 70000 : 1;   /* mix of 1 and 3-byte deltas */
+         assert_true(delta_queue_enque(uint64_t, q, value));
+         ref[tail++ % CAP] = value;
+      }
+      const uint32_t got = delta_queue_deque_n(uint64_t, q, out, (uint32_t)(next_random(&seed) % 16));
+      for (uint32_t k = 0; k < got; k++)
+         assert_true(out[k] == ref[head++ % CAP]);
+      assert_int_equal(delta_queue_len(uint64_t, q), tail - head);
+   }
+   assert_true(delta_queue_bytes(uint64_t, q) > 128);
+
+   delta_queue_clear(uint64_t, q);
+   assert_true(delta_queue_empty(uint64_t, q));
+   assert_int_equal(delta_queue_used(uint64_t, q), 0);
+   assert_true(delta_queue_bytes(uint64_t, q) > 128);   /* clear keeps the grown ring */
+
+   /* usable after clear, deltas restart from 0 */
+   assert_true(delta_queue_enque(uint64_t, q, 5));
+   assert_true(delta_queue_peek(uint64_t, q) == 5);
+}
+
+/* a group ending exactly at the end of the ring: the next one starts at 0 */
+static void test_delta_queue_exact_end(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   delta_queue(uint64_t) *q = &s->ids;
+   const uint64_t big = 1ull << 40;
+   uint64_t value = 0, out[8];
+
+   /* 1 + 8 + 8 + 8 + 4 = 29 bytes, then 3 groups of 33: 128 bytes, ring full */
+   for (uint32_t k = 0; k < 3; k++)
+      assert_true(delta_queue_enque(uint64_t, q, value += big));
+   assert_true(delta_queue_enque(uint64_t, q, value += 1u << 20));
+   for (uint32_t k = 0; k < 12; k++)
+      assert_true(delta_queue_enque(uint64_t, q, value += big));
+   assert_int_equal(delta_queue_used(uint64_t, q), 128);
+   assert_int_equal(delta_queue_bytes(uint64_t, q), 128);
+
+   /* free the first 62 bytes, then a 33-byte group wraps with nothing skipped */
+   assert_int_equal(delta_queue_deque_n(uint64_t, q, out, 8), 8);
+   for (uint32_t k = 0; k < 4; k++)
+      assert_true(delta_queue_enque(uint64_t, q, value += big));
+   assert_int_equal(delta_queue_bytes(uint64_t, q), 128);
+   assert_int_equal(delta_queue_used(uint64_t, q), 128 - 62 + 33);
+
+   uint64_t expect = out[7];
+   while (!delta_queue_empty(uint64_t, q))
+   {
+      const uint32_t got = delta_queue_deque_n(uint64_t, q, out, 3);
+      for (uint32_t k = 0; k < got; k++)
+      {
+         assert_true(out[k] > expect);
+         expect = out[k];
+      }
+   }
+   assert_true(expect == value);
+}
+
+static void test_delta_queue_uint32(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   delta_queue(uint32_t) *q = &s->counters;
+   uint32_t value = 0xFFFFFF00u;   /* wraps through 0 */
+
+   for (uint32_t i = 0; i < 1000; i++)
+      assert_true(delta_queue_enque(uint32_t, q, value + i * 3));
+   assert_true(delta_queue_used(uint32_t, q) <= 250 * 5 + 4);
+
+   uint32_t out[7];
+   uint32_t i = 0;
+   while (!delta_queue_empty(uint32_t, q))
+   {
+      assert_int_equal(delta_queue_peek(uint32_t, q), (uint32_t)(value + i * 3));
+      const uint32_t got = delta_queue_deque_n(uint32_t, q, out, ARRAY_LEN(out));
+      for (uint32_t k = 0; k < got; k++, i++)
+         assert_int_equal(out[k], (uint32_t)(value + i * 3));
+   }
+   assert_int_equal(i, 1000);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_delta_queue_codec),
+      cmocka_unit_test(test_delta_queue_init_delete),
+      cmocka_unit_test_setup_teardown(test_delta_queue_monotonic, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_delta_queue_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_delta_queue_wrap, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_delta_queue_exact_end, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_delta_queue_uint32, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
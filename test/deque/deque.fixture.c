@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <stddef.h>
 #include "deque.fixture.h"
 
 
@@ -9,7 +10,29 @@ bool mock_valid(double x)
    return true;
 }
 
+bool double_equal(double a, double b)
+{
+   return a == b;
+}
+
 GENERATE_DEQUE(double, size_t, DOUBLE_DEQUE_INIT_SIZE, DOUBLE_DEQUE_GROWTH_FACTOR, mock_valid, malloc, realloc, free)
+GENERATE_DEQUE_SEARCH(double, size_t, double_equal)
+GENERATE_DEQUE_REDUCE(double, size_t, double)
+
+
+/* Id deque */
+
+bool id_valid(uint64_t x)
+{
+   return true;
+}
+
+GENERATE_DEQUE(uint64_t, size_t, ID_DEQUE_INIT_SIZE, ID_DEQUE_GROWTH_FACTOR, id_valid, malloc, realloc, free)
+GENERATE_DEQUE_SEARCH(uint64_t, size_t, uint64_t_bytes_equal)
+GENERATE_DEQUE_SORT(uint64_t, size_t, uint64_t, 0, malloc, free)
+GENERATE_DEQUE_REMOVE_IF(uint64_t, size_t, uint64_t_bytes_equal)
+GENERATE_DEQUE_HASH(uint64_t, size_t)
+GENERATE_DEQUE_PARALLEL(uint64_t, size_t, uint64_t)
 
 
 /* Date deque */
@@ -19,4 +42,7 @@ bool date_valid(date_s x)
    return (x.year < 2100) && (x.month > 0) && (x.month <= 12) && (x.day > 0) && (x.day <= 31);
 }
 
-GENERATE_DEQUE(date_s, size_t, DATE_DEQUE_INIT_SIZE, DATE_DEQUE_GROWTH_FACTOR, date_valid, malloc, realloc, free)
\ No newline at end of file
+GENERATE_DEQUE(date_s, size_t, DATE_DEQUE_INIT_SIZE, DATE_DEQUE_GROWTH_FACTOR, date_valid, malloc, realloc, free)
+GENERATE_DEQUE_SEARCH(date_s, size_t, date_s_bytes_equal)
+GENERATE_DEQUE_SORT(date_s, size_t, uint16_t, offsetof(date_s, year), malloc, free)
+GENERATE_DEQUE_PARALLEL_SORT(date_s, size_t, malloc, free)
\ No newline at end of file
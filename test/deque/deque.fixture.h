@@ -9,6 +9,19 @@
 #define DOUBLE_DEQUE_INIT_SIZE 4
 #define DOUBLE_DEQUE_GROWTH_FACTOR 2
 DEFINE_DEQUE(double, size_t, DOUBLE_DEQUE_INIT_SIZE)
+DEFINE_DEQUE_SEARCH(double, size_t)
+DEFINE_DEQUE_REDUCE(double, size_t, double)
+
+/* Id deque */
+#define ID_DEQUE_INIT_SIZE 8
+#define ID_DEQUE_GROWTH_FACTOR 2
+DEFINE_DEQUE(uint64_t, size_t, ID_DEQUE_INIT_SIZE)
+DEFINE_DEQUE_SEARCH(uint64_t, size_t)
+DEFINE_DEQUE_SORT(uint64_t, size_t)
+DEFINE_DEQUE_REMOVE_IF(uint64_t, size_t)
+DEFINE_DEQUE_HASH(uint64_t, size_t)
+DEFINE_DEQUE_PARALLEL(uint64_t, size_t, uint64_t)
+DEFINE_BYTES_EQUAL(uint64_t)
 
 /* Date deque */
 typedef struct
@@ -20,5 +33,9 @@ typedef struct
 #define DATE_DEQUE_INIT_SIZE 4
 #define DATE_DEQUE_GROWTH_FACTOR 2
 DEFINE_DEQUE(date_s, size_t, DATE_DEQUE_INIT_SIZE)
+DEFINE_DEQUE_SEARCH(date_s, size_t)
+DEFINE_DEQUE_SORT(date_s, size_t)
+DEFINE_DEQUE_PARALLEL_SORT(date_s, size_t)
+DEFINE_BYTES_EQUAL(date_s)
 
 #endif /* __DEQUE_FIXTURE_H */
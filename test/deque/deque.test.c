@@ -3,6 +3,8 @@
 #include <stdarg.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include <cmocka.h>
 #include "deque.fixture.h"
 
@@ -212,6 +214,302 @@ static void test_double_deque_clear(void **state)
    assert_true(result);
 }
 
+static void test_double_deque_find_count_contains(void **state)
+{
+   deque(double) *deque = &((test_state_s*)(*state))->double_deque;
+
+   for (size_t i = 0; i < 8; i++)
+      deque_insert_front(double, deque, mock_doubles[i]);
+   for (size_t i = 8; i < 16; i++)
+      deque_insert_back(double, deque, mock_doubles[i]);
+
+   // logical order: mock_doubles[7..0], mock_doubles[8..15]
+   assert_int_equal(deque_find(double, deque, mock_doubles[7]), 0);
+   assert_int_equal(deque_find(double, deque, mock_doubles[0]), 7);
+   assert_int_equal(deque_find(double, deque, mock_doubles[15]), 15);
+   assert_int_equal(deque_find(double, deque, -1.0), deque->len);
+   assert_int_equal(deque_count(double, deque, mock_doubles[9]), 1);
+   assert_true(deque_contains(double, deque, mock_doubles[12]));
+   assert_false(deque_contains(double, deque, mock_doubles[20]));
+}
+
+static void test_double_deque_reduce(void **state)
+{
+   deque(double) *deque = &((test_state_s*)(*state))->double_deque;
+
+   // logical order: mock_doubles[13..0], mock_doubles[14..27]
+   double expected = 0.0;
+   for (size_t i = 0; i < 14; i++)
+      deque_insert_front(double, deque, mock_doubles[i]);
+   for (size_t i = 14; i < ARRAY_LEN(mock_doubles); i++)
+      deque_insert_back(double, deque, mock_doubles[i]);
+   for (size_t i = 0; i < ARRAY_LEN(mock_doubles); i++)
+      expected += mock_doubles[i];
+
+   assert_double_equal(deque_sum(double, deque), expected, 1e-9);
+   assert_double_equal(deque_min(double, deque), mock_doubles[0], DOUBLE_EPS);
+   assert_double_equal(deque_max(double, deque), mock_doubles[27], DOUBLE_EPS);
+   assert_int_equal(deque_argmin(double, deque), 13);
+   assert_int_equal(deque_argmax(double, deque), 27);
+
+   deque_insert_front(double, deque, -1.0);
+   assert_double_equal(deque_min(double, deque), -1.0, DOUBLE_EPS);
+   assert_int_equal(deque_argmin(double, deque), 0);
+
+   deque_insert_back(double, deque, NAN);
+   assert_true(isnan(deque_min(double, deque)));
+   assert_true(isnan(deque_max(double, deque)));
+   assert_int_equal(deque_argmax(double, deque), deque->len - 1);
+}
+
+static void test_id_deque_find_count_contains(void **state)
+{
+   deque(uint64_t) deque;
+   deque_init(uint64_t, &deque);
+
+   // 100 ids at the back, then 100 at the front, so both ring segments run the vector loop
+   for (uint64_t i = 0; i < 100; i++)
+      deque_insert_back(uint64_t, &deque, 2000 + (i % 10));
+   for (uint64_t i = 0; i < 100; i++)
+      deque_insert_front(uint64_t, &deque, 1000 + i);
+   assert_true(deque.front + deque.len > deque.size);
+
+   // logical order: 1099..1000, (2000..2009) x 10
+   assert_int_equal(deque_find(uint64_t, &deque, 1099), 0);
+   assert_int_equal(deque_find(uint64_t, &deque, 1000), 99);
+   assert_int_equal(deque_find(uint64_t, &deque, 2003), 103);
+   assert_int_equal(deque_find(uint64_t, &deque, 3000), deque.len);
+   // only the upper 32 bits differ
+   assert_int_equal(deque_find(uint64_t, &deque, 2003 + (UINT64_C(1) << 32)), deque.len);
+
+   assert_int_equal(deque_count(uint64_t, &deque, 2007), 10);
+   assert_int_equal(deque_count(uint64_t, &deque, 1050), 1);
+   assert_int_equal(deque_count(uint64_t, &deque, 5), 0);
+
+   assert_true(deque_contains(uint64_t, &deque, 1042));
+   assert_false(deque_contains(uint64_t, &deque, 1100));
+
+   deque_delete(uint64_t, &deque);
+}
+
+static int compare_id(const uint64_t *a, const uint64_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+static void test_id_deque_sort(void **state)
+{
+   deque(uint64_t) deque;
+   deque_init(uint64_t, &deque);
+
+   uint64_t seed = 42;
+   for (size_t i = 0; i < 500; i++)
+   {
+      seed = seed * 6364136223846793005u + 1442695040888963407u;
+      deque_insert_back(uint64_t, &deque, seed >> (i % 40));
+      deque_insert_front(uint64_t, &deque, seed >> 3);
+   }
+   assert_true(deque.front + deque.len > deque.size);
+
+   assert_true(deque_radix_sort(uint64_t, &deque));
+   assert_int_equal(deque.front, 0);
+   for (size_t i = 1; i < deque.len; i++)
+      assert_true(deque.values[i - 1] <= deque.values[i]);
+
+   deque_remove_front(uint64_t, &deque);
+   deque_insert_back(uint64_t, &deque, 0);
+   assert_true(deque_sort(uint64_t, &deque, compare_id));
+   assert_int_equal(deque_peek_front(uint64_t, &deque), 0);
+   for (size_t i = 1; i < deque.len; i++)
+      assert_true(deque.values[(deque.front + i - 1) & (deque.size - 1)] <= deque.values[(deque.front + i) & (deque.size - 1)]);
+
+   deque_delete(uint64_t, &deque);
+}
+static void test_id_deque_remove_if(void **state)
+{
+   deque(uint64_t) deque;
+   deque_init(uint64_t, &deque);
+
+   // both ring segments hold more than one vector
+   for (uint64_t i = 0; i < 100; i++)
+      deque_insert_back(uint64_t, &deque, i % 4);
+   for (uint64_t i = 0; i < 100; i++)
+      deque_insert_front(uint64_t, &deque, 100 + (i % 4));
+   assert_true(deque.front + deque.len > deque.size);
+
+   assert_int_equal(deque_remove_value(uint64_t, &deque, 101), 25);
+   assert_int_equal(deque_remove_value(uint64_t, &deque, 2), 25);
+   // only the upper 32 bits differ
+   assert_int_equal(deque_remove_value(uint64_t, &deque, 3 + (UINT64_C(1) << 32)), 0);
+   assert_int_equal(deque.len, 150);
+
+   // logical order: (103, 102, 100) x 25, (0, 1, 3) x 25
+   const uint64_t front[] = { 103, 102, 100 };
+   const uint64_t back[] = { 0, 1, 3 };
+   for (size_t i = 0; i < 75; i++)
+   {
+      assert_int_equal(deque_peek_front(uint64_t, &deque), front[i % 3]);
+      deque_remove_front(uint64_t, &deque);
+   }
+   for (size_t i = 0; i < 75; i++)
+   {
+      assert_int_equal(deque_peek_front(uint64_t, &deque), back[i % 3]);
+      deque_remove_front(uint64_t, &deque);
+   }
+
+   deque_delete(uint64_t, &deque);
+}
+
+static void test_id_deque_hash_equal(void **state)
+{
+   deque(uint64_t) a, b;
+   deque_init(uint64_t, &a);
+   deque_init(uint64_t, &b);
+
+   // logical order 0..99 in both, with different wrap points
+   for (uint64_t i = 0; i < 60; i++)
+      deque_insert_back(uint64_t, &a, 40 + i);
+   for (uint64_t i = 0; i < 40; i++)
+      deque_insert_front(uint64_t, &a, 39 - i);
+   for (uint64_t i = 0; i < 100; i++)
+      deque_insert_back(uint64_t, &b, i);
+   for (size_t i = 0; i < 100; i++) // full rotation moves the front
+   {
+      const uint64_t id = deque_peek_front(uint64_t, &b);
+      deque_remove_front(uint64_t, &b);
+      deque_insert_back(uint64_t, &b, id);
+   }
+   assert_true(a.front + a.len > a.size);
+   assert_true(b.front + b.len > b.size);
+   assert_true(a.front != b.front);
+
+   assert_true(deque_equal(uint64_t, &a, &b));
+   assert_int_equal(deque_hash(uint64_t, &a, 1), deque_hash(uint64_t, &b, 1));
+
+   deque_remove_back(uint64_t, &b);
+   assert_false(deque_equal(uint64_t, &a, &b));
+   deque_insert_back(uint64_t, &b, 99 + (UINT64_C(1) << 40));
+   assert_false(deque_equal(uint64_t, &a, &b));
+   assert_true(deque_hash(uint64_t, &a, 1) != deque_hash(uint64_t, &b, 1));
+
+   deque_delete(uint64_t, &a);
+   deque_delete(uint64_t, &b);
+}
+
+static void test_id_deque_resize_large(void **state)
+{
+   deque(uint64_t) deque;
+   deque_init(uint64_t, &deque);
+
+   // wrapped ring of 8 MiB, so resize goes through MEMORY_COPY_LARGE
+   const uint64_t count = UINT64_C(1) << 20;
+   for (uint64_t i = 0; i < count / 2; i++)
+      deque_insert_back(uint64_t, &deque, i);
+   for (uint64_t i = 0; i < count / 2; i++)
+      deque_insert_front(uint64_t, &deque, count + i);
+   assert_true(deque.front + deque.len > deque.size);
+   assert_int_equal(deque.len, deque.size);
+
+   assert_true(deque_resize(uint64_t, &deque));
+   assert_int_equal(deque.front, 0);
+   for (uint64_t i = 0; i < count / 2; i++)
+   {
+      assert_true(deque.values[i] == count + count / 2 - 1 - i);
+      assert_true(deque.values[count / 2 + i] == i);
+   }
+
+   deque_delete(uint64_t, &deque);
+}
+
+static void test_id_deque_reverse_rotate(void **state)
+{
+   deque(uint64_t) ring;
+   deque(uint64_t) *deque = &ring;
+   deque_init(uint64_t, deque);
+
+   for (size_t len = 0; len < 40; len++)
+   {
+      for (size_t k = 0; k <= len + 1; k++)
+      {
+         // logical order 0..len-1, wrapped for most lengths
+         deque_clear(uint64_t, deque);
+         for (uint64_t i = 0; i < 32; i++)
+            deque_insert_back(uint64_t, deque, i);
+         for (uint64_t i = 0; i < 32; i++)
+            deque_remove_front(uint64_t, deque);
+         for (uint64_t i = len / 2; i > 0; i--)
+            deque_insert_front(uint64_t, deque, i - 1);
+         for (uint64_t i = len / 2; i < len; i++)
+            deque_insert_back(uint64_t, deque, i);
+
+         deque_rotate(uint64_t, deque, k);
+         for (size_t i = 0; i < len; i++)
+            assert_int_equal(deque->values[(deque->front + i) & (deque->size - 1)], (i + k) % len);
+
+         deque_reverse(uint64_t, deque);
+         for (size_t i = 0; i < len; i++)
+            assert_int_equal(deque->values[(deque->front + i) & (deque->size - 1)], (len - 1 - i + k) % len);
+      }
+   }
+
+   deque_delete(uint64_t, deque);
+}
+
+static void id_tag(uint64_t *id, void *ctx)
+{
+   *id |= *(const uint64_t*)ctx;
+}
+
+static uint64_t id_square(uint64_t id, void *ctx)
+{
+   (void)ctx;
+   return id * id;
+}
+
+static uint64_t id_xor(uint64_t acc, const uint64_t *id, void *ctx)
+{
+   (void)ctx;
+   return acc ^ *id;
+}
+
+static uint64_t id_xor_combine(uint64_t a, uint64_t b)
+{
+   return a ^ b;
+}
+
+static void test_id_deque_parallel(void **state)
+{
+   deque(uint64_t) ring;
+   deque(uint64_t) *deque = &ring;
+   deque_init(uint64_t, deque);
+   parallel_pool_s pool;
+   assert_true(parallel_pool_init(&pool, 0));
+
+   // logical order 0..n-1 across the wrap point
+   const uint64_t n = 50000;
+   for (uint64_t i = 0; i < n / 2; i++)
+      deque_insert_back(uint64_t, deque, n / 2 + i);
+   for (uint64_t i = 0; i < n / 2; i++)
+      deque_insert_front(uint64_t, deque, n / 2 - 1 - i);
+   assert_true(deque->front + deque->len > deque->size);
+
+   uint64_t expected = 0;
+   for (uint64_t i = 0; i < n; i++)
+      expected ^= i * i;
+   deque_parallel_transform(uint64_t, deque, &pool, id_square, NULL);
+   assert_int_equal(deque_parallel_reduce(uint64_t, deque, &pool, 0, id_xor, id_xor_combine, NULL), expected);
+   assert_int_equal(deque_parallel_reduce(uint64_t, deque, NULL, 0, id_xor, id_xor_combine, NULL), expected);
+
+   const uint64_t tag = UINT64_C(1) << 63;
+   deque_parallel_for_each(uint64_t, deque, &pool, id_tag, (void*)&tag);
+   for (uint64_t i = 0; i < n; i++)
+      assert_int_equal(deque->values[(deque->front + i) & (deque->size - 1)], (i * i) | tag);
+
+   parallel_pool_delete(&pool);
+   deque_delete(uint64_t, deque);
+}
+
+
 
 /* Date deque */
 
@@ -410,6 +708,103 @@ static void test_date_deque_clear(void **state)
    assert_true(result);
 }
 
+static void test_date_deque_find_count_contains(void **state)
+{
+   deque(date_s) *deque = &((test_state_s*)(*state))->date_deque;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_dates); i++)
+      deque_insert_front(date_s, deque, mock_dates[i]);
+   deque_insert_back(date_s, deque, mock_dates[27]);
+
+   assert_int_equal(deque_find(date_s, deque, mock_dates[27]), 0);
+   assert_int_equal(deque_find(date_s, deque, mock_dates[0]), 27);
+   assert_int_equal(deque_count(date_s, deque, mock_dates[27]), 2);
+
+   const date_s missing = { 2000, 1, 1 };
+   assert_int_equal(deque_find(date_s, deque, missing), deque->len);
+   assert_false(deque_contains(date_s, deque, missing));
+}
+
+static int compare_date_year(const date_s *a, const date_s *b)
+{
+   return (a->year > b->year) - (a->year < b->year);
+}
+
+static int compare_date_month(const date_s *a, const date_s *b)
+{
+   return (a->month > b->month) - (a->month < b->month);
+}
+
+static void test_date_deque_sort(void **state)
+{
+   deque(date_s) *deque = &((test_state_s*)(*state))->date_deque;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_dates); i++)
+      deque_insert_front(date_s, deque, mock_dates[i]);
+
+   // radix key is the year field
+   assert_true(deque_radix_sort(date_s, deque));
+   for (size_t i = 0; i < deque->len; i++)
+      assert_memory_equal(&deque->values[(deque->front + i) & (deque->size - 1)], &mock_dates[i], sizeof(date_s));
+
+   // stable: same month keeps year order
+   assert_true(deque_sort(date_s, deque, compare_date_month));
+   for (size_t i = 1; i < deque->len; i++)
+   {
+      const date_s *a = &deque->values[(deque->front + i - 1) & (deque->size - 1)];
+      const date_s *b = &deque->values[(deque->front + i) & (deque->size - 1)];
+      assert_true(a->month < b->month || (a->month == b->month && a->year < b->year));
+   }
+}
+
+static void test_date_deque_parallel_sort(void **state)
+{
+   deque(date_s) ring;
+   deque(date_s) *deque = &ring;
+   deque_init(date_s, deque);
+   parallel_pool_s pool;
+   assert_true(parallel_pool_init(&pool, 4));
+
+   // wrapped ring; year and day encode the insertion index (year * 31 + day - 1), only 12 distinct months
+   const date_s filler = { .year = 2000, .month = 1, .day = 1 };
+   for (size_t i = 0; i < 40000; i++)
+      deque_insert_back(date_s, deque, filler);
+   for (size_t i = 0; i < 40000; i++)
+      deque_remove_front(date_s, deque);
+   uint32_t seed = 2024;
+   for (size_t i = 0; i < 60000; i++)
+   {
+      seed = seed * 1103515245u + 12345u;
+      const date_s date = { .year = (uint16_t)(i / 31), .month = (uint8_t)((seed >> 16) % 12 + 1), .day = (uint8_t)(i % 31 + 1) };
+      deque_insert_back(date_s, deque, date);
+   }
+   assert_true(deque->front + deque->len > deque->size);
+   const size_t n = deque->len;
+
+   // stable: same month keeps insertion order
+   assert_true(deque_parallel_sort(date_s, deque, &pool, compare_date_month));
+   assert_int_equal(deque->front, 0);
+   assert_int_equal(deque->len, n);
+   for (size_t i = 1; i < n; i++)
+   {
+      const date_s *a = &deque->values[i - 1];
+      const date_s *b = &deque->values[i];
+      assert_true(a->month < b->month || (a->month == b->month && a->year * 31 + a->day < b->year * 31 + b->day));
+   }
+
+   // by year; same year keeps month order
+   assert_true(deque_parallel_sort(date_s, deque, &pool, compare_date_year));
+   for (size_t i = 1; i < n; i++)
+   {
+      const date_s *a = &deque->values[i - 1];
+      const date_s *b = &deque->values[i];
+      assert_true(a->year < b->year || (a->year == b->year && a->month <= b->month));
+   }
+
+   parallel_pool_delete(&pool);
+   deque_delete(date_s, deque);
+}
+
 int main(void)
 {  
    const struct CMUnitTest tests[] = 
@@ -422,6 +817,15 @@ int main(void)
       cmocka_unit_test_setup_teardown(test_double_deque_empty, setup, teardown),
       cmocka_unit_test_setup_teardown(test_double_deque_full, setup, teardown),
       cmocka_unit_test_setup_teardown(test_double_deque_clear, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_double_deque_find_count_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_double_deque_reduce, setup, teardown),
+      cmocka_unit_test(test_id_deque_find_count_contains),
+      cmocka_unit_test(test_id_deque_sort),
+      cmocka_unit_test(test_id_deque_remove_if),
+      cmocka_unit_test(test_id_deque_hash_equal),
+      cmocka_unit_test(test_id_deque_parallel),
+      cmocka_unit_test(test_id_deque_resize_large),
+      cmocka_unit_test(test_id_deque_reverse_rotate),
       cmocka_unit_test(test_date_deque_init_delete),
       cmocka_unit_test(test_date_deque_resize),
       cmocka_unit_test_setup_teardown(test_date_deque_peek_front_back, setup, teardown),
@@ -430,6 +834,9 @@ int main(void)
       cmocka_unit_test_setup_teardown(test_date_deque_empty, setup, teardown),
       cmocka_unit_test_setup_teardown(test_date_deque_full, setup, teardown),
       cmocka_unit_test_setup_teardown(test_date_deque_clear, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_date_deque_find_count_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_date_deque_sort, setup, teardown),
+      cmocka_unit_test(test_date_deque_parallel_sort),
    };
    return cmocka_run_group_tests(tests, NULL, NULL);
 }
@@ -0,0 +1,17 @@
+#include <stddef.h>
+#include "enum-set.fixture.h"
+
+
+/* Constant table indexed by state_e */
+
+const enum_map(state_e, state_name) state_names =
+{
+   .values =
+   {
+      [STATE_IDLE] = "idle",
+      [STATE_RUNNING] = "running",
+      [STATE_BLOCKED] = "blocked",
+      [STATE_DONE] = "done",
+      [STATE_FAILED] = "failed",
+   }
+};
\ No newline at end of file
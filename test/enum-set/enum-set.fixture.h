@@ -0,0 +1,23 @@
+#ifndef __ENUM_SET_FIXTURE_H
+#define __ENUM_SET_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* 5 values -> one word */
+typedef PACKED_ENUM(state_e) { STATE_IDLE, STATE_RUNNING, STATE_BLOCKED, STATE_DONE, STATE_FAILED, STATE_COUNT } state_e;
+
+/* 130 values -> three words, the last one partial */
+typedef enum { WIDE_FIRST, WIDE_MIDDLE = 64, WIDE_LAST = 129, WIDE_COUNT } wide_e;
+
+typedef const char *state_name;
+
+DEFINE_ENUM_SET(state_e, STATE_COUNT)
+DEFINE_ENUM_SET(wide_e, WIDE_COUNT)
+DEFINE_ENUM_MAP(state_e, state_name, STATE_COUNT)
+DEFINE_ENUM_MAP(wide_e, uint32_t, WIDE_COUNT)
+
+extern const enum_map(state_e, state_name) state_names;
+
+#endif /* __ENUM_SET_FIXTURE_H */
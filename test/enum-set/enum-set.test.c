@@ -0,0 +1,237 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include "enum-set.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   enum_set(state_e) states;
+   enum_set(wide_e) a;
+   enum_set(wide_e) b;
+   enum_map(wide_e, uint32_t) counts;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   enum_set_init(state_e, &tmp->states);
+   enum_set_init(wide_e, &tmp->a);
+   enum_set_init(wide_e, &tmp->b);
+   enum_map_fill(wide_e, uint32_t, &tmp->counts, 0);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   free(*state);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+static void test_enum_set_sizes(void **state)
+{
+   (void)state;
+   assert_int_equal(sizeof(state_e), 1);
+   assert_int_equal(sizeof(enum_set(state_e)), 8);
+   assert_int_equal(sizeof(enum_set(wide_e)), 24);
+   assert_int_equal(sizeof(enum_map(state_e, state_name)), STATE_COUNT * sizeof(state_name));
+   assert_int_equal(state_e_enum_set_count, STATE_COUNT);
+   assert_int_equal(wide_e_enum_set_words, 3);
+}
+
+static void test_enum_set_add_has(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   enum_set(state_e) *set = &s->states;
+
+   assert_true(enum_set_empty(state_e, set));
+   enum_set_add(state_e, set, STATE_DONE);
+   enum_set_add(state_e, set, STATE_FAILED);
+   enum_set_add(state_e, set, STATE_DONE);
+   assert_true(enum_set_has(state_e, set, STATE_DONE));
+   assert_true(enum_set_has(state_e, set, STATE_FAILED));
+   assert_false(enum_set_has(state_e, set, STATE_IDLE));
+   assert_int_equal(enum_set_count(state_e, set), 2);
+
+   enum_set_remove(state_e, set, STATE_DONE);
+   enum_set_toggle(state_e, set, STATE_IDLE);
+   enum_set_assign(state_e, set, STATE_RUNNING, true);
+   enum_set_assign(state_e, set, STATE_FAILED, false);
+   assert_true(enum_set_has(state_e, set, STATE_IDLE));
+   assert_true(enum_set_has(state_e, set, STATE_RUNNING));
+   assert_false(enum_set_has(state_e, set, STATE_DONE));
+   assert_false(enum_set_has(state_e, set, STATE_FAILED));
+
+   const enum_set(state_e) same = enum_set_of(state_e, STATE_RUNNING, STATE_IDLE);
+   assert_true(enum_set_equal(state_e, set, &same));
+
+   enum_set_fill(state_e, set);
+   assert_int_equal(enum_set_count(state_e, set), STATE_COUNT);
+   assert_int_equal(set->words[0], 0x1F);     /* nothing past the sentinel */
+   enum_set_clear(state_e, set);
+   assert_true(enum_set_empty(state_e, set));
+}
+
+static void test_enum_set_algebra(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   const enum_set(state_e) terminal = enum_set_of(state_e, STATE_DONE, STATE_FAILED);
+   const enum_set(state_e) active = enum_set_of(state_e, STATE_RUNNING, STATE_BLOCKED);
+   const enum_set(state_e) done = enum_set_of(state_e, STATE_DONE);
+
+   assert_true(enum_set_subset(state_e, &done, &terminal));
+   assert_false(enum_set_subset(state_e, &terminal, &done));
+   assert_false(enum_set_intersects(state_e, &terminal, &active));
+   assert_true(enum_set_intersects(state_e, &terminal, &done));
+
+   enum_set(state_e) *x = &s->states;
+   enum_set_union(state_e, x, &terminal);
+   enum_set_union(state_e, x, &active);
+   assert_int_equal(enum_set_count(state_e, x), 4);
+   enum_set_difference(state_e, x, &done);
+   assert_int_equal(enum_set_count(state_e, x), 3);
+   assert_false(enum_set_has(state_e, x, STATE_DONE));
+   enum_set_intersect(state_e, x, &terminal);
+   assert_int_equal(enum_set_count(state_e, x), 1);
+   assert_true(enum_set_has(state_e, x, STATE_FAILED));
+}
+
+static void test_enum_set_iterate(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   const wide_e members[] = { WIDE_FIRST, 5, 63, WIDE_MIDDLE, 100, 127, 128, WIDE_LAST };
+   for (size_t i = 0; i < ARRAY_LEN(members); i++)
+      enum_set_add(wide_e, &s->a, members[i]);
+
+   size_t i = 0;
+   enum_set_foreach(wide_e, &s->a, w)
+   {
+      assert_true(i < ARRAY_LEN(members));
+      assert_int_equal(w, members[i++]);
+   }
+   assert_int_equal(i, ARRAY_LEN(members));
+
+   assert_int_equal(enum_set_next(wide_e, &s->a, 6), 63);
+   assert_int_equal(enum_set_next(wide_e, &s->a, 65), 100);
+   assert_int_equal(enum_set_next(wide_e, &s->a, 129), WIDE_LAST);
+   assert_int_equal(enum_set_next(wide_e, &s->a, 130), WIDE_COUNT);
+   assert_int_equal(enum_set_next(wide_e, &s->b, 0), WIDE_COUNT);
+
+   i = 0;
+   enum_set_foreach(wide_e, &s->b, w)
+      i++;
+   assert_int_equal(i, 0);
+
+   enum_set_fill(wide_e, &s->b);
+   assert_int_equal(enum_set_count(wide_e, &s->b), WIDE_COUNT);
+   assert_int_equal(s->b.words[2], 0x3);
+   assert_true(enum_set_subset(wide_e, &s->a, &s->b));
+}
+
+/* multi-word operations against a bool array */
+static void test_enum_set_random(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   bool ra[WIDE_COUNT] = { 0 }, rb[WIDE_COUNT] = { 0 };
+   uint32_t seed = 5;
+
+   for (uint32_t step = 0; step < 5000; step++)
+   {
+      const wide_e w = (wide_e)(next_random(&seed) % WIDE_COUNT);
+      switch (next_random(&seed) % 6)
+      {
+         case 0: enum_set_add(wide_e, &s->a, w); ra[w] = true; break;
+         case 1: enum_set_remove(wide_e, &s->a, w); ra[w] = false; break;
+         case 2: enum_set_toggle(wide_e, &s->b, w); rb[w] = !rb[w]; break;
+         case 3: enum_set_assign(wide_e, &s->b, w, step & 1); rb[w] = step & 1; break;
+         case 4:
+            if (step % 7 == 0)
+            {
+               enum_set_union(wide_e, &s->a, &s->b);
+               for (size_t k = 0; k < WIDE_COUNT; k++)
+                  ra[k] |= rb[k];
+            }
+            break;
+         case 5:
+            if (step % 11 == 0)
+            {
+               enum_set_difference(wide_e, &s->a, &s->b);
+               for (size_t k = 0; k < WIDE_COUNT; k++)
+                  ra[k] &= !rb[k];
+            }
+            break;
+      }
+
+      uint32_t na = 0;
+      bool common = false, sub = true;
+      for (size_t k = 0; k < WIDE_COUNT; k++)
+      {
+         assert_int_equal(enum_set_has(wide_e, &s->a, (wide_e)k), ra[k]);
+         na += ra[k];
+         common |= ra[k] && rb[k];
+         sub &= !ra[k] || rb[k];
+      }
+      assert_int_equal(enum_set_count(wide_e, &s->a), na);
+      assert_int_equal(enum_set_intersects(wide_e, &s->a, &s->b), common);
+      assert_int_equal(enum_set_subset(wide_e, &s->a, &s->b), sub);
+      assert_int_equal(enum_set_empty(wide_e, &s->a), na == 0);
+   }
+}
+
+static void test_enum_map(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+
+   assert_string_equal(enum_map_value(state_e, state_name, &state_names, STATE_BLOCKED), "blocked");
+   assert_string_equal(state_names.values[STATE_FAILED], "failed");
+
+   enum_map(wide_e, uint32_t) *counts = &s->counts;
+   enum_map_set(wide_e, uint32_t, counts, WIDE_MIDDLE, 7);
+   enum_map_at(wide_e, uint32_t, counts, WIDE_LAST) += 3;
+   (*enum_map_get(wide_e, uint32_t, counts, WIDE_LAST))++;
+   assert_int_equal(enum_map_value(wide_e, uint32_t, counts, WIDE_MIDDLE), 7);
+   assert_int_equal(enum_map_value(wide_e, uint32_t, counts, WIDE_LAST), 4);
+   assert_int_equal(enum_map_value(wide_e, uint32_t, counts, WIDE_FIRST), 0);
+
+   enum_map_fill(wide_e, uint32_t, counts, 9);
+   for (size_t k = 0; k < WIDE_COUNT; k++)
+      assert_int_equal(counts->values[k], 9);
+
+   /* a set of keys with a map of values */
+   const enum_set(state_e) shown = enum_set_of(state_e, STATE_RUNNING, STATE_DONE);
+   char line[64] = "";
+   enum_set_foreach(state_e, &shown, st)
+      strcat(strcat(line, enum_map_value(state_e, state_name, &state_names, st)), " ");
+   assert_string_equal(line, "running done ");
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_enum_set_sizes),
+      cmocka_unit_test_setup_teardown(test_enum_set_add_has, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_enum_set_algebra, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_enum_set_iterate, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_enum_set_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_enum_map, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,28 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "hashmap.fixture.h"
+
+
+/* Int -> double map */
+
+uint64_t int_hash(int key)
+{
+   return hash_bytes(&key, sizeof(key), 0);
+}
+
+bool int_equal(int a, int b)
+{
+   return a == b;
+}
+
+GENERATE_HASHMAP(int, double, size_t, int_hash, int_equal, malloc, free)
+
+
+/* Point -> int map */
+
+uint64_t point_hash(point_s key)
+{
+   return hash_bytes(&key, sizeof(key), 0);
+}
+
+GENERATE_HASHMAP(point_s, int, uint32_t, point_hash, point_s_bytes_equal, malloc, free)
\ No newline at end of file
@@ -0,0 +1,20 @@
+#ifndef __HASHMAP_FIXTURE_H
+#define __HASHMAP_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Int -> double map */
+DEFINE_HASHMAP(int, double, size_t)
+
+/* Point -> int map */
+typedef struct
+{
+   int32_t x;
+   int32_t y;
+} point_s;
+DEFINE_HASHMAP(point_s, int, uint32_t)
+DEFINE_BYTES_EQUAL(point_s)
+
+#endif /* __HASHMAP_FIXTURE_H */
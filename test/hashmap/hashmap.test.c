@@ -0,0 +1,219 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "hashmap.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+#define DOUBLE_EPS (1e-12)
+
+struct test_state
+{
+   hashmap(int, double) int_map;
+   hashmap(point_s, int) point_map;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   hashmap_init(int, double, &tmp->int_map);
+   hashmap_init(point_s, int, &tmp->point_map);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   hashmap_delete(int, double, &tmp->int_map);
+   hashmap_delete(point_s, int, &tmp->point_map);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+
+/* Int -> double map */
+
+static void test_int_map_init_delete(void **state)
+{
+   hashmap(int, double) map;
+   hashmap_init(int, double, &map);
+   assert_int_equal(hashmap_len(int, double, &map), 0);
+   assert_int_equal(hashmap_capacity(int, double, &map), 0);
+   assert_true(hashmap_empty(int, double, &map));
+   assert_ptr_equal(map.ctrl, NULL);
+
+   // lookups on an unallocated map
+   assert_ptr_equal(hashmap_get(int, double, &map, 3), NULL);
+   assert_false(hashmap_remove(int, double, &map, 3));
+   assert_int_equal(hashmap_next(int, double, &map, 0), 0);
+
+   assert_true(hashmap_insert(int, double, &map, 3, 1.5));
+   assert_int_equal(hashmap_capacity(int, double, &map), HASHMAP_MIN_CAPACITY);
+
+   hashmap_delete(int, double, &map);
+   assert_int_equal(hashmap_len(int, double, &map), 0);
+   assert_int_equal(hashmap_capacity(int, double, &map), 0);
+   assert_ptr_equal(map.ctrl, NULL);
+}
+
+static void test_int_map_insert_get(void **state)
+{
+   hashmap(int, double) *map = &((test_state_s*)(*state))->int_map;
+
+   for (int i = 0; i < 1000; i++)
+      assert_true(hashmap_insert(int, double, map, i * 7, i * 0.5));
+   assert_int_equal(hashmap_len(int, double, map), 1000);
+   assert_int_equal(hashmap_capacity(int, double, map), 2048);
+
+   for (int i = 0; i < 1000; i++)
+   {
+      const double *value = hashmap_get(int, double, map, i * 7);
+      assert_non_null(value);
+      assert_double_equal(*value, i * 0.5, DOUBLE_EPS);
+      assert_false(hashmap_contains(int, double, map, i * 7 + 1));
+   }
+
+   // insert overwrites, get points at the stored value
+   assert_true(hashmap_insert(int, double, map, 14, -1.0));
+   assert_int_equal(hashmap_len(int, double, map), 1000);
+   assert_double_equal(*hashmap_get(int, double, map, 14), -1.0, DOUBLE_EPS);
+   *hashmap_get(int, double, map, 14) = 2.0;
+   assert_double_equal(*hashmap_get(int, double, map, 14), 2.0, DOUBLE_EPS);
+}
+
+static void test_int_map_remove(void **state)
+{
+   hashmap(int, double) *map = &((test_state_s*)(*state))->int_map;
+
+   for (int i = 0; i < 500; i++)
+      hashmap_insert(int, double, map, i, (double)i);
+   for (int i = 0; i < 500; i += 2)
+      assert_true(hashmap_remove(int, double, map, i));
+   assert_false(hashmap_remove(int, double, map, 0));
+   assert_int_equal(hashmap_len(int, double, map), 250);
+
+   for (int i = 0; i < 500; i++)
+      assert_int_equal(hashmap_contains(int, double, map, i), i % 2 == 1);
+
+   for (int i = 0; i < 500; i += 2)
+      assert_true(hashmap_insert(int, double, map, i, -(double)i));
+   assert_int_equal(hashmap_len(int, double, map), 500);
+   assert_double_equal(*hashmap_get(int, double, map, 10), -10.0, DOUBLE_EPS);
+   assert_double_equal(*hashmap_get(int, double, map, 11), 11.0, DOUBLE_EPS);
+}
+
+static void test_int_map_churn(void **state)
+{
+   hashmap(int, double) *map = &((test_state_s*)(*state))->int_map;
+
+   // a sliding window of 100 keys: tombstones are recycled, the table grows at most once
+   for (int i = 0; i < 100; i++)
+      hashmap_insert(int, double, map, i, (double)i);
+   const size_t capacity = hashmap_capacity(int, double, map);
+   for (int i = 0; i < 20000; i++)
+   {
+      assert_true(hashmap_remove(int, double, map, i));
+      assert_true(hashmap_insert(int, double, map, i + 100, (double)(i + 100)));
+   }
+   assert_int_equal(hashmap_len(int, double, map), 100);
+   assert_true(hashmap_capacity(int, double, map) <= 2 * capacity);
+   for (int i = 20000; i < 20100; i++)
+      assert_double_equal(*hashmap_get(int, double, map, i), (double)i, DOUBLE_EPS);
+   assert_false(hashmap_contains(int, double, map, 19999));
+}
+
+static void test_int_map_reserve_clear(void **state)
+{
+   hashmap(int, double) *map = &((test_state_s*)(*state))->int_map;
+
+   assert_true(hashmap_reserve(int, double, map, 1000));
+   const int8_t *const ctrl = map->ctrl;
+   const size_t capacity = hashmap_capacity(int, double, map);
+   assert_true(capacity >= 1000 && capacity - capacity / 8 >= 1000);
+
+   for (int i = 0; i < 1000; i++)
+      hashmap_insert(int, double, map, i, (double)i);
+   assert_ptr_equal(map->ctrl, ctrl);
+   assert_true(hashmap_reserve(int, double, map, 10));
+   assert_ptr_equal(map->ctrl, ctrl);
+
+   hashmap_clear(int, double, map);
+   assert_true(hashmap_empty(int, double, map));
+   assert_int_equal(hashmap_capacity(int, double, map), capacity);
+   assert_false(hashmap_contains(int, double, map, 5));
+   assert_int_equal(hashmap_next(int, double, map, 0), capacity);
+}
+
+static void test_int_map_next(void **state)
+{
+   hashmap(int, double) *map = &((test_state_s*)(*state))->int_map;
+
+   int64_t expected = 0;
+   for (int i = 1; i <= 300; i++)
+   {
+      hashmap_insert(int, double, map, i * i, 1.0);
+      expected += (int64_t)i * i;
+   }
+   hashmap_remove(int, double, map, 4);
+   expected -= 4;
+
+   int64_t sum = 0;
+   size_t count = 0;
+   for (size_t i = hashmap_next(int, double, map, 0); i < map->capacity; i = hashmap_next(int, double, map, i + 1))
+   {
+      sum += map->entries[i].key;
+      count++;
+   }
+   assert_int_equal(count, 299);
+   assert_int_equal(sum, expected);
+}
+
+
+/* Point -> int map */
+
+static void test_point_map_insert_get_remove(void **state)
+{
+   hashmap(point_s, int) *map = &((test_state_s*)(*state))->point_map;
+
+   // 64 x 64 grid
+   for (int32_t x = 0; x < 64; x++)
+      for (int32_t y = 0; y < 64; y++)
+         assert_true(hashmap_insert(point_s, int, map, ((point_s){ x, y }), x * 64 + y));
+   assert_int_equal(hashmap_len(point_s, int, map), 4096);
+
+   for (int32_t x = 0; x < 64; x++)
+      for (int32_t y = 0; y < 64; y++)
+         assert_int_equal(*hashmap_get(point_s, int, map, ((point_s){ x, y })), x * 64 + y);
+   assert_false(hashmap_contains(point_s, int, map, ((point_s){ 64, 0 })));
+   assert_false(hashmap_contains(point_s, int, map, ((point_s){ -1, -1 })));
+
+   // drop the diagonal
+   for (int32_t i = 0; i < 64; i++)
+      assert_true(hashmap_remove(point_s, int, map, ((point_s){ i, i })));
+   assert_int_equal(hashmap_len(point_s, int, map), 4096 - 64);
+   assert_false(hashmap_contains(point_s, int, map, ((point_s){ 5, 5 })));
+   assert_true(hashmap_contains(point_s, int, map, ((point_s){ 5, 6 })));
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_int_map_init_delete),
+      cmocka_unit_test_setup_teardown(test_int_map_insert_get, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_map_remove, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_map_churn, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_map_reserve_clear, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_map_next, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_point_map_insert_get_remove, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
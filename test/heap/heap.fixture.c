@@ -0,0 +1,51 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "heap.fixture.h"
+
+
+/* Int heap (4-ary) */
+
+bool int_valid(int x)
+{
+   return true;
+}
+
+int compare_int(const int *a, const int *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_STACK(int, size_t, INT_HEAP_INIT_SIZE, INT_HEAP_GROWTH_FACTOR, int_valid, malloc, realloc, free)
+GENERATE_HEAP(int, size_t, 4, compare_int)
+
+
+/* Task heap (binary) */
+
+bool task_valid(task_s x)
+{
+   return x.priority != UINT32_MAX;
+}
+
+int compare_task(const task_s *a, const task_s *b)
+{
+   return (a->priority > b->priority) - (a->priority < b->priority);
+}
+
+GENERATE_STACK(task_s, uint32_t, TASK_HEAP_INIT_SIZE, TASK_HEAP_GROWTH_FACTOR, task_valid, malloc, realloc, free)
+GENERATE_HEAP(task_s, uint32_t, 2, compare_task)
+
+
+/* Narrow heap (4-ary, uint16_t length) */
+
+bool uint32_t_valid(uint32_t x)
+{
+   return x != UINT32_MAX;
+}
+
+int compare_uint32_t(const uint32_t *a, const uint32_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_STACK(uint32_t, uint16_t, NARROW_HEAP_INIT_SIZE, NARROW_HEAP_GROWTH_FACTOR, uint32_t_valid, malloc, realloc, free)
+GENERATE_HEAP(uint32_t, uint16_t, 4, compare_uint32_t)
\ No newline at end of file
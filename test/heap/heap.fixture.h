@@ -0,0 +1,31 @@
+#ifndef __HEAP_FIXTURE_H
+#define __HEAP_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Int heap (4-ary) */
+#define INT_HEAP_INIT_SIZE 4
+#define INT_HEAP_GROWTH_FACTOR 2
+DEFINE_STACK(int, size_t, INT_HEAP_INIT_SIZE)
+DEFINE_HEAP(int, size_t)
+
+/* Task heap (binary) */
+typedef struct
+{
+   uint32_t priority;
+   uint32_t id;
+} task_s;
+#define TASK_HEAP_INIT_SIZE 8
+#define TASK_HEAP_GROWTH_FACTOR 4
+DEFINE_STACK(task_s, uint32_t, TASK_HEAP_INIT_SIZE)
+DEFINE_HEAP(task_s, uint32_t)
+
+/* Narrow heap (4-ary, uint16_t length) */
+#define NARROW_HEAP_INIT_SIZE 8
+#define NARROW_HEAP_GROWTH_FACTOR 2
+DEFINE_STACK(uint32_t, uint16_t, NARROW_HEAP_INIT_SIZE)
+DEFINE_HEAP(uint32_t, uint16_t)
+
+#endif /* __HEAP_FIXTURE_H */
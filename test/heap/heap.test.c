@@ -0,0 +1,242 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "heap.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   heap(int) int_heap;
+   heap(task_s) task_heap;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   heap_init(int, &tmp->int_heap);
+   heap_init(task_s, &tmp->task_heap);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   heap_delete(int, &tmp->int_heap);
+   heap_delete(task_s, &tmp->task_heap);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+
+/* Int heap (4-ary) */
+
+// make sure no. elements > INT_HEAP_INIT_SIZE
+const int mock_ints[] = { 17, 3, 22, 9, -4, 15, 8, 3, 41, 0, 11, -9, 27, 6, 13 };
+
+static void test_int_heap_init_delete(void **state)
+{
+   heap(int) heap;
+   heap_init(int, &heap);
+   assert_int_equal(heap_len(int, &heap), 0);
+   assert_int_equal(heap_size(int, &heap), INT_HEAP_INIT_SIZE);
+   assert_ptr_equal(heap.stack.values, heap.stack.inline_buffer);
+   assert_false(heap_pop(int, &heap));
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_ints); i++)
+      assert_true(heap_push(int, &heap, mock_ints[i]));
+   assert_true(heap_size(int, &heap) > INT_HEAP_INIT_SIZE);
+
+   heap_delete(int, &heap);
+   assert_int_equal(heap_len(int, &heap), 0);
+   assert_int_equal(heap_size(int, &heap), INT_HEAP_INIT_SIZE);
+   assert_ptr_equal(heap.stack.values, heap.stack.inline_buffer);
+}
+
+static void test_int_heap_push_pop(void **state)
+{
+   heap(int) *heap = &((test_state_s*)(*state))->int_heap;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_ints); i++)
+      assert_true(heap_push(int, heap, mock_ints[i]));
+   assert_int_equal(heap_len(int, heap), ARRAY_LEN(mock_ints));
+   assert_int_equal(heap_peek(int, heap), -9);
+
+   int previous = heap_peek(int, heap);
+   size_t count = 0;
+   while (!heap_empty(int, heap))
+   {
+      assert_true(heap_peek(int, heap) >= previous);
+      previous = heap_peek(int, heap);
+      assert_true(heap_pop(int, heap));
+      count++;
+   }
+   assert_int_equal(count, ARRAY_LEN(mock_ints));
+   assert_int_equal(previous, 41);
+}
+
+static void test_int_heap_push_pop_combined(void **state)
+{
+   heap(int) *heap = &((test_state_s*)(*state))->int_heap;
+
+   // empty heap: the value comes straight back
+   assert_int_equal(heap_push_pop(int, heap, 5), 5);
+   assert_true(heap_empty(int, heap));
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_ints); i++)
+      heap_push(int, heap, mock_ints[i]);
+
+   // not larger than the top: returned without touching the heap
+   assert_int_equal(heap_push_pop(int, heap, -20), -20);
+   assert_int_equal(heap_peek(int, heap), -9);
+
+   // larger: the top comes out, the value goes in
+   assert_int_equal(heap_push_pop(int, heap, 100), -9);
+   assert_int_equal(heap_push_pop(int, heap, 100), -4);
+   assert_int_equal(heap_len(int, heap), ARRAY_LEN(mock_ints));
+   assert_int_equal(heap_peek(int, heap), 0);
+}
+
+static void test_int_heap_heapify(void **state)
+{
+   heap(int) *heap = &((test_state_s*)(*state))->int_heap;
+
+   // bulk build on top of existing elements, then drain in order
+   heap_push(int, heap, 50000);
+   heap_push(int, heap, -1);
+   int *values = malloc(sizeof(int) * 10000);
+   assert_non_null(values);
+   int lowest = -1;
+   uint32_t seed = 7;
+   for (size_t i = 0; i < 10000; i++)
+   {
+      values[i] = (int)(next_random(&seed) % 20000) - 10000;
+      lowest = (values[i] < lowest) ? values[i] : lowest;
+   }
+
+   assert_true(heap_heapify(int, heap, values, 10000));
+   assert_int_equal(heap_len(int, heap), 10002);
+   assert_int_equal(heap_peek(int, heap), lowest);
+
+   int previous = heap_peek(int, heap);
+   for (size_t i = 0; i < 10002; i++)
+   {
+      assert_true(heap_peek(int, heap) >= previous);
+      previous = heap_peek(int, heap);
+      heap_pop(int, heap);
+   }
+   assert_int_equal(previous, 50000);
+   assert_true(heap_empty(int, heap));
+
+   assert_true(heap_heapify(int, heap, values, 0));
+   assert_true(heap_heapify(int, heap, values, 1));
+   assert_int_equal(heap_peek(int, heap), values[0]);
+   free(values);
+}
+
+
+/* Task heap (binary) */
+
+static void test_task_heap_random(void **state)
+{
+   heap(task_s) *heap = &((test_state_s*)(*state))->task_heap;
+
+   // interleaved pushes and pops against a running count of each priority
+   uint32_t counts[64] = { 0 };
+   uint32_t seed = 99;
+   for (uint32_t i = 0; i < 5000; i++)
+   {
+      const task_s task = { .priority = next_random(&seed) % 64, .id = i };
+      assert_true(heap_push(task_s, heap, task));
+      counts[task.priority]++;
+      if (i % 3 == 0)
+      {
+         const task_s top = heap_peek(task_s, heap);
+         for (uint32_t p = 0; p < top.priority; p++)
+            assert_int_equal(counts[p], 0);
+         counts[top.priority]--;
+         heap_pop(task_s, heap);
+      }
+   }
+
+   uint32_t previous = 0;
+   while (!heap_empty(task_s, heap))
+   {
+      const task_s top = heap_peek(task_s, heap);
+      assert_true(top.priority >= previous);
+      previous = top.priority;
+      counts[top.priority]--;
+      heap_pop(task_s, heap);
+   }
+   for (uint32_t p = 0; p < 64; p++)
+      assert_int_equal(counts[p], 0);
+}
+
+
+/* Narrow heap (4-ary, uint16_t length) */
+
+static void test_narrow_heap_len_type(void **state)
+{
+   // past len 16384, i * 4 + 1 no longer fits in a uint16_t
+   heap(uint32_t) heap;
+   heap_init(uint32_t, &heap);
+   uint32_t *values = malloc(sizeof(uint32_t) * 30000);
+   assert_non_null(values);
+   uint32_t seed = 3;
+   for (size_t i = 0; i < 30000; i++)
+   {
+      values[i] = next_random(&seed);
+      assert_true(heap_push(uint32_t, &heap, values[i]));
+   }
+   assert_int_equal(heap_len(uint32_t, &heap), 30000);
+
+   uint32_t previous = 0;
+   for (size_t i = 0; i < 30000; i++)
+   {
+      assert_true(heap_peek(uint32_t, &heap) >= previous);
+      previous = heap_peek(uint32_t, &heap);
+      assert_true(heap_pop(uint32_t, &heap));
+   }
+   assert_true(heap_empty(uint32_t, &heap));
+
+   // same sizes through the bulk build
+   assert_true(heap_heapify(uint32_t, &heap, values, 30000));
+   previous = 0;
+   for (size_t i = 0; i < 30000; i++)
+   {
+      assert_true(heap_peek(uint32_t, &heap) >= previous);
+      previous = heap_peek(uint32_t, &heap);
+      assert_true(heap_pop(uint32_t, &heap));
+   }
+   heap_delete(uint32_t, &heap);
+   free(values);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_int_heap_init_delete),
+      cmocka_unit_test_setup_teardown(test_int_heap_push_pop, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_heap_push_pop_combined, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_heap_heapify, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_task_heap_random, setup, teardown),
+      cmocka_unit_test(test_narrow_heap_len_type),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
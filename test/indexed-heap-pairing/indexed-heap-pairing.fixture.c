@@ -0,0 +1,4 @@
+#include "indexed-heap-pairing.fixture.h"
+
+/* Same key types, IDs and comparators as the d-ary fixture */
+#include "../indexed-heap/indexed-heap.fixture.c"
@@ -0,0 +1,8 @@
+#ifndef __INDEXED_HEAP_PAIRING_FIXTURE_H
+#define __INDEXED_HEAP_PAIRING_FIXTURE_H
+
+/* The indexed-heap fixture, built with the pairing heap layout */
+#define INDEXED_HEAP_PAIRING
+#include "../indexed-heap/indexed-heap.fixture.h"
+
+#endif /* __INDEXED_HEAP_PAIRING_FIXTURE_H */
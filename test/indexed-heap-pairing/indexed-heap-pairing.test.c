@@ -0,0 +1,4 @@
+#include "indexed-heap-pairing.fixture.h"
+
+/* Every indexed-heap test, against the pairing heap */
+#include "../indexed-heap/indexed-heap.test.c"
@@ -0,0 +1,33 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "indexed-heap.fixture.h"
+
+
+/* Int keys, size_t IDs (4-ary) */
+
+int compare_int(const int *a, const int *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_INDEXED_HEAP(int, size_t, 4, compare_int, malloc, free)
+
+
+/* Double keys, uint32_t IDs (binary) */
+
+int compare_double(const double *a, const double *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_INDEXED_HEAP(double, uint32_t, 2, compare_double, malloc, free)
+
+
+/* uint32_t keys, uint16_t IDs (4-ary) */
+
+int compare_uint32_t(const uint32_t *a, const uint32_t *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+GENERATE_INDEXED_HEAP(uint32_t, uint16_t, 4, compare_uint32_t, malloc, free)
\ No newline at end of file
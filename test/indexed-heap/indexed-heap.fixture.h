@@ -0,0 +1,17 @@
+#ifndef __INDEXED_HEAP_FIXTURE_H
+#define __INDEXED_HEAP_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Int keys, size_t IDs (4-ary) */
+DEFINE_INDEXED_HEAP(int, size_t)
+
+/* Double keys, uint32_t IDs (binary) */
+DEFINE_INDEXED_HEAP(double, uint32_t)
+
+/* uint32_t keys, uint16_t IDs (4-ary) */
+DEFINE_INDEXED_HEAP(uint32_t, uint16_t)
+
+#endif /* __INDEXED_HEAP_FIXTURE_H */
@@ -0,0 +1,319 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "indexed-heap.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   indexed_heap(int) int_heap;
+   indexed_heap(double) double_heap;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   indexed_heap_init(int, &tmp->int_heap);
+   indexed_heap_init(double, &tmp->double_heap);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   indexed_heap_delete(int, &tmp->int_heap);
+   indexed_heap_delete(double, &tmp->double_heap);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+
+/* Int keys, size_t IDs (4-ary) */
+
+// key of ID i is mock_keys[i]; make sure no. IDs > INDEXED_HEAP_MIN_CAPACITY
+const int mock_keys[] = { 17, 3, 22, 9, -4, 15, 8, 3, 41, 0, 11, -9, 27, 6, 13, 30, -1, 5 };
+
+static void test_int_indexed_heap_init_delete(void **state)
+{
+   indexed_heap(int) heap;
+   indexed_heap_init(int, &heap);
+   assert_int_equal(indexed_heap_len(int, &heap), 0);
+   assert_int_equal(indexed_heap_capacity(int, &heap), 0);
+   assert_false(indexed_heap_contains(int, &heap, 0));
+   assert_false(indexed_heap_pop(int, &heap));
+   assert_false(indexed_heap_remove(int, &heap, 3));
+
+   // capacity follows the largest ID, not the number of IDs
+   assert_true(indexed_heap_push(int, &heap, 100, 1));
+   assert_int_equal(indexed_heap_len(int, &heap), 1);
+   assert_int_equal(indexed_heap_capacity(int, &heap), 128);
+   assert_true(indexed_heap_reserve(int, &heap, 20));
+   assert_int_equal(indexed_heap_capacity(int, &heap), 128);
+   assert_true(indexed_heap_reserve(int, &heap, 129));
+   assert_int_equal(indexed_heap_capacity(int, &heap), 256);
+   assert_true(indexed_heap_contains(int, &heap, 100));
+   assert_int_equal(indexed_heap_key(int, &heap, 100), 1);
+
+   indexed_heap_delete(int, &heap);
+   assert_int_equal(indexed_heap_len(int, &heap), 0);
+   assert_int_equal(indexed_heap_capacity(int, &heap), 0);
+   assert_false(indexed_heap_contains(int, &heap, 100));
+}
+
+static void test_int_indexed_heap_push_pop(void **state)
+{
+   indexed_heap(int) *heap = &((test_state_s*)(*state))->int_heap;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_keys); i++)
+      assert_true(indexed_heap_push(int, heap, i, mock_keys[i]));
+   assert_int_equal(indexed_heap_len(int, heap), ARRAY_LEN(mock_keys));
+
+   // an ID is queued at most once
+   assert_false(indexed_heap_push(int, heap, 4, -100));
+   assert_int_equal(indexed_heap_key(int, heap, 4), -4);
+
+   assert_int_equal(indexed_heap_peek(int, heap), 11);
+   assert_int_equal(indexed_heap_peek_key(int, heap), -9);
+
+   int previous = indexed_heap_peek_key(int, heap);
+   size_t count = 0;
+   while (!indexed_heap_empty(int, heap))
+   {
+      const size_t id = indexed_heap_peek(int, heap);
+      assert_int_equal(indexed_heap_peek_key(int, heap), mock_keys[id]);
+      assert_true(mock_keys[id] >= previous);
+      previous = mock_keys[id];
+      assert_true(indexed_heap_pop(int, heap));
+      assert_false(indexed_heap_contains(int, heap, id));
+      count++;
+   }
+   assert_int_equal(count, ARRAY_LEN(mock_keys));
+   assert_int_equal(previous, 41);
+
+   // popped IDs can be pushed again
+   assert_true(indexed_heap_push(int, heap, 8, 2));
+   assert_int_equal(indexed_heap_peek(int, heap), 8);
+}
+
+static void test_int_indexed_heap_change_key(void **state)
+{
+   indexed_heap(int) *heap = &((test_state_s*)(*state))->int_heap;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_keys); i++)
+      indexed_heap_push(int, heap, i, mock_keys[i]);
+
+   assert_true(indexed_heap_decrease_key(int, heap, 8, -50));
+   assert_int_equal(indexed_heap_peek(int, heap), 8);
+   assert_int_equal(indexed_heap_key(int, heap, 8), -50);
+
+   assert_true(indexed_heap_increase_key(int, heap, 8, 100));
+   assert_int_equal(indexed_heap_peek(int, heap), 11);
+   assert_int_equal(indexed_heap_key(int, heap, 8), 100);
+
+   // unchanged keys are allowed both ways
+   assert_true(indexed_heap_decrease_key(int, heap, 11, -9));
+   assert_true(indexed_heap_increase_key(int, heap, 11, -9));
+
+   // not queued
+   assert_false(indexed_heap_decrease_key(int, heap, 500, 0));
+   assert_false(indexed_heap_increase_key(int, heap, ARRAY_LEN(mock_keys), 0));
+
+   assert_true(indexed_heap_remove(int, heap, 11));
+   assert_false(indexed_heap_contains(int, heap, 11));
+   assert_false(indexed_heap_remove(int, heap, 11));
+   assert_true(indexed_heap_remove(int, heap, 2));
+   assert_int_equal(indexed_heap_len(int, heap), ARRAY_LEN(mock_keys) - 2);
+
+   int previous = -100;
+   size_t last = 0;
+   while (!indexed_heap_empty(int, heap))
+   {
+      assert_true(indexed_heap_peek_key(int, heap) >= previous);
+      previous = indexed_heap_peek_key(int, heap);
+      last = indexed_heap_peek(int, heap);
+      indexed_heap_pop(int, heap);
+   }
+   assert_int_equal(last, 8);
+
+   // clear() forgets every queued ID but keeps the arrays
+   for (size_t i = 0; i < ARRAY_LEN(mock_keys); i++)
+      indexed_heap_push(int, heap, i, mock_keys[i]);
+   const size_t capacity = indexed_heap_capacity(int, heap);
+   indexed_heap_clear(int, heap);
+   assert_true(indexed_heap_empty(int, heap));
+   assert_int_equal(indexed_heap_capacity(int, heap), capacity);
+   for (size_t i = 0; i < ARRAY_LEN(mock_keys); i++)
+      assert_false(indexed_heap_contains(int, heap, i));
+}
+
+
+/* Double keys, uint32_t IDs (binary) */
+
+static void test_double_indexed_heap_random(void **state)
+{
+   indexed_heap(double) *heap = &((test_state_s*)(*state))->double_heap;
+
+   // random operations against a plain array of keys (negative: not queued)
+   enum { ID_COUNT = 300 };
+   double keys[ID_COUNT];
+   for (uint32_t i = 0; i < ID_COUNT; i++)
+      keys[i] = -1.0;
+
+   uint32_t seed = 42;
+   uint32_t queued = 0;
+   for (uint32_t step = 0; step < 20000; step++)
+   {
+      const uint32_t id = next_random(&seed) % ID_COUNT;
+      const double key = (double)(next_random(&seed) % 1000);
+      assert_int_equal(indexed_heap_contains(double, heap, id), keys[id] >= 0);
+      switch (next_random(&seed) % 5)
+      {
+         case 0:
+         case 1:
+            if (keys[id] >= 0)
+            {
+               const bool down = key <= keys[id];
+               assert_true(down ? indexed_heap_decrease_key(double, heap, id, key) : indexed_heap_increase_key(double, heap, id, key));
+            }
+            else
+            {
+               assert_true(indexed_heap_push(double, heap, id, key));
+               queued++;
+            }
+            keys[id] = key;
+            break;
+         case 2:
+            assert_int_equal(indexed_heap_remove(double, heap, id), keys[id] >= 0);
+            queued -= (keys[id] >= 0);
+            keys[id] = -1.0;
+            break;
+         default:
+            if (queued == 0)
+               break;
+            {
+               const uint32_t top = indexed_heap_peek(double, heap);
+               for (uint32_t i = 0; i < ID_COUNT; i++)
+                  assert_true(keys[i] < 0 || keys[i] >= keys[top]);
+               assert_true(indexed_heap_pop(double, heap));
+               keys[top] = -1.0;
+               queued--;
+            }
+            break;
+      }
+      assert_int_equal(indexed_heap_len(double, heap), queued);
+   }
+}
+
+static void test_double_indexed_heap_dijkstra(void **state)
+{
+   indexed_heap(double) *heap = &((test_state_s*)(*state))->double_heap;
+
+   // shortest paths on a random graph, checked against Bellman-Ford
+   enum { VERTICES = 200, EDGES = 1500 };
+   uint32_t from[EDGES], to[EDGES];
+   double weight[EDGES];
+   uint32_t seed = 3;
+   for (uint32_t e = 0; e < EDGES; e++)
+   {
+      from[e] = next_random(&seed) % VERTICES;
+      to[e] = next_random(&seed) % VERTICES;
+      weight[e] = (double)(next_random(&seed) % 100) / 4.0;
+   }
+
+   double expected[VERTICES], dist[VERTICES];
+   for (uint32_t v = 0; v < VERTICES; v++)
+      expected[v] = dist[v] = 1e300;
+   expected[0] = 0.0;
+   for (uint32_t round = 0; round < VERTICES; round++)
+      for (uint32_t e = 0; e < EDGES; e++)
+         if (expected[from[e]] + weight[e] < expected[to[e]])
+            expected[to[e]] = expected[from[e]] + weight[e];
+
+   assert_true(indexed_heap_reserve(double, heap, VERTICES));
+   dist[0] = 0.0;
+   indexed_heap_push(double, heap, 0, 0.0);
+   uint32_t settled = 0;
+   while (!indexed_heap_empty(double, heap))
+   {
+      const uint32_t u = indexed_heap_peek(double, heap);
+      const double d = indexed_heap_peek_key(double, heap);
+      indexed_heap_pop(double, heap);
+      settled++;
+      for (uint32_t e = 0; e < EDGES; e++)
+      {
+         if (from[e] != u || d + weight[e] >= dist[to[e]])
+            continue;
+         dist[to[e]] = d + weight[e];
+         if (!indexed_heap_decrease_key(double, heap, to[e], dist[to[e]]))
+            assert_true(indexed_heap_push(double, heap, to[e], dist[to[e]]));
+      }
+   }
+
+   // every vertex is popped at most once
+   assert_true(settled <= VERTICES);
+   for (uint32_t v = 0; v < VERTICES; v++)
+      assert_true(dist[v] == expected[v]);
+}
+
+
+/* uint32_t keys, uint16_t IDs (4-ary) */
+
+static void test_narrow_indexed_heap_len_type(void **state)
+{
+   // past len 16384, i * 4 + 1 no longer fits in a uint16_t
+   indexed_heap(uint32_t) heap;
+   indexed_heap_init(uint32_t, &heap);
+   uint32_t *keys = malloc(sizeof(uint32_t) * 30000);
+   assert_non_null(keys);
+   uint32_t seed = 5;
+   for (uint16_t id = 0; id < 30000; id++)
+   {
+      keys[id] = next_random(&seed);
+      assert_true(indexed_heap_push(uint32_t, &heap, id, keys[id]));
+   }
+   assert_int_equal(indexed_heap_len(uint32_t, &heap), 30000);
+
+   uint32_t previous = 0;
+   for (size_t i = 0; i < 30000; i++)
+   {
+      const uint16_t id = indexed_heap_peek(uint32_t, &heap);
+      assert_int_equal(indexed_heap_peek_key(uint32_t, &heap), keys[id]);
+      assert_true(keys[id] >= previous);
+      previous = keys[id];
+      assert_true(indexed_heap_pop(uint32_t, &heap));
+      assert_false(indexed_heap_contains(uint32_t, &heap, id));
+   }
+   assert_true(indexed_heap_empty(uint32_t, &heap));
+   indexed_heap_delete(uint32_t, &heap);
+   free(keys);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_int_indexed_heap_init_delete),
+      cmocka_unit_test_setup_teardown(test_int_indexed_heap_push_pop, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_indexed_heap_change_key, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_double_indexed_heap_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_double_indexed_heap_dijkstra, setup, teardown),
+      cmocka_unit_test(test_narrow_indexed_heap_len_type),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
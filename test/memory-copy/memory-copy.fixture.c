@@ -0,0 +1,9 @@
+#include <stddef.h>
+#include "memory-copy.fixture.h"
+
+
+void fill_bytes(unsigned char *bytes, size_t n, unsigned char seed)
+{
+   for (size_t i = 0; i < n; i++)
+      bytes[i] = (unsigned char)(i * 131 + seed);
+}
@@ -0,0 +1,19 @@
+#ifndef __MEMORY_COPY_FIXTURE_H
+#define __MEMORY_COPY_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* A 24-byte element for MEMORY_FILL */
+typedef struct
+{
+   double x;
+   double y;
+   double z;
+} point_s;
+
+/* bytes[i] = i * 131 + seed, so a shifted or dropped byte shows up */
+void fill_bytes(unsigned char *bytes, size_t n, unsigned char seed);
+
+#endif /* __MEMORY_COPY_FIXTURE_H */
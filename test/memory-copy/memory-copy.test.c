@@ -0,0 +1,132 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+#include "memory-copy.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+static void test_memory_copy_large(void **state)
+{
+   // below and above MEMORY_COPY_LARGE_MIN, into a buffer with a guard byte
+   const size_t sizes[] = { 0, 1, 63, 4096, MEMORY_COPY_LARGE_MIN, 3 * MEMORY_COPY_LARGE_MIN + 77 };
+   const size_t max = 3 * MEMORY_COPY_LARGE_MIN + 77;
+   unsigned char *src = malloc(max);
+   unsigned char *dest = malloc(max + 1);
+   assert_non_null(src);
+   assert_non_null(dest);
+   fill_bytes(src, max, 7);
+
+   for (size_t s = 0; s < ARRAY_LEN(sizes); s++)
+   {
+      memset(dest, 0, max + 1);
+      MEMORY_COPY_LARGE(dest, src, sizes[s]);
+      assert_memory_equal(dest, src, sizes[s]);
+      assert_int_equal(dest[sizes[s]], 0);
+   }
+   free(src);
+   free(dest);
+}
+
+static void test_memory_copy_stream(void **state)
+{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+   // the non-temporal kernels directly, with unaligned ends on both sides
+   const size_t size = 3 * MEMORY_COPY_LARGE_MIN + 77;
+   unsigned char *src = malloc(size + 64);
+   unsigned char *dest = malloc(size + 64);
+   assert_non_null(src);
+   assert_non_null(dest);
+   fill_bytes(src, size + 64, 7);
+
+   for (size_t offset = 0; offset < 64; offset += 13)
+   {
+      if (__builtin_cpu_supports("avx2"))
+      {
+         memset(dest, 0, size + 64);
+         memory_copy_stream_avx2(dest + offset, src + 63 - offset, size);
+         assert_memory_equal(dest + offset, src + 63 - offset, size);
+         assert_int_equal(dest[offset + size], 0);
+      }
+      if (__builtin_cpu_supports("avx512f"))
+      {
+         memset(dest, 0, size + 64);
+         memory_copy_stream_avx512(dest + offset, src + 63 - offset, size);
+         assert_memory_equal(dest + offset, src + 63 - offset, size);
+         assert_int_equal(dest[offset + size], 0);
+      }
+   }
+   free(src);
+   free(dest);
+#endif
+}
+
+static void test_memory_move_set_fill(void **state)
+{
+   unsigned char bytes[200];
+   for (size_t i = 0; i < sizeof(bytes); i++)
+      bytes[i] = (unsigned char)i;
+
+   // overlapping moves, constant (register path) and runtime sizes, each size evaluated once
+   size_t evaluated = 0;
+   MEMORY_MOVE(bytes + 1, bytes, (evaluated++, 16));
+   assert_int_equal(evaluated, 1);
+   for (size_t i = 0; i < 16; i++)
+      assert_int_equal(bytes[1 + i], i);
+   MEMORY_MOVE(bytes, bytes + 1, 16);
+   for (size_t i = 0; i < 16; i++)
+      assert_int_equal(bytes[i], i);
+   assert_int_equal(bytes[16], 15);
+
+   volatile size_t opaque_len = 140;
+   const size_t runtime_len = opaque_len;
+   MEMORY_MOVE(bytes + 50, bytes + 20, (evaluated++, runtime_len));
+   assert_int_equal(evaluated, 2);
+   for (size_t i = 0; i < runtime_len; i++)
+      assert_int_equal(bytes[50 + i], 20 + i);
+   MEMORY_MOVE(bytes, bytes, 0);
+
+   MEMORY_SET(bytes, 0xAB, (evaluated++, 7));
+   assert_int_equal(evaluated, 3);
+   MEMORY_SET(bytes + 7, 0, runtime_len);
+   for (size_t i = 0; i < 7; i++)
+      assert_int_equal(bytes[i], 0xAB);
+   for (size_t i = 0; i < runtime_len; i++)
+      assert_int_equal(bytes[7 + i], 0);
+
+   // uniform bytes (one MEMORY_SET) and a repeated pattern, with a guard past the end
+   const int lengths[] = { 0, 1, 2, 3, 7, 64, 100 };
+   int values[101];
+   for (size_t l = 0; l < ARRAY_LEN(lengths); l++)
+   {
+      const int n = lengths[l];
+      values[n] = 42;
+      MEMORY_FILL(int, values, -1, n);
+      for (int i = 0; i < n; i++)
+         assert_int_equal(values[i], -1);
+      MEMORY_FILL(int, values, 0x01020304, n);
+      for (int i = 0; i < n; i++)
+         assert_int_equal(values[i], 0x01020304);
+      assert_int_equal(values[n], 42);
+   }
+
+   point_s cords[33];
+   const point_s origin = { 1.0, -2.0, 0.5 };
+   MEMORY_FILL(point_s, cords, origin, ARRAY_LEN(cords));
+   for (size_t i = 0; i < ARRAY_LEN(cords); i++)
+      assert_memory_equal(&cords[i], &origin, sizeof(origin));
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_memory_copy_large),
+      cmocka_unit_test(test_memory_copy_stream),
+      cmocka_unit_test(test_memory_move_set_fill),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,15 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "packed-queue.fixture.h"
+
+
+/* Bit-packed queues of 1, 2 and 4-bit enums */
+
+GENERATE_PACKED_QUEUE(flag_e, PACKED_BITS_FOR(FLAG_COUNT), uint32_t, 64, 2, malloc, realloc, free)
+GENERATE_PACKED_QUEUE(state_e, PACKED_BITS_FOR(STATE_COUNT), uint32_t, 32, 2, malloc, realloc, free)
+GENERATE_PACKED_QUEUE(opcode_e, PACKED_BITS_FOR(OP_COUNT), uint32_t, 16, 4, malloc, realloc, free)
+
+
+/* Bit-packed stack of a 2-bit enum */
+
+GENERATE_PACKED_STACK(state_e, PACKED_BITS_FOR(STATE_COUNT), uint32_t, 32, 2, malloc, realloc, free)
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef __PACKED_QUEUE_FIXTURE_H
+#define __PACKED_QUEUE_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* 2 values -> 1 bit */
+typedef PACKED_ENUM(flag_e) { FLAG_OFF, FLAG_ON, FLAG_COUNT } flag_e;
+
+/* 4 values -> 2 bits */
+typedef PACKED_ENUM(state_e) { STATE_IDLE, STATE_RUNNING, STATE_BLOCKED, STATE_DONE, STATE_COUNT } state_e;
+
+/* 11 values -> 4 bits */
+typedef PACKED_ENUM(opcode_e) { OP_NOP, OP_LOAD, OP_STORE, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_JMP, OP_JZ, OP_CALL, OP_RET, OP_COUNT } opcode_e;
+
+DEFINE_PACKED_QUEUE(flag_e, PACKED_BITS_FOR(FLAG_COUNT), uint32_t, 64)
+DEFINE_PACKED_QUEUE(state_e, PACKED_BITS_FOR(STATE_COUNT), uint32_t, 32)
+DEFINE_PACKED_QUEUE(opcode_e, PACKED_BITS_FOR(OP_COUNT), uint32_t, 16)
+DEFINE_PACKED_STACK(state_e, PACKED_BITS_FOR(STATE_COUNT), uint32_t, 32)
+
+#endif /* __PACKED_QUEUE_FIXTURE_H */
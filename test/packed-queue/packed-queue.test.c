@@ -0,0 +1,264 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "packed-queue.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   packed_queue(flag_e) flags;
+   packed_queue(state_e) states;
+   packed_queue(opcode_e) opcodes;
+   packed_stack(state_e) stack;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   packed_queue_init(flag_e, &tmp->flags);
+   packed_queue_init(state_e, &tmp->states);
+   packed_queue_init(opcode_e, &tmp->opcodes);
+   packed_stack_init(state_e, &tmp->stack);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   packed_queue_delete(flag_e, &tmp->flags);
+   packed_queue_delete(state_e, &tmp->states);
+   packed_queue_delete(opcode_e, &tmp->opcodes);
+   packed_stack_delete(state_e, &tmp->stack);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+static void test_packed_queue_init_delete(void **state)
+{
+   (void)state;
+   static_assert(PACKED_BITS_FOR(FLAG_COUNT) == 1, "flag_e is 1 bit");
+   static_assert(PACKED_BITS_FOR(STATE_COUNT) == 2, "state_e is 2 bits");
+   static_assert(PACKED_BITS_FOR(OP_COUNT) == 4, "opcode_e is 4 bits");
+   static_assert(PACKED_BITS_FOR(200) == 8, "too wide to pack");
+
+   packed_queue(state_e) q;
+   packed_queue_init(state_e, &q);
+   assert_int_equal(packed_queue_len(state_e, &q), 0);
+   assert_int_equal(packed_queue_size(state_e, &q), 32);
+   assert_true(packed_queue_empty(state_e, &q));
+   assert_int_equal(packed_queue_bytes(state_e, &q, 2), 8);  /* 32 states in one word */
+   assert_int_equal(sizeof(q.inline_buffer), 8);
+   assert_false(packed_queue_deque(state_e, &q));
+   packed_queue_delete(state_e, &q);
+   assert_ptr_equal(q.words, q.inline_buffer);
+}
+
+static void test_packed_queue_fifo(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   packed_queue(state_e) *q = &s->states;
+
+   /* fill the inline word, then wrap: deque 20, enque 20 more */
+   for (uint32_t i = 0; i < 32; i++)
+      assert_true(packed_queue_enque(state_e, q, (state_e)(i % STATE_COUNT)));
+   assert_true(packed_queue_full(state_e, q));
+   assert_ptr_equal(q->words, q->inline_buffer);
+
+   for (uint32_t i = 0; i < 20; i++)
+   {
+      assert_int_equal(packed_queue_peek(state_e, q), i % STATE_COUNT);
+      assert_true(packed_queue_deque(state_e, q));
+   }
+   for (uint32_t i = 32; i < 52; i++)
+      assert_true(packed_queue_enque(state_e, q, (state_e)(i % STATE_COUNT)));
+   assert_int_equal(q->front, 20);
+
+   /* full and wrapped: the next enque moves the wrapped part past the old end */
+   for (uint32_t i = 52; i < 300; i++)
+      assert_true(packed_queue_enque(state_e, q, (state_e)(i % STATE_COUNT)));
+   assert_int_equal(packed_queue_size(state_e, q), 512);
+   assert_int_equal(packed_queue_len(state_e, q), 280);
+
+   for (uint32_t i = 0; i < 280; i++)
+      assert_int_equal(packed_queue_get(state_e, q, i), (i + 20) % STATE_COUNT);
+   for (uint32_t i = 20; i < 300; i++)
+   {
+      assert_int_equal(packed_queue_peek(state_e, q), i % STATE_COUNT);
+      assert_true(packed_queue_deque(state_e, q));
+   }
+   assert_true(packed_queue_empty(state_e, q));
+}
+
+static void test_packed_queue_deque_n(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   packed_queue(opcode_e) *q = &s->opcodes;
+
+   for (uint32_t i = 0; i < 100; i++)
+      assert_true(packed_queue_enque(opcode_e, q, (opcode_e)(i % OP_COUNT)));
+   assert_int_equal(packed_queue_deque_n(opcode_e, q, 37), 37);
+   assert_int_equal(packed_queue_peek(opcode_e, q), 37 % OP_COUNT);
+   assert_int_equal(packed_queue_deque_n(opcode_e, q, 1000), 63);
+   assert_true(packed_queue_empty(opcode_e, q));
+   assert_int_equal(packed_queue_deque_n(opcode_e, q, 5), 0);
+}
+
+/* unpack agrees with get for every start and length, wrapped or not */
+static void test_packed_queue_unpack(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   uint8_t out[300];
+   uint32_t seed = 3;
+
+   /* grow to 256 and leave front at 200 so the ring wraps */
+   for (uint32_t i = 0; i < 256; i++)
+   {
+      assert_true(packed_queue_enque(flag_e, &s->flags, (flag_e)(next_random(&seed) % FLAG_COUNT)));
+      assert_true(packed_queue_enque(state_e, &s->states, (state_e)(next_random(&seed) % STATE_COUNT)));
+      assert_true(packed_queue_enque(opcode_e, &s->opcodes, (opcode_e)(next_random(&seed) % OP_COUNT)));
+   }
+   packed_queue_deque_n(flag_e, &s->flags, 200);
+   packed_queue_deque_n(state_e, &s->states, 200);
+   packed_queue_deque_n(opcode_e, &s->opcodes, 200);
+   for (uint32_t i = 0; i < 150; i++)
+   {
+      assert_true(packed_queue_enque(flag_e, &s->flags, (flag_e)(next_random(&seed) % FLAG_COUNT)));
+      assert_true(packed_queue_enque(state_e, &s->states, (state_e)(next_random(&seed) % STATE_COUNT)));
+      assert_true(packed_queue_enque(opcode_e, &s->opcodes, (opcode_e)(next_random(&seed) % OP_COUNT)));
+   }
+   assert_int_equal(packed_queue_size(flag_e, &s->flags), 256);
+   assert_int_equal(packed_queue_size(opcode_e, &s->opcodes), 256);
+
+   const uint32_t len = 206;
+   for (uint32_t from = 0; from < 70; from++)
+      for (uint32_t n = 0; from + n <= len; n += 1 + n / 8)
+      {
+         memset(out, 0xEE, sizeof(out));
+         packed_queue_unpack(flag_e, &s->flags, from, n, out);
+         for (uint32_t k = 0; k < n; k++)
+            assert_int_equal(out[k], packed_queue_get(flag_e, &s->flags, from + k));
+         assert_int_equal(out[n], 0xEE);
+
+         packed_queue_unpack(state_e, &s->states, from, n, out);
+         for (uint32_t k = 0; k < n; k++)
+            assert_int_equal(out[k], packed_queue_get(state_e, &s->states, from + k));
+         assert_int_equal(out[n], 0xEE);
+
+         packed_queue_unpack(opcode_e, &s->opcodes, from, n, out);
+         for (uint32_t k = 0; k < n; k++)
+            assert_int_equal(out[k], packed_queue_get(opcode_e, &s->opcodes, from + k));
+         assert_int_equal(out[n], 0xEE);
+      }
+}
+
+/* random enque / deque / deque_n against a byte ring */
+static void test_packed_queue_random(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   enum { CAP = 1 << 14 };
+   uint8_t *ref = (uint8_t*)malloc(CAP);
+   assert_non_null(ref);
+   uint32_t head = 0, tail = 0;
+   uint32_t seed = 11;
+
+   for (uint32_t step = 0; step < 40000; step++)
+   {
+      const uint32_t r = next_random(&seed) % 8;
+      if (r < 5 && tail - head < CAP)
+      {
+         const opcode_e op = (opcode_e)(next_random(&seed) % OP_COUNT);
+         assert_true(packed_queue_enque(opcode_e, &s->opcodes, op));
+         ref[tail++ % CAP] = op;
+      }
+      else if (r < 7)
+      {
+         assert_int_equal(packed_queue_deque(opcode_e, &s->opcodes), head != tail);
+         if (head != tail)
+            head++;
+      }
+      else
+      {
+         const uint32_t n = next_random(&seed) % 40;
+         const uint32_t done = packed_queue_deque_n(opcode_e, &s->opcodes, n);
+         assert_int_equal(done, n < tail - head ? n : tail - head);
+         head += done;
+      }
+
+      assert_int_equal(packed_queue_len(opcode_e, &s->opcodes), tail - head);
+      if (head != tail)
+         assert_int_equal(packed_queue_peek(opcode_e, &s->opcodes), ref[head % CAP]);
+      if (step % 1009 == 0)
+         for (uint32_t i = head; i != tail; i++)
+            assert_int_equal(packed_queue_get(opcode_e, &s->opcodes, i - head), ref[i % CAP]);
+   }
+   free(ref);
+}
+
+static void test_packed_stack(void **state)
+{
+   test_state_s *s = (test_state_s*)(*state);
+   packed_stack(state_e) *st = &s->stack;
+   uint8_t out[600];
+
+   assert_false(packed_stack_pop(state_e, st));
+   for (uint32_t i = 0; i < 500; i++)
+   {
+      assert_true(packed_stack_push(state_e, st, (state_e)((i * 7) % STATE_COUNT)));
+      assert_int_equal(packed_stack_peek(state_e, st), (i * 7) % STATE_COUNT);
+   }
+   assert_int_equal(packed_stack_len(state_e, st), 500);
+   assert_int_equal(packed_stack_size(state_e, st), 512);
+
+   packed_stack_unpack(state_e, st, 3, 497, out);
+   for (uint32_t i = 3; i < 500; i++)
+   {
+      assert_int_equal(packed_stack_get(state_e, st, i), (i * 7) % STATE_COUNT);
+      assert_int_equal(out[i - 3], (i * 7) % STATE_COUNT);
+   }
+
+   for (uint32_t i = 500; i-- > 0;)
+   {
+      assert_int_equal(packed_stack_peek(state_e, st), (i * 7) % STATE_COUNT);
+      assert_true(packed_stack_pop(state_e, st));
+   }
+   assert_true(packed_stack_empty(state_e, st));
+
+   /* overwriting a slot leaves its neighbours alone */
+   for (uint32_t i = 0; i < 8; i++)
+      assert_true(packed_stack_push(state_e, st, STATE_DONE));
+   assert_true(packed_stack_pop(state_e, st));
+   assert_true(packed_stack_push(state_e, st, STATE_IDLE));
+   for (uint32_t i = 0; i < 7; i++)
+      assert_int_equal(packed_stack_get(state_e, st, i), STATE_DONE);
+   assert_int_equal(packed_stack_peek(state_e, st), STATE_IDLE);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_packed_queue_init_delete),
+      cmocka_unit_test_setup_teardown(test_packed_queue_fifo, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_packed_queue_deque_n, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_packed_queue_unpack, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_packed_queue_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_packed_stack, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
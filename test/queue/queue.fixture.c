@@ -1,4 +1,5 @@
 #include <stdlib.h>
+#include <stddef.h>
 #include "queue.fixture.h"
 
 
@@ -9,7 +10,19 @@ bool mock_valid(float x)
    return true;
 }
 
+bool float_equal(float a, float b)
+{
+   return a == b;
+}
+
 GENERATE_QUEUE(float, size_t, FLOAT_QUEUE_INIT_SIZE, FLOAT_QUEUE_GROWTH_FACTOR, mock_valid, malloc, realloc, free)
+GENERATE_QUEUE_SEARCH(float, size_t, float_equal)
+GENERATE_QUEUE_REDUCE(float, size_t, float)
+GENERATE_QUEUE_SORT(float, size_t, float, 0, malloc, free)
+GENERATE_QUEUE_REMOVE_IF(float, size_t, float_equal)
+GENERATE_QUEUE_HASH(float, size_t)
+GENERATE_QUEUE_PARALLEL(float, size_t, double)
+GENERATE_QUEUE_PARALLEL_SORT(float, size_t, malloc, free)
 
 
 /* Car queue */
@@ -19,4 +32,11 @@ bool car_valid(car_s x)
    return true;
 }
 
-GENERATE_QUEUE(car_s, size_t, CAR_QUEUE_INIT_SIZE, CAR_QUEUE_GROWTH_FACTOR, car_valid, malloc, realloc, free)
\ No newline at end of file
+bool car_equal(car_s a, car_s b)
+{
+   return (a.engine == b.engine) && (a.chasis == b.chasis) && (a.gearbox == b.gearbox);
+}
+
+GENERATE_QUEUE(car_s, size_t, CAR_QUEUE_INIT_SIZE, CAR_QUEUE_GROWTH_FACTOR, car_valid, malloc, realloc, free)
+GENERATE_QUEUE_SEARCH(car_s, size_t, car_equal)
+GENERATE_QUEUE_SORT(car_s, size_t, size_t, offsetof(car_s, chasis), malloc, free)
\ No newline at end of file
@@ -9,6 +9,13 @@
 #define FLOAT_QUEUE_INIT_SIZE 4
 #define FLOAT_QUEUE_GROWTH_FACTOR 2
 DEFINE_QUEUE(float, size_t, FLOAT_QUEUE_INIT_SIZE)
+DEFINE_QUEUE_SEARCH(float, size_t)
+DEFINE_QUEUE_REDUCE(float, size_t, float)
+DEFINE_QUEUE_SORT(float, size_t)
+DEFINE_QUEUE_REMOVE_IF(float, size_t)
+DEFINE_QUEUE_HASH(float, size_t)
+DEFINE_QUEUE_PARALLEL(float, size_t, double)
+DEFINE_QUEUE_PARALLEL_SORT(float, size_t)
 
 /* Car queue */
 typedef struct
@@ -20,5 +27,7 @@ typedef struct
 #define CAR_QUEUE_INIT_SIZE 4
 #define CAR_QUEUE_GROWTH_FACTOR 2
 DEFINE_QUEUE(car_s, size_t, CAR_QUEUE_INIT_SIZE)
+DEFINE_QUEUE_SEARCH(car_s, size_t)
+DEFINE_QUEUE_SORT(car_s, size_t)
 
 #endif /* __QUEUE_FIXTURE_H */
@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <math.h>
 #include <cmocka.h>
 #include "queue.fixture.h"
 
@@ -207,6 +208,297 @@ static void test_float_queue_reverse(void **state)
    for (size_t i = 0; i < queue->len; i++)
       assert_float_equal(queue->values[(queue->front + i) % queue->size], mock_floats[queue->len - 1 - i], FLOAT_EPS);
 }
+
+static void test_float_queue_find_count_contains(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+
+   // wrap the ring: front moves forward, tail wraps to the start of the buffer
+   for (size_t i = 0; i < ARRAY_LEN(mock_floats); i++)
+      queue_enque(float, queue, mock_floats[i]);
+   for (size_t i = 0; i < 20; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 15; i++)
+      queue_enque(float, queue, mock_floats[i]);
+   assert_true(queue->front + queue->len > queue->size);
+
+   // logical order: mock_floats[20..27], mock_floats[0..14]
+   assert_int_equal(queue_find(float, queue, mock_floats[20]), 0);
+   assert_int_equal(queue_find(float, queue, mock_floats[3]), 11);
+   assert_int_equal(queue_find(float, queue, -1.0f), queue->len);
+
+   assert_int_equal(queue_count(float, queue, mock_floats[3]), 1);
+   assert_int_equal(queue_count(float, queue, mock_floats[10]), 1);
+   assert_int_equal(queue_count(float, queue, mock_floats[18]), 0);
+
+   assert_true(queue_contains(float, queue, mock_floats[14]));
+   assert_false(queue_contains(float, queue, mock_floats[15]));
+}
+
+static void test_float_queue_reduce(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+
+   // wrapped ring, logical order: mock_floats[20..27], mock_floats[0..14]
+   for (size_t i = 0; i < ARRAY_LEN(mock_floats); i++)
+      queue_enque(float, queue, mock_floats[i]);
+   for (size_t i = 0; i < 20; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 15; i++)
+      queue_enque(float, queue, mock_floats[i]);
+   assert_true(queue->front + queue->len > queue->size);
+
+   float expected = 0.0f;
+   for (size_t i = 20; i < ARRAY_LEN(mock_floats); i++)
+      expected += mock_floats[i];
+   for (size_t i = 0; i < 15; i++)
+      expected += mock_floats[i];
+
+   assert_float_equal(queue_sum(float, queue), expected, 1e-3);
+   assert_float_equal(queue_min(float, queue), mock_floats[0], FLOAT_EPS);
+   assert_float_equal(queue_max(float, queue), mock_floats[27], FLOAT_EPS);
+   assert_int_equal(queue_argmin(float, queue), 8);
+   assert_int_equal(queue_argmax(float, queue), 7);
+
+   // NaN propagates through min / max, arg* point at it
+   queue_enque(float, queue, NAN);
+   assert_true(isnan(queue_sum(float, queue)));
+   assert_true(isnan(queue_min(float, queue)));
+   assert_true(isnan(queue_max(float, queue)));
+   assert_int_equal(queue_argmin(float, queue), 23);
+   assert_int_equal(queue_argmax(float, queue), 23);
+
+   // -0.0 == 0.0: argmin finds the first zero whatever its sign, across the wrap
+   queue_clear(float, queue);
+   for (size_t i = 0; i < 40; i++)
+      queue_enque(float, queue, 1.0f);
+   queue_clear(float, queue);
+   while (queue->front != queue->size - 16)
+   {
+      queue_enque(float, queue, 1.0f);
+      queue_deque(float, queue);
+   }
+   for (size_t i = 0; i < 40; i++)
+      queue_enque(float, queue, (i == 9) ? -0.0f : (i == 27) ? 0.0f : (i == 33) ? 8.0f : (float)(1 + i % 5));
+   assert_true(queue->front + queue->len > queue->size);
+   assert_int_equal(queue_argmin(float, queue), 9);
+   assert_int_equal(queue_argmax(float, queue), 33);
+   for (size_t i = 0; i < 10; i++)
+      queue_deque(float, queue);
+   assert_int_equal(queue_argmin(float, queue), 17);
+   assert_int_equal(queue_argmax(float, queue), 23);
+}
+
+static int compare_float(const float *a, const float *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+static void test_float_queue_sort(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+
+   // wrapped ring with negative values
+   for (size_t i = 0; i < ARRAY_LEN(mock_floats); i++)
+      queue_enque(float, queue, mock_floats[i]);
+   for (size_t i = 0; i < 20; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 15; i++)
+      queue_enque(float, queue, -mock_floats[i]);
+   assert_true(queue->front + queue->len > queue->size);
+
+   assert_true(queue_radix_sort(float, queue));
+   assert_int_equal(queue->len, 23);
+   assert_float_equal(queue_peek(float, queue), -mock_floats[14], FLOAT_EPS);
+   for (size_t i = 1; i < queue->len; i++)
+      assert_true(queue->values[(queue->front + i - 1) & (queue->size - 1)] <= queue->values[(queue->front + i) & (queue->size - 1)]);
+
+   // not wrapped: sorted in place
+   queue_reverse(float, queue);
+   assert_true(queue_sort(float, queue, compare_float));
+   for (size_t i = 1; i < queue->len; i++)
+      assert_true(queue->values[(queue->front + i - 1) & (queue->size - 1)] <= queue->values[(queue->front + i) & (queue->size - 1)]);
+}
+static bool float_negative(const float *value, void *ctx)
+{
+   (void)ctx;
+   return *value < 0.0f;
+}
+
+static void test_float_queue_remove_if(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+
+   // wrapped ring: 21.75 .. 28.0, then -1.0 .. -23.125 alternating with 1.0
+   for (size_t i = 0; i < ARRAY_LEN(mock_floats); i++)
+      queue_enque(float, queue, mock_floats[i]);
+   for (size_t i = 0; i < 20; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 10; i++)
+   {
+      queue_enque(float, queue, -mock_floats[i]);
+      queue_enque(float, queue, 1.0f);
+   }
+   assert_true(queue->front + queue->len > queue->size);
+   const size_t size = queue->size;
+
+   assert_int_equal(queue_remove_if(float, queue, float_negative, NULL), 10);
+   assert_int_equal(queue->len, 18);
+   assert_int_equal(queue->size, size);
+   for (size_t i = 0; i < 8; i++)
+   {
+      assert_float_equal(queue_peek(float, queue), mock_floats[20 + i], FLOAT_EPS);
+      queue_deque(float, queue);
+   }
+   assert_int_equal(queue_remove_value(float, queue, 1.0f), 10);
+   assert_true(queue_empty(float, queue));
+
+   // retain across the wrap point, order preserved
+   for (size_t i = 0; i < 20; i++)
+      queue_enque(float, queue, (i % 2) ? mock_floats[i] : -mock_floats[i]);
+   assert_int_equal(queue_retain_if(float, queue, float_negative, NULL), 10);
+   for (size_t i = 0; i < 10; i++)
+   {
+      assert_float_equal(queue_peek(float, queue), -mock_floats[2 * i], FLOAT_EPS);
+      queue_deque(float, queue);
+   }
+}
+
+static void test_float_queue_hash_equal(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+   queue(float) other;
+   queue_init(float, &other);
+
+   // same contents, queue wrapped and other linear
+   for (size_t i = 0; i < ARRAY_LEN(mock_floats); i++)
+      queue_enque(float, queue, mock_floats[i]);
+   for (size_t i = 0; i < 20; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 15; i++)
+      queue_enque(float, queue, -mock_floats[i]);
+   assert_true(queue->front + queue->len > queue->size);
+
+   for (size_t i = 20; i < ARRAY_LEN(mock_floats); i++)
+      queue_enque(float, &other, mock_floats[i]);
+   for (size_t i = 0; i < 15; i++)
+      queue_enque(float, &other, -mock_floats[i]);
+   assert_true(other.front + other.len <= other.size);
+
+   assert_true(queue_equal(float, queue, &other));
+   assert_true(queue_equal(float, &other, queue));
+   assert_int_equal(queue_hash(float, queue, 0), queue_hash(float, &other, 0));
+
+   queue_deque(float, &other);
+   queue_enque(float, &other, mock_floats[20]);
+   assert_false(queue_equal(float, queue, &other));
+   assert_true(queue_hash(float, queue, 0) != queue_hash(float, &other, 0));
+
+   queue_delete(float, &other);
+}
+
+static void float_double(float *value, void *ctx)
+{
+   (void)ctx;
+   *value *= 2.0f;
+}
+
+static float float_halve(float value, void *ctx)
+{
+   (void)ctx;
+   return value / 2.0f;
+}
+
+static double float_count_above(double acc, const float *value, void *ctx)
+{
+   return acc + (*value > *(const float*)ctx);
+}
+
+static double double_add(double a, double b)
+{
+   return a + b;
+}
+
+static void test_float_queue_parallel(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+   parallel_pool_s pool;
+   assert_true(parallel_pool_init(&pool, 3));
+
+   // wrapped ring of 65536 + 30000 elements, every chunk sees 0..99 in order
+   const size_t n = 70000;
+   for (size_t i = 0; i < 65536; i++)
+      queue_enque(float, queue, 0.0f);
+   for (size_t i = 0; i < 40000; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 40000 + n - 65536; i++)
+      queue_enque(float, queue, 0.0f);
+   for (size_t i = 0; i < n; i++)
+   {
+      queue_deque(float, queue);
+      queue_enque(float, queue, (float)(i % 100));
+   }
+   assert_int_equal(queue->len, n);
+   assert_true(queue->front + queue->len > queue->size);
+
+   const float limit = 49.5f;
+   assert_float_equal(queue_parallel_reduce(float, queue, &pool, 0.0, float_count_above, double_add, (void*)&limit), n / 2, FLOAT_EPS);
+   queue_parallel_for_each(float, queue, &pool, float_double, NULL);
+   assert_float_equal(queue_parallel_reduce(float, queue, &pool, 0.0, float_count_above, double_add, (void*)&limit), n / 2 + n / 4, FLOAT_EPS);
+   queue_parallel_transform(float, queue, &pool, float_halve, NULL);
+   for (size_t i = 0; i < n; i++)
+   {
+      assert_float_equal(queue_peek(float, queue), (float)(i % 100), FLOAT_EPS);
+      queue_deque(float, queue);
+   }
+
+   parallel_pool_delete(&pool);
+}
+
+static void test_float_queue_parallel_sort(void **state)
+{
+   queue(float) *queue = &((test_state_s*)(*state))->float_queue;
+   parallel_pool_s pool;
+   assert_true(parallel_pool_init(&pool, 3));
+
+   // wrapped ring of 70000 pseudo random values, about half negative
+   const size_t n = 70000;
+   for (size_t i = 0; i < 65536; i++)
+      queue_enque(float, queue, 0.0f);
+   for (size_t i = 0; i < 40000; i++)
+      queue_deque(float, queue);
+   for (size_t i = 0; i < 40000 + n - 65536; i++)
+      queue_enque(float, queue, 0.0f);
+   uint32_t seed = 99;
+   for (size_t i = 0; i < n; i++)
+   {
+      seed = seed * 1103515245u + 12345u;
+      queue_deque(float, queue);
+      queue_enque(float, queue, (float)((int)((seed >> 8) % 20001) - 10000) / 8.0f);
+   }
+   assert_true(queue->front + queue->len > queue->size);
+
+   assert_true(queue_parallel_sort(float, queue, &pool, compare_float));
+   assert_int_equal(queue->front, 0);
+   assert_int_equal(queue->len, n);
+   for (size_t i = 1; i < n; i++)
+      assert_true(queue->values[i - 1] <= queue->values[i]);
+   float *const expected = malloc(sizeof(float) * n);
+   assert_non_null(expected);
+   memcpy(expected, queue->values, sizeof(float) * n);
+
+   // not wrapped, front > 0: merged into the scratch buffer and copied back in place
+   queue_reverse(float, queue);
+   for (size_t i = 0; i < 100; i++)
+      queue_deque(float, queue);
+   assert_true(queue_parallel_sort(float, queue, &pool, compare_float));
+   assert_int_equal(queue->front, 100);
+   assert_memory_equal(&queue->values[queue->front], expected, sizeof(float) * (n - 100));
+
+   free(expected);
+   parallel_pool_delete(&pool);
+}
+
  
 /* Car queue */
 
@@ -401,6 +693,52 @@ static void test_car_queue_reverse(void **state)
       assert_memory_equal(&queue->values[(queue->front + i) % queue->size], &mock_cars[queue->len - 1 - i], sizeof(car_s));
 }
 
+static void test_car_queue_find_count_contains(void **state)
+{
+   queue(car_s) *queue = &((test_state_s*)(*state))->car_queue;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_cars); i++)
+      queue_enque(car_s, queue, mock_cars[i]);
+   queue_enque(car_s, queue, mock_cars[5]);
+
+   assert_int_equal(queue_find(car_s, queue, mock_cars[5]), 5);
+   assert_int_equal(queue_count(car_s, queue, mock_cars[5]), 2);
+
+   const car_s missing = { .engine = 0, .chasis = 0, .gearbox = 0.0f };
+   assert_int_equal(queue_find(car_s, queue, missing), queue->len);
+   assert_false(queue_contains(car_s, queue, missing));
+   assert_true(queue_contains(car_s, queue, mock_cars[27]));
+}
+
+static int compare_car_engine(const car_s *a, const car_s *b)
+{
+   return (a->engine > b->engine) - (a->engine < b->engine);
+}
+
+static void test_car_queue_sort(void **state)
+{
+   queue(car_s) *queue = &((test_state_s*)(*state))->car_queue;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_cars); i++)
+      queue_enque(car_s, queue, mock_cars[i]);
+
+   // stable: equal engines keep their enque order
+   assert_true(queue_sort(car_s, queue, compare_car_engine));
+   for (size_t i = 1; i < queue->len; i++)
+   {
+      const car_s *a = &queue->values[(queue->front + i - 1) & (queue->size - 1)];
+      const car_s *b = &queue->values[(queue->front + i) & (queue->size - 1)];
+      assert_true(a->engine <= b->engine);
+      if (a->engine == b->engine)
+         assert_true(queue_find(car_s, queue, *a) < queue_find(car_s, queue, *b));
+   }
+
+   // radix key is the chasis field
+   assert_true(queue_radix_sort(car_s, queue));
+   for (size_t i = 1; i < queue->len; i++)
+      assert_true(queue->values[(queue->front + i - 1) & (queue->size - 1)].chasis < queue->values[(queue->front + i) & (queue->size - 1)].chasis);
+}
+
 int main(void)
 {  
    const struct CMUnitTest tests[] = 
@@ -413,6 +751,13 @@ int main(void)
       cmocka_unit_test_setup_teardown(test_float_queue_full, setup, teardown),
       cmocka_unit_test_setup_teardown(test_float_queue_clear, setup, teardown),
       cmocka_unit_test_setup_teardown(test_float_queue_reverse, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_find_count_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_reduce, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_sort, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_remove_if, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_hash_equal, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_parallel, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_float_queue_parallel_sort, setup, teardown),
       cmocka_unit_test(test_car_queue_init_delete),
       cmocka_unit_test(test_car_queue_resize),
       cmocka_unit_test_setup_teardown(test_car_queue_peek, setup, teardown),
@@ -421,6 +766,8 @@ int main(void)
       cmocka_unit_test_setup_teardown(test_car_queue_full, setup, teardown),
       cmocka_unit_test_setup_teardown(test_car_queue_clear, setup, teardown),
       cmocka_unit_test_setup_teardown(test_car_queue_reverse, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_car_queue_find_count_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_car_queue_sort, setup, teardown),
    };
    return cmocka_run_group_tests(tests, NULL, NULL);
 }
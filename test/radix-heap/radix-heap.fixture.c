@@ -0,0 +1,25 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "radix-heap.fixture.h"
+
+
+/* uint32_t keys */
+
+bool u32_valid(uint32_t x)
+{
+   return true;
+}
+
+GENERATE_STACK(uint32_t, size_t, U32_HEAP_INIT_SIZE, U32_HEAP_GROWTH_FACTOR, u32_valid, malloc, realloc, free)
+GENERATE_RADIX_HEAP(uint32_t, size_t, uint32_t, 0)
+
+
+/* Timers ordered by a 64-bit deadline */
+
+bool timer_valid(timer_s x)
+{
+   return x.deadline != UINT64_MAX;
+}
+
+GENERATE_STACK(timer_s, uint32_t, TIMER_HEAP_INIT_SIZE, TIMER_HEAP_GROWTH_FACTOR, timer_valid, malloc, realloc, free)
+GENERATE_RADIX_HEAP(timer_s, uint32_t, uint64_t, offsetof(timer_s, deadline))
\ No newline at end of file
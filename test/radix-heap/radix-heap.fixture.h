@@ -0,0 +1,25 @@
+#ifndef __RADIX_HEAP_FIXTURE_H
+#define __RADIX_HEAP_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* uint32_t keys */
+#define U32_HEAP_INIT_SIZE 2
+#define U32_HEAP_GROWTH_FACTOR 2
+DEFINE_STACK(uint32_t, size_t, U32_HEAP_INIT_SIZE)
+DEFINE_RADIX_HEAP(uint32_t, size_t, uint32_t)
+
+/* Timers ordered by a 64-bit deadline */
+typedef struct
+{
+   uint32_t id;
+   uint64_t deadline;
+} timer_s;
+#define TIMER_HEAP_INIT_SIZE 4
+#define TIMER_HEAP_GROWTH_FACTOR 4
+DEFINE_STACK(timer_s, uint32_t, TIMER_HEAP_INIT_SIZE)
+DEFINE_RADIX_HEAP(timer_s, uint32_t, uint64_t)
+
+#endif /* __RADIX_HEAP_FIXTURE_H */
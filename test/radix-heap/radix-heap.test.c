@@ -0,0 +1,196 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "radix-heap.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   radix_heap(uint32_t) u32_heap;
+   radix_heap(timer_s) timer_heap;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   radix_heap_init(uint32_t, &tmp->u32_heap);
+   radix_heap_init(timer_s, &tmp->timer_heap);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   radix_heap_delete(uint32_t, &tmp->u32_heap);
+   radix_heap_delete(timer_s, &tmp->timer_heap);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+
+/* uint32_t keys */
+
+const uint32_t mock_keys[] = { 17, 3, 22, 9, 4, 15, 8, 3, 41, 0, 11, 9, 27, 6, UINT32_MAX, 13 };
+
+static void test_u32_radix_heap_init_delete(void **state)
+{
+   radix_heap(uint32_t) heap;
+   radix_heap_init(uint32_t, &heap);
+   assert_int_equal(radix_heap_len(uint32_t, &heap), 0);
+   assert_true(radix_heap_empty(uint32_t, &heap));
+   assert_false(radix_heap_pop(uint32_t, &heap));
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_keys); i++)
+      assert_true(radix_heap_push(uint32_t, &heap, mock_keys[i]));
+   assert_int_equal(radix_heap_len(uint32_t, &heap), ARRAY_LEN(mock_keys));
+   assert_true(radix_heap_pop(uint32_t, &heap)); // redistributes the lowest bucket
+
+   radix_heap_delete(uint32_t, &heap);
+   assert_true(radix_heap_empty(uint32_t, &heap));
+   for (size_t i = 0; i < RADIX_HEAP_BUCKETS(uint32_t); i++)
+      assert_ptr_equal(heap.buckets[i].values, heap.buckets[i].inline_buffer);
+}
+
+static void test_u32_radix_heap_push_pop(void **state)
+{
+   radix_heap(uint32_t) *heap = &((test_state_s*)(*state))->u32_heap;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_keys); i++)
+      assert_true(radix_heap_push(uint32_t, heap, mock_keys[i]));
+   assert_int_equal(radix_heap_len(uint32_t, heap), ARRAY_LEN(mock_keys));
+   assert_int_equal(radix_heap_peek_key(uint32_t, heap), 0);
+
+   uint32_t previous = 0;
+   size_t count = 0;
+   while (!radix_heap_empty(uint32_t, heap))
+   {
+      const uint32_t top = radix_heap_peek(uint32_t, heap);
+      assert_int_equal(radix_heap_peek_key(uint32_t, heap), top);
+      assert_true(top >= previous);
+      previous = top;
+      assert_true(radix_heap_pop(uint32_t, heap));
+      count++;
+   }
+   assert_int_equal(count, ARRAY_LEN(mock_keys));
+   assert_int_equal(previous, UINT32_MAX);
+   assert_false(radix_heap_pop(uint32_t, heap));
+
+   // keys only move forward, until clear() resets the base to 0
+   assert_true(radix_heap_push(uint32_t, heap, UINT32_MAX));
+   assert_int_equal(radix_heap_peek(uint32_t, heap), UINT32_MAX);
+   radix_heap_clear(uint32_t, heap);
+   assert_true(radix_heap_empty(uint32_t, heap));
+   assert_true(radix_heap_push(uint32_t, heap, 1));
+   assert_int_equal(radix_heap_peek(uint32_t, heap), 1);
+}
+
+static void test_u32_radix_heap_monotone(void **state)
+{
+   radix_heap(uint32_t) *heap = &((test_state_s*)(*state))->u32_heap;
+
+   // Dijkstra-like: every push is at least the last key popped
+   uint32_t seed = 11;
+   uint32_t counts[4096] = { 0 };
+   uint32_t last = 0;
+   size_t queued = 0;
+   radix_heap_push(uint32_t, heap, 0);
+   counts[0]++;
+   queued++;
+   for (uint32_t step = 0; step < 50000; step++)
+   {
+      if (queued == 0 || next_random(&seed) % 3 != 0)
+      {
+         const uint32_t key = last + next_random(&seed) % 64;
+         if (key >= ARRAY_LEN(counts))
+            continue;
+         assert_true(radix_heap_push(uint32_t, heap, key));
+         counts[key]++;
+         queued++;
+      }
+      else
+      {
+         const uint32_t top = radix_heap_peek(uint32_t, heap);
+         assert_true(top >= last);
+         for (uint32_t k = last; k < top; k++)
+            assert_int_equal(counts[k], 0);
+         counts[top]--;
+         last = top;
+         assert_true(radix_heap_pop(uint32_t, heap));
+         queued--;
+      }
+      assert_int_equal(radix_heap_len(uint32_t, heap), queued);
+   }
+}
+
+
+/* Timers ordered by a 64-bit deadline */
+
+static void test_timer_radix_heap_deadlines(void **state)
+{
+   radix_heap(timer_s) *heap = &((test_state_s*)(*state))->timer_heap;
+
+   // timers scheduled at now + timeout, fired as the clock advances
+   const uint64_t start = (uint64_t)1 << 40;
+   uint64_t now = start;
+   uint32_t seed = 5;
+   uint32_t fired = 0;
+   uint8_t *done = calloc(20000, 1);
+   assert_non_null(done);
+   for (uint32_t id = 0; id < 20000; id++)
+   {
+      const timer_s timer = { .id = id, .deadline = now + next_random(&seed) % 100000 };
+      assert_true(radix_heap_push(timer_s, heap, timer));
+      now += next_random(&seed) % 16;
+      while (!radix_heap_empty(timer_s, heap) && radix_heap_peek_key(timer_s, heap) <= now)
+      {
+         const timer_s top = radix_heap_peek(timer_s, heap);
+         assert_true(top.deadline <= now);
+         assert_false(done[top.id]);
+         done[top.id] = 1;
+         fired++;
+         radix_heap_pop(timer_s, heap);
+      }
+   }
+
+   uint64_t previous = 0;
+   while (!radix_heap_empty(timer_s, heap))
+   {
+      const timer_s top = radix_heap_peek(timer_s, heap);
+      assert_true(top.deadline > now && top.deadline >= previous);
+      previous = top.deadline;
+      assert_false(done[top.id]);
+      done[top.id] = 1;
+      fired++;
+      radix_heap_pop(timer_s, heap);
+   }
+   assert_int_equal(fired, 20000);
+   free(done);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_u32_radix_heap_init_delete),
+      cmocka_unit_test_setup_teardown(test_u32_radix_heap_push_pop, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_u32_radix_heap_monotone, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_timer_radix_heap_deadlines, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
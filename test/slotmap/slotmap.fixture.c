@@ -0,0 +1,23 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "slotmap.fixture.h"
+
+
+/* Free lists of uint32_t slot indices */
+
+bool index_valid(uint32_t index)
+{
+   return index != UINT32_MAX;
+}
+
+GENERATE_STACK(uint32_t, uint32_t, 16, 2, index_valid, malloc, realloc, free)
+
+
+/* Int values */
+
+GENERATE_SLOTMAP(int, uint32_t, malloc, free)
+
+
+/* Particles */
+
+GENERATE_SLOTMAP(particle_s, uint32_t, malloc, free)
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef __SLOTMAP_FIXTURE_H
+#define __SLOTMAP_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Free lists of uint32_t slot indices, shared by both slot maps */
+DEFINE_STACK(uint32_t, uint32_t, 16)
+
+/* Int values */
+DEFINE_SLOTMAP(int, uint32_t)
+
+/* Particles */
+typedef struct
+{
+   float x, y;
+   float vx, vy;
+   uint32_t id;
+} particle_s;
+DEFINE_SLOTMAP(particle_s, uint32_t)
+
+#endif /* __SLOTMAP_FIXTURE_H */
@@ -0,0 +1,242 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "slotmap.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   slotmap(int) int_map;
+   slotmap(particle_s) particles;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   slotmap_init(int, &tmp->int_map);
+   slotmap_init(particle_s, &tmp->particles);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   slotmap_delete(int, &tmp->int_map);
+   slotmap_delete(particle_s, &tmp->particles);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+
+/* Int values */
+
+const int mock_values[] = { 17, 3, 22, 9, -4, 15, 8, 3, 41, 0, 11, -9, 27, 6, 13, 30, -1, 5 };
+
+static void test_int_slotmap_init_delete(void **state)
+{
+   slotmap(int) map;
+   slotmap_init(int, &map);
+   assert_int_equal(slotmap_len(int, &map), 0);
+   assert_int_equal(slotmap_capacity(int, &map), 0);
+   assert_true(slotmap_empty(int, &map));
+
+   // a zeroed handle is never valid
+   const slotmap_handle(int) zero = { 0 };
+   assert_false(slotmap_contains(int, &map, zero));
+   assert_ptr_equal(slotmap_get(int, &map, zero), NULL);
+   assert_false(slotmap_remove(int, &map, zero));
+
+   slotmap_handle(int) h;
+   assert_true(slotmap_insert(int, &map, 7, &h));
+   assert_int_equal(h.index, 0);
+   assert_false(slotmap_contains(int, &map, zero));
+   assert_int_equal(slotmap_capacity(int, &map), SLOTMAP_MIN_CAPACITY);
+   assert_true(slotmap_reserve(int, &map, 100));
+   assert_int_equal(slotmap_capacity(int, &map), 128);
+   assert_int_equal(*slotmap_get(int, &map, h), 7);
+
+   slotmap_delete(int, &map);
+   assert_int_equal(slotmap_len(int, &map), 0);
+   assert_int_equal(slotmap_capacity(int, &map), 0);
+   assert_false(slotmap_contains(int, &map, h));
+}
+
+static void test_int_slotmap_insert_remove(void **state)
+{
+   slotmap(int) *map = &((test_state_s*)(*state))->int_map;
+
+   slotmap_handle(int) handles[ARRAY_LEN(mock_values)];
+   for (size_t i = 0; i < ARRAY_LEN(mock_values); i++)
+      assert_true(slotmap_insert(int, map, mock_values[i], &handles[i]));
+   assert_int_equal(slotmap_len(int, map), ARRAY_LEN(mock_values));
+
+   // swap-remove: the last value moves into the hole, its handle still works
+   assert_true(slotmap_remove(int, map, handles[2]));
+   assert_int_equal(slotmap_len(int, map), ARRAY_LEN(mock_values) - 1);
+   assert_int_equal(slotmap_values(int, map)[2], mock_values[ARRAY_LEN(mock_values) - 1]);
+   for (size_t i = 0; i < ARRAY_LEN(mock_values); i++)
+   {
+      assert_int_equal(slotmap_contains(int, map, handles[i]), i != 2);
+      if (i != 2)
+         assert_int_equal(*slotmap_get(int, map, handles[i]), mock_values[i]);
+   }
+
+   // stale handles stay stale after the slot is reused
+   const slotmap_handle(int) stale = handles[2];
+   assert_false(slotmap_remove(int, map, stale));
+   assert_true(slotmap_insert(int, map, 100, &handles[2]));
+   assert_int_equal(handles[2].index, stale.index);
+   assert_int_equal(handles[2].generation, stale.generation + 1);
+   assert_false(slotmap_contains(int, map, stale));
+   assert_ptr_equal(slotmap_get(int, map, stale), NULL);
+   assert_int_equal(*slotmap_get(int, map, handles[2]), 100);
+
+   // handle_at maps dense positions back to handles
+   for (uint32_t i = 0; i < slotmap_len(int, map); i++)
+   {
+      const slotmap_handle(int) h = slotmap_handle_at(int, map, i);
+      assert_ptr_equal(slotmap_get(int, map, h), &slotmap_values(int, map)[i]);
+   }
+
+   // clear: everything stale, slots reused without growing
+   const uint32_t capacity = slotmap_capacity(int, map);
+   slotmap_clear(int, map);
+   assert_true(slotmap_empty(int, map));
+   for (size_t i = 0; i < ARRAY_LEN(mock_values); i++)
+      assert_false(slotmap_contains(int, map, handles[i]));
+   slotmap_handle(int) h;
+   for (size_t i = 0; i < ARRAY_LEN(mock_values); i++)
+   {
+      assert_true(slotmap_insert(int, map, (int)i, &h));
+      assert_true(h.index < ARRAY_LEN(mock_values));
+   }
+   assert_int_equal(slotmap_capacity(int, map), capacity);
+}
+
+static void test_int_slotmap_generation_wrap(void **state)
+{
+   slotmap(int) *map = &((test_state_s*)(*state))->int_map;
+
+   slotmap_handle(int) a, b;
+   assert_true(slotmap_insert(int, map, 1, &a));
+   assert_true(slotmap_insert(int, map, 2, &b));
+
+   // a slot about to wrap its generation is retired, never reused
+   map->slots[a.index].generation = UINT32_MAX;
+   a.generation = UINT32_MAX;
+   assert_true(slotmap_remove(int, map, a));
+   a.generation = 0;
+   assert_false(slotmap_contains(int, map, a));
+
+   slotmap_handle(int) c;
+   assert_true(slotmap_insert(int, map, 3, &c));
+   assert_int_not_equal(c.index, a.index);
+   assert_int_equal(*slotmap_get(int, map, b), 2);
+   assert_int_equal(*slotmap_get(int, map, c), 3);
+}
+
+
+/* Particles */
+
+static void test_particle_slotmap_random(void **state)
+{
+   slotmap(particle_s) *particles = &((test_state_s*)(*state))->particles;
+
+   // random inserts / removes against a plain array of live handles
+   enum { MAX_LIVE = 500 };
+   slotmap_handle(particle_s) live[MAX_LIVE];
+   uint32_t live_ids[MAX_LIVE];
+   slotmap_handle(particle_s) dead[64];
+   uint32_t live_count = 0, dead_count = 0, next_id = 0;
+
+   uint32_t seed = 7;
+   for (uint32_t step = 0; step < 20000; step++)
+   {
+      if (live_count < MAX_LIVE && (live_count == 0 || next_random(&seed) % 2))
+      {
+         const particle_s p = { .x = (float)step, .id = next_id };
+         assert_true(slotmap_insert(particle_s, particles, p, &live[live_count]));
+         live_ids[live_count++] = next_id++;
+      }
+      else
+      {
+         const uint32_t i = next_random(&seed) % live_count;
+         assert_true(slotmap_remove(particle_s, particles, live[i]));
+         dead[dead_count++ % ARRAY_LEN(dead)] = live[i];
+         live[i] = live[--live_count];
+         live_ids[i] = live_ids[live_count];
+      }
+      assert_int_equal(slotmap_len(particle_s, particles), live_count);
+
+      if (step % 97 == 0)
+      {
+         for (uint32_t i = 0; i < live_count; i++)
+            assert_int_equal(slotmap_get(particle_s, particles, live[i])->id, live_ids[i]);
+         for (uint32_t i = 0; i < dead_count && i < ARRAY_LEN(dead); i++)
+            assert_false(slotmap_contains(particle_s, particles, dead[i]));
+
+         // dense iteration sees every live particle once
+         uint64_t id_sum = 0, expected = 0;
+         const particle_s *values = slotmap_values(particle_s, particles);
+         for (uint32_t i = 0; i < slotmap_len(particle_s, particles); i++)
+            id_sum += values[i].id;
+         for (uint32_t i = 0; i < live_count; i++)
+            expected += live_ids[i];
+         assert_int_equal(id_sum, expected);
+      }
+   }
+
+   // slots are recycled: never more than the peak number of live particles
+   assert_true(particles->slot_count <= MAX_LIVE);
+}
+
+static void test_particle_slotmap_remove_while_iterating(void **state)
+{
+   slotmap(particle_s) *particles = &((test_state_s*)(*state))->particles;
+
+   slotmap_handle(particle_s) h;
+   for (uint32_t i = 0; i < 100; i++)
+      assert_true(slotmap_insert(particle_s, particles, ((particle_s){ .id = i }), &h));
+
+   // removing position i moves the last value there: revisit i
+   particle_s *values = slotmap_values(particle_s, particles);
+   for (uint32_t i = 0; i < slotmap_len(particle_s, particles);)
+   {
+      if (values[i].id % 3 == 0)
+         slotmap_remove(particle_s, particles, slotmap_handle_at(particle_s, particles, i));
+      else
+         i++;
+   }
+   assert_int_equal(slotmap_len(particle_s, particles), 66);
+   for (uint32_t i = 0; i < slotmap_len(particle_s, particles); i++)
+      assert_true(values[i].id % 3 != 0);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_int_slotmap_init_delete),
+      cmocka_unit_test_setup_teardown(test_int_slotmap_insert_remove, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_slotmap_generation_wrap, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_particle_slotmap_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_particle_slotmap_remove_while_iterating, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
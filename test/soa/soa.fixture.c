@@ -0,0 +1,34 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "soa.fixture.h"
+
+
+/* Allocator */
+
+bool test_alloc_fail = false;
+
+void *test_alloc(size_t size)
+{
+   return test_alloc_fail ? NULL : malloc(size);
+}
+
+
+/* Particles */
+
+bool particle_valid(particle_s p)
+{
+   return true;
+}
+
+GENERATE_SOA_QUEUE(particle_s, PARTICLE_FIELDS, uint32_t, 4, 2, particle_valid, test_alloc, free)
+GENERATE_QUEUE(particle_s, uint32_t, 4, 2, particle_valid, malloc, realloc, free)
+
+
+/* Samples */
+
+bool sample_valid(sample_s s)
+{
+   return s.note == NULL;
+}
+
+GENERATE_SOA_STACK(sample_s, SAMPLE_FIELDS, uint8_t, 8, 2, sample_valid, test_alloc, free)
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef __SOA_FIXTURE_H
+#define __SOA_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "ccoutils.h"
+
+/* Allocator that fails while test_alloc_fail is set */
+extern bool test_alloc_fail;
+void *test_alloc(size_t size);
+
+/* Particles: SoA queue, with an array-of-structs queue to compare against */
+typedef struct
+{
+   float x, y;
+   float vx, vy;
+   uint32_t id;
+} particle_s;
+#define PARTICLE_FIELDS(X) X(float, x) X(float, y) X(float, vx) X(float, vy) X(uint32_t, id)
+DEFINE_SOA_QUEUE(particle_s, PARTICLE_FIELDS, uint32_t)
+DEFINE_QUEUE(particle_s, uint32_t, 4)
+
+/* Samples: SoA stack of mixed field sizes, `note` not stored */
+typedef struct
+{
+   double time;
+   uint8_t flags;
+   int16_t level;
+   const char *note;
+} sample_s;
+#define SAMPLE_FIELDS(X) X(double, time) X(uint8_t, flags) X(int16_t, level)
+DEFINE_SOA_STACK(sample_s, SAMPLE_FIELDS, uint8_t)
+
+#endif /* __SOA_FIXTURE_H */
@@ -0,0 +1,278 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "soa.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   soa_queue(particle_s) particles;
+   queue(particle_s) reference;
+   soa_stack(sample_s) samples;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   soa_queue_init(particle_s, &tmp->particles);
+   queue_init(particle_s, &tmp->reference);
+   soa_stack_init(sample_s, &tmp->samples);
+   test_alloc_fail = false;
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   soa_queue_delete(particle_s, &tmp->particles);
+   queue_delete(particle_s, &tmp->reference);
+   soa_stack_delete(sample_s, &tmp->samples);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static particle_s make_particle(uint32_t i)
+{
+   return (particle_s){ (float)i, (float)i * 2.0f, (float)i * 0.5f, -(float)i, i };
+}
+
+static void assert_particle_equal(particle_s a, particle_s b)
+{
+   assert_true(a.x == b.x);
+   assert_true(a.y == b.y);
+   assert_true(a.vx == b.vx);
+   assert_true(a.vy == b.vy);
+   assert_int_equal(a.id, b.id);
+}
+
+static void assert_fields_aligned(const soa_queue(particle_s) *q)
+{
+   const void *fields[] = { q->x, q->y, q->vx, q->vy, q->id };
+   for (size_t f = 0; f < ARRAY_LEN(fields); f++)
+      assert_int_equal((uintptr_t)fields[f] % SOA_ALIGN, 0);
+}
+
+
+static void test_soa_queue_init_delete(void **state)
+{
+   soa_queue(particle_s) q;
+   soa_queue_init(particle_s, &q);
+   assert_int_equal(soa_queue_len(particle_s, &q), 0);
+   assert_int_equal(soa_queue_size(particle_s, &q), 0);
+   assert_true(soa_queue_empty(particle_s, &q));
+   assert_ptr_equal(q.memory, NULL);
+   assert_false(soa_queue_deque(particle_s, &q));
+
+   // the first enque allocates init_size slots for every field
+   assert_true(soa_queue_enque(particle_s, &q, make_particle(1)));
+   assert_int_equal(soa_queue_size(particle_s, &q), 4);
+   assert_fields_aligned(&q);
+   assert_particle_equal(soa_queue_peek(particle_s, &q), make_particle(1));
+   assert_true(soa_queue_front(particle_s, &q, vx) == 0.5f);
+
+   soa_queue_delete(particle_s, &q);
+   assert_int_equal(soa_queue_len(particle_s, &q), 0);
+   assert_int_equal(soa_queue_size(particle_s, &q), 0);
+   assert_ptr_equal(q.memory, NULL);
+   assert_ptr_equal(q.x, NULL);
+}
+
+static void test_soa_queue_matches_queue(void **state)
+{
+   soa_queue(particle_s) *q = &((test_state_s*)(*state))->particles;
+   queue(particle_s) *ref = &((test_state_s*)(*state))->reference;
+
+   // the same random enque / deque sequence on queue.h and the SoA queue
+   uint32_t seed = 1, next = 0;
+   for (uint32_t step = 0; step < 20000; step++)
+   {
+      seed = seed * 1103515245u + 12345u;
+      // grow, then drain, then grow again so the ring wraps at every size
+      const uint32_t phase = (step / 2500) % 2;
+      if ((seed >> 8) % 4 < (phase ? 1u : 3u))
+      {
+         assert_true(queue_enque(particle_s, ref, make_particle(next)));
+         assert_true(soa_queue_enque(particle_s, q, make_particle(next)));
+         next++;
+      }
+      else
+         assert_int_equal(soa_queue_deque(particle_s, q), queue_deque(particle_s, ref));
+
+      assert_int_equal(soa_queue_len(particle_s, q), queue_len(particle_s, ref));
+      if (!soa_queue_empty(particle_s, q))
+         assert_particle_equal(soa_queue_peek(particle_s, q), queue_peek(particle_s, ref));
+   }
+
+   // every element, through soa_queue_at
+   for (uint32_t i = 0; i < soa_queue_len(particle_s, q); i++)
+   {
+      const particle_s expected = ref->values[(ref->front + i) & (ref->size - 1)];
+      assert_int_equal(soa_queue_at(particle_s, q, id, i), expected.id);
+      assert_true(soa_queue_at(particle_s, q, y, i) == expected.y);
+   }
+   assert_fields_aligned(q);
+}
+
+static void test_soa_queue_span_linearize(void **state)
+{
+   soa_queue(particle_s) *q = &((test_state_s*)(*state))->particles;
+
+   // 64 slots, front at 50, 40 elements: wraps after 14
+   for (uint32_t i = 0; i < 64; i++)
+      assert_true(soa_queue_enque(particle_s, q, make_particle(i)));
+   for (uint32_t i = 0; i < 50; i++)
+      assert_true(soa_queue_deque(particle_s, q));
+   for (uint32_t i = 64; i < 90; i++)
+      assert_true(soa_queue_enque(particle_s, q, make_particle(i)));
+   assert_int_equal(soa_queue_size(particle_s, q), 64);
+   assert_int_equal(soa_queue_len(particle_s, q), 40);
+
+   uint32_t start;
+   assert_int_equal(soa_queue_span(particle_s, q, 0, &start), 14);
+   assert_int_equal(start, 50);
+   assert_int_equal(soa_queue_span(particle_s, q, 1, &start), 26);
+   assert_int_equal(start, 0);
+
+   // one field over both spans, as plain arrays
+   float sum = 0;
+   uint32_t expected_id = 50;
+   for (unsigned part = 0; part < 2; part++)
+   {
+      const uint32_t n = soa_queue_span(particle_s, q, part, &start);
+      const float *x = soa_queue_field(particle_s, q, x) + start;
+      const uint32_t *id = soa_queue_field(particle_s, q, id) + start;
+      for (uint32_t i = 0; i < n; i++)
+      {
+         sum += x[i];
+         assert_int_equal(id[i], expected_id++);
+      }
+   }
+   assert_true(sum == (float)((50 + 89) * 40 / 2));
+
+   // linearize: one span from slot 0, same order
+   soa_queue_linearize(particle_s, q);
+   assert_int_equal(soa_queue_span(particle_s, q, 0, &start), 40);
+   assert_int_equal(start, 0);
+   assert_int_equal(soa_queue_span(particle_s, q, 1, &start), 0);
+   for (uint32_t i = 0; i < 40; i++)
+   {
+      assert_particle_equal((particle_s){ q->x[i], q->y[i], q->vx[i], q->vy[i], q->id[i] }, make_particle(50 + i));
+      assert_int_equal(soa_queue_at(particle_s, q, id, i), 50 + i);
+   }
+
+   // an unwrapped queue with front past 0 shifts down
+   for (uint32_t i = 0; i < 10; i++)
+      assert_true(soa_queue_deque(particle_s, q));
+   soa_queue_linearize(particle_s, q);
+   assert_int_equal(q->front, 0);
+   for (uint32_t i = 0; i < 30; i++)
+      assert_int_equal(q->id[i], 60 + i);
+
+   // and keeps working as a queue
+   assert_true(soa_queue_enque(particle_s, q, make_particle(999)));
+   assert_int_equal(soa_queue_at(particle_s, q, id, 30), 999);
+   assert_particle_equal(soa_queue_peek(particle_s, q), make_particle(60));
+}
+
+static void test_soa_queue_allocation_failure(void **state)
+{
+   soa_queue(particle_s) *q = &((test_state_s*)(*state))->particles;
+
+   test_alloc_fail = true;
+   assert_false(soa_queue_enque(particle_s, q, make_particle(0)));
+   assert_true(soa_queue_empty(particle_s, q));
+
+   test_alloc_fail = false;
+   for (uint32_t i = 0; i < 4; i++)
+      assert_true(soa_queue_enque(particle_s, q, make_particle(i)));
+   assert_true(soa_queue_deque(particle_s, q));
+   assert_true(soa_queue_enque(particle_s, q, make_particle(4)));   // wrapped and full
+
+   test_alloc_fail = true;
+   assert_false(soa_queue_enque(particle_s, q, make_particle(5)));
+   assert_int_equal(soa_queue_len(particle_s, q), 4);
+   assert_int_equal(soa_queue_size(particle_s, q), 4);
+   for (uint32_t i = 0; i < 4; i++)
+      assert_int_equal(soa_queue_at(particle_s, q, id, i), i + 1);
+
+   test_alloc_fail = false;
+   assert_true(soa_queue_enque(particle_s, q, make_particle(5)));
+   for (uint32_t i = 0; i < 5; i++)
+      assert_int_equal(soa_queue_at(particle_s, q, id, i), i + 1);
+}
+
+static void test_soa_stack(void **state)
+{
+   soa_stack(sample_s) *s = &((test_state_s*)(*state))->samples;
+
+   assert_true(soa_stack_empty(sample_s, s));
+   assert_false(soa_stack_pop(sample_s, s));
+
+   // uint8_t sizes: 8, 16, .., 128, then no room to grow
+   for (int i = 0; i < 128; i++)
+      assert_true(soa_stack_push(sample_s, s, ((sample_s){ i * 0.25, (uint8_t)i, (int16_t)(-i), NULL })));
+   assert_int_equal(soa_stack_size(sample_s, s), 128);
+   assert_true(soa_stack_full(sample_s, s));
+   assert_false(soa_stack_push(sample_s, s, ((sample_s){ 0 })));
+   assert_int_equal(soa_stack_len(sample_s, s), 128);
+
+   // fields in push order, each on its own alignment
+   const double *time = soa_stack_field(sample_s, s, time);
+   const uint8_t *flags = soa_stack_field(sample_s, s, flags);
+   const int16_t *level = soa_stack_field(sample_s, s, level);
+   assert_int_equal((uintptr_t)time % SOA_ALIGN, 0);
+   assert_int_equal((uintptr_t)flags % SOA_ALIGN, 0);
+   assert_int_equal((uintptr_t)level % SOA_ALIGN, 0);
+   for (int i = 0; i < 128; i++)
+   {
+      assert_true(time[i] == i * 0.25);
+      assert_int_equal(flags[i], i);
+      assert_int_equal(level[i], -i);
+   }
+
+   // peek / pop from the top; the unstored field reads back as NULL
+   for (int i = 127; i >= 100; i--)
+   {
+      const sample_s top = soa_stack_peek(sample_s, s);
+      assert_true(top.time == i * 0.25);
+      assert_int_equal(top.level, -i);
+      assert_ptr_equal(top.note, NULL);
+      assert_int_equal(soa_stack_top(sample_s, s, flags), i);
+      assert_true(soa_stack_pop(sample_s, s));
+   }
+   assert_int_equal(soa_stack_len(sample_s, s), 100);
+
+   soa_stack_clear(sample_s, s);
+   assert_true(soa_stack_empty(sample_s, s));
+   assert_int_equal(soa_stack_size(sample_s, s), 128);
+
+   // failed first allocation leaves an unallocated stack
+   soa_stack_delete(sample_s, s);
+   test_alloc_fail = true;
+   assert_false(soa_stack_push(sample_s, s, ((sample_s){ 1.0, 1, 1, NULL })));
+   assert_int_equal(soa_stack_size(sample_s, s), 0);
+   test_alloc_fail = false;
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_soa_queue_init_delete),
+      cmocka_unit_test_setup_teardown(test_soa_queue_matches_queue, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_soa_queue_span_linearize, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_soa_queue_allocation_failure, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_soa_stack, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,32 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "sparse-set.fixture.h"
+
+
+/* Failing allocator */
+
+long test_fail_after = -1;
+
+void *test_alloc(size_t size)
+{
+   if (test_fail_after == 0)
+      return NULL;
+   if (test_fail_after > 0)
+      test_fail_after--;
+   return malloc(size);
+}
+
+
+/* Entity IDs */
+
+GENERATE_SPARSE_SET(uint32_t, malloc, free)
+
+
+/* Int values */
+
+GENERATE_SPARSE_MAP(int, uint32_t, test_alloc, free)
+
+
+/* Positions */
+
+GENERATE_SPARSE_MAP(position_s, uint32_t, malloc, free)
\ No newline at end of file
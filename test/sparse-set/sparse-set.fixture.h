@@ -0,0 +1,26 @@
+#ifndef __SPARSE_SET_FIXTURE_H
+#define __SPARSE_SET_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Failing allocator: a countdown to a failed allocation (-1 never fails) */
+extern long test_fail_after;
+void *test_alloc(size_t size);
+
+/* Entity IDs */
+DEFINE_SPARSE_SET(uint32_t)
+
+/* Int values */
+DEFINE_SPARSE_MAP(int, uint32_t)
+
+/* Positions */
+typedef struct
+{
+   float x, y;
+   uint32_t entity;
+} position_s;
+DEFINE_SPARSE_MAP(position_s, uint32_t)
+
+#endif /* __SPARSE_SET_FIXTURE_H */
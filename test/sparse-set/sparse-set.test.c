@@ -0,0 +1,268 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "sparse-set.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+
+struct test_state
+{
+   sparse_set(uint32_t) ids;
+   sparse_map(int) int_map;
+   sparse_map(position_s) positions;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   test_fail_after = -1;
+   sparse_set_init(uint32_t, &tmp->ids);
+   sparse_map_init(int, &tmp->int_map);
+   sparse_map_init(position_s, &tmp->positions);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   sparse_set_delete(uint32_t, &tmp->ids);
+   sparse_map_delete(int, &tmp->int_map);
+   sparse_map_delete(position_s, &tmp->positions);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+
+/* Entity IDs */
+
+const uint32_t mock_ids[] = { 17, 3, 22, 9, 4, 15, 8, 41, 0, 11, 27, 6, 13, 30, 5, 70000, 123456789, UINT32_MAX - 1 };
+
+static void test_sparse_set_init_delete(void **state)
+{
+   sparse_set(uint32_t) set;
+   sparse_set_init(uint32_t, &set);
+   assert_int_equal(sparse_set_len(uint32_t, &set), 0);
+   assert_int_equal(sparse_set_capacity(uint32_t, &set), 0);
+   assert_true(sparse_set_empty(uint32_t, &set));
+   assert_false(sparse_set_contains(uint32_t, &set, 0));
+   assert_false(sparse_set_remove(uint32_t, &set, 0));
+   assert_int_equal(sparse_set_index(uint32_t, &set, 0), SPARSE_SET_NONE(uint32_t));
+
+   assert_true(sparse_set_insert(uint32_t, &set, 7));
+   assert_int_equal(sparse_set_capacity(uint32_t, &set), SPARSE_SET_MIN_CAPACITY);
+   assert_true(sparse_set_reserve(uint32_t, &set, 100));
+   assert_int_equal(sparse_set_capacity(uint32_t, &set), 128);
+   assert_true(sparse_set_contains(uint32_t, &set, 7));
+
+   sparse_set_delete(uint32_t, &set);
+   assert_int_equal(sparse_set_len(uint32_t, &set), 0);
+   assert_int_equal(sparse_set_capacity(uint32_t, &set), 0);
+   assert_false(sparse_set_contains(uint32_t, &set, 7));
+}
+
+static void test_sparse_set_insert_remove(void **state)
+{
+   sparse_set(uint32_t) *set = &((test_state_s*)(*state))->ids;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_ids); i++)
+      assert_true(sparse_set_insert(uint32_t, set, mock_ids[i]));
+   assert_false(sparse_set_insert(uint32_t, set, mock_ids[3]));
+   assert_int_equal(sparse_set_len(uint32_t, set), ARRAY_LEN(mock_ids));
+   for (size_t i = 0; i < ARRAY_LEN(mock_ids); i++)
+   {
+      assert_int_equal(sparse_set_index(uint32_t, set, mock_ids[i]), i);
+      assert_int_equal(sparse_set_ids(uint32_t, set)[i], mock_ids[i]);
+   }
+   assert_false(sparse_set_contains(uint32_t, set, 1));
+   assert_false(sparse_set_contains(uint32_t, set, 70001));
+
+   // swap-remove: the last ID moves into the hole
+   assert_true(sparse_set_remove(uint32_t, set, mock_ids[2]));
+   assert_false(sparse_set_remove(uint32_t, set, mock_ids[2]));
+   assert_int_equal(sparse_set_len(uint32_t, set), ARRAY_LEN(mock_ids) - 1);
+   assert_int_equal(sparse_set_ids(uint32_t, set)[2], mock_ids[ARRAY_LEN(mock_ids) - 1]);
+   for (size_t i = 0; i < ARRAY_LEN(mock_ids); i++)
+      assert_int_equal(sparse_set_contains(uint32_t, set, mock_ids[i]), i != 2);
+
+   // removing the last ID leaves the rest in place
+   assert_true(sparse_set_remove(uint32_t, set, mock_ids[ARRAY_LEN(mock_ids) - 2]));
+   assert_int_equal(sparse_set_len(uint32_t, set), ARRAY_LEN(mock_ids) - 2);
+   assert_int_equal(sparse_set_ids(uint32_t, set)[2], mock_ids[ARRAY_LEN(mock_ids) - 1]);
+   assert_int_equal(sparse_set_ids(uint32_t, set)[3], mock_ids[3]);
+}
+
+static void test_sparse_set_paging_clear(void **state)
+{
+   sparse_set(uint32_t) *set = &((test_state_s*)(*state))->ids;
+
+   // far apart IDs only allocate the pages they land in
+   assert_true(sparse_set_insert(uint32_t, set, 5));
+   assert_true(sparse_set_insert(uint32_t, set, 4000000000u));
+   size_t pages = 0;
+   for (size_t p = 0; p < set->page_count; p++)
+      pages += set->pages[p] != NULL;
+   assert_int_equal(pages, 2);
+   assert_true(set->page_count > (size_t)(4000000000u >> SPARSE_SET_PAGE_BITS));
+
+   // clear is O(1): stale sparse entries are not members
+   for (uint32_t id = 0; id < 1000; id += 3)
+      sparse_set_insert(uint32_t, set, id);
+   const uint32_t capacity = sparse_set_capacity(uint32_t, set);
+   sparse_set_clear(uint32_t, set);
+   assert_true(sparse_set_empty(uint32_t, set));
+   for (uint32_t id = 0; id < 1000; id++)
+      assert_false(sparse_set_contains(uint32_t, set, id));
+   assert_false(sparse_set_contains(uint32_t, set, 4000000000u));
+
+   // reinserted in another order, the stale entries are overwritten
+   for (uint32_t id = 999; id > 500; id -= 7)
+      assert_true(sparse_set_insert(uint32_t, set, id));
+   for (uint32_t id = 0; id < 1000; id++)
+      assert_int_equal(sparse_set_contains(uint32_t, set, id), id > 500 && (999 - id) % 7 == 0);
+   assert_int_equal(sparse_set_capacity(uint32_t, set), capacity);
+}
+
+
+/* Int values */
+
+static void test_int_sparse_map(void **state)
+{
+   sparse_map(int) *map = &((test_state_s*)(*state))->int_map;
+
+   assert_ptr_equal(sparse_map_get(int, map, 3), NULL);
+   for (size_t i = 0; i < ARRAY_LEN(mock_ids); i++)
+      assert_true(sparse_map_insert(int, map, mock_ids[i], (int)i * 10));
+   assert_false(sparse_map_insert(int, map, mock_ids[0], -1));
+   assert_int_equal(sparse_map_len(int, map), ARRAY_LEN(mock_ids));
+   for (size_t i = 0; i < ARRAY_LEN(mock_ids); i++)
+      assert_int_equal(*sparse_map_get(int, map, mock_ids[i]), (int)i * 10);
+
+   // values move with their IDs
+   assert_true(sparse_map_remove(int, map, mock_ids[0]));
+   assert_false(sparse_map_contains(int, map, mock_ids[0]));
+   for (uint32_t i = 0; i < sparse_map_len(int, map); i++)
+      assert_int_equal(*sparse_map_get(int, map, sparse_map_ids(int, map)[i]), sparse_map_values(int, map)[i]);
+   for (size_t i = 1; i < ARRAY_LEN(mock_ids); i++)
+      assert_int_equal(*sparse_map_get(int, map, mock_ids[i]), (int)i * 10);
+
+   *sparse_map_get(int, map, mock_ids[1]) = 99;
+   assert_int_equal(*sparse_map_get(int, map, mock_ids[1]), 99);
+
+   sparse_map_clear(int, map);
+   assert_true(sparse_map_empty(int, map));
+   assert_ptr_equal(sparse_map_get(int, map, mock_ids[1]), NULL);
+   assert_true(sparse_map_insert(int, map, mock_ids[1], 1));
+   assert_int_equal(*sparse_map_get(int, map, mock_ids[1]), 1);
+}
+
+static void test_int_sparse_map_allocation_failure(void **state)
+{
+   sparse_map(int) *map = &((test_state_s*)(*state))->int_map;
+
+   // the first insert allocates both arrays
+   test_fail_after = 0;
+   assert_false(sparse_map_insert(int, map, 7, 7));
+   assert_true(sparse_map_empty(int, map));
+   test_fail_after = -1;
+
+   for (uint32_t id = 0; id < SPARSE_SET_MIN_CAPACITY; id++)
+      assert_true(sparse_map_insert(int, map, id, (int)id));
+   const uint32_t capacity = sparse_map_capacity(int, map);
+
+   // a failed growth of the values leaves the set at its old capacity
+   test_fail_after = 0;
+   assert_false(sparse_map_insert(int, map, 1000, 1000));
+   assert_false(sparse_map_reserve(int, map, capacity * 4));
+   test_fail_after = -1;
+   assert_int_equal(sparse_map_capacity(int, map), capacity);
+   assert_false(sparse_map_contains(int, map, 1000));
+
+   for (uint32_t id = SPARSE_SET_MIN_CAPACITY; id < 100; id++)
+      assert_true(sparse_map_insert(int, map, id, (int)id));
+   for (uint32_t id = 0; id < 100; id++)
+      assert_int_equal(*sparse_map_get(int, map, id), (int)id);
+}
+
+
+/* Positions */
+
+static void test_position_sparse_map_random(void **state)
+{
+   sparse_map(position_s) *positions = &((test_state_s*)(*state))->positions;
+
+   // random inserts / removes against a plain membership array
+   enum { ID_RANGE = 1 << 14 };
+   bool *member = (bool*)calloc(ID_RANGE, sizeof(bool));
+   assert_non_null(member);
+   uint32_t count = 0;
+
+   uint32_t seed = 11;
+   for (uint32_t step = 0; step < 50000; step++)
+   {
+      const uint32_t id = next_random(&seed) % ID_RANGE;
+      if (next_random(&seed) % 3)
+      {
+         const position_s p = { .x = (float)id, .entity = id };
+         assert_int_equal(sparse_map_insert(position_s, positions, id, p), !member[id]);
+         count += !member[id];
+         member[id] = true;
+      }
+      else
+      {
+         assert_int_equal(sparse_map_remove(position_s, positions, id), member[id]);
+         count -= member[id];
+         member[id] = false;
+      }
+      assert_int_equal(sparse_map_len(position_s, positions), count);
+
+      if (step % 1009 == 0)
+      {
+         for (uint32_t i = 0; i < ID_RANGE; i++)
+         {
+            const position_s *p = sparse_map_get(position_s, positions, i);
+            assert_int_equal(p != NULL, member[i]);
+            if (p)
+               assert_int_equal(p->entity, i);
+         }
+
+         // dense iteration sees every member once, values aligned with IDs
+         const uint32_t *ids = sparse_map_ids(position_s, positions);
+         const position_s *values = sparse_map_values(position_s, positions);
+         for (uint32_t i = 0; i < sparse_map_len(position_s, positions); i++)
+         {
+            assert_true(member[ids[i]]);
+            assert_int_equal(values[i].entity, ids[i]);
+         }
+      }
+   }
+   free(member);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_sparse_set_init_delete),
+      cmocka_unit_test_setup_teardown(test_sparse_set_insert_remove, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_sparse_set_paging_clear, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_sparse_map, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_sparse_map_allocation_failure, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_position_sparse_map_random, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}
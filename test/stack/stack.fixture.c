@@ -9,6 +9,13 @@ bool mock_valid(int x)
 }
 
 GENERATE_STACK(int, size_t, INT_STACK_INIT_SIZE, INT_STACK_GROWTH_FACTOR, mock_valid, malloc, realloc, free)
+GENERATE_STACK_SEARCH(int, size_t, int_bytes_equal)
+GENERATE_STACK_REDUCE(int, size_t, int64_t)
+GENERATE_STACK_SORT(int, size_t, int, 0, malloc, free)
+GENERATE_STACK_REMOVE_IF(int, size_t, int_bytes_equal)
+GENERATE_STACK_HASH(int, size_t)
+GENERATE_STACK_PARALLEL(int, size_t, int64_t)
+GENERATE_STACK_PARALLEL_SORT(int, size_t, malloc, free)
 
 /* Cordinate stack */
 bool cord_valid(cordinate_s x)
@@ -17,3 +24,5 @@ bool cord_valid(cordinate_s x)
 }
 
 GENERATE_STACK(cordinate_s, size_t, CORDINATE_STACK_INIT_SIZE, CORDINATE_STACK_GROWTH_FACTOR, cord_valid, malloc, realloc, free)
+GENERATE_STACK_SEARCH(cordinate_s, size_t, cordinate_s_bytes_equal)
+GENERATE_STACK_SORT(cordinate_s, size_t, double, offsetof(cordinate_s, y), malloc, free)
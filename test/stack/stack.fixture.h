@@ -9,6 +9,14 @@
 #define INT_STACK_INIT_SIZE 4
 #define INT_STACK_GROWTH_FACTOR 2
 DEFINE_STACK(int, size_t, INT_STACK_INIT_SIZE)
+DEFINE_STACK_SEARCH(int, size_t)
+DEFINE_STACK_REDUCE(int, size_t, int64_t)
+DEFINE_STACK_SORT(int, size_t)
+DEFINE_STACK_REMOVE_IF(int, size_t)
+DEFINE_STACK_HASH(int, size_t)
+DEFINE_STACK_PARALLEL(int, size_t, int64_t)
+DEFINE_STACK_PARALLEL_SORT(int, size_t)
+DEFINE_BYTES_EQUAL(int)
 
 /* Cordinate stack */
 typedef struct
@@ -20,5 +28,8 @@ typedef struct
 #define CORDINATE_STACK_INIT_SIZE 4
 #define CORDINATE_STACK_GROWTH_FACTOR 2
 DEFINE_STACK(cordinate_s, size_t, CORDINATE_STACK_INIT_SIZE)
+DEFINE_STACK_SEARCH(cordinate_s, size_t)
+DEFINE_STACK_SORT(cordinate_s, size_t)
+DEFINE_BYTES_EQUAL(cordinate_s)
 
 #endif /* __STACK_FIXTURE_H */
@@ -3,6 +3,7 @@
 #include <stdarg.h>
 #include <setjmp.h>
 #include <stdlib.h>
+#include <string.h>
 #include <cmocka.h>
 #include "stack.fixture.h"
 
@@ -182,6 +183,248 @@ static void test_int_stack_reverse(void **state)
       assert_int_equal(stack->values[i], mock_ints[stack->len - i - 1]);
 }
 
+static void test_int_stack_find_count_contains(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+
+   // long enough to run the vector loop and the scalar tail
+   for (size_t i = 0; i < 100; i++)
+      stack_push(int, stack, 1 + (int)(i % 5));
+   stack_push(int, stack, 7);
+
+   assert_int_equal(stack_find(int, stack, 3), 2);
+   assert_int_equal(stack_find(int, stack, 7), 100);
+   assert_int_equal(stack_find(int, stack, 8), stack->len);
+
+   assert_int_equal(stack_count(int, stack, 3), 20);
+   assert_int_equal(stack_count(int, stack, 7), 1);
+   assert_int_equal(stack_count(int, stack, 8), 0);
+
+   assert_true(stack_contains(int, stack, 5));
+   assert_false(stack_contains(int, stack, 8));
+}
+
+
+static void test_int_stack_reduce(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+
+   int64_t expected = 0;
+   for (size_t i = 0; i < ARRAY_LEN(mock_ints); i++)
+   {
+      stack_push(int, stack, mock_ints[i]);
+      expected += mock_ints[i];
+   }
+   stack_push(int, stack, -5);
+   expected += -5;
+
+   assert_int_equal(stack_sum(int, stack), expected);
+   assert_int_equal(stack_min(int, stack), -5);
+   assert_int_equal(stack_max(int, stack), 23);
+   assert_int_equal(stack_argmin(int, stack), ARRAY_LEN(mock_ints));
+   assert_int_equal(stack_argmax(int, stack), ARRAY_LEN(mock_ints) - 1);
+
+   // first of several equal extremes, past the vector blocks
+   stack_clear(int, stack);
+   for (int i = 0; i < 100; i++)
+      stack_push(int, stack, (i == 37 || i == 90) ? -7 : (i == 61 || i == 99) ? 50 : 1 + i % 5);
+   assert_int_equal(stack_argmin(int, stack), 37);
+   assert_int_equal(stack_argmax(int, stack), 61);
+
+   // accumulates in int64_t, so no overflow
+   stack_clear(int, stack);
+   for (size_t i = 0; i < 4; i++)
+      stack_push(int, stack, 2000000001);
+   assert_int_equal(stack_sum(int, stack), INT64_C(8000000004));
+}
+
+static int compare_int(const int *a, const int *b)
+{
+   return (*a > *b) - (*a < *b);
+}
+
+static void test_int_stack_sort(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+
+   // pseudo random values of the form 6k + 1 (mock_valid rejects multiples of 6)
+   uint32_t seed = 12345;
+   for (size_t i = 0; i < 1000; i++)
+   {
+      seed = seed * 1103515245u + 12345u;
+      stack_push(int, stack, (int)((seed >> 8) % 100000) * 6 + 1 - 300000);
+   }
+
+   assert_true(stack_sort(int, stack, compare_int));
+   for (size_t i = 1; i < stack->len; i++)
+      assert_true(stack->values[i - 1] <= stack->values[i]);
+
+   stack_reverse(int, stack);
+   assert_true(stack_radix_sort(int, stack));
+   for (size_t i = 1; i < stack->len; i++)
+      assert_true(stack->values[i - 1] <= stack->values[i]);
+   assert_true(stack->values[0] < 0);
+}
+static bool int_below(const int *value, void *ctx)
+{
+   return *value < *(const int*)ctx;
+}
+
+static void test_int_stack_remove_if(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+
+   // (1, 7, 13, ..., 55) x 10, long enough for the vector loop
+   for (int i = 0; i < 100; i++)
+      stack_push(int, stack, (i % 10) * 6 + 1);
+
+   assert_int_equal(stack_remove_value(int, stack, 7), 10);
+   assert_int_equal(stack->len, 90);
+   assert_false(stack_contains(int, stack, 7));
+   assert_int_equal(stack_remove_value(int, stack, 8), 0);
+
+   int threshold = 30;
+   assert_int_equal(stack_remove_if(int, stack, int_below, &threshold), 40);
+   assert_int_equal(stack->len, 50);
+   for (size_t i = 0; i < stack->len; i++)
+      assert_int_equal(stack->values[i], (int)(i % 5) * 6 + 31);
+
+   threshold = 40;
+   assert_int_equal(stack_retain_if(int, stack, int_below, &threshold), 30);
+   for (size_t i = 0; i < stack->len; i++)
+      assert_int_equal(stack->values[i], (int)(i % 2) * 6 + 31);
+
+   assert_int_equal(stack_retain_if(int, stack, int_below, &threshold), 0);
+   threshold = 100;
+   assert_int_equal(stack_remove_if(int, stack, int_below, &threshold), 20);
+   assert_true(stack_empty(int, stack));
+}
+
+static void test_int_stack_hash_equal(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+   stack(int) other;
+   stack_init(int, &other);
+
+   assert_true(stack_equal(int, stack, &other));
+   assert_int_equal(stack_hash(int, stack, 7), stack_hash(int, &other, 7));
+
+   for (int i = 0; i < 50; i++)
+   {
+      stack_push(int, stack, i * 6 + 1);
+      stack_push(int, &other, i * 6 + 1);
+   }
+   stack_resize(int, &other);
+   assert_true(stack->size != other.size);
+   assert_true(stack_equal(int, stack, &other));
+   assert_int_equal(stack_hash(int, stack, 7), stack_hash(int, &other, 7));
+   assert_true(stack_hash(int, stack, 7) != stack_hash(int, stack, 8));
+
+   stack_pop(int, &other);
+   stack_push(int, &other, 5);
+   assert_false(stack_equal(int, stack, &other));
+   assert_true(stack_hash(int, stack, 7) != stack_hash(int, &other, 7));
+
+   stack_pop(int, &other);
+   assert_false(stack_equal(int, stack, &other));
+
+   stack_delete(int, &other);
+}
+
+static void int_add_one(int *value, void *ctx)
+{
+   (void)ctx;
+   *value += 1;
+}
+
+static int int_negate(int value, void *ctx)
+{
+   (void)ctx;
+   return -value;
+}
+
+static int64_t int_sum(int64_t acc, const int *value, void *ctx)
+{
+   (void)ctx;
+   return acc + *value;
+}
+
+static int64_t int64_add(int64_t a, int64_t b)
+{
+   return a + b;
+}
+
+static void test_int_stack_parallel(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+   parallel_pool_s pool;
+   assert_true(parallel_pool_init(&pool, 4));
+   assert_int_equal(parallel_pool_threads(&pool), 4);
+
+   // enough elements to be split into several tasks
+   const size_t n = 100001;
+   int64_t expected = 0;
+   for (size_t i = 0; i < n; i++)
+   {
+      stack_push(int, stack, (int)(i % 1000) * 6 + 1);
+      expected += (int64_t)(i % 1000) * 6 + 1;
+   }
+   size_t chunk;
+   assert_true(parallel_chunks(&pool, n, &chunk) > 1);
+
+   assert_int_equal(stack_parallel_reduce(int, stack, &pool, 0, int_sum, int64_add, NULL), expected);
+   stack_parallel_for_each(int, stack, &pool, int_add_one, NULL);
+   stack_parallel_transform(int, stack, &pool, int_negate, NULL);
+   for (size_t i = 0; i < n; i++)
+      assert_int_equal(stack->values[i], -((int)(i % 1000) * 6 + 2));
+   assert_int_equal(stack_parallel_reduce(int, stack, &pool, 0, int_sum, int64_add, NULL), -expected - (int64_t)n);
+
+   // serial without a pool, and below the threshold
+   assert_int_equal(stack_parallel_reduce(int, stack, NULL, 0, int_sum, int64_add, NULL), -expected - (int64_t)n);
+   stack_clear(int, stack);
+   stack_push(int, stack, 7);
+   stack_parallel_for_each(int, stack, &pool, int_add_one, NULL);
+   assert_int_equal(stack_peek(int, stack), 8);
+   assert_int_equal(parallel_chunks(&pool, 100, &chunk), 1);
+
+   parallel_pool_delete(&pool);
+}
+
+static void test_int_stack_parallel_sort(void **state)
+{
+   stack(int) *stack = &((test_state_s*)(*state))->int_stack;
+   stack(int) expected;
+   stack_init(int, &expected);
+   parallel_pool_s pool;
+   assert_true(parallel_pool_init(&pool, 4));
+
+   // enough runs for a multiway merge, last run shorter than the rest
+   uint32_t seed = 777;
+   for (size_t i = 0; i < 200003; i++)
+   {
+      seed = seed * 1103515245u + 12345u;
+      const int value = (int)((seed >> 8) % 100000) * 6 + 1 - 300000;
+      stack_push(int, stack, value);
+      stack_push(int, &expected, value);
+   }
+   assert_true(stack_sort(int, &expected, compare_int));
+
+   assert_true(stack_parallel_sort(int, stack, &pool, compare_int));
+   assert_memory_equal(stack->values, expected.values, sizeof(int) * expected.len);
+
+   stack_reverse(int, stack);
+   assert_true(stack_parallel_sort(int, stack, &pool, compare_int));
+   assert_memory_equal(stack->values, expected.values, sizeof(int) * expected.len);
+
+   // serial without a pool
+   stack_reverse(int, stack);
+   assert_true(stack_parallel_sort(int, stack, NULL, compare_int));
+   assert_memory_equal(stack->values, expected.values, sizeof(int) * expected.len);
+
+   parallel_pool_delete(&pool);
+   stack_delete(int, &expected);
+}
+
 
 /* Cordinate stack */
 
@@ -357,6 +600,116 @@ static void test_cordinate_stack_reverse(void **state)
       assert_memory_equal(&stack->values[i], &mock_cords[stack->len - i - 1], sizeof(cordinate_s));
 }
 
+static void test_cordinate_stack_find_count_contains(void **state)
+{
+   stack(cordinate_s) *stack = &((test_state_s*)(*state))->cordinate_stack;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_cords); i++)
+      stack_push(cordinate_s, stack, mock_cords[i]);
+   stack_push(cordinate_s, stack, mock_cords[3]);
+
+   assert_int_equal(stack_find(cordinate_s, stack, mock_cords[3]), 3);
+   assert_int_equal(stack_count(cordinate_s, stack, mock_cords[3]), 2);
+   assert_int_equal(stack_count(cordinate_s, stack, mock_cords[4]), 1);
+
+   const cordinate_s missing = { -1.0, -1.0, -1.0 };
+   assert_int_equal(stack_find(cordinate_s, stack, missing), stack->len);
+   assert_false(stack_contains(cordinate_s, stack, missing));
+   assert_true(stack_contains(cordinate_s, stack, mock_cords[0]));
+}
+
+
+static int compare_cordinate_x(const cordinate_s *a, const cordinate_s *b)
+{
+   return (a->x > b->x) - (a->x < b->x);
+}
+
+static void test_cordinate_stack_sort(void **state)
+{
+   stack(cordinate_s) *stack = &((test_state_s*)(*state))->cordinate_stack;
+
+   for (size_t i = 0; i < ARRAY_LEN(mock_cords); i++)
+      stack_push(cordinate_s, stack, mock_cords[i]);
+   const cordinate_s lowest = { 0.5, -3.0, 0.0 };
+   stack_push(cordinate_s, stack, lowest);
+
+   assert_true(stack_sort(cordinate_s, stack, compare_cordinate_x));
+   for (size_t i = 1; i < stack->len; i++)
+      assert_true(stack->values[i - 1].x <= stack->values[i].x);
+
+   // radix key is the y field
+   assert_true(stack_radix_sort(cordinate_s, stack));
+   for (size_t i = 1; i < stack->len; i++)
+      assert_true(stack->values[i - 1].y <= stack->values[i].y);
+   assert_double_equal(stack->values[0].y, -3.0, 1e-12);
+}
+
+typedef struct
+{
+   uint8_t rgb[3];
+} pixel_s;
+
+/* a[i] = seed + i in every byte of the element, so a misplaced byte shows up */
+#define FILL_RANGE(type, a, n, seed) \
+   for (size_t i = 0; i < (n); i++) \
+      memset(&(a)[i], (int)((seed) + i), sizeof(type))
+
+#define CHECK_RANGE(type, a, n, expected) \
+   for (size_t i = 0; i < (n); i++) \
+   { \
+      type want; \
+      memset(&want, (int)(expected), sizeof(type)); \
+      assert_memory_equal(&(a)[i], &want, sizeof(type)); \
+   }
+
+/* lengths around every vector width, both even and odd */
+#define TEST_RANGES(type) \
+   do \
+   { \
+      type a[80], b[80]; \
+      for (size_t n = 0; n <= 70; n++) \
+      { \
+         FILL_RANGE(type, a, 80, 0); \
+         FILL_RANGE(type, b, 80, 100); \
+         SWAP_RANGES(type, a, b, n); \
+         CHECK_RANGE(type, a, n, 100 + i); \
+         CHECK_RANGE(type, b, n, i); \
+         CHECK_RANGE(type, a + n, 80 - n, n + i); \
+         CHECK_RANGE(type, b + n, 80 - n, 100 + n + i); \
+\
+         /* adjacent, non-overlapping halves of one array */ \
+         FILL_RANGE(type, a, 80, 0); \
+         SWAP_RANGES(type, a, a + n / 2, n / 2); \
+         CHECK_RANGE(type, a, n / 2, n / 2 + i); \
+         CHECK_RANGE(type, a + n / 2, n / 2, i); \
+         CHECK_RANGE(type, a + n / 2 * 2, 80 - n / 2 * 2, n / 2 * 2 + i); \
+\
+         FILL_RANGE(type, a, 80, 0); \
+         REVERSE_RANGE(type, a, n); \
+         CHECK_RANGE(type, a, n, n - 1 - i); \
+         CHECK_RANGE(type, a + n, 80 - n, n + i); \
+\
+         const size_t shifts[] = { 0, 1, n / 3, n / 2, n ? n - 1 : 0, n, n + 3, 2 * n + 1 }; \
+         for (size_t s = 0; s < ARRAY_LEN(shifts); s++) \
+         { \
+            const size_t k = shifts[s]; \
+            FILL_RANGE(type, a, 80, 0); \
+            ROTATE_RANGE(type, a, n, k); \
+            CHECK_RANGE(type, a, n, (i + (n ? k % n : 0)) % (n ? n : 1)); \
+            CHECK_RANGE(type, a + n, 80 - n, n + i); \
+         } \
+      } \
+   } while (0)
+
+static void test_swap_reverse_rotate_ranges(void **state)
+{
+   TEST_RANGES(uint8_t);
+   TEST_RANGES(uint16_t);
+   TEST_RANGES(int);
+   TEST_RANGES(uint64_t);
+   TEST_RANGES(pixel_s);
+   TEST_RANGES(cordinate_s);
+}
 
 int main(void)
 {  
@@ -370,6 +723,13 @@ int main(void)
       cmocka_unit_test_setup_teardown(test_int_stack_full, setup, teardown),
       cmocka_unit_test_setup_teardown(test_int_stack_clear, setup, teardown),
       cmocka_unit_test_setup_teardown(test_int_stack_reverse, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_find_count_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_reduce, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_sort, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_remove_if, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_hash_equal, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_parallel, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_int_stack_parallel_sort, setup, teardown),
       cmocka_unit_test(test_cordinate_stack_init_delete),
       cmocka_unit_test(test_cordinate_stack_resize),
       cmocka_unit_test_setup_teardown(test_cordinate_stack_peek, setup, teardown),
@@ -378,6 +738,9 @@ int main(void)
       cmocka_unit_test_setup_teardown(test_cordinate_stack_full, setup, teardown),
       cmocka_unit_test_setup_teardown(test_cordinate_stack_clear, setup, teardown),
       cmocka_unit_test_setup_teardown(test_cordinate_stack_reverse, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_cordinate_stack_find_count_contains, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_cordinate_stack_sort, setup, teardown),
+      cmocka_unit_test(test_swap_reverse_rotate_ranges),
    };
    return cmocka_run_group_tests(tests, NULL, NULL);
 }
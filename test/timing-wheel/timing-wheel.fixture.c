@@ -0,0 +1,8 @@
+#include <stdlib.h>
+#include <stddef.h>
+#include "timing-wheel.fixture.h"
+
+
+/* Timers carrying an int, uint32_t IDs */
+
+GENERATE_TIMING_WHEEL(int, uint32_t, malloc, free)
\ No newline at end of file
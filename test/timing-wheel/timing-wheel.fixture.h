@@ -0,0 +1,11 @@
+#ifndef __TIMING_WHEEL_FIXTURE_H
+#define __TIMING_WHEEL_FIXTURE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ccoutils.h"
+
+/* Timers carrying an int, uint32_t IDs */
+DEFINE_TIMING_WHEEL(int, uint32_t)
+
+#endif /* __TIMING_WHEEL_FIXTURE_H */
@@ -0,0 +1,281 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include "timing-wheel.fixture.h"
+
+#define ARRAY_LEN(arr) (sizeof(arr) / sizeof(arr[0]))
+#define START_TICK ((uint64_t)1 << 40)
+
+struct test_state
+{
+   timing_wheel(int) wheel;
+};
+typedef struct test_state test_state_s;
+
+static int setup(void **state)
+{
+   test_state_s *tmp = (test_state_s*)malloc(sizeof(test_state_s));
+   if (!tmp)
+      return -1;
+
+   timing_wheel_init(int, &tmp->wheel, START_TICK);
+   *state = tmp;
+   return 0;
+}
+
+static int teardown(void **state)
+{
+   test_state_s *tmp = (test_state_s*)(*state);
+   timing_wheel_delete(int, &tmp->wheel);
+   free(tmp);
+   *state = NULL;
+   return 0;
+}
+
+static uint32_t next_random(uint32_t *seed)
+{
+   *seed = *seed * 1103515245u + 12345u;
+   return *seed >> 8;
+}
+
+/* records what fired; deadlines[id] is the expected deadline, 0 when not scheduled */
+typedef struct
+{
+   timing_wheel(int) *wheel;
+   uint64_t *deadlines;
+   uint64_t from; /* clock before the advance */
+   size_t fired;
+   uint64_t last_deadline;
+   uint32_t last_id;
+   int last_value;
+} expiry_log_s;
+
+static void log_expiry(uint32_t id, const int *value, void *ctx)
+{
+   expiry_log_s *log = (expiry_log_s*)ctx;
+   const uint64_t now = timing_wheel_now(int, log->wheel);
+   assert_false(timing_wheel_scheduled(int, log->wheel, id));
+   if (log->deadlines)
+   {
+      // fires in the advance that reaches its deadline, in deadline order
+      assert_true(log->deadlines[id] > log->from && log->deadlines[id] <= now);
+      assert_true(log->deadlines[id] >= log->last_deadline);
+      log->last_deadline = log->deadlines[id];
+      log->deadlines[id] = 0;
+   }
+   log->fired++;
+   log->last_id = id;
+   log->last_value = *value;
+}
+
+
+static void test_timing_wheel_init_delete(void **state)
+{
+   timing_wheel(int) wheel;
+   timing_wheel_init(int, &wheel, 100);
+   assert_int_equal(timing_wheel_len(int, &wheel), 0);
+   assert_int_equal(timing_wheel_capacity(int, &wheel), 0);
+   assert_int_equal(timing_wheel_now(int, &wheel), 100);
+   assert_false(timing_wheel_scheduled(int, &wheel, 0));
+   assert_false(timing_wheel_cancel(int, &wheel, 0));
+
+   // capacity follows the largest ID
+   assert_true(timing_wheel_schedule(int, &wheel, 40, 150, -1));
+   assert_int_equal(timing_wheel_capacity(int, &wheel), 64);
+   assert_true(timing_wheel_reserve(int, &wheel, 65));
+   assert_int_equal(timing_wheel_capacity(int, &wheel), 128);
+   assert_true(timing_wheel_scheduled(int, &wheel, 40));
+   assert_int_equal(timing_wheel_deadline(int, &wheel, 40), 150);
+   assert_int_equal(timing_wheel_value(int, &wheel, 40), -1);
+
+   // an empty advance only moves the clock
+   expiry_log_s log = { .wheel = &wheel };
+   assert_int_equal(timing_wheel_advance(int, &wheel, 149, log_expiry, &log), 0);
+   assert_int_equal(timing_wheel_now(int, &wheel), 149);
+
+   timing_wheel_delete(int, &wheel);
+   assert_int_equal(timing_wheel_len(int, &wheel), 0);
+   assert_int_equal(timing_wheel_capacity(int, &wheel), 0);
+   assert_int_equal(timing_wheel_now(int, &wheel), 149);
+   assert_false(timing_wheel_scheduled(int, &wheel, 40));
+}
+
+static void test_timing_wheel_schedule_cancel(void **state)
+{
+   timing_wheel(int) *wheel = &((test_state_s*)(*state))->wheel;
+   expiry_log_s log = { .wheel = wheel };
+
+   assert_true(timing_wheel_schedule(int, wheel, 1, START_TICK + 10, 10));
+   assert_true(timing_wheel_schedule(int, wheel, 2, START_TICK + 1000, 1000));
+   assert_true(timing_wheel_schedule(int, wheel, 3, START_TICK + 100000, 100000));
+   assert_int_equal(timing_wheel_len(int, wheel), 3);
+
+   // an ID is scheduled at most once
+   assert_false(timing_wheel_schedule(int, wheel, 2, START_TICK + 5, 5));
+   assert_int_equal(timing_wheel_deadline(int, wheel, 2), START_TICK + 1000);
+
+   assert_true(timing_wheel_cancel(int, wheel, 2));
+   assert_false(timing_wheel_cancel(int, wheel, 2));
+   assert_false(timing_wheel_scheduled(int, wheel, 2));
+   assert_int_equal(timing_wheel_len(int, wheel), 2);
+
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 9, log_expiry, &log), 0);
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 10, log_expiry, &log), 1);
+   assert_int_equal(log.last_id, 1);
+   assert_int_equal(log.last_value, 10);
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 99999, log_expiry, &log), 0);
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 200000, log_expiry, &log), 1);
+   assert_int_equal(log.last_id, 3);
+   assert_true(timing_wheel_empty(int, wheel));
+
+   // deadlines not after now fire on the next advance
+   const uint64_t now = timing_wheel_now(int, wheel);
+   assert_true(timing_wheel_schedule(int, wheel, 2, now - 50, 7));
+   assert_int_equal(timing_wheel_deadline(int, wheel, 2), now + 1);
+   assert_int_equal(timing_wheel_advance(int, wheel, now + 1, log_expiry, &log), 1);
+   assert_int_equal(log.last_value, 7);
+
+   // clear() unschedules everything and keeps the clock
+   for (uint32_t id = 0; id < 20; id++)
+      timing_wheel_schedule(int, wheel, id, now + id * 1000, 0);
+   timing_wheel_clear(int, wheel);
+   assert_true(timing_wheel_empty(int, wheel));
+   assert_int_equal(timing_wheel_now(int, wheel), now + 1);
+   for (uint32_t id = 0; id < 20; id++)
+      assert_false(timing_wheel_scheduled(int, wheel, id));
+   assert_int_equal(timing_wheel_advance(int, wheel, now + 100000, log_expiry, &log), 0);
+}
+
+static void test_timing_wheel_random(void **state)
+{
+   timing_wheel(int) *wheel = &((test_state_s*)(*state))->wheel;
+
+   // schedule / cancel / advance against a plain array of deadlines
+   enum { ID_COUNT = 5000 };
+   uint64_t *deadlines = calloc(ID_COUNT, sizeof(uint64_t));
+   assert_non_null(deadlines);
+   expiry_log_s log = { .wheel = wheel, .deadlines = deadlines };
+   size_t scheduled = 0, cancelled = 0;
+   uint32_t seed = 17;
+
+   for (uint32_t round = 0; round < 400; round++)
+   {
+      for (uint32_t i = 0; i < 100; i++)
+      {
+         const uint32_t id = next_random(&seed) % ID_COUNT;
+         if (deadlines[id])
+         {
+            assert_true(timing_wheel_cancel(int, wheel, id));
+            deadlines[id] = 0;
+            cancelled++;
+            continue;
+         }
+         // mostly short timeouts, some crossing every level or beyond the top one
+         const uint32_t pick = next_random(&seed) % 8;
+         const uint32_t shift = (pick < 5) ? 10 : (pick < 7) ? 28 : 36;
+         const uint64_t deadline = timing_wheel_now(int, wheel) + 1 + (((uint64_t)next_random(&seed) << 24) ^ next_random(&seed)) % ((uint64_t)1 << shift);
+         assert_true(timing_wheel_schedule(int, wheel, id, deadline, (int)id));
+         deadlines[id] = deadline;
+         scheduled++;
+      }
+
+      log.from = timing_wheel_now(int, wheel);
+      log.last_deadline = 0;
+      const uint64_t to = log.from + ((round % 50 == 49) ? ((uint64_t)next_random(&seed) << 10) : next_random(&seed) % 600);
+      timing_wheel_advance(int, wheel, to, log_expiry, &log);
+      assert_int_equal(timing_wheel_now(int, wheel), to);
+
+      // nothing due is left behind
+      for (uint32_t id = 0; id < ID_COUNT; id++)
+      {
+         assert_int_equal(timing_wheel_scheduled(int, wheel, id), deadlines[id] != 0);
+         assert_true(deadlines[id] == 0 || deadlines[id] > to);
+      }
+      assert_int_equal(timing_wheel_len(int, wheel), scheduled - cancelled - log.fired);
+   }
+
+   log.from = timing_wheel_now(int, wheel);
+   log.last_deadline = 0;
+   timing_wheel_advance(int, wheel, log.from + ((uint64_t)1 << 37), log_expiry, &log);
+   assert_true(timing_wheel_empty(int, wheel));
+   assert_int_equal(log.fired, scheduled - cancelled);
+   free(deadlines);
+}
+
+static void test_timing_wheel_far_deadlines(void **state)
+{
+   timing_wheel(int) *wheel = &((test_state_s*)(*state))->wheel;
+
+   // beyond TIMING_WHEEL_LEVELS * TIMING_WHEEL_BITS bits of ticks: re-filed until due
+   uint64_t deadlines[4] =
+   {
+      START_TICK + ((uint64_t)1 << 33) + 5,
+      START_TICK + ((uint64_t)1 << 36) + 12345,
+      START_TICK + ((uint64_t)1 << 32) - 1,
+      START_TICK + 3,
+   };
+   const uint64_t expected[4] = { deadlines[0], deadlines[1], deadlines[2], deadlines[3] };
+   for (uint32_t id = 0; id < 4; id++)
+      assert_true(timing_wheel_schedule(int, wheel, id, deadlines[id], (int)id));
+
+   expiry_log_s log = { .wheel = wheel, .deadlines = deadlines, .from = START_TICK };
+   const uint64_t steps[] = { START_TICK + 3, expected[2] - 1, expected[2], expected[0], expected[1] - 1, expected[1] };
+   const size_t fired[] = { 1, 0, 1, 1, 0, 1 };
+   for (size_t i = 0; i < ARRAY_LEN(steps); i++)
+   {
+      log.from = timing_wheel_now(int, wheel);
+      log.last_deadline = 0;
+      assert_int_equal(timing_wheel_advance(int, wheel, steps[i], log_expiry, &log), fired[i]);
+   }
+   assert_true(timing_wheel_empty(int, wheel));
+}
+
+/* re-arms itself every `period` ticks until value reaches 0 */
+typedef struct
+{
+   timing_wheel(int) *wheel;
+   uint64_t period;
+   size_t fired;
+} periodic_s;
+
+static void rearm(uint32_t id, const int *value, void *ctx)
+{
+   periodic_s *periodic = (periodic_s*)ctx;
+   periodic->fired++;
+   if (*value > 0)
+      assert_true(timing_wheel_schedule(int, periodic->wheel, id, timing_wheel_now(int, periodic->wheel) + periodic->period, *value - 1));
+}
+
+static void test_timing_wheel_rearm(void **state)
+{
+   timing_wheel(int) *wheel = &((test_state_s*)(*state))->wheel;
+
+   // expire() may schedule the expiring ID again, even at "now"
+   periodic_s periodic = { .wheel = wheel, .period = 300 };
+   assert_true(timing_wheel_schedule(int, wheel, 9, START_TICK + 300, 99));
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 300 * 50, rearm, &periodic), 50);
+   assert_int_equal(timing_wheel_value(int, wheel, 9), 49);
+   assert_int_equal(timing_wheel_deadline(int, wheel, 9), START_TICK + 300 * 51);
+
+   periodic.period = 0;
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 300 * 51, rearm, &periodic), 1);
+   assert_int_equal(timing_wheel_advance(int, wheel, START_TICK + 300 * 51 + 100, rearm, &periodic), 49);
+   assert_true(timing_wheel_empty(int, wheel));
+   assert_int_equal(periodic.fired, 99 + 1);
+}
+
+int main(void)
+{
+   const struct CMUnitTest tests[] =
+   {
+      cmocka_unit_test(test_timing_wheel_init_delete),
+      cmocka_unit_test_setup_teardown(test_timing_wheel_schedule_cancel, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_timing_wheel_random, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_timing_wheel_far_deadlines, setup, teardown),
+      cmocka_unit_test_setup_teardown(test_timing_wheel_rearm, setup, teardown),
+   };
+   return cmocka_run_group_tests(tests, NULL, NULL);
+}